@@ -0,0 +1,932 @@
+#!/usr/bin/env python3
+# This file is part of Sophus.
+#
+# Copyright 2016 Hauke Strasdat
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to
+# deal in the Software without restriction, including without limitation the
+# rights  to use, copy, modify, merge, publish, distribute, sublicense, and/or
+# sell copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+# FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+# IN THE SOFTWARE.
+
+"""Generates closed-form kernels of the Sophus Lie groups.
+
+For each group, exp, log, Adj, the internal Jacobian (derivative of the
+parameters of T * exp(x) at x = 0) and the Jacobians of exp and log are
+derived symbolically, optimized with common subexpression elimination and
+written to sophus/generated/<group>_kernels.hpp.
+
+Coefficients which are singular at zero rotation (or zero log-scale), such
+as (1 - cos(theta)) / theta^2, are evaluated by their Taylor expansion below
+a threshold. The expansions, their derivatives and the thresholds (chosen
+such that the first omitted term is below machine precision) are computed
+here as well, so they never have to be derived by hand.
+
+Usage (requires SymPy):
+
+    python3 py/generate_kernels.py [output directory]
+"""
+
+import itertools
+import os
+import sys
+
+import sympy as sp
+from sympy.printing.cxx import CXX11CodePrinter
+
+# Highest power of a small variable kept in the Taylor expansions.
+SERIES_ORDER = 8
+
+EPSILON = {'double': 2.220446049250313e-16, 'float': 1.1920929e-07}
+
+# Thresholds are not chosen larger than this, since the closed form is
+# well conditioned beyond it anyway.
+MAX_THRESHOLD = 0.5
+
+
+################################################################################
+# Code printer
+
+class KernelPrinter(CXX11CodePrinter):
+    """Prints expressions for generic Scalar types (float, double, Jets).
+
+    Functions are called unqualified (with using-declarations of the std
+    versions in scope) and all literals are wrapped in Scalar(), so that
+    the code also compiles for automatic differentiation types.
+    """
+    _ns = ''
+
+    def _print_Integer(self, expr):
+        return 'Scalar(%d)' % int(expr)
+
+    def _print_Rational(self, expr):
+        return 'Scalar(%d.0 / %d.0)' % (expr.p, expr.q)
+
+    def _print_Float(self, expr):
+        return 'Scalar(%s)' % repr(float(expr))
+
+    def _print_Pi(self, expr):
+        return 'SophusConstants<Scalar>::pi()'
+
+    def _print_Pow(self, expr):
+        base, exponent = expr.as_base_exp()
+        b = self.parenthesize(base, sp.printing.precedence.PRECEDENCE['Mul'])
+        # Products are parenthesized, since the Mul printer does not expect
+        # a power to be printed as a product (e.g. in denominators).
+        if exponent.is_Integer and 1 < exponent <= 8:
+            return '(%s)' % ' * '.join([b] * int(exponent))
+        if exponent.is_Integer and -8 <= exponent < 0:
+            return 'Scalar(1) / (%s)' % ' * '.join([b] * int(-exponent))
+        if exponent == sp.Rational(1, 2):
+            return 'sqrt(%s)' % self._print(base)
+        if exponent == -sp.Rational(1, 2):
+            return 'Scalar(1) / sqrt(%s)' % self._print(base)
+        return 'pow(%s, %s)' % (self._print(base), self._print(exponent))
+
+
+PRINTER = KernelPrinter()
+
+
+def cxx(expr):
+    return PRINTER.doprint(expr)
+
+
+################################################################################
+# Piecewise coefficients
+
+class SmallVar(object):
+    """Variable near whose zero some coefficients are singular.
+
+    If runtime is True, the variable itself is computed by the kernel
+    (e.g. the rotation angle of SE2) and the condition is |v| < threshold.
+    Otherwise only its square is computed (e.g. theta^2 = |omega|^2), the
+    coefficients must be even in v and the condition is
+    v^2 < threshold^2 * ref_sq.
+    """
+
+    def __init__(self, symbol, sq=None, ref_sq=sp.Integer(1)):
+        self.symbol = symbol
+        self.runtime = sq is None
+        self.sq_symbol = None if self.runtime else sp.Symbol(
+            symbol.name + '_sq')
+        self.sq = sq
+        self.ref_sq = ref_sq
+
+
+class Stage(object):
+    """Set of coefficients which share the same small variables.
+
+    poles are symbols at whose zero the closed forms are 0 / 0 or inf * 0 in
+    floating point, although they have one-sided limits (e.g. w of the
+    quaternion in 2 atan(n / w) / n). For |pole| < epsilon the limits are
+    used instead, from above if pole > 0 and from below otherwise.
+    """
+
+    def __init__(self, small_vars, coefficients, substitutions=None,
+                 poles=None):
+        self.small_vars = small_vars
+        # list of (Symbol, closed form)
+        self.coefficients = list(coefficients)
+        # applied to closed forms and expansions before emitting code, e.g.
+        # to reuse exp(sigma) computed before the stage
+        self.substitutions = substitutions or {}
+        self.poles = poles or []
+
+
+def nested_series(expr, small_vars):
+    for v in small_vars:
+        expr = sp.series(expr, v.symbol, 0, SERIES_ORDER + 1).removeO()
+        expr = sp.expand(expr)
+        if not v.runtime:
+            poly = sp.Poly(expr, v.symbol)
+            even = sp.Integer(0)
+            for (power,), coeff in poly.terms():
+                if power % 2 != 0:
+                    raise ValueError('%s is not even in %s' % (expr, v.symbol))
+                even += coeff * v.sq_symbol**(power // 2)
+            expr = even
+    return expr
+
+
+def horner(expr, small_vars):
+    """Expansion in Horner form, with respect to the last small variable."""
+    v = small_vars[-1]
+    return sp.horner(expr, wrt=v.symbol if v.runtime else v.sq_symbol)
+
+
+def threshold(closed_form, var, small_vars, scalar):
+    """Largest |v| for which the first omitted term of the expansion in v
+    is below machine precision (relative to the leading term).
+
+    All other small variables are set to zero, other symbols to one.
+    """
+    expr = closed_form
+    for other in small_vars:
+        if other is not var:
+            expr = sp.limit(expr, other.symbol, 0)
+    expr = expr.subs({s: 1 for s in expr.free_symbols if s != var.symbol})
+    series = sp.series(expr, var.symbol, 0, SERIES_ORDER + 6).removeO()
+    terms = sp.Poly(sp.expand(series), var.symbol).terms()
+    terms = sorted((power, float(abs(coeff))) for (power,), coeff in terms)
+    leading = [c for p, c in terms if c != 0.]
+    omitted = [(p, c) for p, c in terms if p > SERIES_ORDER and c != 0.]
+    if not leading or not omitted:
+        return MAX_THRESHOLD
+    power, coeff = omitted[0]
+    t = (EPSILON[scalar] * leading[0] / coeff)**(1. / power)
+    return min(t, MAX_THRESHOLD)
+
+
+def one_sided_limit(closed_form, pole, direction, small_vars):
+    """Limit of the closed form for pole -> 0 from direction ('+' or '-').
+
+    Small variables known by their square are norms, hence positive.
+    """
+    positive = {v.symbol: sp.Symbol(v.symbol.name, positive=True)
+                for v in small_vars if not v.runtime}
+    expr = closed_form.subs(positive)
+    expr = sp.simplify(sp.limit(expr, pole, 0, direction))
+    return expr.subs({p: s for s, p in positive.items()})
+
+
+################################################################################
+# Kernels
+
+class Kernel(object):
+    """A single function of the generated struct.
+
+    definitions: list of (Symbol, expr) evaluated in order. An entry may also
+    be a Stage, which assigns its coefficients piecewise.
+    """
+
+    def __init__(self, name, doc, result_type, inputs, outputs, definitions):
+        self.name = name
+        self.doc = doc
+        self.result_type = result_type
+        # list of (argument type, argument name, list of symbols)
+        self.inputs = inputs
+        self.outputs = outputs
+        self.definitions = definitions
+
+
+def differentiate(kernel_name, doc, result_type, inputs, outputs, definitions,
+                  variables):
+    """Builds kernel computing d outputs / d variables.
+
+    Coefficients of a stage are functions of the small variables and the
+    other symbols defined before. For each coefficient c the stage is
+    extended by its derivatives, i.e. dc/dv / v for small variables which are
+    only known by their square (which keeps the coefficient even) and dc/ds
+    for all other symbols s.
+    """
+    new_definitions = []
+    # total derivatives of all defined symbols, d symbol / d variables
+    total = {}
+
+    def total_derivative(expr):
+        row = []
+        for x in variables:
+            d = sp.diff(expr, x)
+            for s in expr.free_symbols:
+                if s in total:
+                    d += sp.diff(expr, s) * total[s][len(row)]
+            row.append(d)
+        return row
+
+    for definition in definitions:
+        if isinstance(definition, Stage):
+            stage = definition
+            coefficients = list(stage.coefficients)
+            for v in stage.small_vars:
+                if not v.runtime:
+                    total[v.sq_symbol] = total_derivative(v.sq)
+            derived = []
+            for c, closed_form in stage.coefficients:
+                row = [sp.Integer(0)] * len(variables)
+                for s in sorted(closed_form.free_symbols, key=str):
+                    small = [v for v in stage.small_vars if v.symbol == s]
+                    if small and not small[0].runtime:
+                        # d/dx c = (dc/dv / v) * (1/2) d(v^2)/dx
+                        dc = sp.Symbol('%s_d%s' % (c.name, s.name))
+                        derived.append((dc, sp.diff(closed_form, s) / s))
+                        d_sq = total[small[0].sq_symbol]
+                        row = [r + dc * d_sq[i] / 2 for i, r in enumerate(row)]
+                    elif s in total or s in variables:
+                        dc = sp.Symbol('%s_d%s' % (c.name, s.name))
+                        derived.append((dc, sp.diff(closed_form, s)))
+                        d_s = total[s] if s in total else [
+                            sp.Integer(1) if x == s else sp.Integer(0)
+                            for x in variables]
+                        row = [r + dc * d_s[i] for i, r in enumerate(row)]
+                total[c] = row
+            new_definitions.append(Stage(stage.small_vars,
+                                         coefficients + derived,
+                                         stage.substitutions, stage.poles))
+        else:
+            symbol, expr = definition
+            new_definitions.append(definition)
+            total[symbol] = total_derivative(expr)
+
+    jacobian = sp.Matrix([total_derivative(o) for o in outputs])
+    return Kernel(kernel_name, doc, result_type, inputs, jacobian,
+                  new_definitions)
+
+
+def expansion_at_zero(outputs, definitions, variables):
+    """Outputs with all piecewise coefficients replaced by their expansions,
+    as polynomial in the variables. Only valid close to zero."""
+    subs = {}
+    for definition in definitions:
+        if isinstance(definition, Stage):
+            for v in definition.small_vars:
+                if not v.runtime:
+                    subs[v.sq_symbol] = v.sq.subs(subs)
+            for c, closed_form in definition.coefficients:
+                series = nested_series(closed_form, definition.small_vars)
+                subs[c] = series.subs(definition.substitutions).subs(subs)
+        else:
+            symbol, expr = definition
+            subs[symbol] = expr.subs(subs)
+    return [sp.expand(o.subs(subs)) for o in outputs]
+
+
+def internal_jacobian(group, params):
+    """d params(T * exp(x)) / dx at x = 0."""
+    x = group.tangent
+    exp_at_zero = expansion_at_zero(group.exp_outputs, group.exp_definitions,
+                                    x)
+    d_exp = sp.Matrix([[sp.diff(e, xi).subs({v: 0 for v in x})
+                        for xi in x] for e in exp_at_zero])
+    other = sp.symbols('q0:%d' % len(params))
+    product = sp.Matrix(group.multiply(params, other))
+    d_product = product.jacobian(other).subs(
+        dict(zip(other, group.identity)))
+    return d_product * d_exp
+
+
+################################################################################
+# Code emission
+
+class Emitter(object):
+
+    def __init__(self):
+        self.lines = []
+        self.indent = 2
+
+    def line(self, text=''):
+        self.lines.append((' ' * self.indent + text) if text else '')
+
+    def assignments(self, pairs, prefix, declare):
+        """CSE over all right hand sides, then assigns them."""
+        lhs = [l for l, _ in pairs]
+        temps, reduced = sp.cse([r for _, r in pairs],
+                                symbols=sp.numbered_symbols(prefix),
+                                optimizations='basic')
+        for t, e in temps:
+            self.line('const Scalar %s = %s;' % (t, cxx(e)))
+        for l, r in zip(lhs, reduced):
+            self.line('%s%s = %s;' % ('const Scalar ' if declare else '', l,
+                                      cxx(r)))
+
+    def stage(self, stage, used):
+        coefficients = [(c, e) for c, e in stage.coefficients if c in used]
+        if not coefficients:
+            return
+        self.line('Scalar %s;' % ', '.join(c.name for c, _ in coefficients))
+        # only small variables some of the coefficients depend on
+        small_vars = [v for v in stage.small_vars
+                      if any(v.symbol in e.free_symbols
+                             for _, e in coefficients)]
+        thresholds = {}
+        for v in small_vars:
+            if not v.runtime:
+                self.line('const Scalar %s = %s;' % (v.sq_symbol, cxx(v.sq)))
+            thresholds[v] = {
+                scalar: min(threshold(e, v, small_vars, scalar)
+                            for _, e in coefficients)
+                for scalar in EPSILON}
+        self.branches(stage, small_vars, coefficients, thresholds, 0, [])
+
+    def branches(self, stage, small_vars, coefficients, thresholds, i,
+                 small):
+        if i == len(small_vars):
+            if not small and stage.poles:
+                self.pole_branches(stage, coefficients, 0)
+                return
+            pairs = [(c.name, horner(nested_series(e, small), small)
+                      if small else e) for c, e in coefficients]
+            pairs = [(c, e.subs(stage.substitutions)) for c, e in pairs]
+            self.assignments(pairs, 'b', False)
+            return
+        v = small_vars[i]
+        t = thresholds[v]
+        if v.runtime:
+            cond = 'abs(%s) < generatedThreshold<Scalar>(%.6g, %.6g)' % (
+                v.symbol, t['double'], t['float'])
+        else:
+            ref = '' if v.ref_sq == 1 else ' * (%s)' % cxx(v.ref_sq)
+            cond = '%s < generatedThreshold<Scalar>(%.6g, %.6g)%s' % (
+                v.sq_symbol, t['double']**2, t['float']**2, ref)
+        self.line('if (%s) {' % cond)
+        self.indent += 2
+        self.branches(stage, small_vars, coefficients, thresholds, i + 1,
+                      small + [v])
+        self.indent -= 2
+        self.line('} else {')
+        self.indent += 2
+        if not v.runtime:
+            self.line('const Scalar %s = sqrt(%s);' % (v.symbol,
+                                                       v.sq_symbol))
+        self.branches(stage, small_vars, coefficients, thresholds, i + 1,
+                      small)
+        self.indent -= 2
+        self.line('}')
+
+    def pole_branches(self, stage, coefficients, i):
+        """Closed forms, with one-sided limits if |pole| < epsilon."""
+        if i == len(stage.poles):
+            pairs = [(c.name, e.subs(stage.substitutions))
+                     for c, e in coefficients]
+            self.assignments(pairs, 'b', False)
+            return
+        pole = stage.poles[i]
+        limits = {}
+        for direction in ('+', '-'):
+            limits[direction] = [
+                (c, one_sided_limit(e, pole, direction, stage.small_vars))
+                for c, e in coefficients]
+        self.line('if (abs(%s) < SophusConstants<Scalar>::epsilon()) {' %
+                  pole)
+        self.indent += 2
+        if limits['+'] == limits['-']:
+            self.pole_branches(stage, limits['+'], i + 1)
+        else:
+            self.line('if (%s > Scalar(0)) {' % pole)
+            self.indent += 2
+            self.pole_branches(stage, limits['+'], i + 1)
+            self.indent -= 2
+            self.line('} else {')
+            self.indent += 2
+            self.pole_branches(stage, limits['-'], i + 1)
+            self.indent -= 2
+            self.line('}')
+        self.indent -= 2
+        self.line('} else {')
+        self.indent += 2
+        self.pole_branches(stage, coefficients, i + 1)
+        self.indent -= 2
+        self.line('}')
+
+    def kernel(self, kernel):
+        outputs = sp.Matrix(kernel.outputs)
+        used = set(outputs.free_symbols)
+        # symbols needed by definitions which are needed, back to front
+        for definition in reversed(kernel.definitions):
+            if isinstance(definition, Stage):
+                for c, e in definition.coefficients:
+                    if c in used:
+                        used |= e.free_symbols
+                        for v in definition.small_vars:
+                            used |= v.sq.free_symbols if v.sq is not None \
+                                else set([v.symbol])
+                            used |= v.ref_sq.free_symbols
+            elif definition[0] in used:
+                used |= definition[1].free_symbols
+
+        self.line('/**')
+        for doc_line in kernel.doc.split('\n'):
+            self.line((' * ' + doc_line).rstrip())
+        self.line(' */')
+        # unused arguments are not named, to avoid warnings
+        args = ', '.join(
+            'const %s& %s' % (t, n if used & set(symbols) else '/*%s*/' % n)
+            for t, n, symbols in kernel.inputs)
+        self.line('inline static %s %s(%s) {' % (kernel.result_type,
+                                                 kernel.name, args))
+        self.indent += 2
+        functions = ['abs', 'atan', 'atan2', 'cos', 'exp', 'log', 'sin',
+                     'sqrt', 'tan']
+        for f in functions:
+            self.line('using std::%s;' % f)
+        self.line()
+        for _, name, symbols in kernel.inputs:
+            for i, s in enumerate(symbols):
+                if s in used:
+                    self.line('const Scalar %s = %s[%d];' % (s, name, i))
+        for definition in kernel.definitions:
+            if isinstance(definition, Stage):
+                self.stage(definition, used)
+            elif definition[0] in used:
+                self.line('const Scalar %s = %s;' % (definition[0],
+                                                     cxx(definition[1])))
+        self.line()
+        self.line('%s res;' % kernel.result_type)
+        pairs = []
+        for r in range(outputs.rows):
+            for c in range(outputs.cols):
+                lhs = 'res[%d]' % r if outputs.cols == 1 else \
+                    'res(%d, %d)' % (r, c)
+                pairs.append((lhs, outputs[r, c]))
+        self.assignments(pairs, 't', False)
+        self.line('return res;')
+        self.indent -= 2
+        self.line('}')
+
+
+LICENSE = '''// This file is part of Sophus.
+//
+// Copyright 2016 Hauke Strasdat
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights  to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+'''
+
+
+def write_header(group, directory):
+    kernels = [
+        Kernel('exp', 'Group exponential, returns parameters (see data()) of '
+               'exp(a)', 'Parameters', [('Tangent', 'a', group.tangent)],
+               group.exp_outputs, group.exp_definitions),
+        Kernel('log', 'Group logarithm of parameters p', 'Tangent',
+               [('Parameters', 'p', group.params)], group.log_outputs,
+               group.log_definitions),
+        Kernel('Adj', 'Adjoint transformation of parameters p', 'Adjoint',
+               [('Parameters', 'p', group.params)],
+               group.adj(group.params), []),
+        Kernel('internalJacobian',
+               'Derivative of parameters of p * exp(x) with respect to x at '
+               'x = 0', 'ParameterJacobian',
+               [('Parameters', 'p', group.params)],
+               internal_jacobian(group, group.params), []),
+        differentiate('Dx_exp', 'Derivative of parameters of exp(a) with '
+                      'respect to a', 'ParameterJacobian',
+                      [('Tangent', 'a', group.tangent)], group.exp_outputs,
+                      group.exp_definitions, group.tangent),
+        differentiate('Dx_log', 'Derivative of log(p) with respect to the '
+                      'parameters p', 'LogJacobian',
+                      [('Parameters', 'p', group.params)], group.log_outputs,
+                      group.log_definitions, group.params),
+    ]
+
+    name = group.name
+    guard = 'SOPHUS_GENERATED_%s_KERNELS_HPP' % name.upper()
+    e = Emitter()
+    for k in kernels:
+        e.line()
+        e.kernel(k)
+
+    with open(os.path.join(directory, '%s_kernels.hpp' % name.lower()),
+              'w') as f:
+        f.write(LICENSE)
+        f.write('''
+// This file was generated by py/generate_kernels.py, do not edit.
+
+#ifndef {guard}
+#define {guard}
+
+#include "generated.hpp"
+
+namespace Sophus {{
+namespace generated {{
+
+/**
+ * \\brief Closed-form kernels of {name}
+ *
+ * Parameters are laid out as in {name}Group::data().
+ */
+template <class Scalar>
+struct {name}Kernels {{
+  static const int DoF = {dof};
+  static const int num_parameters = {num_parameters};
+  typedef Eigen::Matrix<Scalar, DoF, 1> Tangent;
+  typedef Eigen::Matrix<Scalar, num_parameters, 1> Parameters;
+  typedef Eigen::Matrix<Scalar, DoF, DoF> Adjoint;
+  typedef Eigen::Matrix<Scalar, num_parameters, DoF> ParameterJacobian;
+  typedef Eigen::Matrix<Scalar, DoF, num_parameters> LogJacobian;
+'''.format(guard=guard, name=name, dof=len(group.tangent),
+           num_parameters=len(group.params)))
+        f.write('\n'.join(e.lines))
+        f.write('''
+}};
+}}  // namespace generated
+}}  // namespace Sophus
+
+#endif  // {guard}
+'''.format(guard=guard))
+
+
+def write_common_header(directory):
+    with open(os.path.join(directory, 'generated.hpp'), 'w') as f:
+        f.write(LICENSE)
+        f.write('''
+// This file was generated by py/generate_kernels.py, do not edit.
+
+#ifndef SOPHUS_GENERATED_HPP
+#define SOPHUS_GENERATED_HPP
+
+#include <cmath>
+#include <type_traits>
+
+#include <Eigen/Core>
+
+#include "../sophus.hpp"
+
+namespace Sophus {
+namespace generated {
+
+/**
+ * \\brief Threshold below which Taylor expansions are used
+ *
+ * The thresholds are chosen such that the first omitted term of the
+ * expansion is below the machine precision of Scalar. Types other than float
+ * (double, automatic differentiation types) use the double threshold.
+ */
+template <class Scalar>
+inline Scalar generatedThreshold(double for_double, double for_float) {
+  return Scalar(std::is_same<Scalar, float>::value ? for_float : for_double);
+}
+}  // namespace generated
+}  // namespace Sophus
+
+#endif  // SOPHUS_GENERATED_HPP
+''')
+
+
+################################################################################
+# Groups
+
+def cross(a, b):
+    return [a[1] * b[2] - a[2] * b[1],
+            a[2] * b[0] - a[0] * b[2],
+            a[0] * b[1] - a[1] * b[0]]
+
+
+def dot(a, b):
+    return sum(x * y for x, y in zip(a, b))
+
+
+def quaternion_product(a, b):
+    # (x, y, z, w) layout of Eigen::Quaternion::coeffs()
+    av, aw = a[:3], a[3]
+    bv, bw = b[:3], b[3]
+    c = cross(av, bv)
+    return [aw * bv[i] + bw * av[i] + c[i] for i in range(3)] + \
+        [aw * bw - dot(av, bv)]
+
+
+def quaternion_sandwich(q, p):
+    """q p q^*, i.e. |q|^2 R(q) p."""
+    v, w = q[:3], q[3]
+    c = cross(v, p)
+    vp = dot(v, p)
+    return [(w * w - dot(v, v)) * p[i] + 2 * vp * v[i] + 2 * w * c[i]
+            for i in range(3)]
+
+
+def quaternion_matrix(q):
+    """|q|^2 R(q)"""
+    columns = [quaternion_sandwich(q, e) for e in
+               ([1, 0, 0], [0, 1, 0], [0, 0, 1])]
+    return sp.Matrix(3, 3, lambda r, c: columns[c][r])
+
+
+def skew(v):
+    return sp.Matrix([[0, -v[2], v[1]], [v[2], 0, -v[0]],
+                      [-v[1], v[0], 0]])
+
+
+class Group(object):
+    pass
+
+
+theta = sp.Symbol('theta')
+sigma = sp.Symbol('sigma')
+n = sp.Symbol('n')
+k = sp.Symbol('k')
+scale = sp.Symbol('scale')
+
+
+def so3_exp_stage(omega):
+    v = SmallVar(theta, sq=dot(omega, omega))
+    imag, real = sp.symbols('imag_factor real_factor')
+    stage = Stage([v], [(imag, sp.sin(theta / 2) / theta),
+                        (real, sp.cos(theta / 2))])
+    return stage, imag, real
+
+
+def so3_log_stage(q):
+    """k = 2 atan(n / w) / n, with expansion for small n / w.
+
+    At w = 0 (rotation by pi) k is +-pi / n, with the sign convention of
+    SO3Group::log() (negative for w = 0).
+    """
+    v = SmallVar(n, sq=dot(q[:3], q[:3]), ref_sq=q[3]**2)
+    return Stage([v], [(k, 2 * sp.atan(n / q[3]) / n)], poles=[q[3]])
+
+
+def so2():
+    g = Group()
+    g.name = 'SO2'
+    g.params = list(sp.symbols('p0:2'))
+    g.tangent = [sp.Symbol('a0')]
+    g.identity = [1, 0]
+    a = g.tangent[0]
+    g.exp_outputs = [sp.cos(a), sp.sin(a)]
+    g.exp_definitions = []
+    g.log_outputs = [sp.atan2(g.params[1], g.params[0])]
+    g.log_definitions = []
+    g.adj = lambda p: sp.Matrix([[1]])
+    g.multiply = lambda a, b: [a[0] * b[0] - a[1] * b[1],
+                               a[0] * b[1] + a[1] * b[0]]
+    return g
+
+
+def se2():
+    g = Group()
+    g.name = 'SE2'
+    g.params = list(sp.symbols('p0:4'))
+    g.tangent = list(sp.symbols('a0:3'))
+    g.identity = [1, 0, 0, 0]
+    a = g.tangent
+    s, c = sp.symbols('sin_theta_by_theta one_minus_cos_theta_by_theta')
+    g.exp_definitions = [
+        (theta, a[2]),
+        Stage([SmallVar(theta)], [(s, sp.sin(theta) / theta),
+                                  (c, (1 - sp.cos(theta)) / theta)])]
+    g.exp_outputs = [sp.cos(theta), sp.sin(theta), s * a[0] - c * a[1],
+                     c * a[0] + s * a[1]]
+
+    p = g.params
+    f = sp.Symbol('halftheta_by_tan_of_halftheta')
+    g.log_definitions = [
+        (theta, sp.atan2(p[1], p[0])),
+        Stage([SmallVar(theta)], [(f, theta / 2 / sp.tan(theta / 2))])]
+    g.log_outputs = [f * p[2] + theta / 2 * p[3],
+                     -theta / 2 * p[2] + f * p[3], theta]
+
+    g.adj = lambda p: sp.Matrix([[p[0], -p[1], p[3]],
+                                 [p[1], p[0], -p[2]],
+                                 [0, 0, 1]])
+    g.multiply = lambda a, b: [a[0] * b[0] - a[1] * b[1],
+                               a[0] * b[1] + a[1] * b[0],
+                               a[2] + a[0] * b[2] - a[1] * b[3],
+                               a[3] + a[1] * b[2] + a[0] * b[3]]
+    return g
+
+
+def so3():
+    g = Group()
+    g.name = 'SO3'
+    g.params = list(sp.symbols('p0:4'))
+    g.tangent = list(sp.symbols('a0:3'))
+    g.identity = [0, 0, 0, 1]
+    stage, imag, real = so3_exp_stage(g.tangent)
+    g.exp_definitions = [stage]
+    g.exp_outputs = [imag * a for a in g.tangent] + [real]
+    g.log_definitions = [so3_log_stage(g.params)]
+    g.log_outputs = [k * p for p in g.params[:3]]
+    g.adj = quaternion_matrix
+    g.multiply = quaternion_product
+    return g
+
+
+def se3():
+    g = Group()
+    g.name = 'SE3'
+    g.params = list(sp.symbols('p0:7'))
+    g.tangent = list(sp.symbols('a0:6'))
+    g.identity = [0, 0, 0, 1, 0, 0, 0]
+    upsilon, omega = g.tangent[:3], g.tangent[3:]
+    stage, imag, real = so3_exp_stage(omega)
+    A, B = sp.symbols('A B')
+    stage.coefficients += [(A, (1 - sp.cos(theta)) / theta**2),
+                           (B, (theta - sp.sin(theta)) / theta**3)]
+    g.exp_definitions = [stage]
+    w_x_u = cross(omega, upsilon)
+    w_x_w_x_u = cross(omega, w_x_u)
+    g.exp_outputs = [imag * w for w in omega] + [real] + \
+        [upsilon[i] + A * w_x_u[i] + B * w_x_w_x_u[i] for i in range(3)]
+
+    q, t = g.params[:4], g.params[4:]
+    c = sp.Symbol('c')
+    omega = [k * x for x in q[:3]]
+    g.log_definitions = [
+        so3_log_stage(q),
+        Stage([SmallVar(theta, sq=k**2 * dot(q[:3], q[:3]))],
+              [(c, (1 - theta / (2 * sp.tan(theta / 2))) / theta**2)])]
+    w_x_t = cross(omega, t)
+    w_x_w_x_t = cross(omega, w_x_t)
+    g.log_outputs = [t[i] - w_x_t[i] / 2 + c * w_x_w_x_t[i]
+                     for i in range(3)] + omega
+
+    def adj(p):
+        R = quaternion_matrix(p[:4])
+        res = sp.zeros(6, 6)
+        res[:3, :3] = R
+        res[3:, 3:] = R
+        res[:3, 3:] = skew(p[4:]) * R
+        return res
+
+    g.adj = adj
+
+    def multiply(a, b):
+        t = quaternion_sandwich(a[:4], b[4:])
+        return quaternion_product(a[:4], b[:4]) + \
+            [a[4 + i] + t[i] for i in range(3)]
+
+    g.multiply = multiply
+    return g
+
+
+def rxso3():
+    g = Group()
+    g.name = 'RxSO3'
+    g.params = list(sp.symbols('p0:4'))
+    g.tangent = list(sp.symbols('a0:4'))
+    g.identity = [0, 0, 0, 1]
+    stage, imag, real = so3_exp_stage(g.tangent[:3])
+    sqrt_scale = sp.Symbol('sqrt_scale')
+    g.exp_definitions = [(sqrt_scale, sp.exp(g.tangent[3] / 2)), stage]
+    g.exp_outputs = [sqrt_scale * imag * a for a in g.tangent[:3]] + \
+        [sqrt_scale * real]
+    q = g.params
+    g.log_definitions = [so3_log_stage(q)]
+    g.log_outputs = [k * p for p in q[:3]] + [sp.log(dot(q, q))]
+    g.adj = lambda p: sp.diag(quaternion_matrix(p) / dot(p, p), 1)
+    g.multiply = quaternion_product
+    return g
+
+
+def sim3_w_coefficients():
+    """W = A Omega + B Omega^2 + C I, see Sim3GroupBase::calcW."""
+    s = sp.exp(sigma)
+    C = (s - 1) / sigma
+    c = theta**2 + sigma**2
+    A = (s * sp.sin(theta) * sigma + (1 - s * sp.cos(theta)) * theta) / \
+        (theta * c)
+    B = (C - ((s * sp.cos(theta) - 1) * sigma + s * sp.sin(theta) * theta) /
+         c) / theta**2
+    return A, B, C
+
+
+def sim3_w_inv_coefficients(A, B, C, theta_sq):
+    """W^-1 = a Omega + b Omega^2 + c I, in terms of the coefficients of W.
+
+    Solves W W^-1 = I using Omega^3 = -theta^2 Omega. The result is regular
+    for theta -> 0, so only A, B and C need expansions.
+    """
+    a, b = sp.symbols('a b')
+    c = 1 / C
+    omega_coeff = A * c + C * a - theta_sq * (A * b + B * a)
+    omega_sq_coeff = A * a + B * c + C * b - theta_sq * B * b
+    solution = sp.solve([omega_coeff, omega_sq_coeff], [a, b], dict=True)[0]
+    return (sp.factor(solution[a]), sp.factor(solution[b]), c)
+
+
+def sim3():
+    g = Group()
+    g.name = 'Sim3'
+    g.params = list(sp.symbols('p0:7'))
+    g.tangent = list(sp.symbols('a0:7'))
+    g.identity = [0, 0, 0, 1, 0, 0, 0]
+    upsilon, omega = g.tangent[:3], g.tangent[3:6]
+    stage, imag, real = so3_exp_stage(omega)
+    A, B, C = sp.symbols('A B C')
+    A_, B_, C_ = sim3_w_coefficients()
+    sqrt_scale = sp.Symbol('sqrt_scale')
+    stage.small_vars.append(SmallVar(sigma))
+    stage.coefficients += [(A, A_), (B, B_), (C, C_)]
+    stage.substitutions = {sp.exp(sigma): sqrt_scale**2}
+    g.exp_definitions = [(sigma, g.tangent[6]),
+                         (sqrt_scale, sp.exp(sigma / 2)), stage]
+    w_x_u = cross(omega, upsilon)
+    w_x_w_x_u = cross(omega, w_x_u)
+    g.exp_outputs = [sqrt_scale * imag * w for w in omega] + \
+        [sqrt_scale * real] + \
+        [C * upsilon[i] + A * w_x_u[i] + B * w_x_w_x_u[i] for i in range(3)]
+
+    q, t = g.params[:4], g.params[4:]
+    a, b, c = sp.symbols('a b c')
+    omega = [k * x for x in q[:3]]
+    log_stage = Stage([SmallVar(theta, sq=k**2 * dot(q[:3], q[:3])),
+                       SmallVar(sigma)], [(A, A_), (B, B_), (C, C_)],
+                      {sp.exp(sigma): scale})
+    a_, b_, c_ = sim3_w_inv_coefficients(A, B, C,
+                                         log_stage.small_vars[0].sq_symbol)
+    g.log_definitions = [
+        so3_log_stage(q),
+        (scale, dot(q, q)),
+        (sigma, sp.log(scale)),
+        log_stage,
+        (a, a_), (b, b_), (c, c_)]
+    w_x_t = cross(omega, t)
+    w_x_w_x_t = cross(omega, w_x_t)
+    g.log_outputs = [c * t[i] + a * w_x_t[i] + b * w_x_w_x_t[i]
+                     for i in range(3)] + omega + [sigma]
+
+    def adj(p):
+        q, t = p[:4], p[4:]
+        s = dot(q, q)
+        R = quaternion_matrix(q) / s
+        res = sp.zeros(7, 7)
+        res[:3, :3] = s * R
+        res[:3, 3:6] = skew(t) * R
+        res[:3, 6] = [-x for x in t]
+        res[3:6, 3:6] = R
+        res[6, 6] = 1
+        return res
+
+    g.adj = adj
+
+    def multiply(a, b):
+        t = quaternion_sandwich(a[:4], b[4:])
+        return quaternion_product(a[:4], b[:4]) + \
+            [a[4 + i] + t[i] for i in range(3)]
+
+    g.multiply = multiply
+    return g
+
+
+GROUPS = [so2, se2, so3, se3, rxso3, sim3]
+
+
+def main():
+    directory = sys.argv[1] if len(sys.argv) > 1 else os.path.join(
+        os.path.dirname(os.path.abspath(__file__)), '..', 'sophus',
+        'generated')
+    write_common_header(directory)
+    for group in GROUPS:
+        g = group()
+        print('Generating %s kernels' % g.name)
+        write_header(g, directory)
+
+
+if __name__ == '__main__':
+    main()
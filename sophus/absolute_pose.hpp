@@ -0,0 +1,411 @@
+// This file is part of Sophus.
+//
+// Copyright 2016 Hauke Strasdat
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights  to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+
+#ifndef SOPHUS_ABSOLUTE_POSE_HPP
+#define SOPHUS_ABSOLUTE_POSE_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+#include <Eigen/Cholesky>
+#include <Eigen/LU>
+#include <Eigen/StdVector>
+
+#include "batch.hpp"
+#include "se3.hpp"
+
+namespace Sophus {
+namespace details {
+
+// Real roots of x^2 + b x + c, without cancellation. False if there are none.
+template <typename Scalar>
+bool quadraticRoots(Scalar b, Scalar c, Scalar* r1, Scalar* r2) {
+  using std::sqrt;
+  const Scalar discriminant = b * b - 4 * c;
+  if (discriminant < 0) {
+    return false;
+  }
+  const Scalar q = Scalar(-0.5) * (b + (b < 0 ? -1 : 1) * sqrt(discriminant));
+  *r1 = q;
+  *r2 = q != 0 ? c / q : Scalar(0);
+  return true;
+}
+
+// One real root of x^3 + b x^2 + c x + d, from an initial guess on the
+// outer flank of the cubic refined with Newton's method.
+template <typename Scalar>
+Scalar cubicRoot(Scalar b, Scalar c, Scalar d) {
+  using std::abs;
+  using std::sqrt;
+  Scalar r;
+  if (b * b >= 3 * c) {
+    // two stationary points; approximate quadratically around the outer one
+    const Scalar v = sqrt(b * b - 3 * c);
+    const Scalar t1 = (-b - v) / 3;
+    const Scalar k1 = ((t1 + b) * t1 + c) * t1 + d;
+    if (k1 > 0) {
+      r = t1 - sqrt(-k1 / (3 * t1 + b));
+    } else {
+      const Scalar t2 = (-b + v) / 3;
+      const Scalar k2 = ((t2 + b) * t2 + c) * t2 + d;
+      r = t2 + sqrt(-k2 / (3 * t2 + b));
+    }
+  } else {
+    r = -b / 3;
+    if (abs((3 * r + 2 * b) * r + c) < Scalar(1e-4)) {
+      r += 1;
+    }
+  }
+  for (int i = 0; i < 50; ++i) {
+    const Scalar f = ((r + b) * r + c) * r + d;
+    if (i >= 7 && abs(f) <= std::numeric_limits<Scalar>::epsilon()) {
+      break;
+    }
+    const Scalar df = (3 * r + 2 * b) * r + c;
+    if (df == 0) {
+      break;
+    }
+    r -= f / df;
+  }
+  return r;
+}
+
+// Eigen decomposition of the symmetric 3x3 matrix A, which is known to be
+// singular: the columns of E are the eigenvectors of the eigenvalues L[0]
+// and L[1], ordered by decreasing magnitude, and of the eigenvalue 0.
+template <typename Scalar>
+void singularSymmetricEigen(const Eigen::Matrix<Scalar, 3, 3>& A,
+                            Eigen::Matrix<Scalar, 3, 3>* E,
+                            Eigen::Matrix<Scalar, 2, 1>* L) {
+  using std::abs;
+  using std::sqrt;
+  typedef Eigen::Matrix<Scalar, 3, 1> Vector3;
+  E->col(2) = A.row(0).cross(A.row(1)).transpose().normalized();
+  const Scalar b = -A.trace();
+  const Scalar a01_sq = A(0, 1) * A(0, 1);
+  const Scalar c = -a01_sq - A(0, 2) * A(0, 2) - A(1, 2) * A(1, 2) +
+                   A(0, 0) * (A(1, 1) + A(2, 2)) + A(1, 1) * A(2, 2);
+  Scalar e1 = 0, e2 = 0;
+  quadraticRoots(b, c, &e1, &e2);
+  if (abs(e1) < abs(e2)) {
+    std::swap(e1, e2);
+  }
+  (*L)[0] = e1;
+  (*L)[1] = e2;
+  const Scalar prec0 = A(0, 1) * A(1, 2) - A(0, 2) * A(1, 1);
+  const Scalar prec1 = A(0, 1) * A(0, 2) - A(0, 0) * A(1, 2);
+  for (int k = 0; k < 2; ++k) {
+    const Scalar e = (*L)[k];
+    const Scalar inv = 1 / (e * (A(0, 0) + A(1, 1)) - A(0, 0) * A(1, 1) -
+                            e * e + a01_sq);
+    const Vector3 v(-(e * A(0, 2) + prec0) * inv,
+                    -(e * A(1, 2) + prec1) * inv, Scalar(1));
+    E->col(k) = v / sqrt(v.squaredNorm());
+  }
+}
+}  // namespace details
+
+/**
+ * \brief Minimal absolute pose from three bearing / point pairs (P3P)
+ *
+ * Finds the camera poses T_cw with T_cw * points[i] = lambda_i * bearings[i]
+ * and positive depths lambda_i, with the Lambda Twist method of Persson and
+ * Nordberg, "Lambda Twist: An Accurate Fast Robust Perspective Three Point
+ * (P3P) Solver", ECCV 2018. The bearings need not be normalized.
+ *
+ * Writes up to four solutions to T_cw and returns their number. No memory is
+ * allocated.
+ */
+template <typename Scalar>
+int p3p(const Eigen::Matrix<Scalar, 3, 1> bearings[3],
+        const Eigen::Matrix<Scalar, 3, 1> points[3], SE3Group<Scalar>* T_cw) {
+  using std::abs;
+  using std::max;
+  using std::sqrt;
+  typedef Eigen::Matrix<Scalar, 3, 1> Vector3;
+  typedef Eigen::Matrix<Scalar, 3, 3> Matrix3;
+
+  const Vector3 y1 = bearings[0].normalized();
+  const Vector3 y2 = bearings[1].normalized();
+  const Vector3 y3 = bearings[2].normalized();
+  const Scalar b12 = -2 * y1.dot(y2);
+  const Scalar b13 = -2 * y1.dot(y3);
+  const Scalar b23 = -2 * y2.dot(y3);
+
+  const Vector3 d12 = points[0] - points[1];
+  const Vector3 d13 = points[0] - points[2];
+  const Vector3 d12xd13 = d12.cross(d13);
+  const Scalar a12 = d12.squaredNorm();
+  const Scalar a13 = d13.squaredNorm();
+  const Scalar a23 = (points[1] - points[2]).squaredNorm();
+
+  // cubic of the degenerate conic D1 - g * D2
+  const Scalar c31 = Scalar(-0.5) * b13;
+  const Scalar c23 = Scalar(-0.5) * b23;
+  const Scalar c12 = Scalar(-0.5) * b12;
+  const Scalar blob = c12 * c23 * c31 - 1;
+  const Scalar s31_sq = 1 - c31 * c31;
+  const Scalar s23_sq = 1 - c23 * c23;
+  const Scalar s12_sq = 1 - c12 * c12;
+  Scalar p3 = a13 * (a23 * s31_sq - a13 * s23_sq);
+  Scalar p2 = 2 * blob * a23 * a13 + a13 * (2 * a12 + a13) * s23_sq +
+              a23 * (a23 - a12) * s31_sq;
+  Scalar p1 = a23 * (a13 - a23) * s12_sq - a12 * a12 * s23_sq -
+              2 * a12 * (blob * a23 + a13 * s23_sq);
+  Scalar p0 = a12 * (a12 * s23_sq - a23 * s12_sq);
+  if (p3 == 0) {
+    return 0;
+  }
+  p2 /= p3;
+  p1 /= p3;
+  p0 /= p3;
+  const Scalar g = details::cubicRoot(p2, p1, p0);
+
+  Matrix3 A;
+  A(0, 0) = a23 * (1 - g);
+  A(0, 1) = A(1, 0) = Scalar(0.5) * a23 * b12;
+  A(0, 2) = A(2, 0) = Scalar(-0.5) * a23 * b13 * g;
+  A(1, 1) = a23 - a12 + a13 * g;
+  A(1, 2) = A(2, 1) = Scalar(0.5) * b23 * (a13 * g - a12);
+  A(2, 2) = g * (a13 - a23) - a12;
+  Matrix3 V;
+  Eigen::Matrix<Scalar, 2, 1> L;
+  details::singularSymmetricEigen(A, &V, &L);
+  const Scalar v = sqrt(max(Scalar(0), -L[1] / L[0]));
+
+  // depths (lambda_1, lambda_2, lambda_3) of up to four solutions
+  Vector3 lambdas[4];
+  int num_lambdas = 0;
+  for (int sign = -1; sign <= 1; sign += 2) {
+    const Scalar s = sign * v;
+    const Scalar w2 = 1 / (s * V(0, 1) - V(0, 0));
+    const Scalar w0 = (V(1, 0) - s * V(1, 1)) * w2;
+    const Scalar w1 = (V(2, 0) - s * V(2, 1)) * w2;
+    const Scalar a = 1 / ((a13 - a12) * w1 * w1 - a12 * b13 * w1 - a12);
+    const Scalar b =
+        (a13 * b12 * w1 - a12 * b13 * w0 - 2 * w0 * w1 * (a12 - a13)) * a;
+    const Scalar c = ((a13 - a12) * w0 * w0 + a13 * b12 * w0 + a13) * a;
+    Scalar taus[2];
+    if (!details::quadraticRoots(b, c, &taus[0], &taus[1])) {
+      continue;
+    }
+    for (Scalar tau : taus) {
+      if (!(tau > 0)) {
+        continue;
+      }
+      const Scalar d = a23 / (tau * (b23 + tau) + 1);
+      if (!(d > 0)) {
+        continue;
+      }
+      const Scalar l2 = sqrt(d);
+      const Scalar l3 = tau * l2;
+      const Scalar l1 = w0 * l2 + w1 * l3;
+      if (l1 >= 0) {
+        lambdas[num_lambdas++] = Vector3(l1, l2, l3);
+      }
+    }
+  }
+
+  const Matrix3 X = (Matrix3() << d12, d13, d12xd13).finished().inverse();
+  int num_solutions = 0;
+  for (int k = 0; k < num_lambdas; ++k) {
+    // Gauss-Newton on the three distance constraints
+    Vector3& l = lambdas[k];
+    for (int i = 0; i < 5; ++i) {
+      const Vector3 r(l[0] * l[0] + l[1] * l[1] + b12 * l[0] * l[1] - a12,
+                      l[0] * l[0] + l[2] * l[2] + b13 * l[0] * l[2] - a13,
+                      l[1] * l[1] + l[2] * l[2] + b23 * l[1] * l[2] - a23);
+      if (r.template lpNorm<1>() < Scalar(1e-10)) {
+        break;
+      }
+      Matrix3 J;
+      J << 2 * l[0] + b12 * l[1], 2 * l[1] + b12 * l[0], 0,
+          2 * l[0] + b13 * l[2], 0, 2 * l[2] + b13 * l[0],  //
+          0, 2 * l[1] + b23 * l[2], 2 * l[2] + b23 * l[1];
+      l -= J.inverse() * r;
+    }
+    const Vector3 ry1 = l[0] * y1;
+    const Vector3 yd1 = ry1 - l[1] * y2;
+    const Vector3 yd2 = ry1 - l[2] * y3;
+    const Matrix3 R =
+        (Matrix3() << yd1, yd2, yd1.cross(yd2)).finished() * X;
+    if (!R.allFinite()) {
+      continue;
+    }
+    const SO3Group<Scalar> so3((Eigen::Quaternion<Scalar>(R)));
+    T_cw[num_solutions++] = SE3Group<Scalar>(so3, ry1 - so3 * points[0]);
+  }
+  return num_solutions;
+}
+
+/**
+ * \brief Levenberg-Marquardt refinement of an absolute camera pose
+ *
+ * Minimizes sum |pi(T_cw * points[i]) - observations[i]|^2 with the pinhole
+ * projection pi(x) = (x / z, y / z), i.e. observations are normalized image
+ * coordinates (2 scalars each) and points world points (3 scalars each).
+ * Residuals and 2x6 pose Jacobians come from BatchOps<SE3Group>::reproject();
+ * the update is T_cw * exp(delta).
+ *
+ * \returns final cost 0.5 * sum |residual|^2
+ */
+template <typename Scalar>
+Scalar refineAbsolutePose(const Scalar* points, const Scalar* observations,
+                          std::size_t n, SE3Group<Scalar>* T_cw,
+                          int max_iterations = 10) {
+  typedef Eigen::Matrix<Scalar, 6, 6> Matrix6;
+  typedef Eigen::Matrix<Scalar, 6, 1> Vector6;
+  typedef Eigen::Matrix<Scalar, 2, 6, Eigen::RowMajor> PoseJacobian;
+  const Scalar camera[4] = {Scalar(1), Scalar(1), Scalar(0), Scalar(0)};
+  std::vector<Scalar> residuals(2 * n), jacobians(12 * n);
+
+  const auto evaluate = [&](const SE3Group<Scalar>& T, bool with_jacobians) {
+    BatchOps<SE3Group<Scalar> >::reproject(
+        T, camera, points, observations, residuals.data(),
+        with_jacobians ? jacobians.data() : NULL, NULL, n);
+    Scalar cost = 0;
+    for (Scalar r : residuals) {
+      cost += r * r;
+    }
+    return cost / 2;
+  };
+
+  Scalar cost = evaluate(*T_cw, true);
+  Scalar lambda = Scalar(1e-4);
+  for (int iteration = 0; iteration < max_iterations; ++iteration) {
+    Matrix6 H = Matrix6::Zero();
+    Vector6 g = Vector6::Zero();
+    for (std::size_t i = 0; i < n; ++i) {
+      const Eigen::Map<const PoseJacobian> J(&jacobians[12 * i]);
+      const Eigen::Map<const Eigen::Matrix<Scalar, 2, 1> > r(&residuals[2 * i]);
+      H.noalias() += J.transpose() * J;
+      g.noalias() += J.transpose() * r;
+    }
+    if (g.template lpNorm<Eigen::Infinity>() <=
+        std::numeric_limits<Scalar>::epsilon()) {
+      break;
+    }
+    bool improved = false;
+    while (!improved && lambda < Scalar(1e10)) {
+      Matrix6 H_damped = H;
+      H_damped.diagonal() *= 1 + lambda;
+      const Vector6 delta = -H_damped.ldlt().solve(g);
+      const SE3Group<Scalar> T_new = *T_cw * SE3Group<Scalar>::exp(delta);
+      const Scalar new_cost = evaluate(T_new, false);
+      if (new_cost < cost) {
+        *T_cw = T_new;
+        cost = evaluate(*T_cw, true);
+        lambda = std::max(lambda / 10, Scalar(1e-10));
+        improved = true;
+      } else {
+        lambda *= 10;
+      }
+    }
+    if (!improved) {
+      break;
+    }
+  }
+  return cost;
+}
+
+/**
+ * \brief Absolute camera pose from 2D-3D correspondences, for ransac()
+ *
+ * Model is the pose T_cw. Observations are normalized image coordinates
+ * (2 scalars each), points world points (3 scalars each), and the squared
+ * error of a correspondence is |pi(T_cw * point) - observation|^2, or
+ * infinity for points behind the camera. The minimal solver is p3p(), the
+ * non-minimal one refineAbsolutePose(). The buffers must outlive the
+ * problem.
+ */
+class AbsolutePoseProblem {
+ public:
+  typedef SE3Group<double> Model;
+  typedef std::vector<Model, Eigen::aligned_allocator<Model> > ModelVector;
+  static const int kSampleSize = 3;
+
+  AbsolutePoseProblem(const double* points, const double* observations,
+                      std::size_t n)
+      : points_(points), observations_(observations), n_(n) {}
+
+  std::size_t numData() const { return n_; }
+
+  void solveMinimal(const int* sample, ModelVector* models) const {
+    Eigen::Vector3d bearings[3];
+    Eigen::Vector3d points[3];
+    for (int i = 0; i < 3; ++i) {
+      bearings[i] = Eigen::Vector3d(observations_[2 * sample[i]],
+                                    observations_[2 * sample[i] + 1], 1);
+      points[i] = Eigen::Map<const Eigen::Vector3d>(points_ + 3 * sample[i]);
+    }
+    Model solutions[4];
+    const int num_solutions = p3p(bearings, points, solutions);
+    models->insert(models->end(), solutions, solutions + num_solutions);
+  }
+
+  bool solveNonMinimal(const std::vector<int>& inliers, Model* model) const {
+    std::vector<double> points(3 * inliers.size());
+    std::vector<double> observations(2 * inliers.size());
+    for (std::size_t i = 0; i < inliers.size(); ++i) {
+      std::copy(points_ + 3 * inliers[i], points_ + 3 * inliers[i] + 3,
+                &points[3 * i]);
+      std::copy(observations_ + 2 * inliers[i],
+                observations_ + 2 * inliers[i] + 2, &observations[2 * i]);
+    }
+    refineAbsolutePose(points.data(), observations.data(), inliers.size(),
+                       model);
+    return true;
+  }
+
+  void squaredErrors(const Model* models, std::size_t num_models,
+                     std::size_t begin, std::size_t end, double* errors,
+                     std::vector<double>* scratch) const {
+    const std::size_t m = end - begin;
+    std::vector<double>& transformed = *scratch;
+    transformed.resize(std::max(transformed.size(), 3 * m));
+    for (std::size_t h = 0; h < num_models; ++h) {
+      BatchOps<Model>::transformPoints(models[h], points_ + 3 * begin,
+                                       transformed.data(), m);
+      const double* observations = observations_ + 2 * begin;
+      double* errors_h = errors + h * m;
+      for (std::size_t i = 0; i < m; ++i) {
+        const double z = transformed[3 * i + 2];
+        const double du = transformed[3 * i] / z - observations[2 * i];
+        const double dv = transformed[3 * i + 1] / z - observations[2 * i + 1];
+        errors_h[i] = z > 0 ? du * du + dv * dv
+                            : std::numeric_limits<double>::infinity();
+      }
+    }
+  }
+
+ private:
+  const double* points_;
+  const double* observations_;
+  std::size_t n_;
+};
+}  // namespace Sophus
+
+#endif  // SOPHUS_ABSOLUTE_POSE_HPP
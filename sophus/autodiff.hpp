@@ -0,0 +1,181 @@
+// This file is part of Sophus.
+//
+// Copyright 2016 Hauke Strasdat
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights  to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#ifndef SOPHUS_AUTODIFF_HPP
+#define SOPHUS_AUTODIFF_HPP
+
+#include "dual.hpp"
+#include "sophus.hpp"
+
+// Declared here such that the traits below pick up ceres::Jet whenever
+// ceres/jet.h is included by the user, in whatever order and independent of
+// how Sophus was configured.
+namespace ceres {
+template <typename T, int N>
+struct Jet;
+}  // namespace ceres
+
+namespace Sophus {
+
+/**
+ * \brief Traits of forward-mode automatic differentiation scalars
+ *
+ * Specialized for Sophus::Dual and ceres::Jet. For all other scalars enabled
+ * is false.
+ *
+ * The groups use these traits to evaluate exp() and log() of autodiff scalars
+ * on the value type only, and then apply the closed-form Jacobian (see
+ * sophus/generated) to the derivative lanes. This is much cheaper than
+ * carrying all lanes through the generic implementation and does not depend
+ * on which side of an epsilon branch the value is.
+ */
+template <class Scalar>
+struct AutoDiffTraits {
+  static const bool enabled = false;
+};
+
+template <class T, int N>
+struct AutoDiffTraits<Dual<T, N> > {
+  static const bool enabled = true;
+  static const int num_lanes = N;
+  typedef T Value;
+  typedef Eigen::Matrix<T, N, 1> Lanes;
+
+  static const T& value(const Dual<T, N>& s) { return s.a; }
+  static const Lanes& lanes(const Dual<T, N>& s) { return s.v; }
+  static Dual<T, N> make(const T& value, const Lanes& lanes) {
+    return Dual<T, N>(value, lanes);
+  }
+};
+
+template <class T, int N>
+struct AutoDiffTraits<ceres::Jet<T, N> > {
+  static const bool enabled = true;
+  static const int num_lanes = N;
+  typedef T Value;
+  typedef Eigen::Matrix<T, N, 1> Lanes;
+
+  static const T& value(const ceres::Jet<T, N>& s) { return s.a; }
+  static const Lanes& lanes(const ceres::Jet<T, N>& s) { return s.v; }
+  static ceres::Jet<T, N> make(const T& value, const Lanes& lanes) {
+    ceres::Jet<T, N> res;
+    res.a = value;
+    res.v = lanes;
+    return res;
+  }
+};
+
+namespace details {
+
+// Values of a vector of autodiff scalars.
+template <class Derived>
+Eigen::Matrix<typename AutoDiffTraits<typename Derived::Scalar>::Value,
+              Derived::RowsAtCompileTime, 1>
+autoDiffValue(const Eigen::MatrixBase<Derived>& x) {
+  typedef AutoDiffTraits<typename Derived::Scalar> Traits;
+  Eigen::Matrix<typename Traits::Value, Derived::RowsAtCompileTime, 1> res;
+  for (int i = 0; i < x.size(); ++i) {
+    res[i] = Traits::value(x[i]);
+  }
+  return res;
+}
+
+// f(x) given the value of f and its Jacobian J at the value of x, i.e. the
+// derivative lanes of f are J times the lanes of x.
+template <class Value, int Rows, int Cols, class Derived>
+Eigen::Matrix<typename Derived::Scalar, Rows, 1> applyChainRule(
+    const Eigen::Matrix<Value, Rows, 1>& f_value,
+    const Eigen::Matrix<Value, Rows, Cols>& J,
+    const Eigen::MatrixBase<Derived>& x) {
+  typedef typename Derived::Scalar Scalar;
+  typedef AutoDiffTraits<Scalar> Traits;
+  Eigen::Matrix<Value, Cols, Traits::num_lanes> x_lanes;
+  for (int i = 0; i < Cols; ++i) {
+    x_lanes.row(i) = Traits::lanes(x[i]).transpose();
+  }
+  const Eigen::Matrix<Value, Rows, Traits::num_lanes> f_lanes = J * x_lanes;
+  Eigen::Matrix<Scalar, Rows, 1> f;
+  for (int i = 0; i < Rows; ++i) {
+    f[i] = Traits::make(f_value[i], f_lanes.row(i).transpose());
+  }
+  return f;
+}
+
+// exp() and log() of Group<Scalar> by the chain rule. The groups call these
+// only if AutoDiffTraits<Scalar>::enabled; the primary template just makes
+// the call compile for all other scalars.
+template <class Scalar, bool = AutoDiffTraits<Scalar>::enabled>
+struct ChainRule {
+  template <template <class, int> class Group, template <class> class Kernels,
+            class Derived>
+  static Group<Scalar, 0> exp(const Eigen::MatrixBase<Derived>&) {
+    return Group<Scalar, 0>();
+  }
+
+  template <template <class, int> class Group, template <class> class Kernels,
+            int Options>
+  static typename Group<Scalar, Options>::Tangent log(
+      const Group<Scalar, Options>&) {
+    return Group<Scalar, Options>::Tangent::Zero();
+  }
+};
+
+template <class Scalar>
+struct ChainRule<Scalar, true> {
+  typedef typename AutoDiffTraits<Scalar>::Value Value;
+
+  template <template <class, int> class Group, template <class> class Kernels,
+            class Derived>
+  static Group<Scalar, 0> exp(const Eigen::MatrixBase<Derived>& a) {
+    typedef Kernels<Value> K;
+
+    const typename K::Tangent a_value = autoDiffValue(a);
+    const Group<Value, 0> T_value = Group<Value, 0>::exp(a_value);
+    const typename K::Parameters p_value =
+        Eigen::Map<const typename K::Parameters>(T_value.data());
+
+    Group<Scalar, 0> T;
+    Eigen::Map<Eigen::Matrix<Scalar, K::num_parameters, 1> >(T.data()) =
+        applyChainRule(p_value, K::Dx_exp(a_value), a);
+    return T;
+  }
+
+  template <template <class, int> class Group, template <class> class Kernels,
+            int Options>
+  static typename Group<Scalar, Options>::Tangent log(
+      const Group<Scalar, Options>& T) {
+    typedef Kernels<Value> K;
+
+    const Eigen::Map<const Eigen::Matrix<Scalar, K::num_parameters, 1> > p(
+        T.data());
+    const typename K::Parameters p_value = autoDiffValue(p);
+    Group<Value, 0> T_value;
+    Eigen::Map<typename K::Parameters>(T_value.data()) = p_value;
+
+    const typename K::Tangent a_value = Group<Value, 0>::log(T_value);
+    return applyChainRule(a_value, K::Dx_log(p_value), p);
+  }
+};
+}  // namespace details
+}  // namespace Sophus
+
+#endif  // SOPHUS_AUTODIFF_HPP
@@ -0,0 +1,1210 @@
+// This file is part of Sophus.
+//
+// Copyright 2016 Hauke Strasdat
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights  to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#ifndef SOPHUS_BATCH_HPP
+#define SOPHUS_BATCH_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#include "cpu_features.hpp"
+#include "se3.hpp"
+
+// Batch kernels operate on many group elements, tangent vectors or points at
+// once. All buffers are tightly packed arrays in the internal data layout of
+// the groups, i.e. each SO3 element occupies SO3Group::num_parameters
+// consecutive scalars (quaternion x, y, z, w), each SE3 element
+// SE3Group::num_parameters scalars (quaternion followed by translation), and
+// each point three consecutive scalars. Tangent vectors use the ordering of
+// the corresponding Tangent type.
+//
+// The kernel bodies are compiled once per instruction set level (using the
+// target function attribute), and the best version for the host CPU is
+// picked at runtime (see BatchKernels::selected()). Most kernels are plain
+// loops over scalars which the auto-vectorizer turns into code using the
+// wider registers. The exp and log kernels need sqrt and selects, which GCC
+// only vectorizes with -fno-math-errno -fno-trapping-math, and sin, cos and
+// atan, which it does not vectorize at all. They, and se3IntegrateSplit()
+// which contains an exp, are therefore written for a generic lane type (see
+// details::ScalarLanes) and instantiated with vector types of the register
+// width of each level, using branch-free polynomial approximations of the
+// transcendental functions.
+//
+// Input and output buffers must not overlap.
+
+#if defined(_MSC_VER)
+#define SOPHUS_RESTRICT __restrict
+#else
+#define SOPHUS_RESTRICT __restrict__
+#endif
+
+#ifdef SOPHUS_ISA_DISPATCH
+#define SOPHUS_TARGET_SSE42 __attribute__((target("sse4.2")))
+#define SOPHUS_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#define SOPHUS_TARGET_AVX512 \
+  __attribute__((target("avx512f,avx512dq,avx512vl,avx2,fma")))
+
+// Vector lanes rely on __builtin_convertvector and the conditional operator
+// on vector types, and on SSE2 for sqrt.
+#if defined(__SSE2__) &&                              \
+    ((defined(__clang__) && __clang_major__ >= 11) || \
+     (!defined(__clang__) && __GNUC__ >= 9))
+#define SOPHUS_BATCH_VECTOR_LANES 1
+#include <emmintrin.h>
+#endif
+#endif
+
+namespace Sophus {
+namespace details {
+
+// Lanes of the exp and log kernels: Lanes::kWidth consecutive elements are
+// processed in parallel, with each scalar quantity held in a Lanes::Vector.
+// Vectors support the arithmetic operators, comparisons and the conditional
+// operator on the result of a comparison. All other operations take vectors
+// by reference, which keeps the vector types of the wider instruction set
+// levels out of the signatures of functions not compiled for them.
+//
+// ScalarLanes processes a single element, with Vector = Scalar.
+template <typename _Scalar>
+struct ScalarLanes {
+  typedef _Scalar Scalar;
+  typedef Scalar Vector;
+  static const int kWidth = 1;
+
+  // Loads p[0], p[stride], ..., p[(kWidth - 1) * stride] into v.
+  static EIGEN_ALWAYS_INLINE void load(const Scalar* p, int /*stride*/,
+                                       Vector* v) {
+    *v = *p;
+  }
+
+  // Inverse of load().
+  static EIGEN_ALWAYS_INLINE void store(const Vector& v, int /*stride*/,
+                                        Scalar* p) {
+    *p = v;
+  }
+
+  static EIGEN_ALWAYS_INLINE void sqrt(const Vector& v, Vector* result) {
+    using std::sqrt;
+    *result = sqrt(v);
+  }
+
+  // Rounds v to the nearest integer k, returning k and k modulo 4.
+  //
+  // Precondition: 0 <= v <= 2^30
+  static EIGEN_ALWAYS_INLINE void round(const Vector& v, Vector* k,
+                                        Vector* k_mod_4) {
+    const int i = static_cast<int>(v + Scalar(0.5));
+    *k = static_cast<Scalar>(i);
+    *k_mod_4 = static_cast<Scalar>(i & 3);
+  }
+};
+
+#ifdef SOPHUS_BATCH_VECTOR_LANES
+EIGEN_ALWAYS_INLINE __m128d sqrtChunk(__m128d v) { return _mm_sqrt_pd(v); }
+EIGEN_ALWAYS_INLINE __m128 sqrtChunk(__m128 v) { return _mm_sqrt_ps(v); }
+
+// Lanes of kBytes / sizeof(Scalar) elements in a GCC vector extension type.
+// Scalar must be float or double.
+template <typename _Scalar, int kBytes>
+struct VectorLanes {
+  typedef _Scalar Scalar;
+  static const int kWidth = kBytes / sizeof(Scalar);
+  typedef Scalar Vector __attribute__((vector_size(kBytes)));
+  typedef std::int32_t Int __attribute__((vector_size(4 * kWidth)));
+  typedef Scalar Chunk __attribute__((vector_size(16)));
+
+  static EIGEN_ALWAYS_INLINE void load(const Scalar* p, int stride,
+                                       Vector* v) {
+    Scalar lanes[kWidth];
+    for (int l = 0; l < kWidth; ++l) {
+      lanes[l] = p[stride * l];
+    }
+    std::memcpy(v, lanes, sizeof(Vector));
+  }
+
+  static EIGEN_ALWAYS_INLINE void store(const Vector& v, int stride,
+                                        Scalar* p) {
+    Scalar lanes[kWidth];
+    std::memcpy(lanes, &v, sizeof(Vector));
+    for (int l = 0; l < kWidth; ++l) {
+      p[stride * l] = lanes[l];
+    }
+  }
+
+  // In 16 byte chunks, such that only SSE2 is required. Within the wider
+  // instruction set levels the chunks are VEX/EVEX encoded.
+  static EIGEN_ALWAYS_INLINE void sqrt(const Vector& v, Vector* result) {
+    for (int c = 0; c < kBytes / 16; ++c) {
+      Chunk chunk;
+      std::memcpy(&chunk, reinterpret_cast<const char*>(&v) + 16 * c, 16);
+      chunk = sqrtChunk(chunk);
+      std::memcpy(reinterpret_cast<char*>(result) + 16 * c, &chunk, 16);
+    }
+  }
+
+  static EIGEN_ALWAYS_INLINE void round(const Vector& v, Vector* k,
+                                        Vector* k_mod_4) {
+    const Int i = __builtin_convertvector(v + Scalar(0.5), Int);
+    *k = __builtin_convertvector(i, Vector);
+    *k_mod_4 = __builtin_convertvector(i & 3, Vector);
+  }
+};
+#endif
+
+// Lane type of the exp and log kernels for registers of kBytes bytes, where
+// kBytes = 0 selects ScalarLanes.
+template <typename Scalar, int kBytes,
+          bool kVector = (kBytes > 0 &&
+                          (std::is_same<Scalar, float>::value ||
+                           std::is_same<Scalar, double>::value))>
+struct LanesFor {
+  typedef ScalarLanes<Scalar> type;
+};
+
+#ifdef SOPHUS_BATCH_VECTOR_LANES
+template <typename Scalar, int kBytes>
+struct LanesFor<Scalar, kBytes, true> {
+  typedef VectorLanes<Scalar, kBytes> type;
+};
+#endif
+
+template <typename Scalar>
+struct BatchKernelsImpl {
+  static const int kSO3Params = 4;
+  static const int kSE3Params = 7;
+
+  // Rotation matrix (row-major) of unit quaternion q = (x, y, z, w).
+  static EIGEN_ALWAYS_INLINE void quaternionToMatrix(const Scalar* q,
+                                                     Scalar* R) {
+    const Scalar tx = Scalar(2) * q[0];
+    const Scalar ty = Scalar(2) * q[1];
+    const Scalar tz = Scalar(2) * q[2];
+    const Scalar twx = tx * q[3];
+    const Scalar twy = ty * q[3];
+    const Scalar twz = tz * q[3];
+    const Scalar txx = tx * q[0];
+    const Scalar txy = ty * q[0];
+    const Scalar txz = tz * q[0];
+    const Scalar tyy = ty * q[1];
+    const Scalar tyz = tz * q[1];
+    const Scalar tzz = tz * q[2];
+    R[0] = Scalar(1) - (tyy + tzz);
+    R[1] = txy - twz;
+    R[2] = txz + twy;
+    R[3] = txy + twz;
+    R[4] = Scalar(1) - (txx + tzz);
+    R[5] = tyz - twx;
+    R[6] = txz - twy;
+    R[7] = tyz + twx;
+    R[8] = Scalar(1) - (txx + tyy);
+  }
+
+  static EIGEN_ALWAYS_INLINE void rotationTransformPoints(
+      const Scalar* R, const Scalar* t, const Scalar* SOPHUS_RESTRICT in,
+      Scalar* SOPHUS_RESTRICT out, std::size_t n) {
+    const Scalar r0 = R[0], r1 = R[1], r2 = R[2];
+    const Scalar r3 = R[3], r4 = R[4], r5 = R[5];
+    const Scalar r6 = R[6], r7 = R[7], r8 = R[8];
+    const Scalar t0 = t[0], t1 = t[1], t2 = t[2];
+    for (std::size_t i = 0; i < n; ++i) {
+      const Scalar x = in[3 * i];
+      const Scalar y = in[3 * i + 1];
+      const Scalar z = in[3 * i + 2];
+      out[3 * i] = r0 * x + r1 * y + r2 * z + t0;
+      out[3 * i + 1] = r3 * x + r4 * y + r5 * z + t1;
+      out[3 * i + 2] = r6 * x + r7 * y + r8 * z + t2;
+    }
+  }
+
+  static EIGEN_ALWAYS_INLINE void so3TransformPoints(
+      const Scalar* R_params, const Scalar* SOPHUS_RESTRICT in,
+      Scalar* SOPHUS_RESTRICT out, std::size_t n) {
+    Scalar R[9];
+    const Scalar t[3] = {Scalar(0), Scalar(0), Scalar(0)};
+    quaternionToMatrix(R_params, R);
+    rotationTransformPoints(R, t, in, out, n);
+  }
+
+  static EIGEN_ALWAYS_INLINE void se3TransformPoints(
+      const Scalar* T_params, const Scalar* SOPHUS_RESTRICT in,
+      Scalar* SOPHUS_RESTRICT out, std::size_t n) {
+    Scalar R[9];
+    quaternionToMatrix(T_params, R);
+    rotationTransformPoints(R, T_params + kSO3Params, in, out, n);
+  }
+
+  // Applies T * exp(offsets[i] * twist) to point i, with the exponential
+  // expanded to first order: out_i = T * (p_i + offsets[i] * (omega x p_i +
+  // upsilon)) for the twist (upsilon, omega).
+  static EIGEN_ALWAYS_INLINE void se3TransformPointsFirstOrder(
+      const Scalar* T_params, const Scalar* twist,
+      const Scalar* SOPHUS_RESTRICT offsets, const Scalar* SOPHUS_RESTRICT in,
+      Scalar* SOPHUS_RESTRICT out, std::size_t n) {
+    Scalar R[9];
+    quaternionToMatrix(T_params, R);
+    const Scalar r0 = R[0], r1 = R[1], r2 = R[2];
+    const Scalar r3 = R[3], r4 = R[4], r5 = R[5];
+    const Scalar r6 = R[6], r7 = R[7], r8 = R[8];
+    const Scalar t0 = T_params[4], t1 = T_params[5], t2 = T_params[6];
+    const Scalar u0 = twist[0], u1 = twist[1], u2 = twist[2];
+    const Scalar w0 = twist[3], w1 = twist[4], w2 = twist[5];
+    for (std::size_t i = 0; i < n; ++i) {
+      const Scalar x = in[3 * i];
+      const Scalar y = in[3 * i + 1];
+      const Scalar z = in[3 * i + 2];
+      const Scalar d = offsets[i];
+      const Scalar qx = x + d * (w1 * z - w2 * y + u0);
+      const Scalar qy = y + d * (w2 * x - w0 * z + u1);
+      const Scalar qz = z + d * (w0 * y - w1 * x + u2);
+      out[3 * i] = r0 * qx + r1 * qy + r2 * qz + t0;
+      out[3 * i + 1] = r3 * qx + r4 * qy + r5 * qz + t1;
+      out[3 * i + 2] = r6 * qx + r7 * qy + r8 * qz + t2;
+    }
+  }
+
+  // Quaternion product followed by the same first-order renormalization as
+  // SO3GroupBase::operator*=(). T is Scalar or a Lanes::Vector; out may
+  // alias a or b.
+  template <typename T>
+  static EIGEN_ALWAYS_INLINE void quaternionProduct(const T* a, const T* b,
+                                                    T* out) {
+    const T x = a[3] * b[0] + a[0] * b[3] + a[1] * b[2] - a[2] * b[1];
+    const T y = a[3] * b[1] + a[1] * b[3] + a[2] * b[0] - a[0] * b[2];
+    const T z = a[3] * b[2] + a[2] * b[3] + a[0] * b[1] - a[1] * b[0];
+    const T w = a[3] * b[3] - a[0] * b[0] - a[1] * b[1] - a[2] * b[2];
+    const T squared_norm = x * x + y * y + z * z + w * w;
+    const T factor = Scalar(2) / (Scalar(1) + squared_norm);
+    out[0] = factor * x;
+    out[1] = factor * y;
+    out[2] = factor * z;
+    out[3] = factor * w;
+  }
+
+  // Rotates p by unit quaternion q, following Eigen's _transformVector. T is
+  // Scalar or a Lanes::Vector.
+  template <typename T>
+  static EIGEN_ALWAYS_INLINE void quaternionRotate(const T* q, const T* p,
+                                                   T* out) {
+    const T uvx = Scalar(2) * (q[1] * p[2] - q[2] * p[1]);
+    const T uvy = Scalar(2) * (q[2] * p[0] - q[0] * p[2]);
+    const T uvz = Scalar(2) * (q[0] * p[1] - q[1] * p[0]);
+    out[0] = p[0] + q[3] * uvx + (q[1] * uvz - q[2] * uvy);
+    out[1] = p[1] + q[3] * uvy + (q[2] * uvx - q[0] * uvz);
+    out[2] = p[2] + q[3] * uvz + (q[0] * uvy - q[1] * uvx);
+  }
+
+  static EIGEN_ALWAYS_INLINE void so3Compose(const Scalar* SOPHUS_RESTRICT a,
+                                             const Scalar* SOPHUS_RESTRICT b,
+                                             Scalar* SOPHUS_RESTRICT out,
+                                             std::size_t n) {
+    for (std::size_t i = 0; i < n; ++i) {
+      quaternionProduct(a + kSO3Params * i, b + kSO3Params * i,
+                        out + kSO3Params * i);
+    }
+  }
+
+  static EIGEN_ALWAYS_INLINE void se3Compose(const Scalar* SOPHUS_RESTRICT a,
+                                             const Scalar* SOPHUS_RESTRICT b,
+                                             Scalar* SOPHUS_RESTRICT out,
+                                             std::size_t n) {
+    for (std::size_t i = 0; i < n; ++i) {
+      const Scalar* a_i = a + kSE3Params * i;
+      const Scalar* b_i = b + kSE3Params * i;
+      Scalar* out_i = out + kSE3Params * i;
+      Scalar rotated[3];
+      quaternionRotate(a_i, b_i + kSO3Params, rotated);
+      out_i[4] = a_i[4] + rotated[0];
+      out_i[5] = a_i[5] + rotated[1];
+      out_i[6] = a_i[6] + rotated[2];
+      quaternionProduct(a_i, b_i, out_i);
+    }
+  }
+
+  // sin(x), cos(x) and sin(x) / x of lanes with 0 <= x.
+  //
+  // x is reduced to r = x - k * pi / 2 in [-pi / 4, pi / 4], with pi / 2
+  // split into three parts such that the first two products with k are
+  // exact. sin(r) and cos(r) are the minimax polynomials of the Cephes
+  // library. For k = 0, sin(x) / x is taken from the polynomial directly, so
+  // that it stays accurate as x goes to zero.
+  template <typename Lanes>
+  static EIGEN_ALWAYS_INLINE void sinCos(const typename Lanes::Vector& x,
+                                         typename Lanes::Vector* sin_x,
+                                         typename Lanes::Vector* cos_x,
+                                         typename Lanes::Vector* sinc_x) {
+    typedef typename Lanes::Vector Vector;
+    const Scalar kMaxQuadrant = Scalar(1 << 30);
+    const Vector quadrant = Scalar(0.63661977236758134308) * x;
+    Vector k, k_mod_4;
+    Lanes::round(quadrant < kMaxQuadrant ? quadrant : kMaxQuadrant, &k,
+                 &k_mod_4);
+    const Vector r = ((x - k * Scalar(1.5703125)) -
+                      k * Scalar(4.837512969970703125e-4)) -
+                     k * Scalar(7.5497899548918822e-8);
+    const Vector z = r * r;
+    const Vector sin_poly =
+        z * (((((Scalar(1.58962301576546568060e-10) * z -
+                 Scalar(2.50507477628578072866e-8)) * z +
+                Scalar(2.75573136213857245213e-6)) * z -
+               Scalar(1.98412698295895385996e-4)) * z +
+              Scalar(8.33333333332211858878e-3)) * z -
+             Scalar(1.66666666666666307295e-1));
+    const Vector cos_poly =
+        (((((Scalar(-1.13585365213876817300e-11) * z +
+             Scalar(2.08757008419747316778e-9)) * z -
+            Scalar(2.75573141792967388112e-7)) * z +
+           Scalar(2.48015872888517045348e-5)) * z -
+          Scalar(1.38888888888730564116e-3)) * z +
+         Scalar(4.16666666666665929218e-2));
+    const Vector sin_r = r + r * sin_poly;
+    const Vector cos_r = Scalar(1) - Scalar(0.5) * z + z * z * cos_poly;
+    // For k modulo 4 = 0, 1, 2, 3, sin(x) is sin(r), cos(r), -sin(r),
+    // -cos(r), and cos(x) is cos(r), -sin(r), -cos(r), sin(r).
+    const Vector sin_abs =
+        (k_mod_4 == Scalar(1)) | (k_mod_4 == Scalar(3)) ? cos_r : sin_r;
+    const Vector cos_abs =
+        (k_mod_4 == Scalar(1)) | (k_mod_4 == Scalar(3)) ? sin_r : cos_r;
+    *sin_x = k_mod_4 >= Scalar(2) ? -sin_abs : sin_abs;
+    *cos_x = (k_mod_4 == Scalar(1)) | (k_mod_4 == Scalar(2)) ? -cos_abs
+                                                             : cos_abs;
+    *sinc_x = k == Scalar(0) ? Scalar(1) + sin_poly
+                             : *sin_x / (k == Scalar(0) ? Scalar(1) : x);
+  }
+
+  // atan(x) and atan(x) / x of lanes with 0 <= x <= 1.
+  //
+  // For x > tan(pi / 8), atan(x) = pi / 4 + atan((x - 1) / (x + 1)), such
+  // that the rational approximation of the Cephes library is only evaluated
+  // for arguments in [-tan(pi / 8), tan(pi / 8)]. Below tan(pi / 8),
+  // atan(x) / x is taken from the rational function directly.
+  template <typename Lanes>
+  static EIGEN_ALWAYS_INLINE void atanUnit(const typename Lanes::Vector& x,
+                                           typename Lanes::Vector* atan_x,
+                                           typename Lanes::Vector* atanc_x) {
+    typedef typename Lanes::Vector Vector;
+    const Scalar kTanPiBy8 = Scalar(0.41421356237309504880);
+    const Vector y =
+        x > kTanPiBy8 ? (x - Scalar(1)) / (x + Scalar(1)) : x;
+    const Vector z = y * y;
+    const Vector p =
+        ((((Scalar(-8.750608600031904122785e-1) * z -
+            Scalar(1.615753718733365076637e1)) * z -
+           Scalar(7.500855792314704667340e1)) * z -
+          Scalar(1.228866684490136173410e2)) * z -
+         Scalar(6.485021904942025371773e1));
+    const Vector q =
+        (((((z + Scalar(2.485846490142306297962e1)) * z +
+            Scalar(1.650270098316988542046e2)) * z +
+           Scalar(4.328810604912902668951e2)) * z +
+          Scalar(4.853903996359136964868e2)) * z +
+         Scalar(1.945506571482613964425e2));
+    const Vector ratio = z * p / q;
+    const Vector atan_y = y + y * ratio;
+    *atan_x = x > kTanPiBy8 ? atan_y + Scalar(0.78539816339744830962) : atan_y;
+    *atanc_x = x > kTanPiBy8 ? *atan_x / (x > kTanPiBy8 ? x : Scalar(1))
+                             : Scalar(1) + ratio;
+  }
+
+  // out = u + A * (w x u) + B * (w x (w x u))
+  template <typename Vector, typename CoefficientA>
+  static EIGEN_ALWAYS_INLINE void crossAccumulate(const Vector* w,
+                                                  const Vector* u,
+                                                  const CoefficientA& A,
+                                                  const Vector& B,
+                                                  Vector* out) {
+    const Vector c0 = w[1] * u[2] - w[2] * u[1];
+    const Vector c1 = w[2] * u[0] - w[0] * u[2];
+    const Vector c2 = w[0] * u[1] - w[1] * u[0];
+    const Vector cc0 = w[1] * c2 - w[2] * c1;
+    const Vector cc1 = w[2] * c0 - w[0] * c2;
+    const Vector cc2 = w[0] * c1 - w[1] * c0;
+    out[0] = u[0] + A * c0 + B * cc0;
+    out[1] = u[1] + A * c1 + B * cc1;
+    out[2] = u[2] + A * c2 + B * cc2;
+  }
+
+  // See SO3GroupBase::expAndTheta(). Also returns sin(theta / 2), cos(theta /
+  // 2) and sin(theta / 2) / (theta / 2).
+  template <typename Lanes>
+  static EIGEN_ALWAYS_INLINE void so3ExpLanes(
+      const typename Lanes::Vector* omega, typename Lanes::Vector* q,
+      typename Lanes::Vector* theta, typename Lanes::Vector* sin_half_theta,
+      typename Lanes::Vector* cos_half_theta,
+      typename Lanes::Vector* sinc_half_theta) {
+    typedef typename Lanes::Vector Vector;
+    Lanes::sqrt(omega[0] * omega[0] + omega[1] * omega[1] +
+                    omega[2] * omega[2],
+                theta);
+    sinCos<Lanes>(Scalar(0.5) * *theta, sin_half_theta, cos_half_theta,
+                  sinc_half_theta);
+    const Vector imag_factor = Scalar(0.5) * *sinc_half_theta;
+    q[0] = imag_factor * omega[0];
+    q[1] = imag_factor * omega[1];
+    q[2] = imag_factor * omega[2];
+    q[3] = *cos_half_theta;
+  }
+
+  // See SE3GroupBase::exp(). The matrix V is applied to upsilon via cross
+  // products instead of forming Omega and Omega^2 explicitly. Its coefficient
+  // (1 - cos(theta)) / theta^2 is evaluated as (sin(theta / 2) / (theta /
+  // 2))^2 / 2, which does not suffer from cancellation.
+  template <typename Lanes>
+  static EIGEN_ALWAYS_INLINE void se3ExpLanes(
+      const typename Lanes::Vector* tangent, typename Lanes::Vector* params) {
+    typedef typename Lanes::Vector Vector;
+    const Vector* upsilon = tangent;
+    const Vector* omega = tangent + 3;
+    Vector theta, sin_half_theta, cos_half_theta, sinc_half_theta;
+    so3ExpLanes<Lanes>(omega, params, &theta, &sin_half_theta,
+                       &cos_half_theta, &sinc_half_theta);
+    const Scalar kEpsilon = SophusConstants<Scalar>::epsilon();
+    const Vector safe_theta = theta < kEpsilon ? Scalar(1) : theta;
+    const Vector A = Scalar(0.5) * sinc_half_theta * sinc_half_theta;
+    const Vector B =
+        theta < kEpsilon
+            ? Scalar(1. / 6.)
+            : (safe_theta - Scalar(2) * sin_half_theta * cos_half_theta) /
+                  (safe_theta * safe_theta * safe_theta);
+    crossAccumulate(omega, upsilon, A, B, params + kSO3Params);
+  }
+
+  // See SO3GroupBase::logAndTheta(). Also returns 2 * atan(n / w) / n, where
+  // n is the norm of the imaginary part of q and w its real part.
+  //
+  // atan(n / w) / n is evaluated as atan(x) / x / |w| with x = n / |w| if
+  // n <= |w|, and as (pi / 2 - atan(|w| / n)) / n otherwise, with the sign of
+  // w applied afterwards. Neither divides by a small number, since
+  // max(n, |w|) >= 1 / sqrt(2) for unit quaternions.
+  template <typename Lanes>
+  static EIGEN_ALWAYS_INLINE void so3LogLanes(
+      const typename Lanes::Vector* q, typename Lanes::Vector* omega,
+      typename Lanes::Vector* theta,
+      typename Lanes::Vector* two_atan_nbyw_by_n) {
+    typedef typename Lanes::Vector Vector;
+    Vector n;
+    Lanes::sqrt(q[0] * q[0] + q[1] * q[1] + q[2] * q[2], &n);
+    const Vector w = q[3];
+    const Vector abs_w = w < Scalar(0) ? -w : w;
+    const Vector x = n <= abs_w ? n / abs_w : abs_w / n;
+    Vector atan_x, atanc_x;
+    atanUnit<Lanes>(x, &atan_x, &atanc_x);
+    const Vector atan_nbyabsw_by_n =
+        n <= abs_w
+            ? atanc_x / abs_w
+            : (Scalar(0.5) * SophusConstants<Scalar>::pi() - atan_x) / n;
+    // As in SO3GroupBase::logAndTheta(), w = 0 maps to -pi.
+    *two_atan_nbyw_by_n =
+        w > Scalar(0) ? Scalar(2) * atan_nbyabsw_by_n
+                      : Scalar(-2) * atan_nbyabsw_by_n;
+    *theta = *two_atan_nbyw_by_n * n;
+    omega[0] = *two_atan_nbyw_by_n * q[0];
+    omega[1] = *two_atan_nbyw_by_n * q[1];
+    omega[2] = *two_atan_nbyw_by_n * q[2];
+  }
+
+  // See SE3GroupBase::log(). With theta = 2 * atan(n / w), the term
+  // theta / (2 * tan(theta / 2)) equals w * theta / (2 * n).
+  template <typename Lanes>
+  static EIGEN_ALWAYS_INLINE void se3LogLanes(
+      const typename Lanes::Vector* params, typename Lanes::Vector* tangent) {
+    typedef typename Lanes::Vector Vector;
+    Vector* upsilon = tangent;
+    Vector* omega = tangent + 3;
+    Vector theta, two_atan_nbyw_by_n;
+    so3LogLanes<Lanes>(params, omega, &theta, &two_atan_nbyw_by_n);
+    const Scalar kEpsilon = SophusConstants<Scalar>::epsilon();
+    const Vector abs_theta = theta < Scalar(0) ? -theta : theta;
+    const Vector safe_theta = abs_theta < kEpsilon ? Scalar(1) : theta;
+    const Vector B =
+        abs_theta < kEpsilon
+            ? Scalar(1. / 12.)
+            : (Scalar(1) - Scalar(0.5) * two_atan_nbyw_by_n * params[3]) /
+                  (safe_theta * safe_theta);
+    crossAccumulate(omega, params + kSO3Params, Scalar(-0.5), B, upsilon);
+  }
+
+  // Loads Lanes::kWidth consecutive elements of kNum scalars each, such that
+  // v[c] holds component c of all elements.
+  template <typename Lanes, int kNum>
+  static EIGEN_ALWAYS_INLINE void loadLanes(const Scalar* p,
+                                            typename Lanes::Vector* v) {
+    for (int c = 0; c < kNum; ++c) {
+      Lanes::load(p + c, kNum, &v[c]);
+    }
+  }
+
+  // Inverse of loadLanes().
+  template <typename Lanes, int kNum>
+  static EIGEN_ALWAYS_INLINE void storeLanes(const typename Lanes::Vector* v,
+                                             Scalar* p) {
+    for (int c = 0; c < kNum; ++c) {
+      Lanes::store(v[c], kNum, p + c);
+    }
+  }
+
+  template <typename Lanes>
+  static EIGEN_ALWAYS_INLINE void so3ExpBlock(const Scalar* omegas,
+                                              Scalar* params) {
+    typedef typename Lanes::Vector Vector;
+    Vector omega[3], q[kSO3Params];
+    Vector theta, sin_half_theta, cos_half_theta, sinc_half_theta;
+    loadLanes<Lanes, 3>(omegas, omega);
+    so3ExpLanes<Lanes>(omega, q, &theta, &sin_half_theta, &cos_half_theta,
+                       &sinc_half_theta);
+    storeLanes<Lanes, kSO3Params>(q, params);
+  }
+
+  template <typename Lanes>
+  static EIGEN_ALWAYS_INLINE void se3ExpBlock(const Scalar* tangents,
+                                              Scalar* params) {
+    typedef typename Lanes::Vector Vector;
+    Vector tangent[6], T[kSE3Params];
+    loadLanes<Lanes, 6>(tangents, tangent);
+    se3ExpLanes<Lanes>(tangent, T);
+    storeLanes<Lanes, kSE3Params>(T, params);
+  }
+
+  // T = T * exp(dt * twist) for Lanes::kWidth elements, see
+  // se3IntegrateSplit().
+  template <typename Lanes>
+  static EIGEN_ALWAYS_INLINE void se3IntegrateSplitBlock(
+      Scalar* quaternions, Scalar* translations, const Scalar* twists,
+      Scalar dt) {
+    typedef typename Lanes::Vector Vector;
+    Vector q[kSO3Params], t[3], tangent[6], delta[kSE3Params], rotated[3];
+    loadLanes<Lanes, kSO3Params>(quaternions, q);
+    loadLanes<Lanes, 3>(translations, t);
+    loadLanes<Lanes, 6>(twists, tangent);
+    for (int c = 0; c < 6; ++c) {
+      tangent[c] = dt * tangent[c];
+    }
+    se3ExpLanes<Lanes>(tangent, delta);
+    quaternionRotate(q, delta + kSO3Params, rotated);
+    for (int c = 0; c < 3; ++c) {
+      t[c] = t[c] + rotated[c];
+    }
+    quaternionProduct(q, delta, q);
+    storeLanes<Lanes, kSO3Params>(q, quaternions);
+    storeLanes<Lanes, 3>(t, translations);
+  }
+
+  template <typename Lanes>
+  static EIGEN_ALWAYS_INLINE void so3LogBlock(const Scalar* params,
+                                              Scalar* omegas) {
+    typedef typename Lanes::Vector Vector;
+    Vector q[kSO3Params], omega[3], theta, two_atan_nbyw_by_n;
+    loadLanes<Lanes, kSO3Params>(params, q);
+    so3LogLanes<Lanes>(q, omega, &theta, &two_atan_nbyw_by_n);
+    storeLanes<Lanes, 3>(omega, omegas);
+  }
+
+  template <typename Lanes>
+  static EIGEN_ALWAYS_INLINE void se3LogBlock(const Scalar* params,
+                                              Scalar* tangents) {
+    typedef typename Lanes::Vector Vector;
+    Vector T[kSE3Params], tangent[6];
+    loadLanes<Lanes, kSE3Params>(params, T);
+    se3LogLanes<Lanes>(T, tangent);
+    storeLanes<Lanes, 6>(tangent, tangents);
+  }
+
+  // The exp and log kernels process blocks of Lanes::kWidth elements,
+  // followed by the remaining elements one at a time.
+  template <typename Lanes>
+  static EIGEN_ALWAYS_INLINE void so3Exp(const Scalar* SOPHUS_RESTRICT omegas,
+                                         Scalar* SOPHUS_RESTRICT out,
+                                         std::size_t n) {
+    std::size_t i = 0;
+    for (; i + Lanes::kWidth <= n; i += Lanes::kWidth) {
+      so3ExpBlock<Lanes>(omegas + 3 * i, out + kSO3Params * i);
+    }
+    for (; i < n; ++i) {
+      so3ExpBlock<ScalarLanes<Scalar> >(omegas + 3 * i, out + kSO3Params * i);
+    }
+  }
+
+  template <typename Lanes>
+  static EIGEN_ALWAYS_INLINE void se3Exp(const Scalar* SOPHUS_RESTRICT tangents,
+                                         Scalar* SOPHUS_RESTRICT out,
+                                         std::size_t n) {
+    std::size_t i = 0;
+    for (; i + Lanes::kWidth <= n; i += Lanes::kWidth) {
+      se3ExpBlock<Lanes>(tangents + 6 * i, out + kSE3Params * i);
+    }
+    for (; i < n; ++i) {
+      se3ExpBlock<ScalarLanes<Scalar> >(tangents + 6 * i,
+                                        out + kSE3Params * i);
+    }
+  }
+
+  // T_i = T_i * exp(dt * twists[i]) for n SE3 elements whose quaternions
+  // (x, y, z, w) and translations are stored in separate packed arrays. Like
+  // the exp kernels, the update is branch-free over blocks of Lanes::kWidth
+  // elements.
+  template <typename Lanes>
+  static EIGEN_ALWAYS_INLINE void se3IntegrateSplit(
+      Scalar* SOPHUS_RESTRICT quaternions, Scalar* SOPHUS_RESTRICT translations,
+      const Scalar* SOPHUS_RESTRICT twists, Scalar dt, std::size_t n) {
+    std::size_t i = 0;
+    for (; i + Lanes::kWidth <= n; i += Lanes::kWidth) {
+      se3IntegrateSplitBlock<Lanes>(quaternions + kSO3Params * i,
+                                    translations + 3 * i, twists + 6 * i, dt);
+    }
+    for (; i < n; ++i) {
+      se3IntegrateSplitBlock<ScalarLanes<Scalar> >(
+          quaternions + kSO3Params * i, translations + 3 * i, twists + 6 * i,
+          dt);
+    }
+  }
+
+  template <typename Lanes>
+  static EIGEN_ALWAYS_INLINE void so3Log(const Scalar* SOPHUS_RESTRICT params,
+                                         Scalar* SOPHUS_RESTRICT omegas,
+                                         std::size_t n) {
+    std::size_t i = 0;
+    for (; i + Lanes::kWidth <= n; i += Lanes::kWidth) {
+      so3LogBlock<Lanes>(params + kSO3Params * i, omegas + 3 * i);
+    }
+    for (; i < n; ++i) {
+      so3LogBlock<ScalarLanes<Scalar> >(params + kSO3Params * i,
+                                        omegas + 3 * i);
+    }
+  }
+
+  template <typename Lanes>
+  static EIGEN_ALWAYS_INLINE void se3Log(const Scalar* SOPHUS_RESTRICT params,
+                                         Scalar* SOPHUS_RESTRICT tangents,
+                                         std::size_t n) {
+    std::size_t i = 0;
+    for (; i + Lanes::kWidth <= n; i += Lanes::kWidth) {
+      se3LogBlock<Lanes>(params + kSE3Params * i, tangents + 6 * i);
+    }
+    for (; i < n; ++i) {
+      se3LogBlock<ScalarLanes<Scalar> >(params + kSE3Params * i,
+                                        tangents + 6 * i);
+    }
+  }
+
+  // Pinhole reprojection residuals pi(T * p_i) - z_i of n points seen by the
+  // camera with pose T and intrinsics camera = (fx, fy, cx, cy). The rotation
+  // matrix of T and the product of the projection Jacobian with it are
+  // shared by all Jacobians of a point. Jacobians are row-major; the 2x6
+  // pose Jacobians are with respect to delta of pi(T * exp(delta) * p_i),
+  // the 2x3 point Jacobians with respect to p_i. Either may be NULL.
+  static EIGEN_ALWAYS_INLINE void se3Reproject(
+      const Scalar* T_params, const Scalar* camera,
+      const Scalar* SOPHUS_RESTRICT points,
+      const Scalar* SOPHUS_RESTRICT observations,
+      Scalar* SOPHUS_RESTRICT residuals, Scalar* SOPHUS_RESTRICT pose_jacobians,
+      Scalar* SOPHUS_RESTRICT point_jacobians, std::size_t n) {
+    Scalar R[9];
+    quaternionToMatrix(T_params, R);
+    const Scalar r0 = R[0], r1 = R[1], r2 = R[2];
+    const Scalar r3 = R[3], r4 = R[4], r5 = R[5];
+    const Scalar r6 = R[6], r7 = R[7], r8 = R[8];
+    const Scalar t0 = T_params[kSO3Params];
+    const Scalar t1 = T_params[kSO3Params + 1];
+    const Scalar t2 = T_params[kSO3Params + 2];
+    const Scalar fx = camera[0], fy = camera[1];
+    const Scalar cx = camera[2], cy = camera[3];
+    for (std::size_t i = 0; i < n; ++i) {
+      const Scalar x = points[3 * i];
+      const Scalar y = points[3 * i + 1];
+      const Scalar z = points[3 * i + 2];
+      const Scalar inv_depth =
+          Scalar(1) / (r6 * x + r7 * y + r8 * z + t2);
+      const Scalar u = (r0 * x + r1 * y + r2 * z + t0) * inv_depth;
+      const Scalar v = (r3 * x + r4 * y + r5 * z + t1) * inv_depth;
+      residuals[2 * i] = fx * u + cx - observations[2 * i];
+      residuals[2 * i + 1] = fy * v + cy - observations[2 * i + 1];
+      if (pose_jacobians == NULL && point_jacobians == NULL) {
+        continue;
+      }
+      // B = Dpi * R
+      const Scalar a0 = fx * inv_depth;
+      const Scalar a2 = -a0 * u;
+      const Scalar b1 = fy * inv_depth;
+      const Scalar b2 = -b1 * v;
+      const Scalar B00 = a0 * r0 + a2 * r6;
+      const Scalar B01 = a0 * r1 + a2 * r7;
+      const Scalar B02 = a0 * r2 + a2 * r8;
+      const Scalar B10 = b1 * r3 + b2 * r6;
+      const Scalar B11 = b1 * r4 + b2 * r7;
+      const Scalar B12 = b1 * r5 + b2 * r8;
+      if (point_jacobians != NULL) {
+        Scalar* J = point_jacobians + 6 * i;
+        J[0] = B00;
+        J[1] = B01;
+        J[2] = B02;
+        J[3] = B10;
+        J[4] = B11;
+        J[5] = B12;
+      }
+      if (pose_jacobians != NULL) {
+        // B * [I, -hat(p)], where each row b^T * -hat(p) is (p x b)^T.
+        Scalar* J = pose_jacobians + 12 * i;
+        J[0] = B00;
+        J[1] = B01;
+        J[2] = B02;
+        J[3] = y * B02 - z * B01;
+        J[4] = z * B00 - x * B02;
+        J[5] = x * B01 - y * B00;
+        J[6] = B10;
+        J[7] = B11;
+        J[8] = B12;
+        J[9] = y * B12 - z * B11;
+        J[10] = z * B10 - x * B12;
+        J[11] = x * B11 - y * B10;
+      }
+    }
+  }
+
+  // Squared distances |M_h * src_i + t_h - dst_i|^2 of n point pairs under
+  // num_transforms affine maps, each given by 12 scalars (row-major M, then
+  // t). The error of pair i under map h is written to errors[h * n + i]. The
+  // pairs are processed in blocks which stay in the L1 cache while all maps
+  // are applied to them.
+  static EIGEN_ALWAYS_INLINE void affineSquaredErrors(
+      const Scalar* transforms, std::size_t num_transforms,
+      const Scalar* SOPHUS_RESTRICT src, const Scalar* SOPHUS_RESTRICT dst,
+      Scalar* SOPHUS_RESTRICT errors, std::size_t n) {
+    const std::size_t kBlockSize = 256;
+    for (std::size_t begin = 0; begin < n; begin += kBlockSize) {
+      const std::size_t end = begin + kBlockSize < n ? begin + kBlockSize : n;
+      for (std::size_t h = 0; h < num_transforms; ++h) {
+        const Scalar* A = transforms + 12 * h;
+        const Scalar m0 = A[0], m1 = A[1], m2 = A[2];
+        const Scalar m3 = A[3], m4 = A[4], m5 = A[5];
+        const Scalar m6 = A[6], m7 = A[7], m8 = A[8];
+        const Scalar t0 = A[9], t1 = A[10], t2 = A[11];
+        Scalar* SOPHUS_RESTRICT errors_h = errors + h * n;
+        for (std::size_t i = begin; i < end; ++i) {
+          const Scalar x = src[3 * i];
+          const Scalar y = src[3 * i + 1];
+          const Scalar z = src[3 * i + 2];
+          const Scalar dx = m0 * x + m1 * y + m2 * z + t0 - dst[3 * i];
+          const Scalar dy = m3 * x + m4 * y + m5 * z + t1 - dst[3 * i + 1];
+          const Scalar dz = m6 * x + m7 * y + m8 * z + t2 - dst[3 * i + 2];
+          errors_h[i] = dx * dx + dy * dy + dz * dz;
+        }
+      }
+    }
+  }
+
+  // Fixed-point codes of n SE3 elements, 7 per element: the index of the
+  // quaternion component of largest magnitude, the other three components
+  // (sign-flipped so that the largest one is positive) times scales[0], and
+  // the translation times scales[1], clamped to [-scales[2], scales[2]].
+  static EIGEN_ALWAYS_INLINE void se3Quantize(
+      const Scalar* SOPHUS_RESTRICT params, const Scalar* scales,
+      std::int32_t* SOPHUS_RESTRICT codes, std::size_t n) {
+    using std::abs;
+    using std::floor;
+    static const int kOthers[4][3] = {
+        {1, 2, 3}, {0, 2, 3}, {0, 1, 3}, {0, 1, 2}};
+    const Scalar rotation_scale = scales[0];
+    const Scalar translation_scale = scales[1];
+    const Scalar limit = scales[2];
+    for (std::size_t i = 0; i < n; ++i) {
+      const Scalar* p = params + kSE3Params * i;
+      std::int32_t* c = codes + 7 * i;
+      int largest = 0;
+      Scalar largest_abs = abs(p[0]);
+      for (int k = 1; k < 4; ++k) {
+        const bool larger = abs(p[k]) > largest_abs;
+        largest = larger ? k : largest;
+        largest_abs = larger ? abs(p[k]) : largest_abs;
+      }
+      const Scalar sign = p[largest] < 0 ? Scalar(-1) : Scalar(1);
+      c[0] = largest;
+      for (int k = 0; k < 3; ++k) {
+        const Scalar v = sign * rotation_scale * p[kOthers[largest][k]];
+        c[1 + k] = static_cast<std::int32_t>(floor(v + Scalar(0.5)));
+      }
+      for (int k = 0; k < 3; ++k) {
+        Scalar v = translation_scale * p[4 + k];
+        v = v < -limit ? -limit : (v > limit ? limit : v);
+        c[4 + k] = static_cast<std::int32_t>(floor(v + Scalar(0.5)));
+      }
+    }
+  }
+
+  // Inverse of se3Quantize(). The largest quaternion component is restored
+  // from the unit norm.
+  static EIGEN_ALWAYS_INLINE void se3Dequantize(
+      const std::int32_t* SOPHUS_RESTRICT codes, const Scalar* scales,
+      Scalar* SOPHUS_RESTRICT params, std::size_t n) {
+    using std::sqrt;
+    const Scalar inv_rotation_scale = Scalar(1) / scales[0];
+    const Scalar inv_translation_scale = Scalar(1) / scales[1];
+    for (std::size_t i = 0; i < n; ++i) {
+      const std::int32_t* c = codes + 7 * i;
+      Scalar* p = params + kSE3Params * i;
+      const int largest = c[0] & 3;
+      const Scalar a = inv_rotation_scale * Scalar(c[1]);
+      const Scalar b = inv_rotation_scale * Scalar(c[2]);
+      const Scalar d = inv_rotation_scale * Scalar(c[3]);
+      const Scalar rest = Scalar(1) - (a * a + b * b + d * d);
+      const Scalar m = sqrt(rest > Scalar(0) ? rest : Scalar(0));
+      p[0] = largest == 0 ? m : a;
+      p[1] = largest == 0 ? a : (largest == 1 ? m : b);
+      p[2] = largest < 2 ? b : (largest == 2 ? m : d);
+      p[3] = largest == 3 ? m : d;
+      p[4] = inv_translation_scale * Scalar(c[4]);
+      p[5] = inv_translation_scale * Scalar(c[5]);
+      p[6] = inv_translation_scale * Scalar(c[6]);
+    }
+  }
+};
+
+// Wraps all kernels of BatchKernelsImpl into static functions compiled with
+// the given target attribute. The exp and log kernels process LANE_BYTES
+// bytes wide vectors of elements at once (see LanesFor).
+#define SOPHUS_DEFINE_BATCH_KERNELS(NAME, TARGET, LANE_BYTES)                  \
+  template <typename Scalar>                                                   \
+  struct NAME {                                                                \
+    typedef BatchKernelsImpl<Scalar> Impl;                                     \
+    typedef typename LanesFor<Scalar, LANE_BYTES>::type Lanes;                 \
+    TARGET static void so3TransformPoints(const Scalar* R, const Scalar* in,   \
+                                          Scalar* out, std::size_t n) {        \
+      Impl::so3TransformPoints(R, in, out, n);                                 \
+    }                                                                          \
+    TARGET static void se3TransformPoints(const Scalar* T, const Scalar* in,   \
+                                          Scalar* out, std::size_t n) {        \
+      Impl::se3TransformPoints(T, in, out, n);                                 \
+    }                                                                          \
+    TARGET static void se3TransformPointsFirstOrder(                           \
+        const Scalar* T, const Scalar* twist, const Scalar* offsets,           \
+        const Scalar* in, Scalar* out, std::size_t n) {                        \
+      Impl::se3TransformPointsFirstOrder(T, twist, offsets, in, out, n);       \
+    }                                                                          \
+    TARGET static void so3Compose(const Scalar* a, const Scalar* b,            \
+                                  Scalar* out, std::size_t n) {                \
+      Impl::so3Compose(a, b, out, n);                                          \
+    }                                                                          \
+    TARGET static void se3Compose(const Scalar* a, const Scalar* b,            \
+                                  Scalar* out, std::size_t n) {                \
+      Impl::se3Compose(a, b, out, n);                                          \
+    }                                                                          \
+    TARGET static void so3Exp(const Scalar* in, Scalar* out, std::size_t n) {  \
+      Impl::template so3Exp<Lanes>(in, out, n);                                \
+    }                                                                          \
+    TARGET static void se3Exp(const Scalar* in, Scalar* out, std::size_t n) {  \
+      Impl::template se3Exp<Lanes>(in, out, n);                                \
+    }                                                                          \
+    TARGET static void se3IntegrateSplit(Scalar* q, Scalar* t,                 \
+                                         const Scalar* twists, Scalar dt,      \
+                                         std::size_t n) {                      \
+      Impl::template se3IntegrateSplit<Lanes>(q, t, twists, dt, n);            \
+    }                                                                          \
+    TARGET static void so3Log(const Scalar* in, Scalar* out, std::size_t n) {  \
+      Impl::template so3Log<Lanes>(in, out, n);                                \
+    }                                                                          \
+    TARGET static void se3Log(const Scalar* in, Scalar* out, std::size_t n) {  \
+      Impl::template se3Log<Lanes>(in, out, n);                                \
+    }                                                                          \
+    TARGET static void se3Reproject(                                           \
+        const Scalar* T, const Scalar* camera, const Scalar* points,           \
+        const Scalar* observations, Scalar* residuals, Scalar* pose_jacobians, \
+        Scalar* point_jacobians, std::size_t n) {                              \
+      Impl::se3Reproject(T, camera, points, observations, residuals,           \
+                         pose_jacobians, point_jacobians, n);                  \
+    }                                                                          \
+    TARGET static void affineSquaredErrors(                                    \
+        const Scalar* transforms, std::size_t num_transforms,                  \
+        const Scalar* src, const Scalar* dst, Scalar* errors, std::size_t n) { \
+      Impl::affineSquaredErrors(transforms, num_transforms, src, dst, errors,  \
+                                n);                                            \
+    }                                                                          \
+    TARGET static void se3Quantize(const Scalar* params, const Scalar* scales, \
+                                   std::int32_t* codes, std::size_t n) {       \
+      Impl::se3Quantize(params, scales, codes, n);                             \
+    }                                                                          \
+    TARGET static void se3Dequantize(const std::int32_t* codes,                \
+                                     const Scalar* scales, Scalar* params,     \
+                                     std::size_t n) {                          \
+      Impl::se3Dequantize(codes, scales, params, n);                           \
+    }                                                                          \
+  };
+
+SOPHUS_DEFINE_BATCH_KERNELS(BatchKernelsScalar, , 0)
+#ifdef SOPHUS_ISA_DISPATCH
+SOPHUS_DEFINE_BATCH_KERNELS(BatchKernelsSSE42, SOPHUS_TARGET_SSE42, 16)
+SOPHUS_DEFINE_BATCH_KERNELS(BatchKernelsAVX2, SOPHUS_TARGET_AVX2, 32)
+SOPHUS_DEFINE_BATCH_KERNELS(BatchKernelsAVX512, SOPHUS_TARGET_AVX512, 64)
+#endif
+
+}  // namespace details
+
+/**
+ * \brief Registry of batch kernels for one instruction set level
+ *
+ * Use selected() to obtain the kernels chosen for the host CPU, and isa to
+ * find out which instruction set level they are compiled for.
+ */
+template <typename Scalar>
+struct BatchKernels {
+  /** \brief applies one group element to n points */
+  typedef void (*TransformPointsFunction)(const Scalar* params,
+                                          const Scalar* points_in,
+                                          Scalar* points_out, std::size_t n);
+  /**
+   * \brief applies one SE3 element, perturbed by a scaled twist to first
+   * order, to n points, see
+   * details::BatchKernelsImpl::se3TransformPointsFirstOrder()
+   */
+  typedef void (*TransformPointsFirstOrderFunction)(
+      const Scalar* params, const Scalar* twist, const Scalar* offsets,
+      const Scalar* points_in, Scalar* points_out, std::size_t n);
+  /** \brief computes out[i] = a[i] * b[i] for n group elements */
+  typedef void (*ComposeFunction)(const Scalar* a, const Scalar* b,
+                                  Scalar* out, std::size_t n);
+  /** \brief maps n tangent vectors to group elements */
+  typedef void (*ExpFunction)(const Scalar* tangents, Scalar* params,
+                              std::size_t n);
+  /**
+   * \brief integrates n SE3 elements with constant twists in place, see
+   * details::BatchKernelsImpl::se3IntegrateSplit()
+   */
+  typedef void (*IntegrateSplitFunction)(Scalar* quaternions,
+                                         Scalar* translations,
+                                         const Scalar* twists, Scalar dt,
+                                         std::size_t n);
+  /** \brief maps n group elements to tangent vectors */
+  typedef void (*LogFunction)(const Scalar* params, Scalar* tangents,
+                              std::size_t n);
+  /**
+   * \brief reprojection residuals and Jacobians of n points seen by one
+   * camera, see BatchOps<SE3Group>::reproject()
+   */
+  typedef void (*ReprojectFunction)(const Scalar* params,
+                                    const Scalar* camera,
+                                    const Scalar* points,
+                                    const Scalar* observations,
+                                    Scalar* residuals, Scalar* pose_jacobians,
+                                    Scalar* point_jacobians, std::size_t n);
+  /**
+   * \brief squared distances of n point pairs under several affine maps,
+   * see details::BatchKernelsImpl::affineSquaredErrors()
+   */
+  typedef void (*AffineSquaredErrorsFunction)(const Scalar* transforms,
+                                              std::size_t num_transforms,
+                                              const Scalar* src,
+                                              const Scalar* dst,
+                                              Scalar* errors, std::size_t n);
+  /**
+   * \brief fixed-point codes of n SE3 elements and their inverse, see
+   * details::BatchKernelsImpl::se3Quantize()
+   */
+  typedef void (*QuantizeFunction)(const Scalar* params, const Scalar* scales,
+                                   std::int32_t* codes, std::size_t n);
+  typedef void (*DequantizeFunction)(const std::int32_t* codes,
+                                     const Scalar* scales, Scalar* params,
+                                     std::size_t n);
+
+  /** \brief instruction set level the kernels are compiled for */
+  CpuIsa isa;
+
+  TransformPointsFunction so3TransformPoints;
+  TransformPointsFunction se3TransformPoints;
+  TransformPointsFirstOrderFunction se3TransformPointsFirstOrder;
+  ComposeFunction so3Compose;
+  ComposeFunction se3Compose;
+  ExpFunction so3Exp;
+  ExpFunction se3Exp;
+  IntegrateSplitFunction se3IntegrateSplit;
+  LogFunction so3Log;
+  LogFunction se3Log;
+  ReprojectFunction se3Reproject;
+  AffineSquaredErrorsFunction affineSquaredErrors;
+  QuantizeFunction se3Quantize;
+  DequantizeFunction se3Dequantize;
+
+  /**
+   * \returns kernels compiled for instruction set level isa
+   *
+   * \pre isa must be supported by the host CPU
+   *      (see CpuFeatures::bestIsa()).
+   */
+  static BatchKernels forIsa(CpuIsa isa) {
+    switch (isa) {
+#ifdef SOPHUS_ISA_DISPATCH
+      case CpuIsa::AVX512:
+        return make<details::BatchKernelsAVX512<Scalar> >(isa);
+      case CpuIsa::AVX2:
+        return make<details::BatchKernelsAVX2<Scalar> >(isa);
+      case CpuIsa::SSE42:
+        return make<details::BatchKernelsSSE42<Scalar> >(isa);
+#endif
+      default:
+        return make<details::BatchKernelsScalar<Scalar> >(CpuIsa::Scalar);
+    }
+  }
+
+  /**
+   * \returns kernels for the instruction set level chosen by selectCpuIsa()
+   *
+   * The selection happens once, on first use.
+   */
+  static const BatchKernels& selected() {
+    static const BatchKernels kernels = forIsa(selectCpuIsa());
+    return kernels;
+  }
+
+ private:
+  template <typename Impl>
+  static BatchKernels make(CpuIsa isa) {
+    BatchKernels kernels;
+    kernels.isa = isa;
+    kernels.so3TransformPoints = &Impl::so3TransformPoints;
+    kernels.se3TransformPoints = &Impl::se3TransformPoints;
+    kernels.se3TransformPointsFirstOrder = &Impl::se3TransformPointsFirstOrder;
+    kernels.so3Compose = &Impl::so3Compose;
+    kernels.se3Compose = &Impl::se3Compose;
+    kernels.so3Exp = &Impl::so3Exp;
+    kernels.se3Exp = &Impl::se3Exp;
+    kernels.se3IntegrateSplit = &Impl::se3IntegrateSplit;
+    kernels.so3Log = &Impl::so3Log;
+    kernels.se3Log = &Impl::se3Log;
+    kernels.se3Reproject = &Impl::se3Reproject;
+    kernels.affineSquaredErrors = &Impl::affineSquaredErrors;
+    kernels.se3Quantize = &Impl::se3Quantize;
+    kernels.se3Dequantize = &Impl::se3Dequantize;
+    return kernels;
+  }
+};
+
+/**
+ * \brief Batched group operations for Group (SO3Group or SE3Group)
+ *
+ * Thin typed front-end to BatchKernels::selected(), e.g.
+ * BatchOps<SE3d>::exp(tangents, params, n).
+ */
+template <typename Group>
+struct BatchOps;
+
+template <typename _Scalar>
+struct BatchOps<SO3Group<_Scalar> > {
+  typedef _Scalar Scalar;
+  typedef SO3Group<Scalar> Group;
+
+  /**
+   * \brief Applies R to n points (x, y, z each)
+   */
+  template <typename Derived>
+  static void transformPoints(const SO3GroupBase<Derived>& R,
+                              const Scalar* points_in, Scalar* points_out,
+                              std::size_t n) {
+    const Group R_copy(R);
+    BatchKernels<Scalar>::selected().so3TransformPoints(
+        R_copy.data(), points_in, points_out, n);
+  }
+
+  /**
+   * \brief Computes out[i] = a[i] * b[i]
+   */
+  static void compose(const Scalar* a, const Scalar* b, Scalar* out,
+                      std::size_t n) {
+    BatchKernels<Scalar>::selected().so3Compose(a, b, out, n);
+  }
+
+  /**
+   * \brief Computes params[i] = exp(tangents[i])
+   */
+  static void exp(const Scalar* tangents, Scalar* params, std::size_t n) {
+    BatchKernels<Scalar>::selected().so3Exp(tangents, params, n);
+  }
+
+  /**
+   * \brief Computes tangents[i] = log(params[i])
+   */
+  static void log(const Scalar* params, Scalar* tangents, std::size_t n) {
+    BatchKernels<Scalar>::selected().so3Log(params, tangents, n);
+  }
+};
+
+template <typename _Scalar>
+struct BatchOps<SE3Group<_Scalar> > {
+  typedef _Scalar Scalar;
+  typedef SE3Group<Scalar> Group;
+
+  /**
+   * \brief Applies T to n points (x, y, z each)
+   */
+  template <typename Derived>
+  static void transformPoints(const SE3GroupBase<Derived>& T,
+                              const Scalar* points_in, Scalar* points_out,
+                              std::size_t n) {
+    const Group T_copy(T);
+    BatchKernels<Scalar>::selected().se3TransformPoints(
+        T_copy.data(), points_in, points_out, n);
+  }
+
+  /**
+   * \brief Computes out[i] = a[i] * b[i]
+   */
+  static void compose(const Scalar* a, const Scalar* b, Scalar* out,
+                      std::size_t n) {
+    BatchKernels<Scalar>::selected().se3Compose(a, b, out, n);
+  }
+
+  /**
+   * \brief Computes params[i] = exp(tangents[i])
+   */
+  static void exp(const Scalar* tangents, Scalar* params, std::size_t n) {
+    BatchKernels<Scalar>::selected().se3Exp(tangents, params, n);
+  }
+
+  /**
+   * \brief Computes tangents[i] = log(params[i])
+   */
+  static void log(const Scalar* params, Scalar* tangents, std::size_t n) {
+    BatchKernels<Scalar>::selected().se3Log(params, tangents, n);
+  }
+
+  /**
+   * \brief Pinhole reprojection residuals of n points seen by camera T_cw
+   *
+   * Computes residuals[i] = pi(T_cw * points[i]) - observations[i] with
+   * pi(x) = (fx * x / z + cx, fy * y / z + cy) and camera = (fx, fy, cx,
+   * cy). If not NULL, pose_jacobians[i] receives the row-major 2x6 derivative
+   * with respect to delta of pi(T_cw * exp(delta) * points[i]) - i.e. the
+   * tangent of the right perturbation - and point_jacobians[i] the row-major
+   * 2x3 derivative with respect to points[i].
+   */
+  template <typename Derived>
+  static void reproject(const SE3GroupBase<Derived>& T_cw,
+                        const Scalar* camera, const Scalar* points,
+                        const Scalar* observations, Scalar* residuals,
+                        Scalar* pose_jacobians, Scalar* point_jacobians,
+                        std::size_t n) {
+    const Group T_copy(T_cw);
+    BatchKernels<Scalar>::selected().se3Reproject(
+        T_copy.data(), camera, points, observations, residuals,
+        pose_jacobians, point_jacobians, n);
+  }
+};
+}  // namespace Sophus
+
+#endif  // SOPHUS_BATCH_HPP
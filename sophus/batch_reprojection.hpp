@@ -0,0 +1,177 @@
+// This file is part of Sophus.
+//
+// Copyright 2016 Hauke Strasdat
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights  to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#ifndef SOPHUS_BATCH_REPROJECTION_HPP
+#define SOPHUS_BATCH_REPROJECTION_HPP
+
+#include <algorithm>
+#include <vector>
+
+#include "batch.hpp"
+
+namespace Sophus {
+
+/**
+ * \brief Reprojection residuals of many observations, grouped by pose
+ *
+ * Observation k is the image point observations[k] of the world point
+ * point_indices[k], seen by the camera with pose pose_indices[k]. All
+ * cameras share the pinhole intrinsics camera = (fx, fy, cx, cy).
+ *
+ * The observations are sorted by pose once, on construction. evaluate() then
+ * runs a single se3Reproject sweep per pose over a contiguous copy of its
+ * points, such that the pose-dependent intermediates are computed once per
+ * pose instead of once per observation.
+ *
+ * Residuals and Jacobians are written in this grouped order: the
+ * observations of pose i occupy the slots poseBegin(i) to poseEnd(i) - 1,
+ * and slot s holds observation observationIndex(s). Buffers are packed as
+ * in BatchOps<SE3Group>::reproject(), i.e. 2 residuals, 12 pose Jacobian and
+ * 6 point Jacobian entries per slot.
+ */
+template <typename Scalar>
+class BatchReprojection {
+ public:
+  typedef Eigen::Matrix<Scalar, 4, 1> Camera;
+
+  /**
+   * \param observations 2 scalars per observation
+   */
+  BatchReprojection(int num_poses, const std::vector<int>& pose_indices,
+                    const std::vector<int>& point_indices,
+                    const std::vector<Scalar>& observations,
+                    const Camera& camera)
+      : offsets_(num_poses + 1, 0) {
+    for (int i = 0; i < 4; ++i) {
+      camera_[i] = camera[i];
+    }
+    SOPHUS_ENSURE(pose_indices.size() == point_indices.size() &&
+                      2 * pose_indices.size() == observations.size(),
+                  "Inconsistent number of observations.");
+    const int num_observations = static_cast<int>(pose_indices.size());
+
+    // counting sort by pose
+    for (int k = 0; k < num_observations; ++k) {
+      SOPHUS_ENSURE(pose_indices[k] >= 0 && pose_indices[k] < num_poses,
+                    "Pose index out of range.");
+      ++offsets_[pose_indices[k] + 1];
+    }
+    int max_group_size = 0;
+    for (int i = 0; i < num_poses; ++i) {
+      max_group_size = std::max(max_group_size, offsets_[i + 1]);
+      offsets_[i + 1] += offsets_[i];
+    }
+    std::vector<int> next(offsets_.begin(), offsets_.end() - 1);
+    observation_indices_.resize(num_observations);
+    point_indices_.resize(num_observations);
+    observations_.resize(2 * num_observations);
+    for (int k = 0; k < num_observations; ++k) {
+      const int slot = next[pose_indices[k]]++;
+      observation_indices_[slot] = k;
+      point_indices_[slot] = point_indices[k];
+      observations_[2 * slot] = observations[2 * k];
+      observations_[2 * slot + 1] = observations[2 * k + 1];
+    }
+    points_.resize(3 * max_group_size);
+  }
+
+  /**
+   * \brief Evaluates all residuals and, if not NULL, Jacobians
+   *
+   * \param poses SE3Group::num_parameters scalars per pose (T_cw)
+   * \param points 3 scalars per world point
+   *
+   * Not thread-safe, since the points of each pose are gathered into a
+   * buffer owned by this object. Use evaluatePose() to evaluate poses
+   * concurrently.
+   */
+  void evaluate(const Scalar* poses, const Scalar* points, Scalar* residuals,
+                Scalar* pose_jacobians, Scalar* point_jacobians) {
+    const int num_poses = static_cast<int>(offsets_.size()) - 1;
+    for (int i = 0; i < num_poses; ++i) {
+      evaluatePose(i, poses, points, residuals, pose_jacobians,
+                   point_jacobians, points_.data());
+    }
+  }
+
+  /**
+   * \brief Evaluates the residuals and Jacobians of the slots of pose i
+   *
+   * Same as evaluate(), restricted to the slots poseBegin(i) to
+   * poseEnd(i) - 1. The output buffers are those of all slots, and
+   * gathered_points must hold 3 * maxPoseObservations() scalars.
+   */
+  void evaluatePose(int i, const Scalar* poses, const Scalar* points,
+                    Scalar* residuals, Scalar* pose_jacobians,
+                    Scalar* point_jacobians, Scalar* gathered_points) const {
+    const int begin = offsets_[i];
+    const int n = offsets_[i + 1] - begin;
+    if (n == 0) {
+      return;
+    }
+    for (int s = 0; s < n; ++s) {
+      const Scalar* p = points + 3 * point_indices_[begin + s];
+      gathered_points[3 * s] = p[0];
+      gathered_points[3 * s + 1] = p[1];
+      gathered_points[3 * s + 2] = p[2];
+    }
+    BatchKernels<Scalar>::selected().se3Reproject(
+        poses + SE3Group<Scalar>::num_parameters * i, camera_,
+        gathered_points, &observations_[2 * begin], residuals + 2 * begin,
+        pose_jacobians == NULL ? NULL : pose_jacobians + 12 * begin,
+        point_jacobians == NULL ? NULL : point_jacobians + 6 * begin, n);
+  }
+
+  int numPoses() const { return static_cast<int>(offsets_.size()) - 1; }
+
+  int numObservations() const {
+    return static_cast<int>(observation_indices_.size());
+  }
+
+  /** \returns first slot of pose i */
+  int poseBegin(int i) const { return offsets_[i]; }
+
+  /** \returns one past the last slot of pose i */
+  int poseEnd(int i) const { return offsets_[i + 1]; }
+
+  /** \returns index of the observation in slot s */
+  int observationIndex(int s) const { return observation_indices_[s]; }
+
+  /** \returns index of the point observed in slot s */
+  int pointIndex(int s) const { return point_indices_[s]; }
+
+  /** \returns largest number of observations of a single pose */
+  int maxPoseObservations() const {
+    return static_cast<int>(points_.size()) / 3;
+  }
+
+ private:
+  Scalar camera_[4];
+  std::vector<int> offsets_;
+  std::vector<int> observation_indices_;
+  std::vector<int> point_indices_;
+  std::vector<Scalar> observations_;
+  std::vector<Scalar> points_;
+};
+}  // namespace Sophus
+
+#endif  // SOPHUS_BATCH_REPROJECTION_HPP
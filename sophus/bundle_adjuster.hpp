@@ -0,0 +1,671 @@
+// This file is part of Sophus.
+//
+// Copyright 2016 Hauke Strasdat
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights  to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#ifndef SOPHUS_BUNDLE_ADJUSTER_HPP
+#define SOPHUS_BUNDLE_ADJUSTER_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+#include <Eigen/Cholesky>
+#include <Eigen/SparseCholesky>
+#include <Eigen/SparseCore>
+
+#include "batch_reprojection.hpp"
+#include "parallel.hpp"
+#include "se3.hpp"
+
+namespace Sophus {
+
+struct BundleAdjustmentOptions {
+  enum LinearSolver {
+    // Eigen::SimplicialLDLT of the reduced camera system, with the symbolic
+    // factorization computed once per structure.
+    SparseCholesky,
+    // Conjugate gradients on the reduced camera system, preconditioned with
+    // the inverses of its 6x6 diagonal blocks.
+    ConjugateGradients
+  };
+
+  LinearSolver linear_solver = SparseCholesky;
+  int max_iterations = 50;
+  double initial_lambda = 1e-4;
+  // Converged if the relative cost decrease of a step is below this.
+  double function_tolerance = 1e-10;
+  // Converged if the largest gradient entry is below this.
+  double gradient_tolerance = 1e-12;
+  // Converged if |step| <= parameter_tolerance * (|x| + parameter_tolerance).
+  double parameter_tolerance = 1e-10;
+  int max_cg_iterations = 500;
+  // Relative residual |S x - b| / |b| at which conjugate gradients stops.
+  double cg_tolerance = 1e-8;
+  // Zero uses all hardware threads.
+  std::size_t num_threads = 0;
+};
+
+struct BundleAdjustmentSummary {
+  double initial_cost = 0;
+  double final_cost = 0;
+  // Number of linear solves, including rejected steps.
+  int num_iterations = 0;
+  int num_successful_iterations = 0;
+  bool converged = false;
+};
+
+/**
+ * \brief Levenberg-Marquardt bundle adjustment of SE3 cameras and 3D points
+ *
+ * Minimizes 0.5 * sum |pi(T_cw * p_w) - z|^2 over all observations z, with
+ * the pinhole projection pi of BatchOps<SE3Group>::reproject(). Cameras are
+ * updated as T_cw * exp(delta), points additively.
+ *
+ * Residuals and analytic Jacobians are evaluated with BatchReprojection, one
+ * kernel sweep per camera. The points are eliminated with the Schur
+ * complement: each row of 6x6 blocks of the reduced camera system is
+ * accumulated by one thread from the observations of its camera, and the
+ * system is solved with a sparse Cholesky factorization or with
+ * preconditioned conjugate gradients (see BundleAdjustmentOptions). All
+ * parallel loops of one solve(), including those of every conjugate gradient
+ * iteration, run on the same ThreadPool.
+ *
+ * The problem structure is analyzed once, on the first call to solve() after
+ * construction or setCameraConstant().
+ */
+class BundleAdjuster {
+ public:
+  typedef BatchReprojection<double>::Camera Camera;
+  typedef Eigen::Matrix<double, 6, 6> Matrix6d;
+  typedef Eigen::Matrix<double, 6, 1> Vector6d;
+  typedef Eigen::Matrix<double, 6, 3> Matrix63d;
+  typedef Eigen::Matrix<double, 2, 6, Eigen::RowMajor> PoseJacobian;
+  typedef Eigen::Matrix<double, 2, 3, Eigen::RowMajor> PointJacobian;
+
+  /**
+   * \brief Observation k is the image point observations[2k, 2k + 1] of
+   * point point_indices[k] in camera camera_indices[k]
+   */
+  BundleAdjuster(int num_cameras, int num_points,
+                 const std::vector<int>& camera_indices,
+                 const std::vector<int>& point_indices,
+                 const std::vector<double>& observations, const Camera& camera)
+      : num_cameras_(num_cameras),
+        num_points_(num_points),
+        reprojection_(num_cameras, camera_indices, point_indices, observations,
+                      camera),
+        constant_(num_cameras, false),
+        structure_dirty_(true) {
+    const int m = reprojection_.numObservations();
+    slot_cameras_.resize(m);
+    for (int c = 0; c < num_cameras; ++c) {
+      for (int s = reprojection_.poseBegin(c); s < reprojection_.poseEnd(c);
+           ++s) {
+        slot_cameras_[s] = c;
+      }
+    }
+    point_offsets_.assign(num_points + 1, 0);
+    for (int s = 0; s < m; ++s) {
+      SOPHUS_ENSURE(reprojection_.pointIndex(s) >= 0 &&
+                        reprojection_.pointIndex(s) < num_points,
+                    "Point index out of range.");
+      ++point_offsets_[reprojection_.pointIndex(s) + 1];
+    }
+    for (int j = 0; j < num_points; ++j) {
+      point_offsets_[j + 1] += point_offsets_[j];
+    }
+    std::vector<int> next(point_offsets_.begin(), point_offsets_.end() - 1);
+    point_slots_.resize(m);
+    for (int s = 0; s < m; ++s) {
+      point_slots_[next[reprojection_.pointIndex(s)]++] = s;
+    }
+  }
+
+  /**
+   * \brief Excludes camera i from the optimization, e.g. to fix the gauge
+   */
+  void setCameraConstant(int i, bool constant = true) {
+    constant_[i] = constant;
+    structure_dirty_ = true;
+  }
+
+  /**
+   * \brief Optimizes poses (7 scalars per camera, T_cw.data()) and points
+   * (3 scalars per point) in place
+   */
+  BundleAdjustmentSummary solve(
+      double* poses, double* points,
+      const BundleAdjustmentOptions& options = BundleAdjustmentOptions()) {
+    if (structure_dirty_) {
+      buildStructure();
+      structure_dirty_ = false;
+    }
+    const int kP = SE3Group<double>::num_parameters;
+    ThreadPool pool(options.num_threads);
+    const int nv = static_cast<int>(var_cameras_.size());
+    gathered_.resize(pool.numThreads() * 3 *
+                     reprojection_.maxPoseObservations());
+
+    BundleAdjustmentSummary summary;
+    double cost = linearize(poses, points, &pool);
+    summary.initial_cost = cost;
+
+    std::vector<double> candidate_poses(poses, poses + kP * num_cameras_);
+    std::vector<double> candidate_points(points, points + 3 * num_points_);
+    Eigen::VectorXd dc(6 * nv), dp(3 * num_points_);
+    double lambda = options.initial_lambda;
+    double nu = 2;
+    while (summary.num_iterations < options.max_iterations) {
+      if (std::max(gc_.lpNorm<Eigen::Infinity>(),
+                   gp_.lpNorm<Eigen::Infinity>()) <=
+          options.gradient_tolerance) {
+        summary.converged = true;
+        break;
+      }
+      ++summary.num_iterations;
+      if (!computeStep(lambda, options, &pool, &dc, &dp)) {
+        lambda *= nu;
+        nu *= 2;
+        continue;
+      }
+
+      const double step_norm =
+          std::sqrt(dc.squaredNorm() + dp.squaredNorm());
+      const double x_norm = std::sqrt(
+          Eigen::Map<const Eigen::VectorXd>(poses, kP * num_cameras_)
+              .squaredNorm() +
+          Eigen::Map<const Eigen::VectorXd>(points, 3 * num_points_)
+              .squaredNorm());
+      const double tolerance = options.parameter_tolerance;
+      if (step_norm <= tolerance * (x_norm + tolerance)) {
+        summary.converged = true;
+        break;
+      }
+
+      for (int i = 0; i < nv; ++i) {
+        const int c = var_cameras_[i];
+        const Eigen::Map<const SE3Group<double> > T(poses + kP * c);
+        Eigen::Map<SE3Group<double> > T_new(&candidate_poses[kP * c]);
+        T_new = T * SE3Group<double>::exp(dc.segment<6>(6 * i));
+      }
+      Eigen::Map<Eigen::VectorXd>(candidate_points.data(), 3 * num_points_) =
+          Eigen::Map<const Eigen::VectorXd>(points, 3 * num_points_) + dp;
+      const double new_cost = evaluateCost(
+          candidate_poses.data(), candidate_points.data(), &pool);
+
+      const double predicted = predictedDecrease(dc, dp, &pool);
+      const double actual = cost - new_cost;
+      if (predicted > 0 && actual > 0) {
+        std::copy(candidate_poses.begin(), candidate_poses.end(), poses);
+        std::copy(candidate_points.begin(), candidate_points.end(), points);
+        ++summary.num_successful_iterations;
+        const double rho = actual / predicted;
+        const double tmp = 2 * rho - 1;
+        lambda *= std::max(1.0 / 3.0, 1 - tmp * tmp * tmp);
+        nu = 2;
+        const bool small_decrease = actual <= options.function_tolerance * cost;
+        cost = linearize(poses, points, &pool);
+        if (small_decrease) {
+          summary.converged = true;
+          break;
+        }
+      } else {
+        lambda *= nu;
+        nu *= 2;
+      }
+    }
+    summary.final_cost = cost;
+    return summary;
+  }
+
+ private:
+  // Variable camera indices, the block sparsity of the reduced camera system
+  // and the pattern of its sparse lower triangle.
+  void buildStructure() {
+    camera_vars_.assign(num_cameras_, -1);
+    var_cameras_.clear();
+    for (int c = 0; c < num_cameras_; ++c) {
+      if (!constant_[c]) {
+        camera_vars_[c] = static_cast<int>(var_cameras_.size());
+        var_cameras_.push_back(c);
+      }
+    }
+    const int nv = static_cast<int>(var_cameras_.size());
+
+    // Block (i, k) is non-zero if cameras i and k share a point.
+    row_offsets_.assign(nv + 1, 0);
+    block_cols_.clear();
+    std::vector<int> marker(nv, -1);
+    for (int i = 0; i < nv; ++i) {
+      const int c = var_cameras_[i];
+      const std::size_t row_begin = block_cols_.size();
+      for (int s = reprojection_.poseBegin(c); s < reprojection_.poseEnd(c);
+           ++s) {
+        const int j = reprojection_.pointIndex(s);
+        for (int t = point_offsets_[j]; t < point_offsets_[j + 1]; ++t) {
+          const int k = camera_vars_[slot_cameras_[point_slots_[t]]];
+          if (k >= 0 && marker[k] != i) {
+            marker[k] = i;
+            block_cols_.push_back(k);
+          }
+        }
+      }
+      if (marker[i] != i) {
+        // camera without observations
+        block_cols_.push_back(i);
+      }
+      std::sort(block_cols_.begin() + row_begin, block_cols_.end());
+      row_offsets_[i + 1] = static_cast<std::ptrdiff_t>(block_cols_.size());
+    }
+    transposed_blocks_.resize(block_cols_.size());
+    for (int i = 0; i < nv; ++i) {
+      for (std::ptrdiff_t b = row_offsets_[i]; b < row_offsets_[i + 1]; ++b) {
+        transposed_blocks_[b] = blockIndex(block_cols_[b], i);
+      }
+    }
+    blocks_.resize(36 * block_cols_.size());
+    u_.resize(36 * nv);
+    gc_.resize(6 * nv);
+    w_.resize(18 * reprojection_.numObservations());
+    v_.resize(9 * num_points_);
+    v_inv_.resize(9 * num_points_);
+    gp_.resize(3 * num_points_);
+    residuals_.resize(2 * reprojection_.numObservations());
+    pose_jacobians_.resize(12 * reprojection_.numObservations());
+    point_jacobians_.resize(6 * reprojection_.numObservations());
+
+    // Lower triangle (block row >= block column) in column-major order.
+    std::vector<Eigen::Triplet<double, std::ptrdiff_t> > triplets;
+    for (int i = 0; i < nv; ++i) {
+      for (std::ptrdiff_t b = row_offsets_[i]; b < row_offsets_[i + 1]; ++b) {
+        const int k = block_cols_[b];
+        if (k > i) {
+          continue;
+        }
+        for (int col = 0; col < 6; ++col) {
+          for (int row = (k == i ? col : 0); row < 6; ++row) {
+            triplets.push_back(
+                Eigen::Triplet<double, std::ptrdiff_t>(6 * i + row,
+                                                       6 * k + col, 0.0));
+          }
+        }
+      }
+    }
+    reduced_.resize(6 * nv, 6 * nv);
+    reduced_.setFromTriplets(triplets.begin(), triplets.end());
+    reduced_.makeCompressed();
+    value_indices_.clear();
+    for (int i = 0; i < nv; ++i) {
+      for (std::ptrdiff_t b = row_offsets_[i]; b < row_offsets_[i + 1]; ++b) {
+        const int k = block_cols_[b];
+        if (k > i) {
+          continue;
+        }
+        for (int col = 0; col < 6; ++col) {
+          const std::ptrdiff_t* inner_begin =
+              reduced_.innerIndexPtr() + reduced_.outerIndexPtr()[6 * k + col];
+          const std::ptrdiff_t* inner_end =
+              reduced_.innerIndexPtr() +
+              reduced_.outerIndexPtr()[6 * k + col + 1];
+          for (int row = (k == i ? col : 0); row < 6; ++row) {
+            value_indices_.push_back(
+                std::lower_bound(inner_begin, inner_end,
+                                 std::ptrdiff_t(6 * i + row)) -
+                reduced_.innerIndexPtr());
+          }
+        }
+      }
+    }
+    cholesky_.analyzePattern(reduced_);
+  }
+
+  // index of block (i, k) of the reduced camera system
+  std::ptrdiff_t blockIndex(int i, int k) const {
+    return static_cast<std::ptrdiff_t>(
+        std::lower_bound(block_cols_.begin() + row_offsets_[i],
+                         block_cols_.begin() + row_offsets_[i + 1], k) -
+        block_cols_.begin());
+  }
+
+  // Buffer of the points of one camera, for each worker of the pool of
+  // solve().
+  double* gatheredPoints(std::size_t worker) {
+    return gathered_.data() + worker * 3 * reprojection_.maxPoseObservations();
+  }
+
+  double evaluateCost(const double* poses, const double* points,
+                      ThreadPool* pool) {
+    pool->parallelForWorkers(
+        0, num_cameras_, 16,
+        [&](std::size_t worker, std::size_t c) {
+          reprojection_.evaluatePose(static_cast<int>(c), poses, points,
+                                     residuals_.data(), NULL, NULL,
+                                     gatheredPoints(worker));
+        });
+    return 0.5 * Eigen::Map<const Eigen::VectorXd>(
+                     residuals_.data(), residuals_.size())
+                     .squaredNorm();
+  }
+
+  // Evaluates residuals and Jacobians at (poses, points) and accumulates the
+  // blocks of the normal equations which do not depend on lambda. Returns
+  // the cost.
+  double linearize(const double* poses, const double* points,
+                   ThreadPool* pool) {
+    pool->parallelForWorkers(
+        0, num_cameras_, 16,
+        [&](std::size_t worker, std::size_t c) {
+          reprojection_.evaluatePose(
+              static_cast<int>(c), poses, points, residuals_.data(),
+              pose_jacobians_.data(), point_jacobians_.data(),
+              gatheredPoints(worker));
+        });
+
+    // camera blocks U, gradients and W = Jp^T Jx
+    const int nv = static_cast<int>(var_cameras_.size());
+    pool->parallelFor(0, nv, 16, [&](std::size_t i) {
+      const int c = var_cameras_[i];
+      Eigen::Map<Matrix6d> U(&u_[36 * i]);
+      Eigen::Map<Vector6d> g(&gc_[6 * i]);
+      U.setZero();
+      g.setZero();
+      for (int s = reprojection_.poseBegin(c); s < reprojection_.poseEnd(c);
+           ++s) {
+        const Eigen::Map<const PoseJacobian> Jp(&pose_jacobians_[12 * s]);
+        const Eigen::Map<const PointJacobian> Jx(&point_jacobians_[6 * s]);
+        const Eigen::Map<const Eigen::Vector2d> r(&residuals_[2 * s]);
+        U.noalias() += Jp.transpose() * Jp;
+        g.noalias() += Jp.transpose() * r;
+        Eigen::Map<Matrix63d>(&w_[18 * s]).noalias() = Jp.transpose() * Jx;
+      }
+    });
+
+    // point blocks V and gradients
+    pool->parallelFor(0, num_points_, 256, [&](std::size_t j) {
+      Eigen::Map<Eigen::Matrix3d> V(&v_[9 * j]);
+      Eigen::Map<Eigen::Vector3d> g(&gp_[3 * j]);
+      V.setZero();
+      g.setZero();
+      for (int t = point_offsets_[j]; t < point_offsets_[j + 1]; ++t) {
+        const int s = point_slots_[t];
+        const Eigen::Map<const PointJacobian> Jx(&point_jacobians_[6 * s]);
+        const Eigen::Map<const Eigen::Vector2d> r(&residuals_[2 * s]);
+        V.noalias() += Jx.transpose() * Jx;
+        g.noalias() += Jx.transpose() * r;
+      }
+    });
+    return 0.5 * Eigen::Map<const Eigen::VectorXd>(residuals_.data(),
+                                                   residuals_.size())
+                     .squaredNorm();
+  }
+
+  // Marquardt scaling of the damping, clamped as in Ceres.
+  template <typename Derived>
+  static typename Derived::PlainObject damping(
+      const Eigen::MatrixBase<Derived>& diagonal, double lambda) {
+    return lambda * diagonal.cwiseMax(1e-6).cwiseMin(1e32);
+  }
+
+  // Solves the damped normal equations for the camera and point steps.
+  bool computeStep(double lambda, const BundleAdjustmentOptions& options,
+                   ThreadPool* pool, Eigen::VectorXd* dc,
+                   Eigen::VectorXd* dp) {
+    const int nv = static_cast<int>(var_cameras_.size());
+
+    pool->parallelFor(0, num_points_, 256, [&](std::size_t j) {
+      Eigen::Matrix3d V = Eigen::Map<const Eigen::Matrix3d>(&v_[9 * j]);
+      V.diagonal() += damping(V.diagonal(), lambda);
+      Eigen::Map<Eigen::Matrix3d> V_inv(&v_inv_[9 * j]);
+      V_inv = V.inverse();
+    });
+
+    // Reduced camera system S dc = rhs, one block row per task. Only the
+    // blocks (i, k >= i) are accumulated; the others are mirrored below.
+    Eigen::VectorXd rhs(6 * nv);
+    pool->parallelFor(0, nv, 4, [&](std::size_t i_) {
+      const int i = static_cast<int>(i_);
+      const int c = var_cameras_[i];
+      for (std::ptrdiff_t b = row_offsets_[i]; b < row_offsets_[i + 1]; ++b) {
+        if (block_cols_[b] >= i) {
+          Eigen::Map<Matrix6d>(&blocks_[36 * b]).setZero();
+        }
+      }
+      Eigen::Map<Matrix6d> S_ii(&blocks_[36 * blockIndex(i, i)]);
+      const Eigen::Map<const Matrix6d> U(&u_[36 * i]);
+      S_ii = U;
+      S_ii.diagonal() += damping(U.diagonal(), lambda);
+      Vector6d r = -Eigen::Map<const Vector6d>(&gc_[6 * i]);
+      for (int s = reprojection_.poseBegin(c); s < reprojection_.poseEnd(c);
+           ++s) {
+        const int j = reprojection_.pointIndex(s);
+        const Matrix63d Y =
+            Eigen::Map<const Matrix63d>(&w_[18 * s]) *
+            Eigen::Map<const Eigen::Matrix3d>(&v_inv_[9 * j]);
+        r.noalias() += Y * Eigen::Map<const Eigen::Vector3d>(&gp_[3 * j]);
+        for (int t = point_offsets_[j]; t < point_offsets_[j + 1]; ++t) {
+          const int s_k = point_slots_[t];
+          const int k = camera_vars_[slot_cameras_[s_k]];
+          if (k < i) {
+            continue;
+          }
+          Eigen::Map<Matrix6d>(&blocks_[36 * blockIndex(i, k)]).noalias() -=
+              Y * Eigen::Map<const Matrix63d>(&w_[18 * s_k]).transpose();
+        }
+      }
+      rhs.segment<6>(6 * i) = r;
+    });
+    pool->parallelFor(0, nv, 16, [&](std::size_t i) {
+      for (std::ptrdiff_t b = row_offsets_[i]; b < row_offsets_[i + 1]; ++b) {
+        if (block_cols_[b] < static_cast<int>(i)) {
+          Eigen::Map<Matrix6d> S_ik(&blocks_[36 * b]);
+          S_ik = Eigen::Map<const Matrix6d>(
+                     &blocks_[36 * transposed_blocks_[b]])
+                     .transpose();
+        }
+      }
+    });
+
+    const bool solved =
+        options.linear_solver == BundleAdjustmentOptions::SparseCholesky
+            ? solveCholesky(rhs, dc)
+            : solveConjugateGradients(rhs, options, pool, dc);
+    if (!solved) {
+      return false;
+    }
+
+    // back-substitution of the points
+    pool->parallelFor(0, num_points_, 256, [&](std::size_t j) {
+      Eigen::Vector3d r = -Eigen::Map<const Eigen::Vector3d>(&gp_[3 * j]);
+      for (int t = point_offsets_[j]; t < point_offsets_[j + 1]; ++t) {
+        const int s = point_slots_[t];
+        const int k = camera_vars_[slot_cameras_[s]];
+        if (k >= 0) {
+          r.noalias() -= Eigen::Map<const Matrix63d>(&w_[18 * s]).transpose() *
+                         dc->segment<6>(6 * k);
+        }
+      }
+      dp->segment<3>(3 * j) =
+          Eigen::Map<const Eigen::Matrix3d>(&v_inv_[9 * j]) * r;
+    });
+    return true;
+  }
+
+  bool solveCholesky(const Eigen::VectorXd& rhs, Eigen::VectorXd* dc) {
+    const int nv = static_cast<int>(var_cameras_.size());
+    double* values = reduced_.valuePtr();
+    std::size_t v = 0;
+    for (int i = 0; i < nv; ++i) {
+      for (std::ptrdiff_t b = row_offsets_[i]; b < row_offsets_[i + 1]; ++b) {
+        const int k = block_cols_[b];
+        if (k > i) {
+          continue;
+        }
+        const Eigen::Map<const Matrix6d> S_ik(&blocks_[36 * b]);
+        for (int col = 0; col < 6; ++col) {
+          for (int row = (k == i ? col : 0); row < 6; ++row) {
+            values[value_indices_[v++]] = S_ik(row, col);
+          }
+        }
+      }
+    }
+    cholesky_.factorize(reduced_);
+    if (cholesky_.info() != Eigen::Success) {
+      return false;
+    }
+    *dc = cholesky_.solve(rhs);
+    return cholesky_.info() == Eigen::Success;
+  }
+
+  bool solveConjugateGradients(const Eigen::VectorXd& rhs,
+                               const BundleAdjustmentOptions& options,
+                               ThreadPool* pool, Eigen::VectorXd* dc) {
+    const int nv = static_cast<int>(var_cameras_.size());
+    std::vector<double> preconditioner(36 * nv);
+    pool->parallelFor(0, nv, 64, [&](std::size_t i) {
+      const int ii = static_cast<int>(i);
+      Eigen::Map<Matrix6d> P(&preconditioner[36 * i]);
+      P = Eigen::Map<const Matrix6d>(&blocks_[36 * blockIndex(ii, ii)])
+              .ldlt()
+              .solve(Matrix6d::Identity());
+    });
+    auto precondition = [&](const Eigen::VectorXd& x, Eigen::VectorXd* y) {
+      pool->parallelFor(0, nv, 256, [&](std::size_t i) {
+        y->segment<6>(6 * i).noalias() =
+            Eigen::Map<const Matrix6d>(&preconditioner[36 * i]) *
+            x.segment<6>(6 * i);
+      });
+    };
+    auto multiply = [&](const Eigen::VectorXd& x, Eigen::VectorXd* y) {
+      pool->parallelFor(0, nv, 64, [&](std::size_t i) {
+        Vector6d sum = Vector6d::Zero();
+        for (std::ptrdiff_t b = row_offsets_[i]; b < row_offsets_[i + 1]; ++b) {
+          sum.noalias() += Eigen::Map<const Matrix6d>(&blocks_[36 * b]) *
+                           x.segment<6>(6 * block_cols_[b]);
+        }
+        y->segment<6>(6 * i) = sum;
+      });
+    };
+
+    const double rhs_norm = rhs.norm();
+    dc->setZero(6 * nv);
+    if (rhs_norm == 0) {
+      return true;
+    }
+    Eigen::VectorXd r = rhs, z(6 * nv), p(6 * nv), q(6 * nv);
+    precondition(r, &z);
+    p = z;
+    double rz = r.dot(z);
+    for (int it = 0; it < options.max_cg_iterations; ++it) {
+      multiply(p, &q);
+      const double pq = p.dot(q);
+      if (!(pq > 0)) {
+        return false;
+      }
+      const double alpha = rz / pq;
+      *dc += alpha * p;
+      r -= alpha * q;
+      if (r.norm() <= options.cg_tolerance * rhs_norm) {
+        break;
+      }
+      precondition(r, &z);
+      const double rz_new = r.dot(z);
+      p = z + (rz_new / rz) * p;
+      rz = rz_new;
+    }
+    return true;
+  }
+
+  // Decrease of the linearized cost, -g^T h - 0.5 |J h|^2.
+  double predictedDecrease(const Eigen::VectorXd& dc, const Eigen::VectorXd& dp,
+                           ThreadPool* pool) const {
+    std::vector<double> camera_sums(num_cameras_);
+    pool->parallelFor(0, num_cameras_, 16, [&](std::size_t c) {
+      const int k = camera_vars_[c];
+      double sum = 0;
+      for (int s = reprojection_.poseBegin(static_cast<int>(c));
+           s < reprojection_.poseEnd(static_cast<int>(c)); ++s) {
+        Eigen::Vector2d Jh =
+            Eigen::Map<const PointJacobian>(&point_jacobians_[6 * s]) *
+            dp.segment<3>(3 * reprojection_.pointIndex(s));
+        if (k >= 0) {
+          Jh.noalias() +=
+              Eigen::Map<const PoseJacobian>(&pose_jacobians_[12 * s]) *
+              dc.segment<6>(6 * k);
+        }
+        sum += Jh.squaredNorm();
+      }
+      camera_sums[c] = sum;
+    });
+    double Jh_squared = 0;
+    for (double sum : camera_sums) {
+      Jh_squared += sum;
+    }
+    return -gc_.dot(dc) - gp_.dot(dp) - 0.5 * Jh_squared;
+  }
+
+  int num_cameras_;
+  int num_points_;
+  BatchReprojection<double> reprojection_;
+  std::vector<bool> constant_;
+  bool structure_dirty_;
+
+  // camera of each slot, and slots of each point
+  std::vector<int> slot_cameras_;
+  std::vector<int> point_offsets_;
+  std::vector<int> point_slots_;
+
+  // variable index of each camera (-1 if constant), and vice versa
+  std::vector<int> camera_vars_;
+  std::vector<int> var_cameras_;
+
+  // block sparse reduced camera system, row-wise; block offsets and the
+  // sparse matrix below use 64-bit indices, since a dense system of 10k
+  // cameras has 10^8 blocks and more than 2^31 scalars
+  std::vector<std::ptrdiff_t> row_offsets_;
+  std::vector<int> block_cols_;
+  std::vector<std::ptrdiff_t> transposed_blocks_;
+  std::vector<double> blocks_;
+
+  // sparse lower triangle of the reduced camera system
+  typedef Eigen::SparseMatrix<double, Eigen::ColMajor, std::ptrdiff_t>
+      ReducedMatrix;
+  ReducedMatrix reduced_;
+  std::vector<std::ptrdiff_t> value_indices_;
+  Eigen::SimplicialLDLT<ReducedMatrix, Eigen::Lower> cholesky_;
+
+  // linearization
+  std::vector<double> residuals_;
+  std::vector<double> pose_jacobians_;
+  std::vector<double> point_jacobians_;
+  std::vector<double> u_;
+  Eigen::VectorXd gc_;
+  std::vector<double> w_;
+  std::vector<double> v_;
+  std::vector<double> v_inv_;
+  Eigen::VectorXd gp_;
+
+  // scratch of evaluateCost() and linearize()
+  std::vector<double> gathered_;
+};
+}  // namespace Sophus
+
+#endif  // SOPHUS_BUNDLE_ADJUSTER_HPP
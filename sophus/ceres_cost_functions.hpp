@@ -0,0 +1,422 @@
+// This file is part of Sophus.
+//
+// Copyright 2016 Hauke Strasdat
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights  to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#ifndef SOPHUS_CERES_COST_FUNCTIONS_HPP
+#define SOPHUS_CERES_COST_FUNCTIONS_HPP
+
+#include <cstdint>
+#include <vector>
+
+#include <ceres/cost_function.h>
+#include <ceres/sized_cost_function.h>
+
+#include "batch.hpp"
+#include "ceres_manifold.hpp"
+
+namespace Sophus {
+namespace details {
+
+/**
+ * \brief Derivative of T * p with respect to T.data()
+ *
+ * Valid for SE3 and Sim3, whose parameters are both the (unit or non-unit)
+ * quaternion (x, y, z, w) followed by the translation. The rotated and
+ * scaled point is q * p * conj(q), which is quadratic in q.
+ */
+inline Eigen::Matrix<double, 3, 7> quaternionActionJacobian(
+    const double* T_raw, const Eigen::Vector3d& p) {
+  const Eigen::Map<const Eigen::Vector3d> v(T_raw);
+  const double w = T_raw[3];
+  Eigen::Matrix<double, 3, 7> J;
+  J.block<3, 3>(0, 0) =
+      2 * (v.dot(p) * Eigen::Matrix3d::Identity() + v * p.transpose() -
+           p * v.transpose() - w * SO3Group<double>::hat(p));
+  J.col(3) = 2 * (w * p + v.cross(p));
+  J.block<3, 3>(0, 4).setIdentity();
+  return J;
+}
+}  // namespace details
+
+/**
+ * \brief Relative pose residual between two nodes of a pose graph
+ *
+ * r = sqrt_information * log(T_ab^-1 * T_a^-1 * T_b), where T_ab is the
+ * measured pose of b in the frame of a. The parameter blocks are T_a.data()
+ * and T_b.data(), to be used with the Manifold of the same group.
+ *
+ * The Jacobian with respect to T_b is Dx_log times the derivative of the
+ * product. For T_a, the residual is evaluated as -log(T_b^-1 * T_a * T_ab)
+ * instead, such that T_a is not differentiated through an inverse.
+ */
+template <template <class, int> class Group, template <class> class Kernels>
+class RelativePoseCostFunction
+    : public ceres::SizedCostFunction<Kernels<double>::DoF,
+                                      Kernels<double>::num_parameters,
+                                      Kernels<double>::num_parameters> {
+ public:
+  typedef Group<double, 0> GroupType;
+  typedef Kernels<double> K;
+  static const int DoF = K::DoF;
+  static const int num_parameters = K::num_parameters;
+  typedef typename K::Tangent Tangent;
+  typedef typename K::Parameters Parameters;
+  typedef Eigen::Matrix<double, DoF, DoF> InformationType;
+  typedef Eigen::Matrix<double, DoF, num_parameters, Eigen::RowMajor>
+      JacobianType;
+
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+  explicit RelativePoseCostFunction(
+      const GroupType& T_ab,
+      const InformationType& sqrt_information = InformationType::Identity())
+      : T_ba_(T_ab.inverse()),
+        T_ab_(T_ab),
+        sqrt_information_(sqrt_information) {}
+
+  virtual ~RelativePoseCostFunction() {}
+
+  virtual bool Evaluate(double const* const* parameters, double* residuals_raw,
+                        double** jacobians) const {
+    const Eigen::Map<const GroupType> T_a(parameters[0]);
+    const Eigen::Map<const GroupType> T_b(parameters[1]);
+    Eigen::Map<Tangent> residuals(residuals_raw);
+
+    const GroupType T_ba_a_inv = T_ba_ * T_a.inverse();
+    const GroupType E = T_ba_a_inv * T_b;
+    const Parameters E_params = Eigen::Map<const Parameters>(E.data());
+    residuals = sqrt_information_ * K::log(E_params);
+
+    if (jacobians == NULL) {
+      return true;
+    }
+    if (jacobians[0] != NULL) {
+      const GroupType T_b_inv = T_b.inverse();
+      const GroupType F = T_b_inv * T_a * T_ab_;
+      Eigen::Map<JacobianType> J_a(jacobians[0]);
+      J_a = -sqrt_information_ *
+            K::Dx_log(Eigen::Map<const Parameters>(F.data())) *
+            details::productJacobian<Group>(T_b_inv, T_a, T_ab_);
+    }
+    if (jacobians[1] != NULL) {
+      Eigen::Map<JacobianType> J_b(jacobians[1]);
+      J_b = sqrt_information_ * K::Dx_log(E_params) *
+            details::productJacobian<Group>(T_ba_a_inv, T_b);
+    }
+    return true;
+  }
+
+ private:
+  GroupType T_ba_;
+  GroupType T_ab_;
+  InformationType sqrt_information_;
+};
+
+/**
+ * \brief Absolute pose prior
+ *
+ * r = sqrt_information * log(T_prior^-1 * T), with the single parameter
+ * block T.data().
+ */
+template <template <class, int> class Group, template <class> class Kernels>
+class PosePriorCostFunction
+    : public ceres::SizedCostFunction<Kernels<double>::DoF,
+                                      Kernels<double>::num_parameters> {
+ public:
+  typedef Group<double, 0> GroupType;
+  typedef Kernels<double> K;
+  static const int DoF = K::DoF;
+  static const int num_parameters = K::num_parameters;
+  typedef typename K::Tangent Tangent;
+  typedef typename K::Parameters Parameters;
+  typedef Eigen::Matrix<double, DoF, DoF> InformationType;
+  typedef Eigen::Matrix<double, DoF, num_parameters, Eigen::RowMajor>
+      JacobianType;
+
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+  explicit PosePriorCostFunction(
+      const GroupType& T_prior,
+      const InformationType& sqrt_information = InformationType::Identity())
+      : T_prior_inv_(T_prior.inverse()), sqrt_information_(sqrt_information) {}
+
+  virtual ~PosePriorCostFunction() {}
+
+  virtual bool Evaluate(double const* const* parameters, double* residuals_raw,
+                        double** jacobians) const {
+    const Eigen::Map<const GroupType> T(parameters[0]);
+    Eigen::Map<Tangent> residuals(residuals_raw);
+
+    const GroupType E = T_prior_inv_ * T;
+    const Parameters E_params = Eigen::Map<const Parameters>(E.data());
+    residuals = sqrt_information_ * K::log(E_params);
+
+    if (jacobians != NULL && jacobians[0] != NULL) {
+      Eigen::Map<JacobianType> J(jacobians[0]);
+      J = sqrt_information_ * K::Dx_log(E_params) *
+          details::productJacobian<Group>(T_prior_inv_, T);
+    }
+    return true;
+  }
+
+ private:
+  GroupType T_prior_inv_;
+  InformationType sqrt_information_;
+};
+
+/**
+ * \brief Point-to-point alignment residual
+ *
+ * r = T * p - q for a point p in the source and its correspondence q in the
+ * target frame, with the single parameter block T.data(). Group is SE3Group
+ * or Sim3Group.
+ */
+template <template <class, int> class Group>
+class PointToPointCostFunction
+    : public ceres::SizedCostFunction<3, Group<double, 0>::num_parameters> {
+ public:
+  typedef Group<double, 0> GroupType;
+  static const int num_parameters = GroupType::num_parameters;
+  typedef Eigen::Matrix<double, 3, num_parameters, Eigen::RowMajor>
+      JacobianType;
+
+  PointToPointCostFunction(const Eigen::Vector3d& p, const Eigen::Vector3d& q)
+      : p_(p), q_(q) {}
+
+  virtual ~PointToPointCostFunction() {}
+
+  virtual bool Evaluate(double const* const* parameters, double* residuals_raw,
+                        double** jacobians) const {
+    const Eigen::Map<const GroupType> T(parameters[0]);
+    Eigen::Map<Eigen::Vector3d> residuals(residuals_raw);
+    residuals = T * p_ - q_;
+
+    if (jacobians != NULL && jacobians[0] != NULL) {
+      Eigen::Map<JacobianType> J(jacobians[0]);
+      J = details::quaternionActionJacobian(parameters[0], p_);
+    }
+    return true;
+  }
+
+ private:
+  Eigen::Vector3d p_;
+  Eigen::Vector3d q_;
+};
+
+/**
+ * \brief Point-to-plane alignment residual
+ *
+ * r = n^T * (T * p - q) for a point p in the source frame and the plane
+ * through q with unit normal n in the target frame, with the single
+ * parameter block T.data(). Group is SE3Group or Sim3Group.
+ */
+template <template <class, int> class Group>
+class PointToPlaneCostFunction
+    : public ceres::SizedCostFunction<1, Group<double, 0>::num_parameters> {
+ public:
+  typedef Group<double, 0> GroupType;
+  static const int num_parameters = GroupType::num_parameters;
+  typedef Eigen::Matrix<double, 1, num_parameters, Eigen::RowMajor>
+      JacobianType;
+
+  PointToPlaneCostFunction(const Eigen::Vector3d& p, const Eigen::Vector3d& q,
+                           const Eigen::Vector3d& n)
+      : p_(p), q_(q), n_(n) {}
+
+  virtual ~PointToPlaneCostFunction() {}
+
+  virtual bool Evaluate(double const* const* parameters, double* residuals_raw,
+                        double** jacobians) const {
+    const Eigen::Map<const GroupType> T(parameters[0]);
+    residuals_raw[0] = n_.dot(T * p_ - q_);
+
+    if (jacobians != NULL && jacobians[0] != NULL) {
+      Eigen::Map<JacobianType> J(jacobians[0]);
+      J = n_.transpose() * details::quaternionActionJacobian(parameters[0], p_);
+    }
+    return true;
+  }
+
+ private:
+  Eigen::Vector3d p_;
+  Eigen::Vector3d q_;
+  Eigen::Vector3d n_;
+};
+
+/**
+ * \brief Pinhole reprojection residual
+ *
+ * r = pi(T_cw * p_w) - z with pi(x) = (fx * x / z + cx, fy * y / z + cy),
+ * for the observation z of the world point p_w. The parameter blocks are
+ * T_cw.data() (SE3) and p_w.
+ */
+class ReprojectionCostFunction
+    : public ceres::SizedCostFunction<2, SE3Group<double>::num_parameters, 3> {
+ public:
+  typedef Eigen::Matrix<double, 2, SE3Group<double>::num_parameters,
+                        Eigen::RowMajor>
+      PoseJacobianType;
+  typedef Eigen::Matrix<double, 2, 3, Eigen::RowMajor> PointJacobianType;
+
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+  ReprojectionCostFunction(const Eigen::Vector2d& observation, double fx,
+                           double fy, double cx, double cy)
+      : observation_(observation), fx_(fx), fy_(fy), cx_(cx), cy_(cy) {}
+
+  virtual ~ReprojectionCostFunction() {}
+
+  virtual bool Evaluate(double const* const* parameters, double* residuals_raw,
+                        double** jacobians) const {
+    const Eigen::Map<const SE3Group<double> > T_cw(parameters[0]);
+    const Eigen::Map<const Eigen::Vector3d> p_w(parameters[1]);
+    Eigen::Map<Eigen::Vector2d> residuals(residuals_raw);
+
+    const Eigen::Vector3d p_c = T_cw * p_w;
+    const double inv_z = 1.0 / p_c[2];
+    residuals[0] = fx_ * p_c[0] * inv_z + cx_ - observation_[0];
+    residuals[1] = fy_ * p_c[1] * inv_z + cy_ - observation_[1];
+
+    if (jacobians == NULL) {
+      return true;
+    }
+    Eigen::Matrix<double, 2, 3> Dpi;
+    Dpi << fx_ * inv_z, 0, -fx_ * p_c[0] * inv_z * inv_z, 0, fy_ * inv_z,
+        -fy_ * p_c[1] * inv_z * inv_z;
+    if (jacobians[0] != NULL) {
+      Eigen::Map<PoseJacobianType> J_pose(jacobians[0]);
+      J_pose = Dpi * details::quaternionActionJacobian(parameters[0], p_w);
+    }
+    if (jacobians[1] != NULL) {
+      Eigen::Map<PointJacobianType> J_point(jacobians[1]);
+      J_point = Dpi * T_cw.so3().matrix();
+    }
+    return true;
+  }
+
+ private:
+  Eigen::Vector2d observation_;
+  double fx_;
+  double fy_;
+  double cx_;
+  double cy_;
+};
+
+/**
+ * \brief Pinhole reprojection residuals of many fixed points seen by one pose
+ *
+ * Stacks the residuals of ReprojectionCostFunction for all observations
+ * (points[i], observations[i]) of the camera with pose T_cw, which is the
+ * single parameter block. All residuals and Jacobians are evaluated in one
+ * BatchOps<SE3Group>::reproject() sweep, computing the rotation matrix once.
+ *
+ * The kernel yields Jacobians with respect to the tangent space. They are
+ * multiplied by SE3Manifold::MinusJacobian(T_cw), a left inverse of its
+ * PlusJacobian, such that Ceres recovers them exactly. Hence this cost
+ * function must be used with SE3Manifold (or another manifold with the same
+ * PlusJacobian). The tangent Jacobians are written to the front of
+ * jacobians[0] and multiplied in place, without a temporary.
+ */
+class BatchReprojectionCostFunction : public ceres::CostFunction {
+ public:
+  typedef Eigen::Matrix<double, 1, SE3Group<double>::num_parameters>
+      PoseJacobianRow;
+  typedef Eigen::Matrix<double, 1, SE3Group<double>::DoF> TangentJacobianRow;
+
+  BatchReprojectionCostFunction(
+      const std::vector<Eigen::Vector3d>& points,
+      const std::vector<Eigen::Vector2d,
+                        Eigen::aligned_allocator<Eigen::Vector2d> >&
+          observations,
+      double fx, double fy, double cx, double cy) {
+    SOPHUS_ENSURE(points.size() == observations.size(),
+                  "Inconsistent number of observations.");
+    for (size_t i = 0; i < points.size(); ++i) {
+      points_.insert(points_.end(), points[i].data(), points[i].data() + 3);
+      observations_.insert(observations_.end(), observations[i].data(),
+                           observations[i].data() + 2);
+    }
+    camera_[0] = fx;
+    camera_[1] = fy;
+    camera_[2] = cx;
+    camera_[3] = cy;
+    set_num_residuals(2 * static_cast<int>(points.size()));
+    mutable_parameter_block_sizes()->push_back(
+        static_cast<int32_t>(SE3Group<double>::num_parameters));
+  }
+
+  virtual ~BatchReprojectionCostFunction() {}
+
+  virtual bool Evaluate(double const* const* parameters, double* residuals,
+                        double** jacobians) const {
+    const std::size_t n = points_.size() / 3;
+    const typename BatchKernels<double>::ReprojectFunction reproject =
+        BatchKernels<double>::selected().se3Reproject;
+    if (jacobians == NULL || jacobians[0] == NULL) {
+      reproject(parameters[0], camera_, points_.data(), observations_.data(),
+                residuals, NULL, NULL, n);
+      return true;
+    }
+
+    double* J = jacobians[0];
+    reproject(parameters[0], camera_, points_.data(), observations_.data(),
+              residuals, J, NULL, n);
+    SE3Manifold::MinusJacobianType minus_jacobian;
+    manifold_.MinusJacobian(parameters[0], minus_jacobian.data());
+    // Result row r, at 7 * r, only overlaps tangent rows r and above, at
+    // 6 * r'. Hence the rows are multiplied from the last one backward, each
+    // from a copy of its tangent row.
+    for (std::size_t r = 2 * n; r-- > 0;) {
+      const TangentJacobianRow tangent_row =
+          Eigen::Map<const TangentJacobianRow>(J + SE3Group<double>::DoF * r);
+      Eigen::Map<PoseJacobianRow>(J + SE3Group<double>::num_parameters * r)
+          .noalias() = tangent_row * minus_jacobian;
+    }
+    return true;
+  }
+
+ private:
+  std::vector<double> points_;
+  std::vector<double> observations_;
+  double camera_[4];
+  SE3Manifold manifold_;
+};
+
+typedef RelativePoseCostFunction<SE2Group, generated::SE2Kernels>
+    RelativeSE2CostFunction;
+typedef RelativePoseCostFunction<SE3Group, generated::SE3Kernels>
+    RelativeSE3CostFunction;
+typedef RelativePoseCostFunction<Sim3Group, generated::Sim3Kernels>
+    RelativeSim3CostFunction;
+typedef PosePriorCostFunction<SE2Group, generated::SE2Kernels>
+    SE2PriorCostFunction;
+typedef PosePriorCostFunction<SE3Group, generated::SE3Kernels>
+    SE3PriorCostFunction;
+typedef PosePriorCostFunction<Sim3Group, generated::Sim3Kernels>
+    Sim3PriorCostFunction;
+typedef PointToPointCostFunction<SE3Group> SE3PointToPointCostFunction;
+typedef PointToPointCostFunction<Sim3Group> Sim3PointToPointCostFunction;
+typedef PointToPlaneCostFunction<SE3Group> SE3PointToPlaneCostFunction;
+typedef PointToPlaneCostFunction<Sim3Group> Sim3PointToPlaneCostFunction;
+
+}  // namespace Sophus
+
+#endif  // SOPHUS_CERES_COST_FUNCTIONS_HPP
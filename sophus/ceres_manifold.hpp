@@ -0,0 +1,211 @@
+// This file is part of Sophus.
+//
+// Copyright 2016 Hauke Strasdat
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights  to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#ifndef SOPHUS_CERES_MANIFOLD_HPP
+#define SOPHUS_CERES_MANIFOLD_HPP
+
+#include <ceres/manifold.h>
+
+#include "dual.hpp"
+#include "generated/rxso3_kernels.hpp"
+#include "generated/se2_kernels.hpp"
+#include "generated/se3_kernels.hpp"
+#include "generated/sim3_kernels.hpp"
+#include "generated/so2_kernels.hpp"
+#include "generated/so3_kernels.hpp"
+#include "rxso3.hpp"
+#include "se2.hpp"
+#include "se3.hpp"
+#include "sim3.hpp"
+#include "so2.hpp"
+#include "so3.hpp"
+
+namespace Sophus {
+namespace details {
+
+/**
+ * \brief Derivative of (A * X * B).data() with respect to X.data()
+ *
+ * Group multiplication is polynomial in the parameters, hence the
+ * forward-mode derivative is exact and, unlike log, has no branches.
+ */
+template <template <class, int> class Group>
+Eigen::Matrix<double, Group<double, 0>::num_parameters,
+              Group<double, 0>::num_parameters>
+productJacobian(const Group<double, 0>& A, const Group<double, 0>& X,
+                const Group<double, 0>& B) {
+  static const int N = Group<double, 0>::num_parameters;
+  typedef Dual<double, N> D;
+  typedef Eigen::Matrix<double, N, 1> Parameters;
+  typedef Eigen::Matrix<D, N, 1> DualParameters;
+
+  Group<D, 0> A_dual, X_dual, B_dual;
+  Eigen::Map<DualParameters> A_dual_params(A_dual.data());
+  Eigen::Map<DualParameters> X_dual_params(X_dual.data());
+  Eigen::Map<DualParameters> B_dual_params(B_dual.data());
+  A_dual_params = Eigen::Map<const Parameters>(A.data()).template cast<D>();
+  X_dual_params = dualVariables(Eigen::Map<const Parameters>(X.data()));
+  B_dual_params = Eigen::Map<const Parameters>(B.data()).template cast<D>();
+  const Group<D, 0> AXB = A_dual * X_dual * B_dual;
+  return dualJacobian(Eigen::Map<const DualParameters>(AXB.data()));
+}
+
+/**
+ * \brief Derivative of (A * X).data() with respect to X.data()
+ */
+template <template <class, int> class Group>
+Eigen::Matrix<double, Group<double, 0>::num_parameters,
+              Group<double, 0>::num_parameters>
+productJacobian(const Group<double, 0>& A, const Group<double, 0>& X) {
+  return productJacobian<Group>(A, X, Group<double, 0>());
+}
+}  // namespace details
+
+/**
+ * \brief Ceres manifold of a Lie group
+ *
+ * The parameter block is the internal data() of Group<double>, i.e. the
+ * ambient space has Group::num_parameters dimensions and the tangent space
+ * Group::DoF dimensions. Increments are applied on the right:
+ *
+ *   Plus(T, delta) = T * exp(delta),  Minus(T_b, T_a) = log(T_a^-1 * T_b).
+ *
+ * All Jacobians are closed form. PlusJacobian is the internalJacobian of the
+ * generated kernels and MinusJacobian is the derivative of log at the
+ * identity times the derivative of the parameters of T_a^-1 * T_b with
+ * respect to the ones of T_b.
+ */
+template <template <class, int> class Group, template <class> class Kernels>
+class Manifold : public ceres::Manifold {
+ public:
+  typedef Group<double, 0> GroupType;
+  typedef Kernels<double> K;
+  static const int DoF = K::DoF;
+  static const int num_parameters = K::num_parameters;
+  typedef typename K::Tangent Tangent;
+  typedef typename K::Parameters Parameters;
+  // Ceres expects row-major Jacobians, which Eigen does not allow for column
+  // vectors (SO2).
+  typedef Eigen::Matrix<double, num_parameters, DoF,
+                        DoF == 1 ? Eigen::ColMajor : Eigen::RowMajor>
+      PlusJacobianType;
+  typedef Eigen::Matrix<double, DoF, num_parameters, Eigen::RowMajor>
+      MinusJacobianType;
+
+  virtual ~Manifold() {}
+
+  virtual int AmbientSize() const { return num_parameters; }
+
+  virtual int TangentSize() const { return DoF; }
+
+  /**
+   * \brief T * exp(delta)
+   */
+  virtual bool Plus(const double* T_raw, const double* delta_raw,
+                    double* T_plus_delta_raw) const {
+    const Eigen::Map<const GroupType> T(T_raw);
+    const Eigen::Map<const Tangent> delta(delta_raw);
+    GroupType exp_delta;
+    Eigen::Map<Parameters> exp_delta_params(exp_delta.data());
+    exp_delta_params = K::exp(delta);
+    Eigen::Map<GroupType> T_plus_delta(T_plus_delta_raw);
+    T_plus_delta = T * exp_delta;
+    return true;
+  }
+
+  /**
+   * \brief Derivative of T * exp(delta) with respect to delta at delta = 0
+   */
+  virtual bool PlusJacobian(const double* T_raw, double* jacobian_raw) const {
+    const Eigen::Map<const Parameters> T(T_raw);
+    Eigen::Map<PlusJacobianType> jacobian(jacobian_raw);
+    jacobian = K::internalJacobian(T);
+    return true;
+  }
+
+  /**
+   * \brief ambient_matrix * PlusJacobian(T), without a dynamically sized
+   * temporary
+   */
+  virtual bool RightMultiplyByPlusJacobian(const double* T_raw,
+                                           const int num_rows,
+                                           const double* ambient_matrix_raw,
+                                           double* tangent_matrix_raw) const {
+    typedef Eigen::Matrix<double, Eigen::Dynamic, num_parameters,
+                          Eigen::RowMajor>
+        AmbientMatrix;
+    typedef Eigen::Matrix<double, Eigen::Dynamic, DoF,
+                          DoF == 1 ? Eigen::ColMajor : Eigen::RowMajor>
+        TangentMatrix;
+    const Eigen::Map<const Parameters> T(T_raw);
+    const Eigen::Map<const AmbientMatrix> ambient_matrix(
+        ambient_matrix_raw, num_rows, num_parameters);
+    Eigen::Map<TangentMatrix> tangent_matrix(tangent_matrix_raw, num_rows,
+                                             DoF);
+    const typename K::ParameterJacobian J = K::internalJacobian(T);
+    tangent_matrix.noalias() = ambient_matrix * J;
+    return true;
+  }
+
+  /**
+   * \brief log(T_a^-1 * T_b)
+   */
+  virtual bool Minus(const double* T_b_raw, const double* T_a_raw,
+                     double* b_minus_a_raw) const {
+    const Eigen::Map<const GroupType> T_a(T_a_raw);
+    const Eigen::Map<const GroupType> T_b(T_b_raw);
+    Eigen::Map<Tangent> b_minus_a(b_minus_a_raw);
+    const GroupType T_ab = T_a.inverse() * T_b;
+    b_minus_a = K::log(Eigen::Map<const Parameters>(T_ab.data()));
+    return true;
+  }
+
+  /**
+   * \brief Derivative of log(T_a^-1 * T_b) with respect to T_b at T_b = T_a
+   */
+  virtual bool MinusJacobian(const double* T_a_raw,
+                             double* jacobian_raw) const {
+    const Eigen::Map<const GroupType> T_a(T_a_raw);
+    Eigen::Map<MinusJacobianType> jacobian(jacobian_raw);
+    jacobian = logJacobianAtIdentity() *
+               details::productJacobian<Group>(T_a.inverse(), T_a);
+    return true;
+  }
+
+ private:
+  static const typename K::LogJacobian& logJacobianAtIdentity() {
+    static const typename K::LogJacobian J =
+        K::Dx_log(Eigen::Map<const Parameters>(GroupType().data()));
+    return J;
+  }
+};
+
+typedef Manifold<SO2Group, generated::SO2Kernels> SO2Manifold;
+typedef Manifold<SE2Group, generated::SE2Kernels> SE2Manifold;
+typedef Manifold<SO3Group, generated::SO3Kernels> SO3Manifold;
+typedef Manifold<SE3Group, generated::SE3Kernels> SE3Manifold;
+typedef Manifold<RxSO3Group, generated::RxSO3Kernels> RxSO3Manifold;
+typedef Manifold<Sim3Group, generated::Sim3Kernels> Sim3Manifold;
+
+}  // namespace Sophus
+
+#endif  // SOPHUS_CERES_MANIFOLD_HPP
@@ -0,0 +1,184 @@
+// This file is part of Sophus.
+//
+// Copyright 2016 Hauke Strasdat
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights  to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#ifndef SOPHUS_CPU_FEATURES_HPP
+#define SOPHUS_CPU_FEATURES_HPP
+
+#include <cstdlib>
+#include <cstring>
+
+// Runtime dispatch is only implemented for x86 with GCC/Clang, since it
+// relies on the target function attribute. On all other platforms (or if
+// SOPHUS_DISABLE_ISA_DISPATCH is defined) only the scalar kernels are used.
+#if !defined(SOPHUS_DISABLE_ISA_DISPATCH) && defined(__GNUC__) && \
+    (defined(__x86_64__) || defined(__i386__))
+#define SOPHUS_ISA_DISPATCH 1
+#include <cpuid.h>
+#endif
+
+namespace Sophus {
+
+/**
+ * \brief Instruction set levels for which batch kernels are provided
+ *
+ * The levels are ordered, i.e. a CPU supporting a given level also supports
+ * all lower levels.
+ */
+enum class CpuIsa { Scalar = 0, SSE42 = 1, AVX2 = 2, AVX512 = 3 };
+
+/**
+ * \returns human readable name of instruction set level
+ */
+inline const char* cpuIsaName(CpuIsa isa) {
+  switch (isa) {
+    case CpuIsa::SSE42:
+      return "sse4.2";
+    case CpuIsa::AVX2:
+      return "avx2";
+    case CpuIsa::AVX512:
+      return "avx512";
+    case CpuIsa::Scalar:
+    default:
+      return "scalar";
+  }
+}
+
+/**
+ * \brief Parses instruction set level name as returned by cpuIsaName()
+ *
+ * \returns false if name is not a known level
+ */
+inline bool parseCpuIsa(const char* name, CpuIsa* isa) {
+  for (int i = static_cast<int>(CpuIsa::Scalar);
+       i <= static_cast<int>(CpuIsa::AVX512); ++i) {
+    if (std::strcmp(name, cpuIsaName(static_cast<CpuIsa>(i))) == 0) {
+      *isa = static_cast<CpuIsa>(i);
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * \brief Features of host CPU relevant for the batch kernels
+ */
+struct CpuFeatures {
+  bool sse42 = false;
+  bool avx = false;
+  bool avx2 = false;
+  bool fma = false;
+  bool avx512f = false;
+  bool avx512dq = false;
+  bool avx512vl = false;
+
+  /**
+   * \returns highest instruction set level supported by all features present
+   */
+  CpuIsa bestIsa() const {
+    if (avx512f && avx512dq && avx512vl && avx2 && fma) {
+      return CpuIsa::AVX512;
+    }
+    if (avx2 && fma) {
+      return CpuIsa::AVX2;
+    }
+    if (sse42) {
+      return CpuIsa::SSE42;
+    }
+    return CpuIsa::Scalar;
+  }
+};
+
+namespace details {
+#ifdef SOPHUS_ISA_DISPATCH
+// Reads the extended control register XCR0 to find out which register
+// states the operating system saves on context switch.
+inline unsigned long long readXcr0() {
+  unsigned int eax, edx;
+  __asm__ __volatile__("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+  return (static_cast<unsigned long long>(edx) << 32) | eax;
+}
+#endif
+}  // namespace details
+
+/**
+ * \brief Queries host CPU via cpuid
+ *
+ * AVX and AVX-512 features are only reported if the operating system also
+ * saves the corresponding register state (checked via xgetbv).
+ */
+inline CpuFeatures detectCpuFeatures() {
+  CpuFeatures features;
+#ifdef SOPHUS_ISA_DISPATCH
+  unsigned int eax, ebx, ecx, edx;
+  if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) {
+    return features;
+  }
+  features.sse42 = (ecx & bit_SSE4_2) != 0;
+  features.fma = (ecx & bit_FMA) != 0;
+  const bool osxsave = (ecx & bit_OSXSAVE) != 0;
+  const bool cpu_avx = (ecx & bit_AVX) != 0;
+
+  unsigned long long xcr0 = osxsave ? details::readXcr0() : 0;
+  // XMM and YMM state
+  const bool os_avx = (xcr0 & 0x6) == 0x6;
+  // opmask, upper ZMM0-15 and ZMM16-31 state
+  const bool os_avx512 = os_avx && (xcr0 & 0xe0) == 0xe0;
+
+  features.avx = cpu_avx && os_avx;
+  features.fma = features.fma && features.avx;
+
+  if (__get_cpuid_max(0, nullptr) >= 7) {
+    __cpuid_count(7, 0, eax, ebx, ecx, edx);
+    features.avx2 = features.avx && (ebx & bit_AVX2) != 0;
+    features.avx512f = os_avx512 && (ebx & bit_AVX512F) != 0;
+    features.avx512dq = os_avx512 && (ebx & bit_AVX512DQ) != 0;
+    features.avx512vl = os_avx512 && (ebx & bit_AVX512VL) != 0;
+  }
+#endif
+  return features;
+}
+
+/**
+ * \brief Instruction set level used by the batch kernels
+ *
+ * This is the best level supported by the host CPU, unless the environment
+ * variable SOPHUS_ISA is set to a lower level (one of "scalar", "sse4.2",
+ * "avx2", "avx512"). Requesting a level above what the CPU supports has no
+ * effect.
+ */
+inline CpuIsa selectCpuIsa() {
+#ifdef SOPHUS_ISA_DISPATCH
+  CpuIsa isa = detectCpuFeatures().bestIsa();
+  const char* requested_name = std::getenv("SOPHUS_ISA");
+  CpuIsa requested;
+  if (requested_name != nullptr && parseCpuIsa(requested_name, &requested) &&
+      requested < isa) {
+    isa = requested;
+  }
+  return isa;
+#else
+  return CpuIsa::Scalar;
+#endif
+}
+}  // namespace Sophus
+
+#endif  // SOPHUS_CPU_FEATURES_HPP
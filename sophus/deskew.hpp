@@ -0,0 +1,249 @@
+// This file is part of Sophus.
+//
+// Copyright 2016 Hauke Strasdat
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights  to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+
+#ifndef SOPHUS_DESKEW_HPP
+#define SOPHUS_DESKEW_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+#include <Eigen/StdVector>
+
+#include "batch.hpp"
+#include "parallel.hpp"
+#include "se3.hpp"
+
+namespace Sophus {
+
+struct DeskewOptions {
+  // Number of time slices K of the sweep.
+  int num_slices = 64;
+  // If set, each point is moved from its slice center to its own timestamp
+  // with the first-order expansion of the slice motion; otherwise all points
+  // of a slice share the pose at its center.
+  bool first_order = false;
+  // Zero uses all hardware threads.
+  std::size_t num_threads = 0;
+};
+
+/**
+ * \brief Motion compensation of a scanning sensor sweep
+ *
+ * Point p_i, measured at time t_i in the sensor frame, is mapped to
+ * T_ref^-1 * T_w_s(t_i) * p_i, i.e. into the sensor frame at the end of the
+ * sweep (or see setReferencePose()). The sweep [t_start, t_end] is split
+ * into K slices, and the motion within slice k is the constant velocity
+ * motion B_k * exp(s * xi_k), s in [0, 1], between the poses B_k and
+ * B_k+1 = T_w_s(t_start + k * (t_end - t_start) / K) at the slice
+ * boundaries. For two poses T_start and T_end this reproduces the constant
+ * velocity interpolation T_start * exp(s * log(T_start^-1 * T_end)) exactly;
+ * general motion models, e.g. splines, are sampled at the K + 1 boundaries.
+ *
+ * Points are binned by slice and each slice is transformed at once with
+ * BatchKernels::se3TransformPoints(), or se3TransformPointsFirstOrder() if
+ * DeskewOptions::first_order is set. See maxError() for the resulting
+ * accuracy. Timestamps outside of the sweep are extrapolated from the first
+ * or last slice.
+ */
+template <typename Scalar>
+class SweepDeskewer {
+ public:
+  typedef SE3Group<Scalar> Group;
+  typedef typename Group::Tangent Tangent;
+
+  /**
+   * \brief Constant velocity motion from T_start to T_end
+   */
+  SweepDeskewer(Scalar t_start, Scalar t_end, const Group& T_start,
+                const Group& T_end,
+                const DeskewOptions& options = DeskewOptions())
+      : options_(options), t_start_(t_start), t_end_(t_end) {
+    checkOptions();
+    const Tangent xi = (T_start.inverse() * T_end).log();
+    const int K = options_.num_slices;
+    setBoundaries([&](int k) {
+      return T_start * Group::exp((Scalar(k) / Scalar(K)) * xi);
+    });
+  }
+
+  /**
+   * \brief General motion, given by motion(t) = T_w_s(t)
+   */
+  template <typename Motion>
+  SweepDeskewer(Scalar t_start, Scalar t_end, const Motion& motion,
+                const DeskewOptions& options = DeskewOptions())
+      : options_(options), t_start_(t_start), t_end_(t_end) {
+    checkOptions();
+    const Scalar dt = (t_end - t_start) / Scalar(options_.num_slices);
+    setBoundaries(
+        [&](int k) { return Group(motion(t_start + Scalar(k) * dt)); });
+  }
+
+  /**
+   * \brief Sets the pose T_ref of the output frame
+   *
+   * Defaults to the pose at the end of the sweep; the identity gives
+   * points in the world frame.
+   */
+  void setReferencePose(const Group& T_ref) {
+    const Group T_ref_inverse = T_ref.inverse();
+    for (int k = 0; k < options_.num_slices; ++k) {
+      const Group center =
+          T_ref_inverse * boundaries_[k] * Group::exp(Scalar(0.5) * twists_[k]);
+      std::copy(center.data(), center.data() + Group::num_parameters,
+                &centers_[Group::num_parameters * k]);
+    }
+  }
+
+  /**
+   * \brief Largest displacement error of points within range of the sensor
+   *
+   * Leading order bound relative to the exact piecewise constant velocity
+   * motion: half a slice of motion, (|omega| * range + |upsilon|) / 2, for
+   * the slice poses, and (|omega| * range + |upsilon|) * |omega| / 8 with
+   * the first-order expansion, maximized over the slice twists
+   * (upsilon, omega).
+   */
+  Scalar maxError(Scalar range) const {
+    Scalar error = 0;
+    for (const Tangent& xi : twists_) {
+      const Scalar omega = xi.template tail<3>().norm();
+      const Scalar motion = omega * range + xi.template head<3>().norm();
+      error = std::max(error, options_.first_order ? motion * omega / 8
+                                                   : motion / 2);
+    }
+    return error;
+  }
+
+  /**
+   * \brief Deskews n points (x, y, z each) with timestamps into out
+   *
+   * out must not overlap points. Scratch buffers are kept between calls.
+   */
+  void deskew(const Scalar* points, const Scalar* timestamps, std::size_t n,
+              Scalar* out) {
+    const int K = options_.num_slices;
+    const Scalar inv_dt = Scalar(K) / (t_end_ - t_start_);
+
+    // counting sort of the points by slice
+    slice_of_point_.resize(n);
+    slice_offsets_.assign(K + 1, 0);
+    for (std::size_t i = 0; i < n; ++i) {
+      const Scalar s = (timestamps[i] - t_start_) * inv_dt;
+      const int k = s < Scalar(1) ? 0
+                                  : (s >= Scalar(K - 1)
+                                         ? K - 1
+                                         : static_cast<int>(s));
+      slice_of_point_[i] = k;
+      ++slice_offsets_[k + 1];
+    }
+    for (int k = 0; k < K; ++k) {
+      slice_offsets_[k + 1] += slice_offsets_[k];
+    }
+    order_.resize(n);
+    sorted_in_.resize(3 * n);
+    sorted_out_.resize(3 * n);
+    offsets_.resize(options_.first_order ? n : 0);
+    fill_.assign(slice_offsets_.begin(), slice_offsets_.end() - 1);
+    for (std::size_t i = 0; i < n; ++i) {
+      const int k = slice_of_point_[i];
+      const std::size_t j = fill_[k]++;
+      order_[j] = i;
+      std::copy(points + 3 * i, points + 3 * i + 3, &sorted_in_[3 * j]);
+      if (options_.first_order) {
+        // offset from the slice center, in units of the slice duration
+        offsets_[j] =
+            (timestamps[i] - t_start_) * inv_dt - Scalar(k) - Scalar(0.5);
+      }
+    }
+
+    const BatchKernels<Scalar>& kernels = BatchKernels<Scalar>::selected();
+    parallelFor(0, K, options_.num_threads, 1, [&](std::size_t k) {
+      const std::size_t begin = slice_offsets_[k];
+      const std::size_t m = slice_offsets_[k + 1] - begin;
+      if (m == 0) {
+        return;
+      }
+      const Scalar* center = &centers_[Group::num_parameters * k];
+      if (options_.first_order) {
+        kernels.se3TransformPointsFirstOrder(
+            center, twists_[k].data(), &offsets_[begin],
+            &sorted_in_[3 * begin], &sorted_out_[3 * begin], m);
+      } else {
+        kernels.se3TransformPoints(center, &sorted_in_[3 * begin],
+                                   &sorted_out_[3 * begin], m);
+      }
+    });
+
+    for (std::size_t j = 0; j < n; ++j) {
+      std::copy(&sorted_out_[3 * j], &sorted_out_[3 * j] + 3,
+                out + 3 * order_[j]);
+    }
+  }
+
+  int numSlices() const { return options_.num_slices; }
+
+ private:
+  void checkOptions() const {
+    SOPHUS_ENSURE(options_.num_slices > 0, "num_slices must be positive, not %",
+                  options_.num_slices);
+    SOPHUS_ENSURE(t_end_ > t_start_, "empty sweep [%, %]", t_start_, t_end_);
+  }
+
+  template <typename Boundary>
+  void setBoundaries(const Boundary& boundary) {
+    const int K = options_.num_slices;
+    boundaries_.resize(K + 1);
+    for (int k = 0; k <= K; ++k) {
+      boundaries_[k] = boundary(k);
+    }
+    twists_.resize(K);
+    for (int k = 0; k < K; ++k) {
+      twists_[k] = (boundaries_[k].inverse() * boundaries_[k + 1]).log();
+    }
+    centers_.resize(Group::num_parameters * K);
+    setReferencePose(boundaries_[K]);
+  }
+
+  DeskewOptions options_;
+  Scalar t_start_;
+  Scalar t_end_;
+  std::vector<Group, Eigen::aligned_allocator<Group> > boundaries_;
+  std::vector<Tangent, Eigen::aligned_allocator<Tangent> > twists_;
+  // T_ref^-1 * pose at the slice centers, packed
+  std::vector<Scalar> centers_;
+
+  // scratch
+  std::vector<int> slice_of_point_;
+  std::vector<std::size_t> slice_offsets_;
+  std::vector<std::size_t> fill_;
+  std::vector<std::size_t> order_;
+  std::vector<Scalar> sorted_in_;
+  std::vector<Scalar> sorted_out_;
+  std::vector<Scalar> offsets_;
+};
+}  // namespace Sophus
+
+#endif  // SOPHUS_DESKEW_HPP
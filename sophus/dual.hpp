@@ -0,0 +1,451 @@
+// This file is part of Sophus.
+//
+// Copyright 2016 Hauke Strasdat
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights  to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#ifndef SOPHUS_DUAL_HPP
+#define SOPHUS_DUAL_HPP
+
+#include <cmath>
+#include <ostream>
+#include <limits>
+
+#include <Eigen/Core>
+
+namespace Sophus {
+
+/**
+ * \brief Forward-mode automatic differentiation number
+ *
+ * Holds a value a and its derivatives v with respect to N variables, i.e.
+ * the number a + v^T eps with eps_i eps_j = 0. The derivative lanes are
+ * stored as fixed-size Eigen vector, such that all operations on them are
+ * vectorized.
+ *
+ * Dual can be used as Scalar of all Sophus groups, e.g.
+ * SE3Group<Dual<double, 6> >, in code which does not link against Ceres.
+ */
+template <class T, int N>
+class Dual {
+ public:
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+  typedef Eigen::Matrix<T, N, 1> Lanes;
+
+  /**
+   * Default constructor, initializes value and derivatives with zero
+   */
+  Dual() : a(T(0)), v(Lanes::Zero()) {}
+
+  /**
+   * Constant, i.e. dual number with zero derivatives
+   */
+  explicit Dual(const T& value) : a(value), v(Lanes::Zero()) {}
+
+  /**
+   * The k-th variable, i.e. dual number with unit derivative in lane k
+   */
+  Dual(const T& value, int k) : a(value), v(Lanes::Zero()) { v[k] = T(1); }
+
+  template <class Derived>
+  Dual(const T& value, const Eigen::DenseBase<Derived>& lanes)
+      : a(value), v(lanes) {}
+
+  inline Dual& operator+=(const Dual& other) {
+    a += other.a;
+    v += other.v;
+    return *this;
+  }
+
+  inline Dual& operator-=(const Dual& other) {
+    a -= other.a;
+    v -= other.v;
+    return *this;
+  }
+
+  inline Dual& operator*=(const Dual& other) {
+    v = other.a * v + a * other.v;
+    a *= other.a;
+    return *this;
+  }
+
+  inline Dual& operator/=(const Dual& other) {
+    const T inv = T(1) / other.a;
+    a *= inv;
+    v = (v - a * other.v) * inv;
+    return *this;
+  }
+
+  inline Dual& operator+=(const T& s) {
+    a += s;
+    return *this;
+  }
+
+  inline Dual& operator-=(const T& s) {
+    a -= s;
+    return *this;
+  }
+
+  inline Dual& operator*=(const T& s) {
+    a *= s;
+    v *= s;
+    return *this;
+  }
+
+  inline Dual& operator/=(const T& s) {
+    const T inv = T(1) / s;
+    a *= inv;
+    v *= inv;
+    return *this;
+  }
+
+  // value
+  T a;
+  // derivatives
+  Lanes v;
+};
+
+////////////////////////////////////////////////////////////////////////////
+// Arithmetic
+////////////////////////////////////////////////////////////////////////////
+
+template <class T, int N>
+inline const Dual<T, N>& operator+(const Dual<T, N>& f) {
+  return f;
+}
+
+template <class T, int N>
+inline Dual<T, N> operator-(const Dual<T, N>& f) {
+  return Dual<T, N>(-f.a, -f.v);
+}
+
+template <class T, int N>
+inline Dual<T, N> operator+(const Dual<T, N>& f, const Dual<T, N>& g) {
+  return Dual<T, N>(f.a + g.a, f.v + g.v);
+}
+
+template <class T, int N>
+inline Dual<T, N> operator+(const Dual<T, N>& f, const T& s) {
+  return Dual<T, N>(f.a + s, f.v);
+}
+
+template <class T, int N>
+inline Dual<T, N> operator+(const T& s, const Dual<T, N>& f) {
+  return Dual<T, N>(s + f.a, f.v);
+}
+
+template <class T, int N>
+inline Dual<T, N> operator-(const Dual<T, N>& f, const Dual<T, N>& g) {
+  return Dual<T, N>(f.a - g.a, f.v - g.v);
+}
+
+template <class T, int N>
+inline Dual<T, N> operator-(const Dual<T, N>& f, const T& s) {
+  return Dual<T, N>(f.a - s, f.v);
+}
+
+template <class T, int N>
+inline Dual<T, N> operator-(const T& s, const Dual<T, N>& f) {
+  return Dual<T, N>(s - f.a, -f.v);
+}
+
+template <class T, int N>
+inline Dual<T, N> operator*(const Dual<T, N>& f, const Dual<T, N>& g) {
+  return Dual<T, N>(f.a * g.a, g.a * f.v + f.a * g.v);
+}
+
+template <class T, int N>
+inline Dual<T, N> operator*(const Dual<T, N>& f, const T& s) {
+  return Dual<T, N>(f.a * s, f.v * s);
+}
+
+template <class T, int N>
+inline Dual<T, N> operator*(const T& s, const Dual<T, N>& f) {
+  return Dual<T, N>(s * f.a, s * f.v);
+}
+
+template <class T, int N>
+inline Dual<T, N> operator/(const Dual<T, N>& f, const Dual<T, N>& g) {
+  // d(f/g) = (df - f/g dg) / g, with a single division
+  const T inv = T(1) / g.a;
+  const T value = f.a * inv;
+  return Dual<T, N>(value, (f.v - value * g.v) * inv);
+}
+
+template <class T, int N>
+inline Dual<T, N> operator/(const Dual<T, N>& f, const T& s) {
+  const T inv = T(1) / s;
+  return Dual<T, N>(f.a * inv, f.v * inv);
+}
+
+template <class T, int N>
+inline Dual<T, N> operator/(const T& s, const Dual<T, N>& g) {
+  const T inv = T(1) / g.a;
+  const T value = s * inv;
+  return Dual<T, N>(value, (-value * inv) * g.v);
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Comparisons, which only consider the value
+////////////////////////////////////////////////////////////////////////////
+
+#define SOPHUS_DUAL_COMPARISON(op)                                           \
+  template <class T, int N>                                                  \
+  inline bool operator op(const Dual<T, N>& f, const Dual<T, N>& g) {        \
+    return f.a op g.a;                                                       \
+  }                                                                          \
+  template <class T, int N>                                                  \
+  inline bool operator op(const Dual<T, N>& f, const T& s) {                 \
+    return f.a op s;                                                         \
+  }                                                                          \
+  template <class T, int N>                                                  \
+  inline bool operator op(const T& s, const Dual<T, N>& g) {                 \
+    return s op g.a;                                                         \
+  }
+SOPHUS_DUAL_COMPARISON(<)
+SOPHUS_DUAL_COMPARISON(<=)
+SOPHUS_DUAL_COMPARISON(>)
+SOPHUS_DUAL_COMPARISON(>=)
+SOPHUS_DUAL_COMPARISON(==)
+SOPHUS_DUAL_COMPARISON(!=)
+#undef SOPHUS_DUAL_COMPARISON
+
+////////////////////////////////////////////////////////////////////////////
+// Functions, found by argument dependent lookup next to the std versions
+////////////////////////////////////////////////////////////////////////////
+
+template <class T, int N>
+inline Dual<T, N> abs(const Dual<T, N>& f) {
+  return f.a < T(0) ? -f : f;
+}
+
+template <class T, int N>
+inline Dual<T, N> sqrt(const Dual<T, N>& f) {
+  using std::sqrt;
+  const T s = sqrt(f.a);
+  return Dual<T, N>(s, f.v * (T(0.5) / s));
+}
+
+template <class T, int N>
+inline Dual<T, N> exp(const Dual<T, N>& f) {
+  using std::exp;
+  const T e = exp(f.a);
+  return Dual<T, N>(e, e * f.v);
+}
+
+template <class T, int N>
+inline Dual<T, N> log(const Dual<T, N>& f) {
+  using std::log;
+  return Dual<T, N>(log(f.a), f.v / f.a);
+}
+
+template <class T, int N>
+inline Dual<T, N> sin(const Dual<T, N>& f) {
+  using std::cos;
+  using std::sin;
+  return Dual<T, N>(sin(f.a), cos(f.a) * f.v);
+}
+
+template <class T, int N>
+inline Dual<T, N> cos(const Dual<T, N>& f) {
+  using std::cos;
+  using std::sin;
+  return Dual<T, N>(cos(f.a), -sin(f.a) * f.v);
+}
+
+template <class T, int N>
+inline Dual<T, N> tan(const Dual<T, N>& f) {
+  using std::tan;
+  const T t = tan(f.a);
+  return Dual<T, N>(t, (T(1) + t * t) * f.v);
+}
+
+template <class T, int N>
+inline Dual<T, N> asin(const Dual<T, N>& f) {
+  using std::asin;
+  using std::sqrt;
+  return Dual<T, N>(asin(f.a), f.v / sqrt(T(1) - f.a * f.a));
+}
+
+template <class T, int N>
+inline Dual<T, N> acos(const Dual<T, N>& f) {
+  using std::acos;
+  using std::sqrt;
+  return Dual<T, N>(acos(f.a), f.v / -sqrt(T(1) - f.a * f.a));
+}
+
+template <class T, int N>
+inline Dual<T, N> atan(const Dual<T, N>& f) {
+  using std::atan;
+  return Dual<T, N>(atan(f.a), f.v / (T(1) + f.a * f.a));
+}
+
+template <class T, int N>
+inline Dual<T, N> atan2(const Dual<T, N>& y, const Dual<T, N>& x) {
+  using std::atan2;
+  const T inv_sq_norm = T(1) / (x.a * x.a + y.a * y.a);
+  return Dual<T, N>(atan2(y.a, x.a),
+                    (x.a * inv_sq_norm) * y.v - (y.a * inv_sq_norm) * x.v);
+}
+
+template <class T, int N>
+inline Dual<T, N> pow(const Dual<T, N>& f, const T& g) {
+  using std::pow;
+  const T p = pow(f.a, g - T(1));
+  return Dual<T, N>(p * f.a, (g * p) * f.v);
+}
+
+template <class T, int N>
+inline Dual<T, N> pow(const T& f, const Dual<T, N>& g) {
+  using std::log;
+  using std::pow;
+  const T p = pow(f, g.a);
+  return Dual<T, N>(p, (p * log(f)) * g.v);
+}
+
+template <class T, int N>
+inline Dual<T, N> pow(const Dual<T, N>& f, const Dual<T, N>& g) {
+  using std::log;
+  using std::pow;
+  const T p = pow(f.a, g.a);
+  return Dual<T, N>(p, (g.a * p / f.a) * f.v + (p * log(f.a)) * g.v);
+}
+
+template <class T, int N>
+inline bool isfinite(const Dual<T, N>& f) {
+  using std::isfinite;
+  return isfinite(f.a) && f.v.allFinite();
+}
+
+template <class T, int N>
+inline bool isnan(const Dual<T, N>& f) {
+  using std::isnan;
+  return isnan(f.a) || f.v.hasNaN();
+}
+
+template <class T, int N>
+inline bool isinf(const Dual<T, N>& f) {
+  using std::isinf;
+  const T inf = std::numeric_limits<T>::infinity();
+  return isinf(f.a) || (f.v.array().abs() == inf).any();
+}
+
+template <class T, int N>
+std::ostream& operator<<(std::ostream& s, const Dual<T, N>& f) {
+  return s << "[" << f.a << " ; " << f.v.transpose() << "]";
+}
+
+/**
+ * \brief Values of a matrix of dual numbers
+ */
+template <class Derived>
+inline Eigen::Matrix<typename Derived::Scalar::Lanes::Scalar,
+                     Derived::RowsAtCompileTime, Derived::ColsAtCompileTime>
+dualValue(const Eigen::MatrixBase<Derived>& m) {
+  typedef typename Derived::Scalar::Lanes::Scalar T;
+  Eigen::Matrix<T, Derived::RowsAtCompileTime, Derived::ColsAtCompileTime> res(
+      m.rows(), m.cols());
+  for (int c = 0; c < m.cols(); ++c) {
+    for (int r = 0; r < m.rows(); ++r) {
+      res(r, c) = m(r, c).a;
+    }
+  }
+  return res;
+}
+
+/**
+ * \brief Jacobian of a vector of dual numbers
+ *
+ * Row i holds the derivative lanes of the i-th element.
+ */
+template <class Derived>
+inline Eigen::Matrix<typename Derived::Scalar::Lanes::Scalar,
+                     Derived::RowsAtCompileTime,
+                     Derived::Scalar::Lanes::RowsAtCompileTime>
+dualJacobian(const Eigen::MatrixBase<Derived>& vec) {
+  EIGEN_STATIC_ASSERT_VECTOR_ONLY(Derived);
+  typedef typename Derived::Scalar::Lanes Lanes;
+  Eigen::Matrix<typename Lanes::Scalar, Derived::RowsAtCompileTime,
+                Lanes::RowsAtCompileTime>
+      res(vec.size(), Lanes::RowsAtCompileTime);
+  for (int i = 0; i < vec.size(); ++i) {
+    res.row(i) = vec[i].v.transpose();
+  }
+  return res;
+}
+
+/**
+ * \brief Seeds a vector of variables, the i-th with unit derivative in lane i
+ */
+template <class Derived>
+inline Eigen::Matrix<Dual<typename Derived::Scalar, Derived::RowsAtCompileTime>,
+                     Derived::RowsAtCompileTime, 1>
+dualVariables(const Eigen::MatrixBase<Derived>& x) {
+  EIGEN_STATIC_ASSERT_VECTOR_ONLY(Derived);
+  typedef Dual<typename Derived::Scalar, Derived::RowsAtCompileTime> D;
+  Eigen::Matrix<D, Derived::RowsAtCompileTime, 1> res;
+  for (int i = 0; i < x.size(); ++i) {
+    res[i] = D(x[i], i);
+  }
+  return res;
+}
+}  // namespace Sophus
+
+namespace Eigen {
+
+template <class T, int N>
+struct NumTraits<Sophus::Dual<T, N> > {
+  typedef Sophus::Dual<T, N> Real;
+  typedef Sophus::Dual<T, N> NonInteger;
+  typedef Sophus::Dual<T, N> Nested;
+  typedef Sophus::Dual<T, N> Literal;
+
+  static inline Real dummy_precision() {
+    return Real(NumTraits<T>::dummy_precision());
+  }
+  static inline Real epsilon() { return Real(NumTraits<T>::epsilon()); }
+  static inline Real highest() { return Real(NumTraits<T>::highest()); }
+  static inline Real lowest() { return Real(NumTraits<T>::lowest()); }
+  static inline int digits10() { return NumTraits<T>::digits10(); }
+
+  enum {
+    IsComplex = 0,
+    IsInteger = 0,
+    IsSigned = 1,
+    RequireInitialization = 1,
+    ReadCost = (N + 1) * NumTraits<T>::ReadCost,
+    AddCost = (N + 1) * NumTraits<T>::AddCost,
+    MulCost = (2 * N + 1) * NumTraits<T>::MulCost + N * NumTraits<T>::AddCost
+  };
+};
+
+// Allows products of Dual matrices with plain T scalars and matrices.
+template <class T, int N, typename BinaryOp>
+struct ScalarBinaryOpTraits<Sophus::Dual<T, N>, T, BinaryOp> {
+  typedef Sophus::Dual<T, N> ReturnType;
+};
+
+template <class T, int N, typename BinaryOp>
+struct ScalarBinaryOpTraits<T, Sophus::Dual<T, N>, BinaryOp> {
+  typedef Sophus::Dual<T, N> ReturnType;
+};
+}  // namespace Eigen
+
+#endif  // SOPHUS_DUAL_HPP
@@ -0,0 +1,305 @@
+// This file is part of Sophus.
+//
+// Copyright 2016 Hauke Strasdat
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights  to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+
+#ifndef SOPHUS_FRAME_GRAPH_HPP
+#define SOPHUS_FRAME_GRAPH_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "batch.hpp"
+#include "se3.hpp"
+
+namespace Sophus {
+
+/**
+ * \brief Tree of coordinate frames with cached root-relative transforms
+ *
+ * Every frame but the root has a parent and the edge transform
+ * T_parent_frame. The composed transform T_root_frame of each frame is
+ * cached and only recomposed after an edge on its path to the root changed:
+ * each edge carries a version, and each cache entry records the edge
+ * version and the cache stamp of its parent that it was composed from.
+ * A query T_target_source = T_root_target^-1 * T_root_source then costs a
+ * walk over the version counters of both paths and one product.
+ *
+ * lookup(), transformPoints() and setTransform() may be called concurrently
+ * from any number of threads. Writers (edge updates and cache refreshes)
+ * are serialized by a mutex and publish through a sequence lock, so that
+ * readers of valid caches never block: they retry if a writer interfered.
+ * addFrame() must not run concurrently with any other member function.
+ *
+ * Scalar must be a floating point type.
+ */
+template <typename Scalar>
+class FrameGraph {
+ public:
+  typedef SE3Group<Scalar> Group;
+  static const int num_parameters = Group::num_parameters;
+
+  explicit FrameGraph(const std::string& root_name = "map") {
+    frames_.emplace_back(new Frame(root_name, -1));
+    Frame& root = *frames_[0];
+    store(Group(), root.edge);
+    store(Group(), root.T_root_frame);
+    // the root cache is always valid
+    root.stamp.store(nextStamp(), std::memory_order_relaxed);
+    name_to_id_[root_name] = 0;
+  }
+
+  /**
+   * \brief Adds frame name as child of parent, and returns its id
+   */
+  int addFrame(const std::string& name, int parent,
+               const Group& T_parent_frame) {
+    checkFrame(parent);
+    SOPHUS_ENSURE(name_to_id_.count(name) == 0, "frame % exists",
+                  name.c_str());
+    const int id = numFrames();
+    frames_.emplace_back(new Frame(name, parent));
+    name_to_id_[name] = id;
+    setTransform(id, T_parent_frame);
+    return id;
+  }
+
+  /**
+   * \returns id of frame name, or -1 if there is no such frame
+   */
+  int frameId(const std::string& name) const {
+    const auto it = name_to_id_.find(name);
+    return it == name_to_id_.end() ? -1 : it->second;
+  }
+
+  const std::string& name(int frame) const {
+    checkFrame(frame);
+    return frames_[frame]->name;
+  }
+
+  /**
+   * \returns id of the parent of frame, or -1 for the root
+   */
+  int parent(int frame) const {
+    checkFrame(frame);
+    return frames_[frame]->parent;
+  }
+
+  int numFrames() const { return static_cast<int>(frames_.size()); }
+
+  /**
+   * \brief Replaces the edge T_parent_frame
+   *
+   * Invalidates the cached transforms of frame and its descendants.
+   */
+  void setTransform(int frame, const Group& T_parent_frame) {
+    checkFrame(frame);
+    SOPHUS_ENSURE(frame != 0, "the root has no parent transform");
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    beginWrite();
+    Frame& f = *frames_[frame];
+    store(T_parent_frame, f.edge);
+    f.edge_version.store(f.edge_version.load(std::memory_order_relaxed) + 1,
+                         std::memory_order_relaxed);
+    endWrite();
+  }
+
+  /**
+   * \returns T_target_source, which maps points in source to target
+   */
+  Group lookup(int target, int source) const {
+    checkFrame(target);
+    checkFrame(source);
+    Scalar root_target[num_parameters];
+    Scalar root_source[num_parameters];
+    readRootTransforms(target, source, root_target, root_source);
+    const Eigen::Map<const Group> T_root_target(root_target);
+    const Eigen::Map<const Group> T_root_source(root_source);
+    return T_root_target.inverse() * T_root_source;
+  }
+
+  Group lookup(const std::string& target, const std::string& source) const {
+    return lookup(frameId(target), frameId(source));
+  }
+
+  /**
+   * \brief Maps n points (x, y, z each) from frame source to target
+   *
+   * The transform is composed once and applied with
+   * BatchKernels::se3TransformPoints().
+   */
+  void transformPoints(int target, int source, const Scalar* points_in,
+                       Scalar* points_out, std::size_t n) const {
+    const Group T_target_source = lookup(target, source);
+    BatchKernels<Scalar>::selected().se3TransformPoints(
+        T_target_source.data(), points_in, points_out, n);
+  }
+
+ private:
+  struct Frame {
+    Frame(const std::string& name, int parent)
+        : name(name),
+          parent(parent),
+          edge_version(1),
+          stamp(0),
+          cached_edge_version(0),
+          cached_parent_stamp(0) {}
+
+    std::string name;
+    int parent;
+    std::atomic<Scalar> edge[num_parameters];
+    std::atomic<std::uint64_t> edge_version;
+    // cache
+    std::atomic<Scalar> T_root_frame[num_parameters];
+    std::atomic<std::uint64_t> stamp;
+    std::atomic<std::uint64_t> cached_edge_version;
+    std::atomic<std::uint64_t> cached_parent_stamp;
+  };
+
+  static void store(const Group& T, std::atomic<Scalar>* params) {
+    for (int i = 0; i < num_parameters; ++i) {
+      params[i].store(T.data()[i], std::memory_order_relaxed);
+    }
+  }
+
+  static Group load(const std::atomic<Scalar>* params) {
+    Scalar copy[num_parameters];
+    for (int i = 0; i < num_parameters; ++i) {
+      copy[i] = params[i].load(std::memory_order_relaxed);
+    }
+    const Eigen::Map<const Group> T(copy);
+    return Group(T);
+  }
+
+  void checkFrame(int frame) const {
+    SOPHUS_ENSURE(frame >= 0 && frame < numFrames(), "invalid frame id %",
+                  frame);
+  }
+
+  std::uint64_t nextStamp() const { return ++last_stamp_; }
+
+  // Sequence lock, write side; requires write_mutex_.
+  void beginWrite() const {
+    sequence_.store(sequence_.load(std::memory_order_relaxed) + 1,
+                    std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+  }
+
+  void endWrite() const {
+    sequence_.store(sequence_.load(std::memory_order_relaxed) + 1,
+                    std::memory_order_release);
+  }
+
+  // Whether the caches on the path from frame to the root are up to date.
+  bool isCached(int frame) const {
+    for (; frame != 0; frame = frames_[frame]->parent) {
+      const Frame& f = *frames_[frame];
+      const Frame& p = *frames_[f.parent];
+      if (f.cached_edge_version.load(std::memory_order_relaxed) !=
+              f.edge_version.load(std::memory_order_relaxed) ||
+          f.cached_parent_stamp.load(std::memory_order_relaxed) !=
+              p.stamp.load(std::memory_order_relaxed)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // Recomposes the stale caches on the path from frame to the root, top
+  // down; requires write_mutex_ and an open write section.
+  void refresh(int frame) const {
+    path_.clear();
+    for (; frame != 0; frame = frames_[frame]->parent) {
+      path_.push_back(frame);
+    }
+    bool stale = false;
+    for (auto it = path_.rbegin(); it != path_.rend(); ++it) {
+      Frame& f = *frames_[*it];
+      const Frame& p = *frames_[f.parent];
+      const std::uint64_t edge_version =
+          f.edge_version.load(std::memory_order_relaxed);
+      const std::uint64_t parent_stamp =
+          p.stamp.load(std::memory_order_relaxed);
+      stale = stale ||
+              f.cached_edge_version.load(std::memory_order_relaxed) !=
+                  edge_version ||
+              f.cached_parent_stamp.load(std::memory_order_relaxed) !=
+                  parent_stamp;
+      if (!stale) {
+        continue;
+      }
+      store(load(p.T_root_frame) * load(f.edge), f.T_root_frame);
+      f.cached_edge_version.store(edge_version, std::memory_order_relaxed);
+      f.cached_parent_stamp.store(parent_stamp, std::memory_order_relaxed);
+      f.stamp.store(nextStamp(), std::memory_order_relaxed);
+    }
+  }
+
+  // Consistent snapshot of T_root_a and T_root_b. Valid caches are read
+  // optimistically and the read is retried if a writer ran meanwhile; stale
+  // caches are refreshed under the write lock first.
+  void readRootTransforms(int a, int b, Scalar* root_a, Scalar* root_b) const {
+    for (;;) {
+      const std::uint64_t sequence =
+          sequence_.load(std::memory_order_acquire);
+      if (sequence % 2 == 0) {
+        if (isCached(a) && isCached(b)) {
+          for (int i = 0; i < num_parameters; ++i) {
+            root_a[i] =
+                frames_[a]->T_root_frame[i].load(std::memory_order_relaxed);
+            root_b[i] =
+                frames_[b]->T_root_frame[i].load(std::memory_order_relaxed);
+          }
+          std::atomic_thread_fence(std::memory_order_acquire);
+          if (sequence_.load(std::memory_order_relaxed) == sequence) {
+            return;
+          }
+          continue;
+        }
+      }
+      std::lock_guard<std::mutex> lock(write_mutex_);
+      if (!isCached(a) || !isCached(b)) {
+        beginWrite();
+        refresh(a);
+        refresh(b);
+        endWrite();
+      }
+    }
+  }
+
+  std::vector<std::unique_ptr<Frame> > frames_;
+  std::unordered_map<std::string, int> name_to_id_;
+
+  mutable std::mutex write_mutex_;
+  mutable std::atomic<std::uint64_t> sequence_{0};
+  // guarded by write_mutex_
+  mutable std::uint64_t last_stamp_ = 0;
+  mutable std::vector<int> path_;
+};
+}  // namespace Sophus
+
+#endif  // SOPHUS_FRAME_GRAPH_HPP
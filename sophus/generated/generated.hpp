@@ -0,0 +1,52 @@
+// This file is part of Sophus.
+//
+// Copyright 2016 Hauke Strasdat
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights  to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+// This file was generated by py/generate_kernels.py, do not edit.
+
+#ifndef SOPHUS_GENERATED_HPP
+#define SOPHUS_GENERATED_HPP
+
+#include <cmath>
+#include <type_traits>
+
+#include <Eigen/Core>
+
+#include "../sophus.hpp"
+
+namespace Sophus {
+namespace generated {
+
+/**
+ * \brief Threshold below which Taylor expansions are used
+ *
+ * The thresholds are chosen such that the first omitted term of the
+ * expansion is below the machine precision of Scalar. Types other than float
+ * (double, automatic differentiation types) use the double threshold.
+ */
+template <class Scalar>
+inline Scalar generatedThreshold(double for_double, double for_float) {
+  return Scalar(std::is_same<Scalar, float>::value ? for_float : for_double);
+}
+}  // namespace generated
+}  // namespace Sophus
+
+#endif  // SOPHUS_GENERATED_HPP
@@ -0,0 +1,297 @@
+// This file is part of Sophus.
+//
+// Copyright 2016 Hauke Strasdat
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights  to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+// This file was generated by py/generate_kernels.py, do not edit.
+
+#ifndef SOPHUS_GENERATED_SE2_KERNELS_HPP
+#define SOPHUS_GENERATED_SE2_KERNELS_HPP
+
+#include "generated.hpp"
+
+namespace Sophus {
+namespace generated {
+
+/**
+ * \brief Closed-form kernels of SE2
+ *
+ * Parameters are laid out as in SE2Group::data().
+ */
+template <class Scalar>
+struct SE2Kernels {
+  static const int DoF = 3;
+  static const int num_parameters = 4;
+  typedef Eigen::Matrix<Scalar, DoF, 1> Tangent;
+  typedef Eigen::Matrix<Scalar, num_parameters, 1> Parameters;
+  typedef Eigen::Matrix<Scalar, DoF, DoF> Adjoint;
+  typedef Eigen::Matrix<Scalar, num_parameters, DoF> ParameterJacobian;
+  typedef Eigen::Matrix<Scalar, DoF, num_parameters> LogJacobian;
+
+  /**
+   * Group exponential, returns parameters (see data()) of exp(a)
+   */
+  inline static Parameters exp(const Tangent& a) {
+    using std::abs;
+    using std::atan;
+    using std::atan2;
+    using std::cos;
+    using std::exp;
+    using std::log;
+    using std::sin;
+    using std::sqrt;
+    using std::tan;
+
+    const Scalar a0 = a[0];
+    const Scalar a1 = a[1];
+    const Scalar a2 = a[2];
+    const Scalar theta = a2;
+    Scalar sin_theta_by_theta, one_minus_cos_theta_by_theta;
+    if (abs(theta) < generatedThreshold<Scalar>(0.0903921, 0.5)) {
+      const Scalar b0 = (theta * theta);
+      sin_theta_by_theta = (Scalar(1.0 / 362880.0))*b0*(b0*(b0*(b0 + Scalar(-72)) + Scalar(3024)) + Scalar(-60480)) + Scalar(1);
+      one_minus_cos_theta_by_theta = (Scalar(1.0 / 40320.0))*theta*(-b0*(b0*(b0 + Scalar(-56)) + Scalar(1680)) + Scalar(20160));
+    } else {
+      const Scalar b0 = Scalar(1) / (theta);
+      sin_theta_by_theta = b0*sin(theta);
+      one_minus_cos_theta_by_theta = -b0*(cos(theta) + Scalar(-1));
+    }
+
+    Parameters res;
+    res[0] = cos(theta);
+    res[1] = sin(theta);
+    res[2] = a0*sin_theta_by_theta - a1*one_minus_cos_theta_by_theta;
+    res[3] = a0*one_minus_cos_theta_by_theta + a1*sin_theta_by_theta;
+    return res;
+  }
+
+  /**
+   * Group logarithm of parameters p
+   */
+  inline static Tangent log(const Parameters& p) {
+    using std::abs;
+    using std::atan;
+    using std::atan2;
+    using std::cos;
+    using std::exp;
+    using std::log;
+    using std::sin;
+    using std::sqrt;
+    using std::tan;
+
+    const Scalar p0 = p[0];
+    const Scalar p1 = p[1];
+    const Scalar p2 = p[2];
+    const Scalar p3 = p[3];
+    const Scalar theta = atan2(p1, p0);
+    Scalar halftheta_by_tan_of_halftheta;
+    if (abs(theta) < generatedThreshold<Scalar>(0.15947, 0.5)) {
+      const Scalar b0 = (theta * theta);
+      halftheta_by_tan_of_halftheta = -Scalar(1.0 / 1209600.0)*b0*(b0*(b0*(b0 + Scalar(40)) + Scalar(1680)) + Scalar(100800)) + Scalar(1);
+    } else {
+      const Scalar b0 = (Scalar(1.0 / 2.0))*theta;
+      halftheta_by_tan_of_halftheta = b0/tan(b0);
+    }
+
+    Tangent res;
+    const Scalar t0 = (Scalar(1.0 / 2.0))*theta;
+    res[0] = halftheta_by_tan_of_halftheta*p2 + p3*t0;
+    res[1] = halftheta_by_tan_of_halftheta*p3 - p2*t0;
+    res[2] = theta;
+    return res;
+  }
+
+  /**
+   * Adjoint transformation of parameters p
+   */
+  inline static Adjoint Adj(const Parameters& p) {
+    using std::abs;
+    using std::atan;
+    using std::atan2;
+    using std::cos;
+    using std::exp;
+    using std::log;
+    using std::sin;
+    using std::sqrt;
+    using std::tan;
+
+    const Scalar p0 = p[0];
+    const Scalar p1 = p[1];
+    const Scalar p2 = p[2];
+    const Scalar p3 = p[3];
+
+    Adjoint res;
+    res(0, 0) = p0;
+    res(0, 1) = -p1;
+    res(0, 2) = p3;
+    res(1, 0) = p1;
+    res(1, 1) = p0;
+    res(1, 2) = -p2;
+    res(2, 0) = Scalar(0);
+    res(2, 1) = Scalar(0);
+    res(2, 2) = Scalar(1);
+    return res;
+  }
+
+  /**
+   * Derivative of parameters of p * exp(x) with respect to x at x = 0
+   */
+  inline static ParameterJacobian internalJacobian(const Parameters& p) {
+    using std::abs;
+    using std::atan;
+    using std::atan2;
+    using std::cos;
+    using std::exp;
+    using std::log;
+    using std::sin;
+    using std::sqrt;
+    using std::tan;
+
+    const Scalar p0 = p[0];
+    const Scalar p1 = p[1];
+
+    ParameterJacobian res;
+    const Scalar t0 = -p1;
+    res(0, 0) = Scalar(0);
+    res(0, 1) = Scalar(0);
+    res(0, 2) = t0;
+    res(1, 0) = Scalar(0);
+    res(1, 1) = Scalar(0);
+    res(1, 2) = p0;
+    res(2, 0) = p0;
+    res(2, 1) = t0;
+    res(2, 2) = Scalar(0);
+    res(3, 0) = p1;
+    res(3, 1) = p0;
+    res(3, 2) = Scalar(0);
+    return res;
+  }
+
+  /**
+   * Derivative of parameters of exp(a) with respect to a
+   */
+  inline static ParameterJacobian Dx_exp(const Tangent& a) {
+    using std::abs;
+    using std::atan;
+    using std::atan2;
+    using std::cos;
+    using std::exp;
+    using std::log;
+    using std::sin;
+    using std::sqrt;
+    using std::tan;
+
+    const Scalar a0 = a[0];
+    const Scalar a1 = a[1];
+    const Scalar a2 = a[2];
+    const Scalar theta = a2;
+    Scalar sin_theta_by_theta, one_minus_cos_theta_by_theta, sin_theta_by_theta_dtheta, one_minus_cos_theta_by_theta_dtheta;
+    if (abs(theta) < generatedThreshold<Scalar>(0.0873301, 0.5)) {
+      const Scalar b0 = (theta * theta);
+      sin_theta_by_theta = (Scalar(1.0 / 362880.0))*b0*(b0*(b0*(b0 + Scalar(-72)) + Scalar(3024)) + Scalar(-60480)) + Scalar(1);
+      one_minus_cos_theta_by_theta = (Scalar(1.0 / 40320.0))*theta*(-b0*(b0*(b0 + Scalar(-56)) + Scalar(1680)) + Scalar(20160));
+      sin_theta_by_theta_dtheta = (Scalar(1.0 / 45360.0))*theta*(b0*(b0*(b0 + Scalar(-54)) + Scalar(1512)) + Scalar(-15120));
+      one_minus_cos_theta_by_theta_dtheta = (Scalar(1.0 / 403200.0))*b0*(b0*(b0*(b0 + Scalar(-70)) + Scalar(2800)) + Scalar(-50400)) + Scalar(1.0 / 2.0);
+    } else {
+      const Scalar b0 = sin(theta);
+      const Scalar b1 = Scalar(1) / (theta);
+      const Scalar b2 = b0*b1;
+      const Scalar b3 = cos(theta);
+      const Scalar b4 = b1*(b3 + Scalar(-1));
+      sin_theta_by_theta = b2;
+      one_minus_cos_theta_by_theta = -b4;
+      sin_theta_by_theta_dtheta = b1*(-b2 + b3);
+      one_minus_cos_theta_by_theta_dtheta = b1*(b0 + b4);
+    }
+
+    ParameterJacobian res;
+    res(0, 0) = Scalar(0);
+    res(0, 1) = Scalar(0);
+    res(0, 2) = -sin(theta);
+    res(1, 0) = Scalar(0);
+    res(1, 1) = Scalar(0);
+    res(1, 2) = cos(theta);
+    res(2, 0) = sin_theta_by_theta;
+    res(2, 1) = -one_minus_cos_theta_by_theta;
+    res(2, 2) = a0*sin_theta_by_theta_dtheta - a1*one_minus_cos_theta_by_theta_dtheta;
+    res(3, 0) = one_minus_cos_theta_by_theta;
+    res(3, 1) = sin_theta_by_theta;
+    res(3, 2) = a0*one_minus_cos_theta_by_theta_dtheta + a1*sin_theta_by_theta_dtheta;
+    return res;
+  }
+
+  /**
+   * Derivative of log(p) with respect to the parameters p
+   */
+  inline static LogJacobian Dx_log(const Parameters& p) {
+    using std::abs;
+    using std::atan;
+    using std::atan2;
+    using std::cos;
+    using std::exp;
+    using std::log;
+    using std::sin;
+    using std::sqrt;
+    using std::tan;
+
+    const Scalar p0 = p[0];
+    const Scalar p1 = p[1];
+    const Scalar p2 = p[2];
+    const Scalar p3 = p[3];
+    const Scalar theta = atan2(p1, p0);
+    Scalar halftheta_by_tan_of_halftheta, halftheta_by_tan_of_halftheta_dtheta;
+    if (abs(theta) < generatedThreshold<Scalar>(0.0825114, 0.5)) {
+      const Scalar b0 = (theta * theta);
+      halftheta_by_tan_of_halftheta = -Scalar(1.0 / 1209600.0)*b0*(b0*(b0*(b0 + Scalar(40)) + Scalar(1680)) + Scalar(100800)) + Scalar(1);
+      halftheta_by_tan_of_halftheta_dtheta = -Scalar(1.0 / 151200.0)*theta*(b0*(b0*(b0 + Scalar(30)) + Scalar(840)) + Scalar(25200));
+    } else {
+      const Scalar b0 = (Scalar(1.0 / 2.0))*theta;
+      const Scalar b1 = tan(b0);
+      const Scalar b2 = Scalar(1) / (b1);
+      halftheta_by_tan_of_halftheta = b0*b2;
+      halftheta_by_tan_of_halftheta_dtheta = (Scalar(1.0 / 4.0))*b2*(-b2*theta*((b1 * b1) + Scalar(1)) + Scalar(2));
+    }
+
+    LogJacobian res;
+    const Scalar t0 = halftheta_by_tan_of_halftheta_dtheta*p2 + (Scalar(1.0 / 2.0))*p3;
+    const Scalar t1 = Scalar(1) / (((p0 * p0) + (p1 * p1)));
+    const Scalar t2 = p1*t1;
+    const Scalar t3 = p0*t1;
+    const Scalar t4 = (Scalar(1.0 / 2.0))*theta;
+    const Scalar t5 = halftheta_by_tan_of_halftheta_dtheta*p3 - Scalar(1.0 / 2.0)*p2;
+    res(0, 0) = -t0*t2;
+    res(0, 1) = t0*t3;
+    res(0, 2) = halftheta_by_tan_of_halftheta;
+    res(0, 3) = t4;
+    res(1, 0) = -t2*t5;
+    res(1, 1) = t3*t5;
+    res(1, 2) = -t4;
+    res(1, 3) = halftheta_by_tan_of_halftheta;
+    res(2, 0) = -t2;
+    res(2, 1) = t3;
+    res(2, 2) = Scalar(0);
+    res(2, 3) = Scalar(0);
+    return res;
+  }
+};
+}  // namespace generated
+}  // namespace Sophus
+
+#endif  // SOPHUS_GENERATED_SE2_KERNELS_HPP
@@ -0,0 +1,653 @@
+// This file is part of Sophus.
+//
+// Copyright 2016 Hauke Strasdat
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights  to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+// This file was generated by py/generate_kernels.py, do not edit.
+
+#ifndef SOPHUS_GENERATED_SE3_KERNELS_HPP
+#define SOPHUS_GENERATED_SE3_KERNELS_HPP
+
+#include "generated.hpp"
+
+namespace Sophus {
+namespace generated {
+
+/**
+ * \brief Closed-form kernels of SE3
+ *
+ * Parameters are laid out as in SE3Group::data().
+ */
+template <class Scalar>
+struct SE3Kernels {
+  static const int DoF = 6;
+  static const int num_parameters = 7;
+  typedef Eigen::Matrix<Scalar, DoF, 1> Tangent;
+  typedef Eigen::Matrix<Scalar, num_parameters, 1> Parameters;
+  typedef Eigen::Matrix<Scalar, DoF, DoF> Adjoint;
+  typedef Eigen::Matrix<Scalar, num_parameters, DoF> ParameterJacobian;
+  typedef Eigen::Matrix<Scalar, DoF, num_parameters> LogJacobian;
+
+  /**
+   * Group exponential, returns parameters (see data()) of exp(a)
+   */
+  inline static Parameters exp(const Tangent& a) {
+    using std::abs;
+    using std::atan;
+    using std::atan2;
+    using std::cos;
+    using std::exp;
+    using std::log;
+    using std::sin;
+    using std::sqrt;
+    using std::tan;
+
+    const Scalar a0 = a[0];
+    const Scalar a1 = a[1];
+    const Scalar a2 = a[2];
+    const Scalar a3 = a[3];
+    const Scalar a4 = a[4];
+    const Scalar a5 = a[5];
+    Scalar imag_factor, real_factor, A, B;
+    const Scalar theta_sq = (a3 * a3) + (a4 * a4) + (a5 * a5);
+    if (theta_sq < generatedThreshold<Scalar>(0.0350873, 0.25)) {
+      imag_factor = (Scalar(1.0 / 185794560.0))*(theta_sq*(theta_sq*(theta_sq*(theta_sq + Scalar(-288)) + Scalar(48384)) + Scalar(-3870720)) + Scalar(92897280));
+      real_factor = (Scalar(1.0 / 10321920.0))*theta_sq*(theta_sq*(theta_sq*(theta_sq + Scalar(-224)) + Scalar(26880)) + Scalar(-1290240)) + Scalar(1);
+      A = (Scalar(1.0 / 3628800.0))*(theta_sq*(theta_sq*(theta_sq*(theta_sq + Scalar(-90)) + Scalar(5040)) + Scalar(-151200)) + Scalar(1814400));
+      B = (Scalar(1.0 / 39916800.0))*(theta_sq*(theta_sq*(theta_sq*(theta_sq + Scalar(-110)) + Scalar(7920)) + Scalar(-332640)) + Scalar(6652800));
+    } else {
+      const Scalar theta = sqrt(theta_sq);
+      const Scalar b0 = (Scalar(1.0 / 2.0))*theta;
+      imag_factor = sin(b0)/theta;
+      real_factor = cos(b0);
+      A = -(cos(theta) + Scalar(-1))/(theta * theta);
+      B = (theta - sin(theta))/(theta * theta * theta);
+    }
+
+    Parameters res;
+    const Scalar t0 = a1*a5 - a2*a4;
+    const Scalar t1 = a0*a4 - a1*a3;
+    const Scalar t2 = a0*a5 - a2*a3;
+    res[0] = a3*imag_factor;
+    res[1] = a4*imag_factor;
+    res[2] = a5*imag_factor;
+    res[3] = real_factor;
+    res[4] = -A*t0 - B*(a4*t1 + a5*t2) + a0;
+    res[5] = A*t2 - B*(-a3*t1 + a5*t0) + a1;
+    res[6] = -A*t1 + B*(a3*t2 + a4*t0) + a2;
+    return res;
+  }
+
+  /**
+   * Group logarithm of parameters p
+   */
+  inline static Tangent log(const Parameters& p) {
+    using std::abs;
+    using std::atan;
+    using std::atan2;
+    using std::cos;
+    using std::exp;
+    using std::log;
+    using std::sin;
+    using std::sqrt;
+    using std::tan;
+
+    const Scalar p0 = p[0];
+    const Scalar p1 = p[1];
+    const Scalar p2 = p[2];
+    const Scalar p3 = p[3];
+    const Scalar p4 = p[4];
+    const Scalar p5 = p[5];
+    const Scalar p6 = p[6];
+    Scalar k;
+    const Scalar n_sq = (p0 * p0) + (p1 * p1) + (p2 * p2);
+    if (n_sq < generatedThreshold<Scalar>(0.00119555, 0.0666102) * ((p3 * p3))) {
+      const Scalar b0 = n_sq/(p3 * p3);
+      k = Scalar(2)*((Scalar(1.0 / 315.0))*b0*(b0*(Scalar(5)*b0*(Scalar(7)*b0 + Scalar(-9)) + Scalar(63)) + Scalar(-105)) + Scalar(1))/p3;
+    } else {
+      const Scalar n = sqrt(n_sq);
+      if (abs(p3) < SophusConstants<Scalar>::epsilon()) {
+        if (p3 > Scalar(0)) {
+          k = SophusConstants<Scalar>::pi()/n;
+        } else {
+          k = -SophusConstants<Scalar>::pi()/n;
+        }
+      } else {
+        k = Scalar(2)*atan(n/p3)/n;
+      }
+    }
+    Scalar c;
+    const Scalar theta_sq = (k * k)*((p0 * p0) + (p1 * p1) + (p2 * p2));
+    if (theta_sq < generatedThreshold<Scalar>(0.0322742, 0.25)) {
+      c = (Scalar(1.0 / 239500800.0))*(theta_sq*(theta_sq*(theta_sq*(Scalar(5)*theta_sq + Scalar(198)) + Scalar(7920)) + Scalar(332640)) + Scalar(19958400));
+    } else {
+      const Scalar theta = sqrt(theta_sq);
+      const Scalar b0 = (Scalar(1.0 / 2.0))*theta;
+      c = -(b0/tan(b0) + Scalar(-1))/(theta * theta);
+    }
+
+    Tangent res;
+    const Scalar t0 = p1*p6;
+    const Scalar t1 = (Scalar(1.0 / 2.0))*k;
+    const Scalar t2 = p2*p5;
+    const Scalar t3 = p0*p5;
+    const Scalar t4 = -p1*p4 + t3;
+    const Scalar t5 = p2*p4;
+    const Scalar t6 = p0*p6 - t5;
+    const Scalar t7 = c*(k * k);
+    const Scalar t8 = t0 - t2;
+    res[0] = p4 - t0*t1 + t1*t2 + t7*(p1*t4 + p2*t6);
+    res[1] = (Scalar(1.0 / 2.0))*k*p0*p6 + p5 - t1*t5 - t7*(p0*t4 - p2*t8);
+    res[2] = (Scalar(1.0 / 2.0))*k*p1*p4 + p6 - t1*t3 - t7*(p0*t6 + p1*t8);
+    res[3] = k*p0;
+    res[4] = k*p1;
+    res[5] = k*p2;
+    return res;
+  }
+
+  /**
+   * Adjoint transformation of parameters p
+   */
+  inline static Adjoint Adj(const Parameters& p) {
+    using std::abs;
+    using std::atan;
+    using std::atan2;
+    using std::cos;
+    using std::exp;
+    using std::log;
+    using std::sin;
+    using std::sqrt;
+    using std::tan;
+
+    const Scalar p0 = p[0];
+    const Scalar p1 = p[1];
+    const Scalar p2 = p[2];
+    const Scalar p3 = p[3];
+    const Scalar p4 = p[4];
+    const Scalar p5 = p[5];
+    const Scalar p6 = p[6];
+
+    Adjoint res;
+    const Scalar t0 = (p3 * p3);
+    const Scalar t1 = (p2 * p2);
+    const Scalar t2 = -t1;
+    const Scalar t3 = (p0 * p0);
+    const Scalar t4 = (p1 * p1);
+    const Scalar t5 = t3 - t4;
+    const Scalar t6 = t0 + t2 + t5;
+    const Scalar t7 = p0*p1;
+    const Scalar t8 = p2*p3;
+    const Scalar t9 = t7 - t8;
+    const Scalar t10 = Scalar(2)*t9;
+    const Scalar t11 = p0*p2;
+    const Scalar t12 = p1*p3;
+    const Scalar t13 = t11 + t12;
+    const Scalar t14 = Scalar(2)*t13;
+    const Scalar t15 = t11 - t12;
+    const Scalar t16 = t7 + t8;
+    const Scalar t17 = p0*p3;
+    const Scalar t18 = p1*p2;
+    const Scalar t19 = t17 + t18;
+    const Scalar t20 = Scalar(2)*p5;
+    const Scalar t21 = -t0;
+    const Scalar t22 = t1 + t21 + t5;
+    const Scalar t23 = t17 - t18;
+    const Scalar t24 = t2 + t21 + t3 + t4;
+    const Scalar t25 = Scalar(2)*t16;
+    const Scalar t26 = -t22;
+    const Scalar t27 = -Scalar(2)*t23;
+    const Scalar t28 = Scalar(2)*p4;
+    const Scalar t29 = Scalar(2)*t15;
+    const Scalar t30 = Scalar(2)*t19;
+    const Scalar t31 = -t24;
+    res(0, 0) = t6;
+    res(0, 1) = t10;
+    res(0, 2) = t14;
+    res(0, 3) = Scalar(2)*p5*t15 - Scalar(2)*p6*t16;
+    res(0, 4) = p6*t22 + t19*t20;
+    res(0, 5) = -p5*t24 + Scalar(2)*p6*t23;
+    res(1, 0) = t25;
+    res(1, 1) = t26;
+    res(1, 2) = t27;
+    res(1, 3) = p6*t6 - t15*t28;
+    res(1, 4) = -Scalar(2)*p4*t19 + Scalar(2)*p6*t9;
+    res(1, 5) = p4*t24 + Scalar(2)*p6*t13;
+    res(2, 0) = t29;
+    res(2, 1) = t30;
+    res(2, 2) = t31;
+    res(2, 3) = -p5*t6 + t16*t28;
+    res(2, 4) = -p4*t22 - t20*t9;
+    res(2, 5) = -Scalar(2)*p4*t23 - Scalar(2)*p5*t13;
+    res(3, 0) = Scalar(0);
+    res(3, 1) = Scalar(0);
+    res(3, 2) = Scalar(0);
+    res(3, 3) = t6;
+    res(3, 4) = t10;
+    res(3, 5) = t14;
+    res(4, 0) = Scalar(0);
+    res(4, 1) = Scalar(0);
+    res(4, 2) = Scalar(0);
+    res(4, 3) = t25;
+    res(4, 4) = t26;
+    res(4, 5) = t27;
+    res(5, 0) = Scalar(0);
+    res(5, 1) = Scalar(0);
+    res(5, 2) = Scalar(0);
+    res(5, 3) = t29;
+    res(5, 4) = t30;
+    res(5, 5) = t31;
+    return res;
+  }
+
+  /**
+   * Derivative of parameters of p * exp(x) with respect to x at x = 0
+   */
+  inline static ParameterJacobian internalJacobian(const Parameters& p) {
+    using std::abs;
+    using std::atan;
+    using std::atan2;
+    using std::cos;
+    using std::exp;
+    using std::log;
+    using std::sin;
+    using std::sqrt;
+    using std::tan;
+
+    const Scalar p0 = p[0];
+    const Scalar p1 = p[1];
+    const Scalar p2 = p[2];
+    const Scalar p3 = p[3];
+
+    ParameterJacobian res;
+    const Scalar t0 = (Scalar(1.0 / 2.0))*p3;
+    const Scalar t1 = (Scalar(1.0 / 2.0))*p2;
+    const Scalar t2 = -t1;
+    const Scalar t3 = (Scalar(1.0 / 2.0))*p1;
+    const Scalar t4 = (Scalar(1.0 / 2.0))*p0;
+    const Scalar t5 = -t4;
+    const Scalar t6 = -t3;
+    const Scalar t7 = (p3 * p3);
+    const Scalar t8 = (p2 * p2);
+    const Scalar t9 = -t8;
+    const Scalar t10 = (p0 * p0);
+    const Scalar t11 = (p1 * p1);
+    const Scalar t12 = t10 - t11;
+    const Scalar t13 = p0*p1;
+    const Scalar t14 = p2*p3;
+    const Scalar t15 = p0*p2;
+    const Scalar t16 = p1*p3;
+    const Scalar t17 = -t7;
+    const Scalar t18 = p0*p3;
+    res(0, 0) = Scalar(0);
+    res(0, 1) = Scalar(0);
+    res(0, 2) = Scalar(0);
+    res(0, 3) = t0;
+    res(0, 4) = t2;
+    res(0, 5) = t3;
+    res(1, 0) = Scalar(0);
+    res(1, 1) = Scalar(0);
+    res(1, 2) = Scalar(0);
+    res(1, 3) = t1;
+    res(1, 4) = t0;
+    res(1, 5) = t5;
+    res(2, 0) = Scalar(0);
+    res(2, 1) = Scalar(0);
+    res(2, 2) = Scalar(0);
+    res(2, 3) = t6;
+    res(2, 4) = t4;
+    res(2, 5) = t0;
+    res(3, 0) = Scalar(0);
+    res(3, 1) = Scalar(0);
+    res(3, 2) = Scalar(0);
+    res(3, 3) = t5;
+    res(3, 4) = t6;
+    res(3, 5) = t2;
+    res(4, 0) = t12 + t7 + t9;
+    res(4, 1) = Scalar(2)*t13 - Scalar(2)*t14;
+    res(4, 2) = Scalar(2)*t15 + Scalar(2)*t16;
+    res(4, 3) = Scalar(0);
+    res(4, 4) = Scalar(0);
+    res(4, 5) = Scalar(0);
+    res(5, 0) = Scalar(2)*t13 + Scalar(2)*t14;
+    res(5, 1) = -t12 - t17 - t8;
+    res(5, 2) = Scalar(2)*p1*p2 - Scalar(2)*t18;
+    res(5, 3) = Scalar(0);
+    res(5, 4) = Scalar(0);
+    res(5, 5) = Scalar(0);
+    res(6, 0) = Scalar(2)*t15 - Scalar(2)*t16;
+    res(6, 1) = Scalar(2)*p1*p2 + Scalar(2)*t18;
+    res(6, 2) = -t10 - t11 - t17 - t9;
+    res(6, 3) = Scalar(0);
+    res(6, 4) = Scalar(0);
+    res(6, 5) = Scalar(0);
+    return res;
+  }
+
+  /**
+   * Derivative of parameters of exp(a) with respect to a
+   */
+  inline static ParameterJacobian Dx_exp(const Tangent& a) {
+    using std::abs;
+    using std::atan;
+    using std::atan2;
+    using std::cos;
+    using std::exp;
+    using std::log;
+    using std::sin;
+    using std::sqrt;
+    using std::tan;
+
+    const Scalar a0 = a[0];
+    const Scalar a1 = a[1];
+    const Scalar a2 = a[2];
+    const Scalar a3 = a[3];
+    const Scalar a4 = a[4];
+    const Scalar a5 = a[5];
+    Scalar imag_factor, A, B, imag_factor_dtheta, real_factor_dtheta, A_dtheta, B_dtheta;
+    const Scalar theta_sq = (a3 * a3) + (a4 * a4) + (a5 * a5);
+    if (theta_sq < generatedThreshold<Scalar>(0.0350873, 0.25)) {
+      const Scalar b0 = theta_sq*(theta_sq*(theta_sq + Scalar(-288)) + Scalar(48384)) + Scalar(-3870720);
+      const Scalar b1 = Scalar(5)*theta_sq;
+      imag_factor = (Scalar(1.0 / 185794560.0))*b0*theta_sq + Scalar(1.0 / 2.0);
+      A = (Scalar(1.0 / 3628800.0))*(theta_sq*(theta_sq*(theta_sq*(theta_sq + Scalar(-90)) + Scalar(5040)) + Scalar(-151200)) + Scalar(1814400));
+      B = (Scalar(1.0 / 39916800.0))*(theta_sq*(theta_sq*(theta_sq*(theta_sq + Scalar(-110)) + Scalar(7920)) + Scalar(-332640)) + Scalar(6652800));
+      imag_factor_dtheta = (Scalar(1.0 / 8174960640.0))*(theta_sq*(-theta_sq*(theta_sq*(theta_sq + Scalar(-352)) + Scalar(76032)) + Scalar(8515584)) + Scalar(-340623360));
+      real_factor_dtheta = -Scalar(1.0 / 371589120.0)*b0*theta_sq + Scalar(-1.0 / 4.0);
+      A_dtheta = (Scalar(1.0 / 239500800.0))*theta_sq*(-theta_sq*(theta_sq*(b1 + Scalar(-528)) + Scalar(35640)) + Scalar(1330560)) + Scalar(-1.0 / 12.0);
+      B_dtheta = (Scalar(1.0 / 3113510400.0))*theta_sq*(-theta_sq*(theta_sq*(b1 + Scalar(-624)) + Scalar(51480)) + Scalar(2471040)) + Scalar(-1.0 / 60.0);
+    } else {
+      const Scalar theta = sqrt(theta_sq);
+      const Scalar b0 = Scalar(1) / (theta);
+      const Scalar b1 = (Scalar(1.0 / 2.0))*theta;
+      const Scalar b2 = b0*sin(b1);
+      const Scalar b3 = Scalar(1) / (theta * theta);
+      const Scalar b4 = cos(theta) + Scalar(-1);
+      const Scalar b5 = Scalar(1) / (theta * theta * theta);
+      const Scalar b6 = sin(theta);
+      const Scalar b7 = -b6 + theta;
+      imag_factor = b2;
+      A = -b3*b4;
+      B = b5*b7;
+      imag_factor_dtheta = b3*(-b2 + (Scalar(1.0 / 2.0))*cos(b1));
+      real_factor_dtheta = -Scalar(1.0 / 2.0)*b2;
+      A_dtheta = b5*(Scalar(2)*b0*b4 + b6);
+      B_dtheta = -(Scalar(3)*b0*b7 + b4)/(theta * theta * theta * theta);
+    }
+
+    ParameterJacobian res;
+    const Scalar t0 = (a3 * a3);
+    const Scalar t1 = a3*imag_factor_dtheta;
+    const Scalar t2 = a4*t1;
+    const Scalar t3 = a5*t1;
+    const Scalar t4 = (a4 * a4);
+    const Scalar t5 = a4*a5;
+    const Scalar t6 = imag_factor_dtheta*t5;
+    const Scalar t7 = (a5 * a5);
+    const Scalar t8 = A*a5;
+    const Scalar t9 = A*a4;
+    const Scalar t10 = B*a3;
+    const Scalar t11 = a1*a4;
+    const Scalar t12 = a2*a5;
+    const Scalar t13 = a1*a5;
+    const Scalar t14 = a2*a4;
+    const Scalar t15 = -t14;
+    const Scalar t16 = t13 + t15;
+    const Scalar t17 = a0*a4;
+    const Scalar t18 = a1*a3;
+    const Scalar t19 = -t18;
+    const Scalar t20 = t17 + t19;
+    const Scalar t21 = a4*t20;
+    const Scalar t22 = a0*a5;
+    const Scalar t23 = a2*a3;
+    const Scalar t24 = -t23;
+    const Scalar t25 = t22 + t24;
+    const Scalar t26 = a5*t25;
+    const Scalar t27 = B_dtheta*(t21 + t26);
+    const Scalar t28 = A*a2;
+    const Scalar t29 = a4*t16;
+    const Scalar t30 = A*a1;
+    const Scalar t31 = A*a3;
+    const Scalar t32 = B_dtheta*a3;
+    const Scalar t33 = a0*a3;
+    const Scalar t34 = a3*t20;
+    const Scalar t35 = B_dtheta*(a5*t16 - t34);
+    const Scalar t36 = A*a0;
+    const Scalar t37 = a3*t25 + t29;
+    res(0, 0) = Scalar(0);
+    res(0, 1) = Scalar(0);
+    res(0, 2) = Scalar(0);
+    res(0, 3) = imag_factor + imag_factor_dtheta*t0;
+    res(0, 4) = t2;
+    res(0, 5) = t3;
+    res(1, 0) = Scalar(0);
+    res(1, 1) = Scalar(0);
+    res(1, 2) = Scalar(0);
+    res(1, 3) = t2;
+    res(1, 4) = imag_factor + imag_factor_dtheta*t4;
+    res(1, 5) = t6;
+    res(2, 0) = Scalar(0);
+    res(2, 1) = Scalar(0);
+    res(2, 2) = Scalar(0);
+    res(2, 3) = t3;
+    res(2, 4) = t6;
+    res(2, 5) = imag_factor + imag_factor_dtheta*t7;
+    res(3, 0) = Scalar(0);
+    res(3, 1) = Scalar(0);
+    res(3, 2) = Scalar(0);
+    res(3, 3) = a3*real_factor_dtheta;
+    res(3, 4) = a4*real_factor_dtheta;
+    res(3, 5) = a5*real_factor_dtheta;
+    res(4, 0) = -B*(t4 + t7) + Scalar(1);
+    res(4, 1) = B*a3*a4 - t8;
+    res(4, 2) = a5*t10 + t9;
+    res(4, 3) = -A_dtheta*a3*t16 + B*(t11 + t12) - a3*t27;
+    res(4, 4) = -A_dtheta*t29 - B*(Scalar(2)*t17 + t19) - a4*t27 + t28;
+    res(4, 5) = -A_dtheta*a5*t16 - B*(Scalar(2)*t22 + t24) - a5*t27 - t30;
+    res(5, 0) = a4*t10 + t8;
+    res(5, 1) = -B*(t0 + t7) + Scalar(1);
+    res(5, 2) = B*a4*a5 - t31;
+    res(5, 3) = A_dtheta*a3*t25 + B*(t17 - Scalar(2)*t18) - t28 - t32*(-a3*t20 + a5*t16);
+    res(5, 4) = A_dtheta*a4*t25 + B*(t12 + t33) - a4*t35;
+    res(5, 5) = A_dtheta*t26 - B*(Scalar(2)*t13 + t15) - a5*t35 + t36;
+    res(6, 0) = B*a3*a5 - t9;
+    res(6, 1) = B*t5 + t31;
+    res(6, 2) = -B*(t0 + t4) + Scalar(1);
+    res(6, 3) = -A_dtheta*t34 + B*(t22 - Scalar(2)*t23) + t30 + t32*t37;
+    res(6, 4) = -A_dtheta*t21 + B*(t13 - Scalar(2)*t14) + B_dtheta*a4*t37 - t36;
+    res(6, 5) = -A_dtheta*a5*t20 + B*(t11 + t33) + B_dtheta*a5*t37;
+    return res;
+  }
+
+  /**
+   * Derivative of log(p) with respect to the parameters p
+   */
+  inline static LogJacobian Dx_log(const Parameters& p) {
+    using std::abs;
+    using std::atan;
+    using std::atan2;
+    using std::cos;
+    using std::exp;
+    using std::log;
+    using std::sin;
+    using std::sqrt;
+    using std::tan;
+
+    const Scalar p0 = p[0];
+    const Scalar p1 = p[1];
+    const Scalar p2 = p[2];
+    const Scalar p3 = p[3];
+    const Scalar p4 = p[4];
+    const Scalar p5 = p[5];
+    const Scalar p6 = p[6];
+    Scalar k, k_dn, k_dp3;
+    const Scalar n_sq = (p0 * p0) + (p1 * p1) + (p2 * p2);
+    if (n_sq < generatedThreshold<Scalar>(0.000693461, 0.0386364) * ((p3 * p3))) {
+      const Scalar b0 = Scalar(1) / (p3 * p3);
+      const Scalar b1 = b0*n_sq;
+      const Scalar b2 = Scalar(7)*b1;
+      const Scalar b3 = Scalar(5)*b1;
+      k = Scalar(2)*((Scalar(1.0 / 315.0))*b1*(b1*(b3*(b2 + Scalar(-9)) + Scalar(63)) + Scalar(-105)) + Scalar(1))/p3;
+      k_dn = (Scalar(4.0 / 3465.0))*(b1*(-b3*(b2*(Scalar(45)*b1 + Scalar(-44)) + Scalar(297)) + Scalar(1386)) + Scalar(-1155))/(p3 * p3 * p3);
+      k_dp3 = Scalar(2)*b0*(b1*(-b1*(b1*(b1 + Scalar(-1)) + Scalar(1)) + Scalar(1)) + Scalar(-1));
+    } else {
+      const Scalar n = sqrt(n_sq);
+      if (abs(p3) < SophusConstants<Scalar>::epsilon()) {
+        if (p3 > Scalar(0)) {
+          k = SophusConstants<Scalar>::pi()/n;
+          k_dn = -SophusConstants<Scalar>::pi()/(n * n * n);
+          k_dp3 = -Scalar(2)/(n * n);
+        } else {
+          k = -SophusConstants<Scalar>::pi()/n;
+          k_dn = SophusConstants<Scalar>::pi()/(n * n * n);
+          k_dp3 = -Scalar(2)/(n * n);
+        }
+      } else {
+        const Scalar b0 = Scalar(1) / (p3);
+        const Scalar b1 = atan(b0*n)/n;
+        const Scalar b2 = (n * n);
+        const Scalar b3 = Scalar(1) / (p3 * p3);
+        const Scalar b4 = Scalar(1) / ((b2*b3 + Scalar(1)));
+        k = Scalar(2)*b1;
+        k_dn = Scalar(2)*(b0*b4 - b1)/b2;
+        k_dp3 = -Scalar(2)*b3*b4;
+      }
+    }
+    Scalar c, c_dtheta;
+    const Scalar theta_sq = (k * k)*((p0 * p0) + (p1 * p1) + (p2 * p2));
+    if (theta_sq < generatedThreshold<Scalar>(0.0207436, 0.25)) {
+      c = (Scalar(1.0 / 239500800.0))*(theta_sq*(theta_sq*(theta_sq*(Scalar(5)*theta_sq + Scalar(198)) + Scalar(7920)) + Scalar(332640)) + Scalar(19958400));
+      c_dtheta = (Scalar(1.0 / 130767436800.0))*(theta_sq*(theta_sq*(theta_sq*(Scalar(691)*theta_sq + Scalar(21840)) + Scalar(648648)) + Scalar(17297280)) + Scalar(363242880));
+    } else {
+      const Scalar theta = sqrt(theta_sq);
+      const Scalar b0 = (Scalar(1.0 / 2.0))*theta;
+      const Scalar b1 = tan(b0);
+      const Scalar b2 = Scalar(1) / (b1);
+      const Scalar b3 = b2*theta;
+      c = -(b0*b2 + Scalar(-1))/(theta * theta);
+      c_dtheta = -((Scalar(1.0 / 4.0))*b2*(-b3*((b1 * b1) + Scalar(1)) + Scalar(2)) - (b3 + Scalar(-2))/theta)/(theta * theta * theta);
+    }
+
+    LogJacobian res;
+    const Scalar t0 = p1*p5;
+    const Scalar t1 = p2*p6;
+    const Scalar t2 = (k * k);
+    const Scalar t3 = c*t2;
+    const Scalar t4 = (Scalar(1.0 / 2.0))*p0;
+    const Scalar t5 = p2*p5;
+    const Scalar t6 = p1*p6;
+    const Scalar t7 = p0*p5;
+    const Scalar t8 = -p1*p4;
+    const Scalar t9 = t7 + t8;
+    const Scalar t10 = p0*p6;
+    const Scalar t11 = p2*p4;
+    const Scalar t12 = -t11;
+    const Scalar t13 = t10 + t12;
+    const Scalar t14 = p1*t9 + p2*t13;
+    const Scalar t15 = c*k;
+    const Scalar t16 = t14*t15;
+    const Scalar t17 = Scalar(4)*t16 + t5 - t6;
+    const Scalar t18 = k_dn*t17;
+    const Scalar t19 = (p0 * p0);
+    const Scalar t20 = (p1 * p1);
+    const Scalar t21 = (p2 * p2);
+    const Scalar t22 = t20 + t21;
+    const Scalar t23 = t19 + t22;
+    const Scalar t24 = k + k_dn*t23;
+    const Scalar t25 = (k * k * k);
+    const Scalar t26 = c_dtheta*t25;
+    const Scalar t27 = t24*t26;
+    const Scalar t28 = t14*t27;
+    const Scalar t29 = (Scalar(1.0 / 2.0))*k;
+    const Scalar t30 = p6*t29;
+    const Scalar t31 = p5*t29;
+    const Scalar t32 = (Scalar(1.0 / 2.0))*p2;
+    const Scalar t33 = t23*t26;
+    const Scalar t34 = p0*t15;
+    const Scalar t35 = p1*t34;
+    const Scalar t36 = (Scalar(1.0 / 2.0))*p1;
+    const Scalar t37 = p2*t34;
+    const Scalar t38 = -t5;
+    const Scalar t39 = t38 + t6;
+    const Scalar t40 = p0*t9 - p2*t39;
+    const Scalar t41 = t15*t40;
+    const Scalar t42 = -t10 + t11 + Scalar(4)*t41;
+    const Scalar t43 = -t42;
+    const Scalar t44 = t27*t40;
+    const Scalar t45 = p0*p4;
+    const Scalar t46 = p4*t29;
+    const Scalar t47 = p1*p2;
+    const Scalar t48 = t15*t47;
+    const Scalar t49 = p0*t13 + p1*t39;
+    const Scalar t50 = t15*t49;
+    const Scalar t51 = -Scalar(4)*t50 - t9;
+    const Scalar t52 = t27*t49;
+    const Scalar t53 = k_dn*p0;
+    const Scalar t54 = p1*t53;
+    const Scalar t55 = p2*t53;
+    const Scalar t56 = k_dn*t47;
+    res(0, 0) = p0*t28 + t18*t4 + t3*(t0 + t1);
+    res(0, 1) = c_dtheta*p1*t14*t24*t25 + (Scalar(1.0 / 2.0))*k_dn*p1*t17 - t3*(Scalar(2)*p1*p4 - t7) - t30;
+    res(0, 2) = p2*t28 + t18*t32 - t3*(Scalar(2)*p2*p4 - t10) + t31;
+    res(0, 3) = k_dp3*(t14*t33 + Scalar(2)*t16 + (Scalar(1.0 / 2.0))*t5 - Scalar(1.0 / 2.0)*t6);
+    res(0, 4) = -t22*t3 + Scalar(1);
+    res(0, 5) = k*(t32 + t35);
+    res(0, 6) = k*(-t36 + t37);
+    res(1, 0) = (Scalar(1.0 / 2.0))*k_dn*p0*t43 - p0*t44 - t3*(Scalar(2)*t7 + t8) + t30;
+    res(1, 1) = c*t2*(t1 + t45) - k_dn*t36*t42 - p1*t44;
+    res(1, 2) = (Scalar(1.0 / 2.0))*k_dn*p2*t43 - p2*t44 - t3*(Scalar(2)*p2*p5 - t6) - t46;
+    res(1, 3) = k_dp3*((Scalar(1.0 / 2.0))*p0*p6 - Scalar(1.0 / 2.0)*t11 - t33*t40 - Scalar(2)*t41);
+    res(1, 4) = k*(-t32 + t35);
+    res(1, 5) = -t3*(t19 + t21) + Scalar(1);
+    res(1, 6) = k*(t4 + t48);
+    res(2, 0) = (Scalar(1.0 / 2.0))*k_dn*p0*t51 - p0*t52 - t3*(Scalar(2)*t10 + t12) - t31;
+    res(2, 1) = (Scalar(1.0 / 2.0))*k_dn*p1*t51 - p1*t52 - t3*(t38 + Scalar(2)*t6) + t46;
+    res(2, 2) = k_dn*t32*t51 - p2*t52 + t3*(t0 + t45);
+    res(2, 3) = k_dp3*((Scalar(1.0 / 2.0))*p1*p4 - t33*t49 - Scalar(2)*t50 - Scalar(1.0 / 2.0)*t7);
+    res(2, 4) = k*(t36 + t37);
+    res(2, 5) = k*(-t4 + t48);
+    res(2, 6) = -t3*(t19 + t20) + Scalar(1);
+    res(3, 0) = k + k_dn*t19;
+    res(3, 1) = t54;
+    res(3, 2) = t55;
+    res(3, 3) = k_dp3*p0;
+    res(3, 4) = Scalar(0);
+    res(3, 5) = Scalar(0);
+    res(3, 6) = Scalar(0);
+    res(4, 0) = t54;
+    res(4, 1) = k + k_dn*t20;
+    res(4, 2) = t56;
+    res(4, 3) = k_dp3*p1;
+    res(4, 4) = Scalar(0);
+    res(4, 5) = Scalar(0);
+    res(4, 6) = Scalar(0);
+    res(5, 0) = t55;
+    res(5, 1) = t56;
+    res(5, 2) = k + k_dn*t21;
+    res(5, 3) = k_dp3*p2;
+    res(5, 4) = Scalar(0);
+    res(5, 5) = Scalar(0);
+    res(5, 6) = Scalar(0);
+    return res;
+  }
+};
+}  // namespace generated
+}  // namespace Sophus
+
+#endif  // SOPHUS_GENERATED_SE3_KERNELS_HPP
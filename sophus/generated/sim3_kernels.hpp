@@ -0,0 +1,1258 @@
+// This file is part of Sophus.
+//
+// Copyright 2016 Hauke Strasdat
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights  to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+// This file was generated by py/generate_kernels.py, do not edit.
+
+#ifndef SOPHUS_GENERATED_SIM3_KERNELS_HPP
+#define SOPHUS_GENERATED_SIM3_KERNELS_HPP
+
+#include "generated.hpp"
+
+namespace Sophus {
+namespace generated {
+
+/**
+ * \brief Closed-form kernels of Sim3
+ *
+ * Parameters are laid out as in Sim3Group::data().
+ */
+template <class Scalar>
+struct Sim3Kernels {
+  static const int DoF = 7;
+  static const int num_parameters = 7;
+  typedef Eigen::Matrix<Scalar, DoF, 1> Tangent;
+  typedef Eigen::Matrix<Scalar, num_parameters, 1> Parameters;
+  typedef Eigen::Matrix<Scalar, DoF, DoF> Adjoint;
+  typedef Eigen::Matrix<Scalar, num_parameters, DoF> ParameterJacobian;
+  typedef Eigen::Matrix<Scalar, DoF, num_parameters> LogJacobian;
+
+  /**
+   * Group exponential, returns parameters (see data()) of exp(a)
+   */
+  inline static Parameters exp(const Tangent& a) {
+    using std::abs;
+    using std::atan;
+    using std::atan2;
+    using std::cos;
+    using std::exp;
+    using std::log;
+    using std::sin;
+    using std::sqrt;
+    using std::tan;
+
+    const Scalar a0 = a[0];
+    const Scalar a1 = a[1];
+    const Scalar a2 = a[2];
+    const Scalar a3 = a[3];
+    const Scalar a4 = a[4];
+    const Scalar a5 = a[5];
+    const Scalar a6 = a[6];
+    const Scalar sigma = a6;
+    const Scalar sqrt_scale = exp((Scalar(1.0 / 2.0))*sigma);
+    Scalar imag_factor, real_factor, A, B, C;
+    const Scalar theta_sq = (a3 * a3) + (a4 * a4) + (a5 * a5);
+    if (theta_sq < generatedThreshold<Scalar>(0.0350873, 0.25)) {
+      if (abs(sigma) < generatedThreshold<Scalar>(0.0881785, 0.5)) {
+        const Scalar b0 = Scalar(5)*theta_sq;
+        const Scalar b1 = Scalar(11)*theta_sq;
+        const Scalar b2 = Scalar(13)*theta_sq;
+        const Scalar b3 = Scalar(7)*theta_sq;
+        imag_factor = (Scalar(1.0 / 185794560.0))*(theta_sq*(theta_sq*(theta_sq*(theta_sq + Scalar(-288)) + Scalar(48384)) + Scalar(-3870720)) + Scalar(92897280));
+        real_factor = (Scalar(1.0 / 10321920.0))*theta_sq*(theta_sq*(theta_sq*(theta_sq + Scalar(-224)) + Scalar(26880)) + Scalar(-1290240)) + Scalar(1);
+        A = (Scalar(1.0 / 3201186852864000.0))*sigma*(sigma*(sigma*(sigma*(sigma*(sigma*(sigma*(Scalar(12155)*sigma*(theta_sq*(theta_sq*(theta_sq*(theta_sq + Scalar(-81)) + Scalar(3888)) + Scalar(-90720)) + Scalar(653184)) + Scalar(144)*theta_sq*(b1*(b2*(b0 + Scalar(-408)) + Scalar(257040)) + Scalar(-66830400)) + Scalar(70572902400)) + Scalar(109395)*theta_sq*(theta_sq*(theta_sq*(b3 + Scalar(-576)) + Scalar(28224)) + Scalar(-677376)) + Scalar(555761606400)) + Scalar(34272)*theta_sq*(theta_sq*(b1*(b2 + Scalar(-1080)) + Scalar(589680)) + Scalar(-14414400)) + Scalar(3810936729600)) + Scalar(5250960)*theta_sq*(theta_sq*(b0*(theta_sq + Scalar(-84)) + Scalar(21168)) + Scalar(-529200)) + Scalar(22230464256000)) + Scalar(10281600)*theta_sq*(theta_sq*(theta_sq*(b1 + Scalar(-936)) + Scalar(48048)) + Scalar(-1235520)) + Scalar(106706228428800)) + Scalar(73513440)*theta_sq*(theta_sq*(theta_sq*(b0 + Scalar(-432)) + Scalar(22680)) + Scalar(-604800)) + Scalar(400148356608000)) + Scalar(801964800)*theta_sq*(theta_sq*(theta_sq*(theta_sq + Scalar(-88)) + Scalar(4752)) + Scalar(-133056)) + Scalar(1067062284288000)) + (Scalar(1.0 / 3628800.0))*theta_sq*(theta_sq*(theta_sq*(theta_sq + Scalar(-90)) + Scalar(5040)) + Scalar(-151200)) + Scalar(1.0 / 2.0);
+        B = (Scalar(1.0 / 60822550204416000.0))*sigma*(sigma*(sigma*(sigma*(sigma*(sigma*(sigma*(Scalar(9)*sigma*(b1*(b2*(theta_sq*(Scalar(17)*theta_sq + Scalar(-1710)) + Scalar(108528)) + Scalar(-48837600)) + Scalar(7618665600)) + Scalar(46189)*theta_sq*(theta_sq*(theta_sq*(Scalar(4)*theta_sq + Scalar(-405)) + Scalar(25920)) + Scalar(-907200)) + Scalar(603398315520)) + Scalar(9576)*theta_sq*(b1*(b2*(theta_sq + Scalar(-102)) + Scalar(85680)) + Scalar(-33415200)) + Scalar(4693098009600)) + Scalar(1247103)*theta_sq*(theta_sq*(theta_sq*(b3 + Scalar(-720)) + Scalar(47040)) + Scalar(-1693440)) + Scalar(31678411564800)) + Scalar(325584)*theta_sq*(theta_sq*(b1*(b2 + Scalar(-1350)) + Scalar(982800)) + Scalar(-36036000)) + Scalar(181019494656000)) + Scalar(199536480)*theta_sq*(theta_sq*(theta_sq*(theta_sq + Scalar(-105)) + Scalar(7056)) + Scalar(-264600)) + Scalar(844757641728000)) + Scalar(58605120)*theta_sq*(theta_sq*(theta_sq*(b1 + Scalar(-1170)) + Scalar(80080)) + Scalar(-3088800)) + Scalar(3041127510220800)) + Scalar(1396755360)*theta_sq*(theta_sq*(theta_sq*(theta_sq + Scalar(-108)) + Scalar(7560)) + Scalar(-302400)) + Scalar(7602818775552000)) + (Scalar(1.0 / 39916800.0))*theta_sq*(theta_sq*(theta_sq*(theta_sq + Scalar(-110)) + Scalar(7920)) + Scalar(-332640)) + Scalar(1.0 / 6.0);
+        C = (Scalar(1.0 / 362880.0))*sigma*(sigma*(sigma*(sigma*(sigma*(sigma*(sigma*(sigma + Scalar(9)) + Scalar(72)) + Scalar(504)) + Scalar(3024)) + Scalar(15120)) + Scalar(60480)) + Scalar(181440)) + Scalar(1);
+      } else {
+        const Scalar b0 = Scalar(1) / (sigma);
+        const Scalar b1 = (sqrt_scale * sqrt_scale);
+        const Scalar b2 = b1 + Scalar(-1);
+        const Scalar b3 = b0*b2;
+        const Scalar b4 = b1 - b3;
+        const Scalar b5 = b0*b4;
+        const Scalar b6 = -Scalar(2)*b0*(-b0*b2 + b1) + b1;
+        const Scalar b7 = Scalar(3)*b0;
+        const Scalar b8 = b1 - b6*b7;
+        const Scalar b9 = Scalar(4)*b0;
+        const Scalar b10 = -Scalar(3)*b0*(-Scalar(2)*b0*b4 + b1) + b1;
+        const Scalar b11 = Scalar(5)*b0;
+        const Scalar b12 = b1 - b11*(b1 - b10*b9);
+        const Scalar b13 = Scalar(6)*b0;
+        const Scalar b14 = Scalar(7)*b0;
+        const Scalar b15 = b1 - b14*(b1 - b13*(b1 + b11*(Scalar(4)*b0*(b1 - b6*b7) - b1)));
+        const Scalar b16 = Scalar(8)*b0;
+        const Scalar b17 = Scalar(9)*b0;
+        imag_factor = (Scalar(1.0 / 185794560.0))*(theta_sq*(theta_sq*(theta_sq*(theta_sq + Scalar(-288)) + Scalar(48384)) + Scalar(-3870720)) + Scalar(92897280));
+        real_factor = (Scalar(1.0 / 10321920.0))*theta_sq*(theta_sq*(theta_sq*(theta_sq + Scalar(-224)) + Scalar(26880)) + Scalar(-1290240)) + Scalar(1);
+        A = b0*(b4 + (Scalar(1.0 / 362880.0))*theta_sq*(Scalar(181440)*b0*(b1 - Scalar(2)*b5) - Scalar(60480)*b1 + theta_sq*(-Scalar(15120)*b0*(b1 - b8*b9) + Scalar(3024)*b1 + theta_sq*(Scalar(504)*b0*(b1 - b12*b13) - Scalar(72)*b1 + theta_sq*(b1 - b17*(b1 - b15*b16))))));
+        B = b0*((Scalar(1.0 / 2.0))*b1 - b5 + (Scalar(1.0 / 3628800.0))*theta_sq*(Scalar(604800)*b0*b8 - Scalar(151200)*b1 + theta_sq*(-Scalar(30240)*b0*(b1 - b11*(b1 - b10*b9)) + Scalar(5040)*b1 + theta_sq*(Scalar(720)*b0*b15 - Scalar(90)*b1 + theta_sq*(-Scalar(10)*b0*(b1 - b17*(b1 - b16*(b1 - b14*(b1 - b12*b13)))) + b1)))));
+        C = b3;
+      }
+    } else {
+      const Scalar theta = sqrt(theta_sq);
+      if (abs(sigma) < generatedThreshold<Scalar>(0.0881785, 0.5)) {
+        const Scalar b0 = Scalar(1) / (theta);
+        const Scalar b1 = (Scalar(1.0 / 2.0))*theta;
+        const Scalar b2 = Scalar(1) / (theta * theta);
+        const Scalar b3 = cos(theta);
+        const Scalar b4 = sin(theta);
+        const Scalar b5 = b0*b4;
+        const Scalar b6 = b3 + Scalar(-1);
+        const Scalar b7 = b0*b6 + b4;
+        const Scalar b8 = b0*b7;
+        const Scalar b9 = -b5;
+        const Scalar b10 = b3 + b9;
+        const Scalar b11 = Scalar(2)*b0;
+        const Scalar b12 = b10*b11 + b4;
+        const Scalar b13 = b0*b12;
+        const Scalar b14 = b0*b6 + b4;
+        const Scalar b15 = Scalar(3)*b0;
+        const Scalar b16 = b10*b11 + b4;
+        const Scalar b17 = Scalar(4)*b0;
+        const Scalar b18 = -Scalar(2)*b0*b7 + b3;
+        const Scalar b19 = b15*b18 + b4;
+        const Scalar b20 = Scalar(5)*b0;
+        const Scalar b21 = -Scalar(3)*b0*b12 + b3;
+        const Scalar b22 = Scalar(6)*b0;
+        const Scalar b23 = b22*(b20*(-Scalar(4)*b0*b21 - b4) + b3) + b4;
+        const Scalar b24 = -Scalar(4)*b0*(b15*(-b11*b14 + b3) + b4) + b3;
+        const Scalar b25 = Scalar(7)*b0;
+        const Scalar b26 = Scalar(8)*b0;
+        const Scalar b27 = (Scalar(1.0 / 362880.0))*sigma;
+        imag_factor = b0*sin(b1);
+        real_factor = cos(b1);
+        A = -b2*(b6 + (Scalar(1.0 / 40320.0))*sigma*(Scalar(40320)*b3 - Scalar(40320)*b5 + sigma*(Scalar(20160)*b3 - Scalar(40320)*b8 + sigma*(-Scalar(20160)*b13 + Scalar(6720)*b3 + sigma*(-Scalar(6720)*b0*(b15*(-b11*b14 + b3) + b4) + Scalar(1680)*b3 + sigma*(-Scalar(1680)*b0*(b17*(-b15*b16 + b3) + b4) + Scalar(336)*b3 + sigma*(-Scalar(336)*b0*(b20*(-b17*b19 + b3) + b4) + Scalar(56)*b3 + sigma*(-Scalar(56)*b0*b23 + Scalar(8)*b3 + sigma*(-b26*(b25*(b22*(-Scalar(5)*b0*b24 - b4) + b3) + b4) + b3)))))))));
+        B = b2*(b27*(-Scalar(362880)*b8 + sigma*(-Scalar(181440)*b13 + sigma*(-Scalar(60480)*b0*(b15*b18 + b4) + sigma*(-Scalar(15120)*b0*(b17*b21 + b4) + sigma*(-Scalar(3024)*b0*(b20*b24 + b4) + sigma*(-Scalar(504)*b0*(b22*(-b20*(b17*(-b15*b16 + b3) + b4) + b3) + b4) + sigma*(-Scalar(72)*b0*(b25*(-b22*(b20*(-b17*b19 + b3) + b4) + b3) + b4) + sigma*(-Scalar(9)*b0*(b26*(-b23*b25 + b3) + b4) + Scalar(1)) + Scalar(9)) + Scalar(72)) + Scalar(504)) + Scalar(3024)) + Scalar(15120)) + Scalar(60480)) + Scalar(181440)) + b9 + Scalar(1));
+        C = b27*(sigma*(sigma*(sigma*(sigma*(sigma*(sigma*(sigma + Scalar(9)) + Scalar(72)) + Scalar(504)) + Scalar(3024)) + Scalar(15120)) + Scalar(60480)) + Scalar(181440)) + Scalar(1);
+      } else {
+        const Scalar b0 = Scalar(1) / (theta);
+        const Scalar b1 = (Scalar(1.0 / 2.0))*theta;
+        const Scalar b2 = (theta * theta);
+        const Scalar b3 = Scalar(1) / ((b2 + (sigma * sigma)));
+        const Scalar b4 = (sqrt_scale * sqrt_scale);
+        const Scalar b5 = b4*sin(theta);
+        const Scalar b6 = b4*cos(theta) + Scalar(-1);
+        const Scalar b7 = (b4 + Scalar(-1))/sigma;
+        imag_factor = b0*sin(b1);
+        real_factor = cos(b1);
+        A = b0*b3*(b5*sigma - b6*theta);
+        B = -(b3*(b5*theta + b6*sigma) - b7)/b2;
+        C = b7;
+      }
+    }
+
+    Parameters res;
+    const Scalar t0 = imag_factor*sqrt_scale;
+    const Scalar t1 = a1*a5 - a2*a4;
+    const Scalar t2 = a0*a4 - a1*a3;
+    const Scalar t3 = a0*a5 - a2*a3;
+    res[0] = a3*t0;
+    res[1] = a4*t0;
+    res[2] = a5*t0;
+    res[3] = real_factor*sqrt_scale;
+    res[4] = -A*t1 - B*(a4*t2 + a5*t3) + C*a0;
+    res[5] = A*t3 - B*(-a3*t2 + a5*t1) + C*a1;
+    res[6] = -A*t2 + B*(a3*t3 + a4*t1) + C*a2;
+    return res;
+  }
+
+  /**
+   * Group logarithm of parameters p
+   */
+  inline static Tangent log(const Parameters& p) {
+    using std::abs;
+    using std::atan;
+    using std::atan2;
+    using std::cos;
+    using std::exp;
+    using std::log;
+    using std::sin;
+    using std::sqrt;
+    using std::tan;
+
+    const Scalar p0 = p[0];
+    const Scalar p1 = p[1];
+    const Scalar p2 = p[2];
+    const Scalar p3 = p[3];
+    const Scalar p4 = p[4];
+    const Scalar p5 = p[5];
+    const Scalar p6 = p[6];
+    Scalar k;
+    const Scalar n_sq = (p0 * p0) + (p1 * p1) + (p2 * p2);
+    if (n_sq < generatedThreshold<Scalar>(0.00119555, 0.0666102) * ((p3 * p3))) {
+      const Scalar b0 = n_sq/(p3 * p3);
+      k = Scalar(2)*((Scalar(1.0 / 315.0))*b0*(b0*(Scalar(5)*b0*(Scalar(7)*b0 + Scalar(-9)) + Scalar(63)) + Scalar(-105)) + Scalar(1))/p3;
+    } else {
+      const Scalar n = sqrt(n_sq);
+      if (abs(p3) < SophusConstants<Scalar>::epsilon()) {
+        if (p3 > Scalar(0)) {
+          k = SophusConstants<Scalar>::pi()/n;
+        } else {
+          k = -SophusConstants<Scalar>::pi()/n;
+        }
+      } else {
+        k = Scalar(2)*atan(n/p3)/n;
+      }
+    }
+    const Scalar scale = (p0 * p0) + (p1 * p1) + (p2 * p2) + (p3 * p3);
+    const Scalar sigma = log(scale);
+    Scalar A, B, C;
+    const Scalar theta_sq = (k * k)*((p0 * p0) + (p1 * p1) + (p2 * p2));
+    if (theta_sq < generatedThreshold<Scalar>(0.0350873, 0.25)) {
+      if (abs(sigma) < generatedThreshold<Scalar>(0.0881785, 0.5)) {
+        const Scalar b0 = Scalar(5)*theta_sq;
+        const Scalar b1 = Scalar(11)*theta_sq;
+        const Scalar b2 = Scalar(13)*theta_sq;
+        const Scalar b3 = Scalar(7)*theta_sq;
+        A = (Scalar(1.0 / 3201186852864000.0))*sigma*(sigma*(sigma*(sigma*(sigma*(sigma*(sigma*(Scalar(12155)*sigma*(theta_sq*(theta_sq*(theta_sq*(theta_sq + Scalar(-81)) + Scalar(3888)) + Scalar(-90720)) + Scalar(653184)) + Scalar(144)*theta_sq*(b1*(b2*(b0 + Scalar(-408)) + Scalar(257040)) + Scalar(-66830400)) + Scalar(70572902400)) + Scalar(109395)*theta_sq*(theta_sq*(theta_sq*(b3 + Scalar(-576)) + Scalar(28224)) + Scalar(-677376)) + Scalar(555761606400)) + Scalar(34272)*theta_sq*(theta_sq*(b1*(b2 + Scalar(-1080)) + Scalar(589680)) + Scalar(-14414400)) + Scalar(3810936729600)) + Scalar(5250960)*theta_sq*(theta_sq*(b0*(theta_sq + Scalar(-84)) + Scalar(21168)) + Scalar(-529200)) + Scalar(22230464256000)) + Scalar(10281600)*theta_sq*(theta_sq*(theta_sq*(b1 + Scalar(-936)) + Scalar(48048)) + Scalar(-1235520)) + Scalar(106706228428800)) + Scalar(73513440)*theta_sq*(theta_sq*(theta_sq*(b0 + Scalar(-432)) + Scalar(22680)) + Scalar(-604800)) + Scalar(400148356608000)) + Scalar(801964800)*theta_sq*(theta_sq*(theta_sq*(theta_sq + Scalar(-88)) + Scalar(4752)) + Scalar(-133056)) + Scalar(1067062284288000)) + (Scalar(1.0 / 3628800.0))*theta_sq*(theta_sq*(theta_sq*(theta_sq + Scalar(-90)) + Scalar(5040)) + Scalar(-151200)) + Scalar(1.0 / 2.0);
+        B = (Scalar(1.0 / 60822550204416000.0))*sigma*(sigma*(sigma*(sigma*(sigma*(sigma*(sigma*(Scalar(9)*sigma*(b1*(b2*(theta_sq*(Scalar(17)*theta_sq + Scalar(-1710)) + Scalar(108528)) + Scalar(-48837600)) + Scalar(7618665600)) + Scalar(46189)*theta_sq*(theta_sq*(theta_sq*(Scalar(4)*theta_sq + Scalar(-405)) + Scalar(25920)) + Scalar(-907200)) + Scalar(603398315520)) + Scalar(9576)*theta_sq*(b1*(b2*(theta_sq + Scalar(-102)) + Scalar(85680)) + Scalar(-33415200)) + Scalar(4693098009600)) + Scalar(1247103)*theta_sq*(theta_sq*(theta_sq*(b3 + Scalar(-720)) + Scalar(47040)) + Scalar(-1693440)) + Scalar(31678411564800)) + Scalar(325584)*theta_sq*(theta_sq*(b1*(b2 + Scalar(-1350)) + Scalar(982800)) + Scalar(-36036000)) + Scalar(181019494656000)) + Scalar(199536480)*theta_sq*(theta_sq*(theta_sq*(theta_sq + Scalar(-105)) + Scalar(7056)) + Scalar(-264600)) + Scalar(844757641728000)) + Scalar(58605120)*theta_sq*(theta_sq*(theta_sq*(b1 + Scalar(-1170)) + Scalar(80080)) + Scalar(-3088800)) + Scalar(3041127510220800)) + Scalar(1396755360)*theta_sq*(theta_sq*(theta_sq*(theta_sq + Scalar(-108)) + Scalar(7560)) + Scalar(-302400)) + Scalar(7602818775552000)) + (Scalar(1.0 / 39916800.0))*theta_sq*(theta_sq*(theta_sq*(theta_sq + Scalar(-110)) + Scalar(7920)) + Scalar(-332640)) + Scalar(1.0 / 6.0);
+        C = (Scalar(1.0 / 362880.0))*sigma*(sigma*(sigma*(sigma*(sigma*(sigma*(sigma*(sigma + Scalar(9)) + Scalar(72)) + Scalar(504)) + Scalar(3024)) + Scalar(15120)) + Scalar(60480)) + Scalar(181440)) + Scalar(1);
+      } else {
+        const Scalar b0 = Scalar(1) / (sigma);
+        const Scalar b1 = scale + Scalar(-1);
+        const Scalar b2 = b0*b1;
+        const Scalar b3 = -b2 + scale;
+        const Scalar b4 = b0*b3;
+        const Scalar b5 = -Scalar(2)*b0*(-b0*b1 + scale) + scale;
+        const Scalar b6 = Scalar(3)*b0;
+        const Scalar b7 = -b5*b6 + scale;
+        const Scalar b8 = Scalar(4)*b0;
+        const Scalar b9 = -Scalar(3)*b0*(-Scalar(2)*b0*b3 + scale) + scale;
+        const Scalar b10 = Scalar(5)*b0;
+        const Scalar b11 = -b10*(-b8*b9 + scale) + scale;
+        const Scalar b12 = Scalar(6)*b0;
+        const Scalar b13 = Scalar(7)*b0;
+        const Scalar b14 = -b13*(-b12*(b10*(Scalar(4)*b0*(-b5*b6 + scale) - scale) + scale) + scale) + scale;
+        const Scalar b15 = Scalar(8)*b0;
+        const Scalar b16 = Scalar(9)*b0;
+        A = b0*(b3 + (Scalar(1.0 / 362880.0))*theta_sq*(Scalar(181440)*b0*(-Scalar(2)*b4 + scale) - Scalar(60480)*scale + theta_sq*(-Scalar(15120)*b0*(-b7*b8 + scale) + Scalar(3024)*scale + theta_sq*(Scalar(504)*b0*(-b11*b12 + scale) - Scalar(72)*scale + theta_sq*(-b16*(-b14*b15 + scale) + scale)))));
+        B = b0*(-b4 + (Scalar(1.0 / 2.0))*scale + (Scalar(1.0 / 3628800.0))*theta_sq*(Scalar(604800)*b0*b7 - Scalar(151200)*scale + theta_sq*(-Scalar(30240)*b0*(-b10*(-b8*b9 + scale) + scale) + Scalar(5040)*scale + theta_sq*(Scalar(720)*b0*b14 - Scalar(90)*scale + theta_sq*(-Scalar(10)*b0*(-b16*(-b15*(-b13*(-b11*b12 + scale) + scale) + scale) + scale) + scale)))));
+        C = b2;
+      }
+    } else {
+      const Scalar theta = sqrt(theta_sq);
+      if (abs(sigma) < generatedThreshold<Scalar>(0.0881785, 0.5)) {
+        const Scalar b0 = Scalar(1) / (theta * theta);
+        const Scalar b1 = cos(theta);
+        const Scalar b2 = sin(theta);
+        const Scalar b3 = Scalar(1) / (theta);
+        const Scalar b4 = b2*b3;
+        const Scalar b5 = b1 + Scalar(-1);
+        const Scalar b6 = b2 + b3*b5;
+        const Scalar b7 = b3*b6;
+        const Scalar b8 = -b4;
+        const Scalar b9 = b1 + b8;
+        const Scalar b10 = Scalar(2)*b3;
+        const Scalar b11 = b10*b9 + b2;
+        const Scalar b12 = b11*b3;
+        const Scalar b13 = b2 + b3*b5;
+        const Scalar b14 = Scalar(3)*b3;
+        const Scalar b15 = b10*b9 + b2;
+        const Scalar b16 = Scalar(4)*b3;
+        const Scalar b17 = b1 - Scalar(2)*b3*b6;
+        const Scalar b18 = b14*b17 + b2;
+        const Scalar b19 = Scalar(5)*b3;
+        const Scalar b20 = b1 - Scalar(3)*b11*b3;
+        const Scalar b21 = Scalar(6)*b3;
+        const Scalar b22 = b2 + b21*(b1 + b19*(-b2 - Scalar(4)*b20*b3));
+        const Scalar b23 = b1 - Scalar(4)*b3*(b14*(b1 - b10*b13) + b2);
+        const Scalar b24 = Scalar(7)*b3;
+        const Scalar b25 = Scalar(8)*b3;
+        const Scalar b26 = (Scalar(1.0 / 362880.0))*sigma;
+        A = -b0*(b5 + (Scalar(1.0 / 40320.0))*sigma*(Scalar(40320)*b1 - Scalar(40320)*b4 + sigma*(Scalar(20160)*b1 - Scalar(40320)*b7 + sigma*(Scalar(6720)*b1 - Scalar(20160)*b12 + sigma*(Scalar(1680)*b1 - Scalar(6720)*b3*(b14*(b1 - b10*b13) + b2) + sigma*(Scalar(336)*b1 - Scalar(1680)*b3*(b16*(b1 - b14*b15) + b2) + sigma*(Scalar(56)*b1 - Scalar(336)*b3*(b19*(b1 - b16*b18) + b2) + sigma*(Scalar(8)*b1 - Scalar(56)*b22*b3 + sigma*(b1 - b25*(b2 + b24*(b1 + b21*(-b2 - Scalar(5)*b23*b3))))))))))));
+        B = b0*(b26*(-Scalar(362880)*b7 + sigma*(-Scalar(181440)*b12 + sigma*(-Scalar(60480)*b3*(b14*b17 + b2) + sigma*(-Scalar(15120)*b3*(b16*b20 + b2) + sigma*(-Scalar(3024)*b3*(b19*b23 + b2) + sigma*(-Scalar(504)*b3*(b2 + b21*(b1 - b19*(b16*(b1 - b14*b15) + b2))) + sigma*(-Scalar(72)*b3*(b2 + b24*(b1 - b21*(b19*(b1 - b16*b18) + b2))) + sigma*(-Scalar(9)*b3*(b2 + b25*(b1 - b22*b24)) + Scalar(1)) + Scalar(9)) + Scalar(72)) + Scalar(504)) + Scalar(3024)) + Scalar(15120)) + Scalar(60480)) + Scalar(181440)) + b8 + Scalar(1));
+        C = b26*(sigma*(sigma*(sigma*(sigma*(sigma*(sigma*(sigma + Scalar(9)) + Scalar(72)) + Scalar(504)) + Scalar(3024)) + Scalar(15120)) + Scalar(60480)) + Scalar(181440)) + Scalar(1);
+      } else {
+        const Scalar b0 = (theta * theta);
+        const Scalar b1 = Scalar(1) / ((b0 + (sigma * sigma)));
+        const Scalar b2 = scale*sin(theta);
+        const Scalar b3 = scale*cos(theta) + Scalar(-1);
+        const Scalar b4 = (scale + Scalar(-1))/sigma;
+        A = b1*(b2*sigma - b3*theta)/theta;
+        B = -(b1*(b2*theta + b3*sigma) - b4)/b0;
+        C = b4;
+      }
+    }
+    const Scalar a = -A/((A * A)*theta_sq + (B * B)*(theta_sq * theta_sq) - Scalar(2)*B*C*theta_sq + (C * C));
+    const Scalar b = ((A * A) + (B * B)*theta_sq - B*C)/(C*((A * A)*theta_sq + (B * B)*(theta_sq * theta_sq) - Scalar(2)*B*C*theta_sq + (C * C)));
+    const Scalar c = Scalar(1) / (C);
+
+    Tangent res;
+    const Scalar t0 = p1*p6 - p2*p5;
+    const Scalar t1 = a*k;
+    const Scalar t2 = p0*p5 - p1*p4;
+    const Scalar t3 = p0*p6 - p2*p4;
+    const Scalar t4 = b*(k * k);
+    res[0] = c*p4 + t0*t1 + t4*(p1*t2 + p2*t3);
+    res[1] = c*p5 - t1*t3 - t4*(p0*t2 - p2*t0);
+    res[2] = c*p6 + t1*t2 - t4*(p0*t3 + p1*t0);
+    res[3] = k*p0;
+    res[4] = k*p1;
+    res[5] = k*p2;
+    res[6] = sigma;
+    return res;
+  }
+
+  /**
+   * Adjoint transformation of parameters p
+   */
+  inline static Adjoint Adj(const Parameters& p) {
+    using std::abs;
+    using std::atan;
+    using std::atan2;
+    using std::cos;
+    using std::exp;
+    using std::log;
+    using std::sin;
+    using std::sqrt;
+    using std::tan;
+
+    const Scalar p0 = p[0];
+    const Scalar p1 = p[1];
+    const Scalar p2 = p[2];
+    const Scalar p3 = p[3];
+    const Scalar p4 = p[4];
+    const Scalar p5 = p[5];
+    const Scalar p6 = p[6];
+
+    Adjoint res;
+    const Scalar t0 = (p1 * p1);
+    const Scalar t1 = -t0;
+    const Scalar t2 = (p2 * p2);
+    const Scalar t3 = -t2;
+    const Scalar t4 = (p0 * p0);
+    const Scalar t5 = (p3 * p3);
+    const Scalar t6 = t4 + t5;
+    const Scalar t7 = t1 + t3 + t6;
+    const Scalar t8 = p0*p1;
+    const Scalar t9 = p2*p3;
+    const Scalar t10 = t8 - t9;
+    const Scalar t11 = p0*p2;
+    const Scalar t12 = p1*p3;
+    const Scalar t13 = t11 + t12;
+    const Scalar t14 = t11 - t12;
+    const Scalar t15 = t8 + t9;
+    const Scalar t16 = Scalar(1) / ((t0 + t2 + t6));
+    const Scalar t17 = Scalar(2)*t16;
+    const Scalar t18 = p0*p3;
+    const Scalar t19 = p1*p2;
+    const Scalar t20 = t18 + t19;
+    const Scalar t21 = Scalar(2)*p5;
+    const Scalar t22 = t4 - t5;
+    const Scalar t23 = t1 + t2 + t22;
+    const Scalar t24 = t18 - t19;
+    const Scalar t25 = t0 + t22 + t3;
+    const Scalar t26 = Scalar(2)*p4;
+    res(0, 0) = t7;
+    res(0, 1) = Scalar(2)*t10;
+    res(0, 2) = Scalar(2)*t13;
+    res(0, 3) = t17*(p5*t14 - p6*t15);
+    res(0, 4) = t16*(p6*t23 + t20*t21);
+    res(0, 5) = t16*(-p5*t25 + Scalar(2)*p6*t24);
+    res(0, 6) = -p4;
+    res(1, 0) = Scalar(2)*t15;
+    res(1, 1) = -t23;
+    res(1, 2) = -Scalar(2)*t24;
+    res(1, 3) = t16*(p6*t7 - t14*t26);
+    res(1, 4) = t17*(-p4*t20 + p6*t10);
+    res(1, 5) = t16*(p4*t25 + Scalar(2)*p6*t13);
+    res(1, 6) = -p5;
+    res(2, 0) = Scalar(2)*t14;
+    res(2, 1) = Scalar(2)*t20;
+    res(2, 2) = -t25;
+    res(2, 3) = t16*(-p5*t7 + t15*t26);
+    res(2, 4) = -t16*(p4*t23 + t10*t21);
+    res(2, 5) = -t17*(p4*t24 + p5*t13);
+    res(2, 6) = -p6;
+    res(3, 0) = Scalar(0);
+    res(3, 1) = Scalar(0);
+    res(3, 2) = Scalar(0);
+    res(3, 3) = t16*t7;
+    res(3, 4) = t10*t17;
+    res(3, 5) = t13*t17;
+    res(3, 6) = Scalar(0);
+    res(4, 0) = Scalar(0);
+    res(4, 1) = Scalar(0);
+    res(4, 2) = Scalar(0);
+    res(4, 3) = t15*t17;
+    res(4, 4) = -t16*t23;
+    res(4, 5) = -t17*t24;
+    res(4, 6) = Scalar(0);
+    res(5, 0) = Scalar(0);
+    res(5, 1) = Scalar(0);
+    res(5, 2) = Scalar(0);
+    res(5, 3) = t14*t17;
+    res(5, 4) = t17*t20;
+    res(5, 5) = -t16*t25;
+    res(5, 6) = Scalar(0);
+    res(6, 0) = Scalar(0);
+    res(6, 1) = Scalar(0);
+    res(6, 2) = Scalar(0);
+    res(6, 3) = Scalar(0);
+    res(6, 4) = Scalar(0);
+    res(6, 5) = Scalar(0);
+    res(6, 6) = Scalar(1);
+    return res;
+  }
+
+  /**
+   * Derivative of parameters of p * exp(x) with respect to x at x = 0
+   */
+  inline static ParameterJacobian internalJacobian(const Parameters& p) {
+    using std::abs;
+    using std::atan;
+    using std::atan2;
+    using std::cos;
+    using std::exp;
+    using std::log;
+    using std::sin;
+    using std::sqrt;
+    using std::tan;
+
+    const Scalar p0 = p[0];
+    const Scalar p1 = p[1];
+    const Scalar p2 = p[2];
+    const Scalar p3 = p[3];
+
+    ParameterJacobian res;
+    const Scalar t0 = (Scalar(1.0 / 2.0))*p3;
+    const Scalar t1 = (Scalar(1.0 / 2.0))*p2;
+    const Scalar t2 = -t1;
+    const Scalar t3 = (Scalar(1.0 / 2.0))*p1;
+    const Scalar t4 = (Scalar(1.0 / 2.0))*p0;
+    const Scalar t5 = -t4;
+    const Scalar t6 = -t3;
+    const Scalar t7 = (p3 * p3);
+    const Scalar t8 = (p2 * p2);
+    const Scalar t9 = -t8;
+    const Scalar t10 = (p0 * p0);
+    const Scalar t11 = (p1 * p1);
+    const Scalar t12 = t10 - t11;
+    const Scalar t13 = p0*p1;
+    const Scalar t14 = p2*p3;
+    const Scalar t15 = p0*p2;
+    const Scalar t16 = p1*p3;
+    const Scalar t17 = -t7;
+    const Scalar t18 = p0*p3;
+    res(0, 0) = Scalar(0);
+    res(0, 1) = Scalar(0);
+    res(0, 2) = Scalar(0);
+    res(0, 3) = t0;
+    res(0, 4) = t2;
+    res(0, 5) = t3;
+    res(0, 6) = t4;
+    res(1, 0) = Scalar(0);
+    res(1, 1) = Scalar(0);
+    res(1, 2) = Scalar(0);
+    res(1, 3) = t1;
+    res(1, 4) = t0;
+    res(1, 5) = t5;
+    res(1, 6) = t3;
+    res(2, 0) = Scalar(0);
+    res(2, 1) = Scalar(0);
+    res(2, 2) = Scalar(0);
+    res(2, 3) = t6;
+    res(2, 4) = t4;
+    res(2, 5) = t0;
+    res(2, 6) = t1;
+    res(3, 0) = Scalar(0);
+    res(3, 1) = Scalar(0);
+    res(3, 2) = Scalar(0);
+    res(3, 3) = t5;
+    res(3, 4) = t6;
+    res(3, 5) = t2;
+    res(3, 6) = t0;
+    res(4, 0) = t12 + t7 + t9;
+    res(4, 1) = Scalar(2)*t13 - Scalar(2)*t14;
+    res(4, 2) = Scalar(2)*t15 + Scalar(2)*t16;
+    res(4, 3) = Scalar(0);
+    res(4, 4) = Scalar(0);
+    res(4, 5) = Scalar(0);
+    res(4, 6) = Scalar(0);
+    res(5, 0) = Scalar(2)*t13 + Scalar(2)*t14;
+    res(5, 1) = -t12 - t17 - t8;
+    res(5, 2) = Scalar(2)*p1*p2 - Scalar(2)*t18;
+    res(5, 3) = Scalar(0);
+    res(5, 4) = Scalar(0);
+    res(5, 5) = Scalar(0);
+    res(5, 6) = Scalar(0);
+    res(6, 0) = Scalar(2)*t15 - Scalar(2)*t16;
+    res(6, 1) = Scalar(2)*p1*p2 + Scalar(2)*t18;
+    res(6, 2) = -t10 - t11 - t17 - t9;
+    res(6, 3) = Scalar(0);
+    res(6, 4) = Scalar(0);
+    res(6, 5) = Scalar(0);
+    res(6, 6) = Scalar(0);
+    return res;
+  }
+
+  /**
+   * Derivative of parameters of exp(a) with respect to a
+   */
+  inline static ParameterJacobian Dx_exp(const Tangent& a) {
+    using std::abs;
+    using std::atan;
+    using std::atan2;
+    using std::cos;
+    using std::exp;
+    using std::log;
+    using std::sin;
+    using std::sqrt;
+    using std::tan;
+
+    const Scalar a0 = a[0];
+    const Scalar a1 = a[1];
+    const Scalar a2 = a[2];
+    const Scalar a3 = a[3];
+    const Scalar a4 = a[4];
+    const Scalar a5 = a[5];
+    const Scalar a6 = a[6];
+    const Scalar sigma = a6;
+    const Scalar sqrt_scale = exp((Scalar(1.0 / 2.0))*sigma);
+    Scalar imag_factor, real_factor, A, B, C, imag_factor_dtheta, real_factor_dtheta, A_dsigma, A_dtheta, B_dsigma, B_dtheta, C_dsigma;
+    const Scalar theta_sq = (a3 * a3) + (a4 * a4) + (a5 * a5);
+    if (theta_sq < generatedThreshold<Scalar>(0.0328764, 0.25)) {
+      if (abs(sigma) < generatedThreshold<Scalar>(0.0847523, 0.5)) {
+        const Scalar b0 = theta_sq*(theta_sq*(theta_sq + Scalar(-288)) + Scalar(48384)) + Scalar(-3870720);
+        const Scalar b1 = theta_sq*(theta_sq*(theta_sq*(theta_sq + Scalar(-88)) + Scalar(4752)) + Scalar(-133056));
+        const Scalar b2 = Scalar(5)*theta_sq;
+        const Scalar b3 = theta_sq*(theta_sq*(theta_sq*(b2 + Scalar(-432)) + Scalar(22680)) + Scalar(-604800));
+        const Scalar b4 = Scalar(11)*theta_sq;
+        const Scalar b5 = theta_sq*(theta_sq*(theta_sq*(b4 + Scalar(-936)) + Scalar(48048)) + Scalar(-1235520));
+        const Scalar b6 = theta_sq*(theta_sq*(b2*(theta_sq + Scalar(-84)) + Scalar(21168)) + Scalar(-529200));
+        const Scalar b7 = Scalar(13)*theta_sq;
+        const Scalar b8 = theta_sq*(theta_sq*(b4*(b7 + Scalar(-1080)) + Scalar(589680)) + Scalar(-14414400));
+        const Scalar b9 = Scalar(7)*theta_sq;
+        const Scalar b10 = theta_sq*(theta_sq*(theta_sq*(b9 + Scalar(-576)) + Scalar(28224)) + Scalar(-677376));
+        const Scalar b11 = theta_sq*(theta_sq*(theta_sq*(theta_sq + Scalar(-81)) + Scalar(3888)) + Scalar(-90720));
+        const Scalar b12 = theta_sq*(b4*(b7*(b2 + Scalar(-408)) + Scalar(257040)) + Scalar(-66830400));
+        const Scalar b13 = theta_sq*(theta_sq*(theta_sq*(theta_sq + Scalar(-108)) + Scalar(7560)) + Scalar(-302400));
+        const Scalar b14 = theta_sq*(theta_sq*(theta_sq*(b4 + Scalar(-1170)) + Scalar(80080)) + Scalar(-3088800));
+        const Scalar b15 = theta_sq*(theta_sq*(theta_sq*(theta_sq + Scalar(-105)) + Scalar(7056)) + Scalar(-264600));
+        const Scalar b16 = theta_sq*(theta_sq*(b4*(b7 + Scalar(-1350)) + Scalar(982800)) + Scalar(-36036000));
+        const Scalar b17 = theta_sq*(theta_sq*(theta_sq*(b9 + Scalar(-720)) + Scalar(47040)) + Scalar(-1693440));
+        const Scalar b18 = theta_sq*(b4*(b7*(theta_sq + Scalar(-102)) + Scalar(85680)) + Scalar(-33415200));
+        const Scalar b19 = theta_sq*(theta_sq*(theta_sq*(Scalar(4)*theta_sq + Scalar(-405)) + Scalar(25920)) + Scalar(-907200));
+        const Scalar b20 = Scalar(17)*theta_sq;
+        const Scalar b21 = b7*(theta_sq*(b20 + Scalar(-1710)) + Scalar(108528)) + Scalar(-48837600);
+        const Scalar b22 = Scalar(9)*sigma;
+        const Scalar b23 = Scalar(3)*theta_sq;
+        imag_factor = (Scalar(1.0 / 185794560.0))*b0*theta_sq + Scalar(1.0 / 2.0);
+        real_factor = (Scalar(1.0 / 10321920.0))*theta_sq*(theta_sq*(theta_sq*(theta_sq + Scalar(-224)) + Scalar(26880)) + Scalar(-1290240)) + Scalar(1);
+        A = (Scalar(1.0 / 3201186852864000.0))*sigma*(Scalar(801964800)*b1 + sigma*(Scalar(73513440)*b3 + sigma*(Scalar(10281600)*b5 + sigma*(Scalar(5250960)*b6 + sigma*(Scalar(34272)*b8 + sigma*(Scalar(109395)*b10 + sigma*(Scalar(144)*b12 + Scalar(12155)*sigma*(b11 + Scalar(653184)) + Scalar(70572902400)) + Scalar(555761606400)) + Scalar(3810936729600)) + Scalar(22230464256000)) + Scalar(106706228428800)) + Scalar(400148356608000)) + Scalar(1067062284288000)) + (Scalar(1.0 / 3628800.0))*theta_sq*(theta_sq*(theta_sq*(theta_sq + Scalar(-90)) + Scalar(5040)) + Scalar(-151200)) + Scalar(1.0 / 2.0);
+        B = (Scalar(1.0 / 60822550204416000.0))*sigma*(Scalar(1396755360)*b13 + sigma*(Scalar(58605120)*b14 + sigma*(Scalar(199536480)*b15 + sigma*(Scalar(325584)*b16 + sigma*(Scalar(1247103)*b17 + sigma*(Scalar(9576)*b18 + sigma*(Scalar(46189)*b19 + b22*(b21*b4 + Scalar(7618665600)) + Scalar(603398315520)) + Scalar(4693098009600)) + Scalar(31678411564800)) + Scalar(181019494656000)) + Scalar(844757641728000)) + Scalar(3041127510220800)) + Scalar(7602818775552000)) + (Scalar(1.0 / 39916800.0))*theta_sq*(theta_sq*(theta_sq*(theta_sq + Scalar(-110)) + Scalar(7920)) + Scalar(-332640)) + Scalar(1.0 / 6.0);
+        C = (Scalar(1.0 / 362880.0))*sigma*(sigma*(sigma*(sigma*(sigma*(sigma*(sigma*(sigma + Scalar(9)) + Scalar(72)) + Scalar(504)) + Scalar(3024)) + Scalar(15120)) + Scalar(60480)) + Scalar(181440)) + Scalar(1);
+        imag_factor_dtheta = (Scalar(1.0 / 8174960640.0))*(theta_sq*(-theta_sq*(theta_sq*(theta_sq + Scalar(-352)) + Scalar(76032)) + Scalar(8515584)) + Scalar(-340623360));
+        real_factor_dtheta = -Scalar(1.0 / 371589120.0)*b0*theta_sq + Scalar(-1.0 / 4.0);
+        A_dsigma = (Scalar(1.0 / 3991680.0))*b1 + (Scalar(1.0 / 30411275102208000.0))*sigma*(Scalar(1396755360)*b3 + sigma*(Scalar(293025600)*b5 + sigma*(Scalar(199536480)*b6 + sigma*(Scalar(1627920)*b8 + sigma*(Scalar(6235515)*b10 + sigma*(Scalar(9576)*b12 + sigma*(Scalar(923780)*b11 + b22*(b4*(b7*(b2*(b20 + Scalar(-1368)) + Scalar(325584)) + Scalar(-97675200)) + Scalar(7618665600)) + Scalar(603398315520)) + Scalar(4693098009600)) + Scalar(31678411564800)) + Scalar(181019494656000)) + Scalar(844757641728000)) + Scalar(3041127510220800)) + Scalar(7602818775552000)) + Scalar(1.0 / 3.0);
+        A_dtheta = (Scalar(1.0 / 121645100408832000.0))*sigma*(sigma*(sigma*(sigma*(sigma*(sigma*(sigma*(Scalar(4199)*sigma*(theta_sq*(-theta_sq*(theta_sq*(Scalar(9)*theta_sq + Scalar(-880)) + Scalar(53460)) + Scalar(1710720)) + Scalar(-19958400)) + Scalar(288)*theta_sq*(-b7*(b2*(b20 + Scalar(-1672)) + Scalar(511632)) + Scalar(214885440)) + Scalar(-731391897600)) + Scalar(335920)*theta_sq*(-theta_sq*(b9*(theta_sq + Scalar(-99)) + Scalar(42768)) + Scalar(1397088)) + Scalar(-5631717611520)) + Scalar(76608)*theta_sq*(-theta_sq*(b7*(Scalar(15)*theta_sq + Scalar(-1496)) + Scalar(1211760)) + Scalar(40098240)) + Scalar(-37544784076800)) + Scalar(2267460)*theta_sq*(-b2*(theta_sq*(b9 + Scalar(-704)) + Scalar(44352)) + Scalar(7451136)) + Scalar(-211189410432000)) + Scalar(26046720)*theta_sq*(-theta_sq*(theta_sq*(b7 + Scalar(-1320)) + Scalar(84240)) + Scalar(2882880)) + Scalar(-965437304832000)) + Scalar(72558720)*theta_sq*(-theta_sq*(b2*(b23 + Scalar(-308)) + Scalar(99792)) + Scalar(3492720)) + Scalar(-3379030566912000)) + Scalar(2344204800)*theta_sq*(-theta_sq*(theta_sq*(theta_sq + Scalar(-104)) + Scalar(6864)) + Scalar(247104)) + Scalar(-8109673360588800)) + (Scalar(1.0 / 239500800.0))*theta_sq*(-theta_sq*(theta_sq*(b2 + Scalar(-528)) + Scalar(35640)) + Scalar(1330560)) + Scalar(-1.0 / 12.0);
+        B_dsigma = (Scalar(1.0 / 43545600.0))*b13 + (Scalar(1.0 / 1216451004088320000.0))*sigma*(Scalar(2344204800)*b14 + sigma*(Scalar(11972188800)*b15 + sigma*(Scalar(26046720)*b16 + sigma*(Scalar(124710300)*b17 + sigma*(Scalar(1149120)*b18 + sigma*(Scalar(6466460)*b19 + b22*(Scalar(1760)*b21*theta_sq + Scalar(46189)*sigma*(theta_sq*(theta_sq*(theta_sq*(theta_sq + Scalar(-100)) + Scalar(6300)) + Scalar(-216000)) + Scalar(3024000)) + Scalar(1218986496000)) + Scalar(84475764172800)) + Scalar(563171761152000)) + Scalar(3167841156480000)) + Scalar(14481559572480000)) + Scalar(50685458503680000)) + Scalar(121645100408832000)) + Scalar(1.0 / 8.0);
+        B_dtheta = (Scalar(1.0 / 851515702861824000.0))*sigma*(sigma*(sigma*(sigma*(sigma*(sigma*(sigma*(sigma*(b7*(-theta_sq*(b20*(Scalar(95)*theta_sq + Scalar(-11088)) + Scalar(14220360)) + Scalar(601679232)) + Scalar(-135377827200)) + Scalar(58786)*theta_sq*(-theta_sq*(theta_sq*(b23 + Scalar(-352)) + Scalar(26730)) + Scalar(1140480)) + Scalar(-1173274502400)) + Scalar(1176)*theta_sq*(-b7*(theta_sq*(Scalar(85)*theta_sq + Scalar(-10032)) + Scalar(767448)) + Scalar(429770880)) + Scalar(-8959550745600)) + Scalar(235144)*theta_sq*(-theta_sq*(b9*(b2 + Scalar(-594)) + Scalar(320760)) + Scalar(13970880)) + Scalar(-59133034920960)) + Scalar(134064)*theta_sq*(-theta_sq*(b7*(Scalar(25)*theta_sq + Scalar(-2992)) + Scalar(3029400)) + Scalar(133660800)) + Scalar(-328516860672000)) + Scalar(5290740)*theta_sq*(-theta_sq*(theta_sq*(Scalar(35)*theta_sq + Scalar(-4224)) + Scalar(332640)) + Scalar(14902272)) + Scalar(-1478325873024000)) + Scalar(45581760)*theta_sq*(-theta_sq*(theta_sq*(b7 + Scalar(-1584)) + Scalar(126360)) + Scalar(5765760)) + Scalar(-5068545850368000)) + Scalar(253955520)*theta_sq*(-theta_sq*(theta_sq*(b2 + Scalar(-616)) + Scalar(49896)) + Scalar(2328480)) + Scalar(-11826606984192000)) + (Scalar(1.0 / 3113510400.0))*theta_sq*(-theta_sq*(theta_sq*(b2 + Scalar(-624)) + Scalar(51480)) + Scalar(2471040)) + Scalar(-1.0 / 60.0);
+        C_dsigma = (Scalar(1.0 / 3628800.0))*sigma*(sigma*(sigma*(sigma*(sigma*(sigma*(sigma*(b22 + Scalar(80)) + Scalar(630)) + Scalar(4320)) + Scalar(25200)) + Scalar(120960)) + Scalar(453600)) + Scalar(1209600)) + Scalar(1.0 / 2.0);
+      } else {
+        const Scalar b0 = theta_sq*(theta_sq*(theta_sq + Scalar(-288)) + Scalar(48384)) + Scalar(-3870720);
+        const Scalar b1 = Scalar(1) / (sigma);
+        const Scalar b2 = (sqrt_scale * sqrt_scale);
+        const Scalar b3 = -Scalar(60480)*b2;
+        const Scalar b4 = b2 + Scalar(-1);
+        const Scalar b5 = b1*b4;
+        const Scalar b6 = b2 - b5;
+        const Scalar b7 = b1*b6;
+        const Scalar b8 = b2 - Scalar(2)*b7;
+        const Scalar b9 = b1*b8;
+        const Scalar b10 = Scalar(3024)*b2;
+        const Scalar b11 = -Scalar(2)*b1*(-b1*b4 + b2) + b2;
+        const Scalar b12 = Scalar(3)*b1;
+        const Scalar b13 = -b11*b12 + b2;
+        const Scalar b14 = Scalar(4)*b1;
+        const Scalar b15 = b1*(-b13*b14 + b2);
+        const Scalar b16 = -Scalar(72)*b2;
+        const Scalar b17 = -Scalar(3)*b1*(-Scalar(2)*b1*b6 + b2) + b2;
+        const Scalar b18 = Scalar(5)*b1;
+        const Scalar b19 = -b18*(-b14*b17 + b2) + b2;
+        const Scalar b20 = Scalar(6)*b1;
+        const Scalar b21 = b1*(-b19*b20 + b2);
+        const Scalar b22 = -Scalar(4)*b1*(-b11*b12 + b2) + b2;
+        const Scalar b23 = b2 - b20*(-b18*b22 + b2);
+        const Scalar b24 = Scalar(7)*b1;
+        const Scalar b25 = b2 - b23*b24;
+        const Scalar b26 = Scalar(8)*b1;
+        const Scalar b27 = Scalar(9)*b1;
+        const Scalar b28 = (Scalar(1.0 / 362880.0))*theta_sq;
+        const Scalar b29 = -Scalar(151200)*b2;
+        const Scalar b30 = b1*b13;
+        const Scalar b31 = Scalar(5040)*b2;
+        const Scalar b32 = -b14*b17 + b2;
+        const Scalar b33 = b1*(-b18*b32 + b2);
+        const Scalar b34 = -Scalar(90)*b2;
+        const Scalar b35 = b1*b25;
+        const Scalar b36 = b2 - b24*(-b19*b20 + b2);
+        const Scalar b37 = b2 - b26*b36;
+        const Scalar b38 = Scalar(10)*b1;
+        const Scalar b39 = theta_sq*(b2 - b38*(b2 - b27*b37));
+        const Scalar b40 = b2 - b26*(b2 - b23*b24);
+        const Scalar b41 = -Scalar(9)*b1*(b2 - b26*b36) + b2;
+        const Scalar b42 = Scalar(11)*b1;
+        imag_factor = (Scalar(1.0 / 185794560.0))*b0*theta_sq + Scalar(1.0 / 2.0);
+        real_factor = (Scalar(1.0 / 10321920.0))*theta_sq*(theta_sq*(theta_sq*(theta_sq + Scalar(-224)) + Scalar(26880)) + Scalar(-1290240)) + Scalar(1);
+        A = b1*(b28*(b3 + Scalar(181440)*b9 + theta_sq*(b10 - Scalar(15120)*b15 + theta_sq*(b16 + Scalar(504)*b21 + theta_sq*(b2 - b27*(b2 - b25*b26))))) + b6);
+        B = b1*((Scalar(1.0 / 2.0))*b2 - b7 + (Scalar(1.0 / 3628800.0))*theta_sq*(b29 + Scalar(604800)*b30 + theta_sq*(b31 - Scalar(30240)*b33 + theta_sq*(b34 + Scalar(720)*b35 + b39))));
+        C = b5;
+        imag_factor_dtheta = (Scalar(1.0 / 8174960640.0))*(theta_sq*(-theta_sq*(theta_sq*(theta_sq + Scalar(-352)) + Scalar(76032)) + Scalar(8515584)) + Scalar(-340623360));
+        real_factor_dtheta = -Scalar(1.0 / 371589120.0)*b0*theta_sq + Scalar(-1.0 / 4.0);
+        A_dsigma = b1*(b28*(b3 + Scalar(241920)*b30 + theta_sq*(b10 - Scalar(18144)*b33 + theta_sq*(b16 + Scalar(576)*b35 + b39))) + b8);
+        A_dtheta = b1*(-Scalar(1.0 / 3.0)*b2 + b9 + (Scalar(1.0 / 3991680.0))*theta_sq*(-Scalar(665280)*b15 + Scalar(133056)*b2 - theta_sq*(Scalar(4752)*b2 - Scalar(33264)*b21 + theta_sq*(Scalar(792)*b1*b40 - Scalar(88)*b2 + theta_sq*(b2 - b42*(b2 - b38*b41))))));
+        B_dsigma = (Scalar(1.0 / 3628800.0))*b1*(Scalar(1814400)*b2 - Scalar(5443200)*b9 + theta_sq*(Scalar(756000)*b1*b32 + b29 + theta_sq*(-Scalar(35280)*b1*(b2 - b20*(-b18*b22 + b2)) + b31 + theta_sq*(Scalar(810)*b1*b37 + b34 + theta_sq*(b2 - b42*(b2 - b38*(b2 - b27*b40)))))));
+        B_dtheta = (Scalar(1.0 / 239500800.0))*b1*(-Scalar(19958400)*b2 + Scalar(79833600)*b30 + theta_sq*(Scalar(1330560)*b2 - Scalar(7983360)*b33 - theta_sq*(Scalar(35640)*b2 - Scalar(285120)*b35 + theta_sq*(Scalar(5280)*b1*b41 - Scalar(528)*b2 + Scalar(5)*theta_sq*(-Scalar(12)*b1*(b2 + b42*(Scalar(10)*b1*(b2 - b27*b40) - b2)) + b2)))));
+        C_dsigma = b7;
+      }
+    } else {
+      const Scalar theta = sqrt(theta_sq);
+      if (abs(sigma) < generatedThreshold<Scalar>(0.0847523, 0.5)) {
+        const Scalar b0 = Scalar(1) / (theta);
+        const Scalar b1 = (Scalar(1.0 / 2.0))*theta;
+        const Scalar b2 = b0*sin(b1);
+        const Scalar b3 = cos(b1);
+        const Scalar b4 = Scalar(1) / (theta * theta);
+        const Scalar b5 = cos(theta);
+        const Scalar b6 = Scalar(40320)*b5;
+        const Scalar b7 = sin(theta);
+        const Scalar b8 = b0*b7;
+        const Scalar b9 = Scalar(20160)*b5;
+        const Scalar b10 = b5 + Scalar(-1);
+        const Scalar b11 = b0*b10;
+        const Scalar b12 = b11 + b7;
+        const Scalar b13 = b0*b12;
+        const Scalar b14 = Scalar(6720)*b5;
+        const Scalar b15 = -b8;
+        const Scalar b16 = b15 + b5;
+        const Scalar b17 = Scalar(2)*b0;
+        const Scalar b18 = b16*b17 + b7;
+        const Scalar b19 = b0*b18;
+        const Scalar b20 = Scalar(1680)*b5;
+        const Scalar b21 = b0*b10 + b7;
+        const Scalar b22 = Scalar(3)*b0;
+        const Scalar b23 = b0*(b22*(-b17*b21 + b5) + b7);
+        const Scalar b24 = Scalar(336)*b5;
+        const Scalar b25 = b16*b17 + b7;
+        const Scalar b26 = Scalar(4)*b0;
+        const Scalar b27 = b0*(b26*(-b22*b25 + b5) + b7);
+        const Scalar b28 = Scalar(56)*b5;
+        const Scalar b29 = -Scalar(2)*b0*b12 + b5;
+        const Scalar b30 = b22*b29 + b7;
+        const Scalar b31 = Scalar(5)*b0;
+        const Scalar b32 = b0*(b31*(-b26*b30 + b5) + b7);
+        const Scalar b33 = Scalar(8)*b5;
+        const Scalar b34 = -Scalar(3)*b0*b18 + b5;
+        const Scalar b35 = Scalar(4)*b0*b34 + b7;
+        const Scalar b36 = Scalar(6)*b0;
+        const Scalar b37 = b36*(-b31*b35 + b5) + b7;
+        const Scalar b38 = -Scalar(4)*b0*(b22*(-b17*b21 + b5) + b7) + b5;
+        const Scalar b39 = Scalar(7)*b0;
+        const Scalar b40 = b39*(b36*(-Scalar(5)*b0*b38 - b7) + b5) + b7;
+        const Scalar b41 = Scalar(8)*b0;
+        const Scalar b42 = -b40*b41 + b5;
+        const Scalar b43 = (Scalar(1.0 / 40320.0))*sigma;
+        const Scalar b44 = b22*b29 + b7;
+        const Scalar b45 = b0*b44;
+        const Scalar b46 = b26*b34 + b7;
+        const Scalar b47 = b0*b46;
+        const Scalar b48 = b31*b38 + b7;
+        const Scalar b49 = b0*b48;
+        const Scalar b50 = -b31*(b26*(-b22*b25 + b5) + b7) + b5;
+        const Scalar b51 = b36*b50 + b7;
+        const Scalar b52 = b0*b51;
+        const Scalar b53 = b39*(-b36*(b31*(-b26*b30 + b5) + b7) + b5) + b7;
+        const Scalar b54 = Scalar(72)*b0;
+        const Scalar b55 = b41*(-b37*b39 + b5) + b7;
+        const Scalar b56 = Scalar(9)*b0;
+        const Scalar b57 = (Scalar(1.0 / 362880.0))*sigma;
+        const Scalar b58 = b0*(b36*(-b31*b35 + b5) + b7);
+        const Scalar b59 = b0*b40;
+        const Scalar b60 = b41*(b39*(-Scalar(6)*b0*b50 - b7) + b5) + b7;
+        const Scalar b61 = Scalar(10)*b0;
+        const Scalar b62 = Scalar(9)*sigma;
+        imag_factor = b2;
+        real_factor = b3;
+        A = -b4*(b10 + b43*(b6 - Scalar(40320)*b8 + sigma*(-Scalar(40320)*b13 + b9 + sigma*(b14 - Scalar(20160)*b19 + sigma*(b20 - Scalar(6720)*b23 + sigma*(b24 - Scalar(1680)*b27 + sigma*(b28 - Scalar(336)*b32 + sigma*(-Scalar(56)*b0*b37 + b33 + b42*sigma))))))));
+        B = b4*(b15 + b57*(-Scalar(362880)*b13 + sigma*(-Scalar(181440)*b19 + sigma*(-Scalar(60480)*b45 + sigma*(-Scalar(15120)*b47 + sigma*(-Scalar(3024)*b49 + sigma*(-Scalar(504)*b52 + sigma*(-b53*b54 + sigma*(-b55*b56 + Scalar(1)) + Scalar(9)) + Scalar(72)) + Scalar(504)) + Scalar(3024)) + Scalar(15120)) + Scalar(60480)) + Scalar(181440)) + Scalar(1));
+        C = b57*(sigma*(sigma*(sigma*(sigma*(sigma*(sigma*(sigma + Scalar(9)) + Scalar(72)) + Scalar(504)) + Scalar(3024)) + Scalar(15120)) + Scalar(60480)) + Scalar(181440)) + Scalar(1);
+        imag_factor_dtheta = b4*(-b2 + (Scalar(1.0 / 2.0))*b3);
+        real_factor_dtheta = -Scalar(1.0 / 2.0)*b2;
+        A_dsigma = -b4*(b16 + b43*(-Scalar(80640)*b13 + b6 + sigma*(-Scalar(60480)*b19 + b9 + sigma*(b14 - Scalar(26880)*b23 + sigma*(b20 - Scalar(8400)*b27 + sigma*(b24 - Scalar(2016)*b32 + sigma*(b28 - Scalar(392)*b58 + sigma*(b33 - Scalar(64)*b59 + sigma*(b5 - b56*b60)))))))));
+        A_dtheta = (Scalar(2)*b11 + b43*(Scalar(120960)*b0*b16 + Scalar(40320)*b7 + sigma*(Scalar(80640)*b0*b29 + Scalar(20160)*b7 + sigma*(Scalar(33600)*b0*b34 + Scalar(6720)*b7 + sigma*(Scalar(10080)*b0*(-b26*b44 + b5) + Scalar(1680)*b7 + sigma*(Scalar(2352)*b0*(-b31*b46 + b5) + Scalar(336)*b7 + sigma*(Scalar(448)*b0*(-b36*b48 + b5) + Scalar(56)*b7 + sigma*(b54*(-b39*b51 + b5) + Scalar(8)*b7 + sigma*(b61*(-b41*b53 + b5) + b7)))))))) + b7)/(theta * theta * theta);
+        B_dsigma = b4*(-b13 + (Scalar(1.0 / 3628800.0))*sigma*(-Scalar(3628800)*b19 + sigma*(-Scalar(1814400)*b45 + sigma*(-Scalar(604800)*b47 + sigma*(-Scalar(151200)*b49 + sigma*(-Scalar(30240)*b52 + sigma*(-Scalar(5040)*b0*b53 + sigma*(-Scalar(720)*b0*b55 + b62*(-b61*(b42*b56 + b7) + Scalar(1)) + Scalar(80)) + Scalar(630)) + Scalar(4320)) + Scalar(25200)) + Scalar(120960)) + Scalar(453600)) + Scalar(1209600)) + Scalar(1.0 / 2.0));
+        B_dtheta = -(b5 + b57*(-Scalar(1451520)*b13 + Scalar(362880)*b5 + sigma*(-Scalar(907200)*b19 + Scalar(181440)*b5 + sigma*(-Scalar(362880)*b23 + Scalar(60480)*b5 + sigma*(-Scalar(105840)*b27 + Scalar(15120)*b5 + sigma*(-Scalar(24192)*b32 + Scalar(3024)*b5 + sigma*(Scalar(504)*b5 - Scalar(4536)*b58 + sigma*(Scalar(72)*b5 - Scalar(720)*b59 + sigma*(-Scalar(99)*b0*b60 + Scalar(9)*b5 + Scalar(2)) + Scalar(18)) + Scalar(144)) + Scalar(1008)) + Scalar(6048)) + Scalar(30240)) + Scalar(120960)) + Scalar(362880)) - Scalar(3)*b8 + Scalar(2))/(theta * theta * theta * theta);
+        C_dsigma = (Scalar(1.0 / 3628800.0))*sigma*(sigma*(sigma*(sigma*(sigma*(sigma*(sigma*(b62 + Scalar(80)) + Scalar(630)) + Scalar(4320)) + Scalar(25200)) + Scalar(120960)) + Scalar(453600)) + Scalar(1209600)) + Scalar(1.0 / 2.0);
+      } else {
+        const Scalar b0 = Scalar(1) / (theta);
+        const Scalar b1 = (Scalar(1.0 / 2.0))*theta;
+        const Scalar b2 = b0*sin(b1);
+        const Scalar b3 = cos(b1);
+        const Scalar b4 = (sqrt_scale * sqrt_scale);
+        const Scalar b5 = sin(theta);
+        const Scalar b6 = b5*sigma;
+        const Scalar b7 = cos(theta);
+        const Scalar b8 = b4*b7;
+        const Scalar b9 = b8 + Scalar(-1);
+        const Scalar b10 = b4*b6 - b9*theta;
+        const Scalar b11 = (sigma * sigma);
+        const Scalar b12 = (theta * theta);
+        const Scalar b13 = b11 + b12;
+        const Scalar b14 = Scalar(1) / (b13);
+        const Scalar b15 = b0*b14;
+        const Scalar b16 = Scalar(1) / (b12);
+        const Scalar b17 = Scalar(1) / (sigma);
+        const Scalar b18 = b4 + Scalar(-1);
+        const Scalar b19 = b17*b18;
+        const Scalar b20 = -b19;
+        const Scalar b21 = b4*b5*theta;
+        const Scalar b22 = b21 + b9*sigma;
+        const Scalar b23 = b14*b22 + b20;
+        const Scalar b24 = b7*theta;
+        const Scalar b25 = Scalar(2)*b10*b14;
+        const Scalar b26 = b21 + b8*sigma;
+        imag_factor = b2;
+        real_factor = b3;
+        A = b10*b15;
+        B = -b16*b23;
+        C = b19;
+        imag_factor_dtheta = b16*(-b2 + (Scalar(1.0 / 2.0))*b3);
+        real_factor_dtheta = -Scalar(1.0 / 2.0)*b2;
+        A_dsigma = b15*(-b25*sigma + b4*(-b24 + b5 + b6));
+        A_dtheta = -b15*(-b0*(b26 - b8 + Scalar(1)) + b10*b16 + b25);
+        B_dsigma = b16*(-b14*(b26 + b9) + b17*b4 + Scalar(2)*b22*sigma/(b13 * b13) - b18/b11);
+        B_dtheta = (Scalar(2)*b0*b23 + b14*(Scalar(2)*b14*b22*theta - b4*(b24 + b5 - b6)))/(theta * theta * theta);
+        C_dsigma = b17*(b20 + b4);
+      }
+    }
+
+    ParameterJacobian res;
+    const Scalar t0 = (a3 * a3);
+    const Scalar t1 = imag_factor_dtheta*sqrt_scale;
+    const Scalar t2 = a3*t1;
+    const Scalar t3 = a4*t2;
+    const Scalar t4 = a5*t2;
+    const Scalar t5 = (Scalar(1.0 / 2.0))*exp((Scalar(1.0 / 2.0))*sigma);
+    const Scalar t6 = imag_factor*t5;
+    const Scalar t7 = (a4 * a4);
+    const Scalar t8 = a4*a5;
+    const Scalar t9 = t1*t8;
+    const Scalar t10 = (a5 * a5);
+    const Scalar t11 = real_factor_dtheta*sqrt_scale;
+    const Scalar t12 = -C;
+    const Scalar t13 = A*a5;
+    const Scalar t14 = A*a4;
+    const Scalar t15 = B*a3;
+    const Scalar t16 = a1*a4;
+    const Scalar t17 = a2*a5;
+    const Scalar t18 = a1*a5;
+    const Scalar t19 = a2*a4;
+    const Scalar t20 = -t19;
+    const Scalar t21 = t18 + t20;
+    const Scalar t22 = a0*a4;
+    const Scalar t23 = a1*a3;
+    const Scalar t24 = -t23;
+    const Scalar t25 = t22 + t24;
+    const Scalar t26 = a4*t25;
+    const Scalar t27 = a0*a5;
+    const Scalar t28 = a2*a3;
+    const Scalar t29 = -t28;
+    const Scalar t30 = t27 + t29;
+    const Scalar t31 = a5*t30;
+    const Scalar t32 = t26 + t31;
+    const Scalar t33 = B_dtheta*t32;
+    const Scalar t34 = A*a2;
+    const Scalar t35 = a4*t21;
+    const Scalar t36 = A*a1;
+    const Scalar t37 = A*a3;
+    const Scalar t38 = B_dtheta*a3;
+    const Scalar t39 = a0*a3;
+    const Scalar t40 = a3*t25;
+    const Scalar t41 = a5*t21 - t40;
+    const Scalar t42 = B_dtheta*t41;
+    const Scalar t43 = A*a0;
+    const Scalar t44 = a3*t30 + t35;
+    res(0, 0) = Scalar(0);
+    res(0, 1) = Scalar(0);
+    res(0, 2) = Scalar(0);
+    res(0, 3) = sqrt_scale*(imag_factor + imag_factor_dtheta*t0);
+    res(0, 4) = t3;
+    res(0, 5) = t4;
+    res(0, 6) = a3*t6;
+    res(1, 0) = Scalar(0);
+    res(1, 1) = Scalar(0);
+    res(1, 2) = Scalar(0);
+    res(1, 3) = t3;
+    res(1, 4) = sqrt_scale*(imag_factor + imag_factor_dtheta*t7);
+    res(1, 5) = t9;
+    res(1, 6) = a4*t6;
+    res(2, 0) = Scalar(0);
+    res(2, 1) = Scalar(0);
+    res(2, 2) = Scalar(0);
+    res(2, 3) = t4;
+    res(2, 4) = t9;
+    res(2, 5) = sqrt_scale*(imag_factor + imag_factor_dtheta*t10);
+    res(2, 6) = a5*t6;
+    res(3, 0) = Scalar(0);
+    res(3, 1) = Scalar(0);
+    res(3, 2) = Scalar(0);
+    res(3, 3) = a3*t11;
+    res(3, 4) = a4*t11;
+    res(3, 5) = a5*t11;
+    res(3, 6) = real_factor*t5;
+    res(4, 0) = -B*(t10 + t7) - t12;
+    res(4, 1) = B*a3*a4 - t13;
+    res(4, 2) = a5*t15 + t14;
+    res(4, 3) = -A_dtheta*a3*t21 + B*(t16 + t17) - a3*t33;
+    res(4, 4) = -A_dtheta*t35 - B*(Scalar(2)*t22 + t24) - a4*t33 + t34;
+    res(4, 5) = -A_dtheta*a5*t21 - B*(Scalar(2)*t27 + t29) - a5*t33 - t36;
+    res(4, 6) = -A_dsigma*t21 - B_dsigma*t32 + C_dsigma*a0;
+    res(5, 0) = a4*t15 + t13;
+    res(5, 1) = -B*(t0 + t10) - t12;
+    res(5, 2) = B*a4*a5 - t37;
+    res(5, 3) = A_dtheta*a3*t30 + B*(t22 - Scalar(2)*t23) - t34 - t38*(-a3*t25 + a5*t21);
+    res(5, 4) = A_dtheta*a4*t30 + B*(t17 + t39) - a4*t42;
+    res(5, 5) = A_dtheta*t31 - B*(Scalar(2)*t18 + t20) - a5*t42 + t43;
+    res(5, 6) = A_dsigma*t30 - B_dsigma*t41 + C_dsigma*a1;
+    res(6, 0) = B*a3*a5 - t14;
+    res(6, 1) = B*t8 + t37;
+    res(6, 2) = -B*(t0 + t7) - t12;
+    res(6, 3) = -A_dtheta*t40 + B*(t27 - Scalar(2)*t28) + t36 + t38*t44;
+    res(6, 4) = -A_dtheta*t26 + B*(t18 - Scalar(2)*t19) + B_dtheta*a4*t44 - t43;
+    res(6, 5) = -A_dtheta*a5*t25 + B*(t16 + t39) + B_dtheta*a5*t44;
+    res(6, 6) = -A_dsigma*t25 + B_dsigma*t44 + C_dsigma*a2;
+    return res;
+  }
+
+  /**
+   * Derivative of log(p) with respect to the parameters p
+   */
+  inline static LogJacobian Dx_log(const Parameters& p) {
+    using std::abs;
+    using std::atan;
+    using std::atan2;
+    using std::cos;
+    using std::exp;
+    using std::log;
+    using std::sin;
+    using std::sqrt;
+    using std::tan;
+
+    const Scalar p0 = p[0];
+    const Scalar p1 = p[1];
+    const Scalar p2 = p[2];
+    const Scalar p3 = p[3];
+    const Scalar p4 = p[4];
+    const Scalar p5 = p[5];
+    const Scalar p6 = p[6];
+    Scalar k, k_dn, k_dp3;
+    const Scalar n_sq = (p0 * p0) + (p1 * p1) + (p2 * p2);
+    if (n_sq < generatedThreshold<Scalar>(0.000693461, 0.0386364) * ((p3 * p3))) {
+      const Scalar b0 = Scalar(1) / (p3 * p3);
+      const Scalar b1 = b0*n_sq;
+      const Scalar b2 = Scalar(7)*b1;
+      const Scalar b3 = Scalar(5)*b1;
+      k = Scalar(2)*((Scalar(1.0 / 315.0))*b1*(b1*(b3*(b2 + Scalar(-9)) + Scalar(63)) + Scalar(-105)) + Scalar(1))/p3;
+      k_dn = (Scalar(4.0 / 3465.0))*(b1*(-b3*(b2*(Scalar(45)*b1 + Scalar(-44)) + Scalar(297)) + Scalar(1386)) + Scalar(-1155))/(p3 * p3 * p3);
+      k_dp3 = Scalar(2)*b0*(b1*(-b1*(b1*(b1 + Scalar(-1)) + Scalar(1)) + Scalar(1)) + Scalar(-1));
+    } else {
+      const Scalar n = sqrt(n_sq);
+      if (abs(p3) < SophusConstants<Scalar>::epsilon()) {
+        if (p3 > Scalar(0)) {
+          k = SophusConstants<Scalar>::pi()/n;
+          k_dn = -SophusConstants<Scalar>::pi()/(n * n * n);
+          k_dp3 = -Scalar(2)/(n * n);
+        } else {
+          k = -SophusConstants<Scalar>::pi()/n;
+          k_dn = SophusConstants<Scalar>::pi()/(n * n * n);
+          k_dp3 = -Scalar(2)/(n * n);
+        }
+      } else {
+        const Scalar b0 = Scalar(1) / (p3);
+        const Scalar b1 = atan(b0*n)/n;
+        const Scalar b2 = (n * n);
+        const Scalar b3 = Scalar(1) / (p3 * p3);
+        const Scalar b4 = Scalar(1) / ((b2*b3 + Scalar(1)));
+        k = Scalar(2)*b1;
+        k_dn = Scalar(2)*(b0*b4 - b1)/b2;
+        k_dp3 = -Scalar(2)*b3*b4;
+      }
+    }
+    const Scalar scale = (p0 * p0) + (p1 * p1) + (p2 * p2) + (p3 * p3);
+    const Scalar sigma = log(scale);
+    Scalar A, B, C, A_dsigma, A_dtheta, B_dsigma, B_dtheta, C_dsigma;
+    const Scalar theta_sq = (k * k)*((p0 * p0) + (p1 * p1) + (p2 * p2));
+    if (theta_sq < generatedThreshold<Scalar>(0.0328764, 0.25)) {
+      if (abs(sigma) < generatedThreshold<Scalar>(0.0847523, 0.5)) {
+        const Scalar b0 = theta_sq*(theta_sq*(theta_sq*(theta_sq + Scalar(-88)) + Scalar(4752)) + Scalar(-133056));
+        const Scalar b1 = Scalar(5)*theta_sq;
+        const Scalar b2 = theta_sq*(theta_sq*(theta_sq*(b1 + Scalar(-432)) + Scalar(22680)) + Scalar(-604800));
+        const Scalar b3 = Scalar(11)*theta_sq;
+        const Scalar b4 = theta_sq*(theta_sq*(theta_sq*(b3 + Scalar(-936)) + Scalar(48048)) + Scalar(-1235520));
+        const Scalar b5 = theta_sq*(theta_sq*(b1*(theta_sq + Scalar(-84)) + Scalar(21168)) + Scalar(-529200));
+        const Scalar b6 = Scalar(13)*theta_sq;
+        const Scalar b7 = theta_sq*(theta_sq*(b3*(b6 + Scalar(-1080)) + Scalar(589680)) + Scalar(-14414400));
+        const Scalar b8 = Scalar(7)*theta_sq;
+        const Scalar b9 = theta_sq*(theta_sq*(theta_sq*(b8 + Scalar(-576)) + Scalar(28224)) + Scalar(-677376));
+        const Scalar b10 = theta_sq*(theta_sq*(theta_sq*(theta_sq + Scalar(-81)) + Scalar(3888)) + Scalar(-90720));
+        const Scalar b11 = theta_sq*(b3*(b6*(b1 + Scalar(-408)) + Scalar(257040)) + Scalar(-66830400));
+        const Scalar b12 = theta_sq*(theta_sq*(theta_sq*(theta_sq + Scalar(-108)) + Scalar(7560)) + Scalar(-302400));
+        const Scalar b13 = theta_sq*(theta_sq*(theta_sq*(b3 + Scalar(-1170)) + Scalar(80080)) + Scalar(-3088800));
+        const Scalar b14 = theta_sq*(theta_sq*(theta_sq*(theta_sq + Scalar(-105)) + Scalar(7056)) + Scalar(-264600));
+        const Scalar b15 = theta_sq*(theta_sq*(b3*(b6 + Scalar(-1350)) + Scalar(982800)) + Scalar(-36036000));
+        const Scalar b16 = theta_sq*(theta_sq*(theta_sq*(b8 + Scalar(-720)) + Scalar(47040)) + Scalar(-1693440));
+        const Scalar b17 = theta_sq*(b3*(b6*(theta_sq + Scalar(-102)) + Scalar(85680)) + Scalar(-33415200));
+        const Scalar b18 = theta_sq*(theta_sq*(theta_sq*(Scalar(4)*theta_sq + Scalar(-405)) + Scalar(25920)) + Scalar(-907200));
+        const Scalar b19 = Scalar(17)*theta_sq;
+        const Scalar b20 = b6*(theta_sq*(b19 + Scalar(-1710)) + Scalar(108528)) + Scalar(-48837600);
+        const Scalar b21 = Scalar(9)*sigma;
+        const Scalar b22 = Scalar(3)*theta_sq;
+        A = (Scalar(1.0 / 3201186852864000.0))*sigma*(Scalar(801964800)*b0 + sigma*(Scalar(73513440)*b2 + sigma*(Scalar(10281600)*b4 + sigma*(Scalar(5250960)*b5 + sigma*(Scalar(34272)*b7 + sigma*(Scalar(109395)*b9 + sigma*(Scalar(144)*b11 + Scalar(12155)*sigma*(b10 + Scalar(653184)) + Scalar(70572902400)) + Scalar(555761606400)) + Scalar(3810936729600)) + Scalar(22230464256000)) + Scalar(106706228428800)) + Scalar(400148356608000)) + Scalar(1067062284288000)) + (Scalar(1.0 / 3628800.0))*theta_sq*(theta_sq*(theta_sq*(theta_sq + Scalar(-90)) + Scalar(5040)) + Scalar(-151200)) + Scalar(1.0 / 2.0);
+        B = (Scalar(1.0 / 60822550204416000.0))*sigma*(Scalar(1396755360)*b12 + sigma*(Scalar(58605120)*b13 + sigma*(Scalar(199536480)*b14 + sigma*(Scalar(325584)*b15 + sigma*(Scalar(1247103)*b16 + sigma*(Scalar(9576)*b17 + sigma*(Scalar(46189)*b18 + b21*(b20*b3 + Scalar(7618665600)) + Scalar(603398315520)) + Scalar(4693098009600)) + Scalar(31678411564800)) + Scalar(181019494656000)) + Scalar(844757641728000)) + Scalar(3041127510220800)) + Scalar(7602818775552000)) + (Scalar(1.0 / 39916800.0))*theta_sq*(theta_sq*(theta_sq*(theta_sq + Scalar(-110)) + Scalar(7920)) + Scalar(-332640)) + Scalar(1.0 / 6.0);
+        C = (Scalar(1.0 / 362880.0))*sigma*(sigma*(sigma*(sigma*(sigma*(sigma*(sigma*(sigma + Scalar(9)) + Scalar(72)) + Scalar(504)) + Scalar(3024)) + Scalar(15120)) + Scalar(60480)) + Scalar(181440)) + Scalar(1);
+        A_dsigma = (Scalar(1.0 / 3991680.0))*b0 + (Scalar(1.0 / 30411275102208000.0))*sigma*(Scalar(1396755360)*b2 + sigma*(Scalar(293025600)*b4 + sigma*(Scalar(199536480)*b5 + sigma*(Scalar(1627920)*b7 + sigma*(Scalar(6235515)*b9 + sigma*(Scalar(9576)*b11 + sigma*(Scalar(923780)*b10 + b21*(b3*(b6*(b1*(b19 + Scalar(-1368)) + Scalar(325584)) + Scalar(-97675200)) + Scalar(7618665600)) + Scalar(603398315520)) + Scalar(4693098009600)) + Scalar(31678411564800)) + Scalar(181019494656000)) + Scalar(844757641728000)) + Scalar(3041127510220800)) + Scalar(7602818775552000)) + Scalar(1.0 / 3.0);
+        A_dtheta = (Scalar(1.0 / 121645100408832000.0))*sigma*(sigma*(sigma*(sigma*(sigma*(sigma*(sigma*(Scalar(4199)*sigma*(theta_sq*(-theta_sq*(theta_sq*(Scalar(9)*theta_sq + Scalar(-880)) + Scalar(53460)) + Scalar(1710720)) + Scalar(-19958400)) + Scalar(288)*theta_sq*(-b6*(b1*(b19 + Scalar(-1672)) + Scalar(511632)) + Scalar(214885440)) + Scalar(-731391897600)) + Scalar(335920)*theta_sq*(-theta_sq*(b8*(theta_sq + Scalar(-99)) + Scalar(42768)) + Scalar(1397088)) + Scalar(-5631717611520)) + Scalar(76608)*theta_sq*(-theta_sq*(b6*(Scalar(15)*theta_sq + Scalar(-1496)) + Scalar(1211760)) + Scalar(40098240)) + Scalar(-37544784076800)) + Scalar(2267460)*theta_sq*(-b1*(theta_sq*(b8 + Scalar(-704)) + Scalar(44352)) + Scalar(7451136)) + Scalar(-211189410432000)) + Scalar(26046720)*theta_sq*(-theta_sq*(theta_sq*(b6 + Scalar(-1320)) + Scalar(84240)) + Scalar(2882880)) + Scalar(-965437304832000)) + Scalar(72558720)*theta_sq*(-theta_sq*(b1*(b22 + Scalar(-308)) + Scalar(99792)) + Scalar(3492720)) + Scalar(-3379030566912000)) + Scalar(2344204800)*theta_sq*(-theta_sq*(theta_sq*(theta_sq + Scalar(-104)) + Scalar(6864)) + Scalar(247104)) + Scalar(-8109673360588800)) + (Scalar(1.0 / 239500800.0))*theta_sq*(-theta_sq*(theta_sq*(b1 + Scalar(-528)) + Scalar(35640)) + Scalar(1330560)) + Scalar(-1.0 / 12.0);
+        B_dsigma = (Scalar(1.0 / 43545600.0))*b12 + (Scalar(1.0 / 1216451004088320000.0))*sigma*(Scalar(2344204800)*b13 + sigma*(Scalar(11972188800)*b14 + sigma*(Scalar(26046720)*b15 + sigma*(Scalar(124710300)*b16 + sigma*(Scalar(1149120)*b17 + sigma*(Scalar(6466460)*b18 + b21*(Scalar(1760)*b20*theta_sq + Scalar(46189)*sigma*(theta_sq*(theta_sq*(theta_sq*(theta_sq + Scalar(-100)) + Scalar(6300)) + Scalar(-216000)) + Scalar(3024000)) + Scalar(1218986496000)) + Scalar(84475764172800)) + Scalar(563171761152000)) + Scalar(3167841156480000)) + Scalar(14481559572480000)) + Scalar(50685458503680000)) + Scalar(121645100408832000)) + Scalar(1.0 / 8.0);
+        B_dtheta = (Scalar(1.0 / 851515702861824000.0))*sigma*(sigma*(sigma*(sigma*(sigma*(sigma*(sigma*(sigma*(b6*(-theta_sq*(b19*(Scalar(95)*theta_sq + Scalar(-11088)) + Scalar(14220360)) + Scalar(601679232)) + Scalar(-135377827200)) + Scalar(58786)*theta_sq*(-theta_sq*(theta_sq*(b22 + Scalar(-352)) + Scalar(26730)) + Scalar(1140480)) + Scalar(-1173274502400)) + Scalar(1176)*theta_sq*(-b6*(theta_sq*(Scalar(85)*theta_sq + Scalar(-10032)) + Scalar(767448)) + Scalar(429770880)) + Scalar(-8959550745600)) + Scalar(235144)*theta_sq*(-theta_sq*(b8*(b1 + Scalar(-594)) + Scalar(320760)) + Scalar(13970880)) + Scalar(-59133034920960)) + Scalar(134064)*theta_sq*(-theta_sq*(b6*(Scalar(25)*theta_sq + Scalar(-2992)) + Scalar(3029400)) + Scalar(133660800)) + Scalar(-328516860672000)) + Scalar(5290740)*theta_sq*(-theta_sq*(theta_sq*(Scalar(35)*theta_sq + Scalar(-4224)) + Scalar(332640)) + Scalar(14902272)) + Scalar(-1478325873024000)) + Scalar(45581760)*theta_sq*(-theta_sq*(theta_sq*(b6 + Scalar(-1584)) + Scalar(126360)) + Scalar(5765760)) + Scalar(-5068545850368000)) + Scalar(253955520)*theta_sq*(-theta_sq*(theta_sq*(b1 + Scalar(-616)) + Scalar(49896)) + Scalar(2328480)) + Scalar(-11826606984192000)) + (Scalar(1.0 / 3113510400.0))*theta_sq*(-theta_sq*(theta_sq*(b1 + Scalar(-624)) + Scalar(51480)) + Scalar(2471040)) + Scalar(-1.0 / 60.0);
+        C_dsigma = (Scalar(1.0 / 3628800.0))*sigma*(sigma*(sigma*(sigma*(sigma*(sigma*(sigma*(b21 + Scalar(80)) + Scalar(630)) + Scalar(4320)) + Scalar(25200)) + Scalar(120960)) + Scalar(453600)) + Scalar(1209600)) + Scalar(1.0 / 2.0);
+      } else {
+        const Scalar b0 = Scalar(1) / (sigma);
+        const Scalar b1 = -Scalar(60480)*scale;
+        const Scalar b2 = scale + Scalar(-1);
+        const Scalar b3 = b0*b2;
+        const Scalar b4 = -b3 + scale;
+        const Scalar b5 = b0*b4;
+        const Scalar b6 = -Scalar(2)*b5 + scale;
+        const Scalar b7 = b0*b6;
+        const Scalar b8 = Scalar(3024)*scale;
+        const Scalar b9 = -Scalar(2)*b0*(-b0*b2 + scale) + scale;
+        const Scalar b10 = Scalar(3)*b0;
+        const Scalar b11 = -b10*b9 + scale;
+        const Scalar b12 = Scalar(4)*b0;
+        const Scalar b13 = b0*(-b11*b12 + scale);
+        const Scalar b14 = -Scalar(72)*scale;
+        const Scalar b15 = -Scalar(3)*b0*(-Scalar(2)*b0*b4 + scale) + scale;
+        const Scalar b16 = Scalar(5)*b0;
+        const Scalar b17 = -b16*(-b12*b15 + scale) + scale;
+        const Scalar b18 = Scalar(6)*b0;
+        const Scalar b19 = b0*(-b17*b18 + scale);
+        const Scalar b20 = -Scalar(4)*b0*(-b10*b9 + scale) + scale;
+        const Scalar b21 = -b18*(-b16*b20 + scale) + scale;
+        const Scalar b22 = Scalar(7)*b0;
+        const Scalar b23 = -b21*b22 + scale;
+        const Scalar b24 = Scalar(8)*b0;
+        const Scalar b25 = Scalar(9)*b0;
+        const Scalar b26 = (Scalar(1.0 / 362880.0))*theta_sq;
+        const Scalar b27 = -Scalar(151200)*scale;
+        const Scalar b28 = b0*b11;
+        const Scalar b29 = Scalar(5040)*scale;
+        const Scalar b30 = -b12*b15 + scale;
+        const Scalar b31 = b0*(-b16*b30 + scale);
+        const Scalar b32 = -Scalar(90)*scale;
+        const Scalar b33 = b0*b23;
+        const Scalar b34 = -b22*(-b17*b18 + scale) + scale;
+        const Scalar b35 = -b24*b34 + scale;
+        const Scalar b36 = Scalar(10)*b0;
+        const Scalar b37 = theta_sq*(-b36*(-b25*b35 + scale) + scale);
+        const Scalar b38 = -b24*(-b21*b22 + scale) + scale;
+        const Scalar b39 = -Scalar(9)*b0*(-b24*b34 + scale) + scale;
+        const Scalar b40 = Scalar(11)*b0;
+        A = b0*(b26*(b1 + Scalar(181440)*b7 + theta_sq*(-Scalar(15120)*b13 + b8 + theta_sq*(b14 + Scalar(504)*b19 + theta_sq*(-b25*(-b23*b24 + scale) + scale)))) + b4);
+        B = b0*(-b5 + (Scalar(1.0 / 2.0))*scale + (Scalar(1.0 / 3628800.0))*theta_sq*(b27 + Scalar(604800)*b28 + theta_sq*(b29 - Scalar(30240)*b31 + theta_sq*(b32 + Scalar(720)*b33 + b37))));
+        C = b3;
+        A_dsigma = b0*(b26*(b1 + Scalar(241920)*b28 + theta_sq*(-Scalar(18144)*b31 + b8 + theta_sq*(b14 + Scalar(576)*b33 + b37))) + b6);
+        A_dtheta = b0*(b7 - Scalar(1.0 / 3.0)*scale + (Scalar(1.0 / 3991680.0))*theta_sq*(-Scalar(665280)*b13 + Scalar(133056)*scale - theta_sq*(-Scalar(33264)*b19 + Scalar(4752)*scale + theta_sq*(Scalar(792)*b0*b38 - Scalar(88)*scale + theta_sq*(-b40*(-b36*b39 + scale) + scale)))));
+        B_dsigma = (Scalar(1.0 / 3628800.0))*b0*(-Scalar(5443200)*b7 + Scalar(1814400)*scale + theta_sq*(Scalar(756000)*b0*b30 + b27 + theta_sq*(-Scalar(35280)*b0*(-b18*(-b16*b20 + scale) + scale) + b29 + theta_sq*(Scalar(810)*b0*b35 + b32 + theta_sq*(-b40*(-b36*(-b25*b38 + scale) + scale) + scale)))));
+        B_dtheta = (Scalar(1.0 / 239500800.0))*b0*(Scalar(79833600)*b28 - Scalar(19958400)*scale + theta_sq*(-Scalar(7983360)*b31 + Scalar(1330560)*scale - theta_sq*(-Scalar(285120)*b33 + Scalar(35640)*scale + theta_sq*(Scalar(5280)*b0*b39 - Scalar(528)*scale + Scalar(5)*theta_sq*(-Scalar(12)*b0*(b40*(Scalar(10)*b0*(-b25*b38 + scale) - scale) + scale) + scale)))));
+        C_dsigma = b5;
+      }
+    } else {
+      const Scalar theta = sqrt(theta_sq);
+      if (abs(sigma) < generatedThreshold<Scalar>(0.0847523, 0.5)) {
+        const Scalar b0 = Scalar(1) / (theta * theta);
+        const Scalar b1 = cos(theta);
+        const Scalar b2 = Scalar(40320)*b1;
+        const Scalar b3 = sin(theta);
+        const Scalar b4 = Scalar(1) / (theta);
+        const Scalar b5 = b3*b4;
+        const Scalar b6 = Scalar(20160)*b1;
+        const Scalar b7 = b1 + Scalar(-1);
+        const Scalar b8 = b4*b7;
+        const Scalar b9 = b3 + b8;
+        const Scalar b10 = b4*b9;
+        const Scalar b11 = Scalar(6720)*b1;
+        const Scalar b12 = -b5;
+        const Scalar b13 = b1 + b12;
+        const Scalar b14 = Scalar(2)*b4;
+        const Scalar b15 = b13*b14 + b3;
+        const Scalar b16 = b15*b4;
+        const Scalar b17 = Scalar(1680)*b1;
+        const Scalar b18 = b3 + b4*b7;
+        const Scalar b19 = Scalar(3)*b4;
+        const Scalar b20 = b4*(b19*(b1 - b14*b18) + b3);
+        const Scalar b21 = Scalar(336)*b1;
+        const Scalar b22 = b13*b14 + b3;
+        const Scalar b23 = Scalar(4)*b4;
+        const Scalar b24 = b4*(b23*(b1 - b19*b22) + b3);
+        const Scalar b25 = Scalar(56)*b1;
+        const Scalar b26 = b1 - Scalar(2)*b4*b9;
+        const Scalar b27 = b19*b26 + b3;
+        const Scalar b28 = Scalar(5)*b4;
+        const Scalar b29 = b4*(b28*(b1 - b23*b27) + b3);
+        const Scalar b30 = Scalar(8)*b1;
+        const Scalar b31 = b1 - Scalar(3)*b15*b4;
+        const Scalar b32 = b3 + Scalar(4)*b31*b4;
+        const Scalar b33 = Scalar(6)*b4;
+        const Scalar b34 = b3 + b33*(b1 - b28*b32);
+        const Scalar b35 = b1 - Scalar(4)*b4*(b19*(b1 - b14*b18) + b3);
+        const Scalar b36 = Scalar(7)*b4;
+        const Scalar b37 = b3 + b36*(b1 + b33*(-b3 - Scalar(5)*b35*b4));
+        const Scalar b38 = Scalar(8)*b4;
+        const Scalar b39 = b1 - b37*b38;
+        const Scalar b40 = (Scalar(1.0 / 40320.0))*sigma;
+        const Scalar b41 = b19*b26 + b3;
+        const Scalar b42 = b4*b41;
+        const Scalar b43 = b23*b31 + b3;
+        const Scalar b44 = b4*b43;
+        const Scalar b45 = b28*b35 + b3;
+        const Scalar b46 = b4*b45;
+        const Scalar b47 = b1 - b28*(b23*(b1 - b19*b22) + b3);
+        const Scalar b48 = b3 + b33*b47;
+        const Scalar b49 = b4*b48;
+        const Scalar b50 = b3 + b36*(b1 - b33*(b28*(b1 - b23*b27) + b3));
+        const Scalar b51 = Scalar(72)*b4;
+        const Scalar b52 = b3 + b38*(b1 - b34*b36);
+        const Scalar b53 = Scalar(9)*b4;
+        const Scalar b54 = (Scalar(1.0 / 362880.0))*sigma;
+        const Scalar b55 = b4*(b3 + b33*(b1 - b28*b32));
+        const Scalar b56 = b37*b4;
+        const Scalar b57 = b3 + b38*(b1 + b36*(-b3 - Scalar(6)*b4*b47));
+        const Scalar b58 = Scalar(10)*b4;
+        const Scalar b59 = Scalar(9)*sigma;
+        A = -b0*(b40*(b2 - Scalar(40320)*b5 + sigma*(-Scalar(40320)*b10 + b6 + sigma*(b11 - Scalar(20160)*b16 + sigma*(b17 - Scalar(6720)*b20 + sigma*(b21 - Scalar(1680)*b24 + sigma*(b25 - Scalar(336)*b29 + sigma*(b30 - Scalar(56)*b34*b4 + b39*sigma))))))) + b7);
+        B = b0*(b12 + b54*(-Scalar(362880)*b10 + sigma*(-Scalar(181440)*b16 + sigma*(-Scalar(60480)*b42 + sigma*(-Scalar(15120)*b44 + sigma*(-Scalar(3024)*b46 + sigma*(-Scalar(504)*b49 + sigma*(-b50*b51 + sigma*(-b52*b53 + Scalar(1)) + Scalar(9)) + Scalar(72)) + Scalar(504)) + Scalar(3024)) + Scalar(15120)) + Scalar(60480)) + Scalar(181440)) + Scalar(1));
+        C = b54*(sigma*(sigma*(sigma*(sigma*(sigma*(sigma*(sigma + Scalar(9)) + Scalar(72)) + Scalar(504)) + Scalar(3024)) + Scalar(15120)) + Scalar(60480)) + Scalar(181440)) + Scalar(1);
+        A_dsigma = -b0*(b13 + b40*(-Scalar(80640)*b10 + b2 + sigma*(-Scalar(60480)*b16 + b6 + sigma*(b11 - Scalar(26880)*b20 + sigma*(b17 - Scalar(8400)*b24 + sigma*(b21 - Scalar(2016)*b29 + sigma*(b25 - Scalar(392)*b55 + sigma*(b30 - Scalar(64)*b56 + sigma*(b1 - b53*b57)))))))));
+        A_dtheta = (b3 + b40*(Scalar(120960)*b13*b4 + Scalar(40320)*b3 + sigma*(Scalar(80640)*b26*b4 + Scalar(20160)*b3 + sigma*(Scalar(6720)*b3 + Scalar(33600)*b31*b4 + sigma*(Scalar(1680)*b3 + Scalar(10080)*b4*(b1 - b23*b41) + sigma*(Scalar(336)*b3 + Scalar(2352)*b4*(b1 - b28*b43) + sigma*(Scalar(56)*b3 + Scalar(448)*b4*(b1 - b33*b45) + sigma*(Scalar(8)*b3 + b51*(b1 - b36*b48) + sigma*(b3 + b58*(b1 - b38*b50))))))))) + Scalar(2)*b8)/(theta * theta * theta);
+        B_dsigma = b0*(-b10 + (Scalar(1.0 / 3628800.0))*sigma*(-Scalar(3628800)*b16 + sigma*(-Scalar(1814400)*b42 + sigma*(-Scalar(604800)*b44 + sigma*(-Scalar(151200)*b46 + sigma*(-Scalar(30240)*b49 + sigma*(-Scalar(5040)*b4*b50 + sigma*(-Scalar(720)*b4*b52 + b59*(-b58*(b3 + b39*b53) + Scalar(1)) + Scalar(80)) + Scalar(630)) + Scalar(4320)) + Scalar(25200)) + Scalar(120960)) + Scalar(453600)) + Scalar(1209600)) + Scalar(1.0 / 2.0));
+        B_dtheta = -(b1 - Scalar(3)*b5 + b54*(Scalar(362880)*b1 - Scalar(1451520)*b10 + sigma*(Scalar(181440)*b1 - Scalar(907200)*b16 + sigma*(Scalar(60480)*b1 - Scalar(362880)*b20 + sigma*(Scalar(15120)*b1 - Scalar(105840)*b24 + sigma*(Scalar(3024)*b1 - Scalar(24192)*b29 + sigma*(Scalar(504)*b1 - Scalar(4536)*b55 + sigma*(Scalar(72)*b1 - Scalar(720)*b56 + sigma*(Scalar(9)*b1 - Scalar(99)*b4*b57 + Scalar(2)) + Scalar(18)) + Scalar(144)) + Scalar(1008)) + Scalar(6048)) + Scalar(30240)) + Scalar(120960)) + Scalar(362880)) + Scalar(2))/(theta * theta * theta * theta);
+        C_dsigma = (Scalar(1.0 / 3628800.0))*sigma*(sigma*(sigma*(sigma*(sigma*(sigma*(sigma*(b59 + Scalar(80)) + Scalar(630)) + Scalar(4320)) + Scalar(25200)) + Scalar(120960)) + Scalar(453600)) + Scalar(1209600)) + Scalar(1.0 / 2.0);
+      } else {
+        const Scalar b0 = sin(theta);
+        const Scalar b1 = b0*sigma;
+        const Scalar b2 = cos(theta);
+        const Scalar b3 = b2*scale;
+        const Scalar b4 = b3 + Scalar(-1);
+        const Scalar b5 = b1*scale - b4*theta;
+        const Scalar b6 = (sigma * sigma);
+        const Scalar b7 = (theta * theta);
+        const Scalar b8 = b6 + b7;
+        const Scalar b9 = Scalar(1) / (b8);
+        const Scalar b10 = Scalar(1) / (theta);
+        const Scalar b11 = b10*b9;
+        const Scalar b12 = Scalar(1) / (b7);
+        const Scalar b13 = Scalar(1) / (sigma);
+        const Scalar b14 = scale + Scalar(-1);
+        const Scalar b15 = b13*b14;
+        const Scalar b16 = -b15;
+        const Scalar b17 = b0*scale*theta;
+        const Scalar b18 = b17 + b4*sigma;
+        const Scalar b19 = b16 + b18*b9;
+        const Scalar b20 = b2*theta;
+        const Scalar b21 = Scalar(2)*b5*b9;
+        const Scalar b22 = b17 + b3*sigma;
+        A = b11*b5;
+        B = -b12*b19;
+        C = b15;
+        A_dsigma = b11*(-b21*sigma + scale*(b0 + b1 - b20));
+        A_dtheta = -b11*(-b10*(b22 - b3 + Scalar(1)) + b12*b5 + b21);
+        B_dsigma = b12*(b13*scale - b14/b6 + Scalar(2)*b18*sigma/(b8 * b8) - b9*(b22 + b4));
+        B_dtheta = (Scalar(2)*b10*b19 + b9*(Scalar(2)*b18*b9*theta - scale*(b0 - b1 + b20)))/(theta * theta * theta);
+        C_dsigma = b13*(b16 + scale);
+      }
+    }
+    const Scalar a = -A/((A * A)*theta_sq + (B * B)*(theta_sq * theta_sq) - Scalar(2)*B*C*theta_sq + (C * C));
+    const Scalar b = ((A * A) + (B * B)*theta_sq - B*C)/(C*((A * A)*theta_sq + (B * B)*(theta_sq * theta_sq) - Scalar(2)*B*C*theta_sq + (C * C)));
+    const Scalar c = Scalar(1) / (C);
+
+    LogJacobian res;
+    const Scalar t0 = p0*p4;
+    const Scalar t1 = Scalar(1) / (scale);
+    const Scalar t2 = Scalar(2)*t1;
+    const Scalar t3 = (C * C);
+    const Scalar t4 = C_dsigma/t3;
+    const Scalar t5 = t2*t4;
+    const Scalar t6 = (k * k);
+    const Scalar t7 = p1*p5;
+    const Scalar t8 = p2*p6;
+    const Scalar t9 = p1*p6;
+    const Scalar t10 = p2*p5;
+    const Scalar t11 = -t10;
+    const Scalar t12 = t11 + t9;
+    const Scalar t13 = p0*p5;
+    const Scalar t14 = p1*p4;
+    const Scalar t15 = -t14;
+    const Scalar t16 = t13 + t15;
+    const Scalar t17 = p1*t16;
+    const Scalar t18 = p0*p6;
+    const Scalar t19 = p2*p4;
+    const Scalar t20 = -t19;
+    const Scalar t21 = t18 + t20;
+    const Scalar t22 = p2*t21;
+    const Scalar t23 = t17 + t22;
+    const Scalar t24 = b*k;
+    const Scalar t25 = Scalar(2)*t24;
+    const Scalar t26 = a*t12 + t23*t25;
+    const Scalar t27 = B*theta_sq;
+    const Scalar t28 = -C + t27;
+    const Scalar t29 = (A * A);
+    const Scalar t30 = t29*theta_sq;
+    const Scalar t31 = (B * B);
+    const Scalar t32 = Scalar(1) / ((-Scalar(2)*C*t27 + t3 + t30 + t31*(theta_sq * theta_sq)));
+    const Scalar t33 = B*C;
+    const Scalar t34 = t31*theta_sq;
+    const Scalar t35 = t29 - Scalar(2)*t33 + Scalar(2)*t34;
+    const Scalar t36 = (p0 * p0);
+    const Scalar t37 = (p1 * p1);
+    const Scalar t38 = (p2 * p2);
+    const Scalar t39 = t37 + t38;
+    const Scalar t40 = t36 + t39;
+    const Scalar t41 = k*(k + k_dn*t40);
+    const Scalar t42 = Scalar(2)*t32;
+    const Scalar t43 = A*t42;
+    const Scalar t44 = t41*t43;
+    const Scalar t45 = A_dsigma*t2;
+    const Scalar t46 = A_dtheta*t41 + t45;
+    const Scalar t47 = t30*t42 + Scalar(-1);
+    const Scalar t48 = t46*t47;
+    const Scalar t49 = B_dsigma*t2;
+    const Scalar t50 = B_dtheta*t41 + t49;
+    const Scalar t51 = t43*t50*theta_sq;
+    const Scalar t52 = k*t32;
+    const Scalar t53 = t52*(Scalar(4)*A*C_dsigma*t1*t28*t32 - t28*t51 - t35*t44 - t48);
+    const Scalar t54 = t29 - t33 + t34;
+    const Scalar t55 = t32*t54;
+    const Scalar t56 = t55*theta_sq;
+    const Scalar t57 = Scalar(2)*A*(t56 + Scalar(-1));
+    const Scalar t58 = Scalar(1) / (C);
+    const Scalar t59 = Scalar(2)*t28;
+    const Scalar t60 = C_dsigma*(B + t54*t58 - t55*t59);
+    const Scalar t61 = Scalar(2)*t31 - Scalar(2)*t35*t55;
+    const Scalar t62 = Scalar(2)*B*theta_sq - C - t56*t59;
+    const Scalar t63 = t2*t60 - t41*t61 + t46*t57 - t50*t62;
+    const Scalar t64 = t32*t58*t6;
+    const Scalar t65 = t23*t63*t64;
+    const Scalar t66 = a*k;
+    const Scalar t67 = p6*t66;
+    const Scalar t68 = b*t6;
+    const Scalar t69 = p1*t12;
+    const Scalar t70 = p5*t66;
+    const Scalar t71 = p2*t12;
+    const Scalar t72 = Scalar(4)*A*C_dsigma*t1*t28*t32 - t28*t51 - t35*t44 - t48;
+    const Scalar t73 = t52*t72;
+    const Scalar t74 = -t63;
+    const Scalar t75 = p3*t2;
+    const Scalar t76 = t4*t75;
+    const Scalar t77 = k*k_dp3*t40;
+    const Scalar t78 = A_dtheta*t77 + p3*t45;
+    const Scalar t79 = B_dtheta*t77 + p3*t49;
+    const Scalar t80 = t52*(Scalar(4)*A*C_dsigma*p3*t1*t28*t32 - t28*t43*t79*theta_sq - t35*t43*t77 - t47*t78);
+    const Scalar t81 = t57*t78 + t60*t75 - t61*t77 - t62*t79;
+    const Scalar t82 = t64*t81;
+    const Scalar t83 = -c;
+    const Scalar t84 = a*p2;
+    const Scalar t85 = a*p1;
+    const Scalar t86 = p0*t24;
+    const Scalar t87 = p0*t16;
+    const Scalar t88 = -t71 + t87;
+    const Scalar t89 = a*t21 + t25*t88;
+    const Scalar t90 = k_dn*t89;
+    const Scalar t91 = t64*t88;
+    const Scalar t92 = t63*t91;
+    const Scalar t93 = p4*t66;
+    const Scalar t94 = a*p0;
+    const Scalar t95 = p0*t21 + t69;
+    const Scalar t96 = a*t16 - t25*t95;
+    const Scalar t97 = k_dn*t96;
+    const Scalar t98 = t64*t95;
+    const Scalar t99 = t63*t98;
+    const Scalar t100 = p1*p2;
+    const Scalar t101 = k_dn*p0;
+    const Scalar t102 = p1*t101;
+    const Scalar t103 = p2*t101;
+    const Scalar t104 = k_dn*t100;
+    res(0, 0) = b*t6*(t7 + t8) + k_dn*p0*t26 - p0*t12*t53 - p0*t65 - t0*t5;
+    res(0, 1) = k_dn*p1*t26 - p1*t65 - t14*t5 - t53*t69 + t67 - t68*(Scalar(2)*p1*p4 - t13);
+    res(0, 2) = k_dn*p2*t26 + p2*t23*t32*t58*t6*t74 - t19*t5 - t68*(Scalar(2)*p2*p4 - t18) - t70 - t71*t73;
+    res(0, 3) = k_dp3*t26 - p4*t76 - t12*t80 - t23*t82;
+    res(0, 4) = -t39*t68 - t83;
+    res(0, 5) = k*(b*k*p0*p1 - t84);
+    res(0, 6) = k*(p2*t86 + t85);
+    res(1, 0) = k*p0*t21*t32*t72 - p0*t74*t91 - p0*t90 - t13*t5 - t67 - t68*(Scalar(2)*t13 + t15);
+    res(1, 1) = p1*t21*t53 - p1*t90 + p1*t92 - t5*t7 + t68*(t0 + t8);
+    res(1, 2) = -p2*t90 + p2*t92 - t10*t5 + t22*t53 - t68*(Scalar(2)*p2*p5 - t9) + t93;
+    res(1, 3) = -k_dp3*t89 - p5*t76 + t21*t80 + t82*t88;
+    res(1, 4) = k*(p1*t86 + t84);
+    res(1, 5) = -t68*(t36 + t38) - t83;
+    res(1, 6) = k*(b*k*p1*p2 - t94);
+    res(2, 0) = p0*t97 + p0*t99 - t18*t5 - t53*t87 - t68*(Scalar(2)*t18 + t20) + t70;
+    res(2, 1) = k_dn*p1*t96 - p1*t74*t98 - t17*t73 - t5*t9 - t68*(t11 + Scalar(2)*t9) - t93;
+    res(2, 2) = -p2*t16*t53 + p2*t97 + p2*t99 - t5*t8 + t68*(t0 + t7);
+    res(2, 3) = k_dp3*t96 - p6*t76 - t16*t80 + t32*t58*t6*t81*t95;
+    res(2, 4) = k*(b*k*p0*p2 - t85);
+    res(2, 5) = k*(t100*t24 + t94);
+    res(2, 6) = -t68*(t36 + t37) - t83;
+    res(3, 0) = k + k_dn*t36;
+    res(3, 1) = t102;
+    res(3, 2) = t103;
+    res(3, 3) = k_dp3*p0;
+    res(3, 4) = Scalar(0);
+    res(3, 5) = Scalar(0);
+    res(3, 6) = Scalar(0);
+    res(4, 0) = t102;
+    res(4, 1) = k + k_dn*t37;
+    res(4, 2) = t104;
+    res(4, 3) = k_dp3*p1;
+    res(4, 4) = Scalar(0);
+    res(4, 5) = Scalar(0);
+    res(4, 6) = Scalar(0);
+    res(5, 0) = t103;
+    res(5, 1) = t104;
+    res(5, 2) = k + k_dn*t38;
+    res(5, 3) = k_dp3*p2;
+    res(5, 4) = Scalar(0);
+    res(5, 5) = Scalar(0);
+    res(5, 6) = Scalar(0);
+    res(6, 0) = p0*t2;
+    res(6, 1) = p1*t2;
+    res(6, 2) = p2*t2;
+    res(6, 3) = t75;
+    res(6, 4) = Scalar(0);
+    res(6, 5) = Scalar(0);
+    res(6, 6) = Scalar(0);
+    return res;
+  }
+};
+}  // namespace generated
+}  // namespace Sophus
+
+#endif  // SOPHUS_GENERATED_SIM3_KERNELS_HPP
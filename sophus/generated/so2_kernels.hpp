@@ -0,0 +1,184 @@
+// This file is part of Sophus.
+//
+// Copyright 2016 Hauke Strasdat
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights  to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+// This file was generated by py/generate_kernels.py, do not edit.
+
+#ifndef SOPHUS_GENERATED_SO2_KERNELS_HPP
+#define SOPHUS_GENERATED_SO2_KERNELS_HPP
+
+#include "generated.hpp"
+
+namespace Sophus {
+namespace generated {
+
+/**
+ * \brief Closed-form kernels of SO2
+ *
+ * Parameters are laid out as in SO2Group::data().
+ */
+template <class Scalar>
+struct SO2Kernels {
+  static const int DoF = 1;
+  static const int num_parameters = 2;
+  typedef Eigen::Matrix<Scalar, DoF, 1> Tangent;
+  typedef Eigen::Matrix<Scalar, num_parameters, 1> Parameters;
+  typedef Eigen::Matrix<Scalar, DoF, DoF> Adjoint;
+  typedef Eigen::Matrix<Scalar, num_parameters, DoF> ParameterJacobian;
+  typedef Eigen::Matrix<Scalar, DoF, num_parameters> LogJacobian;
+
+  /**
+   * Group exponential, returns parameters (see data()) of exp(a)
+   */
+  inline static Parameters exp(const Tangent& a) {
+    using std::abs;
+    using std::atan;
+    using std::atan2;
+    using std::cos;
+    using std::exp;
+    using std::log;
+    using std::sin;
+    using std::sqrt;
+    using std::tan;
+
+    const Scalar a0 = a[0];
+
+    Parameters res;
+    res[0] = cos(a0);
+    res[1] = sin(a0);
+    return res;
+  }
+
+  /**
+   * Group logarithm of parameters p
+   */
+  inline static Tangent log(const Parameters& p) {
+    using std::abs;
+    using std::atan;
+    using std::atan2;
+    using std::cos;
+    using std::exp;
+    using std::log;
+    using std::sin;
+    using std::sqrt;
+    using std::tan;
+
+    const Scalar p0 = p[0];
+    const Scalar p1 = p[1];
+
+    Tangent res;
+    res[0] = atan2(p1, p0);
+    return res;
+  }
+
+  /**
+   * Adjoint transformation of parameters p
+   */
+  inline static Adjoint Adj(const Parameters& /*p*/) {
+    using std::abs;
+    using std::atan;
+    using std::atan2;
+    using std::cos;
+    using std::exp;
+    using std::log;
+    using std::sin;
+    using std::sqrt;
+    using std::tan;
+
+
+    Adjoint res;
+    res[0] = Scalar(1);
+    return res;
+  }
+
+  /**
+   * Derivative of parameters of p * exp(x) with respect to x at x = 0
+   */
+  inline static ParameterJacobian internalJacobian(const Parameters& p) {
+    using std::abs;
+    using std::atan;
+    using std::atan2;
+    using std::cos;
+    using std::exp;
+    using std::log;
+    using std::sin;
+    using std::sqrt;
+    using std::tan;
+
+    const Scalar p0 = p[0];
+    const Scalar p1 = p[1];
+
+    ParameterJacobian res;
+    res[0] = -p1;
+    res[1] = p0;
+    return res;
+  }
+
+  /**
+   * Derivative of parameters of exp(a) with respect to a
+   */
+  inline static ParameterJacobian Dx_exp(const Tangent& a) {
+    using std::abs;
+    using std::atan;
+    using std::atan2;
+    using std::cos;
+    using std::exp;
+    using std::log;
+    using std::sin;
+    using std::sqrt;
+    using std::tan;
+
+    const Scalar a0 = a[0];
+
+    ParameterJacobian res;
+    res[0] = -sin(a0);
+    res[1] = cos(a0);
+    return res;
+  }
+
+  /**
+   * Derivative of log(p) with respect to the parameters p
+   */
+  inline static LogJacobian Dx_log(const Parameters& p) {
+    using std::abs;
+    using std::atan;
+    using std::atan2;
+    using std::cos;
+    using std::exp;
+    using std::log;
+    using std::sin;
+    using std::sqrt;
+    using std::tan;
+
+    const Scalar p0 = p[0];
+    const Scalar p1 = p[1];
+
+    LogJacobian res;
+    const Scalar t0 = Scalar(1) / (((p0 * p0) + (p1 * p1)));
+    res(0, 0) = -p1*t0;
+    res(0, 1) = p0*t0;
+    return res;
+  }
+};
+}  // namespace generated
+}  // namespace Sophus
+
+#endif  // SOPHUS_GENERATED_SO2_KERNELS_HPP
@@ -0,0 +1,342 @@
+// This file is part of Sophus.
+//
+// Copyright 2016 Hauke Strasdat
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights  to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+// This file was generated by py/generate_kernels.py, do not edit.
+
+#ifndef SOPHUS_GENERATED_SO3_KERNELS_HPP
+#define SOPHUS_GENERATED_SO3_KERNELS_HPP
+
+#include "generated.hpp"
+
+namespace Sophus {
+namespace generated {
+
+/**
+ * \brief Closed-form kernels of SO3
+ *
+ * Parameters are laid out as in SO3Group::data().
+ */
+template <class Scalar>
+struct SO3Kernels {
+  static const int DoF = 3;
+  static const int num_parameters = 4;
+  typedef Eigen::Matrix<Scalar, DoF, 1> Tangent;
+  typedef Eigen::Matrix<Scalar, num_parameters, 1> Parameters;
+  typedef Eigen::Matrix<Scalar, DoF, DoF> Adjoint;
+  typedef Eigen::Matrix<Scalar, num_parameters, DoF> ParameterJacobian;
+  typedef Eigen::Matrix<Scalar, DoF, num_parameters> LogJacobian;
+
+  /**
+   * Group exponential, returns parameters (see data()) of exp(a)
+   */
+  inline static Parameters exp(const Tangent& a) {
+    using std::abs;
+    using std::atan;
+    using std::atan2;
+    using std::cos;
+    using std::exp;
+    using std::log;
+    using std::sin;
+    using std::sqrt;
+    using std::tan;
+
+    const Scalar a0 = a[0];
+    const Scalar a1 = a[1];
+    const Scalar a2 = a[2];
+    Scalar imag_factor, real_factor;
+    const Scalar theta_sq = (a0 * a0) + (a1 * a1) + (a2 * a2);
+    if (theta_sq < generatedThreshold<Scalar>(0.0607156, 0.25)) {
+      imag_factor = (Scalar(1.0 / 185794560.0))*(theta_sq*(theta_sq*(theta_sq*(theta_sq + Scalar(-288)) + Scalar(48384)) + Scalar(-3870720)) + Scalar(92897280));
+      real_factor = (Scalar(1.0 / 10321920.0))*theta_sq*(theta_sq*(theta_sq*(theta_sq + Scalar(-224)) + Scalar(26880)) + Scalar(-1290240)) + Scalar(1);
+    } else {
+      const Scalar theta = sqrt(theta_sq);
+      const Scalar b0 = (Scalar(1.0 / 2.0))*theta;
+      imag_factor = sin(b0)/theta;
+      real_factor = cos(b0);
+    }
+
+    Parameters res;
+    res[0] = a0*imag_factor;
+    res[1] = a1*imag_factor;
+    res[2] = a2*imag_factor;
+    res[3] = real_factor;
+    return res;
+  }
+
+  /**
+   * Group logarithm of parameters p
+   */
+  inline static Tangent log(const Parameters& p) {
+    using std::abs;
+    using std::atan;
+    using std::atan2;
+    using std::cos;
+    using std::exp;
+    using std::log;
+    using std::sin;
+    using std::sqrt;
+    using std::tan;
+
+    const Scalar p0 = p[0];
+    const Scalar p1 = p[1];
+    const Scalar p2 = p[2];
+    const Scalar p3 = p[3];
+    Scalar k;
+    const Scalar n_sq = (p0 * p0) + (p1 * p1) + (p2 * p2);
+    if (n_sq < generatedThreshold<Scalar>(0.00119555, 0.0666102) * ((p3 * p3))) {
+      const Scalar b0 = n_sq/(p3 * p3);
+      k = Scalar(2)*((Scalar(1.0 / 315.0))*b0*(b0*(Scalar(5)*b0*(Scalar(7)*b0 + Scalar(-9)) + Scalar(63)) + Scalar(-105)) + Scalar(1))/p3;
+    } else {
+      const Scalar n = sqrt(n_sq);
+      if (abs(p3) < SophusConstants<Scalar>::epsilon()) {
+        if (p3 > Scalar(0)) {
+          k = SophusConstants<Scalar>::pi()/n;
+        } else {
+          k = -SophusConstants<Scalar>::pi()/n;
+        }
+      } else {
+        k = Scalar(2)*atan(n/p3)/n;
+      }
+    }
+
+    Tangent res;
+    res[0] = k*p0;
+    res[1] = k*p1;
+    res[2] = k*p2;
+    return res;
+  }
+
+  /**
+   * Adjoint transformation of parameters p
+   */
+  inline static Adjoint Adj(const Parameters& p) {
+    using std::abs;
+    using std::atan;
+    using std::atan2;
+    using std::cos;
+    using std::exp;
+    using std::log;
+    using std::sin;
+    using std::sqrt;
+    using std::tan;
+
+    const Scalar p0 = p[0];
+    const Scalar p1 = p[1];
+    const Scalar p2 = p[2];
+    const Scalar p3 = p[3];
+
+    Adjoint res;
+    const Scalar t0 = (p3 * p3);
+    const Scalar t1 = (p2 * p2);
+    const Scalar t2 = -t1;
+    const Scalar t3 = (p0 * p0);
+    const Scalar t4 = (p1 * p1);
+    const Scalar t5 = t3 - t4;
+    const Scalar t6 = p0*p1;
+    const Scalar t7 = p2*p3;
+    const Scalar t8 = p0*p2;
+    const Scalar t9 = p1*p3;
+    const Scalar t10 = -t0;
+    const Scalar t11 = p0*p3;
+    res(0, 0) = t0 + t2 + t5;
+    res(0, 1) = Scalar(2)*t6 - Scalar(2)*t7;
+    res(0, 2) = Scalar(2)*t8 + Scalar(2)*t9;
+    res(1, 0) = Scalar(2)*t6 + Scalar(2)*t7;
+    res(1, 1) = -t1 - t10 - t5;
+    res(1, 2) = Scalar(2)*p1*p2 - Scalar(2)*t11;
+    res(2, 0) = Scalar(2)*t8 - Scalar(2)*t9;
+    res(2, 1) = Scalar(2)*p1*p2 + Scalar(2)*t11;
+    res(2, 2) = -t10 - t2 - t3 - t4;
+    return res;
+  }
+
+  /**
+   * Derivative of parameters of p * exp(x) with respect to x at x = 0
+   */
+  inline static ParameterJacobian internalJacobian(const Parameters& p) {
+    using std::abs;
+    using std::atan;
+    using std::atan2;
+    using std::cos;
+    using std::exp;
+    using std::log;
+    using std::sin;
+    using std::sqrt;
+    using std::tan;
+
+    const Scalar p0 = p[0];
+    const Scalar p1 = p[1];
+    const Scalar p2 = p[2];
+    const Scalar p3 = p[3];
+
+    ParameterJacobian res;
+    const Scalar t0 = (Scalar(1.0 / 2.0))*p3;
+    const Scalar t1 = (Scalar(1.0 / 2.0))*p2;
+    const Scalar t2 = -t1;
+    const Scalar t3 = (Scalar(1.0 / 2.0))*p1;
+    const Scalar t4 = (Scalar(1.0 / 2.0))*p0;
+    const Scalar t5 = -t4;
+    const Scalar t6 = -t3;
+    res(0, 0) = t0;
+    res(0, 1) = t2;
+    res(0, 2) = t3;
+    res(1, 0) = t1;
+    res(1, 1) = t0;
+    res(1, 2) = t5;
+    res(2, 0) = t6;
+    res(2, 1) = t4;
+    res(2, 2) = t0;
+    res(3, 0) = t5;
+    res(3, 1) = t6;
+    res(3, 2) = t2;
+    return res;
+  }
+
+  /**
+   * Derivative of parameters of exp(a) with respect to a
+   */
+  inline static ParameterJacobian Dx_exp(const Tangent& a) {
+    using std::abs;
+    using std::atan;
+    using std::atan2;
+    using std::cos;
+    using std::exp;
+    using std::log;
+    using std::sin;
+    using std::sqrt;
+    using std::tan;
+
+    const Scalar a0 = a[0];
+    const Scalar a1 = a[1];
+    const Scalar a2 = a[2];
+    Scalar imag_factor, imag_factor_dtheta, real_factor_dtheta;
+    const Scalar theta_sq = (a0 * a0) + (a1 * a1) + (a2 * a2);
+    if (theta_sq < generatedThreshold<Scalar>(0.0980797, 0.25)) {
+      const Scalar b0 = theta_sq*(theta_sq*(theta_sq + Scalar(-288)) + Scalar(48384)) + Scalar(-3870720);
+      imag_factor = (Scalar(1.0 / 185794560.0))*b0*theta_sq + Scalar(1.0 / 2.0);
+      imag_factor_dtheta = (Scalar(1.0 / 8174960640.0))*(theta_sq*(-theta_sq*(theta_sq*(theta_sq + Scalar(-352)) + Scalar(76032)) + Scalar(8515584)) + Scalar(-340623360));
+      real_factor_dtheta = -Scalar(1.0 / 371589120.0)*b0*theta_sq + Scalar(-1.0 / 4.0);
+    } else {
+      const Scalar theta = sqrt(theta_sq);
+      const Scalar b0 = (Scalar(1.0 / 2.0))*theta;
+      const Scalar b1 = sin(b0)/theta;
+      imag_factor = b1;
+      imag_factor_dtheta = (-b1 + (Scalar(1.0 / 2.0))*cos(b0))/(theta * theta);
+      real_factor_dtheta = -Scalar(1.0 / 2.0)*b1;
+    }
+
+    ParameterJacobian res;
+    const Scalar t0 = a0*imag_factor_dtheta;
+    const Scalar t1 = a1*t0;
+    const Scalar t2 = a2*t0;
+    const Scalar t3 = a1*a2*imag_factor_dtheta;
+    res(0, 0) = (a0 * a0)*imag_factor_dtheta + imag_factor;
+    res(0, 1) = t1;
+    res(0, 2) = t2;
+    res(1, 0) = t1;
+    res(1, 1) = (a1 * a1)*imag_factor_dtheta + imag_factor;
+    res(1, 2) = t3;
+    res(2, 0) = t2;
+    res(2, 1) = t3;
+    res(2, 2) = (a2 * a2)*imag_factor_dtheta + imag_factor;
+    res(3, 0) = a0*real_factor_dtheta;
+    res(3, 1) = a1*real_factor_dtheta;
+    res(3, 2) = a2*real_factor_dtheta;
+    return res;
+  }
+
+  /**
+   * Derivative of log(p) with respect to the parameters p
+   */
+  inline static LogJacobian Dx_log(const Parameters& p) {
+    using std::abs;
+    using std::atan;
+    using std::atan2;
+    using std::cos;
+    using std::exp;
+    using std::log;
+    using std::sin;
+    using std::sqrt;
+    using std::tan;
+
+    const Scalar p0 = p[0];
+    const Scalar p1 = p[1];
+    const Scalar p2 = p[2];
+    const Scalar p3 = p[3];
+    Scalar k, k_dn, k_dp3;
+    const Scalar n_sq = (p0 * p0) + (p1 * p1) + (p2 * p2);
+    if (n_sq < generatedThreshold<Scalar>(0.000693461, 0.0386364) * ((p3 * p3))) {
+      const Scalar b0 = Scalar(1) / (p3 * p3);
+      const Scalar b1 = b0*n_sq;
+      const Scalar b2 = Scalar(7)*b1;
+      const Scalar b3 = Scalar(5)*b1;
+      k = Scalar(2)*((Scalar(1.0 / 315.0))*b1*(b1*(b3*(b2 + Scalar(-9)) + Scalar(63)) + Scalar(-105)) + Scalar(1))/p3;
+      k_dn = (Scalar(4.0 / 3465.0))*(b1*(-b3*(b2*(Scalar(45)*b1 + Scalar(-44)) + Scalar(297)) + Scalar(1386)) + Scalar(-1155))/(p3 * p3 * p3);
+      k_dp3 = Scalar(2)*b0*(b1*(-b1*(b1*(b1 + Scalar(-1)) + Scalar(1)) + Scalar(1)) + Scalar(-1));
+    } else {
+      const Scalar n = sqrt(n_sq);
+      if (abs(p3) < SophusConstants<Scalar>::epsilon()) {
+        if (p3 > Scalar(0)) {
+          k = SophusConstants<Scalar>::pi()/n;
+          k_dn = -SophusConstants<Scalar>::pi()/(n * n * n);
+          k_dp3 = -Scalar(2)/(n * n);
+        } else {
+          k = -SophusConstants<Scalar>::pi()/n;
+          k_dn = SophusConstants<Scalar>::pi()/(n * n * n);
+          k_dp3 = -Scalar(2)/(n * n);
+        }
+      } else {
+        const Scalar b0 = Scalar(1) / (p3);
+        const Scalar b1 = atan(b0*n)/n;
+        const Scalar b2 = (n * n);
+        const Scalar b3 = Scalar(1) / (p3 * p3);
+        const Scalar b4 = Scalar(1) / ((b2*b3 + Scalar(1)));
+        k = Scalar(2)*b1;
+        k_dn = Scalar(2)*(b0*b4 - b1)/b2;
+        k_dp3 = -Scalar(2)*b3*b4;
+      }
+    }
+
+    LogJacobian res;
+    const Scalar t0 = k_dn*p0;
+    const Scalar t1 = p1*t0;
+    const Scalar t2 = p2*t0;
+    const Scalar t3 = k_dn*p1*p2;
+    res(0, 0) = k + k_dn*(p0 * p0);
+    res(0, 1) = t1;
+    res(0, 2) = t2;
+    res(0, 3) = k_dp3*p0;
+    res(1, 0) = t1;
+    res(1, 1) = k + k_dn*(p1 * p1);
+    res(1, 2) = t3;
+    res(1, 3) = k_dp3*p1;
+    res(2, 0) = t2;
+    res(2, 1) = t3;
+    res(2, 2) = k + k_dn*(p2 * p2);
+    res(2, 3) = k_dp3*p2;
+    return res;
+  }
+};
+}  // namespace generated
+}  // namespace Sophus
+
+#endif  // SOPHUS_GENERATED_SO3_KERNELS_HPP
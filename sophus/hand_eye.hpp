@@ -0,0 +1,246 @@
+// This file is part of Sophus.
+//
+// Copyright 2016 Hauke Strasdat
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights  to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+
+#ifndef SOPHUS_HAND_EYE_HPP
+#define SOPHUS_HAND_EYE_HPP
+
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+#include <Eigen/Cholesky>
+#include <Eigen/Eigenvalues>
+
+#include "generated/se3_kernels.hpp"
+#include "se3.hpp"
+
+namespace Sophus {
+
+/**
+ * \brief Closed-form hand-eye calibration A_i * X = X * B_i
+ *
+ * A_i and B_i are corresponding relative motions of the two rigidly
+ * attached frames, e.g. of the robot hand and of the camera, and X is the
+ * transformation from the B frame to the A frame.
+ *
+ * The rotation is the least squares solution of the quaternion equations
+ * q_A * q_X = q_X * q_B, i.e. the eigenvector of the smallest eigenvalue of a
+ * 4x4 matrix. The translation then solves (R_A - I) * t_X = R_X * t_B - t_A
+ * in the least squares sense. All sums are accumulated in fixed-size state,
+ * so any number of pairs can be streamed through add() without storing
+ * them. At least two pairs with non-parallel rotation axes are required.
+ */
+template <typename Scalar>
+class HandEyeLinearSolver {
+ public:
+  typedef SE3Group<Scalar> SE3Type;
+  typedef Eigen::Matrix<Scalar, 3, 1> Point;
+  typedef Eigen::Matrix<Scalar, 3, 3> Matrix3;
+  typedef Eigen::Matrix<Scalar, 4, 4> Matrix4;
+
+  HandEyeLinearSolver()
+      : rotation_normal_(Matrix4::Zero()),
+        translation_normal_(Matrix3::Zero()),
+        rotation_coupling_(Eigen::Matrix<Scalar, 3, 9>::Zero()),
+        translation_rhs_(Point::Zero()),
+        num_pairs_(0) {}
+
+  void add(const SE3Type& A, const SE3Type& B) {
+    // Both rotations have the same angle, so with the real parts of the same
+    // sign the quaternion equation holds without sign ambiguity.
+    Eigen::Quaternion<Scalar> q_A = A.unit_quaternion();
+    Eigen::Quaternion<Scalar> q_B = B.unit_quaternion();
+    if (q_A.w() < 0) {
+      q_A.coeffs() = -q_A.coeffs();
+    }
+    if (q_B.w() < 0) {
+      q_B.coeffs() = -q_B.coeffs();
+    }
+    const Matrix4 K = leftProduct(q_A) - rightProduct(q_B);
+    rotation_normal_.noalias() += K.transpose() * K;
+
+    // With M = R_A - I: sum M^T M t_X = sum M^T R_X t_B - M^T t_A, where
+    // R_X t_B = sum_k t_B[k] R_X.col(k) is linear in the entries of R_X.
+    const Matrix3 M = A.rotationMatrix() - Matrix3::Identity();
+    translation_normal_.noalias() += M.transpose() * M;
+    for (int k = 0; k < 3; ++k) {
+      rotation_coupling_.template block<3, 3>(0, 3 * k) +=
+          B.translation()[k] * M.transpose();
+    }
+    translation_rhs_.noalias() += M.transpose() * A.translation();
+    ++num_pairs_;
+  }
+
+  SE3Type solve() const {
+    SOPHUS_ENSURE(num_pairs_ >= 2, "Hand-eye calibration needs two pairs.");
+    const Eigen::SelfAdjointEigenSolver<Matrix4> eigen_solver(
+        rotation_normal_);
+    // eigenvalues are sorted in increasing order
+    const Eigen::Matrix<Scalar, 4, 1> v = eigen_solver.eigenvectors().col(0);
+    const Eigen::Quaternion<Scalar> q_X(v[0], v[1], v[2], v[3]);
+    const Matrix3 R_X = q_X.normalized().toRotationMatrix();
+    const Point t_X = translation_normal_.ldlt().solve(
+        rotation_coupling_ * Eigen::Map<const Eigen::Matrix<Scalar, 9, 1> >(
+                                 R_X.data()) -
+        translation_rhs_);
+    return SE3Type(q_X.normalized(), t_X);
+  }
+
+  std::size_t numPairs() const { return num_pairs_; }
+
+ private:
+  // q * p = leftProduct(q) * p, with coefficients ordered (w, x, y, z)
+  static Matrix4 leftProduct(const Eigen::Quaternion<Scalar>& q) {
+    Matrix4 L;
+    L << q.w(), -q.x(), -q.y(), -q.z(),  //
+        q.x(), q.w(), -q.z(), q.y(),     //
+        q.y(), q.z(), q.w(), -q.x(),     //
+        q.z(), -q.y(), q.x(), q.w();
+    return L;
+  }
+
+  // p * q = rightProduct(q) * p, with coefficients ordered (w, x, y, z)
+  static Matrix4 rightProduct(const Eigen::Quaternion<Scalar>& q) {
+    Matrix4 R;
+    R << q.w(), -q.x(), -q.y(), -q.z(),  //
+        q.x(), q.w(), q.z(), -q.y(),     //
+        q.y(), -q.z(), q.w(), q.x(),     //
+        q.z(), q.y(), -q.x(), q.w();
+    return R;
+  }
+
+  Matrix4 rotation_normal_;
+  Matrix3 translation_normal_;
+  Eigen::Matrix<Scalar, 3, 9> rotation_coupling_;
+  Point translation_rhs_;
+  std::size_t num_pairs_;
+};
+
+/**
+ * \brief Gauss-Newton normal equations of hand-eye calibration at a fixed
+ * linearization point X_lin
+ *
+ * The residual of a pair is r = log(X^-1 * A^-1 * X * B), which is zero iff
+ * A * X = X * B. With E = X^-1 * A^-1 * X * B and X = X_lin * exp(delta),
+ *
+ *   exp(-delta) * X_lin^-1 A^-1 X_lin * exp(delta) * B
+ *       = E * exp(-Adj(E^-1) * delta) * exp(Adj(B^-1) * delta),
+ *
+ * hence dr/ddelta = Jr^-1(E) * (Adj(B^-1) - Adj(E^-1)), with the inverse right
+ * Jacobian Jr^-1 = d log(E * exp(delta)) / d delta of the generated kernels.
+ *
+ * Only the 6x6 system is stored, so a streamed Gauss-Newton iteration is one
+ * pass over the pairs: feed all pairs, then restart at solve().
+ */
+template <typename Scalar>
+class HandEyeNormalEquations {
+ public:
+  typedef SE3Group<Scalar> SE3Type;
+  typedef typename SE3Type::Tangent Tangent;
+  typedef Eigen::Matrix<Scalar, 6, 6> Matrix6;
+  typedef generated::SE3Kernels<Scalar> K;
+
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+  explicit HandEyeNormalEquations(const SE3Type& X_lin)
+      : X_lin_(X_lin),
+        X_lin_inv_(X_lin.inverse()),
+        H_(Matrix6::Zero()),
+        g_(Tangent::Zero()),
+        cost_(0) {}
+
+  void add(const SE3Type& A, const SE3Type& B) {
+    const SE3Type E = X_lin_inv_ * A.inverse() * X_lin_ * B;
+    const Eigen::Map<const typename K::Parameters> E_params(E.data());
+    const Tangent r = K::log(E_params);
+    const Matrix6 J = K::Dx_log(E_params) * K::internalJacobian(E_params) *
+                      (B.inverse().Adj() - E.inverse().Adj());
+    H_.noalias() += J.transpose() * J;
+    g_.noalias() += J.transpose() * r;
+    cost_ += r.squaredNorm() / 2;
+  }
+
+  /**
+   * \returns X_lin * exp(delta) with the Gauss-Newton step delta
+   */
+  SE3Type solve() const { return X_lin_ * SE3Type::exp(step()); }
+
+  Tangent step() const { return -H_.ldlt().solve(g_); }
+
+  /** \returns 0.5 * sum |r|^2 at X_lin of the pairs added so far */
+  Scalar cost() const { return cost_; }
+
+  const SE3Type& linearizationPoint() const { return X_lin_; }
+
+ private:
+  SE3Type X_lin_;
+  SE3Type X_lin_inv_;
+  Matrix6 H_;
+  Tangent g_;
+  Scalar cost_;
+};
+
+/**
+ * \brief Solves A[i] * X = X * B[i] for X
+ *
+ * Closed-form initialization with HandEyeLinearSolver, followed by at most
+ * max_iterations Gauss-Newton iterations with HandEyeNormalEquations, which
+ * stop once the cost no longer decreases.
+ */
+template <typename Scalar, typename Allocator>
+SE3Group<Scalar> handEyeCalibration(
+    const std::vector<SE3Group<Scalar>, Allocator>& A,
+    const std::vector<SE3Group<Scalar>, Allocator>& B,
+    int max_iterations = 10) {
+  SOPHUS_ENSURE(A.size() == B.size(), "Number of motions differs.");
+  HandEyeLinearSolver<Scalar> linear_solver;
+  for (std::size_t i = 0; i < A.size(); ++i) {
+    linear_solver.add(A[i], B[i]);
+  }
+  SE3Group<Scalar> X = linear_solver.solve();
+  SE3Group<Scalar> X_previous = X;
+  Scalar cost = std::numeric_limits<Scalar>::max();
+  for (int iteration = 0; iteration < max_iterations; ++iteration) {
+    HandEyeNormalEquations<Scalar> normal_equations(X);
+    for (std::size_t i = 0; i < A.size(); ++i) {
+      normal_equations.add(A[i], B[i]);
+    }
+    if (!(normal_equations.cost() < cost)) {
+      // the last step did not decrease the cost
+      X = X_previous;
+      break;
+    }
+    cost = normal_equations.cost();
+    const typename SE3Group<Scalar>::Tangent delta = normal_equations.step();
+    X_previous = X;
+    X = X * SE3Group<Scalar>::exp(delta);
+    if (delta.template lpNorm<Eigen::Infinity>() <=
+        SophusConstants<Scalar>::epsilon()) {
+      break;
+    }
+  }
+  return X;
+}
+}  // namespace Sophus
+
+#endif  // SOPHUS_HAND_EYE_HPP
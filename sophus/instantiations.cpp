@@ -0,0 +1,67 @@
+// This file is part of Sophus.
+//
+// Copyright 2016 Hauke Strasdat
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights  to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+
+// Explicit instantiations of all Lie groups for float and double. Compiled
+// into Sophus::Instantiations if SOPHUS_BUILD_INSTANTIATIONS is ON, in which
+// case SOPHUS_USE_INSTANTIATIONS makes the headers declare them extern.
+
+// Eigen::Transform is needed by SE3Group::affine3() et al., which the
+// Sophus headers do not pull in by themselves.
+#include <Eigen/Geometry>
+
+#include "sim3.hpp"
+#include "se2.hpp"
+#include "se3.hpp"
+
+namespace Sophus {
+
+template class SO2GroupBase<SO2Group<double> >;
+template class SO2Group<double>;
+template class SO2GroupBase<SO2Group<float> >;
+template class SO2Group<float>;
+
+template class SE2GroupBase<SE2Group<double> >;
+template class SE2Group<double>;
+template class SE2GroupBase<SE2Group<float> >;
+template class SE2Group<float>;
+
+template class SO3GroupBase<SO3Group<double> >;
+template class SO3Group<double>;
+template class SO3GroupBase<SO3Group<float> >;
+template class SO3Group<float>;
+
+template class SE3GroupBase<SE3Group<double> >;
+template class SE3Group<double>;
+template class SE3GroupBase<SE3Group<float> >;
+template class SE3Group<float>;
+
+template class RxSO3GroupBase<RxSO3Group<double> >;
+template class RxSO3Group<double>;
+template class RxSO3GroupBase<RxSO3Group<float> >;
+template class RxSO3Group<float>;
+
+template class Sim3GroupBase<Sim3Group<double> >;
+template class Sim3Group<double>;
+template class Sim3GroupBase<Sim3Group<float> >;
+template class Sim3Group<float>;
+}  // namespace Sophus
@@ -0,0 +1,314 @@
+// This file is part of Sophus.
+//
+// Copyright 2016 Hauke Strasdat
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights  to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+
+#ifndef SOPHUS_LIE_INTEGRATORS_HPP
+#define SOPHUS_LIE_INTEGRATORS_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+#include "batch.hpp"
+
+namespace Sophus {
+
+enum class LieIntegratorMethod { RKMK, CrouchGrossman };
+
+/**
+ * \brief Explicit Lie group integrators for dY/dt = Y * hat(xi(t, Y))
+ *
+ * xi is the velocity in the body frame, so that explicit Euler is
+ * Y * exp(h * xi(t, Y)). Both methods only use exp(), lieBracket() and the
+ * group product and keep Y on the group up to rounding.
+ *
+ * Runge-Kutta-Munthe-Kaas (RKMK) integrates Y = Y_0 * exp(theta) in the Lie
+ * algebra, with dtheta/dt = dexpinv(theta, xi), using the classical Runge-
+ * Kutta tableau of the given order: Heun (2), Kutta (3) and the classical
+ * fourth-order method (4).
+ *
+ * Crouch-Grossman (CG) composes the exponentials of the stage velocities,
+ * Y_1 = Y_0 * exp(h b_1 k_1) * ... * exp(h b_s k_s), and needs no
+ * dexpinv(): Heun (2), the three-stage method of Crouch and Grossman (3)
+ * and the five-stage method of Owren and Marthinsen (4).
+ *
+ * The batched step() integrates n elements of SO3Group or SE3Group at once.
+ * All exponentials and products of a stage go through BatchOps, and the
+ * stage velocities are kept in separate arrays per stage.
+ */
+template <class Group>
+class LieIntegrator {
+ public:
+  typedef typename Group::Scalar Scalar;
+  typedef typename Group::Tangent Tangent;
+  static const int DoF = Group::DoF;
+  static const int num_parameters = Group::num_parameters;
+  static const int kMaxStages = 5;
+
+  /**
+   * \param order of accuracy, 2, 3 or 4
+   */
+  LieIntegrator(LieIntegratorMethod method, int order)
+      : method_(method), order_(order) {
+    SOPHUS_ENSURE(order >= 2 && order <= 4,
+                  "Order must be 2, 3 or 4, but is %.", order);
+    for (int i = 0; i < kMaxStages; ++i) {
+      b_[i] = c_[i] = 0;
+      for (int j = 0; j < kMaxStages; ++j) {
+        a_[i][j] = 0;
+      }
+    }
+    if (order == 2) {
+      num_stages_ = 2;
+      a_[1][0] = 1;
+      b_[0] = b_[1] = 0.5;
+    } else if (method == LieIntegratorMethod::RKMK && order == 3) {
+      num_stages_ = 3;
+      a_[1][0] = 0.5;
+      a_[2][0] = -1;
+      a_[2][1] = 2;
+      b_[0] = b_[2] = 1.0 / 6.0;
+      b_[1] = 2.0 / 3.0;
+    } else if (method == LieIntegratorMethod::RKMK) {
+      num_stages_ = 4;
+      a_[1][0] = a_[2][1] = 0.5;
+      a_[3][2] = 1;
+      b_[0] = b_[3] = 1.0 / 6.0;
+      b_[1] = b_[2] = 1.0 / 3.0;
+    } else if (order == 3) {
+      num_stages_ = 3;
+      a_[1][0] = 3.0 / 4.0;
+      a_[2][0] = 119.0 / 216.0;
+      a_[2][1] = 17.0 / 108.0;
+      b_[0] = 13.0 / 51.0;
+      b_[1] = -2.0 / 3.0;
+      b_[2] = 24.0 / 17.0;
+    } else {
+      num_stages_ = 5;
+      a_[1][0] = 0.8177227988124852;
+      a_[2][0] = 0.3199876375476427;
+      a_[2][1] = 0.0659864263556022;
+      a_[3][0] = 0.9214417194464946;
+      a_[3][1] = 0.4997857776773573;
+      a_[3][2] = -1.0969984448371582;
+      a_[4][0] = 0.3552358559023322;
+      a_[4][1] = 0.2390958372307326;
+      a_[4][2] = 1.3918565724203246;
+      a_[4][3] = -1.1092979392113565;
+      b_[0] = 0.1370831520630755;
+      b_[1] = -0.0183698531564020;
+      b_[2] = 0.7397813985370780;
+      b_[3] = -0.1907142565505889;
+      b_[4] = 0.3322195591068374;
+    }
+    for (int i = 0; i < num_stages_; ++i) {
+      for (int j = 0; j < i; ++j) {
+        c_[i] += a_[i][j];
+      }
+    }
+  }
+
+  LieIntegratorMethod method() const { return method_; }
+
+  int order() const { return order_; }
+
+  int numStages() const { return num_stages_; }
+
+  /**
+   * \brief Inverse of the right Jacobian of exp() applied to xi
+   *
+   * Returns the Bernoulli series xi + 1/2 [theta, xi] + 1/12 [theta,
+   * [theta, xi]] - 1/720 ad_theta^4 xi, truncated after the brackets of
+   * the given degree (0 to 4), such that d/dt exp(theta) = exp(theta) *
+   * hat(xi) for dtheta/dt = dexpinv(theta, xi).
+   */
+  static Tangent dexpinv(const Tangent& theta, const Tangent& xi,
+                         int degree) {
+    Tangent result = xi;
+    Tangent ad_xi = xi;
+    static const Scalar kCoefficients[4] = {
+        Scalar(0.5), Scalar(1.0 / 12.0), Scalar(0), Scalar(-1.0 / 720.0)};
+    for (int k = 0; k < degree; ++k) {
+      ad_xi = Group::lieBracket(theta, ad_xi);
+      result += kCoefficients[k] * ad_xi;
+    }
+    return result;
+  }
+
+  /**
+   * \brief Advances Y from t to t + h
+   *
+   * \param field  callable field(t, Y) returning xi(t, Y)
+   */
+  template <typename Field>
+  Group step(const Group& Y, Scalar t, Scalar h, Field field) const {
+    Tangent k[kMaxStages];
+    if (method_ == LieIntegratorMethod::RKMK) {
+      const int degree = order_ - 2;
+      for (int i = 0; i < num_stages_; ++i) {
+        Tangent theta = Tangent::Zero();
+        for (int j = 0; j < i; ++j) {
+          theta += Scalar(a_[i][j]) * k[j];
+        }
+        theta *= h;
+        k[i] = dexpinv(theta, field(t + Scalar(c_[i]) * h,
+                                    Group(Y * Group::exp(theta))),
+                       degree);
+      }
+      Tangent theta = Tangent::Zero();
+      for (int i = 0; i < num_stages_; ++i) {
+        theta += Scalar(b_[i]) * k[i];
+      }
+      return Y * Group::exp(h * theta);
+    }
+    for (int i = 0; i < num_stages_; ++i) {
+      Group Y_i = Y;
+      for (int j = 0; j < i; ++j) {
+        if (a_[i][j] != 0) {
+          Y_i *= Group::exp((h * Scalar(a_[i][j])) * k[j]);
+        }
+      }
+      k[i] = field(t + Scalar(c_[i]) * h, Y_i);
+    }
+    Group Y_1 = Y;
+    for (int i = 0; i < num_stages_; ++i) {
+      Y_1 *= Group::exp((h * Scalar(b_[i])) * k[i]);
+    }
+    return Y_1;
+  }
+
+  /**
+   * \brief Advances n elements from t to t + h, in place
+   *
+   * \param params  n elements packed in the layout of BatchOps
+   * \param field   callable field(t, params, velocities, n) writing
+   *                xi(t, params[i]) to velocities[i] (DoF scalars each)
+   *
+   * Scratch buffers are kept between calls and only grow with n.
+   */
+  template <typename BatchField>
+  void step(Scalar* params, std::size_t n, Scalar t, Scalar h,
+            BatchField field) {
+    const std::size_t num_params = num_parameters * n;
+    const std::size_t num_tangents = DoF * n;
+    start_.assign(params, params + num_params);
+    stage_.resize(num_params);
+    product_.resize(num_params);
+    swap_.resize(num_params);
+    exp_.resize(num_params);
+    theta_.resize(num_tangents);
+    velocities_.resize(num_stages_ * num_tangents);
+    for (int i = 0; i < num_stages_; ++i) {
+      Scalar* k_i = &velocities_[i * num_tangents];
+      if (i == 0) {
+        field(t, start_.data(), k_i, n);
+        continue;
+      }
+      const Scalar t_i = t + Scalar(c_[i]) * h;
+      if (method_ == LieIntegratorMethod::RKMK) {
+        combineVelocities(a_[i], i, h, n);
+        expAndCompose(stage_.data(), n);
+        field(t_i, stage_.data(), k_i, n);
+        const int degree = order_ - 2;
+        for (std::size_t e = 0; e < n; ++e) {
+          Eigen::Map<Tangent> k_ie(k_i + DoF * e);
+          k_ie = dexpinv(Eigen::Map<const Tangent>(&theta_[DoF * e]), k_ie,
+                         degree);
+        }
+      } else {
+        composeExps(a_[i], i, h, n, stage_.data());
+        field(t_i, stage_.data(), k_i, n);
+      }
+    }
+    if (method_ == LieIntegratorMethod::RKMK) {
+      combineVelocities(b_, num_stages_, h, n);
+      expAndCompose(params, n);
+    } else {
+      composeExps(b_, num_stages_, h, n, params);
+    }
+  }
+
+ private:
+  // theta_[e] = h * sum_j weights[j] * k_j[e]
+  void combineVelocities(const double* weights, int num, Scalar h,
+                         std::size_t n) {
+    const std::size_t num_tangents = DoF * n;
+    std::fill(theta_.begin(), theta_.begin() + num_tangents, Scalar(0));
+    for (int j = 0; j < num; ++j) {
+      const Scalar w = h * Scalar(weights[j]);
+      const Scalar* k_j = &velocities_[j * num_tangents];
+      for (std::size_t e = 0; e < num_tangents; ++e) {
+        theta_[e] += w * k_j[e];
+      }
+    }
+  }
+
+  // out = start_ * exp(theta_)
+  void expAndCompose(Scalar* out, std::size_t n) {
+    BatchOps<Group>::exp(theta_.data(), exp_.data(), n);
+    BatchOps<Group>::compose(start_.data(), exp_.data(), out, n);
+  }
+
+  // out = start_ * exp(h w_0 k_0) * ... * exp(h w_num-1 k_num-1)
+  void composeExps(const double* weights, int num, Scalar h, std::size_t n,
+                   Scalar* out) {
+    const std::size_t num_params = num_parameters * n;
+    const std::size_t num_tangents = DoF * n;
+    const Scalar* product = start_.data();
+    Scalar* next = product_.data();
+    Scalar* other = swap_.data();
+    for (int j = 0; j < num; ++j) {
+      if (weights[j] == 0) {
+        continue;
+      }
+      const Scalar w = h * Scalar(weights[j]);
+      const Scalar* k_j = &velocities_[j * num_tangents];
+      for (std::size_t e = 0; e < num_tangents; ++e) {
+        theta_[e] = w * k_j[e];
+      }
+      BatchOps<Group>::exp(theta_.data(), exp_.data(), n);
+      BatchOps<Group>::compose(product, exp_.data(), next, n);
+      product = next;
+      std::swap(next, other);
+    }
+    std::copy(product, product + num_params, out);
+  }
+
+  LieIntegratorMethod method_;
+  int order_;
+  int num_stages_;
+  double a_[kMaxStages][kMaxStages];
+  double b_[kMaxStages];
+  double c_[kMaxStages];
+
+  // scratch of the batched step
+  std::vector<Scalar> start_;
+  std::vector<Scalar> stage_;
+  std::vector<Scalar> product_;
+  std::vector<Scalar> swap_;
+  std::vector<Scalar> exp_;
+  std::vector<Scalar> theta_;
+  std::vector<Scalar> velocities_;
+};
+}  // namespace Sophus
+
+#endif  // SOPHUS_LIE_INTEGRATORS_HPP
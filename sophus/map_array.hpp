@@ -0,0 +1,169 @@
+// This file is part of Sophus.
+//
+// Copyright 2016 Hauke Strasdat
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights  to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+
+#ifndef SOPHUS_MAP_ARRAY_HPP
+#define SOPHUS_MAP_ARRAY_HPP
+
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+#include <Eigen/Core>
+
+#include "sophus.hpp"
+
+namespace Sophus {
+
+/**
+ * \brief Array of Eigen::Map<Group> views into an existing buffer
+ *
+ * Element i is a Map onto the group parameters at
+ * data + i * outer_stride, e.g. the columns of an Eigen::Matrix<Scalar,
+ * Group::num_parameters, Eigen::Dynamic>, or poses stored in records
+ * together with other fields. For SE2Group, SE3Group and Sim3Group, the
+ * translation and the rotation part may also live in separate arrays with
+ * their own strides (struct of arrays layout).
+ *
+ * The parameters of one group part must be contiguous, as the group
+ * classes expose them through data() and the Eigen quaternion and complex
+ * number maps. Use const Group for read-only buffers, e.g.
+ * MapArray<const SE3d>.
+ */
+template <typename Group>
+class MapArray {
+ public:
+  typedef typename std::remove_const<Group>::type PlainGroup;
+  typedef typename PlainGroup::Scalar PlainScalar;
+  typedef typename std::conditional<std::is_const<Group>::value,
+                                    const PlainScalar, PlainScalar>::type
+      Scalar;
+  typedef Eigen::Map<Group> MapType;
+  static const int num_parameters = PlainGroup::num_parameters;
+
+ private:
+  // Enabled if the data pointer of a matrix may be viewed as Group, i.e.
+  // unless the matrix is const and Group is not.
+  template <typename Pointer>
+  using IfViewable = typename std::enable_if<
+      std::is_convertible<Pointer, Scalar*>::value>::type;
+
+ public:
+  /**
+   * \brief size groups, packed if outer_stride is num_parameters
+   */
+  MapArray(Scalar* data, std::size_t size,
+           std::size_t outer_stride = num_parameters)
+      : size_(size),
+        data_(data),
+        outer_stride_(outer_stride),
+        translation_data_(nullptr),
+        translation_stride_(0) {
+    SOPHUS_ENSURE(outer_stride >= num_parameters,
+                  "outer stride % overlaps groups of % parameters",
+                  outer_stride, static_cast<int>(num_parameters));
+  }
+
+  /**
+   * \brief Columns of a matrix or matrix block
+   *
+   * Takes column-major expressions with direct access and num_parameters
+   * contiguous rows, e.g. matrix.middleRows<num_parameters>(1) of a matrix
+   * holding a timestamp in its first row. Temporary blocks may be passed as
+   * well. Columns of const matrices only give MapArray<const Group>.
+   */
+  template <typename Derived,
+            typename = IfViewable<decltype(std::declval<Derived&>().data())> >
+  explicit MapArray(Eigen::DenseBase<Derived>& columns)
+      : MapArray(columns.derived().data(), columns) {}
+
+  template <typename Derived,
+            typename = IfViewable<decltype(std::declval<Derived&>().data())> >
+  explicit MapArray(Eigen::DenseBase<Derived>&& columns)
+      : MapArray(columns.derived().data(), columns) {}
+
+  template <typename Derived,
+            typename = IfViewable<decltype(
+                std::declval<const Derived&>().data())> >
+  explicit MapArray(const Eigen::DenseBase<Derived>& columns)
+      : MapArray(columns.derived().data(), columns) {}
+
+  /**
+   * \brief Separate arrays of translations and rotation parameters
+   *
+   * Only for groups with a translation part; element i has its
+   * translation at translations + i * translation_stride and its rotation
+   * (or RxSO3) parameters at rotations + i * rotation_stride.
+   */
+  MapArray(Scalar* translations, std::size_t translation_stride,
+           Scalar* rotations, std::size_t rotation_stride, std::size_t size)
+      : size_(size),
+        data_(rotations),
+        outer_stride_(rotation_stride),
+        translation_data_(translations),
+        translation_stride_(translation_stride) {
+    static_assert(HasTranslation::value,
+                  "separate arrays require a group with translation");
+  }
+
+  MapType operator[](std::size_t i) const {
+    return element(i, HasTranslation());
+  }
+
+  std::size_t size() const { return size_; }
+
+ private:
+  typedef typename std::is_constructible<MapType, Scalar*, Scalar*>::type
+      HasTranslation;
+
+  template <typename Derived>
+  MapArray(Scalar* data, const Eigen::DenseBase<Derived>& columns)
+      : MapArray(data, static_cast<std::size_t>(columns.cols()),
+                 static_cast<std::size_t>(columns.derived().outerStride())) {
+    static_assert(Derived::RowsAtCompileTime == num_parameters,
+                  "columns must have num_parameters rows");
+    static_assert(!Derived::IsRowMajor &&
+                      Derived::InnerStrideAtCompileTime == 1,
+                  "the parameters of a column must be contiguous");
+  }
+
+  MapType element(std::size_t i, std::false_type) const {
+    return MapType(data_ + i * outer_stride_);
+  }
+
+  MapType element(std::size_t i, std::true_type) const {
+    return translation_data_ == nullptr
+               ? MapType(data_ + i * outer_stride_)
+               : MapType(translation_data_ + i * translation_stride_,
+                         data_ + i * outer_stride_);
+  }
+
+  std::size_t size_;
+  // parameters, or rotation parameters for separate arrays
+  Scalar* data_;
+  std::size_t outer_stride_;
+  Scalar* translation_data_;
+  std::size_t translation_stride_;
+};
+}  // namespace Sophus
+
+#endif  // SOPHUS_MAP_ARRAY_HPP
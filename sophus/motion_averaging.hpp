@@ -0,0 +1,473 @@
+// This file is part of Sophus.
+//
+// Copyright 2016 Hauke Strasdat
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights  to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+
+#ifndef SOPHUS_MOTION_AVERAGING_HPP
+#define SOPHUS_MOTION_AVERAGING_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include <Eigen/SVD>
+#include <Eigen/SparseCholesky>
+#include <Eigen/SparseCore>
+#include <Eigen/StdVector>
+
+#include "generated/so3_kernels.hpp"
+#include "parallel.hpp"
+#include "se3.hpp"
+
+namespace Sophus {
+
+struct MotionAveragingOptions {
+  // Iteratively reweighted least squares iterations of each solve.
+  int max_iterations = 30;
+  // Scale c of the Cauchy weights 1 / (1 + |r|^2 / c^2) of the rotation
+  // residuals, in radians.
+  double rotation_loss_scale = 0.1;
+  // Scale of the Cauchy weights of the translation residuals.
+  double translation_loss_scale = 1.0;
+  // Converged if the largest update of a view is below this.
+  double step_tolerance = 1e-10;
+  // Zero uses all hardware threads.
+  std::size_t num_threads = 0;
+};
+
+struct MotionAveragingSummary {
+  // Robust cost sum 0.5 * c^2 * log(1 + |r|^2 / c^2) before and after the
+  // reweighted iterations.
+  double initial_cost = 0;
+  double final_cost = 0;
+  int num_iterations = 0;
+  bool converged = false;
+};
+
+namespace details {
+
+// Normal equations of a view graph with one 3-vector per view, where view 0
+// is held fixed. The sparse pattern and the symbolic factorization are
+// computed once per edge set.
+class ViewGraphSystem {
+ public:
+  void setStructure(int num_views,
+                    const std::vector<std::pair<int, int> >& edges) {
+    num_views_ = num_views;
+    edges_ = edges;
+    const int nv = num_views - 1;
+    // lower triangle in column-major order
+    std::vector<Eigen::Triplet<double> > triplets;
+    for (int i = 0; i < nv; ++i) {
+      pushBlock(i, i, &triplets);
+    }
+    for (const std::pair<int, int>& e : edges_) {
+      const int a = e.first - 1;
+      const int b = e.second - 1;
+      if (a >= 0 && b >= 0) {
+        pushBlock(std::max(a, b), std::min(a, b), &triplets);
+      }
+    }
+    matrix_.resize(3 * nv, 3 * nv);
+    matrix_.setFromTriplets(triplets.begin(), triplets.end());
+    matrix_.makeCompressed();
+    value_indices_.clear();
+    for (const std::pair<int, int>& e : edges_) {
+      const int a = e.first - 1;
+      const int b = e.second - 1;
+      pushValueIndices(a, a);
+      pushValueIndices(b, b);
+      pushValueIndices(std::max(a, b), std::min(a, b));
+    }
+    cholesky_.analyzePattern(matrix_);
+    gradient_.resize(3 * nv, 3);
+  }
+
+  void setZero(int num_columns) {
+    std::fill(matrix_.valuePtr(), matrix_.valuePtr() + matrix_.nonZeros(), 0);
+    gradient_.setZero(3 * (num_views_ - 1), num_columns);
+  }
+
+  // Adds w * |J_a x_a + J_b x_b + r|^2 of edge k, for each column of r.
+  template <typename Derived>
+  void add(int k, const Eigen::Matrix3d& J_a, const Eigen::Matrix3d& J_b,
+           double w, const Eigen::MatrixBase<Derived>& r) {
+    const int a = edges_[k].first - 1;
+    const int b = edges_[k].second - 1;
+    const int* indices = &value_indices_[21 * k];
+    addBlock(w * J_a.transpose() * J_a, indices, true);
+    addBlock(w * J_b.transpose() * J_b, indices + 6, true);
+    if (a >= 0 && b >= 0) {
+      addBlock(a > b ? Eigen::Matrix3d(w * J_a.transpose() * J_b)
+                     : Eigen::Matrix3d(w * J_b.transpose() * J_a),
+               indices + 12, false);
+    }
+    if (a >= 0) {
+      gradient_.middleRows<3>(3 * a).noalias() += w * J_a.transpose() * r;
+    }
+    if (b >= 0) {
+      gradient_.middleRows<3>(3 * b).noalias() += w * J_b.transpose() * r;
+    }
+  }
+
+  // Solves for the minimizing x, with 3 rows per view and x_0 = 0. False if
+  // the graph is not connected.
+  bool solve(Eigen::MatrixXd* x) {
+    cholesky_.factorize(matrix_);
+    if (cholesky_.info() != Eigen::Success) {
+      return false;
+    }
+    x->resize(3 * num_views_, gradient_.cols());
+    x->topRows<3>().setZero();
+    x->bottomRows(gradient_.rows()) = -cholesky_.solve(gradient_);
+    return cholesky_.info() == Eigen::Success && x->allFinite();
+  }
+
+ private:
+  static void pushBlock(int i, int k,
+                        std::vector<Eigen::Triplet<double> >* triplets) {
+    for (int col = 0; col < 3; ++col) {
+      for (int row = (k == i ? col : 0); row < 3; ++row) {
+        triplets->push_back(
+            Eigen::Triplet<double>(3 * i + row, 3 * k + col, 0.0));
+      }
+    }
+  }
+
+  // Value indices of the lower block (i, k), or -1 for the fixed view.
+  void pushValueIndices(int i, int k) {
+    for (int col = 0; col < 3; ++col) {
+      for (int row = (k == i ? col : 0); row < 3; ++row) {
+        if (k < 0) {
+          value_indices_.push_back(-1);
+          continue;
+        }
+        const int* inner_begin =
+            matrix_.innerIndexPtr() + matrix_.outerIndexPtr()[3 * k + col];
+        const int* inner_end =
+            matrix_.innerIndexPtr() + matrix_.outerIndexPtr()[3 * k + col + 1];
+        value_indices_.push_back(static_cast<int>(
+            std::lower_bound(inner_begin, inner_end, 3 * i + row) -
+            matrix_.innerIndexPtr()));
+      }
+    }
+  }
+
+  void addBlock(const Eigen::Matrix3d& H, const int* indices, bool diagonal) {
+    double* values = matrix_.valuePtr();
+    int v = 0;
+    for (int col = 0; col < 3; ++col) {
+      for (int row = (diagonal ? col : 0); row < 3; ++row, ++v) {
+        if (indices[v] >= 0) {
+          values[indices[v]] += H(row, col);
+        }
+      }
+    }
+  }
+
+  int num_views_ = 0;
+  std::vector<std::pair<int, int> > edges_;
+  Eigen::SparseMatrix<double> matrix_;
+  // 6 + 6 + 9 per edge, for the blocks (a, a), (b, b) and (a, b)
+  std::vector<int> value_indices_;
+  Eigen::SimplicialLDLT<Eigen::SparseMatrix<double>, Eigen::Lower> cholesky_;
+  Eigen::MatrixXd gradient_;
+};
+}  // namespace details
+
+/**
+ * \brief Global rotation and translation averaging on a view graph
+ *
+ * Estimates the poses T_w_i of num_views views from relative measurements
+ * T_ab ~ T_w_a^-1 * T_w_b, e.g. for the initialization of global structure
+ * from motion. View 0 fixes the gauge at the identity.
+ *
+ * averageRotations() starts from the chordal L2 solution, the minimizer of
+ * sum |R_w_b - R_w_a * R_ab|_F^2 over 3x3 matrices projected onto SO(3), and
+ * then minimizes the Cauchy loss of the residuals log(R_ab^-1 * R_w_a^-1 *
+ * R_w_b) with iteratively reweighted Gauss-Newton steps R_w_i * exp(delta_i).
+ * averageTranslations() estimates the view positions p_i for the given
+ * rotations by reweighted least squares on p_b - p_a - R_w_a * t_ab.
+ * Translations must have a consistent metric scale; relative translation
+ * directions alone do not fix it.
+ *
+ * Residuals and Jacobians are evaluated in parallel; the sparse normal
+ * equations are solved with Eigen::SimplicialLDLT.
+ */
+class MotionAveraging {
+ public:
+  typedef std::vector<SO3d, Eigen::aligned_allocator<SO3d> > RotationVector;
+  typedef std::vector<SE3d, Eigen::aligned_allocator<SE3d> > PoseVector;
+
+  explicit MotionAveraging(int num_views) : num_views_(num_views) {
+    SOPHUS_ENSURE(num_views > 0, "num_views must be positive, not %",
+                  num_views);
+  }
+
+  /**
+   * \brief Adds the relative rotation R_ab ~ R_w_a^-1 * R_w_b
+   */
+  void addRelativeRotation(int a, int b, const SO3d& R_ab) {
+    checkEdge(a, b);
+    rotation_edges_.push_back(std::make_pair(a, b));
+    R_ab_.push_back(R_ab);
+    rotation_structure_dirty_ = true;
+  }
+
+  /**
+   * \brief Adds the relative pose T_ab ~ T_w_a^-1 * T_w_b
+   *
+   * Used by both averageRotations() and averageTranslations().
+   */
+  void addRelativePose(int a, int b, const SE3d& T_ab) {
+    addRelativeRotation(a, b, T_ab.so3());
+    translation_edges_.push_back(std::make_pair(a, b));
+    t_ab_.push_back(T_ab.translation());
+    translation_structure_dirty_ = true;
+  }
+
+  int numViews() const { return num_views_; }
+  std::size_t numRotationEdges() const { return rotation_edges_.size(); }
+  std::size_t numTranslationEdges() const { return translation_edges_.size(); }
+
+  /**
+   * \brief Estimates the rotations R_w_i of all views
+   *
+   * Returns false if the rotation graph is not connected.
+   */
+  bool averageRotations(const MotionAveragingOptions& options,
+                        RotationVector* R_w,
+                        MotionAveragingSummary* summary = NULL) {
+    if (rotation_structure_dirty_) {
+      rotation_system_.setStructure(num_views_, rotation_edges_);
+      rotation_structure_dirty_ = false;
+    }
+    if (!chordalRotations(R_w)) {
+      return false;
+    }
+    const std::size_t num_threads = resolveNumThreads(options.num_threads);
+    const std::size_t m = rotation_edges_.size();
+    std::vector<Eigen::Matrix3d, Eigen::aligned_allocator<Eigen::Matrix3d> >
+        jacobians(2 * m);
+    std::vector<Eigen::Vector3d, Eigen::aligned_allocator<Eigen::Vector3d> >
+        residuals(m);
+    std::vector<double> weights(m);
+    const auto linearize = [&](bool with_jacobians) {
+      parallelFor(0, m, num_threads, 256, [&](std::size_t k) {
+        const SO3d& R_a = (*R_w)[rotation_edges_[k].first];
+        const SO3d& R_b = (*R_w)[rotation_edges_[k].second];
+        const SO3d E = R_ab_[k].inverse() * R_a.inverse() * R_b;
+        residuals[k] = E.log();
+        weights[k] = cauchyWeight(residuals[k].squaredNorm(),
+                                  options.rotation_loss_scale);
+        if (with_jacobians) {
+          const Eigen::Map<const Parameters> E_params(E.data());
+          jacobians[2 * k + 1] = K::Dx_log(E_params) *
+                                 K::internalJacobian(E_params);
+          jacobians[2 * k] =
+              -jacobians[2 * k + 1] * (R_b.inverse() * R_a).matrix();
+        }
+      });
+      return cauchyCost(residuals, options.rotation_loss_scale);
+    };
+
+    MotionAveragingSummary local_summary;
+    local_summary.initial_cost = linearize(true);
+    Eigen::MatrixXd delta;
+    for (int iteration = 0; iteration < options.max_iterations; ++iteration) {
+      rotation_system_.setZero(1);
+      for (std::size_t k = 0; k < m; ++k) {
+        rotation_system_.add(static_cast<int>(k), jacobians[2 * k],
+                             jacobians[2 * k + 1], weights[k], residuals[k]);
+      }
+      if (!rotation_system_.solve(&delta)) {
+        return false;
+      }
+      for (int i = 1; i < num_views_; ++i) {
+        (*R_w)[i] =
+            (*R_w)[i] * SO3d::exp(delta.block<3, 1>(3 * i, 0));
+      }
+      ++local_summary.num_iterations;
+      const bool converged = delta.lpNorm<Eigen::Infinity>() <=
+                             options.step_tolerance;
+      local_summary.final_cost = linearize(!converged);
+      if (converged) {
+        local_summary.converged = true;
+        break;
+      }
+    }
+    if (local_summary.num_iterations == 0) {
+      local_summary.final_cost = local_summary.initial_cost;
+    }
+    if (summary) {
+      *summary = local_summary;
+    }
+    return true;
+  }
+
+  /**
+   * \brief Estimates the poses T_w_i for the rotations R_w_i
+   *
+   * Positions come from the relative poses; p_0 = 0. Returns false if the
+   * translation graph is not connected.
+   */
+  bool averageTranslations(const MotionAveragingOptions& options,
+                           const RotationVector& R_w, PoseVector* T_w,
+                           MotionAveragingSummary* summary = NULL) {
+    SOPHUS_ENSURE(static_cast<int>(R_w.size()) == num_views_,
+                  "expected % rotations, not %", num_views_, R_w.size());
+    if (translation_structure_dirty_) {
+      translation_system_.setStructure(num_views_, translation_edges_);
+      translation_structure_dirty_ = false;
+    }
+    const std::size_t num_threads = resolveNumThreads(options.num_threads);
+    const std::size_t m = translation_edges_.size();
+    std::vector<Eigen::Vector3d, Eigen::aligned_allocator<Eigen::Vector3d> >
+        residuals(m);
+    std::vector<double> weights(m, 1.0);
+    Eigen::MatrixXd p = Eigen::MatrixXd::Zero(3 * num_views_, 1);
+    const auto evaluate = [&]() {
+      parallelFor(0, m, num_threads, 1024, [&](std::size_t k) {
+        const int a = translation_edges_[k].first;
+        const int b = translation_edges_[k].second;
+        residuals[k] = p.block<3, 1>(3 * b, 0) - p.block<3, 1>(3 * a, 0) -
+                       R_w[a] * t_ab_[k];
+        weights[k] = cauchyWeight(residuals[k].squaredNorm(),
+                                  options.translation_loss_scale);
+      });
+      return cauchyCost(residuals, options.translation_loss_scale);
+    };
+
+    // The problem is linear: each iteration solves it for the weights of the
+    // previous solution, with residuals taken at p = 0.
+    MotionAveragingSummary local_summary;
+    const Eigen::Matrix3d I = Eigen::Matrix3d::Identity();
+    Eigen::MatrixXd p_new;
+    for (int iteration = 0; iteration < std::max(options.max_iterations, 1);
+         ++iteration) {
+      translation_system_.setZero(1);
+      for (std::size_t k = 0; k < m; ++k) {
+        const int a = translation_edges_[k].first;
+        translation_system_.add(static_cast<int>(k), -I, I, weights[k],
+                                -(R_w[a] * t_ab_[k]));
+      }
+      if (!translation_system_.solve(&p_new)) {
+        return false;
+      }
+      const double step = (p_new - p).lpNorm<Eigen::Infinity>();
+      p = p_new;
+      const double cost = evaluate();
+      if (iteration == 0) {
+        local_summary.initial_cost = cost;
+      }
+      local_summary.final_cost = cost;
+      ++local_summary.num_iterations;
+      if (iteration > 0 && step <= options.step_tolerance) {
+        local_summary.converged = true;
+        break;
+      }
+    }
+    T_w->resize(num_views_);
+    for (int i = 0; i < num_views_; ++i) {
+      (*T_w)[i] = SE3d(R_w[i], p.block<3, 1>(3 * i, 0));
+    }
+    if (summary) {
+      *summary = local_summary;
+    }
+    return true;
+  }
+
+ private:
+  typedef generated::SO3Kernels<double> K;
+  typedef K::Parameters Parameters;
+
+  void checkEdge(int a, int b) const {
+    SOPHUS_ENSURE(a >= 0 && a < num_views_ && b >= 0 && b < num_views_ &&
+                      a != b,
+                  "invalid edge (%, %) of % views", a, b, num_views_);
+  }
+
+  static double cauchyWeight(double r_squared, double c) {
+    return 1 / (1 + r_squared / (c * c));
+  }
+
+  static double cauchyCost(
+      const std::vector<Eigen::Vector3d,
+                        Eigen::aligned_allocator<Eigen::Vector3d> >& r,
+      double c) {
+    double cost = 0;
+    for (const Eigen::Vector3d& r_k : r) {
+      cost += std::log1p(r_k.squaredNorm() / (c * c));
+    }
+    return 0.5 * c * c * cost;
+  }
+
+  // Chordal L2 initialization. The unknowns are the columns of R_w_i^T, so
+  // that each edge reads R_w_b^T - R_ab^T * R_w_a^T = 0.
+  bool chordalRotations(RotationVector* R_w) {
+    const Eigen::Matrix3d I = Eigen::Matrix3d::Identity();
+    rotation_system_.setZero(3);
+    for (std::size_t k = 0; k < rotation_edges_.size(); ++k) {
+      const Eigen::Matrix3d R_ab_T = R_ab_[k].matrix().transpose();
+      // residual at the start point X_0 = I, X_i = 0 otherwise
+      Eigen::Matrix3d r = Eigen::Matrix3d::Zero();
+      if (rotation_edges_[k].first == 0) {
+        r = -R_ab_T;
+      } else if (rotation_edges_[k].second == 0) {
+        r = I;
+      }
+      rotation_system_.add(static_cast<int>(k), -R_ab_T, I, 1.0, r);
+    }
+    Eigen::MatrixXd X;
+    if (!rotation_system_.solve(&X)) {
+      return false;
+    }
+    R_w->resize(num_views_);
+    (*R_w)[0] = SO3d();
+    for (int i = 1; i < num_views_; ++i) {
+      const Eigen::JacobiSVD<Eigen::Matrix3d> svd(
+          X.block<3, 3>(3 * i, 0).transpose(),
+          Eigen::ComputeFullU | Eigen::ComputeFullV);
+      Eigen::Matrix3d D = I;
+      D(2, 2) = (svd.matrixU() * svd.matrixV().transpose()).determinant();
+      const Eigen::Matrix3d R =
+          svd.matrixU() * D * svd.matrixV().transpose();
+      (*R_w)[i] = SO3d(Eigen::Quaterniond(R));
+    }
+    return true;
+  }
+
+  int num_views_;
+  std::vector<std::pair<int, int> > rotation_edges_;
+  std::vector<SO3d, Eigen::aligned_allocator<SO3d> > R_ab_;
+  std::vector<std::pair<int, int> > translation_edges_;
+  std::vector<Eigen::Vector3d, Eigen::aligned_allocator<Eigen::Vector3d> >
+      t_ab_;
+  bool rotation_structure_dirty_ = true;
+  bool translation_structure_dirty_ = true;
+  details::ViewGraphSystem rotation_system_;
+  details::ViewGraphSystem translation_system_;
+};
+}  // namespace Sophus
+
+#endif  // SOPHUS_MOTION_AVERAGING_HPP
@@ -0,0 +1,243 @@
+// This file is part of Sophus.
+//
+// Copyright 2016 Hauke Strasdat
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights  to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#ifndef SOPHUS_PARALLEL_HPP
+#define SOPHUS_PARALLEL_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Sophus {
+
+/**
+ * \returns num_threads, or the number of hardware threads if it is zero
+ */
+inline std::size_t resolveNumThreads(std::size_t num_threads) {
+  if (num_threads > 0) {
+    return num_threads;
+  }
+  return std::max(1u, std::thread::hardware_concurrency());
+}
+
+namespace details {
+// Calls f(worker, i) for the chunks of chunk_size indices of [begin, end)
+// handed out by next_chunk, until none are left.
+template <typename Function>
+void processChunks(std::size_t begin, std::size_t end, std::size_t chunk_size,
+                   std::atomic<std::size_t>* next_chunk, std::size_t worker,
+                   const Function& f) {
+  const std::size_t num_chunks = (end - begin + chunk_size - 1) / chunk_size;
+  for (std::size_t chunk = (*next_chunk)++; chunk < num_chunks;
+       chunk = (*next_chunk)++) {
+    const std::size_t chunk_end =
+        std::min(end, begin + (chunk + 1) * chunk_size);
+    for (std::size_t i = begin + chunk * chunk_size; i < chunk_end; ++i) {
+      f(worker, i);
+    }
+  }
+}
+}  // namespace details
+
+/**
+ * \brief Calls f(worker, i) for all i in [begin, end) on num_threads threads
+ *
+ * Same as parallelFor(), but also passes the index of the calling worker,
+ * in [0, resolveNumThreads(num_threads)), which no two concurrent calls of
+ * f share. This lets f use per-thread scratch buffers.
+ */
+template <typename Function>
+void parallelForWorkers(std::size_t begin, std::size_t end,
+                        std::size_t num_threads, std::size_t chunk_size,
+                        const Function& f) {
+  if (end <= begin) {
+    return;
+  }
+  chunk_size = std::max<std::size_t>(chunk_size, 1);
+  const std::size_t num_chunks = (end - begin + chunk_size - 1) / chunk_size;
+  num_threads = std::min(resolveNumThreads(num_threads), num_chunks);
+  if (num_threads == 1) {
+    for (std::size_t i = begin; i < end; ++i) {
+      f(0, i);
+    }
+    return;
+  }
+
+  std::atomic<std::size_t> next_chunk(0);
+  auto worker = [&](std::size_t w) {
+    details::processChunks(begin, end, chunk_size, &next_chunk, w, f);
+  };
+  std::vector<std::thread> threads;
+  for (std::size_t t = 1; t < num_threads; ++t) {
+    threads.emplace_back(worker, t);
+  }
+  worker(0);
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+}
+
+/**
+ * \brief Calls f(i) for all i in [begin, end) on num_threads threads
+ *
+ * The range is handed out dynamically in chunks of chunk_size indices, so
+ * that uneven work per index is balanced. num_threads = 0 uses all hardware
+ * threads, and the calling thread is one of the workers. f must be safe to
+ * call concurrently for different indices.
+ */
+template <typename Function>
+void parallelFor(std::size_t begin, std::size_t end, std::size_t num_threads,
+                 std::size_t chunk_size, const Function& f) {
+  parallelForWorkers(begin, end, num_threads, chunk_size,
+                     [&f](std::size_t, std::size_t i) { f(i); });
+}
+
+/**
+ * \brief Worker threads for many short parallel loops
+ *
+ * parallelFor() and parallelForWorkers() of a pool behave like the free
+ * functions, but reuse the numThreads() - 1 threads started by the
+ * constructor instead of starting and joining new ones on every call. The
+ * calling thread is worker 0. Loops of one pool must neither be nested nor
+ * run concurrently.
+ */
+class ThreadPool {
+ public:
+  /**
+   * \brief num_threads = 0 uses all hardware threads
+   */
+  explicit ThreadPool(std::size_t num_threads = 0)
+      : num_threads_(resolveNumThreads(num_threads)),
+        job_(nullptr),
+        generation_(0),
+        pending_(0),
+        stop_(false) {
+    for (std::size_t w = 1; w < num_threads_; ++w) {
+      threads_.emplace_back(&ThreadPool::work, this, w);
+    }
+  }
+
+  ~ThreadPool() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    start_.notify_all();
+    for (std::thread& thread : threads_) {
+      thread.join();
+    }
+  }
+
+  std::size_t numThreads() const { return num_threads_; }
+
+  /**
+   * \brief Calls f(worker, i) for all i in [begin, end), with worker in
+   * [0, numThreads())
+   */
+  template <typename Function>
+  void parallelForWorkers(std::size_t begin, std::size_t end,
+                          std::size_t chunk_size, const Function& f) {
+    if (end <= begin) {
+      return;
+    }
+    chunk_size = std::max<std::size_t>(chunk_size, 1);
+    if (num_threads_ == 1 || end - begin <= chunk_size) {
+      for (std::size_t i = begin; i < end; ++i) {
+        f(0, i);
+      }
+      return;
+    }
+    std::atomic<std::size_t> next_chunk(0);
+    run([&](std::size_t w) {
+      details::processChunks(begin, end, chunk_size, &next_chunk, w, f);
+    });
+  }
+
+  /**
+   * \brief Calls f(i) for all i in [begin, end)
+   */
+  template <typename Function>
+  void parallelFor(std::size_t begin, std::size_t end, std::size_t chunk_size,
+                   const Function& f) {
+    parallelForWorkers(begin, end, chunk_size,
+                       [&f](std::size_t, std::size_t i) { f(i); });
+  }
+
+ private:
+  ThreadPool(const ThreadPool&);
+  ThreadPool& operator=(const ThreadPool&);
+
+  // Calls job(w) on every worker w and returns once all calls returned.
+  void run(const std::function<void(std::size_t)>& job) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      job_ = &job;
+      pending_ = threads_.size();
+      ++generation_;
+    }
+    start_.notify_all();
+    job(0);
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_.wait(lock, [this] { return pending_ == 0; });
+    job_ = nullptr;
+  }
+
+  void work(std::size_t worker) {
+    std::size_t generation = 0;
+    for (;;) {
+      const std::function<void(std::size_t)>* job;
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        start_.wait(lock, [&] { return stop_ || generation_ != generation; });
+        if (stop_) {
+          return;
+        }
+        generation = generation_;
+        job = job_;
+      }
+      (*job)(worker);
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (--pending_ == 0) {
+        done_.notify_one();
+      }
+    }
+  }
+
+  std::size_t num_threads_;
+  std::vector<std::thread> threads_;
+  std::mutex mutex_;
+  std::condition_variable start_;
+  std::condition_variable done_;
+  // current job of run(), and number of background workers still in it
+  const std::function<void(std::size_t)>* job_;
+  std::size_t generation_;
+  std::size_t pending_;
+  bool stop_;
+};
+}  // namespace Sophus
+
+#endif  // SOPHUS_PARALLEL_HPP
@@ -0,0 +1,450 @@
+// This file is part of Sophus.
+//
+// Copyright 2016 Hauke Strasdat
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights  to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+
+#ifndef SOPHUS_POSE_CODEC_HPP
+#define SOPHUS_POSE_CODEC_HPP
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+#include "batch.hpp"
+#include "se3.hpp"
+
+namespace Sophus {
+namespace details {
+
+// Little-endian bit stream written to a byte buffer, in fields of up to 32
+// bits. flush() writes the last partial byte.
+class BitWriter {
+ public:
+  explicit BitWriter(std::uint8_t* out) : out_(out), buffer_(0), size_(0) {}
+
+  void write(std::uint32_t value, int num_bits) {
+    buffer_ |= (static_cast<std::uint64_t>(value) &
+                ((std::uint64_t(1) << num_bits) - 1))
+               << size_;
+    size_ += num_bits;
+    while (size_ >= 8) {
+      *out_++ = static_cast<std::uint8_t>(buffer_);
+      buffer_ >>= 8;
+      size_ -= 8;
+    }
+  }
+
+  // Writes value in [-(2^(num_bits-1) - 1), 2^(num_bits-1) - 1].
+  void writeSigned(std::int32_t value, int num_bits) {
+    write(static_cast<std::uint32_t>(static_cast<std::int64_t>(value) +
+                                     (std::int64_t(1) << (num_bits - 1)) - 1),
+          num_bits);
+  }
+
+  void flush() {
+    if (size_ > 0) {
+      *out_++ = static_cast<std::uint8_t>(buffer_);
+      buffer_ = 0;
+      size_ = 0;
+    }
+  }
+
+ private:
+  std::uint8_t* out_;
+  std::uint64_t buffer_;
+  int size_;
+};
+
+// Reads the fields written by BitWriter. Only the bytes holding them are
+// accessed.
+class BitReader {
+ public:
+  explicit BitReader(const std::uint8_t* in) : in_(in), buffer_(0), size_(0) {}
+
+  std::uint32_t read(int num_bits) {
+    while (size_ < num_bits) {
+      buffer_ |= static_cast<std::uint64_t>(*in_++) << size_;
+      size_ += 8;
+    }
+    const std::uint32_t value = static_cast<std::uint32_t>(
+        buffer_ & ((std::uint64_t(1) << num_bits) - 1));
+    buffer_ >>= num_bits;
+    size_ -= num_bits;
+    return value;
+  }
+
+  std::int32_t readSigned(int num_bits) {
+    return static_cast<std::int32_t>(static_cast<std::int64_t>(read(num_bits)) -
+                                     (std::int64_t(1) << (num_bits - 1)) + 1);
+  }
+
+  // bytes touched so far
+  const std::uint8_t* position() const { return in_; }
+
+ private:
+  const std::uint8_t* in_;
+  std::uint64_t buffer_;
+  int size_;
+};
+}  // namespace details
+
+/**
+ * \brief Fixed-size quantized encoding of SE3 poses
+ *
+ * The rotation is stored as the smallest three components of the unit
+ * quaternion (the largest one is made positive, its index takes two bits,
+ * and it is restored from the unit norm), each with rotation_bits bits over
+ * [-1/sqrt(2), 1/sqrt(2)]. The translation is stored in fixed point with the
+ * given resolution and translation_bits bits per axis; larger translations
+ * are clamped to +-translationRange().
+ *
+ * The defaults (12 bits, 1 mm, 20 bits, i.e. +-524 m) take 13 bytes per
+ * pose, down from 56 for SE3d, with errors of at most 1.2e-3 rad and 0.87 mm
+ * (see rotationErrorBound() and translationErrorBound()).
+ *
+ * Batches are quantized with BatchKernels::se3Quantize() and then bit-packed;
+ * each pose starts at a byte boundary.
+ */
+template <typename Scalar>
+class SE3Codec {
+ public:
+  typedef SE3Group<Scalar> Group;
+
+  SE3Codec(int rotation_bits = 12,
+           Scalar translation_resolution = Scalar(1e-3),
+           int translation_bits = 20)
+      : rotation_bits_(rotation_bits), translation_bits_(translation_bits) {
+    using std::floor;
+    using std::nextafter;
+    using std::sqrt;
+    SOPHUS_ENSURE(rotation_bits >= 2 && rotation_bits <= 24,
+                  "rotation_bits must be in [2, 24], not %", rotation_bits);
+    SOPHUS_ENSURE(translation_bits >= 2 && translation_bits <= 32,
+                  "translation_bits must be in [2, 32], not %",
+                  translation_bits);
+    SOPHUS_ENSURE(translation_resolution > 0,
+                  "translation_resolution must be positive, not %",
+                  translation_resolution);
+    scales_[0] = Scalar((std::int64_t(1) << (rotation_bits - 1)) - 1) *
+                 sqrt(Scalar(2));
+    scales_[1] = Scalar(1) / translation_resolution;
+    // The largest code limit which the rounding in se3Quantize() keeps
+    // within translation_bits. For float and translation_bits > 24 the
+    // integer limit itself rounds up, or its rounding does.
+    const std::int64_t limit =
+        (std::int64_t(1) << (translation_bits - 1)) - 1;
+    scales_[2] = Scalar(limit);
+    while (static_cast<std::int64_t>(floor(scales_[2] + Scalar(0.5))) >
+           limit) {
+      scales_[2] = nextafter(scales_[2], Scalar(0));
+    }
+  }
+
+  int rotationBits() const { return rotation_bits_; }
+  int translationBits() const { return translation_bits_; }
+  Scalar translationResolution() const { return Scalar(1) / scales_[1]; }
+
+  int numBits() const { return 2 + 3 * rotation_bits_ + 3 * translation_bits_; }
+  std::size_t numBytes() const { return (numBits() + 7) / 8; }
+
+  /**
+   * \brief Largest rotation angle between a pose and its decoding (radians)
+   *
+   * Each stored component is off by at most d / 2, with the step d = 1 /
+   * (sqrt(2) * (2^(rotation_bits-1) - 1)). Since the restored component is
+   * the largest, it moves by no more than the other three together, so the
+   * unit quaternion moves by at most sqrt(3) * d and the rotation by twice
+   * that, to first order.
+   */
+  Scalar rotationErrorBound() const {
+    using std::sqrt;
+    return 2 * sqrt(Scalar(3)) / scales_[0];
+  }
+
+  /**
+   * \brief Largest translation error of a decoded pose within range
+   */
+  Scalar translationErrorBound() const {
+    using std::sqrt;
+    return sqrt(Scalar(3)) / (2 * scales_[1]);
+  }
+
+  /**
+   * \brief Largest representable absolute translation per axis
+   */
+  Scalar translationRange() const { return scales_[2] / scales_[1]; }
+
+  /**
+   * \brief Writes numBytes() bytes encoding T to out
+   */
+  void encode(const Group& T, std::uint8_t* out) const {
+    encode(T.data(), 1, out);
+  }
+
+  /**
+   * \returns the pose encoded at in
+   */
+  Group decode(const std::uint8_t* in) const {
+    Group T;
+    decode(in, 1, T.data());
+    return T;
+  }
+
+  /**
+   * \brief Encodes n poses (SE3Group parameters) to n * numBytes() bytes
+   */
+  void encode(const Scalar* params, std::size_t n, std::uint8_t* out) const {
+    std::int32_t codes[7 * kBlockSize];
+    const std::size_t num_bytes = numBytes();
+    for (std::size_t begin = 0; begin < n; begin += kBlockSize) {
+      const std::size_t m = n - begin < kBlockSize ? n - begin : kBlockSize;
+      BatchKernels<Scalar>::selected().se3Quantize(
+          params + Group::num_parameters * begin, scales_, codes, m);
+      for (std::size_t i = 0; i < m; ++i) {
+        details::BitWriter writer(out + num_bytes * (begin + i));
+        pack(codes + 7 * i, &writer);
+        writer.flush();
+      }
+    }
+  }
+
+  /**
+   * \brief Decodes n poses from n * numBytes() bytes
+   */
+  void decode(const std::uint8_t* in, std::size_t n, Scalar* params) const {
+    std::int32_t codes[7 * kBlockSize];
+    const std::size_t num_bytes = numBytes();
+    for (std::size_t begin = 0; begin < n; begin += kBlockSize) {
+      const std::size_t m = n - begin < kBlockSize ? n - begin : kBlockSize;
+      for (std::size_t i = 0; i < m; ++i) {
+        details::BitReader reader(in + num_bytes * (begin + i));
+        unpack(&reader, codes + 7 * i);
+      }
+      BatchKernels<Scalar>::selected().se3Dequantize(
+          codes, scales_, params + Group::num_parameters * begin, m);
+    }
+  }
+
+  /**
+   * \brief Appends the numBits() bits encoding T to a bit stream
+   *
+   * \returns the decoded pose
+   */
+  Group write(const Group& T, details::BitWriter* writer) const {
+    std::int32_t codes[7];
+    BatchKernels<Scalar>::selected().se3Quantize(T.data(), scales_, codes, 1);
+    pack(codes, writer);
+    Group decoded;
+    BatchKernels<Scalar>::selected().se3Dequantize(codes, scales_,
+                                                   decoded.data(), 1);
+    return decoded;
+  }
+
+  /**
+   * \brief Reads a pose appended by write()
+   */
+  Group read(details::BitReader* reader) const {
+    std::int32_t codes[7];
+    unpack(reader, codes);
+    Group T;
+    BatchKernels<Scalar>::selected().se3Dequantize(codes, scales_, T.data(),
+                                                   1);
+    return T;
+  }
+
+ private:
+  static const std::size_t kBlockSize = 256;
+
+  void pack(const std::int32_t* codes, details::BitWriter* writer) const {
+    writer->write(static_cast<std::uint32_t>(codes[0]), 2);
+    for (int k = 1; k < 4; ++k) {
+      writer->writeSigned(codes[k], rotation_bits_);
+    }
+    for (int k = 4; k < 7; ++k) {
+      writer->writeSigned(codes[k], translation_bits_);
+    }
+  }
+
+  void unpack(details::BitReader* reader, std::int32_t* codes) const {
+    codes[0] = static_cast<std::int32_t>(reader->read(2));
+    for (int k = 1; k < 4; ++k) {
+      codes[k] = reader->readSigned(rotation_bits_);
+    }
+    for (int k = 4; k < 7; ++k) {
+      codes[k] = reader->readSigned(translation_bits_);
+    }
+  }
+
+  int rotation_bits_;
+  int translation_bits_;
+  // rotation scale, inverse translation resolution, translation code limit
+  Scalar scales_[3];
+};
+
+/**
+ * \brief Delta encoding of a pose stream
+ *
+ * Encodes T_k as the quantized tangent log(T_{k-1}^-1 * T_k), each
+ * component with delta_bits bits and the given resolution (translation part
+ * first, then rotation part, as in SE3Group::Tangent). The reference T_{k-1}
+ * is the previous decoded pose, so that quantization errors do not
+ * accumulate. The first pose, every keyframe_interval-th pose (if positive)
+ * and poses whose delta is out of range are encoded with the key codec
+ * instead. A one-bit flag tells the two cases apart.
+ *
+ * Each encoded pose starts at a byte boundary and takes at most maxBytes()
+ * bytes; with the defaults a delta takes 10 bytes. The error of a delta-coded
+ * pose is at most sqrt(3) / 2 times the resolutions, to first order.
+ *
+ * An instance either encodes or decodes one stream.
+ */
+template <typename Scalar>
+class SE3DeltaCodec {
+ public:
+  typedef SE3Group<Scalar> Group;
+  typedef typename Group::Tangent Tangent;
+
+  explicit SE3DeltaCodec(const SE3Codec<Scalar>& key_codec = SE3Codec<Scalar>(),
+                         Scalar rotation_resolution = Scalar(1e-4),
+                         Scalar translation_resolution = Scalar(1e-4),
+                         int delta_bits = 13, int keyframe_interval = 0)
+      : key_codec_(key_codec),
+        delta_bits_(delta_bits),
+        keyframe_interval_(keyframe_interval),
+        max_code_(Scalar((std::int64_t(1) << (delta_bits - 1)) - 1)),
+        num_since_keyframe_(-1) {
+    SOPHUS_ENSURE(delta_bits >= 2 && delta_bits <= 32,
+                  "delta_bits must be in [2, 32], not %", delta_bits);
+    SOPHUS_ENSURE(rotation_resolution > 0 && translation_resolution > 0,
+                  "resolutions must be positive");
+    resolution_.template head<3>().setConstant(translation_resolution);
+    resolution_.template tail<3>().setConstant(rotation_resolution);
+  }
+
+  std::size_t maxBytes() const {
+    const int delta = 6 * delta_bits_;
+    const int key = key_codec_.numBits();
+    return (1 + (delta > key ? delta : key) + 7) / 8;
+  }
+
+  /**
+   * \brief Encodes the next pose to out
+   *
+   * \returns the number of bytes written
+   */
+  std::size_t encode(const Group& T, std::uint8_t* out) {
+    using std::abs;
+    using std::floor;
+    details::BitWriter writer(out);
+    std::int32_t codes[6];
+    bool key = num_since_keyframe_ < 0 ||
+               (keyframe_interval_ > 0 &&
+                num_since_keyframe_ + 1 >= keyframe_interval_);
+    if (!key) {
+      const Tangent delta =
+          (reference_.inverse() * T).log().cwiseQuotient(resolution_);
+      // Converting an out of range (or NaN) delta to int is undefined, hence
+      // all components are checked before any of them is quantized.
+      for (int k = 0; k < 6; ++k) {
+        key |= !(abs(delta[k]) <= max_code_);
+      }
+      if (!key) {
+        for (int k = 0; k < 6; ++k) {
+          codes[k] = static_cast<std::int32_t>(floor(delta[k] + Scalar(0.5)));
+        }
+      }
+    }
+    writer.write(key ? 1 : 0, 1);
+    if (key) {
+      reference_ = key_codec_.write(T, &writer);
+      num_since_keyframe_ = 0;
+    } else {
+      for (int k = 0; k < 6; ++k) {
+        writer.writeSigned(codes[k], delta_bits_);
+      }
+      reference_ = step(codes);
+      ++num_since_keyframe_;
+    }
+    writer.flush();
+    return numBytes(key);
+  }
+
+  /**
+   * \brief Decodes the next pose from in
+   *
+   * \returns the number of bytes read
+   */
+  std::size_t decode(const std::uint8_t* in, Group* T) {
+    details::BitReader reader(in);
+    const bool key = reader.read(1) != 0;
+    if (key) {
+      reference_ = key_codec_.read(&reader);
+    } else {
+      SOPHUS_ENSURE(num_since_keyframe_ >= 0,
+                    "delta received before the first keyframe");
+      std::int32_t codes[6];
+      for (int k = 0; k < 6; ++k) {
+        codes[k] = reader.readSigned(delta_bits_);
+      }
+      reference_ = step(codes);
+    }
+    num_since_keyframe_ = key ? 0 : num_since_keyframe_ + 1;
+    *T = reference_;
+    return numBytes(key);
+  }
+
+  /**
+   * \brief Forgets the reference, so that the next pose is a keyframe
+   */
+  void reset() { num_since_keyframe_ = -1; }
+
+  /**
+   * \returns the last decoded pose
+   */
+  const Group& reference() const { return reference_; }
+
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+ private:
+  std::size_t numBytes(bool key) const {
+    return (1 + (key ? key_codec_.numBits() : 6 * delta_bits_) + 7) / 8;
+  }
+
+  Group step(const std::int32_t* codes) const {
+    Tangent delta;
+    for (int k = 0; k < 6; ++k) {
+      delta[k] = Scalar(codes[k]) * resolution_[k];
+    }
+    return reference_ * Group::exp(delta);
+  }
+
+  SE3Codec<Scalar> key_codec_;
+  int delta_bits_;
+  int keyframe_interval_;
+  Scalar max_code_;
+  Tangent resolution_;
+  Group reference_;
+  // -1 before the first keyframe
+  int num_since_keyframe_;
+};
+}  // namespace Sophus
+
+#endif  // SOPHUS_POSE_CODEC_HPP
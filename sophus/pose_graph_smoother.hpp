@@ -0,0 +1,419 @@
+// This file is part of Sophus.
+//
+// Copyright 2016 Hauke Strasdat
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights  to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+
+#ifndef SOPHUS_POSE_GRAPH_SMOOTHER_HPP
+#define SOPHUS_POSE_GRAPH_SMOOTHER_HPP
+
+#include <algorithm>
+#include <queue>
+#include <utility>
+#include <vector>
+
+#include <Eigen/Cholesky>
+#include <Eigen/StdVector>
+
+#include "generated/se3_kernels.hpp"
+#include "generated/sim3_kernels.hpp"
+#include "se3.hpp"
+#include "sim3.hpp"
+
+namespace Sophus {
+
+struct PoseGraphSmootherOptions {
+  // A node is relinearized once the largest entry of its tangent update
+  // log(T_lin^-1 * T) exceeds this.
+  double relinearize_threshold = 0.05;
+  // Back-substitution stops at nodes whose update changes by less than this
+  // in every entry. Zero always solves the full system.
+  double wildfire_threshold = 1e-3;
+};
+
+struct PoseGraphUpdateSummary {
+  int num_relinearized_nodes = 0;
+  // Nodes whose column of the Cholesky factor was recomputed.
+  int num_refactored_nodes = 0;
+  // Nodes whose update was recomputed in back-substitution.
+  int num_solved_nodes = 0;
+};
+
+/**
+ * \brief Incremental smoother for pose graphs of SE3 or Sim3 nodes
+ *
+ * Minimizes sum |sqrt_information * log(T_ab^-1 * T_a^-1 * T_b)|^2 over
+ * relative pose factors, plus pose priors |sqrt_information *
+ * log(T_prior^-1 * T)|^2.
+ *
+ * Each node has a linearization point T_lin and an update delta, with the
+ * estimate T_lin * exp(delta). The Gauss-Newton system of all factors,
+ * linearized at T_lin with the closed form Jacobians of the generated
+ * kernels, is kept as a block sparse Cholesky factor with one block column
+ * per node, in the order the nodes were added. update() only recomputes the
+ * columns from the oldest node touched by new factors or by relinearization
+ * onwards, since a change of the information matrix in the trailing block
+ * leaves all columns before it unchanged. Nodes are relinearized only once
+ * their update exceeds PoseGraphSmootherOptions::relinearize_threshold, and
+ * back-substitution only propagates into older nodes where the update
+ * changes by more than PoseGraphSmootherOptions::wildfire_threshold.
+ *
+ * Hence appending a node with odometry costs time independent of the size of
+ * the graph, while a loop closure refactors the nodes of the loop. There is
+ * no reordering, so long loops accumulate fill-in.
+ *
+ * The graph must be anchored, e.g. with a prior on the first node, and every
+ * node must be constrained by a factor before update() is called.
+ */
+template <template <class, int> class Group, template <class> class Kernels>
+class PoseGraphSmoother {
+ public:
+  typedef Group<double, 0> GroupType;
+  typedef Kernels<double> K;
+  static const int DoF = K::DoF;
+  typedef typename K::Tangent Tangent;
+  typedef typename K::Parameters Parameters;
+  typedef Eigen::Matrix<double, DoF, DoF> InformationType;
+  typedef Eigen::Matrix<double, DoF, DoF> Block;
+
+  explicit PoseGraphSmoother(
+      const PoseGraphSmootherOptions& options = PoseGraphSmootherOptions())
+      : options_(options), first_dirty_(0) {}
+
+  /**
+   * \brief Adds a node with initial estimate T and returns its index
+   */
+  int addNode(const GroupType& T) {
+    const int i = numNodes();
+    linearization_points_.push_back(T);
+    deltas_.push_back(Tangent::Zero());
+    node_factors_.push_back(std::vector<int>());
+    diagonal_.push_back(Block::Zero());
+    column_rows_.push_back(std::vector<int>());
+    column_blocks_.push_back(BlockVector());
+    row_entries_.push_back(std::vector<std::pair<int, int> >());
+    forward_.push_back(Tangent::Zero());
+    markers_.push_back(-1);
+    first_dirty_ = std::min(first_dirty_, i);
+    return i;
+  }
+
+  /**
+   * \brief Adds the factor log(T_prior^-1 * T_i)
+   */
+  void addPrior(int i, const GroupType& T_prior,
+                const InformationType& sqrt_information =
+                    InformationType::Identity()) {
+    addFactor(i, -1, T_prior, sqrt_information);
+  }
+
+  /**
+   * \brief Adds the factor log(T_ab^-1 * T_a^-1 * T_b)
+   */
+  void addRelativePose(int a, int b, const GroupType& T_ab,
+                       const InformationType& sqrt_information =
+                           InformationType::Identity()) {
+    SOPHUS_ENSURE(a != b, "Relative pose factor needs two distinct nodes.");
+    addFactor(a, b, T_ab, sqrt_information);
+  }
+
+  /**
+   * \brief Integrates the factors and nodes added since the last call,
+   * relinearizes nodes beyond the threshold and updates the estimates
+   */
+  PoseGraphUpdateSummary update() {
+    PoseGraphUpdateSummary summary;
+
+    // fluid relinearization of the nodes updated by the previous call
+    std::vector<int> relinearized_factors;
+    for (int i : solved_nodes_) {
+      if (deltas_[i].template lpNorm<Eigen::Infinity>() <=
+          options_.relinearize_threshold) {
+        continue;
+      }
+      linearization_points_[i] =
+          linearization_points_[i] * GroupType::exp(deltas_[i]);
+      deltas_[i].setZero();
+      ++summary.num_relinearized_nodes;
+      relinearized_factors.insert(relinearized_factors.end(),
+                                  node_factors_[i].begin(),
+                                  node_factors_[i].end());
+    }
+    std::sort(relinearized_factors.begin(), relinearized_factors.end());
+    relinearized_factors.erase(
+        std::unique(relinearized_factors.begin(), relinearized_factors.end()),
+        relinearized_factors.end());
+    for (int f : relinearized_factors) {
+      linearize(&factors_[f]);
+      first_dirty_ = std::min(first_dirty_, firstNode(factors_[f]));
+    }
+
+    const int n = numNodes();
+    const int k = first_dirty_;
+    // Columns >= k are recomputed, so drop their entries from the rows first.
+    for (int j = k; j < n; ++j) {
+      std::vector<std::pair<int, int> >& row = row_entries_[j];
+      row.erase(std::lower_bound(row.begin(), row.end(),
+                                 std::make_pair(k, -1)),
+                row.end());
+    }
+    for (int j = k; j < n; ++j) {
+      factorColumn(j);
+    }
+    summary.num_refactored_nodes = n - k;
+    first_dirty_ = n;
+
+    backSubstitute(k);
+    summary.num_solved_nodes = static_cast<int>(solved_nodes_.size());
+    return summary;
+  }
+
+  /**
+   * \returns current estimate of node i, T_lin * exp(delta)
+   */
+  GroupType estimate(int i) const {
+    return linearization_points_[i] * GroupType::exp(deltas_[i]);
+  }
+
+  int numNodes() const {
+    return static_cast<int>(linearization_points_.size());
+  }
+
+  int numFactors() const { return static_cast<int>(factors_.size()); }
+
+ private:
+  typedef std::vector<Block, Eigen::aligned_allocator<Block> > BlockVector;
+
+  // Relative pose factor if b >= 0, prior on a otherwise. The Jacobians are
+  // with respect to right perturbations of the linearization points and
+  // already weighted with the square root information.
+  struct Factor {
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+    int a;
+    int b;
+    GroupType measurement_inverse;
+    InformationType sqrt_information;
+    Tangent residual;
+    Block J_a;
+    Block J_b;
+  };
+
+  void addFactor(int a, int b, const GroupType& measurement,
+                 const InformationType& sqrt_information) {
+    SOPHUS_ENSURE(a >= 0 && a < numNodes() && b < numNodes(),
+                  "Node index out of range.");
+    Factor factor;
+    factor.a = a;
+    factor.b = b;
+    factor.measurement_inverse = measurement.inverse();
+    factor.sqrt_information = sqrt_information;
+    linearize(&factor);
+    const int f = numFactors();
+    factors_.push_back(factor);
+    node_factors_[a].push_back(f);
+    if (b >= 0) {
+      node_factors_[b].push_back(f);
+    }
+    first_dirty_ = std::min(first_dirty_, firstNode(factor));
+  }
+
+  static int firstNode(const Factor& factor) {
+    return factor.b < 0 ? factor.a : std::min(factor.a, factor.b);
+  }
+
+  // d log(E * exp(delta)) / d delta at delta = 0
+  static Block logJacobian(const GroupType& E) {
+    const Eigen::Map<const Parameters> E_params(E.data());
+    return K::Dx_log(E_params) * K::internalJacobian(E_params);
+  }
+
+  void linearize(Factor* factor) const {
+    const GroupType& T_a = linearization_points_[factor->a];
+    if (factor->b < 0) {
+      const GroupType E = factor->measurement_inverse * T_a;
+      factor->residual = factor->sqrt_information * E.log();
+      factor->J_a = factor->sqrt_information * logJacobian(E);
+      return;
+    }
+    // With X = T_a^-1 * T_b, exp(-delta) * X = X * exp(-Adj(X^-1) delta).
+    const GroupType& T_b = linearization_points_[factor->b];
+    const GroupType T_ab_inv = T_a.inverse() * T_b;
+    const GroupType E = factor->measurement_inverse * T_ab_inv;
+    factor->residual = factor->sqrt_information * E.log();
+    factor->J_b = factor->sqrt_information * logJacobian(E);
+    factor->J_a = -factor->J_b * T_ab_inv.inverse().Adj();
+  }
+
+  // Recomputes column j of the Cholesky factor and the forward substitution
+  // of node j, assuming all columns before j are up to date.
+  void factorColumn(int j) {
+    const std::vector<std::pair<int, int> >& row = row_entries_[j];
+
+    // column j of the information matrix, rows >= j
+    accumulator_rows_.clear();
+    accumulator_blocks_.clear();
+    Tangent rhs = Tangent::Zero();
+    accumulate(j) = Block::Zero();
+    for (int f : node_factors_[j]) {
+      const Factor& factor = factors_[f];
+      const bool is_a = factor.a == j;
+      const Block& J_j = is_a ? factor.J_a : factor.J_b;
+      accumulate(j).noalias() += J_j.transpose() * J_j;
+      rhs.noalias() -= J_j.transpose() * factor.residual;
+      const int other = factor.b < 0 ? -1 : (is_a ? factor.b : factor.a);
+      if (other > j) {
+        accumulate(other).noalias() +=
+            (is_a ? factor.J_b : factor.J_a).transpose() * J_j;
+      }
+    }
+
+    // left-looking update with the columns c < j which have a row j
+    for (const std::pair<int, int>& entry : row) {
+      const int c = entry.first;
+      const Block& L_jc = column_blocks_[c][entry.second];
+      rhs.noalias() -= L_jc * forward_[c];
+      accumulate(j).noalias() -= L_jc * L_jc.transpose();
+      for (std::size_t t = entry.second + 1; t < column_rows_[c].size();
+           ++t) {
+        accumulate(column_rows_[c][t]).noalias() -=
+            column_blocks_[c][t] * L_jc.transpose();
+      }
+    }
+
+    const Eigen::LLT<Block> llt(accumulator_blocks_[0]);
+    SOPHUS_ENSURE(llt.info() == Eigen::Success,
+                  "Information matrix of node % is not positive definite; "
+                  "is the pose graph anchored?",
+                  j);
+    diagonal_[j] = llt.matrixL();
+    const Eigen::TriangularView<Block, Eigen::Lower> L_jj =
+        diagonal_[j].template triangularView<Eigen::Lower>();
+    forward_[j] = L_jj.solve(rhs);
+
+    // rows below the diagonal, sorted
+    std::vector<int> order(accumulator_rows_.size() - 1);
+    for (std::size_t t = 0; t < order.size(); ++t) {
+      order[t] = static_cast<int>(t) + 1;
+    }
+    std::sort(order.begin(), order.end(), [this](int lhs, int rhs_index) {
+      return accumulator_rows_[lhs] < accumulator_rows_[rhs_index];
+    });
+    column_rows_[j].clear();
+    column_blocks_[j].clear();
+    for (int t : order) {
+      const int i = accumulator_rows_[t];
+      markers_[i] = -1;
+      const int index = static_cast<int>(column_rows_[j].size());
+      column_rows_[j].push_back(i);
+      // L_ij = A_ij * L_jj^-T
+      column_blocks_[j].push_back(
+          L_jj.solve(accumulator_blocks_[t].transpose()).transpose());
+      row_entries_[i].push_back(std::make_pair(j, index));
+    }
+    markers_[j] = -1;
+  }
+
+  // block of row i of the column being factored
+  Block& accumulate(int i) {
+    if (markers_[i] < 0) {
+      markers_[i] = static_cast<int>(accumulator_rows_.size());
+      accumulator_rows_.push_back(i);
+      accumulator_blocks_.push_back(Block::Zero());
+    }
+    return accumulator_blocks_[markers_[i]];
+  }
+
+  // Solves L^T delta = forward for all nodes >= k, and for older nodes as
+  // long as the updates they depend on change by more than the wildfire
+  // threshold.
+  void backSubstitute(int k) {
+    const int n = numNodes();
+    solved_nodes_.clear();
+    std::priority_queue<int> queue;
+    for (int j = k; j < n; ++j) {
+      queue.push(j);
+      markers_[j] = 0;
+    }
+    while (!queue.empty()) {
+      const int j = queue.top();
+      queue.pop();
+      markers_[j] = -1;
+      Tangent x = forward_[j];
+      for (std::size_t t = 0; t < column_rows_[j].size(); ++t) {
+        x.noalias() -=
+            column_blocks_[j][t].transpose() * deltas_[column_rows_[j][t]];
+      }
+      x = diagonal_[j].template triangularView<Eigen::Lower>().transpose()
+              .solve(x);
+      const double change =
+          (x - deltas_[j]).template lpNorm<Eigen::Infinity>();
+      deltas_[j] = x;
+      solved_nodes_.push_back(j);
+      if (change <= options_.wildfire_threshold) {
+        continue;
+      }
+      for (const std::pair<int, int>& entry : row_entries_[j]) {
+        if (entry.first < k && markers_[entry.first] < 0) {
+          markers_[entry.first] = 0;
+          queue.push(entry.first);
+        }
+      }
+    }
+  }
+
+  PoseGraphSmootherOptions options_;
+
+  // nodes
+  std::vector<GroupType, Eigen::aligned_allocator<GroupType> >
+      linearization_points_;
+  std::vector<Tangent, Eigen::aligned_allocator<Tangent> > deltas_;
+  std::vector<std::vector<int> > node_factors_;
+
+  std::vector<Factor, Eigen::aligned_allocator<Factor> > factors_;
+
+  // Cholesky factor L by block columns: diagonal block, and the rows and
+  // blocks below the diagonal. row_entries_[i] lists (column, index into the
+  // column) of the blocks of row i left of the diagonal.
+  BlockVector diagonal_;
+  std::vector<std::vector<int> > column_rows_;
+  std::vector<BlockVector> column_blocks_;
+  std::vector<std::vector<std::pair<int, int> > > row_entries_;
+  // solution of L * forward = -gradient
+  std::vector<Tangent, Eigen::aligned_allocator<Tangent> > forward_;
+
+  // oldest node whose column is out of date
+  int first_dirty_;
+  // nodes solved in the last update, candidates for relinearization
+  std::vector<int> solved_nodes_;
+
+  // scratch space of factorColumn() and backSubstitute()
+  std::vector<int> markers_;
+  std::vector<int> accumulator_rows_;
+  BlockVector accumulator_blocks_;
+};
+
+typedef PoseGraphSmoother<SE3Group, generated::SE3Kernels>
+    SE3PoseGraphSmoother;
+typedef PoseGraphSmoother<Sim3Group, generated::Sim3Kernels>
+    Sim3PoseGraphSmoother;
+}  // namespace Sophus
+
+#endif  // SOPHUS_POSE_GRAPH_SMOOTHER_HPP
@@ -0,0 +1,515 @@
+// This file is part of Sophus.
+//
+// Copyright 2016 Hauke Strasdat
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights  to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+
+#ifndef SOPHUS_RANSAC_HPP
+#define SOPHUS_RANSAC_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include <Eigen/Geometry>
+#include <Eigen/StdVector>
+
+#include "batch.hpp"
+#include "parallel.hpp"
+#include "se3.hpp"
+#include "sim3.hpp"
+
+namespace Sophus {
+
+struct RansacOptions {
+  // A datum is an inlier if its squared error is at most this.
+  double max_squared_error = 1;
+  // Probability of drawing at least one all-inlier sample at termination.
+  double confidence = 0.999;
+  // Bounds on the number of minimal samples drawn.
+  int min_iterations = 0;
+  int max_iterations = 10000;
+  // Refits each new best model to its inliers (LO-RANSAC).
+  bool local_optimization = true;
+  int max_local_iterations = 10;
+  // Rejects models early with Wald's sequential probability ratio test.
+  bool use_sprt = true;
+  // Initial probability that a datum is consistent with a wrong model.
+  double sprt_delta = 0.05;
+  // Initial, and smallest, inlier ratio assumed by the test.
+  double sprt_epsilon = 0.1;
+  // Time to draw a sample and solve for its models, in units of the time to
+  // evaluate the error of one datum.
+  double sprt_time_ratio = 200;
+  // Minimal samples drawn and scored together per thread and round.
+  int samples_per_task = 4;
+  // Zero uses all hardware threads.
+  std::size_t num_threads = 0;
+  unsigned int seed = 0;
+};
+
+template <typename Model>
+struct RansacResult {
+  bool success = false;
+  Model model;
+  // indices of the inliers of model, ascending
+  std::vector<int> inliers;
+  // truncated quadratic (MSAC) cost of model
+  double cost = 0;
+  // number of minimal samples drawn
+  int num_iterations = 0;
+  // number of models rejected by the probability ratio test
+  int num_rejected_models = 0;
+};
+
+namespace details {
+
+/**
+ * \brief Hypothesize-and-verify loop of ransac()
+ *
+ * Each round, every thread draws samples_per_task minimal samples, solves
+ * them and scores all resulting models together: the data are visited in
+ * chunks, and each chunk is handed to Problem::squaredErrors() for all
+ * models still alive, such that the problem can apply several models per
+ * pass over the chunk. After every chunk, models are rejected once their
+ * SPRT likelihood ratio exceeds the decision threshold. The threads are
+ * those of one ThreadPool, kept for all rounds of run(); the best model and
+ * the SPRT parameters are updated by the calling thread between rounds.
+ */
+template <typename Problem>
+class RansacEngine {
+ public:
+  typedef typename Problem::Model Model;
+  typedef std::vector<Model, Eigen::aligned_allocator<Model> > ModelVector;
+  static const int kSampleSize = Problem::kSampleSize;
+  static const std::size_t kChunkSize = 256;
+
+  RansacEngine(const Problem& problem, const RansacOptions& options)
+      : problem_(problem), options_(options) {}
+
+  RansacResult<Model> run() const {
+    RansacResult<Model> result;
+    const std::size_t n = problem_.numData();
+    if (n < static_cast<std::size_t>(kSampleSize)) {
+      return result;
+    }
+    // one task per worker and round; the workers are started once and
+    // reused by all rounds
+    ThreadPool pool(options_.num_threads);
+    const std::size_t num_tasks = pool.numThreads();
+    std::vector<TaskResult, Eigen::aligned_allocator<TaskResult> > tasks(
+        num_tasks);
+    std::vector<Scratch> scratch(num_tasks);
+
+    Model best_model;
+    Score best;
+    double epsilon = options_.sprt_epsilon;
+    double delta = options_.sprt_delta;
+    double rejected_evaluated = 0;
+    double rejected_consistent = 0;
+    int required_iterations = options_.max_iterations;
+    for (int round = 0;
+         result.num_iterations < options_.max_iterations &&
+         (result.num_iterations < required_iterations ||
+          result.num_iterations < options_.min_iterations);
+         ++round) {
+      const double log_A = sprtLogThreshold(epsilon, delta);
+      pool.parallelFor(0, num_tasks, 1, [&](std::size_t t) {
+        runTask(round * num_tasks + t, epsilon, delta, log_A, &scratch[t],
+                &tasks[t]);
+      });
+      result.num_iterations +=
+          static_cast<int>(num_tasks) * options_.samples_per_task;
+
+      bool improved = false;
+      for (const TaskResult& task : tasks) {
+        result.num_rejected_models += task.num_rejected;
+        rejected_evaluated += task.rejected_evaluated;
+        rejected_consistent += task.rejected_consistent;
+        if (task.score.cost < best.cost) {
+          best = task.score;
+          best_model = task.model;
+          improved = true;
+        }
+      }
+      if (!improved) {
+        continue;
+      }
+      if (options_.local_optimization) {
+        localOptimization(&best_model, &best, &scratch[0]);
+      }
+      epsilon = std::max(options_.sprt_epsilon,
+                         static_cast<double>(best.num_inliers) / n);
+      if (rejected_evaluated > 0) {
+        delta = std::min(std::max(rejected_consistent / rejected_evaluated,
+                                  1e-4),
+                         0.5);
+      }
+      required_iterations = requiredIterations(
+          static_cast<double>(best.num_inliers) / n,
+          sprtLogThreshold(epsilon, delta));
+    }
+
+    if (best.num_inliers >= kSampleSize) {
+      result.success = true;
+      result.model = best_model;
+      result.cost = fullScore(best_model, &result.inliers, &scratch[0]).cost;
+    }
+    return result;
+  }
+
+ private:
+  struct Score {
+    Score()
+        : cost(std::numeric_limits<double>::infinity()),
+          num_inliers(0),
+          num_evaluated(0),
+          log_lambda(0),
+          rejected(false) {}
+
+    double cost;
+    int num_inliers;
+    int num_evaluated;
+    double log_lambda;
+    bool rejected;
+  };
+
+  struct TaskResult {
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+    Model model;
+    Score score;
+    int num_rejected;
+    double rejected_evaluated;
+    double rejected_consistent;
+  };
+
+  // Buffers of one task, kept between rounds.
+  struct Scratch {
+    ModelVector models;
+    ModelVector alive_models;
+    std::vector<Score> scores;
+    std::vector<int> alive;
+    std::vector<double> errors;
+    // passed on to Problem::squaredErrors()
+    std::vector<double> problem;
+  };
+
+  // log of the SPRT decision threshold A, infinite if the test is disabled
+  // or cannot discriminate. A solves A = time_ratio * C + 1 + log(A), see
+  // Matas and Chum, "Randomized RANSAC with sequential probability ratio
+  // test".
+  double sprtLogThreshold(double epsilon, double delta) const {
+    if (!options_.use_sprt || !(epsilon > delta)) {
+      return std::numeric_limits<double>::infinity();
+    }
+    using std::log;
+    const double C = (1 - delta) * log((1 - delta) / (1 - epsilon)) +
+                     delta * log(delta / epsilon);
+    const double A_0 = options_.sprt_time_ratio * C + 1;
+    double A = A_0;
+    for (int i = 0; i < 10; ++i) {
+      A = A_0 + log(A);
+    }
+    return log(A);
+  }
+
+  // Number of samples after which an all-inlier sample was drawn and
+  // accepted with probability confidence.
+  int requiredIterations(double inlier_ratio, double log_A) const {
+    using std::log;
+    using std::pow;
+    double p = pow(inlier_ratio, kSampleSize);
+    if (log_A < std::numeric_limits<double>::infinity()) {
+      // a good model is rejected with probability about 1 / A
+      p *= 1 - std::exp(-log_A);
+    }
+    if (!(p > 0)) {
+      return options_.max_iterations;
+    }
+    if (p >= 1) {
+      return 1;
+    }
+    const double k = log(1 - options_.confidence) / log(1 - p);
+    return k < options_.max_iterations ? static_cast<int>(std::ceil(k))
+                                       : options_.max_iterations;
+  }
+
+  void runTask(std::size_t task_index, double epsilon, double delta,
+               double log_A, Scratch* scratch, TaskResult* task) const {
+    std::seed_seq seed{options_.seed, static_cast<unsigned int>(task_index)};
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> uniform(
+        0, static_cast<int>(problem_.numData()) - 1);
+    ModelVector& models = scratch->models;
+    models.clear();
+    int sample[kSampleSize];
+    for (int s = 0; s < options_.samples_per_task; ++s) {
+      for (int i = 0; i < kSampleSize; ++i) {
+        do {
+          sample[i] = uniform(rng);
+        } while (std::find(sample, sample + i, sample[i]) != sample + i);
+      }
+      problem_.solveMinimal(sample, &models);
+    }
+
+    score(epsilon, delta, log_A, scratch);
+    const std::vector<Score>& scores = scratch->scores;
+    task->score = Score();
+    task->num_rejected = 0;
+    task->rejected_evaluated = 0;
+    task->rejected_consistent = 0;
+    for (std::size_t h = 0; h < models.size(); ++h) {
+      if (scores[h].rejected) {
+        ++task->num_rejected;
+        task->rejected_evaluated += scores[h].num_evaluated;
+        task->rejected_consistent += scores[h].num_inliers;
+      } else if (scores[h].cost < task->score.cost) {
+        task->score = scores[h];
+        task->model = models[h];
+      }
+    }
+  }
+
+  // MSAC scores of all scratch->models, with SPRT if log_A is finite, to
+  // scratch->scores.
+  void score(double epsilon, double delta, double log_A,
+             Scratch* scratch) const {
+    using std::log;
+    const double threshold = options_.max_squared_error;
+    const double log_consistent = log(delta / epsilon);
+    const double log_inconsistent = log((1 - delta) / (1 - epsilon));
+    const std::size_t n = problem_.numData();
+    const ModelVector& models = scratch->models;
+    std::vector<Score>* scores = &scratch->scores;
+    std::vector<int>& alive = scratch->alive;
+    ModelVector& alive_models = scratch->alive_models;
+    std::vector<double>& errors = scratch->errors;
+    scores->assign(models.size(), Score());
+    alive.resize(models.size());
+    for (std::size_t h = 0; h < alive.size(); ++h) {
+      alive[h] = static_cast<int>(h);
+    }
+    alive_models.assign(models.begin(), models.end());
+    errors.resize(std::max(errors.size(), models.size() * kChunkSize));
+    for (std::size_t begin = 0; begin < n && !alive.empty();
+         begin += kChunkSize) {
+      const std::size_t end = std::min(n, begin + kChunkSize);
+      const std::size_t m = end - begin;
+      problem_.squaredErrors(alive_models.data(), alive_models.size(), begin,
+                             end, errors.data(), &scratch->problem);
+      std::size_t num_alive = 0;
+      for (std::size_t a = 0; a < alive.size(); ++a) {
+        Score& s = (*scores)[alive[a]];
+        const double* errors_a = &errors[a * m];
+        int num_inliers = 0;
+        double cost = 0;
+        for (std::size_t i = 0; i < m; ++i) {
+          const bool inlier = errors_a[i] <= threshold;
+          num_inliers += inlier;
+          cost += inlier ? errors_a[i] : threshold;
+        }
+        s.cost = (begin == 0 ? 0 : s.cost) + cost;
+        s.num_inliers += num_inliers;
+        s.num_evaluated += static_cast<int>(m);
+        s.log_lambda += num_inliers * log_consistent +
+                        (static_cast<int>(m) - num_inliers) * log_inconsistent;
+        if (s.log_lambda > log_A) {
+          s.rejected = true;
+          continue;
+        }
+        alive[num_alive] = alive[a];
+        alive_models[num_alive] = alive_models[a];
+        ++num_alive;
+      }
+      alive.resize(num_alive);
+      alive_models.resize(num_alive);
+    }
+  }
+
+  // Score of a single model without early termination, and its inliers.
+  Score fullScore(const Model& model, std::vector<int>* inliers,
+                  Scratch* scratch) const {
+    const std::size_t n = problem_.numData();
+    Score s;
+    s.cost = 0;
+    inliers->clear();
+    std::vector<double>& errors = scratch->errors;
+    errors.resize(std::max<std::size_t>(errors.size(), kChunkSize));
+    for (std::size_t begin = 0; begin < n; begin += kChunkSize) {
+      const std::size_t end = std::min(n, begin + kChunkSize);
+      problem_.squaredErrors(&model, 1, begin, end, errors.data(),
+                             &scratch->problem);
+      for (std::size_t i = begin; i < end; ++i) {
+        const double e = errors[i - begin];
+        if (e <= options_.max_squared_error) {
+          inliers->push_back(static_cast<int>(i));
+          s.cost += e;
+        } else {
+          s.cost += options_.max_squared_error;
+        }
+      }
+    }
+    s.num_inliers = static_cast<int>(inliers->size());
+    s.num_evaluated = static_cast<int>(n);
+    return s;
+  }
+
+  // Refits the model to its inliers as long as this lowers the cost.
+  void localOptimization(Model* model, Score* best, Scratch* scratch) const {
+    std::vector<int> inliers;
+    *best = fullScore(*model, &inliers, scratch);
+    for (int i = 0; i < options_.max_local_iterations; ++i) {
+      Model refined = *model;
+      if (static_cast<int>(inliers.size()) < kSampleSize ||
+          !problem_.solveNonMinimal(inliers, &refined)) {
+        return;
+      }
+      std::vector<int> refined_inliers;
+      const Score s = fullScore(refined, &refined_inliers, scratch);
+      if (!(s.cost < best->cost)) {
+        return;
+      }
+      *model = refined;
+      *best = s;
+      inliers.swap(refined_inliers);
+    }
+  }
+
+  const Problem& problem_;
+  RansacOptions options_;
+};
+}  // namespace details
+
+/**
+ * \brief Robustly estimates a model with RANSAC
+ *
+ * Problem provides the minimal solver and the error function:
+ *
+ *   typedef ... Model;
+ *   static const int kSampleSize;
+ *   std::size_t numData() const;
+ *   // appends all models consistent with the minimal sample
+ *   void solveMinimal(const int* sample, ModelVector* models) const;
+ *   // least squares fit to the inliers, starting from the estimate in *m;
+ *   // false on failure
+ *   bool solveNonMinimal(const std::vector<int>& inliers, Model* m) const;
+ *   // errors[h * (end - begin) + i - begin] = squared error of datum i
+ *   // under models[h], for i in [begin, end); scratch belongs to the
+ *   // calling thread and is kept between calls
+ *   void squaredErrors(const Model* models, std::size_t num_models,
+ *                      std::size_t begin, std::size_t end, double* errors,
+ *                      std::vector<double>* scratch) const;
+ *
+ * with ModelVector = std::vector<Model, Eigen::aligned_allocator<Model> >.
+ * The problem is used concurrently from several threads. Models are ranked
+ * by their truncated quadratic (MSAC) cost. See RansacOptions for the early
+ * rejection, local optimization and threading.
+ */
+template <typename Problem>
+RansacResult<typename Problem::Model> ransac(
+    const Problem& problem,
+    const RansacOptions& options = RansacOptions()) {
+  return details::RansacEngine<Problem>(problem, options).run();
+}
+
+/**
+ * \brief Registration of 3D point pairs, dst_i = T * src_i, for SE3Group or
+ * Sim3Group
+ *
+ * The minimal and non-minimal solvers are the closed form of Umeyama, with
+ * scale for Sim3Group. The squared errors |T * src_i - dst_i|^2 of several
+ * models are evaluated together with BatchKernels::affineSquaredErrors.
+ * The point buffers hold 3 scalars per point and must outlive the problem.
+ */
+template <typename Group>
+class PointRegistrationProblem {
+ public:
+  typedef Group Model;
+  typedef std::vector<Model, Eigen::aligned_allocator<Model> > ModelVector;
+  static const int kSampleSize = 3;
+
+  PointRegistrationProblem(const double* src, const double* dst,
+                           std::size_t n)
+      : src_(src), dst_(dst), n_(n) {}
+
+  std::size_t numData() const { return n_; }
+
+  void solveMinimal(const int* sample, ModelVector* models) const {
+    const Eigen::Map<const Eigen::Vector3d> a(src_ + 3 * sample[0]);
+    const Eigen::Map<const Eigen::Vector3d> b(src_ + 3 * sample[1]);
+    const Eigen::Map<const Eigen::Vector3d> c(src_ + 3 * sample[2]);
+    const double scale = std::max((b - a).squaredNorm(), (c - a).squaredNorm());
+    // collinear samples do not determine the rotation
+    if (!((b - a).cross(c - a).squaredNorm() > 1e-12 * scale * scale)) {
+      return;
+    }
+    const std::vector<int> indices(sample, sample + kSampleSize);
+    Model model;
+    if (solveNonMinimal(indices, &model)) {
+      models->push_back(model);
+    }
+  }
+
+  bool solveNonMinimal(const std::vector<int>& inliers, Model* model) const {
+    const int m = static_cast<int>(inliers.size());
+    Eigen::Matrix<double, 3, Eigen::Dynamic> src(3, m), dst(3, m);
+    for (int i = 0; i < m; ++i) {
+      src.col(i) = Eigen::Map<const Eigen::Vector3d>(src_ + 3 * inliers[i]);
+      dst.col(i) = Eigen::Map<const Eigen::Vector3d>(dst_ + 3 * inliers[i]);
+    }
+    const Eigen::Matrix4d T =
+        Eigen::umeyama(src, dst, Group::DoF == 7 /* with_scaling */);
+    if (!T.allFinite() || !(T.topLeftCorner<3, 3>().determinant() > 0)) {
+      return false;
+    }
+    *model = Group(T);
+    return true;
+  }
+
+  void squaredErrors(const Model* models, std::size_t num_models,
+                     std::size_t begin, std::size_t end, double* errors,
+                     std::vector<double>* scratch) const {
+    typedef Eigen::Matrix<double, 3, 3, Eigen::RowMajor> RowMajorMatrix3d;
+    std::vector<double>& maps = *scratch;
+    maps.resize(std::max(maps.size(), 12 * num_models));
+    for (std::size_t h = 0; h < num_models; ++h) {
+      const Eigen::Matrix4d T = models[h].matrix();
+      Eigen::Map<RowMajorMatrix3d> M(&maps[12 * h]);
+      Eigen::Map<Eigen::Vector3d> t(&maps[12 * h + 9]);
+      M = T.topLeftCorner<3, 3>();
+      t = T.topRightCorner<3, 1>();
+    }
+    BatchKernels<double>::selected().affineSquaredErrors(
+        maps.data(), num_models, src_ + 3 * begin, dst_ + 3 * begin, errors,
+        end - begin);
+  }
+
+ private:
+  const double* src_;
+  const double* dst_;
+  std::size_t n_;
+};
+}  // namespace Sophus
+
+#endif  // SOPHUS_RANSAC_HPP
@@ -0,0 +1,172 @@
+// This file is part of Sophus.
+//
+// Copyright 2016 Hauke Strasdat
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights  to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+
+#ifndef SOPHUS_RIGID_BODY_ARRAY_HPP
+#define SOPHUS_RIGID_BODY_ARRAY_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+#include "batch.hpp"
+#include "map_array.hpp"
+#include "parallel.hpp"
+
+namespace Sophus {
+
+/**
+ * \brief Poses and body-frame twists of many rigid bodies
+ *
+ * Stores the state in struct of arrays layout: the unit quaternions (x, y,
+ * z, w), the translations and the twists (upsilon, omega) of all bodies in
+ * three separate packed arrays. Each body is accessible as an
+ * Eigen::Map<SE3Group> over its quaternion and translation, so that it can
+ * be passed to any code taking SE3GroupBase, and poses() gives MapArray
+ * views of all bodies.
+ *
+ * integrate() applies T_i = T_i * exp(dt * xi_i) to all bodies with
+ * BatchKernels::se3IntegrateSplit(), which updates as many bodies at once as
+ * the vector registers of the selected instruction set level hold, optionally
+ * split into blocks of kBlockSize bodies across threads.
+ */
+template <typename Scalar>
+class RigidBodyArray {
+ public:
+  typedef SE3Group<Scalar> Group;
+  typedef typename Group::Tangent Tangent;
+  static const int kQuaternionSize = SO3Group<Scalar>::num_parameters;
+
+  // Bodies per block of integrate(); the state of a block (13 scalars per
+  // body) fits into the L1 cache.
+  static const std::size_t kBlockSize = 256;
+
+  /**
+   * \brief size bodies at the identity, at rest
+   */
+  explicit RigidBodyArray(std::size_t size = 0) { resize(size); }
+
+  std::size_t size() const { return translations_.size() / 3; }
+
+  /**
+   * \brief Resizes to size bodies, new bodies are at the identity, at rest
+   */
+  void resize(std::size_t size) {
+    const std::size_t old_size = this->size();
+    quaternions_.resize(kQuaternionSize * size, Scalar(0));
+    translations_.resize(3 * size, Scalar(0));
+    twists_.resize(6 * size, Scalar(0));
+    for (std::size_t i = old_size; i < size; ++i) {
+      quaternions_[kQuaternionSize * i + 3] = Scalar(1);
+    }
+  }
+
+  void reserve(std::size_t size) {
+    quaternions_.reserve(kQuaternionSize * size);
+    translations_.reserve(3 * size);
+    twists_.reserve(6 * size);
+  }
+
+  /**
+   * \brief Appends a body and returns its index
+   */
+  template <typename Derived>
+  std::size_t addBody(const SE3GroupBase<Derived>& T,
+                      const Tangent& xi = Tangent::Zero()) {
+    const std::size_t i = size();
+    resize(i + 1);
+    pose(i) = T;
+    twist(i) = xi;
+    return i;
+  }
+
+  Eigen::Map<Group> pose(std::size_t i) {
+    return Eigen::Map<Group>(&translations_[3 * i],
+                             &quaternions_[kQuaternionSize * i]);
+  }
+
+  Eigen::Map<const Group> pose(std::size_t i) const {
+    return Eigen::Map<const Group>(&translations_[3 * i],
+                                   &quaternions_[kQuaternionSize * i]);
+  }
+
+  Eigen::Map<Tangent> twist(std::size_t i) {
+    return Eigen::Map<Tangent>(&twists_[6 * i]);
+  }
+
+  Eigen::Map<const Tangent> twist(std::size_t i) const {
+    return Eigen::Map<const Tangent>(&twists_[6 * i]);
+  }
+
+  MapArray<Group> poses() {
+    return MapArray<Group>(translations_.data(), 3, quaternions_.data(),
+                           kQuaternionSize, size());
+  }
+
+  MapArray<const Group> poses() const {
+    return MapArray<const Group>(translations_.data(), 3,
+                                 quaternions_.data(), kQuaternionSize,
+                                 size());
+  }
+
+  // packed arrays of 4, 3 and 6 scalars per body
+  Scalar* quaternions() { return quaternions_.data(); }
+  const Scalar* quaternions() const { return quaternions_.data(); }
+  Scalar* translations() { return translations_.data(); }
+  const Scalar* translations() const { return translations_.data(); }
+  Scalar* twists() { return twists_.data(); }
+  const Scalar* twists() const { return twists_.data(); }
+
+  /**
+   * \brief Advances all bodies by dt with constant twists
+   *
+   * Zero num_threads uses all hardware threads.
+   */
+  void integrate(Scalar dt, std::size_t num_threads = 1) {
+    const typename BatchKernels<Scalar>::IntegrateSplitFunction kernel =
+        BatchKernels<Scalar>::selected().se3IntegrateSplit;
+    const std::size_t n = size();
+    const std::size_t num_blocks = (n + kBlockSize - 1) / kBlockSize;
+    if (num_blocks <= 1 || resolveNumThreads(num_threads) == 1) {
+      if (n > 0) {
+        kernel(quaternions_.data(), translations_.data(), twists_.data(), dt,
+               n);
+      }
+      return;
+    }
+    parallelFor(0, num_blocks, num_threads, 1, [&](std::size_t block) {
+      const std::size_t begin = block * kBlockSize;
+      const std::size_t count =
+          std::min(static_cast<std::size_t>(kBlockSize), n - begin);
+      kernel(&quaternions_[kQuaternionSize * begin], &translations_[3 * begin],
+             &twists_[6 * begin], dt, count);
+    });
+  }
+
+ private:
+  std::vector<Scalar> quaternions_;
+  std::vector<Scalar> translations_;
+  std::vector<Scalar> twists_;
+};
+}  // namespace Sophus
+
+#endif  // SOPHUS_RIGID_BODY_ARRAY_HPP
@@ -267,7 +267,7 @@ class RxSO3GroupBase {
     quaternion() *= other.quaternion();
     Scalar scale = this->scale();
     if (scale < SophusConstants<Scalar>::epsilon()) {
-      SOPHUS_ENSURE(scale > 0, "Scale must be greater zero.");
+      SOPHUS_ENSURE(scale > static_cast<Scalar>(0), "Scale must be greater zero.");
       // Saturation to ensure class invariant.
       quaternion().normalize();
       quaternion().coeffs() *= sqrt(SophusConstants<Scalar>::epsilon());
@@ -315,7 +315,7 @@ class RxSO3GroupBase {
   inline void setRotationMatrix(const Transformation& R) {
     Scalar saved_scale = scale();
     quaternion() = R;
-    quaternion() *= saved_scale;
+    quaternion().coeffs() *= saved_scale;
   }
 
   /**
@@ -520,7 +520,8 @@ class RxSO3GroupBase {
    * \see logAndTheta()
    * \see vee()
    */
-  inline static Tangent log(const RxSO3Group<Scalar>& other) {
+  template <typename OtherDerived>
+  inline static Tangent log(const RxSO3GroupBase<OtherDerived>& other) {
     Scalar theta;
     return logAndTheta(other, &theta);
   }
@@ -535,7 +536,8 @@ class RxSO3GroupBase {
    *
    * \see log() for details
    */
-  inline static Tangent logAndTheta(const RxSO3Group<Scalar>& other,
+  template <typename OtherDerived>
+  inline static Tangent logAndTheta(const RxSO3GroupBase<OtherDerived>& other,
                                     Scalar* theta) {
     using std::log;
 
@@ -543,7 +545,8 @@ class RxSO3GroupBase {
     Tangent omega_sigma;
     omega_sigma[3] = log(scale);
     omega_sigma.template head<3>() = SO3Group<Scalar>::logAndTheta(
-        SO3Group<Scalar>(other.quaternion()), theta);
+        SO3Group<Scalar>(Eigen::Quaternion<Scalar>(other.quaternion())),
+        theta);
     return omega_sigma;
   }
 
@@ -617,7 +620,7 @@ class RxSO3Group : public RxSO3GroupBase<RxSO3Group<_Scalar, _Options> > {
    * \pre matrix need to be "scaled orthogonal" with positive determinant
    */
   inline explicit RxSO3Group(const Transformation& sR) {
-    setScaledRotationMatrix(sR);
+    this->setScaledRotationMatrix(sR);
   }
 
   /**
@@ -675,6 +678,78 @@ class RxSO3Group : public RxSO3GroupBase<RxSO3Group<_Scalar, _Options> > {
   Eigen::Quaternion<Scalar> quaternion_;
 };
 
+/**
+ * \brief Group multiplication into existing storage
+ *
+ * Computes *out = a * b for any storage of out, a and b (e.g. Eigen::Map),
+ * without the intermediate group objects of operator*(). The scale is
+ * saturated as in RxSO3GroupBase::operator*=(); out may alias a or b.
+ */
+template <typename OutDerived, typename ADerived, typename BDerived>
+inline void composeInto(RxSO3GroupBase<OutDerived>* out,
+                        const RxSO3GroupBase<ADerived>& a,
+                        const RxSO3GroupBase<BDerived>& b) {
+  using std::sqrt;
+  typedef typename RxSO3GroupBase<OutDerived>::Scalar Scalar;
+  Eigen::Quaternion<Scalar> q = a.quaternion() * b.quaternion();
+  const Scalar scale = q.squaredNorm();
+  if (scale < SophusConstants<Scalar>::epsilon()) {
+    SOPHUS_ENSURE(scale > static_cast<Scalar>(0),
+                  "Scale must be greater zero.");
+    q.normalize();
+    q.coeffs() *= sqrt(SophusConstants<Scalar>::epsilon());
+  }
+  Eigen::Map<Eigen::Matrix<Scalar, 4, 1> >(out->data()) = q.coeffs();
+}
+
+/**
+ * \brief Group inverse into existing storage
+ *
+ * Computes *out = a^-1, i.e. the conjugate quaternion divided by the scale;
+ * out may alias a.
+ */
+template <typename OutDerived, typename ADerived>
+inline void inverseInto(RxSO3GroupBase<OutDerived>* out,
+                        const RxSO3GroupBase<ADerived>& a) {
+  typedef typename RxSO3GroupBase<OutDerived>::Scalar Scalar;
+  Scalar* q = out->data();
+  const Scalar* q_a = a.data();
+  const Scalar inv_scale = static_cast<Scalar>(1) / a.scale();
+  q[0] = -q_a[0] * inv_scale;
+  q[1] = -q_a[1] * inv_scale;
+  q[2] = -q_a[2] * inv_scale;
+  q[3] = q_a[3] * inv_scale;
+}
+
+/**
+ * \brief Group exponential into existing storage
+ *
+ * Computes *out = exp(a) as RxSO3Group::expAndTheta(), see expInto() of SO3;
+ * sets *theta = |omega| unless theta is null.
+ */
+template <typename OutDerived, typename TangentDerived>
+inline void expInto(RxSO3GroupBase<OutDerived>* out,
+                    const Eigen::MatrixBase<TangentDerived>& a,
+                    typename RxSO3GroupBase<OutDerived>::Scalar* theta = NULL) {
+  using std::exp;
+  using std::sqrt;
+  typedef typename RxSO3GroupBase<OutDerived>::Scalar Scalar;
+  Eigen::Map<SO3Group<Scalar> > rotation(out->data());
+  expInto(&rotation, a.template head<3>(), theta);
+  Eigen::Map<Eigen::Matrix<Scalar, 4, 1> >(out->data()) *= sqrt(exp(a[3]));
+}
+
+/**
+ * \brief Logarithmic map into existing storage
+ *
+ * Computes *out = log(a) for any storage of a and any 4-vector out.
+ */
+template <typename OutDerived, typename ADerived>
+inline void logInto(Eigen::MatrixBase<OutDerived>* out,
+                    const RxSO3GroupBase<ADerived>& a) {
+  *out = RxSO3GroupBase<ADerived>::log(a);
+}
+
 }  // end namespace
 
 namespace Eigen {
@@ -783,4 +858,14 @@ class Map<const Sophus::RxSO3Group<_Scalar>, _Options>
 };
 }
 
+#ifdef SOPHUS_USE_INSTANTIATIONS
+// Instantiated in sophus/instantiations.cpp
+namespace Sophus {
+extern template class RxSO3GroupBase<RxSO3Group<double> >;
+extern template class RxSO3Group<double>;
+extern template class RxSO3GroupBase<RxSO3Group<float> >;
+extern template class RxSO3Group<float>;
+}
+#endif
+
 #endif  // SOPHUS_RXSO3_HPP
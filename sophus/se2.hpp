@@ -169,8 +169,8 @@ class SE2GroupBase {
   inline Transformation matrix() const {
     Transformation homogenious_matrix;
     homogenious_matrix.setIdentity();
-    homogenious_matrix.block(0, 0, 2, 2) = rotationMatrix();
-    homogenious_matrix.col(2).head(2) = translation();
+    homogenious_matrix.template topLeftCorner<2, 2>() = rotationMatrix();
+    homogenious_matrix.col(2).template head<2>() = translation();
     return homogenious_matrix;
   }
 
@@ -259,8 +259,9 @@ class SE2GroupBase {
    * \pre     the 2x2 matrix should be orthogonal and have a determinant of 1
    */
   inline void setRotationMatrix(const Eigen::Matrix<Scalar, 2, 2>& R) {
-    so2().setComplex(static_cast<Scalar>(0.5) * (R(0, 0) + R(1, 1)),
-                     static_cast<Scalar>(0.5) * (R(1, 0) - R(0, 1)));
+    so2().setComplex(Eigen::Matrix<Scalar, 2, 1>(
+        static_cast<Scalar>(0.5) * (R(0, 0) + R(1, 1)),
+        static_cast<Scalar>(0.5) * (R(1, 0) - R(0, 1))));
   }
 
   /**
@@ -347,12 +348,14 @@ class SE2GroupBase {
    * \see log()
    */
   inline static SE2Group<Scalar> exp(const Tangent& a) {
+    using std::abs;
+
     Scalar theta = a[2];
     SO2Group<Scalar> so2 = SO2Group<Scalar>::exp(theta);
     Scalar sin_theta_by_theta;
     Scalar one_minus_cos_theta_by_theta;
 
-    if (std::abs(theta) < SophusConstants<Scalar>::epsilon()) {
+    if (abs(theta) < SophusConstants<Scalar>::epsilon()) {
       Scalar theta_sq = theta * theta;
       sin_theta_by_theta =
           static_cast<Scalar>(1.) - static_cast<Scalar>(1. / 6.) * theta_sq;
@@ -469,17 +472,19 @@ class SE2GroupBase {
    * \see exp()
    * \see vee()
    */
-  inline static Tangent log(const SE2Group<Scalar>& other) {
+  template <typename OtherDerived>
+  inline static Tangent log(const SE2GroupBase<OtherDerived>& other) {
+    using std::abs;
+
     Tangent upsilon_theta;
-    const SO2Group<Scalar>& so2 = other.so2();
-    Scalar theta = SO2Group<Scalar>::log(so2);
+    Scalar theta = SO2Group<Scalar>::log(other.so2());
     upsilon_theta[2] = theta;
     Scalar halftheta = static_cast<Scalar>(0.5) * theta;
     Scalar halftheta_by_tan_of_halftheta;
 
-    const Eigen::Matrix<Scalar, 2, 1>& z = so2.unit_complex();
+    const Eigen::Matrix<Scalar, 2, 1> z = other.unit_complex();
     Scalar real_minus_one = z.x() - static_cast<Scalar>(1.);
-    if (std::abs(real_minus_one) < SophusConstants<Scalar>::epsilon()) {
+    if (abs(real_minus_one) < SophusConstants<Scalar>::epsilon()) {
       halftheta_by_tan_of_halftheta =
           static_cast<Scalar>(1.) -
           static_cast<Scalar>(1. / 12) * theta * theta;
@@ -599,7 +604,7 @@ class SE2Group : public SE2GroupBase<SE2Group<_Scalar, _Options> > {
    * \pre 2x2 sub-matrix need to be orthogonal with determinant of 1
    */
   inline explicit SE2Group(const Transformation& T)
-      : so2_(T.template topLeftCorner<2, 2>()),
+      : so2_(Eigen::Matrix<Scalar, 2, 2>(T.template topLeftCorner<2, 2>())),
         translation_(T.template block<2, 1>(0, 2)) {}
 
   /**
@@ -658,6 +663,85 @@ class SE2Group : public SE2GroupBase<SE2Group<_Scalar, _Options> > {
   Eigen::Matrix<Scalar, 2, 1> translation_;
 };
 
+/**
+ * \brief Group multiplication into existing storage
+ *
+ * Computes *out = a * b for any storage of out, a and b (e.g. Eigen::Map),
+ * without the intermediate group objects of operator*(); out may alias a or
+ * b.
+ */
+template <typename OutDerived, typename ADerived, typename BDerived>
+inline void composeInto(SE2GroupBase<OutDerived>* out,
+                        const SE2GroupBase<ADerived>& a,
+                        const SE2GroupBase<BDerived>& b) {
+  typedef typename SE2GroupBase<OutDerived>::Point Point;
+  const Point translation = a.so2() * Point(b.translation()) + a.translation();
+  composeInto(&out->so2(), a.so2(), b.so2());
+  out->translation() = translation;
+}
+
+/**
+ * \brief Group inverse into existing storage
+ *
+ * Computes *out = a^-1; out may alias a.
+ */
+template <typename OutDerived, typename ADerived>
+inline void inverseInto(SE2GroupBase<OutDerived>* out,
+                        const SE2GroupBase<ADerived>& a) {
+  typedef typename SE2GroupBase<OutDerived>::Scalar Scalar;
+  typedef typename SE2GroupBase<OutDerived>::Point Point;
+  const Scalar real = a.unit_complex().x();
+  const Scalar imag = a.unit_complex().y();
+  const Point t = a.translation();
+  const Point translation(-real * t[0] - imag * t[1],
+                          imag * t[0] - real * t[1]);
+  inverseInto(&out->so2(), a.so2());
+  out->translation() = translation;
+}
+
+/**
+ * \brief Group exponential into existing storage
+ *
+ * Computes *out = exp(a) as SE2Group::exp(), see expInto() of SO2.
+ */
+template <typename OutDerived, typename TangentDerived>
+inline void expInto(SE2GroupBase<OutDerived>* out,
+                    const Eigen::MatrixBase<TangentDerived>& a) {
+  using std::abs;
+  typedef typename SE2GroupBase<OutDerived>::Scalar Scalar;
+  typedef typename SE2GroupBase<OutDerived>::Point Point;
+  const Scalar theta = a[2];
+  expInto(&out->so2(), theta);
+  Scalar sin_theta_by_theta;
+  Scalar one_minus_cos_theta_by_theta;
+  if (abs(theta) < SophusConstants<Scalar>::epsilon()) {
+    const Scalar theta_sq = theta * theta;
+    sin_theta_by_theta =
+        static_cast<Scalar>(1.) - static_cast<Scalar>(1. / 6.) * theta_sq;
+    one_minus_cos_theta_by_theta =
+        static_cast<Scalar>(0.5) * theta -
+        static_cast<Scalar>(1. / 24.) * theta * theta_sq;
+  } else {
+    sin_theta_by_theta = out->unit_complex().y() / theta;
+    one_minus_cos_theta_by_theta =
+        (static_cast<Scalar>(1.) - out->unit_complex().x()) / theta;
+  }
+  out->translation() =
+      Point(sin_theta_by_theta * a[0] - one_minus_cos_theta_by_theta * a[1],
+            one_minus_cos_theta_by_theta * a[0] + sin_theta_by_theta * a[1]);
+}
+
+/**
+ * \brief Logarithmic map into existing storage
+ *
+ * Computes *out = log(a) for any storage of a and any 3-vector out.
+ */
+template <typename OutDerived, typename ADerived>
+inline void logInto(Eigen::MatrixBase<OutDerived>* out,
+                    const SE2GroupBase<ADerived>& a) {
+  *out = SE2GroupBase<ADerived>::log(a);
+}
+
 }  // end namespace
 
 namespace Eigen {
@@ -705,6 +789,10 @@ class Map<Sophus::SE2Group<_Scalar>, _Options>
       : so2_(coeffs),
         translation_(coeffs + Sophus::SO2Group<Scalar>::num_parameters) {}
 
+  EIGEN_STRONG_INLINE
+  Map(Scalar* trans_coeffs, Scalar* rot_coeffs)
+      : so2_(rot_coeffs), translation_(trans_coeffs) {}
+
   /**
    * \brief Mutator of SO2
    */
@@ -777,7 +865,7 @@ class Map<const Sophus::SE2Group<_Scalar>, _Options>
 
   EIGEN_STRONG_INLINE
   Map(const Scalar* trans_coeffs, const Scalar* rot_coeffs)
-      : translation_(trans_coeffs), so2_(rot_coeffs) {}
+      : so2_(rot_coeffs), translation_(trans_coeffs) {}
 
   /**
    * \brief Accessor of SO2
@@ -797,4 +885,14 @@ class Map<const Sophus::SE2Group<_Scalar>, _Options>
 };
 }
 
+#ifdef SOPHUS_USE_INSTANTIATIONS
+// Instantiated in sophus/instantiations.cpp
+namespace Sophus {
+extern template class SE2GroupBase<SE2Group<double> >;
+extern template class SE2Group<double>;
+extern template class SE2GroupBase<SE2Group<float> >;
+extern template class SE2Group<float>;
+}
+#endif
+
 #endif
@@ -24,6 +24,7 @@
 #ifndef SOPHUS_SE3_HPP
 #define SOPHUS_SE3_HPP
 
+#include "generated/se3_kernels.hpp"
 #include "so3.hpp"
 
 ////////////////////////////////////////////////////////////////////////////
@@ -77,6 +78,7 @@ namespace Sophus {
 using std::abs;
 using std::cos;
 using std::sin;
+using std::tan;
 
 /**
  * \brief SE3 base type - implements SE3 class but is storage agnostic
@@ -296,7 +298,7 @@ class SE3GroupBase {
    *
    * deprecated: use rotationMatrix() instead.
    */
-  typedef Transformation M3_marcos_dont_like_commas;
+  typedef Eigen::Matrix<Scalar, 3, 3> M3_marcos_dont_like_commas;
   EIGEN_DEVICE_FUNC EIGEN_STRONG_INLINE
       EIGEN_DEPRECATED const M3_marcos_dont_like_commas
       rotation_matrix() const {
@@ -333,7 +335,7 @@ class SE3GroupBase {
    */
   EIGEN_DEVICE_FUNC EIGEN_STRONG_INLINE void setAffine3(
       const Eigen::Transform<Scalar, 3, Eigen::Affine>& affine3) {
-    so3().setRotationMatrix(affine3.matrix().template topLeftCorner<3, 3>());
+    setRotationMatrix(affine3.matrix().template topLeftCorner<3, 3>());
     translation() = affine3.matrix().template topRightCorner<3, 1>();
   }
 
@@ -433,6 +435,10 @@ class SE3GroupBase {
    */
   EIGEN_DEVICE_FUNC EIGEN_STRONG_INLINE static SE3Group<Scalar> exp(
       const Tangent& a) {
+    if (AutoDiffTraits<Scalar>::enabled) {
+      return details::ChainRule<Scalar>::template exp<
+          SE3Group, generated::SE3Kernels>(a);
+    }
     const Eigen::Matrix<Scalar,3,1> omega = a.template tail<3>();
 
     Scalar theta;
@@ -603,8 +609,13 @@ class SE3GroupBase {
    * \see exp()
    * \see vee()
    */
+  template <typename OtherDerived>
   EIGEN_DEVICE_FUNC EIGEN_STRONG_INLINE static Tangent log(
-      const SE3Group<Scalar>& se3) {
+      const SE3GroupBase<OtherDerived>& se3) {
+    if (AutoDiffTraits<Scalar>::enabled) {
+      return details::ChainRule<Scalar>::template log<
+          SE3Group, generated::SE3Kernels>(SE3Group<Scalar>(se3));
+    }
     Tangent upsilon_omega;
     Scalar theta;
     upsilon_omega.template tail<3>() =
@@ -812,6 +823,82 @@ class SE3Group : public SE3GroupBase<SE3Group<_Scalar, _Options> > {
   Eigen::Matrix<Scalar, 3, 1> translation_;
 };
 
+/**
+ * \brief Group multiplication into existing storage
+ *
+ * Computes *out = a * b for any storage of out, a and b (e.g. Eigen::Map),
+ * without the intermediate group objects of operator*(); out may alias a or
+ * b.
+ */
+template <typename OutDerived, typename ADerived, typename BDerived>
+EIGEN_DEVICE_FUNC EIGEN_STRONG_INLINE void composeInto(
+    SE3GroupBase<OutDerived>* out, const SE3GroupBase<ADerived>& a,
+    const SE3GroupBase<BDerived>& b) {
+  typedef typename SE3GroupBase<OutDerived>::Point Point;
+  const Point translation =
+      a.unit_quaternion()._transformVector(b.translation()) + a.translation();
+  composeInto(&out->so3(), a.so3(), b.so3());
+  out->translation() = translation;
+}
+
+/**
+ * \brief Group inverse into existing storage
+ *
+ * Computes *out = a^-1; out may alias a.
+ */
+template <typename OutDerived, typename ADerived>
+EIGEN_DEVICE_FUNC EIGEN_STRONG_INLINE void inverseInto(
+    SE3GroupBase<OutDerived>* out, const SE3GroupBase<ADerived>& a) {
+  typedef typename SE3GroupBase<OutDerived>::Point Point;
+  const Point translation =
+      -a.unit_quaternion().conjugate()._transformVector(a.translation());
+  inverseInto(&out->so3(), a.so3());
+  out->translation() = translation;
+}
+
+/**
+ * \brief Group exponential into existing storage
+ *
+ * Computes *out = exp(a) as SE3Group::exp(), see expInto() of SO3.
+ */
+template <typename OutDerived, typename TangentDerived>
+EIGEN_DEVICE_FUNC EIGEN_STRONG_INLINE void expInto(
+    SE3GroupBase<OutDerived>* out,
+    const Eigen::MatrixBase<TangentDerived>& a) {
+  typedef typename SE3GroupBase<OutDerived>::Scalar Scalar;
+  typedef Eigen::Matrix<Scalar, 3, 3> Matrix3;
+  if (AutoDiffTraits<Scalar>::enabled) {
+    static_cast<OutDerived&>(*out) = SE3Group<Scalar>::exp(a);
+    return;
+  }
+  const Eigen::Matrix<Scalar, 3, 1> omega = a.template tail<3>();
+  const Eigen::Matrix<Scalar, 3, 1> upsilon = a.template head<3>();
+  Scalar theta;
+  expInto(&out->so3(), omega, &theta);
+  if (theta < SophusConstants<Scalar>::epsilon()) {
+    out->translation() = out->unit_quaternion()._transformVector(upsilon);
+  } else {
+    const Matrix3 Omega = SO3Group<Scalar>::hat(omega);
+    const Scalar theta_sq = theta * theta;
+    const Matrix3 V =
+        Matrix3::Identity() +
+        (static_cast<Scalar>(1) - cos(theta)) / theta_sq * Omega +
+        (theta - sin(theta)) / (theta_sq * theta) * (Omega * Omega);
+    out->translation() = V * upsilon;
+  }
+}
+
+/**
+ * \brief Logarithmic map into existing storage
+ *
+ * Computes *out = log(a) for any storage of a and any 6-vector out.
+ */
+template <typename OutDerived, typename ADerived>
+EIGEN_DEVICE_FUNC EIGEN_STRONG_INLINE void logInto(
+    Eigen::MatrixBase<OutDerived>* out, const SE3GroupBase<ADerived>& a) {
+  *out = SE3GroupBase<ADerived>::log(a);
+}
+
 }  // end namespace
 
 namespace Eigen {
@@ -858,6 +945,10 @@ class Map<Sophus::SE3Group<_Scalar>, _Options>
       : so3_(coeffs),
         translation_(coeffs + Sophus::SO3Group<Scalar>::num_parameters) {}
 
+  EIGEN_DEVICE_FUNC EIGEN_STRONG_INLINE Map(Scalar* trans_coeffs,
+                                            Scalar* rot_coeffs)
+      : so3_(rot_coeffs), translation_(trans_coeffs) {}
+
   /**
    * \brief Mutator of SO3
    */
@@ -932,7 +1023,7 @@ class Map<const Sophus::SE3Group<_Scalar>, _Options>
 
   EIGEN_DEVICE_FUNC EIGEN_STRONG_INLINE Map(const Scalar* trans_coeffs,
                                             const Scalar* rot_coeffs)
-      : translation_(trans_coeffs), so3_(rot_coeffs) {}
+      : so3_(rot_coeffs), translation_(trans_coeffs) {}
 
   /**
    * \brief Accessor of SO3
@@ -955,4 +1046,14 @@ class Map<const Sophus::SE3Group<_Scalar>, _Options>
 };
 }
 
+#ifdef SOPHUS_USE_INSTANTIATIONS
+// Instantiated in sophus/instantiations.cpp
+namespace Sophus {
+extern template class SE3GroupBase<SE3Group<double> >;
+extern template class SE3Group<double>;
+extern template class SE3GroupBase<SE3Group<float> >;
+extern template class SE3Group<float>;
+}
+#endif
+
 #endif
@@ -23,6 +23,7 @@
 #ifndef SOPHUS_SIM3_HPP
 #define SOPHUS_SIM3_HPP
 
+#include "generated/sim3_kernels.hpp"
 #include "rxso3.hpp"
 
 ////////////////////////////////////////////////////////////////////////////
@@ -255,7 +256,8 @@ class Sim3GroupBase {
    *
    * deprecated: use rotationMatrix() instead.
    */
-  inline EIGEN_DEPRECATED const Transformation rotation_matrix() const {
+  inline EIGEN_DEPRECATED const Eigen::Matrix<Scalar, 3, 3> rotation_matrix()
+      const {
     return rxso3().rotationMatrix();
   }
 
@@ -376,6 +378,10 @@ class Sim3GroupBase {
    * \see log()
    */
   inline static Sim3Group<Scalar> exp(const Tangent& a) {
+    if (AutoDiffTraits<Scalar>::enabled) {
+      return details::ChainRule<Scalar>::template exp<
+          Sim3Group, generated::Sim3Kernels>(a);
+    }
     const Eigen::Matrix<Scalar, 3, 1>& upsilon = a.segment(0, 3);
     const Eigen::Matrix<Scalar, 3, 1>& omega = a.segment(3, 3);
     Scalar sigma = a[6];
@@ -521,7 +527,12 @@ class Sim3GroupBase {
    * \see exp()
    * \see vee()
    */
-  inline static Tangent log(const Sim3Group<Scalar>& other) {
+  template <typename OtherDerived>
+  inline static Tangent log(const Sim3GroupBase<OtherDerived>& other) {
+    if (AutoDiffTraits<Scalar>::enabled) {
+      return details::ChainRule<Scalar>::template log<
+          Sim3Group, generated::Sim3Kernels>(Sim3Group<Scalar>(other));
+    }
     Tangent res;
     Scalar theta;
     Eigen::Matrix<Scalar, 4, 1> omega_sigma =
@@ -530,8 +541,8 @@ class Sim3GroupBase {
     Scalar sigma = omega_sigma[3];
     Eigen::Matrix<Scalar, 3, 3> W_inv =
         calcWInv(theta, sigma, other.scale(), SO3Group<Scalar>::hat(omega));
-    res.segment(0, 3) = W_inv * other.translation();
-    res.segment(3, 3) = omega;
+    res.template head<3>() = W_inv * other.translation();
+    res.template segment<3>(3) = omega;
     res[6] = sigma;
     return res;
   }
@@ -773,6 +784,70 @@ class Sim3Group : public Sim3GroupBase<Sim3Group<_Scalar, _Options> > {
   Eigen::Matrix<Scalar, 3, 1> translation_;
 };
 
+/**
+ * \brief Group multiplication into existing storage
+ *
+ * Computes *out = a * b for any storage of out, a and b (e.g. Eigen::Map),
+ * without the intermediate group objects of operator*(); out may alias a or
+ * b.
+ */
+template <typename OutDerived, typename ADerived, typename BDerived>
+inline void composeInto(Sim3GroupBase<OutDerived>* out,
+                        const Sim3GroupBase<ADerived>& a,
+                        const Sim3GroupBase<BDerived>& b) {
+  typedef typename Sim3GroupBase<OutDerived>::Point Point;
+  const Point translation =
+      a.rxso3() * Point(b.translation()) + a.translation();
+  composeInto(&out->rxso3(), a.rxso3(), b.rxso3());
+  out->translation() = translation;
+}
+
+/**
+ * \brief Group inverse into existing storage
+ *
+ * Computes *out = a^-1; out may alias a.
+ */
+template <typename OutDerived, typename ADerived>
+inline void inverseInto(Sim3GroupBase<OutDerived>* out,
+                        const Sim3GroupBase<ADerived>& a) {
+  typedef typename Sim3GroupBase<OutDerived>::Point Point;
+  const Point translation = a.translation();
+  inverseInto(&out->rxso3(), a.rxso3());
+  out->translation() = -(out->rxso3() * translation);
+}
+
+/**
+ * \brief Group exponential into existing storage
+ *
+ * Computes *out = exp(a) with the closed form of generated::Sim3Kernels,
+ * which writes the parameters directly instead of composing W from RxSO3.
+ */
+template <typename OutDerived, typename TangentDerived>
+inline void expInto(Sim3GroupBase<OutDerived>* out,
+                    const Eigen::MatrixBase<TangentDerived>& a) {
+  typedef typename Sim3GroupBase<OutDerived>::Scalar Scalar;
+  typedef generated::Sim3Kernels<Scalar> Kernels;
+  if (AutoDiffTraits<Scalar>::enabled) {
+    static_cast<OutDerived&>(*out) = Sim3Group<Scalar>::exp(a);
+    return;
+  }
+  const typename Kernels::Parameters params = Kernels::exp(a);
+  Eigen::Map<Eigen::Matrix<Scalar, 4, 1> >(out->rxso3().data()) =
+      params.template head<4>();
+  out->translation() = params.template tail<3>();
+}
+
+/**
+ * \brief Logarithmic map into existing storage
+ *
+ * Computes *out = log(a) for any storage of a and any 7-vector out.
+ */
+template <typename OutDerived, typename ADerived>
+inline void logInto(Eigen::MatrixBase<OutDerived>* out,
+                    const Sim3GroupBase<ADerived>& a) {
+  *out = Sim3GroupBase<ADerived>::log(a);
+}
+
 }  // end namespace
 
 namespace Eigen {
@@ -821,6 +896,10 @@ class Map<Sophus::Sim3Group<_Scalar>, _Options>
       : rxso3_(coeffs),
         translation_(coeffs + Sophus::RxSO3Group<Scalar>::num_parameters) {}
 
+  EIGEN_STRONG_INLINE
+  Map(Scalar* trans_coeffs, Scalar* rot_coeffs)
+      : rxso3_(rot_coeffs), translation_(trans_coeffs) {}
+
   /**
    * \brief Mutator of RxSO3
    */
@@ -894,7 +973,7 @@ class Map<const Sophus::Sim3Group<_Scalar>, _Options>
 
   EIGEN_STRONG_INLINE
   Map(const Scalar* trans_coeffs, const Scalar* rot_coeffs)
-      : translation_(trans_coeffs), rxso3_(rot_coeffs) {}
+      : rxso3_(rot_coeffs), translation_(trans_coeffs) {}
 
   /**
    * \brief Accessor of RxSO3
@@ -914,4 +993,14 @@ class Map<const Sophus::Sim3Group<_Scalar>, _Options>
 };
 }
 
+#ifdef SOPHUS_USE_INSTANTIATIONS
+// Instantiated in sophus/instantiations.cpp
+namespace Sophus {
+extern template class Sim3GroupBase<Sim3Group<double> >;
+extern template class Sim3Group<double>;
+extern template class Sim3GroupBase<Sim3Group<float> >;
+extern template class Sim3Group<float>;
+}
+#endif
+
 #endif
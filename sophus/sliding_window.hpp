@@ -0,0 +1,744 @@
+// This file is part of Sophus.
+//
+// Copyright 2016 Hauke Strasdat
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights  to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+
+#ifndef SOPHUS_SLIDING_WINDOW_HPP
+#define SOPHUS_SLIDING_WINDOW_HPP
+
+#include <algorithm>
+#include <vector>
+
+#include <Eigen/Cholesky>
+#include <Eigen/StdVector>
+
+#include "generated/se3_kernels.hpp"
+#include "se3.hpp"
+
+namespace Sophus {
+
+struct SlidingWindowOptions {
+  int max_iterations = 10;
+  double initial_lambda = 1e-4;
+  // Converged if the relative cost decrease of a step is below this.
+  double function_tolerance = 1e-10;
+  // Converged if the largest entry of a step is below this.
+  double parameter_tolerance = 1e-10;
+  // Evaluates the Jacobians of all factors at the first estimates of the
+  // states in the marginalization prior, which keeps the unobservable
+  // directions of the prior and of the factors consistent.
+  bool first_estimate_jacobians = true;
+};
+
+struct SlidingWindowSummary {
+  double initial_cost = 0;
+  double final_cost = 0;
+  // Number of linear solves, including rejected steps.
+  int num_iterations = 0;
+  int num_successful_iterations = 0;
+  bool converged = false;
+};
+
+/**
+ * \brief Fixed-lag smoother over a window of the latest WindowSize states
+ *
+ * A state is an SE3 pose T together with ExtraDoF Euclidean entries x, e.g.
+ * velocity and IMU biases, updated as T * exp(delta_T) and x + delta_x.
+ * Minimizes 0.5 * sum |r|^2 of pose and state priors, relative pose factors
+ * log(T_ab^-1 * T_a^-1 * T_b) and relative factors x_b - x_a - d on the
+ * Euclidean part, plus the marginalization prior, with Levenberg-Marquardt.
+ *
+ * Adding a state to a full window marginalizes the oldest one: the factors
+ * connected to it, linearized at the current estimates, and the previous
+ * prior are reduced onto the remaining states by the Schur complement and
+ * kept as a quadratic around the first estimates of these states. With
+ * SlidingWindowOptions::first_estimate_jacobians, the Jacobians of every
+ * factor are evaluated at these first estimates as well.
+ *
+ * The information matrix and the prior are stored as WindowSize x
+ * WindowSize arrays of fixed-size DoF x DoF blocks and solved with a block
+ * Cholesky factorization, so that adding states and optimizing allocates
+ * nothing once the factor storage reached its steady size.
+ */
+template <int WindowSize, int ExtraDoF = 0>
+class SlidingWindowEstimator {
+ public:
+  static const int DoF = 6 + ExtraDoF;
+  typedef SE3Group<double> SE3Type;
+  typedef generated::SE3Kernels<double> K;
+  typedef Eigen::Matrix<double, ExtraDoF, 1> Extra;
+  typedef Eigen::Matrix<double, DoF, 1> Tangent;
+  typedef Eigen::Matrix<double, DoF, DoF> Block;
+  typedef Eigen::Matrix<double, 6, 6> PoseInformation;
+  typedef Eigen::Matrix<double, ExtraDoF, ExtraDoF> ExtraInformation;
+
+  explicit SlidingWindowEstimator(
+      const SlidingWindowOptions& options = SlidingWindowOptions())
+      : options_(options),
+        first_id_(0),
+        next_id_(0),
+        poses_(WindowSize),
+        extras_(WindowSize),
+        first_poses_(WindowSize),
+        first_extras_(WindowSize),
+        in_prior_(WindowSize, false),
+        saved_poses_(WindowSize),
+        saved_extras_(WindowSize),
+        prior_constant_(0),
+        H_(WindowSize * WindowSize),
+        g_(WindowSize),
+        prior_H_(WindowSize * WindowSize, Block::Zero()),
+        prior_g_(WindowSize, Tangent::Zero()),
+        L_(WindowSize * WindowSize),
+        step_(WindowSize),
+        W_(WindowSize),
+        order_(WindowSize) {
+    static_assert(WindowSize >= 2, "the window needs at least two states");
+  }
+
+  /**
+   * \brief Adds the newest state and returns its id
+   *
+   * Ids count up from zero. If the window is full, the oldest state is
+   * marginalized first.
+   */
+  int addState(const SE3Type& pose, const Extra& extra = Extra::Zero()) {
+    if (numStates() == WindowSize) {
+      marginalizeOldest();
+    }
+    const int s = slot(next_id_);
+    poses_[s] = pose;
+    extras_[s] = extra;
+    in_prior_[s] = false;
+    return next_id_++;
+  }
+
+  /**
+   * \brief Adds the prior sqrt_information * (log(T_prior^-1 * T), x - x_prior)
+   */
+  void addPrior(int id, const SE3Type& T_prior, const Extra& x_prior,
+                const Block& sqrt_information = Block::Identity()) {
+    Factor& factor = newFactor(Factor::kPrior, id, -1);
+    factor.measurement_inverse = T_prior.inverse();
+    factor.extra_measurement = x_prior;
+    factor.sqrt_information = sqrt_information;
+  }
+
+  /**
+   * \brief Adds the prior sqrt_information * log(T_prior^-1 * T)
+   */
+  void addPosePrior(int id, const SE3Type& T_prior,
+                    const PoseInformation& sqrt_information =
+                        PoseInformation::Identity()) {
+    Block sqrt_information_block = Block::Zero();
+    sqrt_information_block.template topLeftCorner<6, 6>() = sqrt_information;
+    addPrior(id, T_prior, Extra::Zero(), sqrt_information_block);
+  }
+
+  /**
+   * \brief Adds the factor sqrt_information * log(T_ab^-1 * T_a^-1 * T_b)
+   */
+  void addRelativePose(int a, int b, const SE3Type& T_ab,
+                       const PoseInformation& sqrt_information =
+                           PoseInformation::Identity()) {
+    SOPHUS_ENSURE(a != b, "Relative pose factor needs two distinct states.");
+    Factor& factor = newFactor(Factor::kRelativePose, a, b);
+    factor.measurement_inverse = T_ab.inverse();
+    factor.sqrt_information.template topLeftCorner<6, 6>() = sqrt_information;
+  }
+
+  /**
+   * \brief Adds the factor sqrt_information * (x_b - x_a - d)
+   */
+  void addRelativeExtra(int a, int b, const Extra& d,
+                        const ExtraInformation& sqrt_information =
+                            ExtraInformation::Identity()) {
+    static_assert(ExtraDoF > 0, "the states have no Euclidean part");
+    SOPHUS_ENSURE(a != b, "Relative factor needs two distinct states.");
+    Factor& factor = newFactor(Factor::kRelativeExtra, a, b);
+    factor.extra_measurement = d;
+    factor.sqrt_information.template bottomRightCorner<ExtraDoF, ExtraDoF>() =
+        sqrt_information;
+  }
+
+  /**
+   * \brief Optimizes the states of the window
+   */
+  SlidingWindowSummary optimize() {
+    SlidingWindowSummary summary;
+    const int n = numStates();
+    for (int i = 0; i < n; ++i) {
+      order_[i] = slot(first_id_ + i);
+    }
+    double cost = evaluate(true);
+    assemble();
+    summary.initial_cost = cost;
+
+    double lambda = options_.initial_lambda;
+    double nu = 2;
+    while (summary.num_iterations < options_.max_iterations) {
+      ++summary.num_iterations;
+      if (!solve(n, lambda)) {
+        lambda *= nu;
+        nu *= 2;
+        continue;
+      }
+      double max_step = 0;
+      for (int i = 0; i < n; ++i) {
+        max_step = std::max(
+            max_step, step_[order_[i]].template lpNorm<Eigen::Infinity>());
+      }
+      if (max_step <= options_.parameter_tolerance) {
+        summary.converged = true;
+        break;
+      }
+
+      const double predicted = predictedDecrease(n);
+      for (int i = 0; i < n; ++i) {
+        const int s = order_[i];
+        saved_poses_[s] = poses_[s];
+        saved_extras_[s] = extras_[s];
+        poses_[s] =
+            poses_[s] * SE3Type::exp(step_[s].template head<6>());
+        extras_[s] += step_[s].template tail<ExtraDoF>();
+      }
+      const double new_cost = evaluate(false);
+      const double actual = cost - new_cost;
+      if (predicted > 0 && actual > 0) {
+        ++summary.num_successful_iterations;
+        const double rho = actual / predicted;
+        const double tmp = 2 * rho - 1;
+        lambda *= std::max(1.0 / 3.0, 1 - tmp * tmp * tmp);
+        nu = 2;
+        const bool small_decrease =
+            actual <= options_.function_tolerance * cost;
+        cost = evaluate(true);
+        assemble();
+        if (small_decrease) {
+          summary.converged = true;
+          break;
+        }
+      } else {
+        for (int i = 0; i < n; ++i) {
+          const int s = order_[i];
+          poses_[s] = saved_poses_[s];
+          extras_[s] = saved_extras_[s];
+        }
+        lambda *= nu;
+        nu *= 2;
+      }
+    }
+    summary.final_cost = cost;
+    return summary;
+  }
+
+  const SE3Type& pose(int id) const {
+    checkState(id);
+    return poses_[slot(id)];
+  }
+
+  const Extra& extra(int id) const {
+    checkState(id);
+    return extras_[slot(id)];
+  }
+
+  // id of the oldest state in the window
+  int oldestState() const { return first_id_; }
+
+  int numStates() const { return next_id_ - first_id_; }
+
+  int numFactors() const { return static_cast<int>(factors_.size()); }
+
+  // Whether state id is part of the marginalization prior.
+  bool inPrior(int id) const {
+    checkState(id);
+    return in_prior_[slot(id)];
+  }
+
+ private:
+  typedef std::vector<Block, Eigen::aligned_allocator<Block> > BlockVector;
+  typedef std::vector<Tangent, Eigen::aligned_allocator<Tangent> >
+      TangentVector;
+  typedef std::vector<SE3Type, Eigen::aligned_allocator<SE3Type> >
+      PoseVector;
+  typedef std::vector<Extra, Eigen::aligned_allocator<Extra> > ExtraVector;
+
+  // Prior on a if b < 0. Residuals and the rows of the Jacobians are padded
+  // to DoF, and the Jacobians, with respect to the updates of the states,
+  // are already weighted with the square root information.
+  struct Factor {
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+    enum Type { kPrior, kRelativePose, kRelativeExtra };
+    Type type;
+    int a;
+    int b;
+    SE3Type measurement_inverse;
+    Extra extra_measurement;
+    Block sqrt_information;
+    Tangent residual;
+    Block J_a;
+    Block J_b;
+  };
+
+  static int slot(int id) { return id % WindowSize; }
+
+  void checkState(int id) const {
+    SOPHUS_ENSURE(id >= first_id_ && id < next_id_,
+                  "State % is not in the window [%, %).", id, first_id_,
+                  next_id_);
+  }
+
+  // Appends a factor on states a and b, or a prior on a if b < 0.
+  Factor& newFactor(typename Factor::Type type, int a, int b) {
+    checkState(a);
+    if (b >= 0) {
+      checkState(b);
+    }
+    factors_.resize(factors_.size() + 1);
+    Factor& factor = factors_.back();
+    factor.type = type;
+    factor.a = a;
+    factor.b = b;
+    factor.extra_measurement.setZero();
+    factor.sqrt_information.setZero();
+    factor.residual.setZero();
+    factor.J_a.setZero();
+    factor.J_b.setZero();
+    return factor;
+  }
+
+  // d log(E * exp(delta)) / d delta at delta = 0
+  static PoseInformation logJacobian(const SE3Type& E) {
+    const Eigen::Map<const typename K::Parameters> E_params(E.data());
+    return K::Dx_log(E_params) * K::internalJacobian(E_params);
+  }
+
+  // pose of slot s at which the Jacobians are evaluated
+  const SE3Type& linearizationPose(int s) const {
+    return options_.first_estimate_jacobians && in_prior_[s] ? first_poses_[s]
+                                                             : poses_[s];
+  }
+
+  // Residual at the current estimates, and the Jacobians if requested.
+  void linearize(Factor* factor, bool jacobians) const {
+    const int s_a = slot(factor->a);
+    const SE3Type& T_a = poses_[s_a];
+    const Block& S = factor->sqrt_information;
+    Tangent error;
+    switch (factor->type) {
+      case Factor::kPrior: {
+        error.template head<6>() = (factor->measurement_inverse * T_a).log();
+        error.template tail<ExtraDoF>() =
+            extras_[s_a] - factor->extra_measurement;
+        factor->residual = S * error;
+        if (jacobians) {
+          Block J = Block::Identity();
+          J.template topLeftCorner<6, 6>() = logJacobian(
+              factor->measurement_inverse * linearizationPose(s_a));
+          factor->J_a = S * J;
+        }
+        return;
+      }
+      case Factor::kRelativePose: {
+        const int s_b = slot(factor->b);
+        error.setZero();
+        error.template head<6>() =
+            (factor->measurement_inverse * T_a.inverse() * poses_[s_b]).log();
+        factor->residual = S * error;
+        if (jacobians) {
+          // With X = T_a^-1 * T_b, exp(-delta) * X = X * exp(-Adj(X^-1)
+          // delta).
+          const SE3Type T_ab =
+              linearizationPose(s_a).inverse() * linearizationPose(s_b);
+          factor->J_a.setZero();
+          factor->J_b.setZero();
+          factor->J_b.template topLeftCorner<6, 6>() =
+              S.template topLeftCorner<6, 6>() *
+              logJacobian(factor->measurement_inverse * T_ab);
+          factor->J_a.template topLeftCorner<6, 6>() =
+              -factor->J_b.template topLeftCorner<6, 6>() *
+              T_ab.inverse().Adj();
+        }
+        return;
+      }
+      case Factor::kRelativeExtra: {
+        const int s_b = slot(factor->b);
+        error.setZero();
+        error.template tail<ExtraDoF>() =
+            extras_[s_b] - extras_[s_a] - factor->extra_measurement;
+        factor->residual = S * error;
+        if (jacobians) {
+          factor->J_b = S;
+          factor->J_b.template leftCols<6>().setZero();
+          factor->J_a = -factor->J_b;
+        }
+        return;
+      }
+    }
+  }
+
+  // Update of slot s relative to its first estimate.
+  Tangent priorDelta(int s) const {
+    Tangent dx;
+    dx.template head<6>() = (first_poses_[s].inverse() * poses_[s]).log();
+    dx.template tail<ExtraDoF>() = extras_[s] - first_extras_[s];
+    return dx;
+  }
+
+  Block& block(BlockVector& blocks, int row, int col) const {
+    return blocks[row * WindowSize + col];
+  }
+
+  const Block& block(const BlockVector& blocks, int row, int col) const {
+    return blocks[row * WindowSize + col];
+  }
+
+  // Evaluates all factors and returns the total cost.
+  double evaluate(bool jacobians) {
+    double cost = 0;
+    for (Factor& factor : factors_) {
+      linearize(&factor, jacobians);
+      cost += 0.5 * factor.residual.squaredNorm();
+    }
+    // 0.5 * dx^T H dx + g^T dx + c of the marginalization prior
+    cost += prior_constant_;
+    const int n = numStates();
+    for (int i = 0; i < n; ++i) {
+      const int s = order_[i];
+      if (!in_prior_[s]) {
+        continue;
+      }
+      step_[s] = priorDelta(s);
+    }
+    for (int i = 0; i < n; ++i) {
+      const int r = order_[i];
+      if (!in_prior_[r]) {
+        continue;
+      }
+      Tangent H_dx = Tangent::Zero();
+      for (int j = 0; j < n; ++j) {
+        const int c = order_[j];
+        if (in_prior_[c]) {
+          H_dx.noalias() += block(prior_H_, r, c) * step_[c];
+        }
+      }
+      cost += step_[r].dot(prior_g_[r] + 0.5 * H_dx);
+    }
+    return cost;
+  }
+
+  // Normal equations H, g of the current linearization; H is symmetric and
+  // stored in full.
+  void assemble() {
+    const int n = numStates();
+    for (int i = 0; i < n; ++i) {
+      const int r = order_[i];
+      g_[r].setZero();
+      for (int j = 0; j < n; ++j) {
+        block(H_, r, order_[j]).setZero();
+      }
+    }
+    addFactorsTo(-1, &H_, &g_);
+    addPriorTo(n, &H_, &g_);
+  }
+
+  // Adds the factors connected to state id, or all factors if id < 0.
+  void addFactorsTo(int id, BlockVector* H, TangentVector* g) const {
+    for (const Factor& factor : factors_) {
+      if (id >= 0 && factor.a != id && factor.b != id) {
+        continue;
+      }
+      const int s_a = slot(factor.a);
+      block(*H, s_a, s_a).noalias() += factor.J_a.transpose() * factor.J_a;
+      (*g)[s_a].noalias() += factor.J_a.transpose() * factor.residual;
+      if (factor.b < 0) {
+        continue;
+      }
+      const int s_b = slot(factor.b);
+      block(*H, s_b, s_b).noalias() += factor.J_b.transpose() * factor.J_b;
+      (*g)[s_b].noalias() += factor.J_b.transpose() * factor.residual;
+      block(*H, s_a, s_b).noalias() += factor.J_a.transpose() * factor.J_b;
+      block(*H, s_b, s_a).noalias() += factor.J_b.transpose() * factor.J_a;
+    }
+  }
+
+  // Adds the marginalization prior linearized at the current estimates of
+  // the first n states of order_.
+  void addPriorTo(int n, BlockVector* H, TangentVector* g) {
+    for (int i = 0; i < n; ++i) {
+      const int s = order_[i];
+      if (in_prior_[s]) {
+        step_[s] = priorDelta(s);
+      }
+    }
+    for (int i = 0; i < n; ++i) {
+      const int r = order_[i];
+      if (!in_prior_[r]) {
+        continue;
+      }
+      (*g)[r] += prior_g_[r];
+      for (int j = 0; j < n; ++j) {
+        const int c = order_[j];
+        if (!in_prior_[c]) {
+          continue;
+        }
+        block(*H, r, c) += block(prior_H_, r, c);
+        (*g)[r].noalias() += block(prior_H_, r, c) * step_[c];
+      }
+    }
+  }
+
+  // Solves (H + lambda * diag(H)) step = -g for the first n states of
+  // order_ by block Cholesky factorization; false if not positive definite.
+  bool solve(int n, double lambda) {
+    Eigen::LLT<Block> llt;
+    for (int j = 0; j < n; ++j) {
+      const int c = order_[j];
+      Block A = block(H_, c, c);
+      A.diagonal() +=
+          lambda * A.diagonal().cwiseMax(1e-6).cwiseMin(1e32);
+      for (int k = 0; k < j; ++k) {
+        const Block& L_jk = block(L_, j, k);
+        A.noalias() -= L_jk * L_jk.transpose();
+      }
+      llt.compute(A);
+      if (llt.info() != Eigen::Success) {
+        return false;
+      }
+      block(L_, j, j) = llt.matrixL();
+      const Block& L_jj = block(L_, j, j);
+      for (int i = j + 1; i < n; ++i) {
+        Block B = block(H_, order_[i], c);
+        for (int k = 0; k < j; ++k) {
+          B.noalias() -= block(L_, i, k) * block(L_, j, k).transpose();
+        }
+        // L_ij = B * L_jj^-T
+        block(L_, i, j) = L_jj.template triangularView<Eigen::Lower>()
+                              .solve(B.transpose())
+                              .transpose();
+      }
+    }
+    // L y = -g, then L^T step = y; W_ holds y by position
+    for (int j = 0; j < n; ++j) {
+      Tangent y = -g_[order_[j]];
+      for (int k = 0; k < j; ++k) {
+        y.noalias() -= block(L_, j, k) * W_[k];
+      }
+      W_[j] = block(L_, j, j).template triangularView<Eigen::Lower>().solve(y);
+    }
+    for (int j = n - 1; j >= 0; --j) {
+      Tangent x = W_[j];
+      for (int i = j + 1; i < n; ++i) {
+        x.noalias() -= block(L_, i, j).transpose() * step_[order_[i]];
+      }
+      step_[order_[j]] = block(L_, j, j)
+                             .template triangularView<Eigen::Lower>()
+                             .transpose()
+                             .solve(x);
+    }
+    return true;
+  }
+
+  // -(g^T step + 0.5 * step^T H step)
+  double predictedDecrease(int n) const {
+    double decrease = 0;
+    for (int i = 0; i < n; ++i) {
+      const int r = order_[i];
+      Tangent H_step = Tangent::Zero();
+      for (int j = 0; j < n; ++j) {
+        const int c = order_[j];
+        H_step.noalias() += block(H_, r, c) * step_[c];
+      }
+      decrease -= step_[r].dot(g_[r] + 0.5 * H_step);
+    }
+    return decrease;
+  }
+
+  // Reduces the factors of the oldest state and the prior onto the other
+  // states by the Schur complement.
+  void marginalizeOldest() {
+    const int n = numStates();
+    for (int i = 0; i < n; ++i) {
+      order_[i] = slot(first_id_ + i);
+    }
+    const int m = order_[0];
+
+    // states connected to m enter the prior at their current estimates
+    for (const Factor& factor : factors_) {
+      if (factor.b < 0 || (factor.a != first_id_ && factor.b != first_id_)) {
+        continue;
+      }
+      const int r = slot(factor.a == first_id_ ? factor.b : factor.a);
+      if (!in_prior_[r]) {
+        in_prior_[r] = true;
+        first_poses_[r] = poses_[r];
+        first_extras_[r] = extras_[r];
+        for (int i = 0; i < n; ++i) {
+          block(prior_H_, r, order_[i]).setZero();
+          block(prior_H_, order_[i], r).setZero();
+        }
+        prior_g_[r].setZero();
+      }
+    }
+    if (!in_prior_[m]) {
+      // m only enters through its own factors
+      first_poses_[m] = poses_[m];
+      first_extras_[m] = extras_[m];
+      prior_g_[m].setZero();
+      for (int i = 0; i < n; ++i) {
+        block(prior_H_, m, order_[i]).setZero();
+        block(prior_H_, order_[i], m).setZero();
+      }
+      in_prior_[m] = true;
+    }
+
+    // quadratic q(delta) = c + g^T delta + 0.5 * delta^T H delta of the
+    // factors of m and the prior, at the current estimates
+    double c = prior_constant_;
+    for (Factor& factor : factors_) {
+      if (factor.a != first_id_ && factor.b != first_id_) {
+        continue;
+      }
+      linearize(&factor, true);
+      c += 0.5 * factor.residual.squaredNorm();
+    }
+    for (int i = 0; i < n; ++i) {
+      const int r = order_[i];
+      g_[r].setZero();
+      for (int j = 0; j < n; ++j) {
+        block(H_, r, order_[j]).setZero();
+      }
+    }
+    addFactorsTo(first_id_, &H_, &g_);
+    for (int i = 0; i < n; ++i) {
+      const int s = order_[i];
+      if (in_prior_[s]) {
+        step_[s] = priorDelta(s);
+      }
+    }
+    for (int i = 0; i < n; ++i) {
+      const int r = order_[i];
+      if (!in_prior_[r]) {
+        continue;
+      }
+      Tangent H_dx = Tangent::Zero();
+      for (int j = 0; j < n; ++j) {
+        const int s = order_[j];
+        if (in_prior_[s]) {
+          H_dx.noalias() += block(prior_H_, r, s) * step_[s];
+        }
+      }
+      c += step_[r].dot(prior_g_[r] + 0.5 * H_dx);
+    }
+    addPriorTo(n, &H_, &g_);
+
+    // Schur complement onto the other states of the prior
+    const Eigen::LLT<Block> llt_m(block(H_, m, m));
+    SOPHUS_ENSURE(llt_m.info() == Eigen::Success,
+                  "State % to marginalize is not constrained.", first_id_);
+    const Tangent H_mm_inv_g = llt_m.solve(g_[m]);
+    c -= 0.5 * g_[m].dot(H_mm_inv_g);
+    for (int i = 1; i < n; ++i) {
+      const int r = order_[i];
+      if (in_prior_[r]) {
+        // W = H_mm^-1 H_mr, stored in L_ as scratch
+        block(L_, 0, i) = llt_m.solve(block(H_, m, r));
+      }
+    }
+    for (int i = 1; i < n; ++i) {
+      const int r = order_[i];
+      if (!in_prior_[r]) {
+        continue;
+      }
+      g_[r].noalias() -= block(H_, r, m) * H_mm_inv_g;
+      for (int j = 1; j < n; ++j) {
+        const int s = order_[j];
+        if (in_prior_[s]) {
+          block(H_, r, s).noalias() -= block(H_, r, m) * block(L_, 0, j);
+        }
+      }
+    }
+
+    // store the reduced quadratic around the first estimates:
+    // q(dx) = c + g^T (dx - dx0) + 0.5 (dx - dx0)^T H (dx - dx0)
+    prior_constant_ = c;
+    for (int i = 1; i < n; ++i) {
+      const int r = order_[i];
+      if (!in_prior_[r]) {
+        continue;
+      }
+      Tangent H_dx0 = Tangent::Zero();
+      for (int j = 1; j < n; ++j) {
+        const int s = order_[j];
+        if (in_prior_[s]) {
+          block(prior_H_, r, s) = block(H_, r, s);
+          H_dx0.noalias() += block(H_, r, s) * step_[s];
+        }
+      }
+      prior_g_[r] = g_[r] - H_dx0;
+      prior_constant_ += step_[r].dot(0.5 * H_dx0 - g_[r]);
+    }
+    in_prior_[m] = false;
+
+    // drop the factors of m
+    factors_.erase(std::remove_if(factors_.begin(), factors_.end(),
+                                  [this](const Factor& factor) {
+                                    return factor.a == first_id_ ||
+                                           factor.b == first_id_;
+                                  }),
+                   factors_.end());
+    ++first_id_;
+  }
+
+  SlidingWindowOptions options_;
+  int first_id_;
+  int next_id_;
+  std::vector<Factor, Eigen::aligned_allocator<Factor> > factors_;
+
+  // states by slot, id % WindowSize
+  PoseVector poses_;
+  ExtraVector extras_;
+  PoseVector first_poses_;
+  ExtraVector first_extras_;
+  std::vector<bool> in_prior_;
+  PoseVector saved_poses_;
+  ExtraVector saved_extras_;
+
+  // normal equations and marginalization prior by slot; the prior is
+  // prior_constant_ + prior_g_^T dx + 0.5 dx^T prior_H_ dx in the updates
+  // dx relative to the first estimates
+  double prior_constant_;
+  BlockVector H_;
+  TangentVector g_;
+  BlockVector prior_H_;
+  TangentVector prior_g_;
+
+  // scratch: Cholesky factor by window position, step by slot, and
+  // positions in the window to slots
+  BlockVector L_;
+  TangentVector step_;
+  TangentVector W_;
+  std::vector<int> order_;
+};
+}  // namespace Sophus
+
+#endif  // SOPHUS_SLIDING_WINDOW_HPP
@@ -172,8 +172,9 @@ class SO2GroupBase {
    * It re-normalizes complex number to unit length.
    */
   inline void normalize() {
-    Scalar length = std::sqrt(unit_complex().x() * unit_complex().x() +
-                              unit_complex().y() * unit_complex().y());
+    using std::sqrt;
+    Scalar length = sqrt(unit_complex().x() * unit_complex().x() +
+                         unit_complex().y() * unit_complex().y());
     SOPHUS_ENSURE(length >= SophusConstants<Scalar>::epsilon(),
                   "Complex number should not be close to zero!");
     unit_complex_nonconst().x() /= length;
@@ -298,7 +299,9 @@ class SO2GroupBase {
    * \see log()
    */
   inline static SO2Group<Scalar> exp(const Tangent& theta) {
-    return SO2Group<Scalar>(std::cos(theta), std::sin(theta));
+    using std::cos;
+    using std::sin;
+    return SO2Group<Scalar>(cos(theta), sin(theta));
   }
 
   /**
@@ -366,9 +369,10 @@ class SO2GroupBase {
    * \see exp()
    * \see vee()
    */
-  inline static Tangent log(const SO2Group<Scalar>& other) {
-    // todo: general implementation for Scalar not being float or double.
-    return atan2(other.unit_complex_.y(), other.unit_complex().x());
+  template <typename OtherDerived>
+  inline static Tangent log(const SO2GroupBase<OtherDerived>& other) {
+    using std::atan2;
+    return atan2(other.unit_complex().y(), other.unit_complex().x());
   }
 
   /**
@@ -450,7 +454,8 @@ class SO2Group : public SO2GroupBase<SO2Group<_Scalar, _Options> > {
   inline explicit SO2Group(const Transformation& R)
       : unit_complex_(static_cast<Scalar>(0.5) * (R(0, 0) + R(1, 1)),
                       static_cast<Scalar>(0.5) * (R(1, 0) - R(0, 1))) {
-    SOPHUS_ENSURE(std::abs(R.determinant() - static_cast<Scalar>(1)) <=
+    using std::abs;
+    SOPHUS_ENSURE(abs(R.determinant() - static_cast<Scalar>(1)) <=
                       SophusConstants<Scalar>::epsilon(),
                   "det(R) should be (close to) 1.");
   }
@@ -514,6 +519,76 @@ class SO2Group : public SO2GroupBase<SO2Group<_Scalar, _Options> > {
   Eigen::Matrix<Scalar, 2, 1> unit_complex_;
 };
 
+/**
+ * \brief Group multiplication into existing storage
+ *
+ * Computes *out = a * b for any storage of out, a and b (e.g. Eigen::Map),
+ * without the intermediate group objects of operator*(). The result is
+ * renormalized as in SO2GroupBase::operator*=(); out may alias a or b.
+ */
+template <typename OutDerived, typename ADerived, typename BDerived>
+inline void composeInto(SO2GroupBase<OutDerived>* out,
+                        const SO2GroupBase<ADerived>& a,
+                        const SO2GroupBase<BDerived>& b) {
+  typedef typename SO2GroupBase<OutDerived>::Scalar Scalar;
+  const Scalar a_real = a.unit_complex().x();
+  const Scalar a_imag = a.unit_complex().y();
+  const Scalar b_real = b.unit_complex().x();
+  const Scalar b_imag = b.unit_complex().y();
+  Scalar real = a_real * b_real - a_imag * b_imag;
+  Scalar imag = a_real * b_imag + a_imag * b_real;
+  const Scalar squared_norm = real * real + imag * imag;
+  if (squared_norm != Scalar(1.0)) {
+    const Scalar factor = Scalar(2.0) / (Scalar(1.0) + squared_norm);
+    real *= factor;
+    imag *= factor;
+  }
+  Scalar* z = out->data();
+  z[0] = real;
+  z[1] = imag;
+}
+
+/**
+ * \brief Group inverse into existing storage
+ *
+ * Computes *out = a^-1; out may alias a.
+ */
+template <typename OutDerived, typename ADerived>
+inline void inverseInto(SO2GroupBase<OutDerived>* out,
+                        const SO2GroupBase<ADerived>& a) {
+  typename SO2GroupBase<OutDerived>::Scalar* z = out->data();
+  const typename SO2GroupBase<ADerived>::Scalar* z_a = a.data();
+  z[0] = z_a[0];
+  z[1] = -z_a[1];
+}
+
+/**
+ * \brief Group exponential into existing storage
+ *
+ * Computes *out = exp(theta) as SO2Group::exp(), but without renormalizing
+ * the already unit complex number.
+ */
+template <typename OutDerived>
+inline void expInto(SO2GroupBase<OutDerived>* out,
+                    const typename SO2GroupBase<OutDerived>::Tangent& theta) {
+  using std::cos;
+  using std::sin;
+  typename SO2GroupBase<OutDerived>::Scalar* z = out->data();
+  z[0] = cos(theta);
+  z[1] = sin(theta);
+}
+
+/**
+ * \brief Logarithmic map into existing storage
+ *
+ * Computes *out = log(a) for any storage of a.
+ */
+template <typename ADerived>
+inline void logInto(typename SO2GroupBase<ADerived>::Tangent* out,
+                    const SO2GroupBase<ADerived>& a) {
+  *out = SO2GroupBase<ADerived>::log(a);
+}
+
 }  // end namespace
 
 namespace Eigen {
@@ -624,4 +699,14 @@ class Map<const Sophus::SO2Group<_Scalar>, _Options>
 };
 }
 
+#ifdef SOPHUS_USE_INSTANTIATIONS
+// Instantiated in sophus/instantiations.cpp
+namespace Sophus {
+extern template class SO2GroupBase<SO2Group<double> >;
+extern template class SO2Group<double>;
+extern template class SO2GroupBase<SO2Group<float> >;
+extern template class SO2Group<float>;
+}
+#endif
+
 #endif  // SOPHUS_SO2_HPP
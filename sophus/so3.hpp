@@ -26,6 +26,8 @@
 
 #include <iostream>
 
+#include "autodiff.hpp"
+#include "generated/so3_kernels.hpp"
 #include "sophus.hpp"
 
 // Include only the selective set of Eigen headers that we need.
@@ -77,6 +79,7 @@ struct traits<Map<const Sophus::SO3Group<_Scalar>, _Options> >
 namespace Sophus {
 using std::sqrt;
 using std::abs;
+using std::atan;
 using std::cos;
 using std::sin;
 
@@ -382,6 +385,10 @@ class SO3GroupBase {
    */
   EIGEN_DEVICE_FUNC EIGEN_STRONG_INLINE static SO3Group<Scalar> exp(
       const Tangent& omega) {
+    if (AutoDiffTraits<Scalar>::enabled) {
+      return details::ChainRule<Scalar>::template exp<
+          SO3Group, generated::SO3Kernels>(omega);
+    }
     Scalar theta;
     return expAndTheta(omega, &theta);
   }
@@ -538,6 +545,10 @@ class SO3GroupBase {
    */
   EIGEN_DEVICE_FUNC EIGEN_STRONG_INLINE static Tangent log(
       const SO3Group<Scalar>& other) {
+    if (AutoDiffTraits<Scalar>::enabled) {
+      return details::ChainRule<Scalar>::template log<
+          SO3Group, generated::SO3Kernels>(other);
+    }
     Scalar theta;
     return logAndTheta(other, &theta);
   }
@@ -552,8 +563,9 @@ class SO3GroupBase {
    *
    * \see log() for details
    */
+  template <typename OtherDerived>
   EIGEN_DEVICE_FUNC EIGEN_STRONG_INLINE static Tangent logAndTheta(
-      const SO3Group<Scalar>& other, Scalar* theta) {
+      const SO3GroupBase<OtherDerived>& other, Scalar* theta) {
     Scalar squared_n = other.unit_quaternion().vec().squaredNorm();
     Scalar n = sqrt(squared_n);
     Scalar w = other.unit_quaternion().w();
@@ -732,6 +744,106 @@ class SO3Group : public SO3GroupBase<SO3Group<_Scalar, _Options> > {
   Eigen::Quaternion<Scalar> unit_quaternion_;
 };
 
+/**
+ * \brief Group multiplication into existing storage
+ *
+ * Computes *out = a * b for any storage of out, a and b (e.g. Eigen::Map),
+ * without the intermediate group objects of operator*(). The result is
+ * renormalized as in SO3GroupBase::operator*=(); out may alias a or b.
+ */
+template <typename OutDerived, typename ADerived, typename BDerived>
+EIGEN_DEVICE_FUNC EIGEN_STRONG_INLINE void composeInto(
+    SO3GroupBase<OutDerived>* out, const SO3GroupBase<ADerived>& a,
+    const SO3GroupBase<BDerived>& b) {
+  typedef typename SO3GroupBase<OutDerived>::Scalar Scalar;
+  Eigen::Quaternion<Scalar> q = a.unit_quaternion() * b.unit_quaternion();
+  const Scalar squared_norm = q.squaredNorm();
+  if (squared_norm != Scalar(1.0)) {
+    q.coeffs() *= Scalar(2.0) / (Scalar(1.0) + squared_norm);
+  }
+  Eigen::Map<Eigen::Matrix<Scalar, 4, 1> >(out->data()) = q.coeffs();
+}
+
+/**
+ * \brief Group inverse into existing storage
+ *
+ * Computes *out = a^-1; out may alias a.
+ */
+template <typename OutDerived, typename ADerived>
+EIGEN_DEVICE_FUNC EIGEN_STRONG_INLINE void inverseInto(
+    SO3GroupBase<OutDerived>* out, const SO3GroupBase<ADerived>& a) {
+  typename SO3GroupBase<OutDerived>::Scalar* q = out->data();
+  const typename SO3GroupBase<ADerived>::Scalar* q_a = a.data();
+  q[0] = -q_a[0];
+  q[1] = -q_a[1];
+  q[2] = -q_a[2];
+  q[3] = q_a[3];
+}
+
+/**
+ * \brief Group exponential into existing storage
+ *
+ * Computes *out = exp(omega) as SO3Group::expAndTheta(), but without
+ * renormalizing the already unit quaternion; sets *theta = |omega| unless
+ * theta is null.
+ */
+template <typename OutDerived, typename TangentDerived>
+EIGEN_DEVICE_FUNC EIGEN_STRONG_INLINE void expInto(
+    SO3GroupBase<OutDerived>* out,
+    const Eigen::MatrixBase<TangentDerived>& omega,
+    typename SO3GroupBase<OutDerived>::Scalar* theta = NULL) {
+  typedef typename SO3GroupBase<OutDerived>::Scalar Scalar;
+  if (AutoDiffTraits<Scalar>::enabled) {
+    static_cast<OutDerived&>(*out) = SO3Group<Scalar>::exp(omega);
+    if (theta != NULL) {
+      *theta = omega.norm();
+    }
+    return;
+  }
+  const Scalar theta_sq = omega.squaredNorm();
+  const Scalar angle = sqrt(theta_sq);
+  Scalar imag_factor;
+  Scalar real_factor;
+  if (angle < SophusConstants<Scalar>::epsilon()) {
+    const Scalar theta_po4 = theta_sq * theta_sq;
+    imag_factor = static_cast<Scalar>(0.5) -
+                  static_cast<Scalar>(1.0 / 48.0) * theta_sq +
+                  static_cast<Scalar>(1.0 / 3840.0) * theta_po4;
+    real_factor = static_cast<Scalar>(1) -
+                  static_cast<Scalar>(0.5) * theta_sq +
+                  static_cast<Scalar>(1.0 / 384.0) * theta_po4;
+  } else {
+    const Scalar half_theta = static_cast<Scalar>(0.5) * angle;
+    imag_factor = sin(half_theta) / angle;
+    real_factor = cos(half_theta);
+  }
+  Scalar* q = out->data();
+  q[0] = imag_factor * omega[0];
+  q[1] = imag_factor * omega[1];
+  q[2] = imag_factor * omega[2];
+  q[3] = real_factor;
+  if (theta != NULL) {
+    *theta = angle;
+  }
+}
+
+/**
+ * \brief Logarithmic map into existing storage
+ *
+ * Computes *out = log(a) for any storage of a and any 3-vector out.
+ */
+template <typename OutDerived, typename ADerived>
+EIGEN_DEVICE_FUNC EIGEN_STRONG_INLINE void logInto(
+    Eigen::MatrixBase<OutDerived>* out, const SO3GroupBase<ADerived>& a) {
+  typedef typename SO3GroupBase<ADerived>::Scalar Scalar;
+  if (AutoDiffTraits<Scalar>::enabled) {
+    *out = SO3Group<Scalar>::log(SO3Group<Scalar>(a));
+    return;
+  }
+  Scalar theta;
+  *out = SO3Group<Scalar>::logAndTheta(a, &theta);
+}
+
 }  // end namespace
 
 namespace Eigen {
@@ -847,4 +959,14 @@ class Map<const Sophus::SO3Group<_Scalar>, _Options>
 };
 }
 
+#ifdef SOPHUS_USE_INSTANTIATIONS
+// Instantiated in sophus/instantiations.cpp
+namespace Sophus {
+extern template class SO3GroupBase<SO3Group<double> >;
+extern template class SO3Group<double>;
+extern template class SO3GroupBase<SO3Group<float> >;
+extern template class SO3Group<float>;
+}
+#endif
+
 #endif
@@ -0,0 +1,367 @@
+// This file is part of Sophus.
+//
+// Copyright 2016 Hauke Strasdat
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights  to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+
+#ifndef SOPHUS_TRAJECTORY_EVALUATION_HPP
+#define SOPHUS_TRAJECTORY_EVALUATION_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include <Eigen/Geometry>
+
+#include "batch.hpp"
+#include "parallel.hpp"
+#include "sim3.hpp"
+#include "trajectory_io.hpp"
+
+namespace Sophus {
+
+/**
+ * \brief Summary of a set of non-negative errors
+ *
+ * Percentiles interpolate linearly between the closest ranks.
+ */
+struct ErrorStatistics {
+  std::size_t count = 0;
+  double rmse = 0;
+  double mean = 0;
+  double median = 0;
+  double min = 0;
+  double max = 0;
+  double p90 = 0;
+  double p95 = 0;
+  double p99 = 0;
+};
+
+/**
+ * \returns the statistics of errors
+ */
+inline ErrorStatistics computeErrorStatistics(std::vector<double> errors) {
+  ErrorStatistics statistics;
+  statistics.count = errors.size();
+  if (errors.empty()) {
+    return statistics;
+  }
+  std::sort(errors.begin(), errors.end());
+  double sum = 0;
+  double squared_sum = 0;
+  for (double e : errors) {
+    sum += e;
+    squared_sum += e * e;
+  }
+  const double n = static_cast<double>(errors.size());
+  const auto percentile = [&](double q) {
+    const double position = q * (n - 1);
+    const std::size_t lower = static_cast<std::size_t>(position);
+    const std::size_t upper = std::min(lower + 1, errors.size() - 1);
+    const double fraction = position - static_cast<double>(lower);
+    return errors[lower] + fraction * (errors[upper] - errors[lower]);
+  };
+  statistics.rmse = std::sqrt(squared_sum / n);
+  statistics.mean = sum / n;
+  statistics.median = percentile(0.5);
+  statistics.min = errors.front();
+  statistics.max = errors.back();
+  statistics.p90 = percentile(0.9);
+  statistics.p95 = percentile(0.95);
+  statistics.p99 = percentile(0.99);
+  return statistics;
+}
+
+/**
+ * \brief Pairs up timestamps of two sorted sequences
+ *
+ * Matches (i, j) are mutual nearest neighbours with |a[i] - b[j]| <=
+ * max_difference. The matching is one-to-one and increasing in both i and
+ * j.
+ */
+inline std::vector<std::pair<int, int> > associateTimestamps(
+    const std::vector<double>& a, const std::vector<double>& b,
+    double max_difference) {
+  SOPHUS_ENSURE(std::is_sorted(a.begin(), a.end()) &&
+                    std::is_sorted(b.begin(), b.end()),
+                "timestamps must be sorted");
+  const auto nearest = [](const std::vector<double>& from,
+                          const std::vector<double>& to) {
+    std::vector<int> indices(from.size(), -1);
+    std::size_t j = 0;
+    for (std::size_t i = 0; i < from.size() && !to.empty(); ++i) {
+      while (j + 1 < to.size() &&
+             std::abs(to[j + 1] - from[i]) <= std::abs(to[j] - from[i])) {
+        ++j;
+      }
+      indices[i] = static_cast<int>(j);
+    }
+    return indices;
+  };
+  const std::vector<int> a_to_b = nearest(a, b);
+  const std::vector<int> b_to_a = nearest(b, a);
+  std::vector<std::pair<int, int> > matches;
+  for (std::size_t i = 0; i < a.size(); ++i) {
+    const int j = a_to_b[i];
+    if (j >= 0 && b_to_a[j] == static_cast<int>(i) &&
+        std::abs(a[i] - b[j]) <= max_difference) {
+      matches.push_back(std::make_pair(static_cast<int>(i), j));
+    }
+  }
+  return matches;
+}
+
+struct TrajectoryEvaluationOptions {
+  enum Alignment {
+    // Estimate used as is.
+    NoAlignment,
+    // Rigid motion minimizing the position errors (Umeyama).
+    SE3Alignment,
+    // Similarity, for monocular estimates without metric scale.
+    Sim3Alignment
+  };
+
+  Alignment alignment = SE3Alignment;
+  // Largest timestamp difference of associated poses, in seconds.
+  double max_time_difference = 0.01;
+  // Frame offsets of the relative pose errors.
+  std::vector<int> rpe_deltas = {1};
+  // Zero uses all hardware threads.
+  std::size_t num_threads = 0;
+};
+
+struct RelativePoseErrors {
+  int delta = 0;
+  ErrorStatistics translation;
+  ErrorStatistics rotation;
+};
+
+/**
+ * \brief Absolute and relative pose errors of an estimated trajectory
+ *
+ * Translation errors are in the units of the ground truth, rotation errors
+ * in radians.
+ */
+struct TrajectoryEvaluation {
+  // pairs (ground truth index, estimate index)
+  std::vector<std::pair<int, int> > matches;
+  // maps the estimate to the ground truth frame
+  Sim3d alignment;
+  ErrorStatistics ate_translation;
+  ErrorStatistics ate_rotation;
+  // one entry per TrajectoryEvaluationOptions::rpe_deltas
+  std::vector<RelativePoseErrors> rpe;
+
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+};
+
+typedef std::vector<TrajectoryEvaluation,
+                    Eigen::aligned_allocator<TrajectoryEvaluation> >
+    TrajectoryEvaluationVector;
+
+namespace details {
+
+// Rotation and translation norms of the poses E[i] = A[i] * B[i], given as
+// packed SE3 parameters, for i in [begin, end). Uses the batch kernels.
+inline void poseErrorNorms(const double* A, const double* B,
+                           std::size_t begin, std::size_t end,
+                           double* translation_errors,
+                           double* rotation_errors) {
+  const std::size_t kP = SE3d::num_parameters;
+  const std::size_t n = end - begin;
+  std::vector<double> E(kP * n);
+  std::vector<double> tangents(6 * n);
+  BatchOps<SE3d>::compose(A + kP * begin, B + kP * begin, E.data(), n);
+  BatchOps<SE3d>::log(E.data(), tangents.data(), n);
+  for (std::size_t i = 0; i < n; ++i) {
+    const double* t = &E[kP * i + 4];
+    const double* omega = &tangents[6 * i + 3];
+    translation_errors[begin + i] =
+        std::sqrt(t[0] * t[0] + t[1] * t[1] + t[2] * t[2]);
+    rotation_errors[begin + i] = std::sqrt(
+        omega[0] * omega[0] + omega[1] * omega[1] + omega[2] * omega[2]);
+  }
+}
+
+inline void storePose(const SE3d& T, double* params) {
+  std::copy(T.data(), T.data() + SE3d::num_parameters, params);
+}
+}  // namespace details
+
+/**
+ * \brief Evaluates an estimated trajectory against ground truth
+ *
+ * Poses are associated by timestamp, or by index if both trajectories lack
+ * timestamps. The estimate is aligned to the matched ground truth positions
+ * as selected, then
+ *
+ *  - the absolute trajectory error (ATE) of match i is
+ *    E_i = T_gt_i^-1 * S * T_est_i,
+ *  - the relative pose error (RPE) for frame offset d is
+ *    E_i = (T_gt_i^-1 * T_gt_i+d)^-1 * (T_est_i^-1 * T_est_i+d),
+ *
+ * with the alignment S applied to the estimate. The translation error is
+ * |translation(E_i)|, the rotation error |log(rotation(E_i))|. Composition
+ * and log run through BatchOps in parallel chunks.
+ *
+ * Returns false if fewer than three poses are matched.
+ */
+inline bool evaluateTrajectory(const Trajectory& ground_truth,
+                               const Trajectory& estimate,
+                               const TrajectoryEvaluationOptions& options,
+                               TrajectoryEvaluation* evaluation) {
+  *evaluation = TrajectoryEvaluation();
+  std::vector<std::pair<int, int> >& matches = evaluation->matches;
+  if (ground_truth.timestamps.empty() && estimate.timestamps.empty()) {
+    if (ground_truth.poses.size() == estimate.poses.size()) {
+      for (std::size_t i = 0; i < estimate.poses.size(); ++i) {
+        matches.push_back(
+            std::make_pair(static_cast<int>(i), static_cast<int>(i)));
+      }
+    }
+  } else {
+    SOPHUS_ENSURE(
+        ground_truth.timestamps.size() == ground_truth.poses.size() &&
+            estimate.timestamps.size() == estimate.poses.size(),
+        "one timestamp per pose expected");
+    matches = associateTimestamps(ground_truth.timestamps, estimate.timestamps,
+                                  options.max_time_difference);
+  }
+  const std::size_t m = matches.size();
+  if (m < 3) {
+    matches.clear();
+    return false;
+  }
+
+  if (options.alignment != TrajectoryEvaluationOptions::NoAlignment) {
+    Eigen::Matrix3Xd gt_positions(3, m);
+    Eigen::Matrix3Xd est_positions(3, m);
+    for (std::size_t i = 0; i < m; ++i) {
+      gt_positions.col(i) = ground_truth.poses[matches[i].first].translation();
+      est_positions.col(i) = estimate.poses[matches[i].second].translation();
+    }
+    const Eigen::Matrix4d S = Eigen::umeyama(
+        est_positions, gt_positions,
+        options.alignment == TrajectoryEvaluationOptions::Sim3Alignment);
+    if (!S.allFinite() || !(S.topLeftCorner<3, 3>().determinant() > 0)) {
+      matches.clear();
+      return false;
+    }
+    evaluation->alignment = Sim3d(S);
+  }
+
+  // ground truth and aligned estimate, and their inverses, as packed
+  // parameters
+  const std::size_t kP = SE3d::num_parameters;
+  std::vector<double> gt(kP * m), gt_inverse(kP * m), est(kP * m),
+      est_inverse(kP * m);
+  const Sim3d& S = evaluation->alignment;
+  const SO3d S_rotation(S.quaternion());
+  const double S_scale = S.scale();
+  parallelFor(0, m, options.num_threads, 1024, [&](std::size_t i) {
+    const SE3d& T_gt = ground_truth.poses[matches[i].first];
+    const SE3d& T_est = estimate.poses[matches[i].second];
+    const SE3d T_aligned(S_rotation * T_est.so3(),
+                         S_scale * (S_rotation * T_est.translation()) +
+                             S.translation());
+    details::storePose(T_gt, &gt[kP * i]);
+    details::storePose(T_gt.inverse(), &gt_inverse[kP * i]);
+    details::storePose(T_aligned, &est[kP * i]);
+    details::storePose(T_aligned.inverse(), &est_inverse[kP * i]);
+  });
+
+  const std::size_t kChunkSize = 1024;
+  const std::size_t num_chunks = (m + kChunkSize - 1) / kChunkSize;
+  std::vector<double> translation_errors(m), rotation_errors(m);
+  parallelFor(0, num_chunks, options.num_threads, 1, [&](std::size_t c) {
+    details::poseErrorNorms(gt_inverse.data(), est.data(), c * kChunkSize,
+                            std::min(m, (c + 1) * kChunkSize),
+                            translation_errors.data(), rotation_errors.data());
+  });
+  evaluation->ate_translation = computeErrorStatistics(translation_errors);
+  evaluation->ate_rotation = computeErrorStatistics(rotation_errors);
+
+  for (int delta : options.rpe_deltas) {
+    SOPHUS_ENSURE(delta > 0, "RPE delta must be positive, not %", delta);
+    RelativePoseErrors rpe;
+    rpe.delta = delta;
+    const std::size_t d = static_cast<std::size_t>(delta);
+    if (d < m) {
+      const std::size_t n = m - d;
+      // (T_gt_i^-1 * T_gt_i+d)^-1 = T_gt_i+d^-1 * T_gt_i and
+      // T_est_i^-1 * T_est_i+d
+      std::vector<double> gt_relative_inverse(kP * n), est_relative(kP * n);
+      translation_errors.resize(n);
+      rotation_errors.resize(n);
+      const std::size_t num_rpe_chunks = (n + kChunkSize - 1) / kChunkSize;
+      parallelFor(0, num_rpe_chunks, options.num_threads, 1,
+                  [&](std::size_t c) {
+                    const std::size_t begin = c * kChunkSize;
+                    const std::size_t end = std::min(n, begin + kChunkSize);
+                    BatchOps<SE3d>::compose(
+                        &gt_inverse[kP * (begin + d)], &gt[kP * begin],
+                        &gt_relative_inverse[kP * begin], end - begin);
+                    BatchOps<SE3d>::compose(
+                        &est_inverse[kP * begin], &est[kP * (begin + d)],
+                        &est_relative[kP * begin], end - begin);
+                    details::poseErrorNorms(
+                        gt_relative_inverse.data(), est_relative.data(), begin,
+                        end, translation_errors.data(),
+                        rotation_errors.data());
+                  });
+      rpe.translation = computeErrorStatistics(translation_errors);
+      rpe.rotation = computeErrorStatistics(rotation_errors);
+    }
+    evaluation->rpe.push_back(rpe);
+  }
+  return true;
+}
+
+/**
+ * \brief Evaluates many sequences, see evaluateTrajectory()
+ *
+ * Sequences are evaluated concurrently, each on a single thread. Returns
+ * false if any evaluation failed; its result has no matches.
+ */
+inline bool evaluateTrajectories(
+    const std::vector<Trajectory>& ground_truths,
+    const std::vector<Trajectory>& estimates,
+    const TrajectoryEvaluationOptions& options,
+    TrajectoryEvaluationVector* evaluations) {
+  SOPHUS_ENSURE(ground_truths.size() == estimates.size(),
+                "% ground truth trajectories for % estimates",
+                ground_truths.size(), estimates.size());
+  evaluations->resize(estimates.size());
+  TrajectoryEvaluationOptions sequence_options = options;
+  sequence_options.num_threads = 1;
+  std::vector<char> ok(estimates.size());
+  parallelFor(0, estimates.size(), options.num_threads, 1,
+              [&](std::size_t k) {
+                ok[k] = evaluateTrajectory(ground_truths[k], estimates[k],
+                                           sequence_options,
+                                           &(*evaluations)[k]);
+              });
+  return std::find(ok.begin(), ok.end(), 0) == ok.end();
+}
+}  // namespace Sophus
+
+#endif  // SOPHUS_TRAJECTORY_EVALUATION_HPP
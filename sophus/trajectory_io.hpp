@@ -0,0 +1,573 @@
+// This file is part of Sophus.
+//
+// Copyright 2016 Hauke Strasdat
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights  to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+
+#ifndef SOPHUS_TRAJECTORY_IO_HPP
+#define SOPHUS_TRAJECTORY_IO_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include <Eigen/StdVector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define SOPHUS_HAS_MMAP
+#endif
+
+#include "parallel.hpp"
+#include "se3.hpp"
+
+// Readers and writers for common trajectory text formats:
+//
+//  - TUM RGB-D: "timestamp tx ty tz qx qy qz qw" per line, timestamps in
+//    seconds.
+//  - KITTI odometry: the 12 entries of the row-major 3x4 matrix of T_w_i
+//    per line, without timestamps.
+//  - EuRoC MAV (ASL ground truth CSV): "timestamp, tx, ty, tz, qw, qx, qy,
+//    qz" followed by optional further columns (velocities, biases) which
+//    are ignored, timestamps in nanoseconds.
+//
+// Lines which are empty or start with '#' are skipped. Files are memory
+// mapped where available, split into chunks at line boundaries, and the
+// chunks are parsed concurrently into preallocated storage, so no memory is
+// allocated per line. Numbers are parsed without the C++ streams; decimal
+// numbers with up to 19 significant digits and small exponents take an exact
+// fast path, others fall back to std::strtod.
+
+namespace Sophus {
+
+/**
+ * \brief Poses T_w_i with timestamps in seconds
+ *
+ * timestamps is empty for formats without them (KITTI). EuRoC nanosecond
+ * timestamps are converted to seconds; for current Unix times a double
+ * resolves them to about 0.2 microseconds.
+ */
+struct Trajectory {
+  std::vector<double> timestamps;
+  std::vector<SE3d, Eigen::aligned_allocator<SE3d> > poses;
+};
+
+enum class TrajectoryFormat { TUM, KITTI, EuRoC };
+
+namespace details {
+
+// Number parsing on [p, end); p is advanced past the parsed characters.
+class TrajectoryLineParser {
+ public:
+  TrajectoryLineParser(const char* begin, const char* end)
+      : p_(begin), end_(end) {}
+
+  // Skips spaces and tabs, then one separator character if it is next.
+  void skipSeparator(char separator) {
+    skipBlanks();
+    if (p_ < end_ && *p_ == separator) {
+      ++p_;
+    }
+  }
+
+  bool parseDouble(double* value) {
+    static const double kPowersOf10[] = {
+        1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+    skipBlanks();
+    const char* p = p_;
+    const char* const end = end_;
+    const char* start = p;
+    bool negative = false;
+    if (p < end && (*p == '-' || *p == '+')) {
+      negative = *p == '-';
+      ++p;
+    }
+    // up to 19 significant digits; truncated if a nonzero one is dropped
+    std::uint64_t mantissa = 0;
+    int num_digits = 0;
+    int exponent = 0;
+    bool any_digits = false;
+    bool truncated = false;
+    for (; p < end && isDigit(*p); ++p) {
+      any_digits = true;
+      if (num_digits < 19) {
+        mantissa = 10 * mantissa + static_cast<std::uint64_t>(*p - '0');
+        num_digits += mantissa > 0;
+      } else {
+        truncated |= *p != '0';
+        ++exponent;
+      }
+    }
+    if (p < end && *p == '.') {
+      for (++p; p < end && isDigit(*p); ++p) {
+        any_digits = true;
+        if (num_digits < 19) {
+          mantissa = 10 * mantissa + static_cast<std::uint64_t>(*p - '0');
+          num_digits += mantissa > 0;
+          --exponent;
+        } else {
+          truncated |= *p != '0';
+        }
+      }
+    }
+    if (!any_digits) {
+      return false;
+    }
+    while (mantissa != 0 && mantissa % 10 == 0) {
+      mantissa /= 10;
+      ++exponent;
+    }
+    if (p < end && (*p == 'e' || *p == 'E')) {
+      ++p;
+      bool negative_exponent = false;
+      if (p < end && (*p == '-' || *p == '+')) {
+        negative_exponent = *p == '-';
+        ++p;
+      }
+      if (p == end || !isDigit(*p)) {
+        return false;
+      }
+      int e = 0;
+      for (; p < end && isDigit(*p); ++p) {
+        e = e < 10000 ? 10 * e + (*p - '0') : e;
+      }
+      exponent += negative_exponent ? -e : e;
+    }
+    p_ = p;
+    // Exact if both the mantissa and the power of ten are representable.
+    if (!truncated && mantissa <= (std::uint64_t(1) << 53) &&
+        exponent >= -22 && exponent <= 22) {
+      const double m = static_cast<double>(mantissa);
+      const double v = exponent < 0 ? m / kPowersOf10[-exponent]
+                                    : m * kPowersOf10[exponent];
+      *value = negative ? -v : v;
+      return true;
+    }
+    return parseSlow(start, value);
+  }
+
+  bool parseInt64(std::int64_t* value) {
+    skipBlanks();
+    const char* start = p_;
+    bool negative = false;
+    if (p_ < end_ && (*p_ == '-' || *p_ == '+')) {
+      negative = *p_ == '-';
+      ++p_;
+    }
+    std::uint64_t v = 0;
+    const char* digits = p_;
+    for (; p_ < end_ && isDigit(*p_) && p_ - digits < 19; ++p_) {
+      v = 10 * v + static_cast<std::uint64_t>(*p_ - '0');
+    }
+    if (p_ == digits || v > static_cast<std::uint64_t>(
+                                 std::numeric_limits<std::int64_t>::max()) ||
+        (p_ < end_ &&
+         (isDigit(*p_) || *p_ == '.' || *p_ == 'e' || *p_ == 'E'))) {
+      p_ = start;
+      return false;
+    }
+    *value = negative ? -static_cast<std::int64_t>(v)
+                      : static_cast<std::int64_t>(v);
+    return true;
+  }
+
+  // True if only blanks are left.
+  bool atEnd() {
+    skipBlanks();
+    return p_ == end_;
+  }
+
+ private:
+  static bool isDigit(char c) { return c >= '0' && c <= '9'; }
+
+  void skipBlanks() {
+    while (p_ < end_ && (*p_ == ' ' || *p_ == '\t' || *p_ == '\r')) {
+      ++p_;
+    }
+  }
+
+  // std::strtod on a null-terminated copy of the token at start.
+  bool parseSlow(const char* start, double* value) {
+    char buffer[64];
+    const std::size_t length = static_cast<std::size_t>(p_ - start);
+    if (length >= sizeof(buffer)) {
+      return false;
+    }
+    std::copy(start, p_, buffer);
+    buffer[length] = '\0';
+    char* parsed_end;
+    *value = std::strtod(buffer, &parsed_end);
+    return parsed_end == buffer + length;
+  }
+
+  const char* p_;
+  const char* end_;
+};
+
+// Whole file contents, memory mapped where available.
+class TextFile {
+ public:
+  TextFile() : data_(NULL), size_(0), mapped_(false) {}
+  ~TextFile() {
+#ifdef SOPHUS_HAS_MMAP
+    if (mapped_) {
+      munmap(const_cast<char*>(data_), size_);
+    }
+#endif
+  }
+
+  bool open(const std::string& path) {
+#ifdef SOPHUS_HAS_MMAP
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+      return false;
+    }
+    struct stat status;
+    if (fstat(fd, &status) != 0) {
+      ::close(fd);
+      return false;
+    }
+    size_ = static_cast<std::size_t>(status.st_size);
+    if (size_ > 0) {
+      void* data = mmap(NULL, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (data != MAP_FAILED) {
+        madvise(data, size_, MADV_SEQUENTIAL);
+        data_ = static_cast<const char*>(data);
+        mapped_ = true;
+      }
+    }
+    ::close(fd);
+    if (mapped_ || size_ == 0) {
+      return true;
+    }
+#endif
+    std::ifstream stream(path.c_str(), std::ios::binary);
+    if (!stream) {
+      return false;
+    }
+    buffer_.assign(std::istreambuf_iterator<char>(stream),
+                   std::istreambuf_iterator<char>());
+    data_ = buffer_.data();
+    size_ = buffer_.size();
+    return true;
+  }
+
+  const char* begin() const { return data_; }
+  const char* end() const { return data_ + size_; }
+
+ private:
+  TextFile(const TextFile&);
+  TextFile& operator=(const TextFile&);
+
+  const char* data_;
+  std::size_t size_;
+  bool mapped_;
+  std::vector<char> buffer_;
+};
+
+// Start of the first line in [p, end) which holds data, or end.
+inline const char* nextDataLine(const char* p, const char* end) {
+  while (p < end) {
+    const char* q = p;
+    while (q < end && (*q == ' ' || *q == '\t' || *q == '\r')) {
+      ++q;
+    }
+    if (q < end && *q != '\n' && *q != '#') {
+      return p;
+    }
+    while (q < end && *q != '\n') {
+      ++q;
+    }
+    p = q < end ? q + 1 : end;
+  }
+  return end;
+}
+
+inline const char* lineEnd(const char* p, const char* end) {
+  while (p < end && *p != '\n') {
+    ++p;
+  }
+  return p;
+}
+
+// Pose of rotation q and translation t; false if q is not finite or too
+// close to zero to be normalized by the SO3 constructor.
+inline bool makePose(const Eigen::Quaterniond& q, const Eigen::Vector3d& t,
+                     SE3d* pose) {
+  const double squared_norm = q.squaredNorm();
+  if (!std::isfinite(squared_norm) ||
+      squared_norm <= SophusConstants<double>::epsilon()) {
+    return false;
+  }
+  *pose = SE3d(q, t);
+  return true;
+}
+
+// Parses one data line; false on malformed lines.
+inline bool parseTrajectoryLine(TrajectoryFormat format, const char* begin,
+                                const char* end, double* timestamp,
+                                SE3d* pose) {
+  TrajectoryLineParser parser(begin, end);
+  double v[12];
+  if (format == TrajectoryFormat::KITTI) {
+    for (int k = 0; k < 12; ++k) {
+      if (!parser.parseDouble(&v[k])) {
+        return false;
+      }
+    }
+    Eigen::Matrix3d R;
+    R << v[0], v[1], v[2], v[4], v[5], v[6], v[8], v[9], v[10];
+    if (!makePose(Eigen::Quaterniond(R), Eigen::Vector3d(v[3], v[7], v[11]),
+                  pose)) {
+      return false;
+    }
+  } else if (format == TrajectoryFormat::TUM) {
+    for (int k = 0; k < 8; ++k) {
+      if (!parser.parseDouble(&v[k])) {
+        return false;
+      }
+    }
+    *timestamp = v[0];
+    // Eigen::Quaterniond(w, x, y, z)
+    if (!makePose(Eigen::Quaterniond(v[7], v[4], v[5], v[6]),
+                  Eigen::Vector3d(v[1], v[2], v[3]), pose)) {
+      return false;
+    }
+  } else {
+    std::int64_t nanoseconds;
+    if (!parser.parseInt64(&nanoseconds)) {
+      return false;
+    }
+    for (int k = 0; k < 7; ++k) {
+      parser.skipSeparator(',');
+      if (!parser.parseDouble(&v[k])) {
+        return false;
+      }
+    }
+    *timestamp = static_cast<double>(nanoseconds / 1000000000) +
+                 1e-9 * static_cast<double>(nanoseconds % 1000000000);
+    // further columns are ignored
+    return makePose(Eigen::Quaterniond(v[3], v[4], v[5], v[6]),
+                    Eigen::Vector3d(v[0], v[1], v[2]), pose);
+  }
+  return parser.atEnd();
+}
+}  // namespace details
+
+/**
+ * \brief Parses a trajectory from the text in [begin, end)
+ *
+ * num_threads = 0 uses all hardware threads. Returns false, and leaves
+ * trajectory empty, if any data line is malformed.
+ */
+inline bool parseTrajectory(const char* begin, const char* end,
+                            TrajectoryFormat format, Trajectory* trajectory,
+                            std::size_t num_threads = 0) {
+  trajectory->timestamps.clear();
+  trajectory->poses.clear();
+  num_threads = resolveNumThreads(num_threads);
+  // Chunks of at least 64 kB, starting at line boundaries.
+  const std::size_t size = static_cast<std::size_t>(end - begin);
+  std::size_t num_chunks =
+      std::min<std::size_t>(4 * num_threads, size / 65536 + 1);
+  std::vector<const char*> chunk_begins(num_chunks + 1, end);
+  chunk_begins[0] = begin;
+  for (std::size_t c = 1; c < num_chunks; ++c) {
+    const char* p =
+        std::max(chunk_begins[c - 1], begin + c * size / num_chunks);
+    // start after the previous line break
+    while (p > begin && p < end && p[-1] != '\n') {
+      ++p;
+    }
+    chunk_begins[c] = p;
+  }
+
+  // count the data lines per chunk
+  std::vector<std::size_t> offsets(num_chunks + 1, 0);
+  parallelFor(0, num_chunks, num_threads, 1, [&](std::size_t c) {
+    std::size_t count = 0;
+    const char* chunk_end = chunk_begins[c + 1];
+    for (const char* p = details::nextDataLine(chunk_begins[c], chunk_end);
+         p < chunk_end; p = details::nextDataLine(
+                            details::lineEnd(p, chunk_end), chunk_end)) {
+      ++count;
+    }
+    offsets[c + 1] = count;
+  });
+  for (std::size_t c = 0; c < num_chunks; ++c) {
+    offsets[c + 1] += offsets[c];
+  }
+
+  const std::size_t num_poses = offsets[num_chunks];
+  std::vector<double> timestamps(format == TrajectoryFormat::KITTI ? 0
+                                                                   : num_poses);
+  trajectory->poses.resize(num_poses);
+  std::vector<char> ok(num_chunks, 1);
+  parallelFor(0, num_chunks, num_threads, 1, [&](std::size_t c) {
+    std::size_t i = offsets[c];
+    double timestamp = 0;
+    const char* chunk_end = chunk_begins[c + 1];
+    for (const char* p = details::nextDataLine(chunk_begins[c], chunk_end);
+         p < chunk_end; ++i) {
+      const char* line_end = details::lineEnd(p, chunk_end);
+      if (!details::parseTrajectoryLine(format, p, line_end, &timestamp,
+                                        &trajectory->poses[i])) {
+        ok[c] = 0;
+        return;
+      }
+      if (!timestamps.empty()) {
+        timestamps[i] = timestamp;
+      }
+      p = details::nextDataLine(line_end, chunk_end);
+    }
+  });
+  if (std::find(ok.begin(), ok.end(), 0) != ok.end()) {
+    trajectory->poses.clear();
+    return false;
+  }
+  trajectory->timestamps.swap(timestamps);
+  return true;
+}
+
+/**
+ * \brief Reads a trajectory file, see parseTrajectory()
+ */
+inline bool readTrajectory(const std::string& path, TrajectoryFormat format,
+                           Trajectory* trajectory,
+                           std::size_t num_threads = 0) {
+  details::TextFile file;
+  if (!file.open(path)) {
+    trajectory->timestamps.clear();
+    trajectory->poses.clear();
+    return false;
+  }
+  return parseTrajectory(file.begin(), file.end(), format, trajectory,
+                         num_threads);
+}
+
+/**
+ * \brief Formats a trajectory as text
+ *
+ * Pose entries are written with precision significant digits, TUM
+ * timestamps with nanosecond resolution. Formats other than KITTI require
+ * one timestamp per pose. Blocks of lines are formatted concurrently.
+ */
+inline std::string formatTrajectory(const Trajectory& trajectory,
+                                    TrajectoryFormat format,
+                                    int precision = 9,
+                                    std::size_t num_threads = 0) {
+  const std::size_t n = trajectory.poses.size();
+  SOPHUS_ENSURE(precision >= 1 && precision <= 17,
+                "precision must be in [1, 17], not %", precision);
+  SOPHUS_ENSURE(format == TrajectoryFormat::KITTI ||
+                    trajectory.timestamps.size() == n,
+                "% timestamps for % poses", trajectory.timestamps.size(), n);
+  const std::size_t kBlockSize = 4096;
+  const std::size_t num_blocks = (n + kBlockSize - 1) / kBlockSize;
+  std::vector<std::string> blocks(num_blocks);
+  parallelFor(0, num_blocks, num_threads, 1, [&](std::size_t b) {
+    std::string& text = blocks[b];
+    const std::size_t block_end = std::min(n, (b + 1) * kBlockSize);
+    text.reserve((block_end - b * kBlockSize) * (14 * (precision + 8)));
+    char line[1024];
+    for (std::size_t i = b * kBlockSize; i < block_end; ++i) {
+      const SE3d& T = trajectory.poses[i];
+      const Eigen::Vector3d& t = T.translation();
+      const Eigen::Quaterniond& q = T.unit_quaternion();
+      int length;
+      if (format == TrajectoryFormat::KITTI) {
+        const Eigen::Matrix<double, 3, 4> M = T.matrix3x4();
+        length = std::snprintf(
+            line, sizeof(line),
+            "%.*g %.*g %.*g %.*g %.*g %.*g %.*g %.*g %.*g %.*g %.*g %.*g\n",
+            precision, M(0, 0), precision, M(0, 1), precision, M(0, 2),
+            precision, M(0, 3), precision, M(1, 0), precision, M(1, 1),
+            precision, M(1, 2), precision, M(1, 3), precision, M(2, 0),
+            precision, M(2, 1), precision, M(2, 2), precision, M(2, 3));
+      } else if (format == TrajectoryFormat::TUM) {
+        length = std::snprintf(
+            line, sizeof(line), "%.9f %.*g %.*g %.*g %.*g %.*g %.*g %.*g\n",
+            trajectory.timestamps[i], precision, t.x(), precision, t.y(),
+            precision, t.z(), precision, q.x(), precision, q.y(), precision,
+            q.z(), precision, q.w());
+      } else {
+        const long long nanoseconds =
+            std::llround(trajectory.timestamps[i] * 1e9);
+        length = std::snprintf(
+            line, sizeof(line), "%lld,%.*g,%.*g,%.*g,%.*g,%.*g,%.*g,%.*g\n",
+            nanoseconds, precision, t.x(), precision, t.y(), precision, t.z(),
+            precision, q.w(), precision, q.x(), precision, q.y(), precision,
+            q.z());
+      }
+      text.append(line, static_cast<std::size_t>(length));
+    }
+  });
+
+  std::string text;
+  if (format == TrajectoryFormat::TUM) {
+    text = "# timestamp tx ty tz qx qy qz qw\n";
+  } else if (format == TrajectoryFormat::EuRoC) {
+    text =
+        "#timestamp [ns], p_RS_R_x [m], p_RS_R_y [m], p_RS_R_z [m], "
+        "q_RS_w [], q_RS_x [], q_RS_y [], q_RS_z []\n";
+  }
+  std::size_t size = text.size();
+  for (const std::string& block : blocks) {
+    size += block.size();
+  }
+  text.reserve(size);
+  for (const std::string& block : blocks) {
+    text += block;
+  }
+  return text;
+}
+
+/**
+ * \brief Writes a trajectory file, see formatTrajectory()
+ */
+inline bool writeTrajectory(const std::string& path,
+                            const Trajectory& trajectory,
+                            TrajectoryFormat format, int precision = 9,
+                            std::size_t num_threads = 0) {
+  const std::string text =
+      formatTrajectory(trajectory, format, precision, num_threads);
+  std::FILE* file = std::fopen(path.c_str(), "wb");
+  if (!file) {
+    return false;
+  }
+  const bool written =
+      std::fwrite(text.data(), 1, text.size(), file) == text.size();
+  return std::fclose(file) == 0 && written;
+}
+}  // namespace Sophus
+
+#endif  // SOPHUS_TRAJECTORY_IO_HPP
@@ -0,0 +1,285 @@
+// This file is part of Sophus.
+//
+// Copyright 2016 Hauke Strasdat
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights  to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+// Compares Sophus::SE3Manifold against a ceres::AutoDiffManifold of the same
+// Plus/Minus, on the manifold Jacobians alone and on a synthetic bundle
+// adjustment problem. Fails if both do not converge to the same cost, and
+// prints the timings.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include <ceres/ceres.h>
+#include <sophus/ceres_manifold.hpp>
+
+namespace {
+
+typedef Sophus::SE3Group<double> SE3d;
+typedef Eigen::Matrix<double, 6, 1> Vector6d;
+typedef Eigen::Matrix<double, 7, 1> Vector7d;
+
+const int kNumSamples = 1000;
+const int kNumRepetitions = 20;
+const int kNumCameras = 20;
+const int kNumPoints = 500;
+
+// Minimum over repetitions of the time of a pass over all samples, in
+// nanoseconds per sample.
+template <class Function>
+double time(Function f) {
+  double best = 1e30;
+  for (int r = 0; r < kNumRepetitions; ++r) {
+    auto start = std::chrono::steady_clock::now();
+    f();
+    auto end = std::chrono::steady_clock::now();
+    best = std::min(
+        best, std::chrono::duration<double, std::nano>(end - start).count());
+  }
+  return best / kNumSamples;
+}
+
+// Same operations as Sophus::SE3Manifold, differentiated by Ceres.
+struct SE3PlusMinus {
+  template <class T>
+  bool Plus(const T* T_raw, const T* delta_raw, T* T_plus_delta_raw) const {
+    const Eigen::Map<const Sophus::SE3Group<T> > T_(T_raw);
+    const Eigen::Map<const Eigen::Matrix<T, 6, 1> > delta(delta_raw);
+    Eigen::Map<Sophus::SE3Group<T> > T_plus_delta(T_plus_delta_raw);
+    T_plus_delta = T_ * Sophus::SE3Group<T>::exp(delta);
+    return true;
+  }
+
+  template <class T>
+  bool Minus(const T* T_b_raw, const T* T_a_raw, T* b_minus_a_raw) const {
+    const Eigen::Map<const Sophus::SE3Group<T> > T_a(T_a_raw);
+    const Eigen::Map<const Sophus::SE3Group<T> > T_b(T_b_raw);
+    Eigen::Map<Eigen::Matrix<T, 6, 1> > b_minus_a(b_minus_a_raw);
+    b_minus_a = (T_a.inverse() * T_b).log();
+    return true;
+  }
+};
+
+typedef ceres::AutoDiffManifold<SE3PlusMinus, SE3d::num_parameters, SE3d::DoF>
+    AutoDiffSE3Manifold;
+
+// Pinhole reprojection error of a point in world coordinates, observed by a
+// camera with pose T_cw and unit focal length.
+struct ReprojectionError {
+  explicit ReprojectionError(const Eigen::Vector2d& observation)
+      : observation(observation) {}
+
+  template <class T>
+  bool operator()(const T* const T_cw_raw, const T* const p_w_raw,
+                  T* residuals_raw) const {
+    const Eigen::Map<const Sophus::SE3Group<T> > T_cw(T_cw_raw);
+    const Eigen::Map<const Eigen::Matrix<T, 3, 1> > p_w(p_w_raw);
+    Eigen::Map<Eigen::Matrix<T, 2, 1> > residuals(residuals_raw);
+    const Eigen::Matrix<T, 3, 1> p_c = T_cw * p_w;
+    residuals = p_c.template head<2>() / p_c[2] - observation.cast<T>();
+    return true;
+  }
+
+  Eigen::Vector2d observation;
+};
+
+struct BundleAdjustmentProblem {
+  std::vector<Vector7d, Eigen::aligned_allocator<Vector7d> > cameras;
+  std::vector<Eigen::Vector3d> points;
+  // observations[i * kNumPoints + j] is point j seen by camera i
+  std::vector<Eigen::Vector2d, Eigen::aligned_allocator<Eigen::Vector2d> >
+      observations;
+};
+
+// Cameras on a circle looking at a cloud of points around the origin, with
+// noisy observations and perturbed initial values.
+BundleAdjustmentProblem syntheticProblem() {
+  std::mt19937 rng(42);
+  std::normal_distribution<double> noise(0.0, 1.0);
+
+  BundleAdjustmentProblem problem;
+  std::vector<SE3d> true_cameras;
+  for (int i = 0; i < kNumCameras; ++i) {
+    const double angle = 2 * M_PI * i / kNumCameras;
+    const SE3d T_wc(Sophus::SO3Group<double>::exp(
+                        Eigen::Vector3d(0.0, angle + M_PI, 0.0)),
+                    10.0 * Eigen::Vector3d(std::sin(angle), 0.0,
+                                           std::cos(angle)));
+    true_cameras.push_back(T_wc.inverse());
+    Vector6d perturbation;
+    for (int k = 0; k < 6; ++k) {
+      perturbation[k] = (i == 0 ? 0.0 : 0.02) * noise(rng);
+    }
+    const SE3d T_cw = true_cameras.back() * SE3d::exp(perturbation);
+    problem.cameras.push_back(Eigen::Map<const Vector7d>(T_cw.data()));
+  }
+  std::vector<Eigen::Vector3d> true_points;
+  for (int j = 0; j < kNumPoints; ++j) {
+    const Eigen::Vector3d p(noise(rng), noise(rng), noise(rng));
+    true_points.push_back(p);
+    problem.points.push_back(
+        p + 0.05 * Eigen::Vector3d(noise(rng), noise(rng), noise(rng)));
+  }
+  for (int i = 0; i < kNumCameras; ++i) {
+    for (int j = 0; j < kNumPoints; ++j) {
+      const Eigen::Vector3d p_c = true_cameras[i] * true_points[j];
+      problem.observations.push_back(
+          p_c.head<2>() / p_c[2] +
+          1e-3 * Eigen::Vector2d(noise(rng), noise(rng)));
+    }
+  }
+  return problem;
+}
+
+// Solves the problem in place, using manifolds created by make_manifold.
+template <class MakeManifold>
+ceres::Solver::Summary solve(BundleAdjustmentProblem* ba,
+                             MakeManifold make_manifold) {
+  ceres::Problem problem;
+  for (int i = 0; i < kNumCameras; ++i) {
+    problem.AddParameterBlock(ba->cameras[i].data(), SE3d::num_parameters,
+                              make_manifold());
+  }
+  for (int i = 0; i < kNumCameras; ++i) {
+    for (int j = 0; j < kNumPoints; ++j) {
+      ceres::CostFunction* cost_function =
+          new ceres::AutoDiffCostFunction<ReprojectionError, 2,
+                                          SE3d::num_parameters, 3>(
+              new ReprojectionError(ba->observations[i * kNumPoints + j]));
+      problem.AddResidualBlock(cost_function, NULL, ba->cameras[i].data(),
+                               ba->points[j].data());
+    }
+  }
+  // Fixes the rigid gauge freedom. The remaining scale freedom does not
+  // change the cost.
+  problem.SetParameterBlockConstant(ba->cameras[0].data());
+
+  ceres::Solver::Options options;
+  options.linear_solver_type = ceres::DENSE_SCHUR;
+  options.max_num_iterations = 50;
+  options.num_threads = 1;
+  ceres::Solver::Summary summary;
+  ceres::Solve(options, &problem, &summary);
+  return summary;
+}
+
+void report(const char* name, double analytic, double autodiff,
+            const char* unit) {
+  std::cout << name << ": analytic " << analytic << " " << unit
+            << ", autodiff " << autodiff << " " << unit << ", ratio "
+            << analytic / autodiff << std::endl;
+}
+}  // namespace
+
+int main() {
+  Sophus::SE3Manifold analytic;
+  AutoDiffSE3Manifold autodiff;
+
+  std::vector<Vector7d, Eigen::aligned_allocator<Vector7d> > params;
+  for (int i = 0; i < kNumSamples; ++i) {
+    const SE3d T = SE3d::exp(Vector6d::Random());
+    params.push_back(Eigen::Map<const Vector7d>(T.data()));
+  }
+
+  // Both manifolds have to yield the same Jacobians.
+  bool passed = true;
+  for (const Vector7d& p : params) {
+    Eigen::Matrix<double, 7, 6, Eigen::RowMajor> plus_analytic, plus_autodiff;
+    Eigen::Matrix<double, 6, 7, Eigen::RowMajor> minus_analytic,
+        minus_autodiff;
+    analytic.PlusJacobian(p.data(), plus_analytic.data());
+    autodiff.PlusJacobian(p.data(), plus_autodiff.data());
+    analytic.MinusJacobian(p.data(), minus_analytic.data());
+    autodiff.MinusJacobian(p.data(), minus_autodiff.data());
+    passed &= (plus_analytic - plus_autodiff).lpNorm<Eigen::Infinity>() < 1e-12;
+    passed &=
+        (minus_analytic - minus_autodiff).lpNorm<Eigen::Infinity>() < 1e-12;
+  }
+  if (!passed) {
+    std::cerr << "Analytic and autodiff manifold Jacobians differ!"
+              << std::endl;
+    return -1;
+  }
+
+  double sink = 0;
+  Eigen::Matrix<double, 7, 6, Eigen::RowMajor> plus_jacobian;
+  Eigen::Matrix<double, 6, 7, Eigen::RowMajor> minus_jacobian;
+  report("PlusJacobian", time([&]() {
+           for (const Vector7d& p : params) {
+             analytic.PlusJacobian(p.data(), plus_jacobian.data());
+             sink += plus_jacobian(0, 0);
+           }
+         }),
+         time([&]() {
+           for (const Vector7d& p : params) {
+             autodiff.PlusJacobian(p.data(), plus_jacobian.data());
+             sink += plus_jacobian(0, 0);
+           }
+         }),
+         "ns");
+  report("MinusJacobian", time([&]() {
+           for (const Vector7d& p : params) {
+             analytic.MinusJacobian(p.data(), minus_jacobian.data());
+             sink += minus_jacobian(0, 0);
+           }
+         }),
+         time([&]() {
+           for (const Vector7d& p : params) {
+             autodiff.MinusJacobian(p.data(), minus_jacobian.data());
+             sink += minus_jacobian(0, 0);
+           }
+         }),
+         "ns");
+  std::cout << "(checksum " << sink << ")" << std::endl;
+
+  BundleAdjustmentProblem ba_analytic = syntheticProblem();
+  BundleAdjustmentProblem ba_autodiff = ba_analytic;
+  const ceres::Solver::Summary summary_analytic = solve(
+      &ba_analytic, []() -> ceres::Manifold* {
+        return new Sophus::SE3Manifold;
+      });
+  const ceres::Solver::Summary summary_autodiff = solve(
+      &ba_autodiff, []() -> ceres::Manifold* {
+        return new AutoDiffSE3Manifold;
+      });
+  std::cout << "analytic: " << summary_analytic.BriefReport() << std::endl
+            << "autodiff: " << summary_autodiff.BriefReport() << std::endl;
+  report("BA total", summary_analytic.total_time_in_seconds,
+         summary_autodiff.total_time_in_seconds, "s");
+  report("BA jacobian evaluation",
+         summary_analytic.jacobian_evaluation_time_in_seconds,
+         summary_autodiff.jacobian_evaluation_time_in_seconds, "s");
+
+  if (!summary_analytic.IsSolutionUsable() ||
+      !summary_autodiff.IsSolutionUsable() ||
+      std::abs(summary_analytic.final_cost - summary_autodiff.final_cost) >
+          1e-6 * std::max(1.0, summary_autodiff.final_cost)) {
+    std::cerr << "Analytic and autodiff manifolds did not converge to the "
+                 "same cost!"
+              << std::endl;
+    return -1;
+  }
+  return 0;
+}
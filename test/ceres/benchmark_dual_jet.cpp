@@ -0,0 +1,193 @@
+// This file is part of Sophus.
+//
+// Copyright 2016 Hauke Strasdat
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights  to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+// Compares Sophus::Dual against ceres::Jet on the exp, log and action paths
+// of SE3. Fails if the derivatives differ, and prints the timings.
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+#include <ceres/jet.h>
+#include <sophus/dual.hpp>
+#include <sophus/se3.hpp>
+
+namespace {
+
+typedef Sophus::SE3Group<double> SE3d;
+typedef Eigen::Matrix<double, 6, 1> Vector6d;
+typedef Eigen::Matrix<double, 7, 1> Vector7d;
+
+const int kNumSamples = 1000;
+const int kNumRepetitions = 20;
+
+// Minimum over repetitions of the time of a pass over all samples, in
+// nanoseconds per sample.
+template <class Function>
+double time(Function f) {
+  double best = 1e30;
+  for (int r = 0; r < kNumRepetitions; ++r) {
+    auto start = std::chrono::steady_clock::now();
+    f();
+    auto end = std::chrono::steady_clock::now();
+    best = std::min(
+        best, std::chrono::duration<double, std::nano>(end - start).count());
+  }
+  return best / kNumSamples;
+}
+
+template <class S>
+struct Paths {
+  typedef Sophus::SE3Group<S> SE3;
+  typedef typename SE3::Tangent Tangent;
+  typedef typename SE3::Point Point;
+
+  // d exp(x).data() / dx
+  static Eigen::Matrix<double, 7, 6> exp(const Vector6d& x) {
+    Tangent dual_x;
+    for (int i = 0; i < 6; ++i) {
+      dual_x[i] = S(x[i], i);
+    }
+    const SE3 T = SE3::exp(dual_x);
+    Eigen::Matrix<double, 7, 6> J;
+    for (int i = 0; i < 7; ++i) {
+      J.row(i) = T.data()[i].v.transpose();
+    }
+    return J;
+  }
+
+  // d log(T) / d T.data(), S must have 7 lanes
+  static Eigen::Matrix<double, 6, 7> log(const Vector7d& params) {
+    SE3 T;
+    for (int i = 0; i < 7; ++i) {
+      T.data()[i] = S(params[i], i);
+    }
+    const Tangent x = SE3::log(T);
+    Eigen::Matrix<double, 6, 7> J;
+    for (int i = 0; i < 6; ++i) {
+      J.row(i) = x[i].v.transpose();
+    }
+    return J;
+  }
+
+  // d (T * p) / d T.data(), S must have 7 lanes
+  static Eigen::Matrix<double, 3, 7> action(const Vector7d& params,
+                                            const Eigen::Vector3d& p) {
+    SE3 T;
+    for (int i = 0; i < 7; ++i) {
+      T.data()[i] = S(params[i], i);
+    }
+    const Point q = T * p.cast<S>();
+    Eigen::Matrix<double, 3, 7> J;
+    for (int i = 0; i < 3; ++i) {
+      J.row(i) = q[i].v.transpose();
+    }
+    return J;
+  }
+};
+
+// Passes over all samples, returning the sum of all derivatives such that
+// nothing is optimized away.
+template <class S>
+double expPass(const std::vector<Vector6d, Eigen::aligned_allocator<Vector6d> >&
+                   tangents) {
+  double sum = 0;
+  for (const Vector6d& x : tangents) {
+    sum += Paths<S>::exp(x).sum();
+  }
+  return sum;
+}
+
+template <class S>
+double logPass(
+    const std::vector<Vector7d, Eigen::aligned_allocator<Vector7d> >& params) {
+  double sum = 0;
+  for (const Vector7d& p : params) {
+    sum += Paths<S>::log(p).sum();
+  }
+  return sum;
+}
+
+template <class S>
+double actionPass(
+    const std::vector<Vector7d, Eigen::aligned_allocator<Vector7d> >& params,
+    const std::vector<Eigen::Vector3d>& points) {
+  double sum = 0;
+  for (size_t i = 0; i < params.size(); ++i) {
+    sum += Paths<S>::action(params[i], points[i]).sum();
+  }
+  return sum;
+}
+
+void report(const char* name, double dual_ns, double jet_ns) {
+  std::cout << name << ": Dual " << dual_ns << " ns, Jet " << jet_ns
+            << " ns, ratio " << dual_ns / jet_ns << std::endl;
+}
+}  // namespace
+
+int main() {
+  typedef Sophus::Dual<double, 6> Dual6;
+  typedef Sophus::Dual<double, 7> Dual7;
+  typedef ceres::Jet<double, 6> Jet6;
+  typedef ceres::Jet<double, 7> Jet7;
+
+  std::vector<Vector6d, Eigen::aligned_allocator<Vector6d> > tangents;
+  std::vector<Vector7d, Eigen::aligned_allocator<Vector7d> > params;
+  std::vector<Eigen::Vector3d> points;
+  for (int i = 0; i < kNumSamples; ++i) {
+    Vector6d x = Vector6d::Random();
+    if (i % 10 == 0) {
+      x.tail<3>() *= 1e-12;
+    }
+    tangents.push_back(x);
+    const SE3d T = SE3d::exp(x);
+    params.push_back(Eigen::Map<const Vector7d>(T.data()));
+    points.push_back(Eigen::Vector3d::Random());
+  }
+
+  // Both types have to yield the same derivatives.
+  bool passed = true;
+  for (int i = 0; i < kNumSamples; ++i) {
+    passed &= (Paths<Dual6>::exp(tangents[i]) - Paths<Jet6>::exp(tangents[i]))
+                  .lpNorm<Eigen::Infinity>() < 1e-12;
+    passed &= (Paths<Dual7>::log(params[i]) - Paths<Jet7>::log(params[i]))
+                  .lpNorm<Eigen::Infinity>() < 1e-12;
+    passed &= (Paths<Dual7>::action(params[i], points[i]) -
+               Paths<Jet7>::action(params[i], points[i]))
+                  .lpNorm<Eigen::Infinity>() < 1e-12;
+  }
+  if (!passed) {
+    std::cerr << "Dual and Jet derivatives differ!" << std::endl;
+    return -1;
+  }
+
+  double sink = 0;
+  report("exp", time([&]() { sink += expPass<Dual6>(tangents); }),
+         time([&]() { sink += expPass<Jet6>(tangents); }));
+  report("log", time([&]() { sink += logPass<Dual7>(params); }),
+         time([&]() { sink += logPass<Jet7>(params); }));
+  report("action", time([&]() { sink += actionPass<Dual7>(params, points); }),
+         time([&]() { sink += actionPass<Jet7>(params, points); }));
+  std::cout << "(checksum " << sink << ")" << std::endl;
+  return 0;
+}
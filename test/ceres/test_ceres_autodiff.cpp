@@ -0,0 +1,104 @@
+// This file is part of Sophus.
+//
+// Copyright 2016 Hauke Strasdat
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights  to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+#include <ceres/jet.h>
+#include <sophus/dual.hpp>
+#include <sophus/se3.hpp>
+
+namespace Sophus {
+
+typedef ceres::Jet<double, 6> Jet6;
+typedef Dual<double, 6> Dual6;
+typedef Eigen::Matrix<double, 6, 1> Vector6d;
+
+static_assert(AutoDiffTraits<Jet6>::enabled,
+              "ceres::Jet has to take the chain rule path of exp and log");
+
+// x with lane i seeded in component i.
+template <class Scalar>
+typename SE3Group<Scalar>::Tangent seeded(const Vector6d& x) {
+  typename SE3Group<Scalar>::Tangent a;
+  for (int i = 0; i < 6; ++i) {
+    a[i] = Scalar(x[i], i);
+  }
+  return a;
+}
+
+template <class A, class B>
+bool sameLanes(const A& a, const B& b) {
+  return std::abs(a.a - b.a) < 1e-12 && (a.v - b.v).norm() < 1e-12 &&
+         std::isfinite(a.a) && a.v.allFinite();
+}
+
+// exp() and log() of SE3Group<ceres::Jet> agree with SE3Group<Dual>,
+// including at theta = pi, where the generic implementation of log() does
+// not give finite derivatives.
+bool testChainRule(const Vector6d& x) {
+  const SE3Group<Jet6> T_jet = SE3Group<Jet6>::exp(seeded<Jet6>(x));
+  const SE3Group<Dual6> T_dual = SE3Group<Dual6>::exp(seeded<Dual6>(x));
+  bool passed = true;
+  for (int i = 0; i < SE3Group<Jet6>::num_parameters; ++i) {
+    passed &= sameLanes(T_jet.data()[i], T_dual.data()[i]);
+  }
+  const SE3Group<Jet6>::Tangent log_jet = T_jet.log();
+  const SE3Group<Dual6>::Tangent log_dual = T_dual.log();
+  for (int i = 0; i < 6; ++i) {
+    passed &= sameLanes(log_jet[i], log_dual[i]);
+  }
+  return passed;
+}
+
+int test_ceres_autodiff() {
+  using std::cerr;
+  using std::endl;
+
+  cerr << "Test Ceres Jet autodiff" << endl << endl;
+  const double kPi = SophusConstants<double>::pi();
+  std::vector<Vector6d, Eigen::aligned_allocator<Vector6d> > tangents;
+  Vector6d x;
+  x << 1.0, -2.0, 0.5, 0.3, -0.6, 1.1;
+  tangents.push_back(x);
+  x << 0.0, 0.0, 0.0, 0.0, 0.0, 0.0;
+  tangents.push_back(x);
+  x << 4.0, -5.0, 0.0, kPi, 0.0, 0.0;
+  tangents.push_back(x);
+  x << 0.1, 0.2, 0.3, 0.0, 0.0, 1e-9;
+  tangents.push_back(x);
+  bool passed = true;
+  for (size_t i = 0; i < tangents.size(); ++i) {
+    passed &= testChainRule(tangents[i]);
+  }
+  if (!passed) {
+    cerr << "failed!" << endl << endl;
+    return -1;
+  }
+  cerr << "passed." << endl << endl;
+  return 0;
+}
+}  // namespace Sophus
+
+int main() { return Sophus::test_ceres_autodiff(); }
@@ -0,0 +1,331 @@
+// This file is part of Sophus.
+//
+// Copyright 2016 Hauke Strasdat
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights  to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <sophus/ceres_cost_functions.hpp>
+
+namespace Sophus {
+
+typedef Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>
+    RowMajorMatrix;
+
+/**
+ * Checks the Jacobians of a cost function against central differences.
+ *
+ * Ceres only ever uses the Jacobians multiplied by the PlusJacobian of the
+ * manifold of each block. Hence these products are compared with the
+ * numerical derivatives with respect to the tangent space; blocks without
+ * manifold are Euclidean.
+ */
+class CostFunctionTest {
+ public:
+  CostFunctionTest(const std::string& name,
+                   const ceres::CostFunction& cost_function)
+      : name_(name), cost_function_(cost_function) {}
+
+  bool run(const std::vector<std::vector<double> >& parameters,
+           const std::vector<const ceres::Manifold*>& manifolds) const {
+    const std::vector<int32_t>& sizes =
+        cost_function_.parameter_block_sizes();
+    const int num_residuals = cost_function_.num_residuals();
+
+    std::vector<const double*> parameter_ptrs;
+    for (size_t k = 0; k < parameters.size(); ++k) {
+      parameter_ptrs.push_back(parameters[k].data());
+    }
+    Eigen::VectorXd residuals(num_residuals);
+    std::vector<RowMajorMatrix> jacobians;
+    std::vector<double*> jacobian_ptrs;
+    for (size_t k = 0; k < parameters.size(); ++k) {
+      jacobians.push_back(RowMajorMatrix(num_residuals, sizes[k]));
+    }
+    for (size_t k = 0; k < parameters.size(); ++k) {
+      jacobian_ptrs.push_back(jacobians[k].data());
+    }
+    bool passed = cost_function_.Evaluate(parameter_ptrs.data(),
+                                          residuals.data(),
+                                          jacobian_ptrs.data());
+
+    // Without Jacobians, the residuals have to be the same.
+    Eigen::VectorXd residuals_only(num_residuals);
+    passed &= cost_function_.Evaluate(parameter_ptrs.data(),
+                                      residuals_only.data(), NULL);
+    passed &= check("residuals", residuals_only, residuals, 0.0);
+
+    const double h = 1e-6;
+    for (size_t k = 0; k < parameters.size(); ++k) {
+      const ceres::Manifold* manifold = manifolds[k];
+      const int tangent_size =
+          manifold == NULL ? sizes[k] : manifold->TangentSize();
+      RowMajorMatrix plus_jacobian =
+          RowMajorMatrix::Identity(sizes[k], tangent_size);
+      if (manifold != NULL) {
+        manifold->PlusJacobian(parameters[k].data(), plus_jacobian.data());
+      }
+
+      RowMajorMatrix num_jacobian(num_residuals, tangent_size);
+      for (int i = 0; i < tangent_size; ++i) {
+        Eigen::VectorXd plus_residuals(num_residuals);
+        Eigen::VectorXd minus_residuals(num_residuals);
+        for (int sign = -1; sign <= 1; sign += 2) {
+          Eigen::VectorXd delta = Eigen::VectorXd::Zero(tangent_size);
+          delta[i] = sign * h;
+          std::vector<double> perturbed = parameters[k];
+          if (manifold == NULL) {
+            perturbed[i] += delta[i];
+          } else {
+            manifold->Plus(parameters[k].data(), delta.data(),
+                           perturbed.data());
+          }
+          std::vector<const double*> perturbed_ptrs = parameter_ptrs;
+          perturbed_ptrs[k] = perturbed.data();
+          cost_function_.Evaluate(
+              perturbed_ptrs.data(),
+              sign > 0 ? plus_residuals.data() : minus_residuals.data(),
+              NULL);
+        }
+        num_jacobian.col(i) = (plus_residuals - minus_residuals) / (2 * h);
+      }
+      passed &= check("Jacobian", jacobians[k] * plus_jacobian, num_jacobian,
+                      1e-7);
+    }
+    return passed;
+  }
+
+  bool checkResiduals(const std::vector<std::vector<double> >& parameters,
+                      const Eigen::VectorXd& reference) const {
+    std::vector<const double*> parameter_ptrs;
+    for (size_t k = 0; k < parameters.size(); ++k) {
+      parameter_ptrs.push_back(parameters[k].data());
+    }
+    Eigen::VectorXd residuals(cost_function_.num_residuals());
+    cost_function_.Evaluate(parameter_ptrs.data(), residuals.data(), NULL);
+    return check("residuals", residuals, reference, 1e-12);
+  }
+
+ private:
+  template <class A, class B>
+  bool check(const char* what, const A& result, const B& reference,
+             double tolerance) const {
+    const double error =
+        (result - reference).template lpNorm<Eigen::Infinity>();
+    if (error <= tolerance *
+                     std::max(1.0,
+                              reference.template lpNorm<Eigen::Infinity>())) {
+      return true;
+    }
+    std::cerr << name_ << " " << what << " mismatch, result:" << std::endl
+              << result << std::endl
+              << "reference:" << std::endl
+              << reference << std::endl;
+    return false;
+  }
+
+  std::string name_;
+  const ceres::CostFunction& cost_function_;
+};
+
+template <class G>
+std::vector<double> parametersOf(const G& T) {
+  return std::vector<double>(T.data(), T.data() + G::num_parameters);
+}
+
+std::vector<double> parametersOf(const Eigen::Vector3d& p) {
+  return std::vector<double>(p.data(), p.data() + 3);
+}
+
+template <template <class, int> class Group, template <class> class Kernels>
+bool testPoseCostFunctions(const std::string& name, std::mt19937* rng) {
+  typedef Group<double, 0> G;
+  typedef Kernels<double> K;
+  typedef typename K::Tangent Tangent;
+  std::uniform_real_distribution<double> uniform(-1.0, 1.0);
+  Manifold<Group, Kernels> manifold;
+
+  bool passed = true;
+  for (int sample = 0; sample < 20; ++sample) {
+    Tangent x_a, x_b, x_ab;
+    for (int i = 0; i < K::DoF; ++i) {
+      x_a[i] = uniform(*rng);
+      x_b[i] = uniform(*rng);
+      x_ab[i] = uniform(*rng);
+    }
+    const G T_a = G::exp(x_a);
+    const G T_b = G::exp(x_b);
+    const G T_ab = G::exp(x_ab);
+    typename RelativePoseCostFunction<Group, Kernels>::InformationType
+        sqrt_information;
+    sqrt_information.setRandom();
+
+    const RelativePoseCostFunction<Group, Kernels> relative(T_ab,
+                                                            sqrt_information);
+    const CostFunctionTest relative_test(name + " relative pose", relative);
+    std::vector<std::vector<double> > parameters;
+    parameters.push_back(parametersOf(T_a));
+    parameters.push_back(parametersOf(T_b));
+    std::vector<const ceres::Manifold*> manifolds(2, &manifold);
+    passed &= relative_test.run(parameters, manifolds);
+    const G E = T_ab.inverse() * T_a.inverse() * T_b;
+    passed &= relative_test.checkResiduals(
+        parameters,
+        sqrt_information *
+            K::log(Eigen::Map<const typename K::Parameters>(E.data())));
+
+    const PosePriorCostFunction<Group, Kernels> prior(T_ab);
+    const CostFunctionTest prior_test(name + " prior", prior);
+    parameters.pop_back();
+    manifolds.pop_back();
+    passed &= prior_test.run(parameters, manifolds);
+  }
+  return passed;
+}
+
+template <template <class, int> class Group, template <class> class Kernels>
+bool testPointCostFunctions(const std::string& name, std::mt19937* rng) {
+  typedef Group<double, 0> G;
+  typedef Kernels<double> K;
+  typedef typename K::Tangent Tangent;
+  std::uniform_real_distribution<double> uniform(-1.0, 1.0);
+  Manifold<Group, Kernels> manifold;
+
+  bool passed = true;
+  for (int sample = 0; sample < 20; ++sample) {
+    Tangent x;
+    for (int i = 0; i < K::DoF; ++i) {
+      x[i] = uniform(*rng);
+    }
+    const G T = G::exp(x);
+    const Eigen::Vector3d p(uniform(*rng), uniform(*rng), uniform(*rng));
+    const Eigen::Vector3d q(uniform(*rng), uniform(*rng), uniform(*rng));
+    const Eigen::Vector3d n =
+        Eigen::Vector3d(uniform(*rng), uniform(*rng), uniform(*rng))
+            .normalized();
+    std::vector<std::vector<double> > parameters(1, parametersOf(T));
+    const std::vector<const ceres::Manifold*> manifolds(1, &manifold);
+
+    const PointToPointCostFunction<Group> point_to_point(p, q);
+    const CostFunctionTest point_to_point_test(name + " point-to-point",
+                                               point_to_point);
+    passed &= point_to_point_test.run(parameters, manifolds);
+    passed &= point_to_point_test.checkResiduals(parameters, T * p - q);
+
+    const PointToPlaneCostFunction<Group> point_to_plane(p, q, n);
+    const CostFunctionTest point_to_plane_test(name + " point-to-plane",
+                                               point_to_plane);
+    passed &= point_to_plane_test.run(parameters, manifolds);
+    passed &= point_to_plane_test.checkResiduals(
+        parameters, Eigen::Matrix<double, 1, 1>(n.dot(T * p - q)));
+  }
+  return passed;
+}
+
+bool testReprojectionCostFunction(std::mt19937* rng) {
+  std::uniform_real_distribution<double> uniform(-1.0, 1.0);
+  SE3Manifold manifold;
+
+  bool passed = true;
+  std::vector<Eigen::Vector3d> batch_points;
+  std::vector<Eigen::Vector2d, Eigen::aligned_allocator<Eigen::Vector2d> >
+      batch_observations;
+  for (int sample = 0; sample < 20; ++sample) {
+    Eigen::Matrix<double, 6, 1> x;
+    for (int i = 0; i < 6; ++i) {
+      x[i] = 0.3 * uniform(*rng);
+    }
+    const SE3Group<double> T_cw = SE3Group<double>::exp(x);
+    // In front of the camera
+    const Eigen::Vector3d p_w(uniform(*rng), uniform(*rng),
+                              5.0 + uniform(*rng));
+    const Eigen::Vector2d z(uniform(*rng), uniform(*rng));
+
+    const ReprojectionCostFunction reprojection(z, 500.0, 510.0, 320.0, 240.0);
+    const CostFunctionTest reprojection_test("SE3 reprojection",
+                                             reprojection);
+    std::vector<std::vector<double> > parameters;
+    parameters.push_back(parametersOf(T_cw));
+    parameters.push_back(parametersOf(p_w));
+    std::vector<const ceres::Manifold*> manifolds;
+    manifolds.push_back(&manifold);
+    manifolds.push_back(NULL);
+    passed &= reprojection_test.run(parameters, manifolds);
+    const Eigen::Vector3d p_c = T_cw * p_w;
+    passed &= reprojection_test.checkResiduals(
+        parameters,
+        Eigen::Vector2d(500.0 * p_c[0] / p_c[2] + 320.0 - z[0],
+                        510.0 * p_c[1] / p_c[2] + 240.0 - z[1]));
+    batch_points.push_back(p_w);
+    batch_observations.push_back(z);
+  }
+
+  // All points seen by the last pose, which has to yield the stacked
+  // residuals of ReprojectionCostFunction.
+  const SE3Group<double> T_cw = SE3Group<double>::exp(
+      0.3 * Eigen::Matrix<double, 6, 1>::Random());
+  const BatchReprojectionCostFunction batch(batch_points, batch_observations,
+                                            500.0, 510.0, 320.0, 240.0);
+  const CostFunctionTest batch_test("SE3 batch reprojection", batch);
+  const std::vector<std::vector<double> > parameters(1, parametersOf(T_cw));
+  passed &= batch_test.run(parameters,
+                           std::vector<const ceres::Manifold*>(1, &manifold));
+  Eigen::VectorXd stacked_residuals(2 * batch_points.size());
+  for (size_t i = 0; i < batch_points.size(); ++i) {
+    const ReprojectionCostFunction reprojection(batch_observations[i], 500.0,
+                                                510.0, 320.0, 240.0);
+    const double* parameter_ptrs[2] = {T_cw.data(), batch_points[i].data()};
+    reprojection.Evaluate(parameter_ptrs, &stacked_residuals[2 * i], NULL);
+  }
+  passed &= batch_test.checkResiduals(parameters, stacked_residuals);
+  return passed;
+}
+
+int test_ceres_cost_functions() {
+  using std::cerr;
+  using std::endl;
+
+  cerr << "Test Ceres cost functions" << endl << endl;
+  std::mt19937 rng(11);
+  bool passed = true;
+  passed &= testPoseCostFunctions<SE2Group, generated::SE2Kernels>("SE2", &rng);
+  passed &= testPoseCostFunctions<SE3Group, generated::SE3Kernels>("SE3", &rng);
+  passed &=
+      testPoseCostFunctions<Sim3Group, generated::Sim3Kernels>("Sim3", &rng);
+  passed &=
+      testPointCostFunctions<SE3Group, generated::SE3Kernels>("SE3", &rng);
+  passed &=
+      testPointCostFunctions<Sim3Group, generated::Sim3Kernels>("Sim3", &rng);
+  passed &= testReprojectionCostFunction(&rng);
+  if (!passed) {
+    cerr << "failed!" << endl << endl;
+    return -1;
+  }
+  cerr << "passed." << endl << endl;
+  return 0;
+}
+}  // namespace Sophus
+
+int main() { return Sophus::test_ceres_cost_functions(); }
@@ -0,0 +1,166 @@
+// This file is part of Sophus.
+//
+// Copyright 2016 Hauke Strasdat
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights  to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <string>
+
+#include <sophus/ceres_manifold.hpp>
+
+namespace Sophus {
+
+/**
+ * Checks the manifold invariants of Ceres (Plus and Minus are inverse to
+ * each other, MinusJacobian * PlusJacobian = I) and the Jacobians against
+ * central differences.
+ */
+template <class ManifoldType>
+class ManifoldTests {
+ public:
+  static const int DoF = ManifoldType::DoF;
+  static const int num_parameters = ManifoldType::num_parameters;
+  typedef typename ManifoldType::GroupType G;
+  typedef typename ManifoldType::Tangent Tangent;
+  typedef typename ManifoldType::Parameters Parameters;
+  typedef typename ManifoldType::PlusJacobianType PlusJacobianType;
+  typedef typename ManifoldType::MinusJacobianType MinusJacobianType;
+
+  explicit ManifoldTests(const std::string& name) : name_(name) {}
+
+  bool run() {
+    bool passed = manifold_.AmbientSize() == num_parameters &&
+                  manifold_.TangentSize() == DoF;
+
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<double> uniform(-1.0, 1.0);
+    for (int sample = 0; sample < 50; ++sample) {
+      Tangent x, delta;
+      for (int i = 0; i < DoF; ++i) {
+        x[i] = 1.5 * uniform(rng);
+        delta[i] = (sample % 5 == 0 ? 1e-9 : 0.5) * uniform(rng);
+      }
+      const Parameters p = ManifoldType::K::exp(x);
+
+      Parameters p_plus_zero, p_plus_delta;
+      manifold_.Plus(p.data(), Tangent::Zero().eval().data(),
+                     p_plus_zero.data());
+      manifold_.Plus(p.data(), delta.data(), p_plus_delta.data());
+      passed &= check("Plus(x, 0)", p_plus_zero, p, 1e-15);
+
+      Tangent zero, delta_again;
+      manifold_.Minus(p.data(), p.data(), zero.data());
+      manifold_.Minus(p_plus_delta.data(), p.data(), delta_again.data());
+      passed &= check("Minus(x, x)", zero, Tangent::Zero(), 1e-15);
+      passed &= check("Minus(Plus(x, delta), x)", delta_again, delta, 1e-12);
+
+      PlusJacobianType plus_jacobian;
+      MinusJacobianType minus_jacobian;
+      manifold_.PlusJacobian(p.data(), plus_jacobian.data());
+      manifold_.MinusJacobian(p.data(), minus_jacobian.data());
+      passed &= check("MinusJacobian * PlusJacobian",
+                      minus_jacobian * plus_jacobian,
+                      Eigen::Matrix<double, DoF, DoF>::Identity(), 1e-12);
+
+      const double h = 1e-6;
+      PlusJacobianType num_plus_jacobian;
+      for (int i = 0; i < DoF; ++i) {
+        Tangent e = Tangent::Zero();
+        e[i] = h;
+        Parameters plus, minus;
+        manifold_.Plus(p.data(), e.data(), plus.data());
+        manifold_.Plus(p.data(), (-e).eval().data(), minus.data());
+        num_plus_jacobian.col(i) = (plus - minus) / (2 * h);
+      }
+      passed &= check("PlusJacobian", plus_jacobian, num_plus_jacobian, 1e-8);
+
+      MinusJacobianType num_minus_jacobian;
+      for (int i = 0; i < num_parameters; ++i) {
+        Parameters e = Parameters::Zero();
+        e[i] = h;
+        const Parameters p_plus = p + e;
+        const Parameters p_minus = p - e;
+        Tangent plus, minus;
+        manifold_.Minus(p_plus.data(), p.data(), plus.data());
+        manifold_.Minus(p_minus.data(), p.data(), minus.data());
+        num_minus_jacobian.col(i) = (plus - minus) / (2 * h);
+      }
+      passed &=
+          check("MinusJacobian", minus_jacobian, num_minus_jacobian, 1e-8);
+
+      Eigen::Matrix<double, 3, num_parameters, Eigen::RowMajor> ambient;
+      ambient.setRandom();
+      Eigen::Matrix<double, 3, DoF, DoF == 1 ? Eigen::ColMajor
+                                             : Eigen::RowMajor>
+          tangent;
+      manifold_.RightMultiplyByPlusJacobian(p.data(), 3, ambient.data(),
+                                            tangent.data());
+      passed &= check("RightMultiplyByPlusJacobian", tangent,
+                      ambient * plus_jacobian, 1e-14);
+    }
+    return passed;
+  }
+
+ private:
+  template <class A, class B>
+  bool check(const char* what, const A& result, const B& reference,
+             double tolerance) const {
+    const double error =
+        (result - reference).template lpNorm<Eigen::Infinity>();
+    if (error <= tolerance *
+                     std::max(1.0,
+                              reference.template lpNorm<Eigen::Infinity>())) {
+      return true;
+    }
+    std::cerr << name_ << " " << what << " mismatch, result:" << std::endl
+              << result << std::endl
+              << "reference:" << std::endl
+              << reference << std::endl;
+    return false;
+  }
+
+  std::string name_;
+  ManifoldType manifold_;
+};
+
+int test_ceres_manifold() {
+  using std::cerr;
+  using std::endl;
+
+  cerr << "Test Ceres manifolds" << endl << endl;
+  bool passed = true;
+  passed &= ManifoldTests<SO2Manifold>("SO2").run();
+  passed &= ManifoldTests<SE2Manifold>("SE2").run();
+  passed &= ManifoldTests<SO3Manifold>("SO3").run();
+  passed &= ManifoldTests<SE3Manifold>("SE3").run();
+  passed &= ManifoldTests<RxSO3Manifold>("RxSO3").run();
+  passed &= ManifoldTests<Sim3Manifold>("Sim3").run();
+  if (!passed) {
+    cerr << "failed!" << endl << endl;
+    return -1;
+  }
+  cerr << "passed." << endl << endl;
+  return 0;
+}
+}  // namespace Sophus
+
+int main() { return Sophus::test_ceres_manifold(); }
@@ -0,0 +1,693 @@
+// This file is part of Sophus.
+//
+// Copyright 2016 Hauke Strasdat
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights  to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#ifndef SOPHUS_PROPERTY_TESTS_HPP
+#define SOPHUS_PROPERTY_TESTS_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <map>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sophus/se2.hpp>
+#include <sophus/se3.hpp>
+#include <sophus/sim3.hpp>
+#include "tests.hpp"
+
+namespace Sophus {
+
+/**
+ * \brief Region of the tangent space a random sample is drawn from
+ *
+ * NearZero and NearPi place the rotation angle (and, for the similarity
+ * groups, the log-scale) close to the singularities of exp/log, where the
+ * closed-form expressions switch to their Taylor expansions.
+ */
+enum class SampleRegime { Generic, NearZero, NearPi };
+
+/**
+ * \brief Every fourth sample is taken from each singular regime
+ */
+inline SampleRegime sampleRegime(std::size_t i) {
+  switch (i % 4) {
+    case 2:
+      return SampleRegime::NearZero;
+    case 3:
+      return SampleRegime::NearPi;
+    default:
+      return SampleRegime::Generic;
+  }
+}
+
+template <class Scalar>
+inline const char* scalarSuffix();
+
+template <>
+inline const char* scalarSuffix<double>() {
+  return "d";
+}
+
+template <>
+inline const char* scalarSuffix<float>() {
+  return "f";
+}
+
+namespace details {
+// Magnitude in [1e-8, 1e-2], log-uniformly distributed.
+template <class Scalar>
+Scalar sampleTiny(std::mt19937_64& rng) {
+  std::uniform_real_distribution<double> exponent(-8., -2.);
+  return static_cast<Scalar>(std::pow(10., exponent(rng)));
+}
+
+template <class Scalar>
+Scalar sampleAngle(std::mt19937_64& rng, SampleRegime regime) {
+  const double kPi = SophusConstants<double>::pi();
+  std::uniform_real_distribution<double> uniform(-kPi, kPi);
+  std::bernoulli_distribution coin;
+  const Scalar sign = coin(rng) ? Scalar(1) : Scalar(-1);
+  switch (regime) {
+    case SampleRegime::NearZero:
+      return sign * sampleTiny<Scalar>(rng);
+    case SampleRegime::NearPi:
+      return sign * (SophusConstants<Scalar>::pi() - sampleTiny<Scalar>(rng));
+    case SampleRegime::Generic:
+    default:
+      return static_cast<Scalar>(uniform(rng));
+  }
+}
+
+template <class Scalar, int Rows>
+Eigen::Matrix<Scalar, Rows, 1> sampleGaussian(std::mt19937_64& rng,
+                                              double sigma) {
+  std::normal_distribution<double> normal(0., sigma);
+  Eigen::Matrix<Scalar, Rows, 1> v;
+  for (int i = 0; i < Rows; ++i) {
+    v[i] = static_cast<Scalar>(normal(rng));
+  }
+  return v;
+}
+
+template <class Scalar>
+Eigen::Matrix<Scalar, 3, 1> sampleRotationVector(std::mt19937_64& rng,
+                                                 SampleRegime regime) {
+  Eigen::Matrix<double, 3, 1> axis;
+  do {
+    axis = sampleGaussian<double, 3>(rng, 1.);
+  } while (axis.squaredNorm() < 1e-6);
+  axis.normalize();
+  return axis.cast<Scalar>() * sampleAngle<Scalar>(rng, regime);
+}
+
+template <class Scalar>
+Scalar sampleLogScale(std::mt19937_64& rng, SampleRegime regime) {
+  if (regime == SampleRegime::NearZero) {
+    std::bernoulli_distribution coin;
+    return (coin(rng) ? Scalar(1) : Scalar(-1)) * sampleTiny<Scalar>(rng);
+  }
+  std::uniform_real_distribution<double> uniform(-1., 1.);
+  return static_cast<Scalar>(uniform(rng));
+}
+}  // namespace details
+
+/**
+ * \brief Draws random tangent vectors and points for a Lie group
+ *
+ * Specialized for each group, since the layout of the tangent vector
+ * (which components are rotation, translation or scale) differs.
+ */
+template <class LieGroup>
+struct PropertySampler;
+
+template <class Scalar>
+struct PropertySampler<SO2Group<Scalar> > {
+  typedef typename SO2Group<Scalar>::Tangent Tangent;
+  typedef typename SO2Group<Scalar>::Point Point;
+
+  static const char* name() { return "SO2"; }
+
+  static Tangent tangent(std::mt19937_64& rng, SampleRegime regime) {
+    return details::sampleAngle<Scalar>(rng, regime);
+  }
+
+  static Point point(std::mt19937_64& rng) {
+    return details::sampleGaussian<Scalar, 2>(rng, 10.);
+  }
+};
+
+template <class Scalar>
+struct PropertySampler<SE2Group<Scalar> > {
+  typedef typename SE2Group<Scalar>::Tangent Tangent;
+  typedef typename SE2Group<Scalar>::Point Point;
+
+  static const char* name() { return "SE2"; }
+
+  static Tangent tangent(std::mt19937_64& rng, SampleRegime regime) {
+    Tangent x;
+    x.template head<2>() = details::sampleGaussian<Scalar, 2>(rng, 2.);
+    x[2] = details::sampleAngle<Scalar>(rng, regime);
+    return x;
+  }
+
+  static Point point(std::mt19937_64& rng) {
+    return details::sampleGaussian<Scalar, 2>(rng, 10.);
+  }
+};
+
+template <class Scalar>
+struct PropertySampler<SO3Group<Scalar> > {
+  typedef typename SO3Group<Scalar>::Tangent Tangent;
+  typedef typename SO3Group<Scalar>::Point Point;
+
+  static const char* name() { return "SO3"; }
+
+  static Tangent tangent(std::mt19937_64& rng, SampleRegime regime) {
+    return details::sampleRotationVector<Scalar>(rng, regime);
+  }
+
+  static Point point(std::mt19937_64& rng) {
+    return details::sampleGaussian<Scalar, 3>(rng, 10.);
+  }
+};
+
+template <class Scalar>
+struct PropertySampler<SE3Group<Scalar> > {
+  typedef typename SE3Group<Scalar>::Tangent Tangent;
+  typedef typename SE3Group<Scalar>::Point Point;
+
+  static const char* name() { return "SE3"; }
+
+  static Tangent tangent(std::mt19937_64& rng, SampleRegime regime) {
+    Tangent x;
+    x.template head<3>() = details::sampleGaussian<Scalar, 3>(rng, 2.);
+    x.template tail<3>() = details::sampleRotationVector<Scalar>(rng, regime);
+    return x;
+  }
+
+  static Point point(std::mt19937_64& rng) {
+    return details::sampleGaussian<Scalar, 3>(rng, 10.);
+  }
+};
+
+template <class Scalar>
+struct PropertySampler<RxSO3Group<Scalar> > {
+  typedef typename RxSO3Group<Scalar>::Tangent Tangent;
+  typedef typename RxSO3Group<Scalar>::Point Point;
+
+  static const char* name() { return "RxSO3"; }
+
+  static Tangent tangent(std::mt19937_64& rng, SampleRegime regime) {
+    Tangent x;
+    x.template head<3>() = details::sampleRotationVector<Scalar>(rng, regime);
+    x[3] = details::sampleLogScale<Scalar>(rng, regime);
+    return x;
+  }
+
+  static Point point(std::mt19937_64& rng) {
+    return details::sampleGaussian<Scalar, 3>(rng, 10.);
+  }
+};
+
+template <class Scalar>
+struct PropertySampler<Sim3Group<Scalar> > {
+  typedef typename Sim3Group<Scalar>::Tangent Tangent;
+  typedef typename Sim3Group<Scalar>::Point Point;
+
+  static const char* name() { return "Sim3"; }
+
+  static Tangent tangent(std::mt19937_64& rng, SampleRegime regime) {
+    Tangent x;
+    x.template head<3>() = details::sampleGaussian<Scalar, 3>(rng, 2.);
+    x.template segment<3>(3) =
+        details::sampleRotationVector<Scalar>(rng, regime);
+    x[6] = details::sampleLogScale<Scalar>(rng, regime);
+    return x;
+  }
+
+  static Point point(std::mt19937_64& rng) {
+    return details::sampleGaussian<Scalar, 3>(rng, 10.);
+  }
+};
+
+/**
+ * \brief Accuracy and timing of one property over all samples
+ */
+struct PropertyStats {
+  std::string key;
+  std::size_t count;
+  double max_error;
+  double p50_error;
+  double p99_error;
+  double ns_per_op;
+  // Errors below this bound are never reported as regressions, since they
+  // are at the level of the rounding error of the scalar type.
+  double error_floor;
+};
+
+struct PropertyBaselineEntry {
+  double max_error;
+  double p99_error;
+  double ns_per_op;
+};
+
+/**
+ * \brief Stored accuracy/timing results used to detect regressions
+ *
+ * The file contains one line "<key> <max_error> <p99_error> <ns_per_op>" per
+ * property; lines starting with '#' are ignored.
+ */
+class PropertyBaseline {
+ public:
+  /**
+   * \returns false if file cannot be read
+   */
+  bool load(const std::string& path) {
+    std::ifstream in(path.c_str());
+    if (!in) {
+      return false;
+    }
+    std::string line;
+    while (std::getline(in, line)) {
+      if (line.empty() || line[0] == '#') {
+        continue;
+      }
+      // Parsed with strtod, since operator>> does not accept "inf".
+      std::istringstream fields(line);
+      std::string key, max_error, p99_error, ns_per_op;
+      if (fields >> key >> max_error >> p99_error >> ns_per_op) {
+        PropertyBaselineEntry& entry = entries_[key];
+        entry.max_error = std::strtod(max_error.c_str(), nullptr);
+        entry.p99_error = std::strtod(p99_error.c_str(), nullptr);
+        entry.ns_per_op = std::strtod(ns_per_op.c_str(), nullptr);
+      }
+    }
+    return true;
+  }
+
+  /**
+   * \returns false if file cannot be written
+   */
+  bool save(const std::string& path) const {
+    std::ofstream out(path.c_str());
+    if (!out) {
+      return false;
+    }
+    out << "# Sophus property test baseline, regenerate with" << std::endl
+        << "# SOPHUS_PROPERTY_UPDATE_BASELINE=1 ./test_properties" << std::endl
+        << "# key max_error p99_error ns_per_op" << std::endl;
+    out << std::setprecision(3) << std::scientific;
+    for (const auto& key_entry : entries_) {
+      out << key_entry.first << " " << key_entry.second.max_error << " "
+          << key_entry.second.p99_error << " " << key_entry.second.ns_per_op
+          << std::endl;
+    }
+    return static_cast<bool>(out);
+  }
+
+  const PropertyBaselineEntry* find(const std::string& key) const {
+    auto it = entries_.find(key);
+    return it == entries_.end() ? nullptr : &it->second;
+  }
+
+  void set(const PropertyStats& stats) {
+    PropertyBaselineEntry& entry = entries_[stats.key];
+    entry.max_error = stats.max_error;
+    entry.p99_error = stats.p99_error;
+    entry.ns_per_op = stats.ns_per_op;
+  }
+
+ private:
+  std::map<std::string, PropertyBaselineEntry> entries_;
+};
+
+/**
+ * \brief Compares stats against baseline
+ *
+ * The 99th percentile may grow by a factor of 2 and the maximum (which
+ * depends more strongly on the number of samples) by a factor of 10. The
+ * timing is only checked if check_timing is set, and may grow by a factor
+ * of 2.
+ *
+ * \returns false on regression or if key is missing from baseline
+ */
+inline bool checkRegression(const PropertyStats& stats,
+                            const PropertyBaseline& baseline,
+                            bool check_timing, std::ostream& os) {
+  const PropertyBaselineEntry* entry = baseline.find(stats.key);
+  if (entry == nullptr) {
+    os << stats.key << ": missing from baseline" << std::endl;
+    return false;
+  }
+  bool passed = true;
+  if (!(stats.p99_error <=
+        std::max(2. * entry->p99_error, stats.error_floor))) {
+    os << stats.key << ": p99 error " << stats.p99_error
+       << " regressed, baseline " << entry->p99_error << std::endl;
+    passed = false;
+  }
+  if (!(stats.max_error <=
+        std::max(10. * entry->max_error, stats.error_floor))) {
+    os << stats.key << ": max error " << stats.max_error
+       << " regressed, baseline " << entry->max_error << std::endl;
+    passed = false;
+  }
+  if (check_timing && stats.ns_per_op > 2. * entry->ns_per_op) {
+    os << stats.key << ": " << stats.ns_per_op
+       << " ns/op regressed, baseline " << entry->ns_per_op << std::endl;
+    passed = false;
+  }
+  return passed;
+}
+
+struct PropertyTestOptions {
+  std::size_t num_samples = 20000;
+  std::size_t num_threads = 1;
+  std::uint64_t seed = 0;
+  // Number of samples (taken from the front) used for the timing pass.
+  std::size_t num_timing_samples = 4096;
+};
+
+/**
+ * \brief Randomized check of the Lie group identities
+ *
+ * For each sample a random group element g, tangent vectors x, y and a point
+ * p are drawn and the following properties are evaluated:
+ *
+ *  - exp_log:     exp(log(g)) = g
+ *  - exp_matrix:  exp(x) = expm(hat(x))
+ *  - adjoint:     Adj(g) x = vee(g hat(x) g^-1)
+ *  - lie_bracket: [x, y] = vee(hat(x) hat(y) - hat(y) hat(x))
+ *  - action:      g * p = T(g) p
+ *  - inverse:     g * g^-1 = I
+ *
+ * Errors are normalized by the magnitude of the inputs. Samples are evaluated
+ * in parallel; the random stream is seeded per chunk so that the results do
+ * not depend on the number of threads.
+ */
+template <class LieGroup>
+class PropertyTests {
+ public:
+  typedef typename LieGroup::Scalar Scalar;
+  typedef typename LieGroup::Transformation Transformation;
+  typedef typename LieGroup::Tangent Tangent;
+  typedef typename LieGroup::Point Point;
+  typedef typename LieGroup::Adjoint Adjoint;
+  typedef PropertySampler<LieGroup> Sampler;
+  static const int N = LieGroup::N;
+
+  enum Property {
+    kExpLog,
+    kExpMatrix,
+    kAdjoint,
+    kLieBracket,
+    kAction,
+    kInverse,
+    kNumProperties
+  };
+
+  struct Sample {
+    LieGroup g;
+    Tangent x;
+    Tangent y;
+    Point p;
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+  };
+
+  explicit PropertyTests(const PropertyTestOptions& options)
+      : options_(options) {}
+
+  static const char* propertyName(int property) {
+    static const char* const kNames[kNumProperties] = {
+        "exp_log", "exp_matrix", "adjoint", "lie_bracket", "action",
+        "inverse"};
+    return kNames[property];
+  }
+
+  static std::string key(int property) {
+    return std::string(Sampler::name()) + scalarSuffix<Scalar>() + "." +
+           propertyName(property);
+  }
+
+  static Sample sample(std::mt19937_64& rng, SampleRegime regime) {
+    Sample s;
+    s.g = LieGroup::exp(Sampler::tangent(rng, regime));
+    s.x = Sampler::tangent(rng, regime);
+    s.y = Sampler::tangent(rng, SampleRegime::Generic);
+    s.p = Sampler::point(rng);
+    return s;
+  }
+
+  /**
+   * \returns normalized error of property for given sample
+   */
+  static double error(int property, const Sample& s) {
+    const Transformation T = s.g.matrix();
+    switch (property) {
+      case kExpLog:
+        return normOf(LieGroup::exp(s.g.log()).matrix() - T) /
+               (1. + normOf(T));
+      case kExpMatrix: {
+        Transformation expm_x = LieGroup::hat(s.x).exp();
+        return normOf(LieGroup::exp(s.x).matrix() - expm_x) /
+               (1. + normOf(expm_x));
+      }
+      case kAdjoint: {
+        const Transformation T_inv = s.g.inverse().matrix();
+        Tangent ad1 = s.g.Adj() * s.x;
+        Tangent ad2 = LieGroup::vee(T * LieGroup::hat(s.x) * T_inv);
+        return normOf(ad1 - ad2) /
+               (1. + normOf(s.x) * normOf(T) * normOf(T_inv));
+      }
+      case kLieBracket: {
+        Transformation hat_x = LieGroup::hat(s.x);
+        Transformation hat_y = LieGroup::hat(s.y);
+        Tangent diff = LieGroup::lieBracket(s.x, s.y) -
+                       LieGroup::vee(hat_x * hat_y - hat_y * hat_x);
+        return normOf(diff) / (1. + normOf(s.x) * normOf(s.y));
+      }
+      case kAction: {
+        Point expected = act(T, s.p);
+        return normOf(Point(s.g * s.p) - expected) / (1. + normOf(s.p));
+      }
+      case kInverse:
+      default:
+        return normOf((s.g * s.g.inverse()).matrix() -
+                      Transformation::Identity());
+    }
+  }
+
+  /**
+   * \returns some value depending on the result of the group operation the
+   *          property tests, so that it is not optimized away when timed.
+   */
+  static Scalar evaluate(int property, const Sample& s) {
+    switch (property) {
+      case kExpLog:
+        return LieGroup::exp(s.g.log()).data()[0];
+      case kExpMatrix:
+        return LieGroup::exp(s.x).data()[0];
+      case kAdjoint:
+        return firstOf(s.g.Adj() * s.x);
+      case kLieBracket:
+        return firstOf(LieGroup::lieBracket(s.x, s.y));
+      case kAction:
+        return firstOf(s.g * s.p);
+      case kInverse:
+      default:
+        return (s.g * s.g.inverse()).data()[0];
+    }
+  }
+
+  /**
+   * \returns stats of all properties
+   */
+  std::vector<PropertyStats> run() const {
+    const std::size_t n = options_.num_samples;
+    std::vector<std::vector<double> > errors(kNumProperties,
+                                             std::vector<double>(n));
+    const std::size_t num_chunks = (n + kChunkSize - 1) / kChunkSize;
+    std::atomic<std::size_t> next_chunk(0);
+    auto worker = [&]() {
+      for (std::size_t chunk = next_chunk++; chunk < num_chunks;
+           chunk = next_chunk++) {
+        std::mt19937_64 rng = chunkRng(chunk);
+        const std::size_t end = std::min(n, (chunk + 1) * kChunkSize);
+        for (std::size_t i = chunk * kChunkSize; i < end; ++i) {
+          Sample s = sample(rng, sampleRegime(i));
+          for (int property = 0; property < kNumProperties; ++property) {
+            errors[property][i] = error(property, s);
+          }
+        }
+      }
+    };
+    std::vector<std::thread> threads;
+    for (std::size_t t = 1; t < options_.num_threads; ++t) {
+      threads.emplace_back(worker);
+    }
+    worker();
+    for (std::thread& thread : threads) {
+      thread.join();
+    }
+
+    std::vector<double> ns_per_op = time();
+
+    std::vector<PropertyStats> stats;
+    for (int property = 0; property < kNumProperties; ++property) {
+      PropertyStats s;
+      s.key = key(property);
+      s.count = n;
+      s.ns_per_op = ns_per_op[property];
+      s.error_floor = 16. * std::numeric_limits<Scalar>::epsilon();
+      summarize(&errors[property], &s);
+      stats.push_back(s);
+    }
+    return stats;
+  }
+
+ private:
+  static const std::size_t kChunkSize = 1024;
+
+  std::mt19937_64 chunkRng(std::size_t chunk) const {
+    std::seed_seq seq{static_cast<std::uint64_t>(options_.seed),
+                      static_cast<std::uint64_t>(chunk)};
+    return std::mt19937_64(seq);
+  }
+
+  // Single threaded, best of several repetitions.
+  std::vector<double> time() const {
+    const std::size_t n =
+        std::min(options_.num_timing_samples, options_.num_samples);
+    std::vector<Sample, Eigen::aligned_allocator<Sample> > samples;
+    for (std::size_t chunk = 0; samples.size() < n; ++chunk) {
+      std::mt19937_64 rng = chunkRng(chunk);
+      for (std::size_t i = 0; i < kChunkSize && samples.size() < n; ++i) {
+        samples.push_back(sample(rng, sampleRegime(samples.size())));
+      }
+    }
+
+    const int kRepetitions = 5;
+    std::vector<double> ns_per_op(kNumProperties, 0.);
+    volatile Scalar sink = 0;
+    for (int property = 0; property < kNumProperties && n > 0; ++property) {
+      double best = std::numeric_limits<double>::infinity();
+      for (int r = 0; r < kRepetitions; ++r) {
+        auto start = std::chrono::steady_clock::now();
+        Scalar sum = 0;
+        for (const Sample& s : samples) {
+          sum += evaluate(property, s);
+        }
+        auto stop = std::chrono::steady_clock::now();
+        sink = sink + sum;
+        best = std::min(
+            best, std::chrono::duration<double, std::nano>(stop - start).count());
+      }
+      ns_per_op[property] = best / n;
+    }
+    return ns_per_op;
+  }
+
+  // NaNs are counted as infinite error.
+  static void summarize(std::vector<double>* errors, PropertyStats* stats) {
+    for (double& e : *errors) {
+      if (isnan(e)) {
+        e = std::numeric_limits<double>::infinity();
+      }
+    }
+    stats->max_error = 0;
+    stats->p50_error = 0;
+    stats->p99_error = 0;
+    if (errors->empty()) {
+      return;
+    }
+    stats->max_error = *std::max_element(errors->begin(), errors->end());
+    stats->p50_error = percentile(errors, 0.5);
+    stats->p99_error = percentile(errors, 0.99);
+  }
+
+  static double percentile(std::vector<double>* values, double q) {
+    const std::size_t k =
+        static_cast<std::size_t>(q * static_cast<double>(values->size() - 1));
+    std::nth_element(values->begin(), values->begin() + k, values->end());
+    return (*values)[k];
+  }
+
+  // Rotation groups act on N-dim points, the others on homogeneous points.
+  static Eigen::Matrix<Scalar, N - 1, 1> act(
+      const Transformation& T, const Eigen::Matrix<Scalar, N - 1, 1>& p) {
+    return T.template topLeftCorner<N - 1, N - 1>() * p +
+           T.template topRightCorner<N - 1, 1>();
+  }
+
+  static Eigen::Matrix<Scalar, N, 1> act(const Transformation& T,
+                                         const Eigen::Matrix<Scalar, N, 1>& p) {
+    return T * p;
+  }
+
+  static double normOf(Scalar v) { return std::abs(static_cast<double>(v)); }
+
+  template <class Derived>
+  static double normOf(const Eigen::MatrixBase<Derived>& v) {
+    return static_cast<double>(v.norm());
+  }
+
+  static Scalar firstOf(Scalar v) { return v; }
+
+  template <class Derived>
+  static Scalar firstOf(const Eigen::MatrixBase<Derived>& v) {
+    return v.eval()[0];
+  }
+
+  PropertyTestOptions options_;
+};
+
+/**
+ * \brief Prints table of stats
+ */
+inline void printPropertyStats(const std::vector<PropertyStats>& stats,
+                               std::ostream& os) {
+  std::ios::fmtflags flags = os.flags();
+  os << std::left << std::setw(22) << "property" << std::right
+     << std::setw(12) << "max" << std::setw(12) << "p50" << std::setw(12)
+     << "p99" << std::setw(12) << "ns/op" << std::endl;
+  for (const PropertyStats& s : stats) {
+    os << std::left << std::setw(22) << s.key << std::right
+       << std::scientific << std::setprecision(2) << std::setw(12)
+       << s.max_error << std::setw(12) << s.p50_error << std::setw(12)
+       << s.p99_error << std::fixed << std::setprecision(1) << std::setw(12)
+       << s.ns_per_op << std::endl;
+  }
+  os.flags(flags);
+}
+}  // namespace Sophus
+
+#endif  // SOPHUS_PROPERTY_TESTS_HPP
@@ -0,0 +1,175 @@
+// This file is part of Sophus.
+//
+// Copyright 2016 Hauke Strasdat
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights  to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+
+
+#include <algorithm>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include <sophus/absolute_pose.hpp>
+#include <sophus/ransac.hpp>
+#include "tests.hpp"
+
+namespace Sophus {
+
+// Points in front of a camera with a known pose, their normalized image
+// coordinates, and the same observations with noise and gross outliers.
+class AbsolutePoseTests : public TestCases {
+ public:
+  static const int kNumPoints = 500;
+
+  AbsolutePoseTests() : rng_(7) {
+    Vector6d x;
+    x << 0.3, -0.2, 1.0, 0.4, -0.5, 0.2;
+    T_cw_ = SE3d::exp(x);
+    const SE3d T_wc = T_cw_.inverse();
+    std::uniform_real_distribution<double> uniform(-1, 1);
+    std::uniform_real_distribution<double> depth(2, 10);
+    std::normal_distribution<double> noise(0, 1e-3);
+    for (int i = 0; i < kNumPoints; ++i) {
+      const double z = depth(rng_);
+      const Eigen::Vector3d p_c(uniform(rng_) * z, uniform(rng_) * z, z);
+      const Eigen::Vector3d p_w = T_wc * p_c;
+      points_.insert(points_.end(), p_w.data(), p_w.data() + 3);
+      exact_.push_back(p_c.x() / z);
+      exact_.push_back(p_c.y() / z);
+      // 50% outliers
+      if (i % 2 == 0) {
+        noisy_.push_back(p_c.x() / z + noise(rng_));
+        noisy_.push_back(p_c.y() / z + noise(rng_));
+      } else {
+        noisy_.push_back(uniform(rng_));
+        noisy_.push_back(uniform(rng_));
+      }
+    }
+  }
+
+  bool runAll() {
+    bool passed = p3pTest();
+    passed &= refinementTest();
+    passed &= ransacTest();
+    return passed;
+  }
+
+ private:
+  // The true pose is among the P3P solutions of exact triplets.
+  bool p3pTest() {
+    bool passed = true;
+    for (int k = 0; k + 3 <= 300; k += 3) {
+      Eigen::Vector3d bearings[3];
+      Eigen::Vector3d points[3];
+      for (int i = 0; i < 3; ++i) {
+        bearings[i] =
+            Eigen::Vector3d(exact_[2 * (k + i)], exact_[2 * (k + i) + 1], 1);
+        points[i] = Eigen::Map<const Eigen::Vector3d>(&points_[3 * (k + i)]);
+      }
+      SE3d solutions[4];
+      const int num_solutions = p3p(bearings, points, solutions);
+      double best = std::numeric_limits<double>::infinity();
+      for (int s = 0; s < num_solutions; ++s) {
+        best = std::min(best, (T_cw_.inverse() * solutions[s]).log().norm());
+        for (int i = 0; i < 3; ++i) {
+          const Eigen::Vector3d p_c = solutions[s] * points[i];
+          const double error =
+              (p_c.normalized() - bearings[i].normalized()).norm();
+          if (p_c.z() <= 0 || error > 1e-8) {
+            std::cerr << "P3P solution " << s << " of triplet " << k
+                      << " violates bearing " << i << ": " << error
+                      << std::endl;
+            passed = false;
+          }
+        }
+      }
+      if (best > 1e-8) {
+        std::cerr << "P3P triplet " << k << ": " << num_solutions
+                  << " solution(s), error to truth " << best << std::endl;
+        passed = false;
+      }
+    }
+    return processTestResult(passed, "P3P");
+  }
+
+  // Refinement from a perturbed pose converges to the truth.
+  bool refinementTest() {
+    Vector6d delta;
+    delta << 0.05, -0.03, 0.1, 0.02, 0.04, -0.03;
+    SE3d T = T_cw_ * SE3d::exp(delta);
+    const double cost =
+        refineAbsolutePose(points_.data(), exact_.data(), kNumPoints, &T);
+    const double error = (T_cw_.inverse() * T).log().norm();
+    bool passed = cost < 1e-20 && error < 1e-9;
+    if (!passed) {
+      std::cerr << "Refinement cost " << cost << ", error " << error
+                << std::endl;
+    }
+    return processTestResult(passed, "Refinement");
+  }
+
+  // RANSAC finds the pose and the inliers among gross outliers.
+  bool ransacTest() {
+    const AbsolutePoseProblem problem(points_.data(), noisy_.data(),
+                                      kNumPoints);
+    RansacOptions options;
+    options.max_squared_error = 1e-4;
+    options.num_threads = 2;
+    const RansacResult<SE3d> result = ransac(problem, options);
+    const double error = (T_cw_.inverse() * result.model).log().norm();
+    int num_true_inliers = 0;
+    for (int i : result.inliers) {
+      num_true_inliers += i % 2 == 0;
+    }
+    bool passed = result.success && error < 1e-2 &&
+                  num_true_inliers >= kNumPoints / 2 - 5 &&
+                  result.inliers.size() < kNumPoints / 2 + 20;
+    if (!passed) {
+      std::cerr << "RANSAC error " << error << ", inliers "
+                << result.inliers.size() << " (" << num_true_inliers
+                << " true)" << std::endl;
+    }
+    return processTestResult(passed, "RANSAC");
+  }
+
+  std::mt19937 rng_;
+  SE3d T_cw_;
+  std::vector<double> points_;
+  std::vector<double> exact_;
+  std::vector<double> noisy_;
+};
+
+int test_absolute_pose() {
+  using std::cerr;
+  using std::endl;
+
+  cerr << "Test absolute pose" << endl << endl;
+  AbsolutePoseTests tests;
+  if (!tests.runAll()) {
+    exit(-1);
+  }
+  cerr << endl;
+  return 0;
+}
+}  // namespace Sophus
+
+int main() { return Sophus::test_absolute_pose(); }
@@ -0,0 +1,402 @@
+// This file is part of Sophus.
+//
+// Copyright 2016 Hauke Strasdat
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights  to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+#include <sophus/batch_reprojection.hpp>
+#include "tests.hpp"
+
+namespace Sophus {
+
+template <class Scalar>
+class BatchTests {
+ public:
+  typedef SO3Group<Scalar> SO3Type;
+  typedef SE3Group<Scalar> SE3Type;
+  typedef typename SE3Type::Point Point;
+  typedef typename SE3Type::Tangent Tangent;
+
+  BatchTests() : eps_(10 * SophusConstants<Scalar>::epsilon()) {
+    const Scalar kPi = SophusConstants<Scalar>::pi();
+    // Odd count so that the remainder loops of the vectorized kernels are
+    // exercised as well.
+    const int kNum = 37;
+    for (int i = 0; i < kNum; ++i) {
+      Scalar s = static_cast<Scalar>(i) / kNum;
+      Tangent xi;
+      xi << 10 * s - 3, -2 * s, 5 * s * s, kPi * s, -0.5 * s, 0.2;
+      if (i == 0) {
+        xi.setZero();
+      } else if (i == 1) {
+        xi.template tail<3>() << 0, 0, Scalar(0.00001);
+      } else if (i == 2) {
+        xi.template tail<3>() << kPi, 0, 0;
+      }
+      tangents_.push_back(xi);
+      points_.push_back(Point(s, -3 * s + 1, 7 * s * s));
+    }
+  }
+
+  bool run(CpuIsa isa) {
+    const BatchKernels<Scalar> kernels = BatchKernels<Scalar>::forIsa(isa);
+    const size_t n = tangents_.size();
+    const int kP = SE3Type::num_parameters;
+    const int kQ = SO3Type::num_parameters;
+
+    std::vector<Scalar> xi(6 * n), omega(3 * n), points(3 * n);
+    for (size_t i = 0; i < n; ++i) {
+      Eigen::Map<Tangent> xi_i(&xi[6 * i]);
+      Eigen::Map<Point> omega_i(&omega[3 * i]);
+      Eigen::Map<Point> point_i(&points[3 * i]);
+      xi_i = tangents_[i];
+      omega_i = tangents_[i].template tail<3>();
+      point_i = points_[i];
+    }
+
+    bool passed = true;
+
+    // exp
+    std::vector<Scalar> T(kP * n), R(kQ * n);
+    kernels.se3Exp(xi.data(), T.data(), n);
+    kernels.so3Exp(omega.data(), R.data(), n);
+    for (size_t i = 0; i < n; ++i) {
+      SE3Type expected_T = SE3Type::exp(tangents_[i]);
+      SO3Type expected_R = SO3Type::exp(tangents_[i].template tail<3>());
+      passed &= check("se3Exp", i,
+                      expected_T.matrix() -
+                          Eigen::Map<const SE3Type>(&T[kP * i]).matrix());
+      passed &= check("so3Exp", i,
+                      expected_R.matrix() -
+                          Eigen::Map<const SO3Type>(&R[kQ * i]).matrix());
+    }
+
+    // log
+    std::vector<Scalar> log_T(6 * n), log_R(3 * n);
+    kernels.se3Log(T.data(), log_T.data(), n);
+    kernels.so3Log(R.data(), log_R.data(), n);
+    for (size_t i = 0; i < n; ++i) {
+      passed &= check("se3Log", i,
+                      Eigen::Map<const SE3Type>(&T[kP * i]).log() -
+                          Eigen::Map<const Tangent>(&log_T[6 * i]));
+      passed &= check("so3Log", i,
+                      Eigen::Map<const SO3Type>(&R[kQ * i]).log() -
+                          Eigen::Map<const Point>(&log_R[3 * i]));
+    }
+
+    // compose, pairing element i with element n-1-i
+    std::vector<Scalar> T_rev(kP * n), R_rev(kQ * n);
+    for (size_t i = 0; i < n; ++i) {
+      std::copy(&T[kP * (n - 1 - i)], &T[kP * (n - i)], &T_rev[kP * i]);
+      std::copy(&R[kQ * (n - 1 - i)], &R[kQ * (n - i)], &R_rev[kQ * i]);
+    }
+    std::vector<Scalar> T_prod(kP * n), R_prod(kQ * n);
+    kernels.se3Compose(T.data(), T_rev.data(), T_prod.data(), n);
+    kernels.so3Compose(R.data(), R_rev.data(), R_prod.data(), n);
+    for (size_t i = 0; i < n; ++i) {
+      SE3Type expected_T = Eigen::Map<const SE3Type>(&T[kP * i]) *
+                           SE3Type(Eigen::Map<const SE3Type>(&T_rev[kP * i]));
+      SO3Type expected_R = Eigen::Map<const SO3Type>(&R[kQ * i]) *
+                           SO3Type(Eigen::Map<const SO3Type>(&R_rev[kQ * i]));
+      passed &= check("se3Compose", i,
+                      expected_T.matrix() -
+                          Eigen::Map<const SE3Type>(&T_prod[kP * i]).matrix());
+      passed &= check("so3Compose", i,
+                      expected_R.matrix() -
+                          Eigen::Map<const SO3Type>(&R_prod[kQ * i]).matrix());
+    }
+
+    // integration in split layout, T_rev[i] * exp(dt * xi[i])
+    const Scalar dt = Scalar(0.1);
+    std::vector<Scalar> quaternions(kQ * n), translations(3 * n);
+    for (size_t i = 0; i < n; ++i) {
+      std::copy(&T_rev[kP * i], &T_rev[kP * i] + kQ, &quaternions[kQ * i]);
+      std::copy(&T_rev[kP * i] + kQ, &T_rev[kP * (i + 1)],
+                &translations[3 * i]);
+    }
+    kernels.se3IntegrateSplit(quaternions.data(), translations.data(),
+                              xi.data(), dt, n);
+    for (size_t i = 0; i < n; ++i) {
+      SE3Type expected_T = Eigen::Map<const SE3Type>(&T_rev[kP * i]) *
+                           SE3Type::exp(dt * tangents_[i]);
+      passed &= check("se3IntegrateSplit", i,
+                      expected_T.matrix() -
+                          Eigen::Map<const SE3Type>(&translations[3 * i],
+                                                    &quaternions[kQ * i])
+                              .matrix());
+    }
+
+    // group action
+    std::vector<Scalar> T_points(3 * n), R_points(3 * n);
+    for (size_t j = 0; j < n; ++j) {
+      kernels.se3TransformPoints(&T[kP * j], points.data(), T_points.data(),
+                                 n);
+      kernels.so3TransformPoints(&R[kQ * j], points.data(), R_points.data(),
+                                 n);
+      Eigen::Map<const SE3Type> T_j(&T[kP * j]);
+      Eigen::Map<const SO3Type> R_j(&R[kQ * j]);
+      for (size_t i = 0; i < n; ++i) {
+        passed &= check("se3TransformPoints", j,
+                        T_j * points_[i] -
+                            Eigen::Map<const Point>(&T_points[3 * i]));
+        passed &= check("so3TransformPoints", j,
+                        R_j * points_[i] -
+                            Eigen::Map<const Point>(&R_points[3 * i]));
+      }
+    }
+
+    // first-order perturbed transform, with offsets in [-1, 1]
+    std::vector<Scalar> offsets(n), perturbed_points(3 * n);
+    for (size_t i = 0; i < n; ++i) {
+      offsets[i] = Scalar(2 * i) / Scalar(n) - 1;
+    }
+    for (size_t j = 0; j < n; j += 7) {
+      kernels.se3TransformPointsFirstOrder(&T[kP * j], &xi[6 * ((j + 1) % n)],
+                                           offsets.data(), points.data(),
+                                           perturbed_points.data(), n);
+      Eigen::Map<const SE3Type> T_j(&T[kP * j]);
+      const Tangent& twist = tangents_[(j + 1) % n];
+      for (size_t i = 0; i < n; ++i) {
+        const Point omega = twist.template tail<3>();
+        const Point p = points_[i] + offsets[i] * (omega.cross(points_[i]) +
+                                                   twist.template head<3>());
+        passed &= check("se3TransformPointsFirstOrder", j,
+                        T_j * p -
+                            Eigen::Map<const Point>(&perturbed_points[3 * i]));
+      }
+    }
+
+    // squared errors under several affine maps at once, pairing point i
+    // with point n-1-i
+    const size_t kNumMaps = 5;
+    std::vector<Scalar> maps(12 * kNumMaps), dst(3 * n),
+        errors(kNumMaps * n);
+    for (size_t h = 0; h < kNumMaps; ++h) {
+      typedef Eigen::Matrix<Scalar, 3, 3, Eigen::RowMajor> RowMajorMatrix3;
+      Eigen::Map<RowMajorMatrix3> M(&maps[12 * h]);
+      Eigen::Map<Point> t(&maps[12 * h + 9]);
+      const SE3Type T_h(Eigen::Map<const SE3Type>(&T[kP * (3 * h)]));
+      M = Scalar(h + 1) * T_h.rotationMatrix();
+      t = T_h.translation();
+    }
+    for (size_t i = 0; i < n; ++i) {
+      Eigen::Map<Point> dst_i(&dst[3 * i]);
+      dst_i = points_[n - 1 - i];
+    }
+    kernels.affineSquaredErrors(maps.data(), kNumMaps, points.data(),
+                                dst.data(), errors.data(), n);
+    for (size_t h = 0; h < kNumMaps; ++h) {
+      const SE3Type T_h(Eigen::Map<const SE3Type>(&T[kP * (3 * h)]));
+      for (size_t i = 0; i < n; ++i) {
+        const Point p = Scalar(h + 1) * (T_h.so3() * points_[i]) +
+                        T_h.translation() - points_[n - 1 - i];
+        // relative error, since the squared distances reach a few hundred
+        passed &= check("affineSquaredErrors", i,
+                        Eigen::Matrix<Scalar, 1, 1>(
+                            (p.squaredNorm() - errors[h * n + i]) /
+                            (1 + p.squaredNorm())));
+      }
+    }
+
+    // fixed-point round trip; each quaternion component may be off by one
+    // quantization step, each translation component by half a step
+    const Scalar scales[3] = {Scalar(1 << 12), Scalar(1 << 10),
+                              Scalar(1 << 20)};
+    std::vector<std::int32_t> codes(7 * n);
+    std::vector<Scalar> T_quantized(kP * n);
+    kernels.se3Quantize(T.data(), scales, codes.data(), n);
+    kernels.se3Dequantize(codes.data(), scales, T_quantized.data(), n);
+    for (size_t i = 0; i < n; ++i) {
+      Eigen::Map<const SE3Type> T_i(&T[kP * i]);
+      Eigen::Map<const SE3Type> T_quantized_i(&T_quantized[kP * i]);
+      const Scalar sign =
+          T_i.unit_quaternion().dot(T_quantized_i.unit_quaternion()) < 0
+              ? Scalar(-1)
+              : Scalar(1);
+      const Eigen::Matrix<Scalar, 4, 1> q_error =
+          (T_quantized_i.unit_quaternion().coeffs() -
+           sign * T_i.unit_quaternion().coeffs())
+              .cwiseAbs();
+      const Point t_error =
+          (T_quantized_i.translation() - T_i.translation()).cwiseAbs();
+      passed &= check(
+          "se3Quantize", i,
+          (q_error.array() - 2 / scales[0]).max(Scalar(0)).matrix());
+      passed &= check("se3Quantize", i,
+                      (t_error.array() - Scalar(0.5) / scales[1] - eps_)
+                          .max(Scalar(0))
+                          .matrix());
+    }
+
+    // reprojection, with points in front of each camera
+    const Scalar camera[4] = {Scalar(1.2), Scalar(0.9), Scalar(0.1),
+                              Scalar(-0.2)};
+    std::vector<Scalar> world_points(3 * n), observations(2 * n);
+    std::vector<Scalar> residuals(2 * n), pose_jacobians(12 * n),
+        point_jacobians(6 * n);
+    for (size_t j = 0; j < n; j += 5) {
+      Eigen::Map<const SE3Type> T_j(&T[kP * j]);
+      for (size_t i = 0; i < n; ++i) {
+        Eigen::Map<Point> p_w(&world_points[3 * i]);
+        p_w = T_j.inverse() * (points_[i] + Point(0, 0, 3));
+        observations[2 * i] = points_[i][1];
+        observations[2 * i + 1] = points_[i][0];
+      }
+      kernels.se3Reproject(&T[kP * j], camera, world_points.data(),
+                           observations.data(), residuals.data(),
+                           pose_jacobians.data(), point_jacobians.data(), n);
+      for (size_t i = 0; i < n; ++i) {
+        const Point p_w = Eigen::Map<const Point>(&world_points[3 * i]);
+        const Point p_c = T_j * p_w;
+        Eigen::Matrix<Scalar, 2, 1> expected_residual;
+        expected_residual << camera[0] * p_c[0] / p_c[2] + camera[2] -
+                                 observations[2 * i],
+            camera[1] * p_c[1] / p_c[2] + camera[3] - observations[2 * i + 1];
+        Eigen::Matrix<Scalar, 2, 3> Dpi;
+        Dpi << camera[0] / p_c[2], 0, -camera[0] * p_c[0] / (p_c[2] * p_c[2]),
+            0, camera[1] / p_c[2], -camera[1] * p_c[1] / (p_c[2] * p_c[2]);
+        const Eigen::Matrix<Scalar, 2, 3> expected_point_jacobian =
+            Dpi * T_j.so3().matrix();
+        Eigen::Matrix<Scalar, 3, 6> D_exp;
+        D_exp << Eigen::Matrix<Scalar, 3, 3>::Identity(),
+            -SO3Type::hat(p_w);
+        const Eigen::Matrix<Scalar, 2, 6> expected_pose_jacobian =
+            expected_point_jacobian * D_exp;
+        typedef Eigen::Matrix<Scalar, 2, 6, Eigen::RowMajor> PoseJacobian;
+        typedef Eigen::Matrix<Scalar, 2, 3, Eigen::RowMajor> PointJacobian;
+        passed &= check("se3Reproject residual", i,
+                        expected_residual -
+                            Eigen::Map<const Eigen::Matrix<Scalar, 2, 1> >(
+                                &residuals[2 * i]));
+        passed &= check("se3Reproject pose Jacobian", i,
+                        expected_pose_jacobian -
+                            Eigen::Map<const PoseJacobian>(
+                                &pose_jacobians[12 * i]));
+        passed &= check("se3Reproject point Jacobian", i,
+                        expected_point_jacobian -
+                            Eigen::Map<const PointJacobian>(
+                                &point_jacobians[6 * i]));
+      }
+    }
+
+    // reprojection grouped by pose, against one kernel call per observation
+    const int kNumPoses = 4;
+    std::vector<int> pose_indices, point_indices;
+    std::vector<Scalar> grouped_observations;
+    for (size_t k = 0; k < n; ++k) {
+      pose_indices.push_back(static_cast<int>((3 * k + 1) % kNumPoses));
+      point_indices.push_back(static_cast<int>((5 * k) % n));
+      grouped_observations.push_back(observations[2 * k]);
+      grouped_observations.push_back(observations[2 * k + 1]);
+    }
+    BatchReprojection<Scalar> batch(
+        kNumPoses, pose_indices, point_indices, grouped_observations,
+        typename BatchReprojection<Scalar>::Camera(camera[0], camera[1],
+                                                   camera[2], camera[3]));
+    batch.evaluate(T.data(), world_points.data(), residuals.data(),
+                   pose_jacobians.data(), point_jacobians.data());
+    for (int i = 0; i < kNumPoses; ++i) {
+      for (int s = batch.poseBegin(i); s < batch.poseEnd(i); ++s) {
+        const int k = batch.observationIndex(s);
+        passed &= check("BatchReprojection pose", s,
+                        Eigen::Matrix<Scalar, 1, 1>(
+                            Scalar(pose_indices[k] == i ? 0 : 1)));
+        Eigen::Matrix<Scalar, 20, 1> expected, result;
+        kernels.se3Reproject(&T[kP * i], camera,
+                             &world_points[3 * point_indices[k]],
+                             &grouped_observations[2 * k], expected.data(),
+                             expected.data() + 2, expected.data() + 14, 1);
+        result << Eigen::Map<const Eigen::Matrix<Scalar, 2, 1> >(
+                      &residuals[2 * s]),
+            Eigen::Map<const Eigen::Matrix<Scalar, 12, 1> >(
+                &pose_jacobians[12 * s]),
+            Eigen::Map<const Eigen::Matrix<Scalar, 6, 1> >(
+                &point_jacobians[6 * s]);
+        passed &= check("BatchReprojection", s, expected - result);
+      }
+    }
+
+    // typed front-end
+    SE3Type T0 = SE3Type::exp(tangents_[n - 1]);
+    BatchOps<SE3Type>::transformPoints(T0, points.data(), T_points.data(), n);
+    for (size_t i = 0; i < n; ++i) {
+      passed &= check("BatchOps::transformPoints", i,
+                      T0 * points_[i] -
+                          Eigen::Map<const Point>(&T_points[3 * i]));
+    }
+    return passed;
+  }
+
+ private:
+  template <typename Derived>
+  bool check(const char* name, size_t i,
+             const Eigen::MatrixBase<Derived>& diff) {
+    Scalar nrm = diff.norm();
+    if (isnan(nrm) || nrm > eps_) {
+      std::cerr << name << std::endl;
+      std::cerr << "Test case: " << i << std::endl;
+      std::cerr << diff << std::endl << std::endl;
+      return false;
+    }
+    return true;
+  }
+
+  Scalar eps_;
+  std::vector<Tangent, Eigen::aligned_allocator<Tangent> > tangents_;
+  std::vector<Point, Eigen::aligned_allocator<Point> > points_;
+};
+
+template <class Scalar>
+void tests() {
+  using std::cerr;
+  using std::endl;
+  BatchTests<Scalar> tests;
+  const CpuIsa best = detectCpuFeatures().bestIsa();
+  for (int i = 0; i <= static_cast<int>(best); ++i) {
+    const CpuIsa isa = static_cast<CpuIsa>(i);
+    cerr << "ISA " << cpuIsaName(isa) << ": ";
+    if (!tests.run(isa)) {
+      cerr << "failed!" << endl << endl;
+      exit(-1);
+    }
+    cerr << "passed." << endl;
+  }
+  cerr << "Selected ISA: " << cpuIsaName(BatchKernels<Scalar>::selected().isa)
+       << endl
+       << endl;
+}
+
+int test_batch() {
+  using std::cerr;
+  using std::endl;
+
+  cerr << "Test batch kernels" << endl << endl;
+  cerr << "Double tests: " << endl;
+  tests<double>();
+  cerr << "Float tests: " << endl;
+  tests<float>();
+  return 0;
+}
+}  // namespace Sophus
+
+int main() { return Sophus::test_batch(); }
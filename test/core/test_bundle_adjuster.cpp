@@ -0,0 +1,176 @@
+// This file is part of Sophus.
+//
+// Copyright 2016 Hauke Strasdat
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights  to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+
+#include <iostream>
+#include <vector>
+
+#include <sophus/bundle_adjuster.hpp>
+#include "tests.hpp"
+
+namespace Sophus {
+
+// Synthetic scene: cameras on a circle looking at a cloud of points. The
+// perturbed problem has to converge back to zero cost, with both linear
+// solvers and on one as well as several threads.
+class BundleAdjusterTests {
+ public:
+  typedef SE3Group<double> SE3Type;
+  static const int kNumCameras = 12;
+  static const int kNumPoints = 200;
+
+  BundleAdjusterTests() : camera_(500, 500, 320, 240) {
+    const double kPi = SophusConstants<double>::pi();
+    for (int c = 0; c < kNumCameras; ++c) {
+      const double angle = 0.5 * kPi * c / kNumCameras;
+      // camera centre on a circle of radius 10, looking at the origin
+      const SE3Type T_wc(
+          SO3Group<double>::exp(Eigen::Vector3d(0, -angle, 0)),
+          Eigen::Vector3d(10 * std::sin(angle), 0.3 * c,
+                          -10 * std::cos(angle)));
+      const SE3Type T_cw = T_wc.inverse();
+      poses_.insert(poses_.end(), T_cw.data(),
+                    T_cw.data() + SE3Type::num_parameters);
+    }
+    for (int j = 0; j < kNumPoints; ++j) {
+      const double s = static_cast<double>(j) / kNumPoints;
+      points_.push_back(2 * std::sin(37 * s));
+      points_.push_back(2 * std::cos(53 * s) + 0.3 * 12 / 2);
+      points_.push_back(2 * std::sin(71 * s + 1));
+    }
+    for (int c = 0; c < kNumCameras; ++c) {
+      const Eigen::Map<const SE3Type> T_cw(
+          &poses_[SE3Type::num_parameters * c]);
+      for (int j = 0; j < kNumPoints; ++j) {
+        // every camera sees a contiguous half of the points
+        if ((j + 17 * c) % kNumPoints >= kNumPoints / 2) {
+          continue;
+        }
+        const Eigen::Vector3d p =
+            T_cw * Eigen::Map<const Eigen::Vector3d>(&points_[3 * j]);
+        camera_indices_.push_back(c);
+        point_indices_.push_back(j);
+        observations_.push_back(camera_[0] * p.x() / p.z() + camera_[2]);
+        observations_.push_back(camera_[1] * p.y() / p.z() + camera_[3]);
+      }
+    }
+  }
+
+  bool run(BundleAdjustmentOptions::LinearSolver solver,
+           std::size_t num_threads) {
+    BundleAdjuster adjuster(kNumCameras, kNumPoints, camera_indices_,
+                            point_indices_, observations_, camera_);
+    // fix the gauge: the first two cameras fix rotation, translation and
+    // scale
+    adjuster.setCameraConstant(0);
+    adjuster.setCameraConstant(1);
+
+    std::vector<double> poses = poses_;
+    std::vector<double> points = points_;
+    for (int c = 2; c < kNumCameras; ++c) {
+      Eigen::Map<SE3Type> T_cw(&poses[SE3Type::num_parameters * c]);
+      Eigen::Matrix<double, 6, 1> delta;
+      delta << 0.05 * std::sin(c), 0.05 * std::cos(c), -0.03, 0.01 * c / 10,
+          -0.01, 0.02 * std::sin(3 * c);
+      T_cw = T_cw * SE3Type::exp(delta);
+    }
+    for (int j = 0; j < kNumPoints; ++j) {
+      points[3 * j] += 0.05 * std::sin(5 * j);
+      points[3 * j + 1] -= 0.05 * std::cos(7 * j);
+      points[3 * j + 2] += 0.03;
+    }
+
+    BundleAdjustmentOptions options;
+    options.linear_solver = solver;
+    options.num_threads = num_threads;
+    const BundleAdjustmentSummary summary =
+        adjuster.solve(poses.data(), points.data(), options);
+
+    bool passed = true;
+    if (!(summary.initial_cost > 1) || !(summary.final_cost < 1e-12) ||
+        summary.num_successful_iterations == 0) {
+      std::cerr << "Cost: " << summary.initial_cost << " -> "
+                << summary.final_cost << " in " << summary.num_iterations
+                << " iterations" << std::endl;
+      passed = false;
+    }
+    for (int c = 0; c < kNumCameras; ++c) {
+      const Eigen::Map<const SE3Type> T(&poses[SE3Type::num_parameters * c]);
+      const Eigen::Map<const SE3Type> T_expected(
+          &poses_[SE3Type::num_parameters * c]);
+      passed &= check("Camera", c, (T_expected.inverse() * T).log());
+    }
+    for (int j = 0; j < kNumPoints; ++j) {
+      passed &= check("Point", j,
+                      Eigen::Map<const Eigen::Vector3d>(&points[3 * j]) -
+                          Eigen::Map<const Eigen::Vector3d>(&points_[3 * j]));
+    }
+    return passed;
+  }
+
+ private:
+  template <typename Derived>
+  bool check(const char* name, int i, const Eigen::MatrixBase<Derived>& diff) {
+    const double nrm = diff.norm();
+    if (isnan(nrm) || nrm > 1e-6) {
+      std::cerr << name << std::endl;
+      std::cerr << "Test case: " << i << std::endl;
+      std::cerr << diff.transpose() << std::endl << std::endl;
+      return false;
+    }
+    return true;
+  }
+
+  BundleAdjuster::Camera camera_;
+  std::vector<double> poses_;
+  std::vector<double> points_;
+  std::vector<int> camera_indices_;
+  std::vector<int> point_indices_;
+  std::vector<double> observations_;
+};
+
+int test_bundle_adjuster() {
+  using std::cerr;
+  using std::endl;
+
+  cerr << "Test bundle adjuster" << endl << endl;
+  BundleAdjusterTests tests;
+  const BundleAdjustmentOptions::LinearSolver solvers[] = {
+      BundleAdjustmentOptions::SparseCholesky,
+      BundleAdjustmentOptions::ConjugateGradients};
+  const char* names[] = {"Sparse Cholesky", "Conjugate gradients"};
+  for (int i = 0; i < 2; ++i) {
+    for (std::size_t num_threads = 1; num_threads <= 4; num_threads += 3) {
+      cerr << names[i] << ", " << num_threads << " thread(s): ";
+      if (!tests.run(solvers[i], num_threads)) {
+        cerr << "failed!" << endl << endl;
+        exit(-1);
+      }
+      cerr << "passed." << endl;
+    }
+  }
+  cerr << endl;
+  return 0;
+}
+}  // namespace Sophus
+
+int main() { return Sophus::test_bundle_adjuster(); }
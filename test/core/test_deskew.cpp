@@ -0,0 +1,213 @@
+// This file is part of Sophus.
+//
+// Copyright 2016 Hauke Strasdat
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights  to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+
+
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include <sophus/deskew.hpp>
+#include "tests.hpp"
+
+namespace Sophus {
+
+// A sweep of points with uniform timestamps, deskewed against the exact
+// constant velocity motion T_start * exp(s * xi) between two poses.
+class DeskewTests : public TestCases {
+ public:
+  typedef SE3Group<double> SE3d;
+  typedef SE3d::Tangent Tangent;
+  static const int kNumPoints = 20000;
+  static constexpr double kRange = 30.0;
+
+  DeskewTests() : t_start_(10.0), t_end_(10.1) {
+    T_start_ = SE3d::exp((Tangent() << 1.0, -2.0, 0.5, 0.1, 0.2, -0.3)
+                             .finished());
+    // 10 m/s and 180 deg/s, a fast moving vehicle
+    xi_ << 1.0, 0.1, 0.02, 0.05, 0.03, 0.31;
+    T_end_ = T_start_ * SE3d::exp(xi_);
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<double> uniform(-1, 1);
+    std::uniform_real_distribution<double> time(t_start_, t_end_);
+    for (int i = 0; i < kNumPoints; ++i) {
+      Eigen::Vector3d p(uniform(rng), uniform(rng), 0.2 * uniform(rng));
+      p *= kRange / p.norm() * (0.1 + 0.9 * std::abs(uniform(rng)));
+      points_.insert(points_.end(), p.data(), p.data() + 3);
+      timestamps_.push_back(time(rng));
+    }
+  }
+
+  void runAll() {
+    bool passed = testZeroOrder();
+    processTestResult(passed, "zero order");
+    passed = testFirstOrder();
+    processTestResult(passed, "first order");
+    passed = testThreads();
+    processTestResult(passed, "threads");
+    passed = testMotion();
+    processTestResult(passed, "motion model");
+    passed = testReferencePose();
+    processTestResult(passed, "reference pose");
+  }
+
+ private:
+  DeskewOptions options(bool first_order, std::size_t num_threads) const {
+    DeskewOptions options;
+    options.num_slices = 16;
+    options.first_order = first_order;
+    options.num_threads = num_threads;
+    return options;
+  }
+
+  // Largest distance to the exact T_ref^-1 * T(t_i) * p_i.
+  double error(const std::vector<double>& out, const SE3d& T_ref) const {
+    const SE3d T_ref_inverse = T_ref.inverse();
+    double max_error = 0;
+    for (int i = 0; i < kNumPoints; ++i) {
+      const double s = (timestamps_[i] - t_start_) / (t_end_ - t_start_);
+      const Eigen::Map<const Eigen::Vector3d> p(&points_[3 * i]);
+      const Eigen::Map<const Eigen::Vector3d> q(&out[3 * i]);
+      const Eigen::Vector3d expected =
+          T_ref_inverse * T_start_ * SE3d::exp(s * xi_) * p;
+      max_error = std::max(max_error, (q - expected).norm());
+    }
+    return max_error;
+  }
+
+  bool check(bool first_order, double* max_error) {
+    SweepDeskewer<double> deskewer(t_start_, t_end_, T_start_, T_end_,
+                                   options(first_order, 1));
+    std::vector<double> out(3 * kNumPoints);
+    deskewer.deskew(points_.data(), timestamps_.data(), kNumPoints,
+                    out.data());
+    *max_error = error(out, T_end_);
+    const double bound = deskewer.maxError(kRange);
+    // the bound is to leading order only
+    const bool passed = *max_error <= 1.1 * bound;
+    if (!passed) {
+      std::cerr << "Error " << *max_error << " exceeds bound " << bound
+                << std::endl;
+    }
+    return passed;
+  }
+
+  bool testZeroOrder() {
+    double max_error;
+    return check(false, &max_error) && max_error > 1e-3;
+  }
+
+  bool testFirstOrder() {
+    double zero_order_error, first_order_error;
+    bool passed = check(false, &zero_order_error);
+    passed &= check(true, &first_order_error);
+    passed &= first_order_error < 0.1 * zero_order_error;
+    if (!passed) {
+      std::cerr << "First order " << first_order_error << ", zero order "
+                << zero_order_error << std::endl;
+    }
+    return passed;
+  }
+
+  bool testThreads() {
+    bool passed = true;
+    for (int first_order = 0; first_order < 2; ++first_order) {
+      std::vector<double> out1(3 * kNumPoints), out4(3 * kNumPoints);
+      SweepDeskewer<double> deskewer1(t_start_, t_end_, T_start_, T_end_,
+                                      options(first_order == 1, 1));
+      SweepDeskewer<double> deskewer4(t_start_, t_end_, T_start_, T_end_,
+                                      options(first_order == 1, 4));
+      // the second call reuses the scratch buffers
+      for (int call = 0; call < 2; ++call) {
+        deskewer1.deskew(points_.data(), timestamps_.data(), kNumPoints,
+                         out1.data());
+        deskewer4.deskew(points_.data(), timestamps_.data(), kNumPoints,
+                         out4.data());
+        passed &= out1 == out4;
+      }
+    }
+    return passed;
+  }
+
+  bool testMotion() {
+    // constant velocity as a motion model gives the same slices
+    const SE3d T_start = T_start_;
+    const Tangent xi = xi_;
+    const double t_start = t_start_;
+    const double duration = t_end_ - t_start_;
+    const auto motion = [&](double t) {
+      return T_start * SE3d::exp((t - t_start) / duration * xi);
+    };
+    bool passed = true;
+    for (int first_order = 0; first_order < 2; ++first_order) {
+      SweepDeskewer<double> deskewer(t_start_, t_end_, T_start_, T_end_,
+                                     options(first_order == 1, 1));
+      SweepDeskewer<double> sampled(t_start_, t_end_, motion,
+                                    options(first_order == 1, 1));
+      std::vector<double> out(3 * kNumPoints), out_sampled(3 * kNumPoints);
+      deskewer.deskew(points_.data(), timestamps_.data(), kNumPoints,
+                      out.data());
+      sampled.deskew(points_.data(), timestamps_.data(), kNumPoints,
+                     out_sampled.data());
+      for (int i = 0; i < 3 * kNumPoints; ++i) {
+        passed &= std::abs(out[i] - out_sampled[i]) < 1e-9;
+      }
+    }
+    return passed;
+  }
+
+  bool testReferencePose() {
+    // the identity reference gives world points
+    SweepDeskewer<double> deskewer(t_start_, t_end_, T_start_, T_end_,
+                                   options(true, 1));
+    deskewer.setReferencePose(SE3d());
+    std::vector<double> out(3 * kNumPoints);
+    deskewer.deskew(points_.data(), timestamps_.data(), kNumPoints,
+                    out.data());
+    return error(out, SE3d()) <= 1.1 * deskewer.maxError(kRange);
+  }
+
+  double t_start_;
+  double t_end_;
+  SE3d T_start_;
+  SE3d T_end_;
+  Tangent xi_;
+  std::vector<double> points_;
+  std::vector<double> timestamps_;
+};
+
+int test_deskew() {
+  using std::cerr;
+  using std::endl;
+
+  cerr << "Test sweep deskewing" << endl << endl;
+  DeskewTests tests;
+  tests.runAll();
+  if (!tests.passed()) {
+    exit(-1);
+  }
+  cerr << endl;
+  return 0;
+}
+}  // namespace Sophus
+
+int main() { return Sophus::test_deskew(); }
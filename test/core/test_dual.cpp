@@ -0,0 +1,298 @@
+// This file is part of Sophus.
+//
+// Copyright 2016 Hauke Strasdat
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights  to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include <iostream>
+#include <vector>
+
+#include <sophus/dual.hpp>
+#include <sophus/generated/rxso3_kernels.hpp>
+#include <sophus/generated/se2_kernels.hpp>
+#include <sophus/generated/se3_kernels.hpp>
+#include <sophus/generated/sim3_kernels.hpp>
+#include <sophus/generated/so3_kernels.hpp>
+#include <sophus/rxso3.hpp>
+#include <sophus/se2.hpp>
+#include <sophus/se3.hpp>
+#include <sophus/sim3.hpp>
+#include <sophus/so2.hpp>
+#include <sophus/so3.hpp>
+#include "tests.hpp"
+
+// All groups need to compile with Dual scalars.
+namespace Sophus {
+template class SO2Group<Dual<double, 1> >;
+template class SE2Group<Dual<double, 3> >;
+template class SO3Group<Dual<double, 3> >;
+template class SE3Group<Dual<double, 6> >;
+template class RxSO3Group<Dual<double, 4> >;
+template class Sim3Group<Dual<double, 7> >;
+template class SE3Group<Dual<float, 6> >;
+}  // namespace Sophus
+
+namespace Sophus {
+
+bool checkClose(const char* what, const Eigen::MatrixXd& result,
+                const Eigen::MatrixXd& reference, double tolerance) {
+  const double error = (result - reference).lpNorm<Eigen::Infinity>();
+  if (error <= tolerance * std::max(1.0, reference.lpNorm<Eigen::Infinity>())) {
+    return true;
+  }
+  std::cerr << what << " mismatch, result:" << std::endl
+            << result << std::endl
+            << "reference:" << std::endl
+            << reference << std::endl;
+  return false;
+}
+
+// Derivatives of the elementary functions against central differences.
+bool testFunctions() {
+  typedef Dual<double, 2> D;
+  bool passed = true;
+  const double h = 1e-6;
+  for (double x : {-0.7, 0.3, 0.9}) {
+    const D dx(x, 0);
+    const D dy(0.4, 1);
+    struct {
+      const char* name;
+      D dual;
+      double (*f)(double);
+    } unary[] = {
+        {"abs", abs(dx), [](double a) { return std::abs(a); }},
+        {"sin", sin(dx), [](double a) { return std::sin(a); }},
+        {"cos", cos(dx), [](double a) { return std::cos(a); }},
+        {"tan", tan(dx), [](double a) { return std::tan(a); }},
+        {"asin", asin(dx), [](double a) { return std::asin(a); }},
+        {"acos", acos(dx), [](double a) { return std::acos(a); }},
+        {"atan", atan(dx), [](double a) { return std::atan(a); }},
+        {"exp", exp(dx), [](double a) { return std::exp(a); }},
+        {"sqrt", sqrt(dx * dx), [](double a) { return std::sqrt(a * a); }},
+        {"log", log(dx * dx), [](double a) { return std::log(a * a); }},
+        {"div", 2.0 / dx, [](double a) { return 2.0 / a; }},
+        {"pow", pow(dx * dx, 1.5),
+         [](double a) { return std::pow(a * a, 1.5); }},
+    };
+    for (const auto& u : unary) {
+      Eigen::Vector2d numeric((u.f(x + h) - u.f(x - h)) / (2 * h), 0.0);
+      Eigen::Vector2d value(u.dual.a, 0.0);
+      passed &= checkClose(u.name, value, Eigen::Vector2d(u.f(x), 0.0), 1e-14);
+      passed &= checkClose(u.name, u.dual.v, numeric, 1e-8);
+    }
+
+    const D q = dx / dy;
+    passed &= checkClose("quotient", q.v, Eigen::Vector2d(1 / 0.4,
+                                                          -x / (0.4 * 0.4)),
+                         1e-14);
+    const D a = atan2(dy, dx);
+    const double sq_norm = x * x + 0.4 * 0.4;
+    passed &= checkClose("atan2", a.v,
+                         Eigen::Vector2d(-0.4 / sq_norm, x / sq_norm), 1e-14);
+    const D p = pow(dx * dx, dy);
+    const double p_ref = std::pow(x * x, 0.4);
+    passed &= checkClose(
+        "pow", p.v,
+        Eigen::Vector2d(0.4 * p_ref / (x * x) * 2 * x, p_ref * std::log(x * x)),
+        1e-12);
+  }
+  return passed;
+}
+
+// Jacobian of exp via Dual against the generated closed form.
+template <template <class> class Group, template <class> class Kernels>
+bool testExpJacobian(const char* name) {
+  typedef Kernels<double> K;
+  typedef Dual<double, K::DoF> D;
+  typedef typename Group<D>::Tangent DualTangent;
+  typedef Eigen::Matrix<D, K::num_parameters, 1> DualParameters;
+  bool passed = true;
+  // Not close to epsilon, where the hand-written SE3 and Sim3 exp lose
+  // precision in (1 - cos(theta)) / theta^2 and similar terms.
+  for (double s : {0.0, 1e-4, 0.1, 0.7}) {
+    typename K::Tangent x;
+    for (int i = 0; i < K::DoF; ++i) {
+      x[i] = s * (1.0 + 0.3 * i) * (i % 2 == 0 ? 1 : -1);
+    }
+    const DualTangent dual_x = dualVariables(x);
+    const Group<D> T = Group<D>::exp(dual_x);
+    const DualParameters params = Eigen::Map<const DualParameters>(T.data());
+    passed &= checkClose(name, dualJacobian(params), K::Dx_exp(x), 1e-9);
+  }
+  return passed;
+}
+
+// exp and log of SO3, SE3 and Sim3 apply the closed-form Jacobian to the
+// derivative lanes. Checks this for lanes which are not unit vectors, i.e.
+// x = x0 + u * du + v * dv, and that log(exp(x)) = x holds for the lanes.
+template <template <class> class Group, template <class> class Kernels>
+bool testChainRule(const char* name) {
+  typedef Kernels<double> K;
+  typedef Dual<double, 2> D;
+  typedef typename Group<D>::Tangent DualTangent;
+  typedef Eigen::Matrix<D, K::num_parameters, 1> DualParameters;
+  bool passed = true;
+  for (double s : {0.0, 1e-9, 0.1, 0.7}) {
+    typename K::Tangent x, du, dv;
+    DualTangent dual_x;
+    for (int i = 0; i < K::DoF; ++i) {
+      x[i] = s * (1.0 + 0.3 * i) * (i % 2 == 0 ? 1 : -1);
+      du[i] = 0.5 + i;
+      dv[i] = 1.0 - 0.2 * i;
+      dual_x[i] = D(x[i], Eigen::Vector2d(du[i], dv[i]));
+    }
+    Eigen::Matrix<double, K::DoF, 2> dx;
+    dx << du, dv;
+
+    const Group<D> T = Group<D>::exp(dual_x);
+    const DualParameters params = Eigen::Map<const DualParameters>(T.data());
+    passed &= checkClose(name, dualValue(params),
+                         Eigen::Map<const typename K::Parameters>(
+                             Group<double>::exp(x).data()),
+                         1e-15);
+    passed &= checkClose(name, dualJacobian(params), K::Dx_exp(x) * dx, 1e-12);
+    passed &=
+        checkClose(name, dualJacobian(Group<D>::log(T)), dx, 1e-8);
+  }
+  return passed;
+}
+
+// Jacobian of log and of the action against central differences.
+template <template <class> class Group>
+bool testLogAndAction(const char* name,
+                      const typename Group<double>::Tangent& x) {
+  typedef Group<double> G;
+  static const int num_parameters = G::num_parameters;
+  static const int DoF = G::DoF;
+  typedef Dual<double, num_parameters> D;
+  typedef Eigen::Matrix<double, num_parameters, 1> Parameters;
+  typedef Eigen::Matrix<D, num_parameters, 1> DualParameters;
+  typedef Group<D> DualGroup;
+  bool passed = true;
+
+  const G T = G::exp(x);
+  const Parameters p = Eigen::Map<const Parameters>(T.data());
+  DualGroup dual_T;
+  Eigen::Map<DualParameters>(dual_T.data()) = dualVariables(p);
+
+  // log is defined for non-normalized parameters as well, hence it can be
+  // differentiated with respect to all parameters.
+  Eigen::Matrix<double, DoF, num_parameters> numeric;
+  const double h = 1e-6;
+  for (int i = 0; i < num_parameters; ++i) {
+    Parameters e = Parameters::Zero();
+    e[i] = h;
+    G plus, minus;
+    Eigen::Map<Parameters>(plus.data()) = p + e;
+    Eigen::Map<Parameters>(minus.data()) = p - e;
+    numeric.col(i) = (G::log(plus) - G::log(minus)) / (2 * h);
+  }
+  passed &= checkClose(name, dualJacobian(DualGroup::log(dual_T)), numeric,
+                       1e-6);
+
+  typedef typename DualGroup::Point DualPoint;
+  typedef typename G::Point Point;
+  const Point point = Point::Constant(0.5);
+  const DualPoint dual_point = point.template cast<D>();
+  const DualPoint transformed = dual_T * dual_point;
+  passed &= checkClose(name, dualValue(transformed), T * point, 1e-14);
+  return passed;
+}
+
+// Jacobian of SO3 log at exactly theta = pi, i.e. w = 0, where the closed
+// form of 2 atan(n / w) / n and its derivatives is inf * 0. log maps w = 0 to
+// -pi, hence the derivative with respect to w is the one from below.
+bool testLogAtPi() {
+  typedef SO3Group<double> G;
+  typedef Dual<double, 4> D;
+  typedef Eigen::Matrix<double, 4, 1> Parameters;
+  typedef Eigen::Matrix<D, 4, 1> DualParameters;
+  bool passed = true;
+
+  const Parameters p(0.0, 1.0, 0.0, 0.0);
+  SO3Group<D> dual_T;
+  Eigen::Map<DualParameters>(dual_T.data()) = dualVariables(p);
+  const Eigen::Matrix<double, 3, 4> J = dualJacobian(SO3Group<D>::log(dual_T));
+  if (!J.allFinite()) {
+    std::cerr << "SO3 log at pi not finite:" << std::endl << J << std::endl;
+    return false;
+  }
+
+  Eigen::Matrix<double, 3, 4> numeric;
+  const double h = 1e-7;
+  for (int i = 0; i < 4; ++i) {
+    Parameters e = Parameters::Zero();
+    e[i] = h;
+    G plus, minus;
+    Eigen::Map<Parameters>(plus.data()) = i == 3 ? p : Parameters(p + e);
+    Eigen::Map<Parameters>(minus.data()) = p - e;
+    numeric.col(i) = (G::log(plus) - G::log(minus)) / (i == 3 ? h : 2 * h);
+  }
+  passed &= checkClose("SO3 log at pi", J, numeric, 1e-6);
+
+  // Group constructed from a quaternion with constant lanes.
+  typedef Dual<double, 3> D3;
+  const SO3Group<D3> R(Eigen::Quaternion<D3>(D3(0.0), D3(1.0), D3(0.0),
+                                             D3(0.0)));
+  const SO3Group<D3>::Tangent omega = SO3Group<D3>::log(R);
+  passed &= checkClose("SO3 log at pi", dualValue(omega),
+                       G::log(G(Eigen::Quaterniond(0, 1, 0, 0))), 1e-15);
+  passed &= checkClose("SO3 log at pi", dualJacobian(omega),
+                       Eigen::Matrix3d::Zero(), 0.0);
+  return passed;
+}
+
+int test_dual() {
+  using std::cerr;
+  using std::endl;
+
+  cerr << "Test Dual" << endl << endl;
+  bool passed = testFunctions();
+  passed &= testExpJacobian<SE2Group, generated::SE2Kernels>("SE2 exp");
+  passed &= testExpJacobian<SO3Group, generated::SO3Kernels>("SO3 exp");
+  passed &= testExpJacobian<SE3Group, generated::SE3Kernels>("SE3 exp");
+  passed &= testExpJacobian<RxSO3Group, generated::RxSO3Kernels>("RxSO3 exp");
+  passed &= testExpJacobian<Sim3Group, generated::Sim3Kernels>("Sim3 exp");
+  passed &= testChainRule<SO3Group, generated::SO3Kernels>("SO3 chain rule");
+  passed &= testChainRule<SE3Group, generated::SE3Kernels>("SE3 chain rule");
+  passed &= testChainRule<Sim3Group, generated::Sim3Kernels>("Sim3 chain rule");
+  passed &= testLogAndAction<SE2Group>(
+      "SE2 log", SE2Group<double>::Tangent(0.5, -1, 0.3));
+  passed &= testLogAndAction<SO3Group>(
+      "SO3 log", SO3Group<double>::Tangent(0.5, -1, 0.3));
+  SE3Group<double>::Tangent se3_x;
+  se3_x << 1, 2, 3, 0.5, -1, 0.3;
+  passed &= testLogAndAction<SE3Group>("SE3 log", se3_x);
+  RxSO3Group<double>::Tangent rxso3_x(0.5, -1, 0.3, 0.2);
+  passed &= testLogAndAction<RxSO3Group>("RxSO3 log", rxso3_x);
+  Sim3Group<double>::Tangent sim3_x;
+  sim3_x << 1, 2, 3, 0.5, -1, 0.3, 0.2;
+  passed &= testLogAndAction<Sim3Group>("Sim3 log", sim3_x);
+  passed &= testLogAtPi();
+
+  if (!passed) {
+    cerr << "failed!" << endl << endl;
+    return -1;
+  }
+  cerr << "passed." << endl << endl;
+  return 0;
+}
+}  // namespace Sophus
+
+int main() { return Sophus::test_dual(); }
@@ -0,0 +1,190 @@
+// This file is part of Sophus.
+//
+// Copyright 2016 Hauke Strasdat
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights  to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+
+
+#include <atomic>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include <sophus/frame_graph.hpp>
+#include "tests.hpp"
+
+namespace Sophus {
+
+// map -> odom -> base -> {lidar, camera}, checked against the explicitly
+// composed chains.
+class FrameGraphTests : public TestCases {
+ public:
+  typedef SE3Group<double> SE3d;
+  typedef SE3d::Tangent Tangent;
+
+  FrameGraphTests() {
+    T_map_odom_ = pose(0.5, -1.0, 0.2, 0.0, 0.0, 0.3);
+    T_odom_base_ = pose(10.0, 3.0, 0.0, 0.01, -0.02, 1.2);
+    T_base_lidar_ = pose(0.3, 0.0, 1.5, 0.0, 0.1, 0.0);
+    T_base_camera_ = pose(0.5, 0.1, 1.2, -1.5, 0.0, -1.5);
+    odom_ = graph_.addFrame("odom", 0, T_map_odom_);
+    base_ = graph_.addFrame("base", odom_, T_odom_base_);
+    lidar_ = graph_.addFrame("lidar", base_, T_base_lidar_);
+    camera_ = graph_.addFrame("camera", base_, T_base_camera_);
+  }
+
+  void runAll() {
+    bool passed = testLookup();
+    processTestResult(passed, "lookup");
+    passed = testInvalidation();
+    processTestResult(passed, "invalidation");
+    passed = testTransformPoints();
+    processTestResult(passed, "transformPoints");
+    passed = testConcurrency();
+    processTestResult(passed, "concurrency");
+  }
+
+ private:
+  static SE3d pose(double x, double y, double z, double rx, double ry,
+                   double rz) {
+    return SE3d::exp((Tangent() << x, y, z, rx, ry, rz).finished());
+  }
+
+  static bool near(const SE3d& a, const SE3d& b) {
+    return (a.matrix() - b.matrix()).norm() < 1e-10;
+  }
+
+  bool checkAll() const {
+    const SE3d T_map_base = T_map_odom_ * T_odom_base_;
+    bool passed = near(graph_.lookup(0, lidar_), T_map_base * T_base_lidar_);
+    passed &= near(graph_.lookup(camera_, lidar_),
+                   T_base_camera_.inverse() * T_base_lidar_);
+    passed &= near(graph_.lookup(odom_, camera_),
+                   T_odom_base_ * T_base_camera_);
+    passed &= near(graph_.lookup(lidar_, 0),
+                   (T_map_base * T_base_lidar_).inverse());
+    passed &= near(graph_.lookup(base_, base_), SE3d());
+    return passed;
+  }
+
+  bool testLookup() {
+    bool passed = checkAll();
+    passed &= graph_.numFrames() == 5;
+    passed &= graph_.frameId("lidar") == lidar_;
+    passed &= graph_.frameId("unknown") == -1;
+    passed &= graph_.name(0) == "map";
+    passed &= graph_.parent(camera_) == base_;
+    passed &= near(graph_.lookup("camera", "map"),
+                   graph_.lookup(camera_, 0));
+    return passed;
+  }
+
+  bool testInvalidation() {
+    // edges near the root and near the leaves, both of which must reach
+    // all descendants
+    bool passed = true;
+    for (int i = 0; i < 5; ++i) {
+      T_map_odom_ = pose(0.1 * i, 0.0, 0.0, 0.0, 0.0, 0.2 * i);
+      graph_.setTransform(odom_, T_map_odom_);
+      passed &= checkAll();
+      T_base_lidar_ = pose(0.3, 0.01 * i, 1.5, 0.0, 0.1, 0.05 * i);
+      graph_.setTransform(lidar_, T_base_lidar_);
+      passed &= checkAll();
+    }
+    return passed;
+  }
+
+  bool testTransformPoints() {
+    const int n = 1000;
+    std::vector<double> in(3 * n), out(3 * n);
+    for (int i = 0; i < 3 * n; ++i) {
+      in[i] = 0.01 * i - 5.0;
+    }
+    graph_.transformPoints(camera_, lidar_, in.data(), out.data(), n);
+    const SE3d T_camera_lidar = T_base_camera_.inverse() * T_base_lidar_;
+    bool passed = true;
+    for (int i = 0; i < n; ++i) {
+      const Eigen::Map<const Eigen::Vector3d> p(&in[3 * i]);
+      const Eigen::Map<const Eigen::Vector3d> q(&out[3 * i]);
+      passed &= (q - T_camera_lidar * p).norm() < 1e-10;
+    }
+    return passed;
+  }
+
+  // A writer alternates the odom edge between two poses while readers
+  // query; every result must be consistent with one of them.
+  bool testConcurrency() {
+    const SE3d T_a = pose(1.0, 2.0, 3.0, 0.1, 0.2, 0.3);
+    const SE3d T_b = pose(-4.0, 5.0, -6.0, -1.0, 0.5, 2.0);
+    const SE3d T_odom_lidar = graph_.lookup(odom_, lidar_);
+    const SE3d expected_a = T_a * T_odom_lidar;
+    const SE3d expected_b = T_b * T_odom_lidar;
+    graph_.setTransform(odom_, T_b);
+    std::atomic<bool> done(false);
+    std::atomic<int> failures(0);
+    auto reader = [&]() {
+      while (!done.load()) {
+        const SE3d T = graph_.lookup(0, lidar_);
+        if (!near(T, expected_a) && !near(T, expected_b)) {
+          ++failures;
+        }
+      }
+    };
+    std::vector<std::thread> readers;
+    for (int i = 0; i < 3; ++i) {
+      readers.emplace_back(reader);
+    }
+    for (int i = 0; i < 20000; ++i) {
+      graph_.setTransform(odom_, i % 2 == 0 ? T_a : T_b);
+    }
+    done = true;
+    for (std::thread& thread : readers) {
+      thread.join();
+    }
+    return failures == 0 && near(graph_.lookup(0, lidar_), expected_b);
+  }
+
+  FrameGraph<double> graph_;
+  int odom_;
+  int base_;
+  int lidar_;
+  int camera_;
+  SE3d T_map_odom_;
+  SE3d T_odom_base_;
+  SE3d T_base_lidar_;
+  SE3d T_base_camera_;
+};
+
+int test_frame_graph() {
+  using std::cerr;
+  using std::endl;
+
+  cerr << "Test frame graph" << endl << endl;
+  FrameGraphTests tests;
+  tests.runAll();
+  if (!tests.passed()) {
+    exit(-1);
+  }
+  cerr << endl;
+  return 0;
+}
+}  // namespace Sophus
+
+int main() { return Sophus::test_frame_graph(); }
@@ -0,0 +1,189 @@
+// This file is part of Sophus.
+//
+// Copyright 2016 Hauke Strasdat
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights  to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <sophus/generated/rxso3_kernels.hpp>
+#include <sophus/generated/se2_kernels.hpp>
+#include <sophus/generated/se3_kernels.hpp>
+#include <sophus/generated/sim3_kernels.hpp>
+#include <sophus/generated/so2_kernels.hpp>
+#include <sophus/generated/so3_kernels.hpp>
+#include <sophus/rxso3.hpp>
+#include <sophus/se2.hpp>
+#include <sophus/se3.hpp>
+#include <sophus/sim3.hpp>
+#include <sophus/so2.hpp>
+#include <sophus/so3.hpp>
+#include "tests.hpp"
+
+namespace Sophus {
+
+/**
+ * Compares the generated kernels of a group against the hand-written
+ * implementation (exp, log, Adj) and against numerical differentiation of
+ * the hand-written implementation (internalJacobian, Dx_exp) and of the
+ * generated log (Dx_log).
+ */
+template <template <class> class Group, template <class> class Kernels>
+class GeneratedTests {
+ public:
+  typedef Group<double> G;
+  typedef Kernels<double> K;
+  typedef Kernels<float> Kf;
+  static const int DoF = K::DoF;
+  static const int num_parameters = K::num_parameters;
+  typedef typename K::Tangent Tangent;
+  typedef typename K::Parameters Parameters;
+  typedef typename K::ParameterJacobian ParameterJacobian;
+
+  explicit GeneratedTests(const std::string& name) : name_(name) {
+    // Exact zero, tangents around the thresholds of the Taylor expansions
+    // and random ones.
+    tangent_vec_.push_back(Tangent::Zero());
+    for (double magnitude : {1e-12, 1e-8, 1e-5, 1e-3, 0.01, 0.05, 0.1, 0.2,
+                             0.3, 0.5, 0.8}) {
+      for (int i = 0; i < DoF; ++i) {
+        Tangent x = Tangent::Zero();
+        x[i] = magnitude;
+        tangent_vec_.push_back(x);
+        tangent_vec_.push_back(-x);
+      }
+      tangent_vec_.push_back(Tangent::Constant(magnitude));
+    }
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<double> uniform(-1.5, 1.5);
+    for (int i = 0; i < 200; ++i) {
+      Tangent x;
+      for (int j = 0; j < DoF; ++j) {
+        x[j] = uniform(rng);
+      }
+      tangent_vec_.push_back(x);
+    }
+  }
+
+  bool run() {
+    bool passed = true;
+    for (const Tangent& x : tangent_vec_) {
+      const G T = exp(x);
+      const Parameters p = parameters(T);
+
+      passed &= check("exp", x, K::exp(x), p, 1e-10);
+      passed &= check("float exp", x,
+                      Kf::exp(x.template cast<float>()).template cast<double>(),
+                      p, 1e-5);
+      passed &= check("log", x, K::log(p), Tangent(G::log(T)), 1e-9);
+      passed &= check("Adj", x, K::Adj(p), typename K::Adjoint(T.Adj()), 1e-10);
+
+      ParameterJacobian num_internal;
+      ParameterJacobian num_dx_exp;
+      // Not smaller, since e.g. SE2Group::exp evaluates (1 - cos(h)) / h
+      // without expansion for h > epsilon.
+      const double h = 1e-4;
+      for (int i = 0; i < DoF; ++i) {
+        Tangent e = Tangent::Zero();
+        e[i] = h;
+        num_internal.col(i) =
+            (parameters(T * exp(e)) - parameters(T * exp(-e))) / (2 * h);
+        num_dx_exp.col(i) =
+            (parameters(exp(x + e)) - parameters(exp(x - e))) / (2 * h);
+      }
+      passed &= check("internalJacobian", x, K::internalJacobian(p),
+                      num_internal, 1e-6);
+      passed &= check("Dx_exp", x, K::Dx_exp(x), num_dx_exp, 1e-6);
+
+      // log is defined for non-normalized parameters as well.
+      typename K::LogJacobian num_dx_log;
+      for (int i = 0; i < num_parameters; ++i) {
+        Parameters e = Parameters::Zero();
+        e[i] = h;
+        num_dx_log.col(i) = (K::log(p + e) - K::log(p - e)) / (2 * h);
+      }
+      passed &= check("Dx_log", x, K::Dx_log(p), num_dx_log, 1e-6);
+    }
+    return passed;
+  }
+
+ private:
+  // SO2 uses a scalar tangent type.
+  static double groupTangent(const Eigen::Matrix<double, 1, 1>& x) {
+    return x[0];
+  }
+
+  template <int D>
+  static Eigen::Matrix<double, D, 1> groupTangent(
+      const Eigen::Matrix<double, D, 1>& x) {
+    return x;
+  }
+
+  static G exp(const Tangent& x) { return G::exp(groupTangent(x)); }
+
+  static Parameters parameters(const G& T) {
+    return Eigen::Map<const Parameters>(T.data());
+  }
+
+  template <class A, class B>
+  bool check(const char* what, const Tangent& x, const A& generated,
+             const B& reference, double tolerance) const {
+    const double error =
+        (generated - reference).template lpNorm<Eigen::Infinity>();
+    const double scale =
+        std::max(1.0, reference.template lpNorm<Eigen::Infinity>());
+    if (error <= tolerance * scale) {
+      return true;
+    }
+    std::cerr << name_ << " " << what << " mismatch for x = "
+              << x.transpose() << std::endl
+              << "generated:" << std::endl << generated << std::endl
+              << "reference:" << std::endl << reference << std::endl;
+    return false;
+  }
+
+  std::string name_;
+  std::vector<Tangent, Eigen::aligned_allocator<Tangent> > tangent_vec_;
+};
+
+int test_generated() {
+  using std::cerr;
+  using std::endl;
+
+  cerr << "Test generated kernels" << endl << endl;
+  bool passed = true;
+  passed &= GeneratedTests<SO2Group, generated::SO2Kernels>("SO2").run();
+  passed &= GeneratedTests<SE2Group, generated::SE2Kernels>("SE2").run();
+  passed &= GeneratedTests<SO3Group, generated::SO3Kernels>("SO3").run();
+  passed &= GeneratedTests<SE3Group, generated::SE3Kernels>("SE3").run();
+  passed &= GeneratedTests<RxSO3Group, generated::RxSO3Kernels>("RxSO3").run();
+  passed &= GeneratedTests<Sim3Group, generated::Sim3Kernels>("Sim3").run();
+  if (!passed) {
+    cerr << "failed!" << endl << endl;
+    return -1;
+  }
+  cerr << "passed." << endl << endl;
+  return 0;
+}
+}  // namespace Sophus
+
+int main() { return Sophus::test_generated(); }
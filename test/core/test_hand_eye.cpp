@@ -0,0 +1,172 @@
+// This file is part of Sophus.
+//
+// Copyright 2016 Hauke Strasdat
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights  to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+
+#include <iostream>
+#include <vector>
+
+#include <sophus/hand_eye.hpp>
+#include "tests.hpp"
+
+namespace Sophus {
+
+class HandEyeTests {
+ public:
+  typedef SE3Group<double> SE3Type;
+  typedef SE3Type::Tangent Tangent;
+  typedef std::vector<SE3Type, Eigen::aligned_allocator<SE3Type> > SE3Vector;
+
+  HandEyeTests() {
+    Tangent x;
+    x << 0.1, -0.3, 0.05, 0.4, -1.2, 0.7;
+    X_ = SE3Type::exp(x);
+    for (int i = 0; i < 50; ++i) {
+      Tangent a;
+      for (int d = 0; d < 6; ++d) {
+        a[d] = std::sin(1.7 * i + 2.3 * d);
+      }
+      A_.push_back(SE3Type::exp(a));
+      B_.push_back(X_.inverse() * A_.back() * X_);
+      // B with noise
+      Tangent noise;
+      for (int d = 0; d < 6; ++d) {
+        noise[d] = 0.01 * std::cos(3.1 * i + 0.7 * d);
+      }
+      B_noisy_.push_back(B_.back() * SE3Type::exp(noise));
+    }
+  }
+
+  bool run() {
+    bool passed = true;
+
+    // exact data is solved exactly by the closed form
+    HandEyeLinearSolver<double> linear_solver;
+    for (std::size_t i = 0; i < A_.size(); ++i) {
+      linear_solver.add(A_[i], B_[i]);
+    }
+    passed &= check("Linear", (X_.inverse() * linear_solver.solve()).log(),
+                    1e-10);
+    passed &= check("Batch", (X_.inverse() * handEyeCalibration(A_, B_)).log(),
+                    1e-10);
+
+    // Gauss-Newton step against one with central difference Jacobians
+    {
+      const int kPairs = 5;
+      const SE3Type X_lin = X_ * SE3Type::exp(Tangent::Constant(0.1));
+      Eigen::Matrix<double, 6 * kPairs, 6> J_num;
+      Eigen::Matrix<double, 6 * kPairs, 1> r;
+      HandEyeNormalEquations<double> normal_equations(X_lin);
+      const double h = 1e-6;
+      for (int i = 0; i < kPairs; ++i) {
+        normal_equations.add(A_[i], B_noisy_[i]);
+        r.segment<6>(6 * i) = residual(X_lin, i);
+        for (int d = 0; d < 6; ++d) {
+          const Tangent e = h * Tangent::Unit(d);
+          J_num.block<6, 1>(6 * i, d) =
+              (residual(X_lin * SE3Type::exp(e), i) -
+               residual(X_lin * SE3Type::exp(-e), i)) /
+              (2 * h);
+        }
+      }
+      const Tangent step_num =
+          -(J_num.transpose() * J_num).ldlt().solve(J_num.transpose() * r);
+      passed &= check("Jacobian", normal_equations.step() - step_num, 1e-6);
+    }
+
+    // noisy data: refinement reaches a local minimum better than the
+    // closed form, and streaming one pass per iteration agrees with it
+    const SE3Type X_batch = handEyeCalibration(A_, B_noisy_);
+    HandEyeLinearSolver<double> noisy_solver;
+    for (std::size_t i = 0; i < A_.size(); ++i) {
+      noisy_solver.add(A_[i], B_noisy_[i]);
+    }
+    const SE3Type X_linear = noisy_solver.solve();
+    SE3Type X_stream = X_linear;
+    for (int iteration = 0; iteration < 5; ++iteration) {
+      HandEyeNormalEquations<double> normal_equations(X_stream);
+      for (std::size_t i = 0; i < A_.size(); ++i) {
+        normal_equations.add(A_[i], B_noisy_[i]);
+      }
+      X_stream = normal_equations.solve();
+    }
+    passed &= check("Streaming", (X_batch.inverse() * X_stream).log(), 1e-8);
+    passed &= check("Noisy", (X_.inverse() * X_batch).log(), 1e-2);
+    const double cost = totalCost(X_batch);
+    if (!(cost < totalCost(X_linear))) {
+      std::cerr << "Refinement did not decrease the cost" << std::endl;
+      passed = false;
+    }
+    for (int d = 0; d < 6; ++d) {
+      for (double sign = -1; sign <= 1; sign += 2) {
+        const Tangent e = 1e-4 * sign * Tangent::Unit(d);
+        if (!(totalCost(X_batch * SE3Type::exp(e)) >= cost)) {
+          std::cerr << "Not a local minimum in direction " << d << std::endl;
+          passed = false;
+        }
+      }
+    }
+    return passed;
+  }
+
+ private:
+  Tangent residual(const SE3Type& X, int i) const {
+    return (X.inverse() * A_[i].inverse() * X * B_noisy_[i]).log();
+  }
+
+  double totalCost(const SE3Type& X) const {
+    double cost = 0;
+    for (std::size_t i = 0; i < A_.size(); ++i) {
+      cost += residual(X, static_cast<int>(i)).squaredNorm() / 2;
+    }
+    return cost;
+  }
+
+  bool check(const char* name, const Tangent& diff, double tolerance) {
+    if (!(diff.norm() <= tolerance)) {
+      std::cerr << name << ": " << diff.transpose() << std::endl;
+      return false;
+    }
+    return true;
+  }
+
+  SE3Type X_;
+  SE3Vector A_;
+  SE3Vector B_;
+  SE3Vector B_noisy_;
+};
+
+int test_hand_eye() {
+  using std::cerr;
+  using std::endl;
+
+  cerr << "Test hand-eye calibration" << endl << endl;
+  HandEyeTests tests;
+  if (!tests.run()) {
+    cerr << "failed!" << endl << endl;
+    exit(-1);
+  }
+  cerr << "passed." << endl << endl;
+  return 0;
+}
+}  // namespace Sophus
+
+int main() { return Sophus::test_hand_eye(); }
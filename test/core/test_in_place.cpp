@@ -0,0 +1,357 @@
+// This file is part of Sophus.
+//
+// Copyright 2016 Hauke Strasdat
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights  to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+
+
+#include <iostream>
+#include <vector>
+
+#include <sophus/dual.hpp>
+#include <sophus/se2.hpp>
+#include <sophus/se3.hpp>
+#include <sophus/sim3.hpp>
+#include "tests.hpp"
+
+namespace Sophus {
+
+// composeInto(), inverseInto(), expInto() and logInto() against the value
+// returning operations, on owned groups, Maps into a buffer and aliased
+// arguments.
+template <class Scalar>
+class InPlaceTests : public TestCases {
+ public:
+  typedef SO2Group<Scalar> SO2Type;
+  typedef SE2Group<Scalar> SE2Type;
+  typedef SO3Group<Scalar> SO3Type;
+  typedef SE3Group<Scalar> SE3Type;
+  typedef RxSO3Group<Scalar> RxSO3Type;
+  typedef Sim3Group<Scalar> Sim3Type;
+  typedef typename SE3Type::Tangent Tangent;
+  typedef typename SO3Type::Tangent SO3Tangent;
+
+  InPlaceTests() {
+    Tangent x;
+    x << 1.0, -2.0, 0.5, 0.3, -0.6, 1.1;
+    tangents_.push_back(x);
+    x << 0.0, 0.0, 0.0, 0.0, 0.0, 0.0;
+    tangents_.push_back(x);
+    x << -0.1, 0.2, 3.0, 1e-9, -2e-9, 0.0;
+    tangents_.push_back(x);
+    x << 5.0, 0.0, -1.0, 0.0, 3.0, 0.1;
+    tangents_.push_back(x);
+  }
+
+  void runAll() {
+    processTestResult(testSO3(), "SO3");
+    processTestResult(testSE3(), "SE3");
+    processTestResult(testMaps(), "Maps");
+    processTestResult(testAliasing(), "aliasing");
+    processTestResult(testSO2(), "SO2");
+    processTestResult(testSE2(), "SE2");
+    processTestResult(testRxSO3(), "RxSO3");
+    processTestResult(testSim3(), "Sim3");
+    processTestResult(testSim3Maps(), "Sim3 maps");
+  }
+
+ private:
+  static Scalar eps() {
+    return Scalar(100) * SophusConstants<Scalar>::epsilon();
+  }
+
+  template <class Group>
+  static bool near(const Group& a, const Group& b) {
+    return (a.matrix() - b.matrix()).norm() < eps();
+  }
+
+  static bool near(Scalar a, Scalar b) { return std::abs(a - b) < eps(); }
+
+  template <class Derived>
+  static bool near(const Eigen::MatrixBase<Derived>& a,
+                   const Eigen::MatrixBase<Derived>& b) {
+    return (a - b).norm() < eps();
+  }
+
+  // All four operations of Group, including aliased arguments.
+  template <class Group>
+  static bool testGroup(const Group& a, const Group& b,
+                        const typename Group::Tangent& xa) {
+    bool passed = true;
+    Group out;
+    composeInto(&out, a, b);
+    passed &= near(out, a * b);
+    inverseInto(&out, a);
+    passed &= near(out, a.inverse());
+    expInto(&out, xa);
+    passed &= near(out, a);
+    typename Group::Tangent x;
+    logInto(&x, b);
+    passed &= near(x, b.log());
+
+    out = a;
+    composeInto(&out, out, b);
+    passed &= near(out, a * b);
+    out = b;
+    composeInto(&out, a, out);
+    passed &= near(out, a * b);
+    out = a;
+    inverseInto(&out, out);
+    passed &= near(out, a.inverse());
+    return passed;
+  }
+
+  bool testSO2() {
+    bool passed = true;
+    for (const Tangent& xa : tangents_) {
+      for (const Tangent& xb : tangents_) {
+        passed &= testGroup(SO2Type::exp(xa[5]), SO2Type::exp(xb[5]), xa[5]);
+      }
+    }
+    return passed;
+  }
+
+  bool testSE2() {
+    bool passed = true;
+    for (const Tangent& xa : tangents_) {
+      for (const Tangent& xb : tangents_) {
+        const typename SE2Type::Tangent ya(xa[0], xa[1], xa[5]);
+        const typename SE2Type::Tangent yb(xb[0], xb[1], xb[5]);
+        passed &= testGroup(SE2Type::exp(ya), SE2Type::exp(yb), ya);
+      }
+    }
+    return passed;
+  }
+
+  bool testRxSO3() {
+    bool passed = true;
+    for (const Tangent& xa : tangents_) {
+      for (const Tangent& xb : tangents_) {
+        typename RxSO3Type::Tangent ya, yb;
+        ya << xa.template tail<3>(), Scalar(0.2) * xa[0];
+        yb << xb.template tail<3>(), Scalar(0.2) * xb[0];
+        passed &= testGroup(RxSO3Type::exp(ya), RxSO3Type::exp(yb), ya);
+      }
+    }
+    return passed;
+  }
+
+  bool testSim3() {
+    bool passed = true;
+    for (const Tangent& xa : tangents_) {
+      for (const Tangent& xb : tangents_) {
+        typename Sim3Type::Tangent ya, yb;
+        ya << xa, Scalar(0.2) * xa[1];
+        yb << xb, Scalar(0.2) * xb[1];
+        passed &= testGroup(Sim3Type::exp(ya), Sim3Type::exp(yb), ya);
+      }
+    }
+    return passed;
+  }
+
+  bool testSim3Maps() {
+    // packed similarities in a buffer, composed into their own storage
+    const int n = static_cast<int>(tangents_.size());
+    const int stride = Sim3Type::num_parameters;
+    std::vector<Scalar> params(stride * n);
+    std::vector<Sim3Type, Eigen::aligned_allocator<Sim3Type> > expected;
+    for (int i = 0; i < n; ++i) {
+      typename Sim3Type::Tangent x;
+      x << tangents_[i], Scalar(-0.1) * tangents_[i][2];
+      Eigen::Map<Sim3Type> T(&params[stride * i]);
+      expInto(&T, x);
+      expected.push_back(Sim3Type::exp(x));
+    }
+    bool passed = true;
+    for (int i = 0; i + 1 < n; ++i) {
+      Eigen::Map<Sim3Type> a(&params[stride * i]);
+      const Eigen::Map<const Sim3Type> b(&params[stride * (i + 1)]);
+      passed &= near(Sim3Type(a), expected[i]);
+      composeInto(&a, a, b);
+      passed &= near(Sim3Type(a), expected[i] * expected[i + 1]);
+      Eigen::Map<RxSO3Type> sR(&params[stride * i]);
+      inverseInto(&sR, b.rxso3());
+      passed &= near(RxSO3Type(sR), expected[i + 1].rxso3().inverse());
+    }
+    return passed;
+  }
+
+  bool testSO3() {
+    bool passed = true;
+    for (const Tangent& xa : tangents_) {
+      for (const Tangent& xb : tangents_) {
+        const SO3Tangent omega_a = xa.template tail<3>();
+        const SO3Tangent omega_b = xb.template tail<3>();
+        const SO3Type a = SO3Type::exp(omega_a);
+        const SO3Type b = SO3Type::exp(omega_b);
+        SO3Type out;
+        composeInto(&out, a, b);
+        passed &= out.unit_quaternion().coeffs() ==
+                  (a * b).unit_quaternion().coeffs();
+        inverseInto(&out, a);
+        passed &= near(out, a.inverse());
+        Scalar theta;
+        expInto(&out, omega_a, &theta);
+        passed &= near(out, a);
+        passed &= std::abs(theta - omega_a.norm()) < eps();
+        SO3Tangent omega;
+        logInto(&omega, b);
+        passed &= (omega - b.log()).norm() < eps();
+      }
+    }
+    return passed;
+  }
+
+  bool testSE3() {
+    bool passed = true;
+    for (const Tangent& xa : tangents_) {
+      for (const Tangent& xb : tangents_) {
+        const SE3Type a = SE3Type::exp(xa);
+        const SE3Type b = SE3Type::exp(xb);
+        SE3Type out;
+        composeInto(&out, a, b);
+        passed &= out.matrix() == (a * b).matrix();
+        inverseInto(&out, a);
+        passed &= near(out, a.inverse());
+        expInto(&out, xa);
+        passed &= near(out, a);
+        Tangent x;
+        logInto(&x, b);
+        passed &= (x - b.log()).norm() < eps();
+      }
+    }
+    return passed;
+  }
+
+  bool testMaps() {
+    // packed poses in a buffer, and a tangent into a strided buffer
+    const int n = static_cast<int>(tangents_.size());
+    std::vector<Scalar> params(SE3Type::num_parameters * n);
+    for (int i = 0; i < n; ++i) {
+      Eigen::Map<SE3Type> T(&params[SE3Type::num_parameters * i]);
+      expInto(&T, tangents_[i]);
+    }
+    bool passed = true;
+    std::vector<Scalar> tangents(2 * SE3Type::DoF);
+    for (int i = 0; i + 1 < n; ++i) {
+      const Eigen::Map<const SE3Type> a(&params[SE3Type::num_parameters * i]);
+      const Eigen::Map<const SE3Type> b(
+          &params[SE3Type::num_parameters * (i + 1)]);
+      passed &= near(SE3Type(a), SE3Type::exp(tangents_[i]));
+      SE3Type ab;
+      composeInto(&ab, a, b);
+      passed &= near(ab, SE3Type(a) * SE3Type(b));
+      Eigen::Map<Tangent, 0, Eigen::InnerStride<2> > x(tangents.data());
+      logInto(&x, ab);
+      passed &= (Tangent(x) - ab.log()).norm() < eps();
+      Eigen::Map<SO3Type> R(&params[SE3Type::num_parameters * i]);
+      inverseInto(&R, b.so3());
+      passed &= near(SO3Type(R), b.so3().inverse());
+    }
+    return passed;
+  }
+
+  bool testAliasing() {
+    bool passed = true;
+    for (const Tangent& xa : tangents_) {
+      for (const Tangent& xb : tangents_) {
+        const SE3Type a = SE3Type::exp(xa);
+        const SE3Type b = SE3Type::exp(xb);
+        SE3Type out = a;
+        composeInto(&out, out, b);
+        passed &= near(out, a * b);
+        out = b;
+        composeInto(&out, a, out);
+        passed &= near(out, a * b);
+        out = a;
+        composeInto(&out, out, out);
+        passed &= near(out, a * a);
+        out = a;
+        inverseInto(&out, out);
+        passed &= near(out, a.inverse());
+      }
+    }
+    return passed;
+  }
+
+  std::vector<Tangent, Eigen::aligned_allocator<Tangent> > tangents_;
+};
+
+// The autodiff scalars fall back to the value returning operations.
+bool testDual() {
+  typedef Dual<double, 6> D;
+  typedef SE3Group<D> SE3D;
+  SE3D::Tangent x;
+  for (int i = 0; i < 6; ++i) {
+    x[i] = D(0.1 * (i + 1), i);
+  }
+  SE3D T;
+  expInto(&T, x);
+  SE3D::Tangent y;
+  logInto(&y, T);
+  bool passed = true;
+  for (int i = 0; i < 6; ++i) {
+    passed &= std::abs(y[i].a - x[i].a) < 1e-12;
+    for (int j = 0; j < 6; ++j) {
+      passed &= std::abs(y[i].v[j] - (i == j ? 1.0 : 0.0)) < 1e-9;
+    }
+  }
+
+  typedef Dual<double, 7> D7;
+  typedef Sim3Group<D7> Sim3D;
+  Sim3D::Tangent z;
+  for (int i = 0; i < 7; ++i) {
+    z[i] = D7(0.1 * (i + 1), i);
+  }
+  Sim3D S;
+  expInto(&S, z);
+  Sim3D::Tangent w;
+  logInto(&w, S);
+  for (int i = 0; i < 7; ++i) {
+    passed &= std::abs(w[i].a - z[i].a) < 1e-12;
+    for (int j = 0; j < 7; ++j) {
+      passed &= std::abs(w[i].v[j] - (i == j ? 1.0 : 0.0)) < 1e-9;
+    }
+  }
+  return passed;
+}
+
+int test_in_place() {
+  using std::cerr;
+  using std::endl;
+
+  cerr << "Test in-place group operations" << endl << endl;
+  cerr << "Double tests: " << endl;
+  InPlaceTests<double> tests_double;
+  tests_double.runAll();
+  cerr << "Float tests: " << endl;
+  InPlaceTests<float> tests_float;
+  tests_float.runAll();
+  const bool dual = testDual();
+  cerr << "Dual: " << (dual ? "passed." : "failed!") << endl;
+  if (!tests_double.passed() || !tests_float.passed() || !dual) {
+    exit(-1);
+  }
+  cerr << endl;
+  return 0;
+}
+}  // namespace Sophus
+
+int main() { return Sophus::test_in_place(); }
@@ -0,0 +1,202 @@
+// This file is part of Sophus.
+//
+// Copyright 2016 Hauke Strasdat
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights  to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+#include <sophus/lie_integrators.hpp>
+#include "tests.hpp"
+
+namespace Sophus {
+
+// Orientation dependent, time-varying body velocities, whose values at the
+// stages do not commute.
+struct SO3Field {
+  SO3Group<double>::Tangent operator()(double t,
+                                       const SO3Group<double>& R) const {
+    return R.inverse() * Eigen::Vector3d(0.3, -0.2, 1.0) +
+           Eigen::Vector3d(std::sin(2 * t), 0.5, -0.4 * t);
+  }
+};
+
+struct SE3Field {
+  SE3Group<double>::Tangent operator()(double t,
+                                       const SE3Group<double>& T) const {
+    SE3Group<double>::Tangent xi;
+    xi.head<3>() = T.so3().inverse() * Eigen::Vector3d(1.0, 0.0, -0.5) -
+                   0.2 * T.translation();
+    xi.tail<3>() = Eigen::Vector3d(0.4 * std::cos(t), -0.7, 0.3) +
+                   0.1 * T.translation();
+    return xi;
+  }
+};
+
+// Applies a per-element field to packed elements.
+template <class Group, class Field>
+struct BatchField {
+  void operator()(double t, const double* params, double* velocities,
+                  std::size_t n) const {
+    for (std::size_t i = 0; i < n; ++i) {
+      const Eigen::Map<const Group> Y(params + Group::num_parameters * i);
+      Eigen::Map<typename Group::Tangent>(velocities + Group::DoF * i) =
+          Field()(t, Group(Y));
+    }
+  }
+};
+
+template <class Group, class Field>
+class LieIntegratorTests : public TestCases {
+ public:
+  typedef typename Group::Tangent Tangent;
+
+  LieIntegratorTests() {
+    Tangent x;
+    for (int i = 0; i < Group::DoF; ++i) {
+      x[i] = 0.3 * (i + 1) - 0.8;
+    }
+    Y_0_ = Group::exp(x);
+  }
+
+  void runAll() {
+    processTestResult(testDexpinv(), "dexpinv");
+    const LieIntegratorMethod methods[2] = {
+        LieIntegratorMethod::RKMK, LieIntegratorMethod::CrouchGrossman};
+    const char* names[2] = {"RKMK", "Crouch-Grossman"};
+    for (int m = 0; m < 2; ++m) {
+      for (int order = 2; order <= 4; ++order) {
+        const LieIntegrator<Group> integrator(methods[m], order);
+        std::cerr << names[m] << " " << order << ", ";
+        processTestResult(testOrder(integrator), "convergence order");
+        std::cerr << names[m] << " " << order << ", ";
+        processTestResult(testBatch(methods[m], order), "batched step");
+      }
+    }
+  }
+
+ private:
+  // d/dt exp(theta + t dexpinv(theta, xi)) = exp(theta) * hat(xi)
+  bool testDexpinv() {
+    Tangent theta;
+    Tangent xi;
+    for (int i = 0; i < Group::DoF; ++i) {
+      theta[i] = 0.05 * (i - 2);
+      xi[i] = 0.5 - 0.2 * i;
+    }
+    const double eps = 1e-6;
+    const Tangent d = LieIntegrator<Group>::dexpinv(theta, xi, 4);
+    const Tangent numeric =
+        ((Group::exp(theta).inverse() * Group::exp(theta + eps * d)).log() -
+         (Group::exp(theta).inverse() * Group::exp(theta - eps * d)).log()) /
+        (2 * eps);
+    const bool passed = (numeric - xi).norm() < 1e-8;
+    if (!passed) {
+      std::cerr << "Error " << (numeric - xi).transpose() << std::endl;
+    }
+    return passed;
+  }
+
+  static Group integrate(const LieIntegrator<Group>& integrator,
+                         const Group& Y_0, int num_steps) {
+    const double h = kDuration / num_steps;
+    Group Y = Y_0;
+    for (int i = 0; i < num_steps; ++i) {
+      Y = integrator.step(Y, i * h, h, Field());
+    }
+    return Y;
+  }
+
+  // The error halves 2^order times when halving the step.
+  bool testOrder(const LieIntegrator<Group>& integrator) {
+    const LieIntegrator<Group> reference_integrator(LieIntegratorMethod::RKMK,
+                                                    4);
+    const Group reference = integrate(reference_integrator, Y_0_, 4096);
+    const double error_coarse =
+        (reference.inverse() * integrate(integrator, Y_0_, 32)).log().norm();
+    const double error_fine =
+        (reference.inverse() * integrate(integrator, Y_0_, 64)).log().norm();
+    const double order = std::log2(error_coarse / error_fine);
+    const bool passed = order > integrator.order() - 0.3;
+    if (!passed) {
+      std::cerr << "Errors " << error_coarse << ", " << error_fine
+                << ", estimated order " << order << std::endl;
+    }
+    return passed;
+  }
+
+  // Batched steps agree with steps of the single elements.
+  bool testBatch(LieIntegratorMethod method, int order) {
+    const int kNumElements = 37;
+    const double h = 0.05;
+    LieIntegrator<Group> integrator(method, order);
+    std::vector<double> params;
+    std::vector<Group, Eigen::aligned_allocator<Group> > Ys;
+    for (int i = 0; i < kNumElements; ++i) {
+      Tangent x;
+      for (int j = 0; j < Group::DoF; ++j) {
+        x[j] = std::sin(1.3 * i + j);
+      }
+      Ys.push_back(Group::exp(x));
+      params.insert(params.end(), Ys.back().data(),
+                    Ys.back().data() + Group::num_parameters);
+    }
+    bool passed = true;
+    for (int step = 0; step < 3; ++step) {
+      integrator.step(params.data(), kNumElements, step * h, h,
+                      BatchField<Group, Field>());
+      for (int i = 0; i < kNumElements; ++i) {
+        Ys[i] = integrator.step(Ys[i], step * h, h, Field());
+        const Eigen::Map<const Group> Y(&params[Group::num_parameters * i]);
+        passed &= (Ys[i].inverse() * Y).log().norm() < 1e-12;
+      }
+    }
+    return passed;
+  }
+
+  static constexpr double kDuration = 2.0;
+  Group Y_0_;
+};
+
+template <class Group, class Field>
+constexpr double LieIntegratorTests<Group, Field>::kDuration;
+
+int test_lie_integrators() {
+  using std::cerr;
+  using std::endl;
+
+  cerr << "Test Lie group integrators" << endl << endl;
+  cerr << "SO3" << endl;
+  LieIntegratorTests<SO3Group<double>, SO3Field> so3_tests;
+  so3_tests.runAll();
+  cerr << endl << "SE3" << endl;
+  LieIntegratorTests<SE3Group<double>, SE3Field> se3_tests;
+  se3_tests.runAll();
+  if (!so3_tests.passed() || !se3_tests.passed()) {
+    exit(-1);
+  }
+  cerr << endl;
+  return 0;
+}
+}  // namespace Sophus
+
+int main() { return Sophus::test_lie_integrators(); }
@@ -0,0 +1,194 @@
+// This file is part of Sophus.
+//
+// Copyright 2016 Hauke Strasdat
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights  to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+
+
+#include <iostream>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <sophus/map_array.hpp>
+#include <sophus/se2.hpp>
+#include <sophus/se3.hpp>
+#include <sophus/sim3.hpp>
+#include "tests.hpp"
+
+namespace Sophus {
+
+template <class Group>
+bool sameParameters(const Group& a, const Group& b) {
+  for (int i = 0; i < Group::num_parameters; ++i) {
+    if (a.data()[i] != b.data()[i]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// SO2 has a scalar tangent
+template <class Scalar, int DoF>
+Eigen::Matrix<Scalar, DoF, 1> asTangent(
+    const Eigen::Matrix<Scalar, DoF, 1>& x) {
+  return x;
+}
+
+template <class Scalar>
+Scalar asTangent(const Eigen::Matrix<Scalar, 1, 1>& x) {
+  return x[0];
+}
+
+template <class Group>
+std::vector<Group, Eigen::aligned_allocator<Group> > someGroups(int n) {
+  typedef typename Group::Scalar Scalar;
+  std::vector<Group, Eigen::aligned_allocator<Group> > groups;
+  for (int i = 0; i < n; ++i) {
+    Eigen::Matrix<Scalar, Group::DoF, 1> x;
+    for (int j = 0; j < Group::DoF; ++j) {
+      x[j] = Scalar(0.1 * (i + 1) * (j % 2 == 0 ? 1 : -1) + 0.05 * j);
+    }
+    groups.push_back(Group::exp(asTangent(x)));
+  }
+  return groups;
+}
+
+// Packed, strided and column layouts; reads and writes through the maps.
+template <class Group>
+bool testStrided() {
+  typedef typename Group::Scalar Scalar;
+  const int N = Group::num_parameters;
+  const int n = 5;
+  const auto groups = someGroups<Group>(n);
+  bool passed = true;
+
+  // records of a timestamp and the parameters
+  std::vector<Scalar> records(n * (N + 1));
+  const MapArray<Group> writable(records.data() + 1, n, N + 1);
+  for (int i = 0; i < n; ++i) {
+    records[i * (N + 1)] = Scalar(i);
+    writable[i] = groups[i];
+  }
+  const MapArray<const Group> readable(records.data() + 1, n, N + 1);
+  for (int i = 0; i < n; ++i) {
+    passed &= sameParameters(Group(readable[i]), groups[i]);
+    passed &= records[i * (N + 1)] == Scalar(i);
+  }
+
+  // columns of a matrix, and rows 1 to N of one with a timestamp row; const
+  // matrices only give read-only views
+  typedef Eigen::Matrix<Scalar, N, Eigen::Dynamic> Columns;
+  static_assert(
+      !std::is_constructible<MapArray<Group>, const Columns&>::value &&
+          !std::is_constructible<
+              MapArray<Group>,
+              decltype(std::declval<const Columns&>().leftCols(1))>::value,
+      "writable views of const matrices");
+  static_assert(std::is_constructible<MapArray<const Group>, Columns&>::value,
+                "read-only views of writable matrices");
+  Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic> stamped(N + 1, n);
+  stamped.row(0).setConstant(Scalar(-1));
+  Columns columns(N, n);
+  const MapArray<Group> column_view(columns);
+  const MapArray<Group> stamped_view(stamped.template middleRows<N>(1));
+  passed &= column_view.size() == std::size_t(n);
+  for (int i = 0; i < n; ++i) {
+    column_view[i] = groups[i];
+    stamped_view[i] = groups[n - 1 - i];
+  }
+  const Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic>& const_stamped =
+      stamped;
+  const MapArray<const Group> const_view(
+      const_stamped.template middleRows<N>(1));
+  for (int i = 0; i < n; ++i) {
+    passed &= sameParameters(Group(column_view[i]), groups[i]);
+    passed &= sameParameters(Group(const_view[i]), groups[n - 1 - i]);
+    passed &= stamped(0, i) == Scalar(-1);
+  }
+
+  // in-place group operations on a mapped element
+  column_view[0] *= groups[1];
+  passed &= (Group(column_view[0]).matrix() - (groups[0] * groups[1]).matrix())
+                .norm() < 1e-10;
+  return passed;
+}
+
+// Translations and rotation parameters in separate arrays.
+template <class Group>
+bool testSeparate() {
+  typedef typename Group::Scalar Scalar;
+  const int N = Group::num_parameters;
+  const int T = Group::Point::RowsAtCompileTime;
+  const int R = N - T;
+  const int n = 5;
+  const auto groups = someGroups<Group>(n);
+  // packed translations, rotations with one padding scalar each
+  std::vector<Scalar> translations(n * T), rotations(n * (R + 1));
+  const MapArray<Group> separate(translations.data(), T, rotations.data(),
+                                 R + 1, n);
+  bool passed = true;
+  for (int i = 0; i < n; ++i) {
+    separate[i] = groups[i];
+    const Eigen::Map<const Group> element(&translations[i * T],
+                                          &rotations[i * (R + 1)]);
+    passed &= sameParameters(Group(element), groups[i]);
+    passed &= (Group(separate[i]).translation() - groups[i].translation())
+                  .norm() == 0;
+  }
+  // the split constructor of the writable map
+  Eigen::Map<Group> element(&translations[0], &rotations[0]);
+  element = groups[n - 1];
+  passed &= sameParameters(Group(separate[0]), groups[n - 1]);
+  return passed;
+}
+
+class MapArrayTests : public TestCases {
+ public:
+  void runAll() {
+    processTestResult(testStrided<SO2Group<double> >(), "SO2 strided");
+    processTestResult(testStrided<SO3Group<double> >(), "SO3 strided");
+    processTestResult(testStrided<RxSO3Group<double> >(), "RxSO3 strided");
+    processTestResult(testStrided<SE2Group<double> >(), "SE2 strided");
+    processTestResult(testSeparate<SE2Group<double> >(), "SE2 separate");
+    processTestResult(testStrided<SE3Group<double> >(), "SE3 strided");
+    processTestResult(testSeparate<SE3Group<double> >(), "SE3 separate");
+    processTestResult(testSeparate<SE3Group<float> >(), "SE3f separate");
+    processTestResult(testStrided<Sim3Group<double> >(), "Sim3 strided");
+    processTestResult(testSeparate<Sim3Group<double> >(), "Sim3 separate");
+  }
+};
+
+int test_map_array() {
+  using std::cerr;
+  using std::endl;
+
+  cerr << "Test MapArray" << endl << endl;
+  MapArrayTests tests;
+  tests.runAll();
+  if (!tests.passed()) {
+    exit(-1);
+  }
+  cerr << endl;
+  return 0;
+}
+}  // namespace Sophus
+
+int main() { return Sophus::test_map_array(); }
@@ -0,0 +1,186 @@
+// This file is part of Sophus.
+//
+// Copyright 2016 Hauke Strasdat
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights  to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+
+
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include <sophus/motion_averaging.hpp>
+#include "tests.hpp"
+
+namespace Sophus {
+
+// Random view graph around known poses, with T_w_0 = identity.
+class MotionAveragingTests : public TestCases {
+ public:
+  static const int kNumViews = 300;
+
+  MotionAveragingTests() : rng_(3) {
+    std::normal_distribution<double> normal(0, 1);
+    T_w_.push_back(SE3d());
+    for (int i = 1; i < kNumViews; ++i) {
+      Vector6d x;
+      for (int k = 0; k < 6; ++k) {
+        x[k] = normal(rng_) * (k < 3 ? 10 : 2);
+      }
+      T_w_.push_back(SE3d::exp(x));
+    }
+    std::uniform_int_distribution<int> view(0, kNumViews - 1);
+    for (int i = 1; i < kNumViews; ++i) {
+      edges_.push_back(std::make_pair(i - 1, i));
+    }
+    for (int k = 0; k < 4 * kNumViews; ++k) {
+      const int a = view(rng_);
+      const int b = view(rng_);
+      if (a != b) {
+        edges_.push_back(std::make_pair(a, b));
+      }
+    }
+  }
+
+  bool runAll() {
+    bool passed = exactTest();
+    passed &= robustTest();
+    passed &= disconnectedTest();
+    return passed;
+  }
+
+ private:
+  // Noise-free measurements give back the poses.
+  bool exactTest() {
+    MotionAveraging averaging(kNumViews);
+    for (const std::pair<int, int>& e : edges_) {
+      averaging.addRelativePose(e.first, e.second,
+                                T_w_[e.first].inverse() * T_w_[e.second]);
+    }
+    MotionAveragingOptions options;
+    options.num_threads = 2;
+    MotionAveraging::RotationVector R_w;
+    MotionAveraging::PoseVector T_w;
+    bool passed = averaging.averageRotations(options, &R_w) &&
+                  averaging.averageTranslations(options, R_w, &T_w);
+    double error = 0;
+    for (int i = 0; passed && i < kNumViews; ++i) {
+      error = std::max(error, (T_w_[i].inverse() * T_w[i]).log().norm());
+    }
+    passed &= error < 1e-8;
+    if (!passed) {
+      std::cerr << "Largest pose error " << error << std::endl;
+    }
+    return processTestResult(passed, "Exact measurements");
+  }
+
+  // With noise and 20% gross outliers, the reweighted solution is accurate
+  // and better than the chordal initialization.
+  bool robustTest() {
+    std::normal_distribution<double> normal(0, 1);
+    std::uniform_int_distribution<int> percent(0, 99);
+    MotionAveraging averaging(kNumViews);
+    for (std::size_t k = 0; k < edges_.size(); ++k) {
+      const int a = edges_[k].first;
+      const int b = edges_[k].second;
+      Vector6d noise;
+      for (int j = 0; j < 6; ++j) {
+        noise[j] = normal(rng_) * (j < 3 ? 1e-2 : 5e-3);
+      }
+      // keep the chain clean so that the inlier graph is connected
+      if (k >= kNumViews - 1 && percent(rng_) < 20) {
+        noise *= 300;
+      }
+      averaging.addRelativePose(
+          a, b, T_w_[a].inverse() * T_w_[b] * SE3d::exp(noise));
+    }
+    MotionAveragingOptions options;
+    options.num_threads = 4;
+    options.max_iterations = 0;
+    MotionAveraging::RotationVector chordal;
+    bool passed = averaging.averageRotations(options, &chordal);
+    options.max_iterations = 30;
+    MotionAveraging::RotationVector R_w;
+    MotionAveraging::PoseVector T_w;
+    MotionAveragingSummary rotation_summary;
+    MotionAveragingSummary translation_summary;
+    passed &= averaging.averageRotations(options, &R_w, &rotation_summary);
+    passed &= averaging.averageTranslations(options, R_w, &T_w,
+                                            &translation_summary);
+    if (!passed) {
+      return processTestResult(false, "Outliers");
+    }
+    double chordal_error = 0;
+    double rotation_error = 0;
+    double position_error = 0;
+    for (int i = 0; i < kNumViews; ++i) {
+      chordal_error += (T_w_[i].so3().inverse() * chordal[i]).log().norm();
+      rotation_error += (T_w_[i].so3().inverse() * R_w[i]).log().norm();
+      position_error += (T_w_[i].translation() - T_w[i].translation()).norm();
+    }
+    chordal_error /= kNumViews;
+    rotation_error /= kNumViews;
+    position_error /= kNumViews;
+    passed = rotation_error < 2e-2 && rotation_error < 0.5 * chordal_error &&
+             position_error < 0.5 &&
+             rotation_summary.final_cost < rotation_summary.initial_cost &&
+             translation_summary.final_cost < translation_summary.initial_cost;
+    if (!passed) {
+      std::cerr << "Mean rotation error " << rotation_error << " (chordal "
+                << chordal_error << "), mean position error "
+                << position_error << ", rotation cost "
+                << rotation_summary.initial_cost << " -> "
+                << rotation_summary.final_cost << ", translation cost "
+                << translation_summary.initial_cost << " -> "
+                << translation_summary.final_cost << std::endl;
+    }
+    return processTestResult(passed, "Outliers");
+  }
+
+  // A view without edges makes the problem unsolvable.
+  bool disconnectedTest() {
+    MotionAveraging averaging(3);
+    averaging.addRelativeRotation(0, 1, SO3d::exp(Eigen::Vector3d(0.3, 0, 0)));
+    MotionAveraging::RotationVector R_w;
+    const bool passed =
+        !averaging.averageRotations(MotionAveragingOptions(), &R_w);
+    return processTestResult(passed, "Disconnected graph");
+  }
+
+  std::mt19937 rng_;
+  MotionAveraging::PoseVector T_w_;
+  std::vector<std::pair<int, int> > edges_;
+};
+
+int test_motion_averaging() {
+  using std::cerr;
+  using std::endl;
+
+  cerr << "Test motion averaging" << endl << endl;
+  MotionAveragingTests tests;
+  if (!tests.runAll()) {
+    exit(-1);
+  }
+  cerr << endl;
+  return 0;
+}
+}  // namespace Sophus
+
+int main() { return Sophus::test_motion_averaging(); }
@@ -0,0 +1,226 @@
+// This file is part of Sophus.
+//
+// Copyright 2016 Hauke Strasdat
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights  to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include <sophus/pose_codec.hpp>
+#include "tests.hpp"
+
+namespace Sophus {
+
+template <class Scalar>
+class PoseCodecTests : public TestCases {
+ public:
+  typedef SE3Group<Scalar> SE3Type;
+  typedef typename SE3Type::Tangent Tangent;
+  typedef std::vector<SE3Type, Eigen::aligned_allocator<SE3Type> > PoseVector;
+  static const int kNumPoses = 1000;
+
+  PoseCodecTests() {
+    std::mt19937 rng(5);
+    std::uniform_real_distribution<double> uniform(-1, 1);
+    for (int i = 0; i < kNumPoses; ++i) {
+      Tangent x;
+      for (int k = 0; k < 6; ++k) {
+        x[k] = Scalar(uniform(rng) * (k < 3 ? 100 : 3.1));
+      }
+      if (i < 5) {
+        x.template tail<3>().setZero();
+      }
+      poses_.push_back(SE3Type::exp(x));
+    }
+  }
+
+  bool runAll() {
+    bool passed = codecTest(SE3Codec<Scalar>(), "Default codec");
+    passed &= codecTest(SE3Codec<Scalar>(7, Scalar(0.05), 13), "Small codec");
+    passed &= codecTest(SE3Codec<Scalar>(16, Scalar(1e-4), 24), "Large codec");
+    passed &= clampTest();
+    passed &= deltaTest();
+    return passed;
+  }
+
+ private:
+  // Decoded poses are within the error bounds; single and batched encoding
+  // agree.
+  bool codecTest(const SE3Codec<Scalar>& codec, const char* name) {
+    const std::size_t num_bytes = codec.numBytes();
+    std::vector<std::uint8_t> bytes(num_bytes * kNumPoses);
+    const int kP = SE3Type::num_parameters;
+    std::vector<Scalar> params(kP * kNumPoses), decoded(kP * kNumPoses);
+    for (int i = 0; i < kNumPoses; ++i) {
+      std::copy(poses_[i].data(), poses_[i].data() + kP, &params[kP * i]);
+    }
+    codec.encode(params.data(), kNumPoses, bytes.data());
+    codec.decode(bytes.data(), kNumPoses, decoded.data());
+    // float arithmetic adds to the quantization errors
+    const Scalar slack = 10 * SophusConstants<Scalar>::epsilon();
+    bool passed = true;
+    Scalar max_rotation_error = 0;
+    Scalar max_translation_error = 0;
+    std::vector<std::uint8_t> single(num_bytes);
+    for (int i = 0; i < kNumPoses; ++i) {
+      const Eigen::Map<const SE3Type> T(&decoded[kP * i]);
+      max_rotation_error =
+          std::max(max_rotation_error,
+                   (poses_[i].so3().inverse() * T.so3()).log().norm());
+      max_translation_error =
+          std::max(max_translation_error,
+                   (poses_[i].translation() - T.translation()).norm());
+      codec.encode(poses_[i], single.data());
+      passed &= std::equal(single.begin(), single.end(),
+                           bytes.begin() + num_bytes * i);
+      const SE3Type T_single = codec.decode(single.data());
+      passed &= std::equal(&decoded[kP * i], &decoded[kP * (i + 1)],
+                           T_single.data());
+    }
+    passed &= max_rotation_error <= codec.rotationErrorBound() + slack &&
+              max_translation_error <=
+                  codec.translationErrorBound() * (1 + slack) + slack;
+    if (!passed) {
+      std::cerr << "Rotation error " << max_rotation_error << " (bound "
+                << codec.rotationErrorBound() << "), translation error "
+                << max_translation_error << " (bound "
+                << codec.translationErrorBound() << ")" << std::endl;
+    }
+    return processTestResult(passed, name);
+  }
+
+  // Translations out of range are clamped, also where the code limit is not
+  // representable in Scalar.
+  bool clampTest() {
+    const SE3Codec<Scalar> codec(12, Scalar(0.01), 8);
+    const Scalar range = codec.translationRange();
+    std::vector<std::uint8_t> bytes(codec.numBytes());
+    codec.encode(SE3Type(SO3Group<Scalar>(),
+                         typename SE3Type::Point(10 * range, -range, 0)),
+                 bytes.data());
+    const SE3Type T = codec.decode(bytes.data());
+    bool passed =
+        (T.translation() -
+         typename SE3Type::Point(range, -range, 0)).norm() < 1e-5 &&
+        range == Scalar(127) * Scalar(0.01);
+    for (int bits = 24; bits <= 32; ++bits) {
+      const SE3Codec<Scalar> wide(12, Scalar(1e-3), bits);
+      const Scalar wide_range = wide.translationRange();
+      const Scalar full_range =
+          Scalar(1e-3) * Scalar((std::int64_t(1) << (bits - 1)) - 1);
+      bytes.resize(wide.numBytes());
+      const typename SE3Type::Point t(Scalar(1e9), -Scalar(1e9), wide_range);
+      wide.encode(SE3Type(SO3Group<Scalar>(), t), bytes.data());
+      const typename SE3Type::Point decoded =
+          wide.decode(bytes.data()).translation();
+      const typename SE3Type::Point expected(wide_range, -wide_range,
+                                             wide_range);
+      passed &= wide_range <= full_range &&
+                wide_range > full_range * (1 - 1e-6) &&
+                (decoded - expected).norm() <= 1e-6 * wide_range;
+    }
+    return processTestResult(passed, "Clamping");
+  }
+
+  // A smooth trajectory delta-encoded to under a quarter of its size, with
+  // bounded errors, keyframes on jumps and at fixed intervals, and encoder
+  // and decoder in lockstep.
+  bool deltaTest() {
+    SE3DeltaCodec<Scalar> encoder(SE3Codec<Scalar>(), Scalar(1e-4),
+                                  Scalar(1e-4), 13, 500);
+    SE3DeltaCodec<Scalar> decoder(SE3Codec<Scalar>(), Scalar(1e-4),
+                                  Scalar(1e-4), 13, 500);
+    std::vector<std::uint8_t> stream;
+    std::vector<std::uint8_t> message(encoder.maxBytes());
+    PoseVector trajectory;
+    for (int i = 0; i < 2 * kNumPoses; ++i) {
+      const Scalar s = Scalar(i) / 100;
+      Tangent x;
+      x << 5 * std::cos(s), 5 * std::sin(s), s / 10, 0.1 * std::sin(3 * s),
+          0.05, s;
+      if (i >= 1200) {
+        x[0] += 50;  // jump
+      }
+      trajectory.push_back(SE3Type::exp(x));
+    }
+    std::size_t num_keyframes = 0;
+    for (const SE3Type& T : trajectory) {
+      const std::size_t num_bytes = encoder.encode(T, message.data());
+      num_keyframes += message[0] & 1;
+      stream.insert(stream.end(), message.begin(),
+                    message.begin() + num_bytes);
+    }
+    bool passed =
+        stream.size() * 4 < trajectory.size() * sizeof(SE3Group<double>) &&
+        num_keyframes == 5;
+    std::size_t offset = 0;
+    Scalar max_rotation_error = 0;
+    Scalar max_translation_error = 0;
+    for (const SE3Type& T : trajectory) {
+      SE3Type decoded;
+      offset += decoder.decode(&stream[offset], &decoded);
+      const Tangent error = (T.inverse() * decoded).log();
+      max_rotation_error =
+          std::max(max_rotation_error, error.template tail<3>().norm());
+      max_translation_error =
+          std::max(max_translation_error, (T.translation() -
+                                           decoded.translation()).norm());
+    }
+    passed &= offset == stream.size() &&
+              std::equal(decoder.reference().data(),
+                         decoder.reference().data() + SE3Type::num_parameters,
+                         encoder.reference().data()) &&
+              max_rotation_error < 1e-3 && max_translation_error < 1e-3;
+    if (!passed) {
+      std::cerr << stream.size() << " bytes, " << num_keyframes
+                << " keyframes, rotation error " << max_rotation_error
+                << ", translation error " << max_translation_error
+                << std::endl;
+    }
+    return processTestResult(passed, "Delta coding");
+  }
+
+  PoseVector poses_;
+};
+
+int test_pose_codec() {
+  using std::cerr;
+  using std::endl;
+
+  cerr << "Test pose codec" << endl << endl;
+  cerr << "Double tests: " << endl;
+  bool passed = PoseCodecTests<double>().runAll();
+  cerr << endl << "Float tests: " << endl;
+  passed &= PoseCodecTests<float>().runAll();
+  if (!passed) {
+    exit(-1);
+  }
+  cerr << endl;
+  return 0;
+}
+}  // namespace Sophus
+
+int main() { return Sophus::test_pose_codec(); }
@@ -0,0 +1,141 @@
+// This file is part of Sophus.
+//
+// Copyright 2016 Hauke Strasdat
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights  to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+
+#include <iostream>
+#include <vector>
+
+#include <sophus/pose_graph_smoother.hpp>
+#include "tests.hpp"
+
+namespace Sophus {
+
+// Trajectory with consistent odometry and loop closures, processed one node
+// at a time from perturbed initial estimates.
+template <class Smoother>
+class PoseGraphSmootherTests {
+ public:
+  typedef typename Smoother::GroupType GroupType;
+  typedef typename Smoother::Tangent Tangent;
+  static const int kNumNodes = 120;
+
+  PoseGraphSmootherTests() {
+    GroupType T;
+    for (int i = 0; i < kNumNodes; ++i) {
+      truth_.push_back(T);
+      Tangent step = Tangent::Zero();
+      step[0] = 0.5;
+      step[1] = 0.05 * std::sin(0.1 * i);
+      step[Smoother::DoF == 7 ? 6 : 5] = 0.1;
+      step[3] = 0.02 * std::cos(0.3 * i);
+      T = T * GroupType::exp(step);
+    }
+  }
+
+  bool run(const PoseGraphSmootherOptions& options, bool exact) {
+    Smoother smoother(options);
+    bool passed = true;
+    for (int i = 0; i < kNumNodes; ++i) {
+      Tangent noise;
+      for (int d = 0; d < Smoother::DoF; ++d) {
+        noise[d] = 0.01 * std::sin(3.0 * i + d);
+      }
+      smoother.addNode(truth_[i] * GroupType::exp(noise));
+      if (i == 0) {
+        smoother.addPrior(0, truth_[0]);
+      } else {
+        smoother.addRelativePose(i - 1, i,
+                                 truth_[i - 1].inverse() * truth_[i]);
+      }
+      const bool loop_closure = i >= 20 && i % 10 == 0;
+      if (loop_closure) {
+        smoother.addRelativePose(i - 20, i,
+                                 truth_[i - 20].inverse() * truth_[i]);
+      }
+      const PoseGraphUpdateSummary summary = smoother.update();
+      // odometry alone only touches the last two columns
+      if (!loop_closure && i > 0 && summary.num_relinearized_nodes == 0 &&
+          summary.num_refactored_nodes != 2) {
+        std::cerr << "Node " << i << ": refactored "
+                  << summary.num_refactored_nodes << " nodes" << std::endl;
+        passed = false;
+      }
+    }
+    if (exact) {
+      // without new factors, update() is a Gauss-Newton iteration
+      for (int iteration = 0; iteration < 5; ++iteration) {
+        smoother.update();
+      }
+    }
+    const double tolerance = exact ? 1e-8 : 1e-2;
+    for (int i = 0; i < kNumNodes; ++i) {
+      const Tangent error = (truth_[i].inverse() * smoother.estimate(i)).log();
+      if (!(error.norm() <= tolerance)) {
+        std::cerr << "Node " << i << ": " << error.transpose() << std::endl;
+        passed = false;
+      }
+    }
+    return passed;
+  }
+
+ private:
+  std::vector<GroupType, Eigen::aligned_allocator<GroupType> > truth_;
+};
+
+template <class Smoother>
+bool tests(const char* name) {
+  using std::cerr;
+  using std::endl;
+  PoseGraphSmootherTests<Smoother> tests;
+  PoseGraphSmootherOptions exact;
+  exact.relinearize_threshold = 0;
+  exact.wildfire_threshold = 0;
+  cerr << name << ", exact: ";
+  if (!tests.run(exact, true)) {
+    cerr << "failed!" << endl << endl;
+    return false;
+  }
+  cerr << "passed." << endl;
+  cerr << name << ", incremental: ";
+  if (!tests.run(PoseGraphSmootherOptions(), false)) {
+    cerr << "failed!" << endl << endl;
+    return false;
+  }
+  cerr << "passed." << endl;
+  return true;
+}
+
+int test_pose_graph_smoother() {
+  using std::cerr;
+  using std::endl;
+
+  cerr << "Test pose graph smoother" << endl << endl;
+  if (!tests<SE3PoseGraphSmoother>("SE3") ||
+      !tests<Sim3PoseGraphSmoother>("Sim3")) {
+    exit(-1);
+  }
+  cerr << endl;
+  return 0;
+}
+}  // namespace Sophus
+
+int main() { return Sophus::test_pose_graph_smoother(); }
@@ -0,0 +1,116 @@
+// This file is part of Sophus.
+//
+// Copyright 2016 Hauke Strasdat
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights  to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+
+#include <cstdlib>
+#include <iostream>
+
+#include "property_tests.hpp"
+
+// Environment variables:
+//   SOPHUS_PROPERTY_SAMPLES          samples per group and scalar type
+//   SOPHUS_PROPERTY_THREADS          worker threads (default: all cores)
+//   SOPHUS_PROPERTY_SEED             seed of random stream
+//   SOPHUS_PROPERTY_UPDATE_BASELINE  if set, (re)writes the baseline file
+//   SOPHUS_PROPERTY_CHECK_TIMING     if set, timing regressions also fail
+#ifndef SOPHUS_PROPERTY_BASELINE
+#define SOPHUS_PROPERTY_BASELINE "property_baseline.txt"
+#endif
+
+namespace Sophus {
+
+unsigned long long envOr(const char* name, unsigned long long fallback) {
+  const char* value = std::getenv(name);
+  return value == nullptr ? fallback : std::strtoull(value, nullptr, 10);
+}
+
+template <class LieGroup>
+void runProperties(const PropertyTestOptions& options,
+                   std::vector<PropertyStats>* stats) {
+  PropertyTests<LieGroup> tests(options);
+  std::vector<PropertyStats> group_stats = tests.run();
+  stats->insert(stats->end(), group_stats.begin(), group_stats.end());
+}
+
+template <class Scalar>
+void tests(const PropertyTestOptions& options,
+           std::vector<PropertyStats>* stats) {
+  runProperties<SO2Group<Scalar> >(options, stats);
+  runProperties<SE2Group<Scalar> >(options, stats);
+  runProperties<SO3Group<Scalar> >(options, stats);
+  runProperties<SE3Group<Scalar> >(options, stats);
+  runProperties<RxSO3Group<Scalar> >(options, stats);
+  runProperties<Sim3Group<Scalar> >(options, stats);
+}
+
+int test_properties() {
+  using std::cerr;
+  using std::endl;
+
+  PropertyTestOptions options;
+  options.num_samples = envOr("SOPHUS_PROPERTY_SAMPLES", options.num_samples);
+  options.num_threads = envOr("SOPHUS_PROPERTY_THREADS",
+                              std::max(1u, std::thread::hardware_concurrency()));
+  options.seed = envOr("SOPHUS_PROPERTY_SEED", options.seed);
+  const bool update = std::getenv("SOPHUS_PROPERTY_UPDATE_BASELINE") != nullptr;
+  const bool check_timing =
+      std::getenv("SOPHUS_PROPERTY_CHECK_TIMING") != nullptr;
+
+  cerr << "Test properties (" << options.num_samples << " samples, "
+       << options.num_threads << " threads)" << endl
+       << endl;
+
+  std::vector<PropertyStats> stats;
+  tests<double>(options, &stats);
+  tests<float>(options, &stats);
+  printPropertyStats(stats, cerr);
+  cerr << endl;
+
+  const std::string path = SOPHUS_PROPERTY_BASELINE;
+  PropertyBaseline baseline;
+  const bool loaded = baseline.load(path);
+  if (update) {
+    for (const PropertyStats& s : stats) {
+      baseline.set(s);
+    }
+    if (!baseline.save(path)) {
+      cerr << "Could not write baseline " << path << endl;
+      return -1;
+    }
+    cerr << "Baseline " << path << " updated." << endl;
+    return 0;
+  }
+  if (!loaded) {
+    cerr << "Could not read baseline " << path << endl;
+    return -1;
+  }
+
+  bool passed = true;
+  for (const PropertyStats& s : stats) {
+    passed &= checkRegression(s, baseline, check_timing, cerr);
+  }
+  cerr << (passed ? "passed." : "failed!") << endl << endl;
+  return passed ? 0 : -1;
+}
+}  // namespace Sophus
+
+int main() { return Sophus::test_properties(); }
@@ -0,0 +1,132 @@
+// This file is part of Sophus.
+//
+// Copyright 2016 Hauke Strasdat
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights  to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include <sophus/ransac.hpp>
+#include "tests.hpp"
+
+namespace Sophus {
+
+// Point pairs related by a known transformation, with a fixed fraction of
+// gross outliers.
+template <class Group>
+class RansacTests {
+ public:
+  typedef typename Group::Tangent Tangent;
+  static const int kNumPoints = 1000;
+
+  RansacTests() {
+    Tangent x;
+    x.setZero();
+    x.template head<6>() << 1.0, -2.0, 0.5, 0.3, -0.6, 1.1;
+    if (Group::DoF == 7) {
+      x[6] = 0.4;
+    }
+    T_ = Group::exp(x);
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<double> uniform(-5, 5);
+    for (int i = 0; i < kNumPoints; ++i) {
+      const Eigen::Vector3d p(uniform(rng), uniform(rng), uniform(rng));
+      Eigen::Vector3d q = T_ * p;
+      // 60% outliers
+      const bool inlier = i % 5 < 2;
+      if (inlier) {
+        inliers_.push_back(i);
+      } else {
+        q = Eigen::Vector3d(uniform(rng), uniform(rng), uniform(rng));
+      }
+      src_.insert(src_.end(), p.data(), p.data() + 3);
+      dst_.insert(dst_.end(), q.data(), q.data() + 3);
+    }
+  }
+
+  bool run(const RansacOptions& options) {
+    const PointRegistrationProblem<Group> problem(src_.data(), dst_.data(),
+                                                  kNumPoints);
+    const RansacResult<Group> result = ransac(problem, options);
+    bool passed = result.success;
+    // the gross outliers can be consistent with T by chance
+    for (int i : inliers_) {
+      passed &= std::binary_search(result.inliers.begin(),
+                                   result.inliers.end(), i);
+    }
+    passed &= result.inliers.size() < inliers_.size() + 10;
+    const Tangent error = (T_.inverse() * result.model).log();
+    passed &= error.norm() < 1e-8;
+    if (!passed) {
+      std::cerr << "Inliers: " << result.inliers.size() << " of "
+                << inliers_.size() << ", error " << error.transpose()
+                << ", iterations " << result.num_iterations << std::endl;
+    }
+    return passed;
+  }
+
+ private:
+  Group T_;
+  std::vector<double> src_;
+  std::vector<double> dst_;
+  std::vector<int> inliers_;
+};
+
+template <class Group>
+bool tests(const char* name) {
+  using std::cerr;
+  using std::endl;
+  RansacTests<Group> tests;
+  RansacOptions options;
+  options.max_squared_error = 1e-6;
+  bool passed = true;
+  for (int sprt = 0; sprt < 2; ++sprt) {
+    for (std::size_t num_threads = 1; num_threads <= 4; num_threads += 3) {
+      options.use_sprt = sprt == 1;
+      options.num_threads = num_threads;
+      cerr << name << (sprt ? ", SPRT" : "") << ", " << num_threads
+           << " thread(s): ";
+      if (tests.run(options)) {
+        cerr << "passed." << endl;
+      } else {
+        cerr << "failed!" << endl;
+        passed = false;
+      }
+    }
+  }
+  return passed;
+}
+
+int test_ransac() {
+  using std::cerr;
+  using std::endl;
+
+  cerr << "Test RANSAC" << endl << endl;
+  if (!tests<SE3Group<double> >("SE3") || !tests<Sim3Group<double> >("Sim3")) {
+    exit(-1);
+  }
+  cerr << endl;
+  return 0;
+}
+}  // namespace Sophus
+
+int main() { return Sophus::test_ransac(); }
@@ -0,0 +1,149 @@
+// This file is part of Sophus.
+//
+// Copyright 2016 Hauke Strasdat
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights  to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+#include <sophus/rigid_body_array.hpp>
+#include "tests.hpp"
+
+namespace Sophus {
+
+template <class Scalar>
+class RigidBodyArrayTests : public TestCases {
+ public:
+  typedef RigidBodyArray<Scalar> Array;
+  typedef SE3Group<Scalar> SE3Type;
+  typedef typename SE3Type::Tangent Tangent;
+  typedef typename SE3Type::Point Point;
+  typedef std::vector<SE3Type, Eigen::aligned_allocator<SE3Type> >
+      PoseVector;
+
+  RigidBodyArrayTests() {}
+
+  void runAll() {
+    processTestResult(testViews(), "Per-body views");
+    processTestResult(testIntegrate(1), "Integrate, 1 thread");
+    processTestResult(testIntegrate(4), "Integrate, 4 threads");
+  }
+
+ private:
+  static Tangent twist(std::size_t i) {
+    Tangent xi;
+    for (int j = 0; j < 6; ++j) {
+      xi[j] = Scalar(std::sin(0.7 * i + 1.3 * j));
+    }
+    if (i % 7 == 0) {
+      xi.template tail<3>().setZero();
+    }
+    return xi;
+  }
+
+  // The views write through to the arrays and interoperate with SE3Group.
+  bool testViews() {
+    Array array(3);
+    bool passed = array.size() == 3;
+    for (std::size_t i = 0; i < 3; ++i) {
+      passed &= array.pose(i).matrix().isIdentity();
+      passed &= array.twist(i).isZero();
+    }
+    const SE3Type T = SE3Type::exp(twist(1));
+    array.pose(1) = T;
+    array.twist(2) = twist(2);
+    passed &= array.addBody(T, twist(3)) == 3;
+    const Point p(1, 2, 3);
+    passed &= (array.pose(1) * p - T * p).norm() < kEps;
+    passed &= (array.pose(3).matrix() - T.matrix()).norm() < kEps;
+    passed &= Eigen::Map<const Point>(array.translations() + 3) ==
+              T.translation();
+    passed &= Eigen::Map<const Point>(array.twists() + 18) ==
+              twist(3).template head<3>();
+    passed &= (array.twist(2) - twist(2)).isZero();
+
+    const Array& const_array = array;
+    const MapArray<const SE3Type> poses = const_array.poses();
+    passed &= poses.size() == 4;
+    passed &= (SE3Type(poses[1]).log() - T.log()).norm() < kEps;
+    array.poses()[0] = T.inverse();
+    passed &= (SE3Type(array.pose(0) * T).log()).norm() < kEps;
+    return passed;
+  }
+
+  // Matches T = T * exp(dt * xi) of the single bodies, across several
+  // blocks and a partial one.
+  bool testIntegrate(std::size_t num_threads) {
+    const std::size_t kNumBodies = 3 * Array::kBlockSize + 17;
+    const Scalar dt = Scalar(0.01);
+    Array array;
+    array.reserve(kNumBodies);
+    PoseVector expected;
+    for (std::size_t i = 0; i < kNumBodies; ++i) {
+      expected.push_back(SE3Type::exp(Scalar(0.5) * twist(i + 1)));
+      array.addBody(expected.back(), twist(i));
+    }
+    for (int step = 0; step < 50; ++step) {
+      array.integrate(dt, num_threads);
+      for (std::size_t i = 0; i < kNumBodies; ++i) {
+        expected[i] = expected[i] * SE3Type::exp(dt * twist(i));
+      }
+    }
+    bool passed = true;
+    for (std::size_t i = 0; i < kNumBodies; ++i) {
+      const Scalar error =
+          (expected[i].matrix() - array.pose(i).matrix()).norm();
+      if (error > 100 * kEps) {
+        std::cerr << "Body " << i << ": error " << error << std::endl;
+        passed = false;
+      }
+    }
+    return passed;
+  }
+
+  static const Scalar kEps;
+};
+
+template <class Scalar>
+const Scalar RigidBodyArrayTests<Scalar>::kEps =
+    10 * SophusConstants<Scalar>::epsilon();
+
+int test_rigid_body_array() {
+  using std::cerr;
+  using std::endl;
+
+  cerr << "Test rigid body array" << endl << endl;
+  cerr << "Double tests: " << endl;
+  RigidBodyArrayTests<double> tests_double;
+  tests_double.runAll();
+  cerr << "Float tests: " << endl;
+  RigidBodyArrayTests<float> tests_float;
+  tests_float.runAll();
+  if (!tests_double.passed() || !tests_float.passed()) {
+    exit(-1);
+  }
+  cerr << endl;
+  return 0;
+}
+}  // namespace Sophus
+
+int main() { return Sophus::test_rigid_body_array(); }
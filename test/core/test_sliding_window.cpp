@@ -0,0 +1,209 @@
+// This file is part of Sophus.
+//
+// Copyright 2016 Hauke Strasdat
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights  to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include <sophus/sliding_window.hpp>
+#include "tests.hpp"
+
+namespace Sophus {
+
+class SlidingWindowTests : public TestCases {
+ public:
+  typedef SE3Group<double> SE3Type;
+  typedef SE3Type::Tangent Tangent;
+  typedef std::vector<SE3Type, Eigen::aligned_allocator<SE3Type> >
+      PoseVector;
+  static const int kNumStates = 15;
+
+  SlidingWindowTests() : rng_(7) {
+    // helix with rotating heading
+    for (int i = 0; i < kNumStates; ++i) {
+      Tangent x;
+      x << 0.5 * i, 0.1 * i, 0.2 * std::sin(0.5 * i), 0.05 * i, -0.02 * i,
+          0.3 * i;
+      poses_.push_back(SE3Type::exp(x));
+    }
+  }
+
+  void runAll() {
+    processTestResult(testNoiseFree(true), "Noise-free trajectory, FEJ");
+    processTestResult(testNoiseFree(false), "Noise-free trajectory");
+    processTestResult(testLinearMatchesBatch(),
+                      "Linear problem matches batch solution");
+    processTestResult(testNoisyMatchesBatch(),
+                      "Noisy trajectory close to batch solution");
+  }
+
+ private:
+  Tangent noise(double sigma) {
+    std::normal_distribution<double> normal(0, sigma);
+    Tangent x;
+    for (int i = 0; i < 6; ++i) {
+      x[i] = normal(rng_);
+    }
+    return x;
+  }
+
+  // Relative pose factors to the two previous states, perturbed initial
+  // estimates and a prior on the first state.
+  bool testNoiseFree(bool first_estimate_jacobians) {
+    SlidingWindowOptions options;
+    options.first_estimate_jacobians = first_estimate_jacobians;
+    SlidingWindowEstimator<4> window(options);
+    bool passed = true;
+    for (int i = 0; i < kNumStates; ++i) {
+      const SE3Type guess = i == 0 ? poses_[0] : window.pose(i - 1) *
+                                                     poses_[i - 1].inverse() *
+                                                     poses_[i] *
+                                                     SE3Type::exp(noise(0.1));
+      const int id = window.addState(guess);
+      passed &= id == i;
+      if (i == 0) {
+        window.addPosePrior(0, poses_[0]);
+      }
+      for (int j = std::max(0, i - 2); j < i; ++j) {
+        window.addRelativePose(j, i, poses_[j].inverse() * poses_[i]);
+      }
+      const SlidingWindowSummary summary = window.optimize();
+      passed &= summary.converged && summary.final_cost < 1e-16;
+      passed &= window.numStates() == std::min(i + 1, 4);
+      passed &= window.oldestState() == std::max(0, i - 3);
+    }
+    passed &= window.inPrior(kNumStates - 3) && !window.inPrior(14);
+    for (int i = window.oldestState(); i < kNumStates; ++i) {
+      const double error = (poses_[i].inverse() * window.pose(i)).log().norm();
+      if (error > 1e-7) {
+        std::cerr << "State " << i << ": error " << error << std::endl;
+        passed = false;
+      }
+    }
+    return passed;
+  }
+
+  // With factors on the Euclidean part only, marginalization is exact, so
+  // the newest state agrees with a full batch solution.
+  bool testLinearMatchesBatch() {
+    typedef SlidingWindowEstimator<3, 3> Window;
+    typedef SlidingWindowEstimator<kNumStates, 3> Batch;
+    // run the linear solves to convergence
+    SlidingWindowOptions options;
+    options.function_tolerance = 0;
+    options.max_iterations = 50;
+    Window window(options);
+    Batch batch(options);
+    std::normal_distribution<double> normal(0, 1);
+    bool passed = true;
+    for (int i = 0; i < kNumStates; ++i) {
+      const Eigen::Vector3d x(normal(rng_), normal(rng_), normal(rng_));
+      window.addState(poses_[i], x);
+      batch.addState(poses_[i], x);
+      Window::Block sqrt_information = Window::Block::Identity();
+      sqrt_information.diagonal().head<6>().setConstant(10);
+      if (i == 0) {
+        window.addPrior(0, poses_[0], Eigen::Vector3d::Zero(),
+                        sqrt_information);
+        batch.addPrior(0, poses_[0], Eigen::Vector3d::Zero(),
+                       sqrt_information);
+      } else {
+        window.addPosePrior(i, poses_[i]);
+        batch.addPosePrior(i, poses_[i]);
+      }
+      for (int j = std::max(0, i - 2); j < i; ++j) {
+        const Eigen::Vector3d d(normal(rng_), normal(rng_), normal(rng_));
+        Eigen::Matrix3d sqrt_information = Eigen::Matrix3d::Identity();
+        sqrt_information(0, 1) = 0.5 * (i - j);
+        window.addRelativeExtra(j, i, d, sqrt_information);
+        batch.addRelativeExtra(j, i, d, sqrt_information);
+      }
+      window.optimize();
+    }
+    const SlidingWindowSummary summary = batch.optimize();
+    const double window_cost = window.optimize().final_cost;
+    passed &= summary.converged;
+    passed &= std::abs(window_cost - summary.final_cost) <
+              1e-9 * summary.final_cost;
+    for (int i = window.oldestState(); i < kNumStates; ++i) {
+      const double error = (window.extra(i) - batch.extra(i)).norm();
+      if (error > 1e-9) {
+        std::cerr << "State " << i << ": error " << error << std::endl;
+        passed = false;
+      }
+    }
+    return passed;
+  }
+
+  // Inconsistent relative poses: the window only differs from the batch
+  // solution by the linearization of the prior.
+  bool testNoisyMatchesBatch() {
+    SlidingWindowEstimator<5> window;
+    SlidingWindowEstimator<kNumStates> batch;
+    for (int i = 0; i < kNumStates; ++i) {
+      window.addState(i == 0 ? poses_[0] : window.pose(i - 1));
+      batch.addState(poses_[i] * SE3Type::exp(noise(0.05)));
+      if (i == 0) {
+        window.addPosePrior(0, poses_[0]);
+        batch.addPosePrior(0, poses_[0]);
+      }
+      for (int j = std::max(0, i - 3); j < i; ++j) {
+        const SE3Type T_ji =
+            poses_[j].inverse() * poses_[i] * SE3Type::exp(noise(0.01));
+        window.addRelativePose(j, i, T_ji);
+        batch.addRelativePose(j, i, T_ji);
+      }
+      window.optimize();
+    }
+    bool passed = batch.optimize().converged;
+    for (int i = window.oldestState(); i < kNumStates; ++i) {
+      const double error =
+          (batch.pose(i).inverse() * window.pose(i)).log().norm();
+      if (error > 5e-3) {
+        std::cerr << "State " << i << ": error " << error << std::endl;
+        passed = false;
+      }
+    }
+    return passed;
+  }
+
+  PoseVector poses_;
+  std::mt19937 rng_;
+};
+
+int test_sliding_window() {
+  using std::cerr;
+  using std::endl;
+
+  cerr << "Test sliding-window estimator" << endl << endl;
+  SlidingWindowTests tests;
+  tests.runAll();
+  if (!tests.passed()) {
+    exit(-1);
+  }
+  cerr << endl;
+  return 0;
+}
+}  // namespace Sophus
+
+int main() { return Sophus::test_sliding_window(); }
@@ -0,0 +1,248 @@
+// This file is part of Sophus.
+//
+// Copyright 2016 Hauke Strasdat
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights  to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+
+
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include <sophus/trajectory_evaluation.hpp>
+#include "tests.hpp"
+
+namespace Sophus {
+
+class TrajectoryEvaluationTests : public TestCases {
+ public:
+  static const int kNumPoses = 5000;
+
+  TrajectoryEvaluationTests() : rng_(17) {
+    for (int i = 0; i < kNumPoses; ++i) {
+      const double s = 0.01 * i;
+      Vector6d x;
+      x << 10 * std::cos(s), 10 * std::sin(2 * s), s, 0.3 * std::sin(s), 0.2,
+          s;
+      ground_truth_.timestamps.push_back(s);
+      ground_truth_.poses.push_back(SE3d::exp(x));
+    }
+    Eigen::Matrix<double, 7, 1> y;
+    y << 1, -2, 3, 0.4, 0.5, -0.6, 0.7;
+    S_ = Sim3d::exp(y);
+  }
+
+  bool runAll() {
+    bool passed = statisticsTest();
+    passed &= associationTest();
+    passed &= exactTest();
+    passed &= noisyTest();
+    passed &= sequencesTest();
+    return passed;
+  }
+
+ private:
+  // Estimate S^-1 * T_gt * exp(noise), with shifted timestamps and every
+  // tenth pose missing.
+  Trajectory makeEstimate(double noise) {
+    std::normal_distribution<double> normal(0, noise);
+    Trajectory estimate;
+    const Sim3d S_inverse = S_.inverse();
+    const SO3d R_inverse(S_inverse.quaternion());
+    for (int i = 0; i < kNumPoses; ++i) {
+      if (i % 10 == 3) {
+        continue;
+      }
+      Vector6d x;
+      for (int k = 0; k < 6; ++k) {
+        x[k] = normal(rng_);
+      }
+      const SE3d T = ground_truth_.poses[i] * SE3d::exp(x);
+      estimate.timestamps.push_back(ground_truth_.timestamps[i] + 0.001);
+      estimate.poses.push_back(SE3d(R_inverse * T.so3(), S_inverse *
+                                                             T.translation()));
+    }
+    return estimate;
+  }
+
+  bool statisticsTest() {
+    const ErrorStatistics statistics =
+        computeErrorStatistics(std::vector<double>{4, 1, 3, 2});
+    const bool passed =
+        statistics.count == 4 && statistics.min == 1 && statistics.max == 4 &&
+        std::abs(statistics.rmse - std::sqrt(7.5)) < 1e-12 &&
+        statistics.mean == 2.5 && statistics.median == 2.5 &&
+        std::abs(statistics.p90 - 3.7) < 1e-12;
+    return processTestResult(passed, "Statistics");
+  }
+
+  bool associationTest() {
+    const std::vector<double> a = {0.0, 1.0, 2.0, 3.0, 4.0};
+    const std::vector<double> b = {0.05, 0.92, 1.1, 2.5, 3.98, 10.0};
+    const std::vector<std::pair<int, int> > matches =
+        associateTimestamps(a, b, 0.2);
+    const std::vector<std::pair<int, int> > expected = {
+        {0, 0}, {1, 1}, {4, 4}};
+    return processTestResult(matches == expected, "Association");
+  }
+
+  // An exactly transformed estimate has zero errors after Sim3 alignment,
+  // and errors from the scale otherwise.
+  bool exactTest() {
+    const Trajectory estimate = makeEstimate(0);
+    TrajectoryEvaluationOptions options;
+    options.alignment = TrajectoryEvaluationOptions::Sim3Alignment;
+    options.rpe_deltas = {1, 10, 100};
+    TrajectoryEvaluation evaluation;
+    bool passed =
+        evaluateTrajectory(ground_truth_, estimate, options, &evaluation);
+    passed &= evaluation.matches.size() == estimate.poses.size() &&
+              (S_.inverse() * evaluation.alignment).log().norm() < 1e-9 &&
+              evaluation.ate_translation.max < 1e-9 &&
+              evaluation.ate_rotation.max < 1e-9 && evaluation.rpe.size() == 3;
+    for (const RelativePoseErrors& rpe : evaluation.rpe) {
+      const std::size_t count =
+          estimate.poses.size() - static_cast<std::size_t>(rpe.delta);
+      passed &= rpe.translation.count == count &&
+                rpe.translation.max < 1e-9 && rpe.rotation.max < 1e-9;
+    }
+    options.alignment = TrajectoryEvaluationOptions::SE3Alignment;
+    passed &= evaluateTrajectory(ground_truth_, estimate, options,
+                                 &evaluation) &&
+              evaluation.ate_translation.rmse > 0.1 &&
+              evaluation.ate_rotation.max < 1e-9;
+    if (!passed) {
+      std::cerr << "ATE " << evaluation.ate_translation.rmse << ", "
+                << evaluation.ate_rotation.rmse << std::endl;
+    }
+    return processTestResult(passed, "Exact estimate");
+  }
+
+  // The statistics match a direct per-pose evaluation, on any number of
+  // threads.
+  bool noisyTest() {
+    const Trajectory estimate = makeEstimate(0.01);
+    TrajectoryEvaluationOptions options;
+    options.alignment = TrajectoryEvaluationOptions::Sim3Alignment;
+    options.rpe_deltas = {5};
+    bool passed = true;
+    for (std::size_t num_threads = 1; num_threads <= 4; num_threads *= 2) {
+      options.num_threads = num_threads;
+      TrajectoryEvaluation evaluation;
+      passed &=
+          evaluateTrajectory(ground_truth_, estimate, options, &evaluation);
+      const Sim3d& S = evaluation.alignment;
+      const SO3d R(S.quaternion());
+      std::vector<SE3d, Eigen::aligned_allocator<SE3d> > gt, est;
+      for (const std::pair<int, int>& match : evaluation.matches) {
+        const SE3d& T = estimate.poses[match.second];
+        gt.push_back(ground_truth_.poses[match.first]);
+        est.push_back(SE3d(R * T.so3(), S * T.translation()));
+      }
+      std::vector<double> ate_t, ate_r, rpe_t, rpe_r;
+      for (std::size_t i = 0; i < gt.size(); ++i) {
+        const SE3d E = gt[i].inverse() * est[i];
+        ate_t.push_back(E.translation().norm());
+        ate_r.push_back(E.so3().log().norm());
+        if (i + 5 < gt.size()) {
+          const SE3d E_rel = (gt[i].inverse() * gt[i + 5]).inverse() *
+                             (est[i].inverse() * est[i + 5]);
+          rpe_t.push_back(E_rel.translation().norm());
+          rpe_r.push_back(E_rel.so3().log().norm());
+        }
+      }
+      passed &= same(evaluation.ate_translation, computeErrorStatistics(ate_t));
+      passed &= same(evaluation.ate_rotation, computeErrorStatistics(ate_r));
+      passed &=
+          same(evaluation.rpe[0].translation, computeErrorStatistics(rpe_t));
+      passed &= same(evaluation.rpe[0].rotation, computeErrorStatistics(rpe_r));
+      // noise of 0.01 per axis
+      passed &= std::abs(evaluation.ate_rotation.rmse - 0.01 * std::sqrt(3.0)) <
+                2e-3;
+    }
+    return processTestResult(passed, "Noisy estimate");
+  }
+
+  // Batches of sequences give the single-sequence results; too short
+  // sequences fail.
+  bool sequencesTest() {
+    std::vector<Trajectory> ground_truths(3, ground_truth_);
+    std::vector<Trajectory> estimates;
+    for (int k = 0; k < 3; ++k) {
+      estimates.push_back(makeEstimate(0.001 * (k + 1)));
+    }
+    TrajectoryEvaluationOptions options;
+    TrajectoryEvaluationVector evaluations;
+    bool passed = evaluateTrajectories(ground_truths, estimates, options,
+                                       &evaluations);
+    for (int k = 0; k < 3; ++k) {
+      TrajectoryEvaluation evaluation;
+      passed &= evaluateTrajectory(ground_truths[k], estimates[k], options,
+                                   &evaluation) &&
+                same(evaluation.ate_translation,
+                     evaluations[k].ate_translation) &&
+                same(evaluation.rpe[0].rotation,
+                     evaluations[k].rpe[0].rotation);
+    }
+    estimates[1].timestamps.resize(2);
+    estimates[1].poses.resize(2);
+    passed &= !evaluateTrajectories(ground_truths, estimates, options,
+                                    &evaluations) &&
+              evaluations[1].matches.empty() && !evaluations[0].matches.empty();
+    return processTestResult(passed, "Sequences");
+  }
+
+  static bool same(const ErrorStatistics& a, const ErrorStatistics& b) {
+    const double kEps = 1e-9;
+    const bool equal =
+        a.count == b.count && std::abs(a.rmse - b.rmse) < kEps &&
+        std::abs(a.mean - b.mean) < kEps &&
+        std::abs(a.median - b.median) < kEps &&
+        std::abs(a.min - b.min) < kEps && std::abs(a.max - b.max) < kEps &&
+        std::abs(a.p90 - b.p90) < kEps && std::abs(a.p95 - b.p95) < kEps &&
+        std::abs(a.p99 - b.p99) < kEps;
+    if (!equal) {
+      std::cerr << "Statistics differ: rmse " << a.rmse << " vs " << b.rmse
+                << ", count " << a.count << " vs " << b.count << std::endl;
+    }
+    return equal;
+  }
+
+  std::mt19937 rng_;
+  Trajectory ground_truth_;
+  Sim3d S_;
+};
+
+int test_trajectory_evaluation() {
+  using std::cerr;
+  using std::endl;
+
+  cerr << "Test trajectory evaluation" << endl << endl;
+  TrajectoryEvaluationTests tests;
+  if (!tests.runAll()) {
+    exit(-1);
+  }
+  cerr << endl;
+  return 0;
+}
+}  // namespace Sophus
+
+int main() { return Sophus::test_trajectory_evaluation(); }
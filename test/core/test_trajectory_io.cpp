@@ -0,0 +1,214 @@
+// This file is part of Sophus.
+//
+// Copyright 2016 Hauke Strasdat
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights  to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+
+
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <sophus/trajectory_io.hpp>
+#include "tests.hpp"
+
+namespace Sophus {
+
+class TrajectoryIoTests : public TestCases {
+ public:
+  static const int kNumPoses = 20000;
+
+  TrajectoryIoTests() : rng_(11) {
+    std::uniform_real_distribution<double> uniform(-1, 1);
+    for (int i = 0; i < kNumPoses; ++i) {
+      Vector6d x;
+      for (int k = 0; k < 6; ++k) {
+        x[k] = uniform(rng_) * (k < 3 ? 200 : 3);
+      }
+      trajectory_.poses.push_back(SE3d::exp(x));
+      // nanosecond timestamps of the EuRoC datasets
+      trajectory_.timestamps.push_back(1403636579.758555392 + 0.005 * i);
+    }
+  }
+
+  bool runAll() {
+    bool passed = numberTest();
+    passed &= roundTripTest(TrajectoryFormat::TUM, "TUM round trip");
+    passed &= roundTripTest(TrajectoryFormat::KITTI, "KITTI round trip");
+    passed &= roundTripTest(TrajectoryFormat::EuRoC, "EuRoC round trip");
+    passed &= fileTest();
+    passed &= textTest();
+    return passed;
+  }
+
+ private:
+  // The number parser agrees with std::strtod.
+  bool numberTest() {
+    std::vector<std::string> numbers = {
+        "0", "-0.0", "1", "+2.5", "3.14159265358979323846", "1e-300",
+        "-2.2250738585072014e-308", "1.7976931348623157e308", "123456789012",
+        "0.000000000000000000000000123", "12345678901234567890123",
+        "1000000000.010000000", "12345678901234567890000e-10",
+        "9007199254740993", "5e-324", ".5", "7.", "1E+5"};
+    std::uniform_real_distribution<double> uniform(-1, 1);
+    std::uniform_int_distribution<int> exponent(-40, 40);
+    char buffer[64];
+    for (int i = 0; i < 10000; ++i) {
+      const double v = uniform(rng_) * std::pow(10.0, exponent(rng_));
+      std::snprintf(buffer, sizeof(buffer), "%.*g", 1 + i % 17, v);
+      numbers.push_back(buffer);
+    }
+    bool passed = true;
+    for (const std::string& number : numbers) {
+      details::TrajectoryLineParser parser(number.data(),
+                                           number.data() + number.size());
+      double value;
+      const bool parsed = parser.parseDouble(&value) && parser.atEnd();
+      if (!parsed || value != std::strtod(number.c_str(), NULL)) {
+        std::cerr << "Parsing " << number << " failed" << std::endl;
+        passed = false;
+      }
+    }
+    return processTestResult(passed, "Number parsing");
+  }
+
+  bool samePoses(const Trajectory& a, const Trajectory& b,
+                 bool with_timestamps) {
+    if (a.poses.size() != b.poses.size() ||
+        (with_timestamps && a.timestamps.size() != b.timestamps.size())) {
+      std::cerr << "Sizes differ: " << a.poses.size() << " vs "
+                << b.poses.size() << std::endl;
+      return false;
+    }
+    for (std::size_t i = 0; i < a.poses.size(); ++i) {
+      const double error = (a.poses[i].inverse() * b.poses[i]).log().norm();
+      const double time_error =
+          with_timestamps ? std::abs(a.timestamps[i] - b.timestamps[i]) : 0;
+      if (!(error < 1e-12 && time_error < 1e-6)) {
+        std::cerr << "Pose " << i << " differs by " << error << ", "
+                  << time_error << " s" << std::endl;
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // Formatting with 17 digits and parsing gives back the trajectory, with
+  // any number of threads.
+  bool roundTripTest(TrajectoryFormat format, const char* name) {
+    const std::string text = formatTrajectory(trajectory_, format, 17, 3);
+    bool passed = true;
+    for (std::size_t num_threads = 1; num_threads <= 8; num_threads *= 2) {
+      Trajectory parsed;
+      passed &= parseTrajectory(text.data(), text.data() + text.size(), format,
+                                &parsed, num_threads);
+      passed &= samePoses(trajectory_, parsed,
+                          format != TrajectoryFormat::KITTI);
+      passed &= format != TrajectoryFormat::KITTI ||
+                parsed.timestamps.empty();
+    }
+    return processTestResult(passed, name);
+  }
+
+  bool fileTest() {
+    const std::string path = "test_trajectory_io.txt";
+    Trajectory read;
+    bool passed =
+        writeTrajectory(path, trajectory_, TrajectoryFormat::TUM, 17) &&
+        readTrajectory(path, TrajectoryFormat::TUM, &read) &&
+        samePoses(trajectory_, read, true);
+    std::remove(path.c_str());
+    passed &= !readTrajectory(path, TrajectoryFormat::TUM, &read) &&
+              read.poses.empty();
+    return processTestResult(passed, "Files");
+  }
+
+  // Comments, blank lines, CRLF line ends, extra EuRoC columns, and
+  // malformed lines, including rotations which cannot be normalized.
+  bool textTest() {
+    const std::string tum =
+        "# comment\r\n\r\n  1.5 1 2 3 0 0 0 1\r\n"
+        "2.5\t4e0 5 6 0.5 0.5 0.5 0.5 \n\n# end";
+    const std::string kitti =
+        "1 0 0 1 0 1 0 2 0 0 1 3\n0 -1 0 4 1 0 0 5 0 0 1 6";
+    const std::string euroc =
+        "#timestamp [ns], p_RS_R_x [m]\n"
+        "1403636579758555392, 1, 2, 3, 1, 0, 0, 0, 0.1, 0.2, 0.3\n"
+        "1403636579763555584,4,5,6,0.5,0.5,0.5,0.5\n";
+    Trajectory expected;
+    expected.timestamps = {1.5, 2.5};
+    expected.poses.push_back(SE3d(SO3d(), Eigen::Vector3d(1, 2, 3)));
+    expected.poses.push_back(
+        SE3d(Eigen::Quaterniond(0.5, 0.5, 0.5, 0.5), Eigen::Vector3d(4, 5, 6)));
+    Trajectory parsed;
+    bool passed = parseTrajectory(tum.data(), tum.data() + tum.size(),
+                                  TrajectoryFormat::TUM, &parsed) &&
+                  samePoses(expected, parsed, true);
+    passed &= parseTrajectory(euroc.data(), euroc.data() + euroc.size(),
+                              TrajectoryFormat::EuRoC, &parsed) &&
+              samePoses(expected, parsed, false) &&
+              std::abs(parsed.timestamps[1] - 1403636579.763555584) < 1e-6;
+    const double kPi = SophusConstants<double>::pi();
+    expected.poses[1] = SE3d(SO3d::exp(Eigen::Vector3d(0, 0, kPi / 2)),
+                             Eigen::Vector3d(4, 5, 6));
+    passed &= parseTrajectory(kitti.data(), kitti.data() + kitti.size(),
+                              TrajectoryFormat::KITTI, &parsed) &&
+              samePoses(expected, parsed, false);
+
+    const std::string malformed[] = {"1 2 3 4 5 6 7", "1 2 3 4 5 6 7 8 9",
+                                     "1 2 3 x 5 6 7 8", "1 2 3 4 5 6 7 1e",
+                                     "1.0 0 0 0 0 0 0 0",
+                                     "1 2 3 4 1e-9 0 0 0\n5 6 7 8 0 0 0 1",
+                                     "1 2 3 4 0 0 0 1e999"};
+    for (const std::string& text : malformed) {
+      passed &= !parseTrajectory(text.data(), text.data() + text.size(),
+                                 TrajectoryFormat::TUM, &parsed) &&
+                parsed.poses.empty();
+    }
+    const std::string euroc_zero = "1403636579758555392,1,2,3,0,0,0,0\n";
+    passed &= !parseTrajectory(euroc_zero.data(),
+                               euroc_zero.data() + euroc_zero.size(),
+                               TrajectoryFormat::EuRoC, &parsed) &&
+              parsed.poses.empty();
+    return processTestResult(passed, "Text");
+  }
+
+  std::mt19937 rng_;
+  Trajectory trajectory_;
+};
+
+int test_trajectory_io() {
+  using std::cerr;
+  using std::endl;
+
+  cerr << "Test trajectory I/O" << endl << endl;
+  TrajectoryIoTests tests;
+  if (!tests.runAll()) {
+    exit(-1);
+  }
+  cerr << endl;
+  return 0;
+}
+}  // namespace Sophus
+
+int main() { return Sophus::test_trajectory_io(); }
@@ -1,6 +1,8 @@
 #ifndef SOPUHS_TESTS_HPP
 #define SOPUHS_TESTS_HPP
 
+#include <iostream>
+
 #include <Eigen/StdVector>
 #include <unsupported/Eigen/MatrixFunctions>
 
@@ -38,6 +40,25 @@ inline void ensureFailed(const char* function, const char* file, int line,
   std::abort();
 }
 
+// Base of test fixtures which run several named checks: prints the result
+// of each and records whether all of them passed. processTestResult()
+// returns the result of the check, for fixtures which combine them
+// themselves.
+class TestCases {
+ public:
+  bool passed() const { return passed_; }
+
+ protected:
+  bool processTestResult(bool passed, const char* name) {
+    std::cerr << name << ": " << (passed ? "passed." : "failed!") << std::endl;
+    passed_ &= passed;
+    return passed;
+  }
+
+ private:
+  bool passed_ = true;
+};
+
 template <class LieGroup>
 class Tests {
  public: